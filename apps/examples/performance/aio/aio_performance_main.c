@@ -0,0 +1,401 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file aio_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <aio.h>
+
+#define FILE_SIZE		(16 * 1024)
+#define NFILES			2
+
+/* Requests in flight, at most the number of AIO containers */
+
+#if CONFIG_FS_NAIOC < 8
+#define MAX_DEPTH		CONFIG_FS_NAIOC
+#else
+#define MAX_DEPTH		8
+#endif
+
+/* Slots of the completion ring, a power of two of at least MAX_DEPTH */
+
+#define RING_SIZE		8
+
+static uint8_t g_wbuf[FILE_SIZE];
+static uint8_t g_rbuf[NFILES][FILE_SIZE];
+
+static struct aiocb g_aiocb[MAX_DEPTH];
+static struct aiocb *g_list[MAX_DEPTH];
+static struct aiocb *g_ring_slots[RING_SIZE];
+static struct aio_ring_s g_ring;
+
+static const size_t g_sizes[] = { 64, 256, 1024 };
+
+enum aio_test_e {
+	TEST_PWRITE = 0,
+	TEST_LIO_WRITE,
+	TEST_PREAD,
+	TEST_LIO_READ,
+	TEST_RING_READ,
+	TEST_NUM
+};
+
+static const char *g_test_names[TEST_NUM] = {
+	"pwrite", "lio-wr", "pread", "lio-rd", "ring-rd"
+};
+
+/*
+ * @fn                   :aio_perf_fill
+ * @description          :Fill a buffer with a pseudo random pattern
+ * @return               :void
+ */
+static void aio_perf_fill(uint8_t *buf, size_t len)
+{
+	uint32_t x = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		x = x * 1103515245 + 12345;
+		buf[i] = (uint8_t)(x >> 16);
+	}
+}
+
+/*
+ * @fn                   :aio_perf_prep
+ * @description          :Prepare the control block of one request
+ * @return               :void
+ */
+static void aio_perf_prep(struct aiocb *aiocbp, int fd, int opcode, uint8_t *buf, off_t offset, size_t size)
+{
+	memset(aiocbp, 0, sizeof(struct aiocb));
+	aiocbp->aio_fildes = fd;
+	aiocbp->aio_buf = buf + offset;
+	aiocbp->aio_offset = offset;
+	aiocbp->aio_nbytes = size;
+	aiocbp->aio_lio_opcode = opcode;
+	aiocbp->aio_sigevent.sigev_notify = SIGEV_NONE;
+}
+
+/*
+ * @fn                   :aio_perf_sync
+ * @description          :Read or write the files with pread()/pwrite()
+ * @return               :OK, or ERROR on a failed or short transfer
+ */
+static int aio_perf_sync(int *fds, size_t size, bool write)
+{
+	off_t offset;
+	ssize_t ret;
+	int f;
+
+	for (offset = 0; offset < FILE_SIZE; offset += size) {
+		for (f = 0; f < NFILES; f++) {
+			if (write) {
+				ret = pwrite(fds[f], g_wbuf + offset, size, offset);
+			} else {
+				ret = pread(fds[f], g_rbuf[f] + offset, size, offset);
+			}
+
+			if (ret != size) {
+				printf("%s failed: %d\n", write ? "pwrite" : "pread", errno);
+				return ERROR;
+			}
+		}
+	}
+
+	return OK;
+}
+
+/*
+ * @fn                   :aio_perf_lio
+ * @description          :Read or write the files with lio_listio(LIO_WAIT),
+ *                        each list holding the next adjacent requests of
+ *                        all files, interleaved
+ * @return               :OK, or ERROR on a failed or short transfer
+ */
+static int aio_perf_lio(int *fds, size_t size, int opcode)
+{
+	int total = NFILES * (FILE_SIZE / size);
+	int issued = 0;
+	off_t offset;
+	int nent;
+	int i;
+	int f;
+
+	while (issued < total) {
+		for (nent = 0; nent < MAX_DEPTH && issued < total; nent++, issued++) {
+			f = issued % NFILES;
+			offset = (off_t)(issued / NFILES) * size;
+			aio_perf_prep(&g_aiocb[nent], fds[f], opcode, opcode == LIO_READ ? g_rbuf[f] : g_wbuf, offset, size);
+			g_list[nent] = &g_aiocb[nent];
+		}
+
+		if (lio_listio(LIO_WAIT, g_list, nent, NULL) < 0) {
+			printf("lio_listio failed: %d\n", errno);
+			return ERROR;
+		}
+
+		for (i = 0; i < nent; i++) {
+			if (aio_error(g_list[i]) != OK || aio_return(g_list[i]) != size) {
+				printf("lio request %d failed: %d\n", i, aio_error(g_list[i]));
+				return ERROR;
+			}
+		}
+	}
+
+	return OK;
+}
+
+/*
+ * @fn                   :aio_perf_ring
+ * @description          :Read the files with aio_read(), keeping MAX_DEPTH
+ *                        requests in flight and polling the completion ring
+ * @return               :OK, or ERROR on a failed or short transfer
+ */
+static int aio_perf_ring(int *fds, size_t size)
+{
+	struct aiocb *aiocbp;
+	int total = NFILES * (FILE_SIZE / size);
+	int issued = 0;
+	int done = 0;
+	int i;
+	int f;
+
+	memset(g_list, 0, sizeof(g_list));
+	aio_ring_init(&g_ring, g_ring_slots, RING_SIZE);
+
+	while (done < total) {
+		for (i = 0; i < MAX_DEPTH && issued < total; i++) {
+			if (g_list[i] != NULL) {
+				continue;
+			}
+
+			f = issued % NFILES;
+			aiocbp = &g_aiocb[i];
+			aio_perf_prep(aiocbp, fds[f], LIO_READ, g_rbuf[f], (off_t)(issued / NFILES) * size, size);
+			aiocbp->aio_sigevent.sigev_notify = SIGEV_AIO_RING;
+			aiocbp->aio_sigevent.sigev_value.sival_ptr = &g_ring;
+
+			if (aio_read(aiocbp) < 0) {
+				printf("aio_read failed: %d\n", errno);
+				return ERROR;
+			}
+
+			g_list[i] = aiocbp;
+			issued++;
+		}
+
+		while ((aiocbp = aio_ring_get(&g_ring)) == NULL) {
+			(void)aio_suspend((const struct aiocb *const *)g_list, MAX_DEPTH, NULL);
+		}
+
+		if (aio_error(aiocbp) != OK || aio_return(aiocbp) != size) {
+			printf("ring request failed: %d\n", aio_error(aiocbp));
+			return ERROR;
+		}
+
+		g_list[aiocbp - g_aiocb] = NULL;
+		done++;
+	}
+
+	if (g_ring.ar_overflow != 0) {
+		printf("%u completions lost\n", g_ring.ar_overflow);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/*
+ * @fn                   :aio_perf_run
+ * @description          :Run one test over all files
+ * @return               :OK, or ERROR on a failed transfer or bad data
+ */
+static int aio_perf_run(int test, int *fds, size_t size)
+{
+	int ret;
+	int f;
+
+	if (test == TEST_PREAD || test == TEST_LIO_READ || test == TEST_RING_READ) {
+		memset(g_rbuf, 0, sizeof(g_rbuf));
+	}
+
+	switch (test) {
+	case TEST_PWRITE:
+		ret = aio_perf_sync(fds, size, true);
+		break;
+
+	case TEST_LIO_WRITE:
+		ret = aio_perf_lio(fds, size, LIO_WRITE);
+		break;
+
+	case TEST_PREAD:
+		ret = aio_perf_sync(fds, size, false);
+		break;
+
+	case TEST_LIO_READ:
+		ret = aio_perf_lio(fds, size, LIO_READ);
+		break;
+
+	case TEST_RING_READ:
+		ret = aio_perf_ring(fds, size);
+		break;
+
+	default:
+		ret = ERROR;
+		break;
+	}
+
+	if (ret == OK && (test == TEST_PREAD || test == TEST_LIO_READ || test == TEST_RING_READ)) {
+		for (f = 0; f < NFILES; f++) {
+			if (memcmp(g_rbuf[f], g_wbuf, FILE_SIZE) != 0) {
+				printf("%s read back wrong data from file %d\n", g_test_names[test], f);
+				ret = ERROR;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/*
+ * @fn                   :aio_perf_dir
+ * @description          :Print the requests per second of every test for
+ *                        each size on files in 'dir'
+ * @return               :number of failed tests
+ */
+static int aio_perf_dir(const char *dir, int loops)
+{
+	struct timespec stime;
+	struct timespec etime;
+	char path[64];
+	long long usec;
+	int fds[NFILES];
+	int errors = 0;
+	int test;
+	int loop;
+	int f;
+	int n;
+
+	for (f = 0; f < NFILES; f++) {
+		snprintf(path, sizeof(path), "%s/aio_perf%d.dat", dir, f);
+		fds[f] = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+		if (fds[f] < 0) {
+			printf("%s: open failed: %d\n", path, errno);
+			while (--f >= 0) {
+				close(fds[f]);
+			}
+
+			return 1;
+		}
+	}
+
+	printf("\n%s, %d files of %d bytes, %d requests in flight\n", dir, NFILES, FILE_SIZE, MAX_DEPTH);
+	printf("%-8s:", "req/s");
+	for (test = 0; test < TEST_NUM; test++) {
+		printf(" %8s", g_test_names[test]);
+	}
+
+	printf("\n");
+
+	for (n = 0; n < sizeof(g_sizes) / sizeof(g_sizes[0]); n++) {
+		printf("%6u B:", (unsigned)g_sizes[n]);
+
+		for (test = 0; test < TEST_NUM; test++) {
+			clock_gettime(CLOCK_REALTIME, &stime);
+			for (loop = 0; loop < loops; loop++) {
+				if (aio_perf_run(test, fds, g_sizes[n]) != OK) {
+					break;
+				}
+			}
+			clock_gettime(CLOCK_REALTIME, &etime);
+
+			if (loop < loops) {
+				printf(" %8s", "FAIL");
+				errors++;
+				continue;
+			}
+
+			usec = (long long)(etime.tv_sec - stime.tv_sec) * 1000000 + (etime.tv_nsec - stime.tv_nsec) / 1000;
+			if (usec <= 0) {
+				usec = 1;
+			}
+
+			printf(" %8lld", ((long long)loops * NFILES * (FILE_SIZE / g_sizes[n]) * 1000000) / usec);
+		}
+
+		printf("\n");
+	}
+
+	for (f = 0; f < NFILES; f++) {
+		close(fds[f]);
+		snprintf(path, sizeof(path), "%s/aio_perf%d.dat", dir, f);
+		unlink(path);
+	}
+
+	return errors;
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int aio_performance_main(int argc, char *argv[])
+#endif
+{
+	const char *dirs[] = { CONFIG_EXAMPLES_AIO_PERFORMANCE_SMARTFS_DIR, CONFIG_EXAMPLES_AIO_PERFORMANCE_TMPFS_DIR };
+	int loops = 1;
+	int errors = 0;
+	int i;
+
+	if (argc > 1) {
+		loops = atoi(argv[1]);
+		if (loops <= 0) {
+			printf("Usage: %s [loops [dir ...]]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	aio_perf_fill(g_wbuf, sizeof(g_wbuf));
+
+	if (argc > 2) {
+		for (i = 2; i < argc; i++) {
+			errors += aio_perf_dir(argv[i], loops);
+		}
+	} else {
+		for (i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++) {
+			errors += aio_perf_dir(dirs[i], loops);
+		}
+	}
+
+	if (errors != 0) {
+		printf("AIO performance test FAILED, %d errors\n", errors);
+		return -1;
+	}
+
+	printf("Done\n");
+	return 0;
+}
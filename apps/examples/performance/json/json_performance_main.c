@@ -0,0 +1,360 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file json_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <json/cJSON.h>
+
+#define DEFAULT_SENSORS		160
+#define MAX_SENSORS			1000
+#define SENSOR_DOC_SIZE		160
+#define PARSE_LOOPS			20
+#define LOOKUP_LOOPS		20
+#define ARENA_SLACK			256
+
+/* Allocations made through the cJSON hooks */
+
+static int g_mallocs;
+static int g_frees;
+
+static void *json_perf_malloc(size_t size)
+{
+	g_mallocs++;
+	return malloc(size);
+}
+
+static void json_perf_free(void *ptr)
+{
+	if (ptr) {
+		g_frees++;
+	}
+	free(ptr);
+}
+
+/*
+ * @fn                   :json_perf_usec
+ * @description          :Microseconds between two times, at least 1
+ * @return               :long long
+ */
+static long long json_perf_usec(struct timespec *stime, struct timespec *etime)
+{
+	long long usec;
+
+	usec = (long long)(etime->tv_sec - stime->tv_sec) * 1000000 + (etime->tv_nsec - stime->tv_nsec) / 1000;
+	return usec > 0 ? usec : 1;
+}
+
+/*
+ * @fn                   :json_perf_document
+ * @description          :Generate a device shadow document with 'sensors'
+ *                        reported values and their metadata
+ * @return               :document length, or -1 on error
+ */
+static int json_perf_document(char *doc, size_t size, int sensors)
+{
+	size_t len = 0;
+	int i;
+
+	len += snprintf(doc + len, size - len, "{\n  \"state\": {\n    \"reported\": {");
+	for (i = 0; i < sensors && len < size; i++) {
+		len += snprintf(doc + len, size - len, "%s\n      \"sensor%03d\": { \"value\": %d.%d, \"unit\": \"C\", \"ok\": %s, \"label\": \"Sensor \\\"%d\\\" \\u00e9\\n\" }",
+						i ? "," : "", i, 20 + i % 10, i % 10, (i % 3) ? "true" : "false", i);
+	}
+	if (len < size) {
+		len += snprintf(doc + len, size - len, "\n    },\n    \"desired\": { \"mode\": \"auto\", \"targets\": [21, 22.5, -3e2, null] }\n  },\n  \"metadata\": {");
+	}
+	for (i = 0; i < sensors && len < size; i++) {
+		len += snprintf(doc + len, size - len, "%s\n    \"sensor%03d\": { \"timestamp\": %d }", i ? "," : "", i, 1600000000 + i);
+	}
+	if (len < size) {
+		len += snprintf(doc + len, size - len, "\n  },\n  \"version\": 42,\n  \"timestamp\": 1600000000,\n  \"clientToken\": \"tizenrt-json-perf\"\n}\n");
+	}
+
+	return len < size ? (int)len : -1;
+}
+
+/*
+ * @fn                   :json_perf_verify
+ * @description          :Check that the arena and the in-situ results equal the
+ *                        heap result, that they take no allocation, and that a
+ *                        failed parse leaves the arena as it was
+ * @return               :number of errors
+ */
+static int json_perf_verify(const char *doc, char *copy, size_t doc_size, cJSON_Arena *arena, size_t used)
+{
+	static const char *const invalid[] = { "{\"a\": [1, 2,, 3]}", "{\"a\": \"\\q\"}", "{\"a\" 1}", "[\"\\ud800\"]" };
+	cJSON *heap;
+	cJSON *tree;
+	cJSON *item;
+	int errors = 0;
+	int i;
+
+	heap = cJSON_Parse(doc);
+	if (!heap) {
+		printf("heap parse failed\n");
+		return 1;
+	}
+
+	cJSON_ResetArena(arena);
+	g_mallocs = 0;
+	tree = cJSON_ParseInArena(arena, doc, NULL, 1);
+	if (!tree || !cJSON_Compare(heap, tree, 1) || g_mallocs != 0 || cJSON_ArenaUsed(arena) != used) {
+		printf("arena parse mismatch: %d allocations, %u bytes used\n", g_mallocs, (unsigned)cJSON_ArenaUsed(arena));
+		errors++;
+	}
+
+	memcpy(copy, doc, doc_size);
+	cJSON_ResetArena(arena);
+	tree = cJSON_ParseInSitu(arena, copy, NULL, 1);
+	if (!tree || !cJSON_Compare(heap, tree, 1) || g_mallocs != 0) {
+		printf("in-situ parse mismatch: %d allocations\n", g_mallocs);
+		errors++;
+	} else {
+		/* Strings point into the input */
+		item = cJSON_GetObjectItem(tree, "clientToken");
+		if (!item || item->valuestring < copy || item->valuestring >= copy + doc_size) {
+			printf("in-situ string not in the input\n");
+			errors++;
+		}
+	}
+
+	/* A second copy of the document does not fit, nothing is taken */
+
+	cJSON_ResetArena(arena);
+	tree = cJSON_ParseInArena(arena, doc, NULL, 1);
+	used = cJSON_ArenaUsed(arena);
+	if (!tree || cJSON_ParseInArena(arena, doc, NULL, 1) != NULL || cJSON_ArenaUsed(arena) != used) {
+		printf("arena overflow not detected\n");
+		errors++;
+	}
+
+	/* Invalid documents fail without taking arena memory */
+
+	for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+		cJSON_ResetArena(arena);
+		strcpy(copy, invalid[i]);
+		if (cJSON_ParseInArena(arena, invalid[i], NULL, 1) != NULL || cJSON_ParseInSitu(arena, copy, NULL, 1) != NULL || cJSON_ArenaUsed(arena) != 0) {
+			printf("invalid document %d accepted\n", i);
+			errors++;
+		}
+	}
+
+	/* Key lookup */
+
+	item = cJSON_GetObjectItem(cJSON_GetObjectItem(heap, "state"), "reported");
+	if (!cJSON_GetObjectItem(item, "SENSOR000") || cJSON_GetObjectItemCaseSensitive(item, "SENSOR000") || !cJSON_GetObjectItemCaseSensitive(item, "sensor000") || cJSON_GetObjectItem(item, "sensor00") || cJSON_GetObjectItem(item, "")) {
+		printf("key lookup mismatch\n");
+		errors++;
+	}
+
+	cJSON_Delete(heap);
+	cJSON_ResetArena(arena);
+	return errors;
+}
+
+/*
+ * @fn                   :json_perf_measure
+ * @description          :Print the allocations and the time of each parse mode
+ *                        and of the object key lookup
+ * @return               :void
+ */
+static void json_perf_measure(const char *doc, char *copy, size_t doc_size, cJSON_Arena *arena, int sensors, int scale)
+{
+	struct timespec stime;
+	struct timespec etime;
+	char name[16];
+	cJSON *tree;
+	cJSON *reported;
+	long long usec;
+	int loops = PARSE_LOOPS * scale;
+	int mallocs;
+	int found;
+	int i;
+	int n;
+
+	/* Heap: one allocation per node and per string, freed one by one */
+
+	g_mallocs = 0;
+	g_frees = 0;
+	sched_lock();
+	clock_gettime(CLOCK_REALTIME, &stime);
+	for (i = 0; i < loops; i++) {
+		tree = cJSON_Parse(doc);
+		cJSON_Delete(tree);
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	sched_unlock();
+	usec = json_perf_usec(&stime, &etime);
+	printf("heap     %6u  %8d  %9lld\n", (unsigned)doc_size, g_mallocs / loops, usec / loops);
+
+	/* Arena: released in one go */
+
+	g_mallocs = 0;
+	sched_lock();
+	clock_gettime(CLOCK_REALTIME, &stime);
+	for (i = 0; i < loops; i++) {
+		tree = cJSON_ParseInArena(arena, doc, NULL, 1);
+		cJSON_ResetArena(arena);
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	sched_unlock();
+	usec = json_perf_usec(&stime, &etime);
+	printf("arena    %6u  %8d  %9lld\n", (unsigned)doc_size, g_mallocs / loops, usec / loops);
+
+	/* In-situ: the input is consumed, so the copy is part of the cost */
+
+	g_mallocs = 0;
+	sched_lock();
+	clock_gettime(CLOCK_REALTIME, &stime);
+	for (i = 0; i < loops; i++) {
+		memcpy(copy, doc, doc_size);
+		tree = cJSON_ParseInSitu(arena, copy, NULL, 1);
+		cJSON_ResetArena(arena);
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	sched_unlock();
+	usec = json_perf_usec(&stime, &etime);
+	mallocs = g_mallocs;
+	printf("in-situ  %6u  %8d  %9lld\n", (unsigned)doc_size, mallocs / loops, usec / loops);
+
+	/* Look up every reported sensor, case insensitively as the names differ in case */
+
+	tree = cJSON_ParseInArena(arena, doc, NULL, 1);
+	reported = cJSON_GetObjectItem(cJSON_GetObjectItem(tree, "state"), "reported");
+	found = 0;
+	loops = LOOKUP_LOOPS * scale;
+	sched_lock();
+	clock_gettime(CLOCK_REALTIME, &stime);
+	for (i = 0; i < loops; i++) {
+		for (n = 0; n < sensors; n++) {
+			snprintf(name, sizeof(name), "SENSOR%03d", n);
+			if (cJSON_GetObjectItem(reported, name)) {
+				found++;
+			}
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	sched_unlock();
+	usec = json_perf_usec(&stime, &etime);
+	cJSON_ResetArena(arena);
+	printf("lookup of %d keys in an object of %d: %lld ns per key%s\n", sensors, sensors,
+		   usec * 1000 / ((long long)loops * sensors), found == loops * sensors ? "" : " (MISSING KEYS)");
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int json_performance_main(int argc, char *argv[])
+#endif
+{
+	cJSON_Hooks hooks = { json_perf_malloc, json_perf_free };
+	cJSON_Arena arena;
+	cJSON *tree;
+	char *doc;
+	char *copy;
+	void *buffer;
+	size_t doc_size;
+	size_t used;
+	int sensors = DEFAULT_SENSORS;
+	int scale = 1;
+	int errors;
+	int len;
+
+	if (argc > 1) {
+		sensors = atoi(argv[1]);
+	}
+	if (argc > 2) {
+		scale = atoi(argv[2]);
+	}
+	if (sensors <= 0 || sensors > MAX_SENSORS || scale <= 0) {
+		printf("Usage: %s [sensors] [loops]\n", argv[0]);
+		return -1;
+	}
+
+	doc_size = (size_t)sensors * SENSOR_DOC_SIZE + 256;
+	doc = malloc(doc_size);
+	copy = malloc(doc_size);
+	if (!doc || !copy) {
+		printf("Cannot allocate the document\n");
+		goto errout_with_doc;
+	}
+	len = json_perf_document(doc, doc_size, sensors);
+	if (len < 0) {
+		printf("Cannot generate the document\n");
+		goto errout_with_doc;
+	}
+	doc_size = len + 1;
+
+	/*
+	 * Find out how much arena the document takes. A string is first given room
+	 * for its escaped length, so leave some slack above the final use.
+	 */
+
+	buffer = malloc(doc_size * 8);
+	if (!buffer) {
+		printf("Cannot allocate the arena\n");
+		goto errout_with_doc;
+	}
+	cJSON_InitArena(&arena, buffer, doc_size * 8);
+	tree = cJSON_ParseInArena(&arena, doc, NULL, 1);
+	used = cJSON_ArenaUsed(&arena);
+	free(buffer);
+	if (!tree) {
+		printf("Cannot parse the document\n");
+		goto errout_with_doc;
+	}
+	buffer = malloc(used + ARENA_SLACK);
+	if (!buffer) {
+		printf("Cannot allocate the arena\n");
+		goto errout_with_doc;
+	}
+	cJSON_InitArena(&arena, buffer, used + ARENA_SLACK);
+
+	cJSON_InitHooks(&hooks);
+	errors = json_perf_verify(doc, copy, doc_size, &arena, used);
+	if (errors != 0) {
+		printf("cJSON parse verification FAILED, %d errors\n", errors);
+		goto errout_with_arena;
+	}
+	printf("cJSON parse verification passed, arena of %u bytes\n", (unsigned)used);
+
+	printf("mode       bytes    allocs  usec/parse\n");
+	json_perf_measure(doc, copy, doc_size, &arena, sensors, scale);
+
+	cJSON_InitHooks(NULL);
+	free(buffer);
+	free(copy);
+	free(doc);
+	printf("Done\n");
+	return 0;
+
+errout_with_arena:
+	cJSON_InitHooks(NULL);
+	free(buffer);
+errout_with_doc:
+	free(copy);
+	free(doc);
+	return -1;
+}
@@ -0,0 +1,428 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file mqtt_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <mosquitto.h>
+
+#define MQTT_PERF_PORT		18830
+#define MQTT_PERF_TOPIC		"perf/telemetry"
+#define MQTT_PERF_PAYLOAD	32
+#define MQTT_PERF_TIMEOUT	120
+#define BROKER_BUF_SIZE		2048
+#define BROKER_MAX_ACKS		(BROKER_BUF_SIZE / 4)
+
+/* One bit per message id */
+
+#define MID_MAP_SIZE		(65536 / 8)
+#define MID_TEST(map, mid)	((map)[(mid) >> 3] & (1 << ((mid) & 7)))
+#define MID_SET(map, mid)	((map)[(mid) >> 3] |= (1 << ((mid) & 7)))
+
+/* Broker stand-in state */
+
+static int g_listen_fd = -1;
+static volatile int g_broker_stop;
+static int g_received;
+static int g_redelivered;
+static uint8_t g_received_map[MID_MAP_SIZE];
+
+/* Client state */
+
+static volatile int g_connected;
+static int g_acked;
+static int g_ack_errors;
+static uint8_t g_acked_map[MID_MAP_SIZE];
+
+/*
+ * @fn                   :mqtt_perf_usec
+ * @description          :Microseconds between two times, at least 1
+ * @return               :long long
+ */
+static long long mqtt_perf_usec(struct timespec *stime, struct timespec *etime)
+{
+	long long usec;
+
+	usec = (long long)(etime->tv_sec - stime->tv_sec) * 1000000 + (etime->tv_nsec - stime->tv_nsec) / 1000;
+	return usec > 0 ? usec : 1;
+}
+
+/*
+ * @fn                   :broker_send
+ * @description          :Send the whole buffer to the client
+ * @return               :0 on success, -1 on error
+ */
+static int broker_send(int fd, const uint8_t *buf, size_t len)
+{
+	ssize_t r;
+
+	while (len > 0) {
+		r = send(fd, buf, len, 0);
+		if (r <= 0) {
+			return -1;
+		}
+		buf += r;
+		len -= r;
+	}
+	return 0;
+}
+
+/*
+ * @fn                   :broker_serve
+ * @description          :Answer CONNECT, PUBLISH and PINGREQ packets of one
+ *                        connection.  The PUBLISH packets of each read are
+ *                        acknowledged together, in the reverse order of arrival,
+ *                        as a broker with several worker threads may do.
+ * @return               :void
+ */
+static void broker_serve(int fd)
+{
+	static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+	static const uint8_t pingresp[] = { 0xd0, 0x00 };
+	uint8_t buf[BROKER_BUF_SIZE];
+	uint8_t acks[BROKER_MAX_ACKS * 4];
+	uint16_t mids[BROKER_MAX_ACKS];
+	size_t len = 0;
+	size_t pos;
+	size_t hdr;
+	size_t rlen;
+	size_t tlen;
+	uint16_t mid;
+	ssize_t r;
+	int nmids;
+	int shift;
+	int i;
+
+	while (!g_broker_stop) {
+		r = recv(fd, buf + len, sizeof(buf) - len, 0);
+		if (r <= 0) {
+			return;
+		}
+		len += r;
+
+		pos = 0;
+		nmids = 0;
+		while (len - pos >= 2 && nmids < BROKER_MAX_ACKS) {
+			/* Fixed header: type and flags, then the remaining length */
+			rlen = 0;
+			shift = 0;
+			for (hdr = 1; hdr < 5 && pos + hdr < len; hdr++) {
+				rlen |= (size_t)(buf[pos + hdr] & 0x7f) << shift;
+				shift += 7;
+				if (!(buf[pos + hdr] & 0x80)) {
+					break;
+				}
+			}
+			if (hdr == 5 || pos + hdr >= len || (buf[pos + hdr] & 0x80)) {
+				break;
+			}
+			hdr++;
+			if (pos + hdr + rlen > len) {
+				break;
+			}
+
+			switch (buf[pos] >> 4) {
+			case 1:		/* CONNECT */
+				if (broker_send(fd, connack, sizeof(connack)) != 0) {
+					return;
+				}
+				break;
+			case 3:		/* PUBLISH, QoS 1 */
+				tlen = (buf[pos + hdr] << 8) | buf[pos + hdr + 1];
+				if (((buf[pos] >> 1) & 3) == 0 || 4 + tlen > rlen) {
+					break;
+				}
+				mid = (buf[pos + hdr + 2 + tlen] << 8) | buf[pos + hdr + 3 + tlen];
+				if (MID_TEST(g_received_map, mid)) {
+					g_redelivered++;
+				} else {
+					MID_SET(g_received_map, mid);
+				}
+				g_received++;
+				mids[nmids++] = mid;
+				break;
+			case 12:	/* PINGREQ */
+				if (broker_send(fd, pingresp, sizeof(pingresp)) != 0) {
+					return;
+				}
+				break;
+			case 14:	/* DISCONNECT */
+				return;
+			default:
+				break;
+			}
+			pos += hdr + rlen;
+		}
+
+		if (pos == 0 && len == sizeof(buf)) {
+			printf("broker: packet too large\n");
+			return;
+		}
+		memmove(buf, buf + pos, len - pos);
+		len -= pos;
+
+		for (i = 0; i < nmids; i++) {
+			mid = mids[nmids - 1 - i];
+			acks[i * 4] = 0x40;
+			acks[i * 4 + 1] = 0x02;
+			acks[i * 4 + 2] = mid >> 8;
+			acks[i * 4 + 3] = mid & 0xff;
+		}
+		if (nmids > 0 && broker_send(fd, acks, nmids * 4) != 0) {
+			return;
+		}
+	}
+}
+
+/*
+ * @fn                   :broker_thread
+ * @description          :Accept and serve client connections until stopped
+ * @return               :void *
+ */
+static void *broker_thread(void *arg)
+{
+	int fd;
+
+	while (!g_broker_stop) {
+		fd = accept(g_listen_fd, NULL, NULL);
+		if (fd < 0) {
+			continue;
+		}
+		broker_serve(fd);
+		close(fd);
+	}
+	return NULL;
+}
+
+/*
+ * @fn                   :broker_start
+ * @description          :Listen on the loopback interface and start the broker stand-in
+ * @return               :0 on success, -1 on error
+ */
+static int broker_start(pthread_t *tid)
+{
+	struct sockaddr_in addr;
+	int opt = 1;
+
+	g_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (g_listen_fd < 0) {
+		return -1;
+	}
+	setsockopt(g_listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(MQTT_PERF_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(g_listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(g_listen_fd, 1) < 0) {
+		close(g_listen_fd);
+		return -1;
+	}
+
+	g_broker_stop = 0;
+	if (pthread_create(tid, NULL, broker_thread, NULL) != 0) {
+		close(g_listen_fd);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * @fn                   :broker_stop
+ * @description          :Stop the broker stand-in
+ * @return               :void
+ */
+static void broker_stop(pthread_t tid)
+{
+	struct sockaddr_in addr;
+	int fd;
+
+	g_broker_stop = 1;
+
+	/* Wake up accept() */
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd >= 0) {
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(MQTT_PERF_PORT);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		connect(fd, (struct sockaddr *)&addr, sizeof(addr));
+		close(fd);
+	}
+	pthread_join(tid, NULL);
+	close(g_listen_fd);
+	g_listen_fd = -1;
+}
+
+static void mqtt_perf_on_connect(struct mosquitto *mosq, void *obj, int rc)
+{
+	g_connected = (rc == 0) ? 1 : -1;
+}
+
+static void mqtt_perf_on_publish(struct mosquitto *mosq, void *obj, int mid)
+{
+	/* Each message must be reported exactly once */
+	if (MID_TEST(g_acked_map, mid)) {
+		g_ack_errors++;
+	} else {
+		MID_SET(g_acked_map, mid);
+		g_acked++;
+	}
+}
+
+/*
+ * @fn                   :mqtt_perf_replay
+ * @description          :Queue a backlog of QoS 1 messages while offline, then
+ *                        connect and time the replay until every message is
+ *                        acknowledged
+ * @return               :0 on success, -1 on error
+ */
+static int mqtt_perf_replay(int nmsgs, int inflight)
+{
+	struct mosquitto *mosq;
+	struct timespec stime;
+	struct timespec etime;
+	struct timespec qtime;
+	uint8_t payload[MQTT_PERF_PAYLOAD];
+	long long queue_usec;
+	long long replay_usec;
+	time_t deadline;
+	int ret = -1;
+	int rc;
+	int i;
+
+	g_connected = 0;
+	g_acked = 0;
+	g_ack_errors = 0;
+	g_received = 0;
+	g_redelivered = 0;
+	memset(g_acked_map, 0, sizeof(g_acked_map));
+	memset(g_received_map, 0, sizeof(g_received_map));
+
+	mosq = mosquitto_new("mqtt_perf", true, NULL);
+	if (!mosq) {
+		printf("Cannot create the client\n");
+		return -1;
+	}
+	mosquitto_connect_callback_set(mosq, mqtt_perf_on_connect);
+	mosquitto_publish_callback_set(mosq, mqtt_perf_on_publish);
+	mosquitto_max_inflight_messages_set(mosq, inflight);
+
+	/* The backlog builds up while there is no connection */
+
+	clock_gettime(CLOCK_REALTIME, &stime);
+	for (i = 0; i < nmsgs; i++) {
+		memset(payload, i, sizeof(payload));
+		rc = mosquitto_publish(mosq, NULL, MQTT_PERF_TOPIC, sizeof(payload), payload, 1, false);
+		if (rc != MOSQ_ERR_SUCCESS && rc != MOSQ_ERR_NO_CONN) {
+			printf("publish failed: %d\n", rc);
+			goto done;
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &qtime);
+	queue_usec = mqtt_perf_usec(&stime, &qtime);
+
+	clock_gettime(CLOCK_REALTIME, &stime);
+	if (mosquitto_connect(mosq, "127.0.0.1", MQTT_PERF_PORT, 60) != MOSQ_ERR_SUCCESS) {
+		printf("Cannot connect to the broker stand-in\n");
+		goto done;
+	}
+
+	deadline = time(NULL) + MQTT_PERF_TIMEOUT;
+	while (g_acked < nmsgs && g_connected >= 0 && time(NULL) < deadline) {
+		rc = mosquitto_loop(mosq, 100, 1);
+		if (rc != MOSQ_ERR_SUCCESS) {
+			printf("loop failed: %d\n", rc);
+			goto done;
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	replay_usec = mqtt_perf_usec(&stime, &etime);
+
+	if (g_acked != nmsgs || g_ack_errors != 0 || g_received < nmsgs) {
+		printf("replay mismatch: %d messages, %d acknowledged, %d reported twice, %d received\n", nmsgs, g_acked, g_ack_errors, g_received);
+		goto done;
+	}
+
+	/* msgs/s = msgs / (usec / 1000000) */
+
+	printf("%6d  %8d  %8lld  %9lld  %9lld  %11d\n", nmsgs, inflight, queue_usec / 1000, replay_usec / 1000,
+		   (long long)nmsgs * 1000000 / replay_usec, g_redelivered);
+	ret = 0;
+
+done:
+	mosquitto_disconnect(mosq);
+	mosquitto_destroy(mosq);
+	return ret;
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int mqtt_performance_main(int argc, char *argv[])
+#endif
+{
+	static const int inflight[] = { 20, 100, 0 };
+	pthread_t tid;
+	int nmsgs = 2000;
+	int errors = 0;
+	int i;
+
+	if (argc > 1) {
+		nmsgs = atoi(argv[1]);
+		if (nmsgs <= 0 || nmsgs > 65535) {
+			printf("Usage: %s [messages]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	mosquitto_lib_init();
+	if (broker_start(&tid) != 0) {
+		printf("Cannot start the broker stand-in\n");
+		mosquitto_lib_cleanup();
+		return -1;
+	}
+
+	printf("  msgs  inflight  queue ms  replay ms     msgs/s  redelivered\n");
+	for (i = 0; i < sizeof(inflight) / sizeof(inflight[0]); i++) {
+		if (mqtt_perf_replay(nmsgs, inflight[i]) != 0) {
+			errors++;
+		}
+	}
+
+	broker_stop(tid);
+	mosquitto_lib_cleanup();
+
+	if (errors != 0) {
+		printf("MQTT replay FAILED\n");
+		return -1;
+	}
+	printf("Done\n");
+	return 0;
+}
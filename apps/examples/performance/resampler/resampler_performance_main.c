@@ -0,0 +1,384 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file resampler_performance_main.c
+
+#ifndef RESAMPLER_PERF_HOST
+#include <tinyara/config.h>
+#include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "samplerate.h"
+
+#define CHUNK_FRAMES	240		/* Frames handed to src_simple() at a time */
+#define OUT_FRAMES		256		/* Room for output frames per call */
+#define SRC_BUFSIZE		4096	/* As CONFIG_AUDIO_RESAMPLER_BUFSIZE */
+#define TEST_SECONDS	1
+#define SKIP_FRAMES		64		/* Edges of the output left out of the SNR */
+#define AMPLITUDE		16384.0
+
+#define PERF_PI			3.14159265358979
+
+#ifdef RESAMPLER_PERF_HOST
+#define sched_lock()
+#define sched_unlock()
+
+/* The framework's rechannel() needs the TizenRT headers; the host run only
+ * converts mono to mono and stereo to stereo.
+ */
+
+uint32_t ch2layout(uint32_t nb_chs)
+{
+	return nb_chs;
+}
+
+int32_t rechannel(uint32_t in_layout, uint32_t out_layout, const int16_t *input, uint32_t in_frames, int16_t *output, uint32_t max_frames)
+{
+	if (in_layout != out_layout) {
+		return -1;
+	}
+	if (in_frames > max_frames) {
+		in_frames = max_frames;
+	}
+	memmove(output, input, in_frames * in_layout * sizeof(int16_t));
+	return in_frames;
+}
+#endif
+
+struct conversion_s {
+	int in_rate;
+	int out_rate;
+};
+
+static const struct conversion_s g_conversions[] = {
+	{ 44100, 16000 },	/* voice capture */
+	{ 48000, 16000 },
+	{ 22050, 48000 },	/* playback */
+	{ 16000, 48000 },
+	{ 44100, 48000 },
+	{ 48000, 44100 },
+	{ 8000, 16000 },
+};
+
+#define NUM_CONVERSIONS (sizeof(g_conversions) / sizeof(g_conversions[0]))
+
+/*
+ * @fn                   :resampler_perf_tone
+ * @description          :Fill interleaved frames with a sine of the given frequency on every channel
+ * @return               :void
+ */
+static void resampler_perf_tone(int16_t *buf, int frames, int channels, double freq, int rate)
+{
+	int i;
+	int c;
+
+	for (i = 0; i < frames; i++) {
+		int16_t s = (int16_t)lrint(AMPLITUDE * sin(2.0 * PERF_PI * freq * i / rate));
+		for (c = 0; c < channels; c++) {
+			buf[i * channels + c] = s;
+		}
+	}
+}
+
+/*
+ * @fn                   :resampler_perf_convert
+ * @description          :Convert a whole buffer the way the audio manager does,
+ *                        in chunks and into a small output buffer. A new handle
+ *                        is used if none is given.
+ * @return               :number of output frames, negative on error
+ */
+static int resampler_perf_convert(src_handle_t handle, const struct conversion_s *conv, int channels, const int16_t *in, int in_frames, int16_t *out, int out_max)
+{
+	src_handle_t own = NULL;
+	src_data_t data;
+	int in_done = 0;
+	int out_done = 0;
+	int ret = 0;
+
+	if (handle == NULL) {
+		own = handle = src_init(SRC_BUFSIZE);
+		if (handle == NULL) {
+			return -1;
+		}
+	}
+
+	memset(&data, 0, sizeof(data));
+	data.origin_sample_rate = conv->in_rate;
+	data.origin_channel_num = channels;
+	data.origin_sample_width = SAMPLE_WIDTH_16BITS;
+	data.desired_sample_rate = conv->out_rate;
+	data.desired_channel_num = channels;
+	data.desired_sample_width = SAMPLE_WIDTH_16BITS;
+
+	while (out_done < out_max) {
+		int chunk = in_frames - in_done;
+		int room = out_max - out_done;
+
+		if (chunk > CHUNK_FRAMES) {
+			chunk = CHUNK_FRAMES;
+		}
+		if (room > OUT_FRAMES) {
+			room = OUT_FRAMES;
+		}
+
+		data.data_in = in + in_done * channels;
+		data.input_frames = chunk;
+		data.data_out = out + out_done * channels;
+		data.out_buf_length = room * channels * sizeof(int16_t);
+		ret = src_simple(handle, &data);
+		if (ret != SRC_ERR_NO_ERROR) {
+			break;
+		}
+
+		in_done += data.input_frames_used;
+		out_done += data.output_frames_gen;
+		if (data.input_frames_used == 0 && data.output_frames_gen == 0) {
+			break;
+		}
+	}
+
+	if (own != NULL) {
+		src_destroy(own);
+	}
+	return ret == SRC_ERR_NO_ERROR ? out_done : ret;
+}
+
+/*
+ * @fn                   :resampler_perf_snr
+ * @description          :Fit a sine of the given frequency to the output by least
+ *                        squares and compare the rest with it. The gain of the fit
+ *                        shows the passband ripple, the rest is noise and distortion.
+ * @return               :signal to noise ratio in dB
+ */
+static double resampler_perf_snr(const int16_t *out, int frames, int channels, double freq, int rate, double *gain)
+{
+	double ss = 0.0;
+	double cc = 0.0;
+	double sc = 0.0;
+	double ys = 0.0;
+	double yc = 0.0;
+	double a;
+	double b;
+	double det;
+	double signal = 0.0;
+	double noise = 0.0;
+	int i;
+	int c;
+
+	for (i = SKIP_FRAMES; i < frames - SKIP_FRAMES; i++) {
+		double s = sin(2.0 * PERF_PI * freq * i / rate);
+		double co = cos(2.0 * PERF_PI * freq * i / rate);
+		for (c = 0; c < channels; c++) {
+			ss += s * s;
+			cc += co * co;
+			sc += s * co;
+			ys += out[i * channels + c] * s;
+			yc += out[i * channels + c] * co;
+		}
+	}
+
+	det = ss * cc - sc * sc;
+	if (det <= 0.0) {
+		*gain = -200.0;
+		return 0.0;
+	}
+
+	a = (ys * cc - yc * sc) / det;
+	b = (yc * ss - ys * sc) / det;
+	*gain = 20.0 * log10(sqrt(a * a + b * b) / AMPLITUDE);
+
+	for (i = SKIP_FRAMES; i < frames - SKIP_FRAMES; i++) {
+		double fit = a * sin(2.0 * PERF_PI * freq * i / rate) + b * cos(2.0 * PERF_PI * freq * i / rate);
+		for (c = 0; c < channels; c++) {
+			double err = out[i * channels + c] - fit;
+			signal += fit * fit;
+			noise += err * err;
+		}
+	}
+
+	if (noise <= 0.0) {
+		return 200.0;
+	}
+
+	return 10.0 * log10(signal / noise);
+}
+
+/*
+ * @fn                   :resampler_perf_level
+ * @description          :Level of the output relative to a full sine of AMPLITUDE
+ * @return               :level in dB
+ */
+static double resampler_perf_level(const int16_t *out, int frames, int channels)
+{
+	double energy = 0.0;
+	int n = 0;
+	int i;
+
+	for (i = SKIP_FRAMES * channels; i < (frames - SKIP_FRAMES) * channels; i++, n++) {
+		energy += (double)out[i] * out[i];
+	}
+
+	if (energy <= 0.0 || n == 0) {
+		return -200.0;
+	}
+
+	return 10.0 * log10(energy / n / (AMPLITUDE * AMPLITUDE / 2.0));
+}
+
+/*
+ * @fn                   :resampler_perf_run
+ * @description          :Quality and speed of one conversion
+ * @return               :0 on success
+ */
+static int resampler_perf_run(const struct conversion_s *conv, int channels, int scale)
+{
+	int in_frames = conv->in_rate * TEST_SECONDS;
+	int out_max = (int)((long long)in_frames * conv->out_rate / conv->in_rate);
+	int nyquist = (conv->in_rate < conv->out_rate ? conv->in_rate : conv->out_rate) / 2;
+	double high = nyquist * 0.8;
+	struct timespec stime;
+	struct timespec etime;
+	long long usec;
+	long long setup;
+	src_handle_t handle;
+	double snr_low;
+	double snr_high;
+	double gain_low;
+	double gain_high;
+	double alias = 0.0;
+	int16_t *in;
+	int16_t *out;
+	int frames = 0;
+	int loop;
+
+	in = (int16_t *)malloc(in_frames * channels * sizeof(int16_t));
+	out = (int16_t *)malloc(out_max * channels * sizeof(int16_t));
+	if (in == NULL || out == NULL) {
+		printf("Out of memory\n");
+		free(in);
+		free(out);
+		return -1;
+	}
+
+	resampler_perf_tone(in, in_frames, channels, 1000.0, conv->in_rate);
+	frames = resampler_perf_convert(NULL, conv, channels, in, in_frames, out, out_max);
+	snr_low = resampler_perf_snr(out, frames, channels, 1000.0, conv->out_rate, &gain_low);
+
+	resampler_perf_tone(in, in_frames, channels, high, conv->in_rate);
+	frames = resampler_perf_convert(NULL, conv, channels, in, in_frames, out, out_max);
+	snr_high = resampler_perf_snr(out, frames, channels, high, conv->out_rate, &gain_high);
+
+	/* A tone above the output Nyquist frequency must be filtered out, not folded back */
+
+	if (conv->out_rate < conv->in_rate) {
+		double above = conv->out_rate / 2 + (conv->in_rate / 2 - conv->out_rate / 2) * 0.6;
+		resampler_perf_tone(in, in_frames, channels, above, conv->in_rate);
+		frames = resampler_perf_convert(NULL, conv, channels, in, in_frames, out, out_max);
+		alias = resampler_perf_level(out, frames, channels);
+	}
+
+	/* Setup designs the filter on the first call, then the stream is converted on */
+
+	handle = src_init(SRC_BUFSIZE);
+	if (handle == NULL) {
+		printf("Out of memory\n");
+		free(in);
+		free(out);
+		return -1;
+	}
+
+	sched_lock();
+	clock_gettime(CLOCK_REALTIME, &stime);
+	resampler_perf_convert(handle, conv, channels, in, 1, out, 1);
+	clock_gettime(CLOCK_REALTIME, &etime);
+	setup = (long long)(etime.tv_sec - stime.tv_sec) * 1000000 + (etime.tv_nsec - stime.tv_nsec) / 1000;
+
+	clock_gettime(CLOCK_REALTIME, &stime);
+	for (loop = 0; loop < scale; loop++) {
+		frames = resampler_perf_convert(handle, conv, channels, in, in_frames, out, out_max);
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	sched_unlock();
+
+	src_destroy(handle);
+
+	usec = (long long)(etime.tv_sec - stime.tv_sec) * 1000000 + (etime.tv_nsec - stime.tv_nsec) / 1000;
+	if (usec <= 0) {
+		usec = 1;
+	}
+
+	printf("%5d -> %5d %s: SNR 1kHz %5.1f dB (%5.2f dB), %5.0fHz %5.1f dB (%5.2f dB)", conv->in_rate, conv->out_rate, channels == 1 ? "mono  " : "stereo", snr_low, gain_low, high, snr_high, gain_high);
+	if (conv->out_rate < conv->in_rate) {
+		printf(", alias %6.1f dB", alias);
+	} else {
+		printf(", alias    -     ");
+	}
+
+	/* Time to set up, and to convert one second of audio */
+
+	printf(", setup %6lld us, %6lld us/s\n", setup, usec / (scale * TEST_SECONDS));
+
+	free(in);
+	free(out);
+	return frames > 0 ? 0 : -1;
+}
+
+#ifdef RESAMPLER_PERF_HOST
+int main(int argc, char *argv[])
+#elif defined(CONFIG_BUILD_KERNEL)
+int main(int argc, FAR char *argv[])
+#else
+int resampler_performance_main(int argc, char *argv[])
+#endif
+{
+	int scale = 1;
+	int errors = 0;
+	int channels;
+	size_t n;
+
+	if (argc > 1) {
+		scale = atoi(argv[1]);
+		if (scale <= 0) {
+			printf("Usage: %s [loops]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	for (channels = 1; channels <= 2; channels++) {
+		for (n = 0; n < NUM_CONVERSIONS; n++) {
+			if (resampler_perf_run(&g_conversions[n], channels, scale) != 0) {
+				errors++;
+			}
+		}
+	}
+
+	if (errors != 0) {
+		printf("Resampler test FAILED, %d conversions\n", errors);
+		return -1;
+	}
+
+	printf("Done\n");
+	return 0;
+}
@@ -0,0 +1,342 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file string_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+
+#define BUF_SIZE		4096
+#define BUF_ALIGN		8
+#define VERIFY_MAXLEN	256
+#define BYTES_PER_TEST	(1024 * 1024)
+
+/* Word aligned buffers with room to apply the test misalignments */
+
+static unsigned long g_src_buf[(BUF_SIZE + BUF_ALIGN) / sizeof(unsigned long) + 1];
+static unsigned long g_dst_buf[(BUF_SIZE + BUF_ALIGN) / sizeof(unsigned long) + 1];
+
+static const size_t g_sizes[] = { 8, 16, 32, 64, 128, 256, 512, 1024, 4096 };
+
+/* Results are accumulated here so that the calls can not be optimized away */
+
+static volatile uintptr_t g_sink;
+
+enum string_test_e {
+	TEST_MEMCPY = 0,
+	TEST_MEMSET,
+	TEST_MEMCMP,
+	TEST_MEMCHR,
+	TEST_STRLEN,
+	TEST_STRCHR,
+	TEST_NUM
+};
+
+static const char *g_test_names[TEST_NUM] = {
+	"memcpy", "memset", "memcmp", "memchr", "strlen", "strchr"
+};
+
+/*
+ * @fn                   :string_perf_fill
+ * @description          :Fill a buffer with a pattern which contains no NUL byte
+ *                        and no 0xff byte, so the whole length is scanned
+ * @return               :void
+ */
+static void string_perf_fill(unsigned char *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		buf[i] = (unsigned char)(1 + (i * 7) % 251);
+	}
+}
+
+/*
+ * @fn                   :string_perf_verify
+ * @description          :Check every function against a byte-wise reference
+ *                        for each length up to VERIFY_MAXLEN and each alignment
+ * @return               :number of mismatches
+ */
+static int string_perf_verify(void)
+{
+	unsigned char *sbase = (unsigned char *)g_src_buf;
+	unsigned char *dbase = (unsigned char *)g_dst_buf;
+	unsigned char *src;
+	unsigned char *dst;
+	int sa;
+	int da;
+	int errors = 0;
+	size_t len;
+	size_t i;
+
+	for (sa = 0; sa < BUF_ALIGN; sa++) {
+		for (da = 0; da < BUF_ALIGN; da++) {
+			for (len = 0; len <= VERIFY_MAXLEN; len++) {
+				src = sbase + sa;
+				dst = dbase + da;
+
+				/* memcpy must copy exactly len bytes */
+
+				string_perf_fill(sbase, BUF_SIZE + BUF_ALIGN);
+				memset(dbase, 0xa5, BUF_SIZE + BUF_ALIGN);
+				if (memcpy(dst, src, len) != dst) {
+					errors++;
+				}
+
+				for (i = 0; i < len; i++) {
+					if (dst[i] != src[i]) {
+						printf("memcpy mismatch: len %u src+%d dst+%d at %u\n", (unsigned)len, sa, da, (unsigned)i);
+						errors++;
+						break;
+					}
+				}
+
+				if (dst[len] != 0xa5 || (da > 0 && dst[-1] != 0xa5)) {
+					printf("memcpy overrun: len %u src+%d dst+%d\n", (unsigned)len, sa, da);
+					errors++;
+				}
+
+				/* memcmp must report a difference at any position with the right sign */
+
+				if (memcmp(dst, src, len) != 0) {
+					printf("memcmp equal: len %u src+%d dst+%d\n", (unsigned)len, sa, da);
+					errors++;
+				}
+
+				if (len > 0) {
+					i = (len * 5) / 7;
+					dst[i] = src[i] + 1;
+					if (memcmp(dst, src, len) <= 0 || memcmp(src, dst, len) >= 0) {
+						printf("memcmp order: len %u src+%d dst+%d at %u\n", (unsigned)len, sa, da, (unsigned)i);
+						errors++;
+					}
+				}
+
+				if (sa != 0) {
+					continue;
+				}
+
+				/* memset, memchr, strlen and strchr only depend on one pointer */
+
+				memset(dbase, 0xa5, BUF_SIZE + BUF_ALIGN);
+				if (memset(dst, 0x3c, len) != dst) {
+					errors++;
+				}
+
+				for (i = 0; i < len; i++) {
+					if (dst[i] != 0x3c) {
+						printf("memset mismatch: len %u dst+%d at %u\n", (unsigned)len, da, (unsigned)i);
+						errors++;
+						break;
+					}
+				}
+
+				if (dst[len] != 0xa5 || (da > 0 && dst[-1] != 0xa5)) {
+					printf("memset overrun: len %u dst+%d\n", (unsigned)len, da);
+					errors++;
+				}
+
+				string_perf_fill(dbase, BUF_SIZE + BUF_ALIGN);
+				dst[len] = 0xff;
+				if (memchr(dst, 0xff, len) != NULL || memchr(dst, 0xff, len + 1) != dst + len) {
+					printf("memchr mismatch: len %u dst+%d\n", (unsigned)len, da);
+					errors++;
+				}
+
+				dst[len] = '\0';
+				if (strlen((char *)dst) != len) {
+					printf("strlen mismatch: len %u dst+%d\n", (unsigned)len, da);
+					errors++;
+				}
+
+				if (strchr((char *)dst, 0xff) != NULL || strchr((char *)dst, '\0') != (char *)dst + len) {
+					printf("strchr mismatch: len %u dst+%d\n", (unsigned)len, da);
+					errors++;
+				}
+
+				if (len > 0 && strchr((char *)dst, dst[len - 1]) > (char *)dst + len - 1) {
+					printf("strchr last: len %u dst+%d\n", (unsigned)len, da);
+					errors++;
+				}
+			}
+		}
+	}
+
+	return errors;
+}
+
+/*
+ * @fn                   :string_perf_run
+ * @description          :Run one function 'loops' times over 'len' bytes
+ * @return               :void
+ */
+static void string_perf_run(int test, unsigned char *dst, unsigned char *src, size_t len, int loops)
+{
+	/* Reload the pointers on every iteration so that the pure functions (memcmp,
+	 * strlen, ...) can not be hoisted out of the loop by the compiler.
+	 */
+
+	unsigned char *volatile vdst = dst;
+	unsigned char *volatile vsrc = src;
+	uintptr_t acc = 0;
+	int i;
+
+	switch (test) {
+	case TEST_MEMCPY:
+		for (i = 0; i < loops; i++) {
+			acc += (uintptr_t)memcpy(vdst, vsrc, len);
+		}
+		break;
+
+	case TEST_MEMSET:
+		for (i = 0; i < loops; i++) {
+			acc += (uintptr_t)memset(vdst, i, len);
+		}
+		break;
+
+	case TEST_MEMCMP:
+		for (i = 0; i < loops; i++) {
+			acc += (uintptr_t)memcmp(vdst, vsrc, len);
+		}
+		break;
+
+	case TEST_MEMCHR:
+		for (i = 0; i < loops; i++) {
+			acc += (uintptr_t)memchr(vsrc, 0xff, len);
+		}
+		break;
+
+	case TEST_STRLEN:
+		for (i = 0; i < loops; i++) {
+			acc += strlen((char *)vsrc);
+		}
+		break;
+
+	case TEST_STRCHR:
+		for (i = 0; i < loops; i++) {
+			acc += (uintptr_t)strchr((char *)vsrc, 0xff);
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	g_sink += acc;
+}
+
+/*
+ * @fn                   :string_perf_measure
+ * @description          :Print the throughput of one function for each size
+ *                        at the given source and destination misalignment
+ * @return               :void
+ */
+static void string_perf_measure(int test, int salign, int dalign, int scale)
+{
+	unsigned char *src = (unsigned char *)g_src_buf + salign;
+	unsigned char *dst = (unsigned char *)g_dst_buf + dalign;
+	struct timespec stime;
+	struct timespec etime;
+	long long usec;
+	int loops;
+	int n;
+
+	printf("%-7s src+%d dst+%d  :", g_test_names[test], salign, dalign);
+
+	for (n = 0; n < sizeof(g_sizes) / sizeof(g_sizes[0]); n++) {
+		/* Prepare the inputs so that every function scans the whole length */
+
+		string_perf_fill((unsigned char *)g_src_buf, sizeof(g_src_buf));
+		src[g_sizes[n]] = '\0';
+		memcpy(dst, src, g_sizes[n]);
+
+		loops = (BYTES_PER_TEST / g_sizes[n]) * scale;
+
+		sched_lock();
+		clock_gettime(CLOCK_REALTIME, &stime);
+		string_perf_run(test, dst, src, g_sizes[n], loops);
+		clock_gettime(CLOCK_REALTIME, &etime);
+		sched_unlock();
+
+		usec = (long long)(etime.tv_sec - stime.tv_sec) * 1000000 + (etime.tv_nsec - stime.tv_nsec) / 1000;
+		if (usec <= 0) {
+			usec = 1;
+		}
+
+		/* KB/s = (bytes / 1024) / (usec / 1000000) */
+
+		printf(" %7lld", ((long long)g_sizes[n] * loops * 1000000 / 1024) / usec);
+	}
+
+	printf("\n");
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int string_performance_main(int argc, char *argv[])
+#endif
+{
+	int scale = 1;
+	int errors;
+	int test;
+	int n;
+
+	if (argc > 1) {
+		scale = atoi(argv[1]);
+		if (scale <= 0) {
+			printf("Usage: %s [loops]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	errors = string_perf_verify();
+	if (errors != 0) {
+		printf("String function verification FAILED, %d errors\n", errors);
+		return -1;
+	}
+
+	printf("String function verification passed\n");
+
+	printf("%-21s:", "KB/s for size");
+	for (n = 0; n < sizeof(g_sizes) / sizeof(g_sizes[0]); n++) {
+		printf(" %7u", (unsigned)g_sizes[n]);
+	}
+
+	printf("\n");
+
+	for (test = 0; test < TEST_NUM; test++) {
+		string_perf_measure(test, 0, 0, scale);
+		if (test == TEST_MEMCPY || test == TEST_MEMCMP) {
+			string_perf_measure(test, 1, 0, scale);
+			string_perf_measure(test, 0, 3, scale);
+		}
+
+		string_perf_measure(test, 1, 1, scale);
+		string_perf_measure(test, 3, 3, scale);
+	}
+
+	printf("Done, check sum %u\n", (unsigned)g_sink);
+	return 0;
+}
@@ -0,0 +1,532 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file uds_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+
+#define STREAM_BYTES		(256 * 1024)
+#define DGRAM_COUNT			2000
+#define DGRAM_SIZE			256
+#define PINGPONG_LOOPS		1000
+
+/* What one benchmark thread talks to: a socket or the two ends of a pipe */
+
+struct uds_perf_chan_s {
+	int rfd;
+	int wfd;
+	int sock;					/* Use send() and recv() instead of write() and read() */
+};
+
+struct uds_perf_job_s {
+	struct uds_perf_chan_s chan;
+	size_t msgsize;
+	size_t total;
+	int loops;
+	int result;
+};
+
+static const size_t g_msgsizes[] = { 64, 256, 1024, 4096 };
+
+/*
+ * @fn                   :uds_perf_usec
+ * @description          :Microseconds between two times, at least 1
+ * @return               :long long
+ */
+static long long uds_perf_usec(struct timespec *stime, struct timespec *etime)
+{
+	long long usec;
+
+	usec = (long long)(etime->tv_sec - stime->tv_sec) * 1000000 + (etime->tv_nsec - stime->tv_nsec) / 1000;
+	return usec > 0 ? usec : 1;
+}
+
+static ssize_t uds_perf_write(struct uds_perf_chan_s *chan, const void *buf, size_t len)
+{
+	return chan->sock ? send(chan->wfd, buf, len, 0) : write(chan->wfd, buf, len);
+}
+
+static ssize_t uds_perf_read(struct uds_perf_chan_s *chan, void *buf, size_t len)
+{
+	return chan->sock ? recv(chan->rfd, buf, len, 0) : read(chan->rfd, buf, len);
+}
+
+/*
+ * @fn                   :uds_perf_write_all
+ * @description          :Write the whole buffer, a stream may take it in parts
+ * @return               :0 on success, -1 on error
+ */
+static int uds_perf_write_all(struct uds_perf_chan_s *chan, const unsigned char *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = uds_perf_write(chan, buf, len);
+		if (ret <= 0) {
+			return -1;
+		}
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/*
+ * @fn                   :uds_perf_read_all
+ * @description          :Read exactly len bytes of a stream
+ * @return               :0 on success, -1 on error or end of stream
+ */
+static int uds_perf_read_all(struct uds_perf_chan_s *chan, unsigned char *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = uds_perf_read(chan, buf, len);
+		if (ret <= 0) {
+			return -1;
+		}
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/*
+ * @fn                   :uds_perf_writer
+ * @description          :Thread writing 'total' bytes of a known pattern in
+ *                        'msgsize' writes
+ * @return               :void*
+ */
+static void *uds_perf_writer(void *arg)
+{
+	struct uds_perf_job_s *job = (struct uds_perf_job_s *)arg;
+	unsigned char *buf;
+	size_t off;
+	size_t n;
+	size_t i;
+
+	job->result = -1;
+	buf = malloc(job->msgsize);
+	if (!buf) {
+		return NULL;
+	}
+
+	for (off = 0; off < job->total; off += n) {
+		n = job->total - off < job->msgsize ? job->total - off : job->msgsize;
+		for (i = 0; i < n; i++) {
+			buf[i] = (unsigned char)(off + i);
+		}
+		if (uds_perf_write_all(&job->chan, buf, n) < 0) {
+			goto errout;
+		}
+	}
+	job->result = 0;
+
+errout:
+	free(buf);
+	return NULL;
+}
+
+/*
+ * @fn                   :uds_perf_echo
+ * @description          :Thread sending every message back, for the round trips
+ * @return               :void*
+ */
+static void *uds_perf_echo(void *arg)
+{
+	struct uds_perf_job_s *job = (struct uds_perf_job_s *)arg;
+	unsigned char buf[64];
+	int i;
+
+	job->result = -1;
+	for (i = 0; i < job->loops; i++) {
+		if (uds_perf_read_all(&job->chan, buf, job->msgsize) < 0 || uds_perf_write_all(&job->chan, buf, job->msgsize) < 0) {
+			return NULL;
+		}
+	}
+	job->result = 0;
+	return NULL;
+}
+
+/*
+ * @fn                   :uds_perf_dgram_writer
+ * @description          :Thread sending 'loops' datagrams of growing sizes,
+ *                        each one starting with its sequence number
+ * @return               :void*
+ */
+static void *uds_perf_dgram_writer(void *arg)
+{
+	struct uds_perf_job_s *job = (struct uds_perf_job_s *)arg;
+	unsigned char buf[DGRAM_SIZE];
+	size_t len;
+	int i;
+
+	job->result = -1;
+	memset(buf, 0xa5, sizeof(buf));
+	for (i = 0; i < job->loops; i++) {
+		len = 2 + i % (job->msgsize - 1);
+		buf[0] = (unsigned char)i;
+		buf[1] = (unsigned char)(i >> 8);
+		if (send(job->chan.wfd, buf, len, 0) != (ssize_t)len) {
+			return NULL;
+		}
+	}
+	job->result = 0;
+	return NULL;
+}
+
+/*
+ * @fn                   :uds_perf_verify
+ * @description          :Check the stream and datagram semantics of socketpair()
+ * @return               :number of errors
+ */
+static int uds_perf_verify(void)
+{
+	struct pollfd pfd;
+	char buf[64];
+	int sv[2];
+	int errors = 0;
+
+	/* Stream: both directions, no data is a would-block, a close is an end of file */
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+		printf("socketpair(SOCK_STREAM) failed: %d\n", errno);
+		return 1;
+	}
+	if (send(sv[0], "hello", 5, 0) != 5 || send(sv[0], "world", 5, 0) != 5 || recv(sv[1], buf, sizeof(buf), 0) != 10 || memcmp(buf, "helloworld", 10) != 0) {
+		printf("stream data mismatch\n");
+		errors++;
+	}
+	if (send(sv[1], "back", 4, 0) != 4 || recv(sv[0], buf, 2, 0) != 2 || recv(sv[0], buf + 2, 2, 0) != 2 || memcmp(buf, "back", 4) != 0) {
+		printf("stream reverse data mismatch\n");
+		errors++;
+	}
+	if (recv(sv[1], buf, sizeof(buf), MSG_DONTWAIT) != -1 || errno != EAGAIN) {
+		printf("empty stream does not report EAGAIN\n");
+		errors++;
+	}
+	pfd.fd = sv[1];
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	send(sv[0], "x", 1, 0);
+	if (poll(&pfd, 1, 1000) != 1 || !(pfd.revents & POLLIN)) {
+		printf("stream poll does not report POLLIN\n");
+		errors++;
+	}
+	close(sv[0]);
+	if (recv(sv[1], buf, sizeof(buf), 0) != 1 || recv(sv[1], buf, sizeof(buf), 0) != 0) {
+		printf("stream end of file not reported\n");
+		errors++;
+	}
+	close(sv[1]);
+
+	/* Datagram: boundaries are kept, the part that does not fit is lost */
+
+	if (socketpair(AF_UNIX, SOCK_DGRAM, 0, sv) < 0) {
+		printf("socketpair(SOCK_DGRAM) failed: %d\n", errno);
+		return errors + 1;
+	}
+	if (send(sv[0], "one", 3, 0) != 3 || send(sv[0], "", 0, 0) != 0 || send(sv[0], "three", 5, 0) != 5) {
+		printf("datagram send failed\n");
+		errors++;
+	}
+	if (recv(sv[1], buf, sizeof(buf), 0) != 3 || memcmp(buf, "one", 3) != 0 || recv(sv[1], buf, sizeof(buf), 0) != 0 || recv(sv[1], buf, 2, 0) != 2 || memcmp(buf, "th", 2) != 0) {
+		printf("datagram boundaries not kept\n");
+		errors++;
+	}
+	if (recv(sv[1], buf, sizeof(buf), MSG_DONTWAIT) != -1 || errno != EAGAIN) {
+		printf("truncated datagram not discarded\n");
+		errors++;
+	}
+	close(sv[0]);
+	close(sv[1]);
+
+	return errors;
+}
+
+/*
+ * @fn                   :uds_perf_stream
+ * @description          :Move STREAM_BYTES through a channel with a writer
+ *                        thread, checking the data
+ * @return               :usec, or -1 on error
+ */
+static long long uds_perf_stream(struct uds_perf_chan_s *wchan, struct uds_perf_chan_s *rchan, size_t msgsize, size_t total)
+{
+	struct uds_perf_job_s job;
+	struct timespec stime;
+	struct timespec etime;
+	unsigned char *buf;
+	pthread_t writer;
+	size_t off = 0;
+	ssize_t n;
+	int errors = 0;
+	int i;
+
+	buf = malloc(msgsize);
+	if (!buf) {
+		return -1;
+	}
+
+	job.chan = *wchan;
+	job.msgsize = msgsize;
+	job.total = total;
+
+	clock_gettime(CLOCK_REALTIME, &stime);
+	if (pthread_create(&writer, NULL, uds_perf_writer, &job) != 0) {
+		free(buf);
+		return -1;
+	}
+	while (off < total) {
+		n = uds_perf_read(rchan, buf, msgsize);
+		if (n <= 0) {
+			break;
+		}
+		for (i = 0; i < n; i++) {
+			errors += buf[i] != (unsigned char)(off + i);
+		}
+		off += n;
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	pthread_join(writer, NULL);
+	free(buf);
+
+	if (off != total || errors != 0 || job.result != 0) {
+		printf("stream of %u byte writes failed: %u bytes, %d errors\n", (unsigned)msgsize, (unsigned)off, errors);
+		return -1;
+	}
+
+	return uds_perf_usec(&stime, &etime);
+}
+
+/*
+ * @fn                   :uds_perf_pingpong
+ * @description          :Time 'loops' round trips of 'msgsize' bytes
+ * @return               :usec, or -1 on error
+ */
+static long long uds_perf_pingpong(struct uds_perf_chan_s *local, struct uds_perf_chan_s *remote, size_t msgsize, int loops)
+{
+	struct uds_perf_job_s job;
+	struct timespec stime;
+	struct timespec etime;
+	unsigned char buf[64];
+	pthread_t echo;
+	int ret = 0;
+	int i;
+
+	job.chan = *remote;
+	job.msgsize = msgsize;
+	job.loops = loops;
+	if (pthread_create(&echo, NULL, uds_perf_echo, &job) != 0) {
+		return -1;
+	}
+
+	memset(buf, 0x5a, sizeof(buf));
+	clock_gettime(CLOCK_REALTIME, &stime);
+	for (i = 0; i < loops && ret == 0; i++) {
+		ret = uds_perf_write_all(local, buf, msgsize);
+		if (ret == 0) {
+			ret = uds_perf_read_all(local, buf, msgsize);
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	pthread_join(echo, NULL);
+
+	if (ret != 0 || job.result != 0) {
+		printf("round trip failed\n");
+		return -1;
+	}
+
+	return uds_perf_usec(&stime, &etime);
+}
+
+/*
+ * @fn                   :uds_perf_dgram
+ * @description          :Time 'count' datagrams through a SOCK_DGRAM pair,
+ *                        checking their order and sizes
+ * @return               :usec, or -1 on error
+ */
+static long long uds_perf_dgram(int count)
+{
+	struct uds_perf_job_s job;
+	struct timespec stime;
+	struct timespec etime;
+	unsigned char buf[DGRAM_SIZE];
+	pthread_t writer;
+	ssize_t len;
+	int errors = 0;
+	int sv[2];
+	int i;
+
+	if (socketpair(AF_UNIX, SOCK_DGRAM, 0, sv) < 0) {
+		return -1;
+	}
+
+	job.chan.rfd = sv[1];
+	job.chan.wfd = sv[0];
+	job.chan.sock = 1;
+	job.msgsize = DGRAM_SIZE;
+	job.loops = count;
+
+	clock_gettime(CLOCK_REALTIME, &stime);
+	if (pthread_create(&writer, NULL, uds_perf_dgram_writer, &job) != 0) {
+		close(sv[0]);
+		close(sv[1]);
+		return -1;
+	}
+	for (i = 0; i < count; i++) {
+		len = recv(sv[1], buf, sizeof(buf), 0);
+		if (len != (ssize_t)(2 + i % (DGRAM_SIZE - 1)) || buf[0] != (unsigned char)i || buf[1] != (unsigned char)(i >> 8)) {
+			errors++;
+			break;
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &etime);
+	pthread_join(writer, NULL);
+	close(sv[0]);
+	close(sv[1]);
+
+	if (errors != 0 || job.result != 0) {
+		printf("datagram %d out of order or resized\n", i);
+		return -1;
+	}
+
+	return uds_perf_usec(&stime, &etime);
+}
+
+/*
+ * @fn                   :uds_perf_measure
+ * @description          :Print the throughput and latency of socketpair() and
+ *                        pipe()
+ * @return               :number of errors
+ */
+static int uds_perf_measure(int scale)
+{
+	struct uds_perf_chan_s sockchan[2];
+	struct uds_perf_chan_s pipechan[2];
+	long long susec;
+	long long pusec;
+	size_t total = (size_t)STREAM_BYTES * scale;
+	int sv[2];
+	int p1[2];
+	int p2[2];
+	int errors = 0;
+	int i;
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+		printf("socketpair failed: %d\n", errno);
+		return 1;
+	}
+	if (pipe(p1) < 0 || pipe(p2) < 0) {
+		printf("pipe failed: %d\n", errno);
+		close(sv[0]);
+		close(sv[1]);
+		return 1;
+	}
+
+	/* Both ends of each channel, pipes need two of them for two directions */
+
+	sockchan[0].rfd = sockchan[0].wfd = sv[0];
+	sockchan[1].rfd = sockchan[1].wfd = sv[1];
+	sockchan[0].sock = sockchan[1].sock = 1;
+	pipechan[0].rfd = p2[0];
+	pipechan[0].wfd = p1[1];
+	pipechan[1].rfd = p1[0];
+	pipechan[1].wfd = p2[1];
+	pipechan[0].sock = pipechan[1].sock = 0;
+
+	printf("write size  socketpair KB/s  pipe KB/s\n");
+	for (i = 0; i < sizeof(g_msgsizes) / sizeof(g_msgsizes[0]); i++) {
+		susec = uds_perf_stream(&sockchan[0], &sockchan[1], g_msgsizes[i], total);
+		pusec = uds_perf_stream(&pipechan[0], &pipechan[1], g_msgsizes[i], total);
+		if (susec < 0 || pusec < 0) {
+			errors++;
+			continue;
+		}
+		printf("%10u  %15lld  %9lld\n", (unsigned)g_msgsizes[i], (long long)total * 1000000 / 1024 / susec, (long long)total * 1000000 / 1024 / pusec);
+	}
+
+	susec = uds_perf_pingpong(&sockchan[0], &sockchan[1], 1, PINGPONG_LOOPS * scale);
+	pusec = uds_perf_pingpong(&pipechan[0], &pipechan[1], 1, PINGPONG_LOOPS * scale);
+	if (susec < 0 || pusec < 0) {
+		errors++;
+	} else {
+		printf("round trip of 1 byte: socketpair %lld us, pipe %lld us\n", susec / (PINGPONG_LOOPS * scale), pusec / (PINGPONG_LOOPS * scale));
+	}
+
+	close(sv[0]);
+	close(sv[1]);
+	close(p1[0]);
+	close(p1[1]);
+	close(p2[0]);
+	close(p2[1]);
+
+	susec = uds_perf_dgram(DGRAM_COUNT * scale);
+	if (susec < 0) {
+		errors++;
+	} else {
+		printf("datagrams of 2 to %d bytes: %lld per second\n", DGRAM_SIZE, (long long)DGRAM_COUNT * scale * 1000000 / susec);
+	}
+
+	return errors;
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int uds_performance_main(int argc, char *argv[])
+#endif
+{
+	int scale = 1;
+	int errors;
+
+	if (argc > 1) {
+		scale = atoi(argv[1]);
+	}
+	if (scale <= 0) {
+		printf("Usage: %s [loops]\n", argv[0]);
+		return -1;
+	}
+
+	errors = uds_perf_verify();
+	if (errors != 0) {
+		printf("socketpair verification FAILED, %d errors\n", errors);
+		return -1;
+	}
+	printf("socketpair verification passed\n");
+
+	errors = uds_perf_measure(scale);
+	if (errors != 0) {
+		printf("socketpair measurement FAILED, %d errors\n", errors);
+		return -1;
+	}
+
+	printf("Done\n");
+	return 0;
+}
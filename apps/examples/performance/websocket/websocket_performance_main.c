@@ -0,0 +1,367 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file websocket_performance_main.c
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <protocols/wslay/wslay.h>
+
+#define WIRE_SIZE		8192
+#define DATA_ALIGN		8
+#define VERIFY_MAXLEN	300
+#define BYTES_PER_TEST	(256 * 1024)
+
+/* The in-memory connection between the sending and the receiving context */
+
+static uint8_t g_wire[WIRE_SIZE];
+static size_t g_wire_len;
+static size_t g_wire_off;
+
+/* Bytes accepted per send_callback call, to exercise partial sends */
+
+static size_t g_send_limit;
+static int g_send_calls;
+
+static unsigned long g_data_buf[(WIRE_SIZE + DATA_ALIGN) / sizeof(unsigned long) + 1];
+static uint8_t g_recv_buf[WIRE_SIZE];
+
+static const size_t g_sizes[] = { 16, 64, 125, 256, 1024, 4096 };
+
+static const uint8_t g_maskkey[4] = { 0x37, 0xfa, 0x21, 0x3d };
+
+static ssize_t ws_perf_send(const uint8_t *data, size_t len, int flags, void *user_data)
+{
+	g_send_calls++;
+
+	if (g_send_limit > 0 && len > g_send_limit) {
+		len = g_send_limit;
+	}
+
+	if (len > WIRE_SIZE - g_wire_len) {
+		/* Benchmark mode: the wire only counts the bytes */
+		g_wire_len = 0;
+	}
+
+	memcpy(g_wire + g_wire_len, data, len);
+	g_wire_len += len;
+	return len;
+}
+
+static ssize_t ws_perf_recv(uint8_t *buf, size_t len, int flags, void *user_data)
+{
+	if (g_wire_off == g_wire_len) {
+		return -1;
+	}
+
+	if (len > g_wire_len - g_wire_off) {
+		len = g_wire_len - g_wire_off;
+	}
+
+	memcpy(buf, g_wire + g_wire_off, len);
+	g_wire_off += len;
+	return len;
+}
+
+static int ws_perf_genmask(uint8_t *buf, size_t len, void *user_data)
+{
+	memcpy(buf, g_maskkey, len);
+	return 0;
+}
+
+static const struct wslay_frame_callbacks g_callbacks = {
+	ws_perf_send,
+	ws_perf_recv,
+	ws_perf_genmask
+};
+
+/*
+ * @fn                   :ws_perf_fill
+ * @description          :Fill a buffer with a pattern that differs at every offset
+ * @return               :void
+ */
+static void ws_perf_fill(uint8_t *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		buf[i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+}
+
+/*
+ * @fn                   :ws_perf_send_frame
+ * @description          :Send one binary frame, repeating the call for partial sends
+ * @return               :0 on success, -1 on error
+ */
+static int ws_perf_send_frame(wslay_frame_context_ptr ctx, const uint8_t *data, size_t len, int mask)
+{
+	struct wslay_frame_iocb iocb;
+	ssize_t r;
+
+	memset(&iocb, 0, sizeof(iocb));
+	iocb.fin = 1;
+	iocb.opcode = WSLAY_BINARY_FRAME;
+	iocb.mask = mask;
+	iocb.payload_length = len;
+	iocb.data = data;
+	iocb.data_length = len;
+
+	do {
+		r = wslay_frame_send(ctx, &iocb);
+		if (r < 0 && r != WSLAY_ERR_WANT_WRITE) {
+			return -1;
+		}
+		if (r > 0) {
+			iocb.data += r;
+			iocb.data_length -= r;
+		}
+	} while (iocb.data_length > 0 || r == WSLAY_ERR_WANT_WRITE);
+
+	return 0;
+}
+
+/*
+ * @fn                   :ws_perf_recv_frame
+ * @description          :Receive one frame from the wire into g_recv_buf
+ * @return               :payload length, or -1 on error
+ */
+static ssize_t ws_perf_recv_frame(wslay_frame_context_ptr ctx)
+{
+	struct wslay_frame_iocb iocb;
+	size_t len = 0;
+	ssize_t r;
+
+	do {
+		r = wslay_frame_recv(ctx, &iocb);
+		if (r < 0) {
+			return -1;
+		}
+		memcpy(g_recv_buf + len, iocb.data, r);
+		len += r;
+	} while (len < iocb.payload_length);
+
+	return len;
+}
+
+/*
+ * @fn                   :ws_perf_verify
+ * @description          :Send and receive frames of every length up to VERIFY_MAXLEN
+ *                        and a few large ones, at every payload alignment, masked
+ *                        and unmasked, with whole and partial sends
+ * @return               :number of mismatches
+ */
+static int ws_perf_verify(wslay_frame_context_ptr sctx, wslay_frame_context_ptr rctx)
+{
+	static const size_t large[] = { 1000, 4095, 4096, 4097, 6000 };
+	static const size_t limits[] = { 0, 1, 3, 1000 };
+	uint8_t *base = (uint8_t *)g_data_buf;
+	uint8_t *data;
+	size_t len;
+	size_t hdrlen;
+	size_t i;
+	ssize_t r;
+	int errors = 0;
+	int align;
+	int mask;
+	int l;
+	int n;
+
+	ws_perf_fill(base, sizeof(g_data_buf));
+
+	for (l = 0; l < sizeof(limits) / sizeof(limits[0]); l++) {
+		g_send_limit = limits[l];
+		for (mask = 0; mask < 2; mask++) {
+			for (align = 0; align < DATA_ALIGN; align++) {
+				for (n = 0; n <= VERIFY_MAXLEN + sizeof(large) / sizeof(large[0]); n++) {
+					len = (n <= VERIFY_MAXLEN) ? n : large[n - VERIFY_MAXLEN - 1];
+					if (g_send_limit == 1 && len > VERIFY_MAXLEN) {
+						continue;
+					}
+					data = base + align;
+					g_wire_len = 0;
+					g_wire_off = 0;
+					g_send_calls = 0;
+
+					if (ws_perf_send_frame(sctx, data, len, mask) != 0) {
+						printf("send failed: len %u mask %d align %d\n", (unsigned)len, mask, align);
+						errors++;
+						continue;
+					}
+
+					/* Without a limit, the header goes out with the payload */
+					hdrlen = 2 + (len < 126 ? 0 : 2) + (mask ? 4 : 0);
+					if (g_wire_len != hdrlen + len || (g_send_limit == 0 && g_send_calls != (len + 4095) / 4096 + (len == 0))) {
+						printf("send mismatch: len %u mask %d align %d wire %u calls %d\n", (unsigned)len, mask, align, (unsigned)g_wire_len, g_send_calls);
+						errors++;
+						continue;
+					}
+
+					/* The payload on the wire must be masked byte by byte */
+					for (i = 0; i < len; i++) {
+						if (g_wire[hdrlen + i] != (data[i] ^ (mask ? g_maskkey[i % 4] : 0))) {
+							printf("mask mismatch: len %u mask %d align %d at %u\n", (unsigned)len, mask, align, (unsigned)i);
+							errors++;
+							break;
+						}
+					}
+
+					r = ws_perf_recv_frame(rctx);
+					if (r != len || memcmp(g_recv_buf, data, len) != 0) {
+						printf("recv mismatch: len %u mask %d align %d\n", (unsigned)len, mask, align);
+						errors++;
+					}
+				}
+			}
+		}
+	}
+
+	g_send_limit = 0;
+	return errors;
+}
+
+/*
+ * @fn                   :ws_perf_usec
+ * @description          :Microseconds between two times, at least 1
+ * @return               :long long
+ */
+static long long ws_perf_usec(struct timespec *stime, struct timespec *etime)
+{
+	long long usec;
+
+	usec = (long long)(etime->tv_sec - stime->tv_sec) * 1000000 + (etime->tv_nsec - stime->tv_nsec) / 1000;
+	return usec > 0 ? usec : 1;
+}
+
+/*
+ * @fn                   :ws_perf_measure
+ * @description          :Print the masked send and the unmasking receive throughput
+ *                        for each payload size
+ * @return               :void
+ */
+static void ws_perf_measure(wslay_frame_context_ptr sctx, wslay_frame_context_ptr rctx, int align, int scale)
+{
+	uint8_t *data = (uint8_t *)g_data_buf + align;
+	struct timespec stime;
+	struct timespec etime;
+	long long send_usec;
+	long long recv_usec;
+	size_t frame_len;
+	int loops;
+	int calls;
+	int i;
+	int n;
+
+	for (n = 0; n < sizeof(g_sizes) / sizeof(g_sizes[0]); n++) {
+		loops = (BYTES_PER_TEST / g_sizes[n]) * scale;
+
+		/* Masked send, the wire only counts the bytes */
+
+		g_wire_len = 0;
+		g_send_calls = 0;
+		sched_lock();
+		clock_gettime(CLOCK_REALTIME, &stime);
+		for (i = 0; i < loops; i++) {
+			ws_perf_send_frame(sctx, data, g_sizes[n], 1);
+		}
+		clock_gettime(CLOCK_REALTIME, &etime);
+		sched_unlock();
+		send_usec = ws_perf_usec(&stime, &etime);
+		calls = g_send_calls;
+
+		/* Receive and unmask the same frame again and again */
+
+		g_wire_len = 0;
+		ws_perf_send_frame(sctx, data, g_sizes[n], 1);
+		frame_len = g_wire_len;
+		sched_lock();
+		clock_gettime(CLOCK_REALTIME, &stime);
+		for (i = 0; i < loops; i++) {
+			g_wire_off = 0;
+			ws_perf_recv_frame(rctx);
+		}
+		clock_gettime(CLOCK_REALTIME, &etime);
+		sched_unlock();
+		recv_usec = ws_perf_usec(&stime, &etime);
+
+		/* KB/s = (bytes / 1024) / (usec / 1000000) */
+
+		printf("%5u  data+%d  %9lld  %9lld  %8u  %5d.%02d\n", (unsigned)g_sizes[n], align,
+			   ((long long)g_sizes[n] * loops * 1000000 / 1024) / send_usec,
+			   ((long long)g_sizes[n] * loops * 1000000 / 1024) / recv_usec,
+			   (unsigned)frame_len, calls / loops, (calls % loops) * 100 / loops);
+	}
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int websocket_performance_main(int argc, char *argv[])
+#endif
+{
+	wslay_frame_context_ptr sctx;
+	wslay_frame_context_ptr rctx;
+	int scale = 1;
+	int errors;
+
+	if (argc > 1) {
+		scale = atoi(argv[1]);
+		if (scale <= 0) {
+			printf("Usage: %s [loops]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	if (wslay_frame_context_init(&sctx, &g_callbacks, NULL) != 0) {
+		printf("Cannot create the sending context\n");
+		return -1;
+	}
+
+	if (wslay_frame_context_init(&rctx, &g_callbacks, NULL) != 0) {
+		printf("Cannot create the receiving context\n");
+		wslay_frame_context_free(sctx);
+		return -1;
+	}
+
+	errors = ws_perf_verify(sctx, rctx);
+	if (errors != 0) {
+		printf("Websocket frame verification FAILED, %d errors\n", errors);
+		wslay_frame_context_free(rctx);
+		wslay_frame_context_free(sctx);
+		return -1;
+	}
+
+	printf("Websocket frame verification passed\n");
+
+	printf(" size  align   send KB/s  recv KB/s  frame  sends/frame\n");
+	ws_perf_measure(sctx, rctx, 0, scale);
+	ws_perf_measure(sctx, rctx, 1, scale);
+	ws_perf_measure(sctx, rctx, 3, scale);
+
+	wslay_frame_context_free(rctx);
+	wslay_frame_context_free(sctx);
+
+	printf("Done\n");
+	return 0;
+}
@@ -0,0 +1,167 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "tc_common.h"
+
+/* The cloud file of ST Things lives on the smartfs volume at /mnt, and is
+ * updated through a temporary file next to it.
+ */
+
+#define CLOUD_FILE "/mnt/utc_things_cloud.json"
+#define CLOUD_TMP_FILE CLOUD_FILE ".tmp"
+
+#define OLD_JSON "{\"cloud\":{\"address\":\"old\"}}"
+#define NEW_JSON "{\"cloud\":{\"address\":\"new\"}}"
+
+/* Internal to ST Things (things_data_manager.h) */
+
+extern int replace_json_file(const char *tmp_path, const char *filename);
+extern void recover_json_file(const char *tmp_path, const char *filename);
+
+static int write_file(const char *path, const char *str)
+{
+	FILE *fp = fopen(path, "w");
+	size_t len = strlen(str);
+
+	if (fp == NULL) {
+		return ERROR;
+	}
+	if (fwrite(str, 1, len, fp) != len) {
+		fclose(fp);
+		return ERROR;
+	}
+	return fclose(fp) == 0 ? OK : ERROR;
+}
+
+static int compare_file(const char *path, const char *str)
+{
+	char buf[64];
+	FILE *fp = fopen(path, "r");
+	size_t len;
+
+	if (fp == NULL) {
+		return ERROR;
+	}
+	len = fread(buf, 1, sizeof(buf) - 1, fp);
+	fclose(fp);
+	buf[len] = '\0';
+	return strcmp(buf, str) == 0 ? OK : ERROR;
+}
+
+static void remove_files(void)
+{
+	unlink(CLOUD_TMP_FILE);
+	unlink(CLOUD_FILE);
+}
+
+static void utc_st_things_replace_json_file_p(void)
+{
+	struct stat st;
+	int ret;
+
+	remove_files();
+	ret = write_file(CLOUD_FILE, OLD_JSON);
+	TC_ASSERT_EQ_CLEANUP("write_file", ret, OK, remove_files());
+	ret = write_file(CLOUD_TMP_FILE, NEW_JSON);
+	TC_ASSERT_EQ_CLEANUP("write_file", ret, OK, remove_files());
+
+	/* smartfs does not rename over an existing file */
+
+	ret = replace_json_file(CLOUD_TMP_FILE, CLOUD_FILE);
+	TC_ASSERT_EQ_CLEANUP("replace_json_file", ret, 1, remove_files());
+	ret = compare_file(CLOUD_FILE, NEW_JSON);
+	TC_ASSERT_EQ_CLEANUP("compare_file", ret, OK, remove_files());
+	ret = stat(CLOUD_TMP_FILE, &st);
+	TC_ASSERT_NEQ_CLEANUP("stat", ret, OK, remove_files());
+
+	remove_files();
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_st_things_replace_json_file_n(void)
+{
+	int ret;
+
+	remove_files();
+
+	ret = replace_json_file(CLOUD_TMP_FILE, CLOUD_FILE);
+	TC_ASSERT_EQ_CLEANUP("replace_json_file", ret, 0, remove_files());
+
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_st_things_recover_json_file_p(void)
+{
+	struct stat st;
+	int ret;
+
+	/* Power lost after the old file was removed: the complete temporary
+	 * file takes its place.
+	 */
+
+	remove_files();
+	ret = write_file(CLOUD_TMP_FILE, NEW_JSON);
+	TC_ASSERT_EQ_CLEANUP("write_file", ret, OK, remove_files());
+
+	recover_json_file(CLOUD_TMP_FILE, CLOUD_FILE);
+	ret = compare_file(CLOUD_FILE, NEW_JSON);
+	TC_ASSERT_EQ_CLEANUP("compare_file", ret, OK, remove_files());
+	ret = stat(CLOUD_TMP_FILE, &st);
+	TC_ASSERT_NEQ_CLEANUP("stat", ret, OK, remove_files());
+
+	/* Power lost while the temporary file was written: it is dropped and
+	 * the old file is kept.
+	 */
+
+	ret = write_file(CLOUD_TMP_FILE, OLD_JSON);
+	TC_ASSERT_EQ_CLEANUP("write_file", ret, OK, remove_files());
+
+	recover_json_file(CLOUD_TMP_FILE, CLOUD_FILE);
+	ret = compare_file(CLOUD_FILE, NEW_JSON);
+	TC_ASSERT_EQ_CLEANUP("compare_file", ret, OK, remove_files());
+	ret = stat(CLOUD_TMP_FILE, &st);
+	TC_ASSERT_NEQ_CLEANUP("stat", ret, OK, remove_files());
+
+	remove_files();
+	TC_SUCCESS_RESULT();
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int utc_st_things_main(int argc, char *argv[])
+#endif
+{
+	if (testcase_state_handler(TC_START, "ST Things UTC") == ERROR) {
+		return ERROR;
+	}
+
+	utc_st_things_replace_json_file_p();
+	utc_st_things_replace_json_file_n();
+	utc_st_things_recover_json_file_p();
+
+	(void)testcase_state_handler(TC_END, "ST Things UTC");
+
+	return 0;
+}
@@ -72,6 +72,9 @@
 #ifdef CONFIG_EXAMPLES_TESTCASE_PREFERENCE_UTC
 #define TC_PREFERENCE_STACK  2048
 #endif
+#ifdef CONFIG_EXAMPLES_TESTCASE_ST_THINGS_UTC
+#define TC_ST_THINGS_STACK  2048
+#endif
 #if defined(CONFIG_EXAMPLES_TESTCASE_SYSTEMIO_UTC) || defined(CONFIG_EXAMPLES_TESTCASE_SYSTEMIO_ITC)
 #define TC_SYSTEMIO_STACK 2048
 #endif
@@ -116,6 +119,7 @@ extern int utc_messaging_main(int argc, char *argv[]);
 extern int utc_mqtt_main(int argc, char *argv[]);
 extern int itc_mqtt_main(int argc, char *argv[]);
 extern int utc_preference_main(int argc, char *argv[]);
+extern int utc_st_things_main(int argc, char *argv[]);
 extern int utc_sysio_main(int argc, char *argv[]);
 extern int itc_sysio_main(int argc, char *argv[]);
 extern int utc_taskmanager_main(int argc, char *argv[]);
@@ -190,6 +194,9 @@ static const tash_cmdlist_t tc_cmds[] = {
 #ifdef CONFIG_EXAMPLES_TESTCASE_PREFERENCE_UTC
 	{"preference_utc", utc_preference_main, TASH_EXECMD_ASYNC},
 #endif
+#ifdef CONFIG_EXAMPLES_TESTCASE_ST_THINGS_UTC
+	{"st_things_utc", utc_st_things_main, TASH_EXECMD_ASYNC},
+#endif
 #ifdef CONFIG_EXAMPLES_TESTCASE_SYSTEMIO_UTC
 	{"sysio_utc", utc_sysio_main, TASH_EXECMD_ASYNC},
 #endif
@@ -389,6 +396,12 @@ int tc_main(int argc, char *argv[])
 		printf("Preference tc is not started, err = %d\n", pid);
 	}
 #endif
+#ifdef CONFIG_EXAMPLES_TESTCASE_ST_THINGS_UTC
+	pid = task_create("stthingsutc", SCHED_PRIORITY_DEFAULT, TC_ST_THINGS_STACK, utc_st_things_main, argv);
+	if (pid < 0) {
+		printf("ST Things tc is not started, err = %d\n", pid);
+	}
+#endif
 #ifdef CONFIG_EXAMPLES_TESTCASE_SYSTEMIO_UTC
 	pid = task_create("sysioutc", SCHED_PRIORITY_DEFAULT, TC_SYSTEMIO_STACK, utc_sysio_main, argv);
 	if (pid < 0) {
@@ -159,6 +159,9 @@ struct iperf_stream {
 	int buffer_fd;				/* data to send, file descriptor */
 	char *buffer;				/* data to send, mmapped */
 	int diskfile_fd;			/* file to send, file descriptor */
+	struct mmsghdr *mmsg;		/* -m batch headers, allocated on first use */
+	struct iovec *mmsg_iov;		/* one iovec per batch entry */
+	char *mmsg_buffer;			/* mmsg_batch datagrams of blksize bytes */
 
 	/*
 	 * for udp measurements - This can be a structure outside stream, and
@@ -259,6 +262,7 @@ struct iperf_test {
 	int forceflush;				/* --forceflush - flushing output at every interval */
 	int no_fq_socket_pacing;	/* --no-fq-socket-pacing */
 	int multisend;
+	int mmsg_batch;				/* -m option - UDP datagrams per recvmmsg/sendmmsg call */
 
 	char *json_output_string;	/* rendered JSON output if json_output is set */
 	/* Select related parameters */
@@ -337,6 +341,7 @@ struct iperf_test {
 #define MAX_INTERVAL 60.0
 #define MAX_TIME 86400
 #define MAX_BURST 1000
+#define MAX_MMSG 64
 #define MAX_MSS (9 * 1024)
 #define MAX_STREAMS 128
 
@@ -606,7 +606,7 @@ int iperf_parse_arguments(struct iperf_test *test, int argc, char **argv)
 
 	blksize = 0;
 	server_flag = client_flag = rate_flag = duration_flag = 0;
-	while ((flag = getopt(argc, argv, "p:f:D1VJvsc:t:i:ub:n:k:l:P:Rw:B:M:N46S:L:ZO:F:A:T:C:dI:hX:")) != -1) {
+	while ((flag = getopt(argc, argv, "p:f:D1VJvsc:t:i:ub:n:k:l:m:P:Rw:B:M:N46S:L:ZO:F:A:T:C:dI:hX:")) != -1) {
 		switch (flag) {
 		case 'p':
 			test->server_port = atoi(optarg);
@@ -714,6 +714,18 @@ int iperf_parse_arguments(struct iperf_test *test, int argc, char **argv)
 			blksize = unit_atoi(optarg);
 			client_flag = 1;
 			break;
+		case 'm':
+#if defined(HAVE_MMSG)
+			test->mmsg_batch = atoi(optarg);
+			if (test->mmsg_batch <= 0 || test->mmsg_batch > MAX_MMSG) {
+				i_errno = IEMMSG;
+				goto err;
+			}
+#else
+			i_errno = IEUNIMP;
+			goto err;
+#endif
+			break;
 		case 'P':
 			test->num_streams = atoi(optarg);
 			if (test->num_streams > MAX_STREAMS) {
@@ -2670,6 +2682,7 @@ void iperf_free_stream(struct iperf_stream *sp)
 #else
 	free(sp->buffer);
 #endif
+	iperf_udp_free_mmsg(sp);
 	free(sp->result->interval_results);
 	free(sp->result);
 	if (sp->send_timer != NULL) {
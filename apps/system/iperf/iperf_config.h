@@ -18,6 +18,8 @@
 /* src/iperf_config.h.  Generated from iperf_config.h.in by configure.  */
 /* src/iperf_config.h.in.  Generated from configure.ac by autoheader.  */
 
+#include <tinyara/config.h>
+
 /* Define to 1 if you have the `cpuset_setaffinity' function. */
 /* #undef HAVE_CPUSET_SETAFFINITY */
 
@@ -48,6 +50,13 @@
 /* Define to 1 if you have the `sendfile' function. */
 #undef HAVE_SENDFILE
 
+/* Define to 1 if you have the `recvmmsg' and `sendmmsg' functions. */
+#ifdef CONFIG_NET_NETMGR
+#define HAVE_MMSG 1
+#else
+#undef HAVE_MMSG
+#endif
+
 /* Have SO_MAX_PACING_RATE sockopt. */
 #undef HAVE_SO_MAX_PACING_RATE
 
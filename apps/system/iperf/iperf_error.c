@@ -144,6 +144,9 @@ char *iperf_strerror(int err)
 	case IEBADTOS:
 		snprintf(errstr, len, "bad TOS value (must be between 0 and 255 inclusive)");
 		break;
+	case IEMMSG:
+		snprintf(errstr, len, "invalid datagram batch (maximum = %d)", MAX_MMSG);
+		break;
 	case IEMSS:
 		snprintf(errstr, len, "TCP MSS too large (maximum = %d bytes)", MAX_MSS);
 		break;
@@ -112,6 +112,9 @@ extern    "C"
 	const char usage_shortstr[] = "Usage: iperf [-s|-c host] [options]\n" "Try `iperf --help' for more information.\n";
 
 	const char usage_longstr[] = "Usage: iperf [-s|-c host] [options]\n" "       iperf [-h|--help] [-v|--version]\n\n" "Server or Client:\n" "  -p, --port      #         server port to listen on/connect to\n" "  -f, --format    [kmgKMG]  format to report: Kbits, Mbits, KBytes, MBytes\n" "  -i, --interval  #         seconds between periodic bandwidth reports\n" "  -F, --file name           xmit/recv the specified file\n"
+#if defined(HAVE_MMSG)
+								 "  -m, --mmsg      #         UDP datagrams per recvmmsg()/sendmmsg() call\n"
+#endif
 #if defined(HAVE_CPU_AFFINITY)
 								 "  -A, --affinity n/n,m      set CPU affinity\n"
 #endif							/* HAVE_CPU_AFFINITY */
@@ -65,40 +65,27 @@
 #include "iperf_net.h"
 #include "iperf_portable_endian.h"
 
-/* iperf_udp_recv
+/* iperf_udp_account
  *
- * receives the data for UDP
+ * updates the loss, ordering and jitter statistics with a received datagram
  */
-int iperf_udp_recv(struct iperf_stream *sp)
+static void iperf_udp_account(struct iperf_stream *sp, const char *buf, int r)
 {
 	uint32_t sec;
 	uint32_t usec;
 	uint64_t pcount;
-	int r;
-	int size = sp->settings->blksize;
 	double transit = 0;
 	double d = 0;
 	struct timeval sent_time;
 	struct timeval arrival_time;
 
-	r = Nread(sp->socket, sp->buffer, size, Pudp);
-
-	/*
-	 * If we got an error in the read, or if we didn't read anything
-	 * because the underlying read(2) got a EAGAIN, then skip packet
-	 * processing.
-	 */
-	if (r <= 0) {
-		return r;
-	}
-
 	sp->result->bytes_received += r;
 	sp->result->bytes_received_this_interval += r;
 
 	if (sp->test->udp_counters_64bit) {
-		memcpy(&sec, sp->buffer, sizeof(sec));
-		memcpy(&usec, sp->buffer + 4, sizeof(usec));
-		memcpy(&pcount, sp->buffer + 8, sizeof(pcount));
+		memcpy(&sec, buf, sizeof(sec));
+		memcpy(&usec, buf + 4, sizeof(usec));
+		memcpy(&pcount, buf + 8, sizeof(pcount));
 		sec = ntohl(sec);
 		usec = ntohl(usec);
 		pcount = be64toh(pcount);
@@ -106,9 +93,9 @@ int iperf_udp_recv(struct iperf_stream *sp)
 		sent_time.tv_usec = usec;
 	} else {
 		uint32_t pc;
-		memcpy(&sec, sp->buffer, sizeof(sec));
-		memcpy(&usec, sp->buffer + 4, sizeof(usec));
-		memcpy(&pc, sp->buffer + 8, sizeof(pc));
+		memcpy(&sec, buf, sizeof(sec));
+		memcpy(&usec, buf + 4, sizeof(usec));
+		memcpy(&pc, buf + 8, sizeof(pc));
 		sec = ntohl(sec);
 		usec = ntohl(usec);
 		pcount = ntohl(pc);
@@ -143,18 +130,14 @@ int iperf_udp_recv(struct iperf_stream *sp)
 	if (sp->test->debug) {
 		fprintf(stderr, "packet_count %d\n", sp->packet_count);
 	}
-
-	return r;
 }
 
-/* iperf_udp_send
+/* iperf_udp_stamp
  *
- * sends the data for UDP
+ * writes the send time and the next packet count into a datagram
  */
-int iperf_udp_send(struct iperf_stream *sp)
+static void iperf_udp_stamp(struct iperf_stream *sp, char *buf)
 {
-	int r;
-	int size = sp->settings->blksize;
 	struct timeval before;
 
 	gettimeofday(&before, 0);
@@ -171,9 +154,9 @@ int iperf_udp_send(struct iperf_stream *sp)
 		usec = htonl(before.tv_usec);
 		pcount = htobe64(sp->packet_count);
 
-		memcpy(sp->buffer, &sec, sizeof(sec));
-		memcpy(sp->buffer + 4, &usec, sizeof(usec));
-		memcpy(sp->buffer + 8, &pcount, sizeof(pcount));
+		memcpy(buf, &sec, sizeof(sec));
+		memcpy(buf + 4, &usec, sizeof(usec));
+		memcpy(buf + 8, &pcount, sizeof(pcount));
 
 	} else {
 
@@ -185,11 +168,187 @@ int iperf_udp_send(struct iperf_stream *sp)
 		usec = htonl(before.tv_usec);
 		pcount = htonl(sp->packet_count);
 
-		memcpy(sp->buffer, &sec, sizeof(sec));
-		memcpy(sp->buffer + 4, &usec, sizeof(usec));
-		memcpy(sp->buffer + 8, &pcount, sizeof(pcount));
+		memcpy(buf, &sec, sizeof(sec));
+		memcpy(buf + 4, &usec, sizeof(usec));
+		memcpy(buf + 8, &pcount, sizeof(pcount));
 
 	}
+}
+
+#if defined(HAVE_MMSG)
+/* iperf_udp_alloc_mmsg
+ *
+ * sets up the batch of datagrams used with recvmmsg/sendmmsg
+ */
+static int iperf_udp_alloc_mmsg(struct iperf_stream *sp)
+{
+	int batch = sp->test->mmsg_batch;
+	int size = sp->settings->blksize;
+	int i;
+
+	sp->mmsg = (struct mmsghdr *)malloc(batch * (sizeof(struct mmsghdr) + sizeof(struct iovec) + size));
+	if (sp->mmsg == NULL) {
+		return -1;
+	}
+	sp->mmsg_iov = (struct iovec *)(sp->mmsg + batch);
+	sp->mmsg_buffer = (char *)(sp->mmsg_iov + batch);
+
+	memset(sp->mmsg, 0, batch * sizeof(struct mmsghdr));
+	for (i = 0; i < batch; i++) {
+		/* the payload is the same random data as for single sends */
+		memcpy(sp->mmsg_buffer + i * size, sp->buffer, size);
+		sp->mmsg_iov[i].iov_base = sp->mmsg_buffer + i * size;
+		sp->mmsg_iov[i].iov_len = size;
+		sp->mmsg[i].msg_hdr.msg_iov = &sp->mmsg_iov[i];
+		sp->mmsg[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	return 0;
+}
+
+/* iperf_udp_recv_mmsg
+ *
+ * receives the datagrams already queued on the socket, up to the batch size,
+ * with one recvmmsg call
+ */
+static int iperf_udp_recv_mmsg(struct iperf_stream *sp)
+{
+	int total = 0;
+	int n;
+	int i;
+
+	if (sp->mmsg == NULL && iperf_udp_alloc_mmsg(sp) < 0) {
+		return NET_HARDERROR;
+	}
+
+	/* the socket was reported readable, so only the first datagram may be
+	 * waited for */
+	n = recvmmsg(sp->socket, sp->mmsg, sp->test->mmsg_batch, MSG_WAITFORONE, NULL);
+	if (n < 0) {
+		int errcode = get_errno();
+		if (errcode == EINTR || errcode == EAGAIN || errcode == EWOULDBLOCK) {
+			return 0;
+		}
+		return NET_HARDERROR;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (sp->mmsg[i].msg_len > 0) {
+			iperf_udp_account(sp, sp->mmsg_buffer + i * sp->settings->blksize, sp->mmsg[i].msg_len);
+			total += sp->mmsg[i].msg_len;
+		}
+	}
+
+	return total;
+}
+
+/* iperf_udp_send_mmsg
+ *
+ * sends a batch of datagrams with one sendmmsg call
+ */
+static int iperf_udp_send_mmsg(struct iperf_stream *sp)
+{
+	int batch = sp->test->mmsg_batch;
+	int size = sp->settings->blksize;
+	int n;
+	int i;
+
+	if (sp->mmsg == NULL && iperf_udp_alloc_mmsg(sp) < 0) {
+		return NET_HARDERROR;
+	}
+
+	/* do not send beyond the -k block count */
+	if (sp->settings->blocks != 0) {
+		if (sp->test->blocks_sent >= sp->settings->blocks) {
+			batch = 1;
+		} else if (sp->settings->blocks - sp->test->blocks_sent < (iperf_size_t)batch) {
+			batch = (int)(sp->settings->blocks - sp->test->blocks_sent);
+		}
+	}
+
+	for (i = 0; i < batch; i++) {
+		iperf_udp_stamp(sp, sp->mmsg_buffer + i * size);
+	}
+
+	n = sendmmsg(sp->socket, sp->mmsg, batch, 0);
+	if (n < 0) {
+		sp->packet_count -= batch;
+		switch (get_errno()) {
+		case EINTR:
+		case EAGAIN:
+#if (EAGAIN != EWOULDBLOCK)
+		case EWOULDBLOCK:
+#endif
+		case ENOMEM:
+		case ENOBUFS:
+			return NET_SOFTERROR;
+		default:
+			return NET_HARDERROR;
+		}
+	}
+
+	/* the counts of the datagrams not sent are used again */
+	sp->packet_count -= batch - n;
+
+	sp->result->bytes_sent += n * size;
+	sp->result->bytes_sent_this_interval += n * size;
+
+	/* iperf_send() counts one block per call */
+	if (n > 1) {
+		sp->test->blocks_sent += n - 1;
+	}
+
+	return n * size;
+}
+#endif							/* HAVE_MMSG */
+
+/* iperf_udp_recv
+ *
+ * receives the data for UDP
+ */
+int iperf_udp_recv(struct iperf_stream *sp)
+{
+	int r;
+	int size = sp->settings->blksize;
+
+#if defined(HAVE_MMSG)
+	if (sp->test->mmsg_batch > 1) {
+		return iperf_udp_recv_mmsg(sp);
+	}
+#endif
+
+	r = Nread(sp->socket, sp->buffer, size, Pudp);
+
+	/*
+	 * If we got an error in the read, or if we didn't read anything
+	 * because the underlying read(2) got a EAGAIN, then skip packet
+	 * processing.
+	 */
+	if (r <= 0) {
+		return r;
+	}
+
+	iperf_udp_account(sp, sp->buffer, r);
+
+	return r;
+}
+
+/* iperf_udp_send
+ *
+ * sends the data for UDP
+ */
+int iperf_udp_send(struct iperf_stream *sp)
+{
+	int r;
+	int size = sp->settings->blksize;
+
+#if defined(HAVE_MMSG)
+	if (sp->test->mmsg_batch > 1) {
+		return iperf_udp_send_mmsg(sp);
+	}
+#endif
+
+	iperf_udp_stamp(sp, sp->buffer);
 
 	r = Nwrite(sp->socket, sp->buffer, size, Pudp);
 
@@ -203,6 +362,18 @@ int iperf_udp_send(struct iperf_stream *sp)
 	return r;
 }
 
+/* iperf_udp_free_mmsg
+ *
+ * frees the recvmmsg/sendmmsg batch of a stream
+ */
+void iperf_udp_free_mmsg(struct iperf_stream *sp)
+{
+	free(sp->mmsg);
+	sp->mmsg = NULL;
+	sp->mmsg_iov = NULL;
+	sp->mmsg_buffer = NULL;
+}
+
 /**************************************************************************/
 
 /*
@@ -74,4 +74,10 @@ int iperf_udp_connect(struct iperf_test *);
 
 int iperf_udp_init(struct iperf_test *);
 
+/**
+ * iperf_udp_free_mmsg -- frees the recvmmsg/sendmmsg batch of a stream
+ *
+ */
+void iperf_udp_free_mmsg(struct iperf_stream *);
+
 #endif
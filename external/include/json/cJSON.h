@@ -116,6 +116,16 @@ typedef struct cJSON_Hooks
 
 typedef int cJSON_bool;
 
+/* Caller-provided memory for cJSON_ParseInArena and cJSON_ParseInSitu. Set it up with cJSON_InitArena, the fields are private. */
+typedef struct cJSON_Arena
+{
+    unsigned char *buffer;
+    size_t size;
+    /* strings are taken from the bottom, nodes from the top */
+    size_t low;
+    size_t high;
+} cJSON_Arena;
+
 #if !defined(__WINDOWS__) && (defined(WIN32) || defined(WIN64) || defined(_MSC_VER) || defined(_WIN32))
 #define __WINDOWS__
 #endif
@@ -178,6 +188,19 @@ CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value);
 /* If you supply a ptr in return_parse_end and parsing fails, then return_parse_end will contain a pointer to the error. If not, then cJSON_GetErrorPtr() does the job. */
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
 
+/* Arena parsing: all nodes and strings of the result are taken from the arena, without a single call to the allocation hooks.
+ * The result must not be passed to cJSON_Delete or modified with the AddItem/Replace/Delete functions; it is released,
+ * together with every other result in the arena, by cJSON_ResetArena or by freeing the arena buffer.
+ * When the arena is too small, parsing fails and the arena is left as it was before the call. */
+CJSON_PUBLIC(void) cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size);
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena);
+/* Number of bytes of the arena in use, to size the arena for a kind of document. */
+CJSON_PUBLIC(size_t) cJSON_ArenaUsed(const cJSON_Arena *arena);
+CJSON_PUBLIC(cJSON *) cJSON_ParseInArena(cJSON_Arena *arena, const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
+/* Like cJSON_ParseInArena, but the strings and names are unescaped in place and point into value, which must stay valid
+ * as long as the result is used. value is modified even when parsing fails. Only the nodes are taken from the arena. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(cJSON_Arena *arena, char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
+
 /* Render a cJSON entity to text for transfer/storage. */
 CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item);
 /* Render a cJSON entity to text for transfer/storage without any formatting. */
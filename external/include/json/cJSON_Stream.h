@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * external/include/json/cJSON_Stream.h
+ *
+ * Streaming JSON on top of cJSON: a pull reader that returns one token at a
+ * time from a callback or a string, and a push writer that emits into a
+ * fixed buffer and flushes it through a callback. Neither builds a tree, so
+ * the memory used does not depend on the size of the document.
+ *
+ ****************************************************************************/
+
+#ifndef __EXTERNAL_INCLUDE_JSON_CJSON_STREAM_H
+#define __EXTERNAL_INCLUDE_JSON_CJSON_STREAM_H
+
+#ifdef __cplusplus
+// *INDENT-OFF*
+extern "C"
+{
+// *INDENT-ON*
+#endif
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stddef.h>
+#include <json/cJSON.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Deepest nesting of objects and arrays the reader and the writer track */
+#ifndef CJSON_STREAM_NESTING_LIMIT
+#define CJSON_STREAM_NESTING_LIMIT 32
+#endif
+
+/* Tokens returned by cJSON_ReaderNext */
+#define cJSON_TokenError       (-1)	/* Malformed input, read error or no memory; sticky */
+#define cJSON_TokenEnd         (0)	/* End of the document */
+#define cJSON_TokenObjectStart (1)
+#define cJSON_TokenObjectEnd   (2)
+#define cJSON_TokenArrayStart  (3)
+#define cJSON_TokenArrayEnd    (4)
+#define cJSON_TokenKey         (5)	/* Name of an object member, in reader->value */
+#define cJSON_TokenString      (6)	/* Unescaped text in reader->value */
+#define cJSON_TokenNumber      (7)	/* reader->number, the text in reader->value */
+#define cJSON_TokenTrue        (8)
+#define cJSON_TokenFalse       (9)
+#define cJSON_TokenNull        (10)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Fills buffer with up to size bytes. Returns the number of bytes read, 0 at the end of the input or a negative value on error. */
+typedef int (*cJSON_ReadCallback)(void *context, char *buffer, size_t size);
+
+/* Consumes size bytes of buffer. Returns the number of bytes written or a negative value on error. */
+typedef int (*cJSON_WriteCallback)(void *context, const char *buffer, size_t size);
+
+/* Set up with cJSON_InitReader or cJSON_InitStringReader. Only value, length and number are meant to be read by the caller. */
+typedef struct cJSON_Reader {
+	char *value;				/* Key, string or number text of the last token, NUL terminated */
+	size_t length;				/* Length of value, without the terminator */
+	double number;				/* Value of the last cJSON_TokenNumber */
+
+	cJSON_ReadCallback read;
+	void *context;
+	const char *data;			/* Unread input is data[offset] .. data[size - 1] */
+	char *window;				/* Refilled by read, NULL for a string reader */
+	size_t window_size;
+	size_t offset;
+	size_t size;
+	size_t value_size;
+	cJSON_bool value_owned;		/* value is grown with the cJSON hooks */
+	cJSON_bool eof;
+	int state;
+	int depth;
+	unsigned char objects[CJSON_STREAM_NESTING_LIMIT / 8 + 1];	/* Bit set when the level is an object */
+} cJSON_Reader;
+
+/* Set up with cJSON_InitWriter. The fields are private. */
+typedef struct cJSON_Writer {
+	cJSON_WriteCallback write;
+	void *context;
+	char *buffer;
+	size_t size;
+	size_t used;
+	size_t total;				/* Bytes handed to write so far */
+	cJSON_bool format;
+	cJSON_bool error;
+	int depth;
+	unsigned char objects[CJSON_STREAM_NESTING_LIMIT / 8 + 1];	/* Bit set when the level is an object, level 0 is the top */
+	unsigned char members[CJSON_STREAM_NESTING_LIMIT / 8 + 1];	/* Bit set once the level has a value */
+} cJSON_Writer;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Pull reader. window of window_size bytes is refilled through read. value receives key, string and number text and must hold
+ * the longest of them; pass NULL to have the reader grow its own with the cJSON hooks, released by cJSON_ReleaseReader. */
+CJSON_PUBLIC(void) cJSON_InitReader(cJSON_Reader *reader, cJSON_ReadCallback read, void *context, char *window, size_t window_size, char *value, size_t value_size);
+/* Reads from the first length bytes of json, which must stay valid while the reader is used. */
+CJSON_PUBLIC(void) cJSON_InitStringReader(cJSON_Reader *reader, const char *json, size_t length, char *value, size_t value_size);
+CJSON_PUBLIC(void) cJSON_ReleaseReader(cJSON_Reader *reader);
+/* Returns the next cJSON_Token* of the document. A key is always followed by its value. */
+CJSON_PUBLIC(int) cJSON_ReaderNext(cJSON_Reader *reader);
+/* Current nesting depth, 0 outside of any object or array. */
+CJSON_PUBLIC(int) cJSON_ReaderDepth(const cJSON_Reader *reader);
+/* Skips the next value, with everything nested in it. Returns false on error. */
+CJSON_PUBLIC(cJSON_bool) cJSON_ReaderSkipValue(cJSON_Reader *reader);
+/* Builds a tree out of the next value only, so a single member can be looked at with the usual API. Delete it with cJSON_Delete. */
+CJSON_PUBLIC(cJSON *) cJSON_ReaderGetValue(cJSON_Reader *reader);
+
+/* Push writer. Output is collected in buffer and passed to write whenever it fills up. Without a callback the whole document
+ * must fit into buffer, and is NUL terminated there by cJSON_WriterFinish. format selects the layout of cJSON_Print. */
+CJSON_PUBLIC(void) cJSON_InitWriter(cJSON_Writer *writer, cJSON_WriteCallback write, void *context, char *buffer, size_t size, cJSON_bool format);
+/* name is the member name inside an object and must be NULL inside an array or at the top level. All return false once the
+ * writer failed, after which nothing more is written. */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteObjectStart(cJSON_Writer *writer, const char *name);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteObjectEnd(cJSON_Writer *writer);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteArrayStart(cJSON_Writer *writer, const char *name);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteArrayEnd(cJSON_Writer *writer);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteString(cJSON_Writer *writer, const char *name, const char *string);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteNumber(cJSON_Writer *writer, const char *name, double number);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteBool(cJSON_Writer *writer, const char *name, cJSON_bool boolean);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteNull(cJSON_Writer *writer, const char *name);
+/* Writes an existing tree as the next value, without printing it to a string first. */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteItem(cJSON_Writer *writer, const char *name, const cJSON *item);
+/* Flushes the buffer. Returns the length of the document, or -1 if anything failed. */
+CJSON_PUBLIC(int) cJSON_WriterFinish(cJSON_Writer *writer);
+
+#ifdef __cplusplus
+// *INDENT-OFF*
+}
+// *INDENT-ON*
+#endif
+
+#endif /* __EXTERNAL_INCLUDE_JSON_CJSON_STREAM_H */
@@ -45,7 +45,7 @@
 #include <sys/select.h>
 
 #include <stdio.h>
-#include <mqueue.h>
+#include <semaphore.h>
 #include <netinet/in.h>
 
 #ifdef CONFIG_NETUTILS_WEBSOCKET
@@ -75,6 +75,26 @@
 #define HTTP_CONF_MAX_CLIENT_HANDLE		1
 #endif
 
+#if defined(CONFIG_NETUTILS_WEBSERVER_MAX_HANDLER_CONNECTIONS)
+#define HTTP_CONF_MAX_HANDLER_CONNECTIONS	(CONFIG_NETUTILS_WEBSERVER_MAX_HANDLER_CONNECTIONS)
+#else
+#define HTTP_CONF_MAX_HANDLER_CONNECTIONS	4
+#endif
+
+#if defined(CONFIG_NETUTILS_WEBSERVER_KEEPALIVE)
+#define HTTP_CONF_KEEPALIVE_TIMEOUT_MSEC	(CONFIG_NETUTILS_WEBSERVER_KEEPALIVE_TIMEOUT * 1000)
+#define HTTP_CONF_KEEPALIVE_MAX_REQUESTS	(CONFIG_NETUTILS_WEBSERVER_KEEPALIVE_MAX_REQUESTS)
+#else
+#define HTTP_CONF_KEEPALIVE_TIMEOUT_MSEC	0
+#define HTTP_CONF_KEEPALIVE_MAX_REQUESTS	1
+#endif
+
+#if defined(CONFIG_NETUTILS_WEBSERVER_FILE_CHUNK_SIZE)
+#define HTTP_CONF_FILE_CHUNK_SIZE		(CONFIG_NETUTILS_WEBSERVER_FILE_CHUNK_SIZE)
+#else
+#define HTTP_CONF_FILE_CHUNK_SIZE		1024
+#endif
+
 #define HTTP_METHOD_UNKNOWN -1
 #define HTTP_METHOD_GET     0
 #define HTTP_METHOD_PUT     1
@@ -93,9 +113,6 @@
 #define HTTP_CONF_CLIENT_STACKSIZE              8192
 #define HTTP_CONF_MIN_TLS_MEMORY                80000
 #define HTTP_CONF_SOCKET_TIMEOUT_MSEC           50000
-#define HTTP_CONF_SERVER_MQ_MAX_MSG             10
-#define HTTP_CONF_SERVER_MQ_PRIO                50
-#define HTTP_CONF_SERVER_SIGWAKEUP              18
 
 #define HTTP_CONF_MAX_REQUEST_LENGTH            4096
 #define HTTP_CONF_MAX_REQUEST_LINE_LENGTH       256
@@ -178,9 +195,7 @@ struct http_server_t {
 	int  listen_fd;
 	http_server_state_t state;
 	sem_t sem_thread_sync;
-	pthread_t tid;
 	pthread_t c_tid[HTTP_CONF_MAX_CLIENT_HANDLE];
-	mqd_t msg_q;
 
 	int                       tls_init;
 #ifdef CONFIG_NET_SECURITY_TLS
@@ -294,6 +309,20 @@ int http_server_deregister_cb(struct http_server_t *server, int method, const ch
  */
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers);
 
+/**
+ * @brief http_send_file() sends a file as the response.
+ *        The file is streamed from the file system to the socket in pieces,
+ *        it is never read into memory as a whole.
+ *        If the file can not be opened, a 404 response is sent instead.
+ *
+ * @param[in] client a pointer of HTTP client.
+ * @param[in] path path of the file to be sent.
+ * @return On success, HTTP_OK(0) is returned.
+ *         On failure, HTTP_ERROR(-1) is returned.
+ * @since TizenRT v3.1
+ */
+int http_send_file(struct http_client_t *client, const char *path);
+
 #ifdef CONFIG_NET_SECURITY_TLS
 /**
  * @brief http_tls_init() initializes the TLS configuere for webserver.
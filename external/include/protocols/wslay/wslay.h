@@ -212,7 +212,8 @@ void wslay_frame_context_free(wslay_frame_context_ptr ctx);
  * the payload_length of this frame.  iocb->data must point to the
  * payload data to be sent. iocb->data_length must be the length of
  * the data.  This function calls send_callback function if it needs
- * to send bytes.  This function calls gen_mask_callback function if
+ * to send bytes, the frame header is passed together with the first
+ * part of the payload.  This function calls gen_mask_callback function if
  * it needs new mask key.  This function returns the number of payload
  * bytes sent. Please note that it does not include any number of
  * header bytes. If it cannot send any single bytes of payload, it
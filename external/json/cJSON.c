@@ -95,6 +95,29 @@ CJSON_PUBLIC(const char*) cJSON_Version(void)
     return version;
 }
 
+/* ASCII lower case of every byte, a table lookup without the function call
+ * and the locale handling of tolower() */
+static const unsigned char ascii_lower_case[256] =
+{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+    0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+    0x40, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+    0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
+    0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+    0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+    0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f,
+    0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf,
+    0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf,
+    0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf,
+    0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf,
+    0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef,
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+#define ascii_tolower(c) (ascii_lower_case[(unsigned char)(c)])
+
 /* Case insensitive string comparison, doesn't consider two NULL pointers equal though */
 static int case_insensitive_strcmp(const unsigned char *string1, const unsigned char *string2)
 {
@@ -108,7 +131,7 @@ static int case_insensitive_strcmp(const unsigned char *string1, const unsigned
         return 0;
     }
 
-    for(; tolower(*string1) == tolower(*string2); (void)string1++, string2++)
+    for(; ascii_tolower(*string1) == ascii_tolower(*string2); (void)string1++, string2++)
     {
         if (*string1 == '\0')
         {
@@ -116,7 +139,7 @@ static int case_insensitive_strcmp(const unsigned char *string1, const unsigned
         }
     }
 
-    return tolower(*string1) - tolower(*string2);
+    return ascii_tolower(*string1) - ascii_tolower(*string2);
 }
 
 typedef struct internal_hooks
@@ -215,6 +238,86 @@ CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
     }
 }
 
+/* Nodes are taken from the top of an arena, aligned for the double in cJSON,
+ * strings from the bottom, so that neither wastes space on padding. */
+#define CJSON_ARENA_ALIGN sizeof(double)
+#define CJSON_ARENA_NODE_SIZE ((sizeof(cJSON) + CJSON_ARENA_ALIGN - 1) & ~(CJSON_ARENA_ALIGN - 1))
+
+CJSON_PUBLIC(void) cJSON_InitArena(cJSON_Arena *arena, void *buffer, size_t size)
+{
+    size_t end = 0;
+
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    arena->buffer = (unsigned char*)buffer;
+    arena->size = 0;
+    if (buffer != NULL)
+    {
+        /* align the top for the nodes */
+        end = ((size_t)arena->buffer + size) & ~(CJSON_ARENA_ALIGN - 1);
+        if (end > (size_t)arena->buffer)
+        {
+            arena->size = end - (size_t)arena->buffer;
+        }
+    }
+    cJSON_ResetArena(arena);
+}
+
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    arena->low = 0;
+    arena->high = arena->size;
+}
+
+CJSON_PUBLIC(size_t) cJSON_ArenaUsed(const cJSON_Arena *arena)
+{
+    if (arena == NULL)
+    {
+        return 0;
+    }
+
+    return arena->low + (arena->size - arena->high);
+}
+
+static cJSON *arena_new_item(cJSON_Arena * const arena)
+{
+    cJSON *node = NULL;
+
+    if ((arena->high - arena->low) < CJSON_ARENA_NODE_SIZE)
+    {
+        return NULL;
+    }
+
+    arena->high -= CJSON_ARENA_NODE_SIZE;
+    node = (cJSON*)(arena->buffer + arena->high);
+    memset(node, '\0', sizeof(cJSON));
+
+    return node;
+}
+
+static unsigned char *arena_allocate_string(cJSON_Arena * const arena, size_t size)
+{
+    unsigned char *string = NULL;
+
+    if ((arena->high - arena->low) < size)
+    {
+        return NULL;
+    }
+
+    string = arena->buffer + arena->low;
+    arena->low += size;
+
+    return string;
+}
+
 
 typedef struct
 {
@@ -223,6 +326,8 @@ typedef struct
     size_t offset;
     size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
     internal_hooks hooks;
+    cJSON_Arena *arena; /* if not NULL, nodes and strings are taken from here instead of the hooks */
+    cJSON_bool in_situ; /* strings are unescaped in place, content is writable */
 } parse_buffer;
 
 /* check if the given size is left to read in a given parse buffer (starting with 1) */
@@ -666,6 +771,26 @@ fail:
     return 0;
 }
 
+/* allocate a new item for the parser */
+static cJSON *parse_new_item(parse_buffer * const input_buffer)
+{
+    if (input_buffer->arena != NULL)
+    {
+        return arena_new_item(input_buffer->arena);
+    }
+
+    return cJSON_New_Item(&(input_buffer->hooks));
+}
+
+/* free the items of a failed parse, arena memory is given back by the caller */
+static void parse_delete_items(parse_buffer * const input_buffer, cJSON *items)
+{
+    if ((items != NULL) && (input_buffer->arena == NULL))
+    {
+        cJSON_Delete(items);
+    }
+}
+
 /* Parse the input text into an unescaped cinput, and populate item. */
 static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_buffer)
 {
@@ -706,7 +831,19 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
 
         /* This is at most how much we need for the output */
         allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
+        if (input_buffer->in_situ)
+        {
+            /* unescaping never makes a string longer, the terminator takes the place of the closing quote at the latest */
+            output = (unsigned char*)input_pointer;
+        }
+        else if (input_buffer->arena != NULL)
+        {
+            output = arena_allocate_string(input_buffer->arena, allocation_length + sizeof(""));
+        }
+        else
+        {
+            output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
+        }
         if (output == NULL)
         {
             goto fail; /* allocation failure */
@@ -773,6 +910,12 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     /* zero terminate the output */
     *output_pointer = '\0';
 
+    if ((input_buffer->arena != NULL) && !input_buffer->in_situ)
+    {
+        /* give back what escape sequences saved */
+        input_buffer->arena->low = (size_t)(output_pointer + sizeof("") - input_buffer->arena->buffer);
+    }
+
     item->type = cJSON_String;
     item->valuestring = (char*)output;
 
@@ -782,7 +925,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     return true;
 
 fail:
-    if (output != NULL)
+    if ((output != NULL) && (input_buffer->arena == NULL))
     {
         input_buffer->hooks.deallocate(output);
     }
@@ -953,9 +1096,10 @@ static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
 }
 
 /* Parse an object - create a new root, and populate. */
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+static cJSON *parse_with_opts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, cJSON_Arena *arena, cJSON_bool in_situ)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 }, NULL, false };
+    cJSON_Arena arena_state = { NULL, 0, 0, 0 };
     cJSON *item = NULL;
 
     /* reset error position */
@@ -971,8 +1115,14 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return
     buffer.length = strlen((const char*)value) + sizeof("");
     buffer.offset = 0;
     buffer.hooks = global_hooks;
+    buffer.arena = arena;
+    buffer.in_situ = in_situ;
+    if (arena != NULL)
+    {
+        arena_state = *arena;
+    }
 
-    item = cJSON_New_Item(&global_hooks);
+    item = parse_new_item(&buffer);
     if (item == NULL) /* memory fail */
     {
         goto fail;
@@ -1001,7 +1151,12 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return
     return item;
 
 fail:
-    if (item != NULL)
+    if (arena != NULL)
+    {
+        /* release everything this parse took */
+        *arena = arena_state;
+    }
+    else if (item != NULL)
     {
         cJSON_Delete(item);
     }
@@ -1034,6 +1189,31 @@ fail:
     return NULL;
 }
 
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    return parse_with_opts(value, return_parse_end, require_null_terminated, NULL, false);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInArena(cJSON_Arena *arena, const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    if ((arena == NULL) || (arena->buffer == NULL))
+    {
+        return NULL;
+    }
+
+    return parse_with_opts(value, return_parse_end, require_null_terminated, arena, false);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(cJSON_Arena *arena, char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    if ((arena == NULL) || (arena->buffer == NULL))
+    {
+        return NULL;
+    }
+
+    return parse_with_opts(value, return_parse_end, require_null_terminated, arena, true);
+}
+
 /* Default options for cJSON_Parse */
 CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
 {
@@ -1337,7 +1517,7 @@ static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buf
     do
     {
         /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+        cJSON *new_item = parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1384,10 +1564,7 @@ success:
     return true;
 
 fail:
-    if (head != NULL)
-    {
-        cJSON_Delete(head);
-    }
+    parse_delete_items(input_buffer, head);
 
     return false;
 }
@@ -1491,7 +1668,7 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
     do
     {
         /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+        cJSON *new_item = parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1555,10 +1732,7 @@ success:
     return true;
 
 fail:
-    if (head != NULL)
-    {
-        cJSON_Delete(head);
-    }
+    parse_delete_items(input_buffer, head);
 
     return false;
 }
@@ -1733,23 +1907,27 @@ CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index)
 static cJSON *get_object_item(const cJSON * const object, const char * const name, const cJSON_bool case_sensitive)
 {
     cJSON *current_element = NULL;
+    unsigned char first = 0;
 
     if ((object == NULL) || (name == NULL))
     {
         return NULL;
     }
 
+    /* most keys already differ in the first character, check it before calling the string comparison */
     current_element = object->child;
     if (case_sensitive)
     {
-		while ((current_element != NULL) && (current_element->string != NULL) && (strcmp(name, current_element->string) != 0))
+        first = (unsigned char)name[0];
+		while ((current_element != NULL) && (current_element->string != NULL) && (((unsigned char)current_element->string[0] != first) || (strcmp(name, current_element->string) != 0)))
 		{
             current_element = current_element->next;
         }
     }
     else
     {
-        while ((current_element != NULL) && (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) != 0))
+        first = (unsigned char)ascii_tolower((unsigned char)name[0]);
+        while ((current_element != NULL) && ((current_element->string == NULL) || (ascii_tolower((unsigned char)current_element->string[0]) != first) || (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) != 0)))
         {
             current_element = current_element->next;
         }
@@ -0,0 +1,1025 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * external/json/cJSON_Stream.c
+ *
+ * Pull reader and push writer for JSON documents that should not be held in
+ * memory as a whole. See external/include/json/cJSON_Stream.h.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <json/cJSON.h>
+#include <json/cJSON_Stream.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* What the reader expects next */
+#define READER_VALUE         0	/* Any value, also the start of the document */
+#define READER_VALUE_OR_END  1	/* Right after '[' */
+#define READER_KEY_OR_END    2	/* Right after '{' */
+#define READER_KEY           3	/* After ',' inside an object */
+#define READER_NEXT          4	/* After a value: ',' or the end of the level */
+#define READER_DONE          5
+#define READER_ERROR         6
+
+/* Smallest value buffer grown by the reader itself */
+#define READER_VALUE_MIN     32
+
+#define LEVEL_TEST(bits, level)  (((bits)[(level) >> 3] & (1 << ((level) & 7))) != 0)
+#define LEVEL_SET(bits, level)   ((bits)[(level) >> 3] |= (unsigned char)(1 << ((level) & 7)))
+#define LEVEL_CLEAR(bits, level) ((bits)[(level) >> 3] &= (unsigned char)~(1 << ((level) & 7)))
+
+/****************************************************************************
+ * Private Functions: reader
+ ****************************************************************************/
+
+/* Makes sure there is unread input. Returns 1 if so, 0 at the end of the input, -1 on a read error. */
+static int reader_fill(cJSON_Reader *reader)
+{
+	int ret;
+
+	if (reader->offset < reader->size) {
+		return 1;
+	}
+	if (reader->eof) {
+		return 0;
+	}
+	if (reader->read == NULL) {
+		reader->eof = true;
+		return 0;
+	}
+
+	ret = reader->read(reader->context, reader->window, reader->window_size);
+	if (ret <= 0) {
+		reader->eof = true;
+		return ret < 0 ? -1 : 0;
+	}
+
+	reader->data = reader->window;
+	reader->offset = 0;
+	reader->size = (size_t)ret;
+	return 1;
+}
+
+/* Returns the next unread character without consuming it, or -1 at the end of the input. */
+static int reader_peek(cJSON_Reader *reader)
+{
+	if (reader_fill(reader) <= 0) {
+		return -1;
+	}
+	return (unsigned char)reader->data[reader->offset];
+}
+
+static int reader_get(cJSON_Reader *reader)
+{
+	int c = reader_peek(reader);
+
+	if (c >= 0) {
+		reader->offset++;
+	}
+	return c;
+}
+
+/* Skips whitespace and returns the next character, unconsumed */
+static int reader_skip(cJSON_Reader *reader)
+{
+	int c;
+
+	while ((c = reader_peek(reader)) >= 0 && c <= 32) {
+		reader->offset++;
+	}
+	return c;
+}
+
+static int reader_fail(cJSON_Reader *reader)
+{
+	reader->state = READER_ERROR;
+	return cJSON_TokenError;
+}
+
+static cJSON_bool reader_append(cJSON_Reader *reader, const char *text, size_t length)
+{
+	if (reader->length + length + 1 > reader->value_size) {
+		size_t size = reader->value_size > 0 ? reader->value_size : READER_VALUE_MIN;
+		char *value;
+
+		if (!reader->value_owned) {
+			return false;
+		}
+		while (size < reader->length + length + 1) {
+			size <<= 1;
+		}
+		value = (char *)cJSON_malloc(size);
+		if (value == NULL) {
+			return false;
+		}
+		if (reader->value != NULL) {
+			memcpy(value, reader->value, reader->length);
+			cJSON_free(reader->value);
+		}
+		reader->value = value;
+		reader->value_size = size;
+	}
+
+	memcpy(reader->value + reader->length, text, length);
+	reader->length += length;
+	reader->value[reader->length] = '\0';
+	return true;
+}
+
+static cJSON_bool reader_hex4(cJSON_Reader *reader, unsigned int *code)
+{
+	int i;
+	int c;
+
+	*code = 0;
+	for (i = 0; i < 4; i++) {
+		c = reader_get(reader);
+		if (c >= '0' && c <= '9') {
+			c -= '0';
+		} else if (c >= 'a' && c <= 'f') {
+			c -= 'a' - 10;
+		} else if (c >= 'A' && c <= 'F') {
+			c -= 'A' - 10;
+		} else {
+			return false;
+		}
+		*code = (*code << 4) | (unsigned int)c;
+	}
+	return true;
+}
+
+/* Decodes \uXXXX, including surrogate pairs, to UTF-8. The "\u" has been consumed. */
+static cJSON_bool reader_utf16(cJSON_Reader *reader)
+{
+	unsigned int code;
+	unsigned int low;
+	char utf8[4];
+	size_t length;
+
+	if (!reader_hex4(reader, &code)) {
+		return false;
+	}
+	if (code >= 0xDC00 && code <= 0xDFFF) {
+		return false;
+	}
+	if (code >= 0xD800 && code <= 0xDBFF) {
+		if (reader_get(reader) != '\\' || reader_get(reader) != 'u' || !reader_hex4(reader, &low)) {
+			return false;
+		}
+		if (low < 0xDC00 || low > 0xDFFF) {
+			return false;
+		}
+		code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+	}
+
+	if (code < 0x80) {
+		utf8[0] = (char)code;
+		length = 1;
+	} else if (code < 0x800) {
+		utf8[0] = (char)(0xC0 | (code >> 6));
+		utf8[1] = (char)(0x80 | (code & 0x3F));
+		length = 2;
+	} else if (code < 0x10000) {
+		utf8[0] = (char)(0xE0 | (code >> 12));
+		utf8[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+		utf8[2] = (char)(0x80 | (code & 0x3F));
+		length = 3;
+	} else {
+		utf8[0] = (char)(0xF0 | (code >> 18));
+		utf8[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+		utf8[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+		utf8[3] = (char)(0x80 | (code & 0x3F));
+		length = 4;
+	}
+	return reader_append(reader, utf8, length);
+}
+
+/* Reads a string into value. The opening quote has been consumed. */
+static cJSON_bool reader_string(cJSON_Reader *reader)
+{
+	const char *start;
+	const char *end;
+	const char *p;
+	char c;
+
+	reader->length = 0;
+	if (!reader_append(reader, "", 0)) {
+		return false;
+	}
+
+	for (;;) {
+		if (reader_fill(reader) <= 0) {
+			return false;
+		}
+
+		/* Copy the run of plain characters in one go */
+
+		start = reader->data + reader->offset;
+		end = reader->data + reader->size;
+		for (p = start; p < end && *p != '\"' && *p != '\\'; p++) {
+		}
+		if (p > start && !reader_append(reader, start, (size_t)(p - start))) {
+			return false;
+		}
+		reader->offset += (size_t)(p - start);
+		if (p == end) {
+			continue;
+		}
+
+		reader->offset++;
+		if (*p == '\"') {
+			return true;
+		}
+
+		switch (reader_get(reader)) {
+		case '\"':
+			c = '\"';
+			break;
+		case '\\':
+			c = '\\';
+			break;
+		case '/':
+			c = '/';
+			break;
+		case 'b':
+			c = '\b';
+			break;
+		case 'f':
+			c = '\f';
+			break;
+		case 'n':
+			c = '\n';
+			break;
+		case 'r':
+			c = '\r';
+			break;
+		case 't':
+			c = '\t';
+			break;
+		case 'u':
+			if (!reader_utf16(reader)) {
+				return false;
+			}
+			continue;
+		default:
+			return false;
+		}
+		if (!reader_append(reader, &c, 1)) {
+			return false;
+		}
+	}
+}
+
+static cJSON_bool reader_number(cJSON_Reader *reader)
+{
+	char *end;
+	char c;
+	int next;
+
+	reader->length = 0;
+	while ((next = reader_peek(reader)) >= 0) {
+		if (!((next >= '0' && next <= '9') || next == '-' || next == '+' || next == '.' || next == 'e' || next == 'E')) {
+			break;
+		}
+		c = (char)next;
+		if (!reader_append(reader, &c, 1)) {
+			return false;
+		}
+		reader->offset++;
+	}
+	if (reader->length == 0) {
+		return false;
+	}
+
+	reader->number = strtod(reader->value, &end);
+	return end == reader->value + reader->length;
+}
+
+static cJSON_bool reader_literal(cJSON_Reader *reader, const char *literal)
+{
+	for (; *literal != '\0'; literal++) {
+		if (reader_get(reader) != (unsigned char)*literal) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static int reader_push(cJSON_Reader *reader, cJSON_bool object)
+{
+	if (reader->depth >= CJSON_STREAM_NESTING_LIMIT) {
+		return reader_fail(reader);
+	}
+
+	reader->offset++;
+	reader->depth++;
+	if (object) {
+		LEVEL_SET(reader->objects, reader->depth);
+		reader->state = READER_KEY_OR_END;
+		return cJSON_TokenObjectStart;
+	}
+	LEVEL_CLEAR(reader->objects, reader->depth);
+	reader->state = READER_VALUE_OR_END;
+	return cJSON_TokenArrayStart;
+}
+
+/* Ends the current level if c closes it */
+static int reader_pop(cJSON_Reader *reader, int c)
+{
+	cJSON_bool object;
+
+	if (reader->depth == 0) {
+		return reader_fail(reader);
+	}
+	object = LEVEL_TEST(reader->objects, reader->depth);
+	if (c != (object ? '}' : ']')) {
+		return reader_fail(reader);
+	}
+
+	reader->offset++;
+	reader->depth--;
+	reader->state = reader->depth > 0 ? READER_NEXT : READER_DONE;
+	return object ? cJSON_TokenObjectEnd : cJSON_TokenArrayEnd;
+}
+
+static int reader_value(cJSON_Reader *reader, int c)
+{
+	int token;
+
+	switch (c) {
+	case '{':
+		return reader_push(reader, true);
+	case '[':
+		return reader_push(reader, false);
+	case '\"':
+		reader->offset++;
+		if (!reader_string(reader)) {
+			return reader_fail(reader);
+		}
+		token = cJSON_TokenString;
+		break;
+	case 't':
+		if (!reader_literal(reader, "true")) {
+			return reader_fail(reader);
+		}
+		token = cJSON_TokenTrue;
+		break;
+	case 'f':
+		if (!reader_literal(reader, "false")) {
+			return reader_fail(reader);
+		}
+		token = cJSON_TokenFalse;
+		break;
+	case 'n':
+		if (!reader_literal(reader, "null")) {
+			return reader_fail(reader);
+		}
+		token = cJSON_TokenNull;
+		break;
+	default:
+		if (c != '-' && (c < '0' || c > '9')) {
+			return reader_fail(reader);
+		}
+		if (!reader_number(reader)) {
+			return reader_fail(reader);
+		}
+		token = cJSON_TokenNumber;
+		break;
+	}
+
+	reader->state = reader->depth > 0 ? READER_NEXT : READER_DONE;
+	return token;
+}
+
+/* Builds the value that starts with token */
+static cJSON *reader_item(cJSON_Reader *reader, int token)
+{
+	cJSON *item;
+	cJSON *child;
+	cJSON *tail = NULL;
+	char *name = NULL;
+	int end;
+
+	switch (token) {
+	case cJSON_TokenString:
+		item = cJSON_CreateString(reader->value);
+		break;
+	case cJSON_TokenNumber:
+		item = cJSON_CreateNumber(reader->number);
+		break;
+	case cJSON_TokenTrue:
+		item = cJSON_CreateTrue();
+		break;
+	case cJSON_TokenFalse:
+		item = cJSON_CreateFalse();
+		break;
+	case cJSON_TokenNull:
+		item = cJSON_CreateNull();
+		break;
+	case cJSON_TokenObjectStart:
+	case cJSON_TokenArrayStart:
+		if (token == cJSON_TokenObjectStart) {
+			item = cJSON_CreateObject();
+			end = cJSON_TokenObjectEnd;
+		} else {
+			item = cJSON_CreateArray();
+			end = cJSON_TokenArrayEnd;
+		}
+		if (item == NULL) {
+			break;
+		}
+
+		while ((token = cJSON_ReaderNext(reader)) != end) {
+			if (end == cJSON_TokenObjectEnd) {
+				if (token != cJSON_TokenKey) {
+					goto errout;
+				}
+				name = (char *)cJSON_malloc(reader->length + 1);
+				if (name == NULL) {
+					goto errout;
+				}
+				memcpy(name, reader->value, reader->length + 1);
+				token = cJSON_ReaderNext(reader);
+			}
+
+			child = reader_item(reader, token);
+			if (child == NULL) {
+				goto errout;
+			}
+			child->string = name;
+			name = NULL;
+
+			/* Append without walking the list, as the parser does */
+
+			if (tail == NULL) {
+				item->child = child;
+			} else {
+				tail->next = child;
+				child->prev = tail;
+			}
+			tail = child;
+		}
+		return item;
+	default:
+		return NULL;
+	}
+
+	if (item == NULL) {
+		reader_fail(reader);
+	}
+	return item;
+
+errout:
+	if (name != NULL) {
+		cJSON_free(name);
+	}
+	cJSON_Delete(item);
+	reader_fail(reader);
+	return NULL;
+}
+
+/****************************************************************************
+ * Private Functions: writer
+ ****************************************************************************/
+
+static cJSON_bool writer_fail(cJSON_Writer *writer)
+{
+	writer->error = true;
+	return false;
+}
+
+static cJSON_bool writer_flush(cJSON_Writer *writer)
+{
+	if (writer->used == 0) {
+		return true;
+	}
+	if (writer->write == NULL) {
+		return false;
+	}
+	if (writer->write(writer->context, writer->buffer, writer->used) != (int)writer->used) {
+		return false;
+	}
+	writer->total += writer->used;
+	writer->used = 0;
+	return true;
+}
+
+static cJSON_bool writer_put(cJSON_Writer *writer, const char *text, size_t length)
+{
+	size_t chunk;
+
+	while (length > 0) {
+		if (writer->used == writer->size && !writer_flush(writer)) {
+			return writer_fail(writer);
+		}
+		chunk = writer->size - writer->used;
+		if (chunk > length) {
+			chunk = length;
+		}
+		memcpy(writer->buffer + writer->used, text, chunk);
+		writer->used += chunk;
+		text += chunk;
+		length -= chunk;
+	}
+	return true;
+}
+
+static cJSON_bool writer_tabs(cJSON_Writer *writer, int count)
+{
+	static const char tabs[8] = { '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t' };
+	int chunk;
+
+	while (count > 0) {
+		chunk = count > (int)sizeof(tabs) ? (int)sizeof(tabs) : count;
+		if (!writer_put(writer, tabs, (size_t)chunk)) {
+			return false;
+		}
+		count -= chunk;
+	}
+	return true;
+}
+
+/* Escapes the same characters as cJSON_Print */
+static cJSON_bool writer_string(cJSON_Writer *writer, const char *string)
+{
+	const unsigned char *start;
+	const unsigned char *p;
+	char escape[7];
+	size_t length;
+
+	if (string == NULL) {
+		string = "";
+	}
+	if (!writer_put(writer, "\"", 1)) {
+		return false;
+	}
+
+	start = (const unsigned char *)string;
+	for (p = start; ; p++) {
+		if (*p != '\0' && *p > 31 && *p != '\"' && *p != '\\') {
+			continue;
+		}
+		if (p > start && !writer_put(writer, (const char *)start, (size_t)(p - start))) {
+			return false;
+		}
+		if (*p == '\0') {
+			break;
+		}
+
+		escape[0] = '\\';
+		length = 2;
+		switch (*p) {
+		case '\"':
+			escape[1] = '\"';
+			break;
+		case '\\':
+			escape[1] = '\\';
+			break;
+		case '\b':
+			escape[1] = 'b';
+			break;
+		case '\f':
+			escape[1] = 'f';
+			break;
+		case '\n':
+			escape[1] = 'n';
+			break;
+		case '\r':
+			escape[1] = 'r';
+			break;
+		case '\t':
+			escape[1] = 't';
+			break;
+		default:
+			snprintf(escape + 1, sizeof(escape) - 1, "u%04x", *p);
+			length = 6;
+			break;
+		}
+		if (!writer_put(writer, escape, length)) {
+			return false;
+		}
+		start = p + 1;
+	}
+
+	return writer_put(writer, "\"", 1);
+}
+
+/* Separator, indentation and name in front of the next value */
+static cJSON_bool writer_begin(cJSON_Writer *writer, const char *name)
+{
+	cJSON_bool object;
+
+	if (writer->error) {
+		return false;
+	}
+
+	object = LEVEL_TEST(writer->objects, writer->depth);
+	if (writer->depth == 0) {
+		if (name != NULL || LEVEL_TEST(writer->members, 0)) {
+			return writer_fail(writer);
+		}
+	} else if (object != (name != NULL)) {
+		return writer_fail(writer);
+	}
+
+	if (LEVEL_TEST(writer->members, writer->depth)) {
+		if (!writer_put(writer, ",", 1)) {
+			return false;
+		}
+		if (writer->format && !writer_put(writer, object ? "\n" : " ", 1)) {
+			return false;
+		}
+	}
+	LEVEL_SET(writer->members, writer->depth);
+
+	if (object) {
+		if (writer->format && !writer_tabs(writer, writer->depth)) {
+			return false;
+		}
+		if (!writer_string(writer, name)) {
+			return false;
+		}
+		if (!writer_put(writer, ":\t", writer->format ? 2 : 1)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static cJSON_bool writer_push(cJSON_Writer *writer, const char *name, cJSON_bool object)
+{
+	if (!writer_begin(writer, name)) {
+		return false;
+	}
+	if (writer->depth >= CJSON_STREAM_NESTING_LIMIT) {
+		return writer_fail(writer);
+	}
+
+	writer->depth++;
+	LEVEL_CLEAR(writer->members, writer->depth);
+	if (object) {
+		LEVEL_SET(writer->objects, writer->depth);
+		return writer_put(writer, "{\n", writer->format ? 2 : 1);
+	}
+	LEVEL_CLEAR(writer->objects, writer->depth);
+	return writer_put(writer, "[", 1);
+}
+
+static cJSON_bool writer_pop(cJSON_Writer *writer, cJSON_bool object)
+{
+	if (writer->error) {
+		return false;
+	}
+	if (writer->depth == 0 || LEVEL_TEST(writer->objects, writer->depth) != object) {
+		return writer_fail(writer);
+	}
+
+	if (object && writer->format) {
+		if (LEVEL_TEST(writer->members, writer->depth) && !writer_put(writer, "\n", 1)) {
+			return false;
+		}
+		if (!writer_tabs(writer, writer->depth - 1)) {
+			return false;
+		}
+	}
+	writer->depth--;
+	return writer_put(writer, object ? "}" : "]", 1);
+}
+
+static cJSON_bool writer_item(cJSON_Writer *writer, const char *name, const cJSON *item)
+{
+	const cJSON *child;
+
+	if (item == NULL) {
+		return writer_fail(writer);
+	}
+
+	switch (item->type & 0xFF) {
+	case cJSON_NULL:
+		return cJSON_WriteNull(writer, name);
+	case cJSON_False:
+		return cJSON_WriteBool(writer, name, false);
+	case cJSON_True:
+		return cJSON_WriteBool(writer, name, true);
+	case cJSON_Number:
+		return cJSON_WriteNumber(writer, name, item->valuedouble);
+	case cJSON_String:
+		return cJSON_WriteString(writer, name, item->valuestring);
+	case cJSON_Raw:
+		if (item->valuestring == NULL) {
+			return writer_fail(writer);
+		}
+		return writer_begin(writer, name) && writer_put(writer, item->valuestring, strlen(item->valuestring));
+	case cJSON_Array:
+		if (!cJSON_WriteArrayStart(writer, name)) {
+			return false;
+		}
+		for (child = item->child; child != NULL; child = child->next) {
+			if (!writer_item(writer, NULL, child)) {
+				return false;
+			}
+		}
+		return cJSON_WriteArrayEnd(writer);
+	case cJSON_Object:
+		if (!cJSON_WriteObjectStart(writer, name)) {
+			return false;
+		}
+		for (child = item->child; child != NULL; child = child->next) {
+			if (child->string == NULL) {
+				return writer_fail(writer);
+			}
+			if (!writer_item(writer, child->string, child)) {
+				return false;
+			}
+		}
+		return cJSON_WriteObjectEnd(writer);
+	default:
+		return writer_fail(writer);
+	}
+}
+
+/****************************************************************************
+ * Public Functions: reader
+ ****************************************************************************/
+
+CJSON_PUBLIC(void) cJSON_InitReader(cJSON_Reader *reader, cJSON_ReadCallback read, void *context, char *window, size_t window_size, char *value, size_t value_size)
+{
+	if (reader == NULL) {
+		return;
+	}
+
+	memset(reader, 0, sizeof(cJSON_Reader));
+	reader->read = read;
+	reader->context = context;
+	reader->window = window;
+	reader->window_size = window_size;
+	reader->data = window;
+	reader->value = value;
+	reader->value_size = value != NULL ? value_size : 0;
+	reader->value_owned = value == NULL;
+	reader->state = READER_VALUE;
+	if (read == NULL || window == NULL || window_size == 0) {
+		reader->state = READER_ERROR;
+	}
+}
+
+CJSON_PUBLIC(void) cJSON_InitStringReader(cJSON_Reader *reader, const char *json, size_t length, char *value, size_t value_size)
+{
+	if (reader == NULL) {
+		return;
+	}
+
+	memset(reader, 0, sizeof(cJSON_Reader));
+	reader->data = json;
+	reader->size = json != NULL ? length : 0;
+	reader->value = value;
+	reader->value_size = value != NULL ? value_size : 0;
+	reader->value_owned = value == NULL;
+	reader->state = READER_VALUE;
+}
+
+CJSON_PUBLIC(void) cJSON_ReleaseReader(cJSON_Reader *reader)
+{
+	if (reader == NULL) {
+		return;
+	}
+
+	if (reader->value_owned && reader->value != NULL) {
+		cJSON_free(reader->value);
+	}
+	reader->value = NULL;
+	reader->value_size = 0;
+	reader->state = READER_ERROR;
+}
+
+CJSON_PUBLIC(int) cJSON_ReaderNext(cJSON_Reader *reader)
+{
+	int c;
+
+	if (reader == NULL || reader->state == READER_ERROR) {
+		return cJSON_TokenError;
+	}
+	if (reader->state == READER_DONE) {
+		return cJSON_TokenEnd;
+	}
+
+	c = reader_skip(reader);
+	if (reader->state == READER_NEXT) {
+		if (c != ',') {
+			return reader_pop(reader, c);
+		}
+		reader->offset++;
+		reader->state = LEVEL_TEST(reader->objects, reader->depth) ? READER_KEY : READER_VALUE;
+		c = reader_skip(reader);
+	}
+
+	switch (reader->state) {
+	case READER_KEY_OR_END:
+		if (c == '}') {
+			return reader_pop(reader, c);
+		}
+		/* Fall through */
+	case READER_KEY:
+		if (c != '\"') {
+			return reader_fail(reader);
+		}
+		reader->offset++;
+		if (!reader_string(reader) || reader_skip(reader) != ':') {
+			return reader_fail(reader);
+		}
+		reader->offset++;
+		reader->state = READER_VALUE;
+		return cJSON_TokenKey;
+	case READER_VALUE_OR_END:
+		if (c == ']') {
+			return reader_pop(reader, c);
+		}
+		/* Fall through */
+	default:
+		return reader_value(reader, c);
+	}
+}
+
+CJSON_PUBLIC(int) cJSON_ReaderDepth(const cJSON_Reader *reader)
+{
+	return reader != NULL ? reader->depth : 0;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ReaderSkipValue(cJSON_Reader *reader)
+{
+	int depth;
+	int token;
+
+	if (reader == NULL) {
+		return false;
+	}
+
+	depth = reader->depth;
+	token = cJSON_ReaderNext(reader);
+	switch (token) {
+	case cJSON_TokenObjectStart:
+	case cJSON_TokenArrayStart:
+		while (reader->depth > depth) {
+			if (cJSON_ReaderNext(reader) == cJSON_TokenError) {
+				return false;
+			}
+		}
+		return true;
+	case cJSON_TokenString:
+	case cJSON_TokenNumber:
+	case cJSON_TokenTrue:
+	case cJSON_TokenFalse:
+	case cJSON_TokenNull:
+		return true;
+	default:
+		return false;
+	}
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ReaderGetValue(cJSON_Reader *reader)
+{
+	if (reader == NULL) {
+		return NULL;
+	}
+	return reader_item(reader, cJSON_ReaderNext(reader));
+}
+
+/****************************************************************************
+ * Public Functions: writer
+ ****************************************************************************/
+
+CJSON_PUBLIC(void) cJSON_InitWriter(cJSON_Writer *writer, cJSON_WriteCallback write, void *context, char *buffer, size_t size, cJSON_bool format)
+{
+	if (writer == NULL) {
+		return;
+	}
+
+	memset(writer, 0, sizeof(cJSON_Writer));
+	writer->write = write;
+	writer->context = context;
+	writer->buffer = buffer;
+	writer->size = size;
+	writer->format = format;
+	if (buffer == NULL || size == 0) {
+		writer->error = true;
+	}
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteObjectStart(cJSON_Writer *writer, const char *name)
+{
+	return writer != NULL && writer_push(writer, name, true);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteObjectEnd(cJSON_Writer *writer)
+{
+	return writer != NULL && writer_pop(writer, true);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteArrayStart(cJSON_Writer *writer, const char *name)
+{
+	return writer != NULL && writer_push(writer, name, false);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteArrayEnd(cJSON_Writer *writer)
+{
+	return writer != NULL && writer_pop(writer, false);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteString(cJSON_Writer *writer, const char *name, const char *string)
+{
+	return writer != NULL && writer_begin(writer, name) && writer_string(writer, string);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteNumber(cJSON_Writer *writer, const char *name, double number)
+{
+	char text[27];
+	double test;
+	int length;
+
+	if (writer == NULL || !writer_begin(writer, name)) {
+		return false;
+	}
+
+	/* Same precision rules as cJSON_Print */
+
+	if ((number * 0) != 0) {
+		length = snprintf(text, sizeof(text), "null");
+	} else {
+		length = snprintf(text, sizeof(text), "%1.15g", number);
+		if (sscanf(text, "%lg", &test) != 1 || test != number) {
+			length = snprintf(text, sizeof(text), "%1.17g", number);
+		}
+	}
+	if (length < 0 || length >= (int)sizeof(text)) {
+		return writer_fail(writer);
+	}
+	return writer_put(writer, text, (size_t)length);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteBool(cJSON_Writer *writer, const char *name, cJSON_bool boolean)
+{
+	if (writer == NULL || !writer_begin(writer, name)) {
+		return false;
+	}
+	return boolean ? writer_put(writer, "true", 4) : writer_put(writer, "false", 5);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteNull(cJSON_Writer *writer, const char *name)
+{
+	return writer != NULL && writer_begin(writer, name) && writer_put(writer, "null", 4);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteItem(cJSON_Writer *writer, const char *name, const cJSON *item)
+{
+	return writer != NULL && !writer->error && writer_item(writer, name, item);
+}
+
+CJSON_PUBLIC(int) cJSON_WriterFinish(cJSON_Writer *writer)
+{
+	if (writer == NULL || writer->error || writer->depth != 0) {
+		return -1;
+	}
+
+	if (writer->write == NULL) {
+		/* Everything is in the buffer, which needs room for the terminator */
+
+		if (writer->used >= writer->size) {
+			writer->error = true;
+			return -1;
+		}
+		writer->buffer[writer->used] = '\0';
+		return (int)writer->used;
+	}
+
+	if (!writer_flush(writer)) {
+		writer->error = true;
+		return -1;
+	}
+	return (int)writer->total;
+}
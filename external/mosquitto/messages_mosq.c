@@ -41,6 +41,7 @@ Contributors:
 #include <mosquitto.h>
 #include <memory_mosq.h>
 #include <messages_mosq.h>
+#include <net_mosq.h>
 #include <send_mosq.h>
 #include <time_mosq.h>
 
@@ -63,6 +64,195 @@ void _mosquitto_message_cleanup(struct mosquitto_message_all **message)
 	_mosquitto_free(msg);
 }
 
+/* Smallest size of a message id hash table, a power of two */
+#define MOSQ_MSG_HASH_MIN 16
+
+static struct mosquitto_message_index *_mosquitto_message_index(struct mosquitto *mosq, enum mosquitto_msg_direction dir)
+{
+	return dir == mosq_md_out ? &mosq->out_index : &mosq->in_index;
+}
+
+/* Retry and waiting queue helpers, both are linked through rnext and rprev */
+static void _mosquitto_message_rqueue_append(struct mosquitto_message_all **first, struct mosquitto_message_all **last, struct mosquitto_message_all *message)
+{
+	message->rnext = NULL;
+	message->rprev = *last;
+	if (*last) {
+		(*last)->rnext = message;
+	} else {
+		*first = message;
+	}
+	*last = message;
+}
+
+static void _mosquitto_message_rqueue_unlink(struct mosquitto_message_all **first, struct mosquitto_message_all **last, struct mosquitto_message_all *message)
+{
+	if (message->rprev) {
+		message->rprev->rnext = message->rnext;
+	} else {
+		*first = message->rnext;
+	}
+	if (message->rnext) {
+		message->rnext->rprev = message->rprev;
+	} else {
+		*last = message->rprev;
+	}
+	message->rnext = NULL;
+	message->rprev = NULL;
+}
+
+/* Append to the retry queue.  Timestamps only grow, except when two threads
+ * race between taking the time and queueing, so clamping keeps the queue in
+ * timestamp order. */
+static void _mosquitto_message_retry_append(struct mosquitto_message_index *index, struct mosquitto_message_all *message)
+{
+	if (index->retry_last && message->timestamp < index->retry_last->timestamp) {
+		message->timestamp = index->retry_last->timestamp;
+	}
+	_mosquitto_message_rqueue_append(&index->retry, &index->retry_last, message);
+}
+
+/* An outgoing message is in the waiting queue until it gets an inflight slot */
+static void _mosquitto_message_rqueue_remove(struct mosquitto_message_index *index, struct mosquitto_message_all *message, enum mosquitto_msg_direction dir)
+{
+	if (dir == mosq_md_out && message->state == mosq_ms_invalid) {
+		_mosquitto_message_rqueue_unlink(&index->waiting, &index->waiting_last, message);
+	} else {
+		_mosquitto_message_rqueue_unlink(&index->retry, &index->retry_last, message);
+	}
+}
+
+/* Rebuild the hash table with room for 'count' messages.  On allocation
+ * failure the old table is kept, it only gets slower. */
+static void _mosquitto_message_hash_grow(struct mosquitto_message_index *index, struct mosquitto_message_all *last, int count)
+{
+	struct mosquitto_message_all **hash;
+	struct mosquitto_message_all **bucket;
+	unsigned int size;
+
+	size = index->hash_size ? index->hash_size : MOSQ_MSG_HASH_MIN;
+	while (size < (unsigned int)count && size < 65536) {
+		size <<= 1;
+	}
+	if (size == index->hash_size) {
+		return;
+	}
+
+	hash = _mosquitto_calloc(size, sizeof(struct mosquitto_message_all *));
+	if (!hash) {
+		return;
+	}
+
+	/* Walk backwards and push, so that each bucket stays in queue order */
+	for (; last; last = last->prev) {
+		bucket = &hash[last->msg.mid & (size - 1)];
+		last->hnext = *bucket;
+		*bucket = last;
+	}
+
+	if (index->hash) {
+		_mosquitto_free(index->hash);
+	}
+	index->hash = hash;
+	index->hash_size = size;
+}
+
+static void _mosquitto_message_hash_add(struct mosquitto_message_index *index, struct mosquitto_message_all *message)
+{
+	struct mosquitto_message_all **bucket;
+
+	message->hnext = NULL;
+	if (!index->hash) {
+		return;
+	}
+	bucket = &index->hash[message->msg.mid & (index->hash_size - 1)];
+	while (*bucket) {
+		bucket = &(*bucket)->hnext;
+	}
+	*bucket = message;
+}
+
+static void _mosquitto_message_hash_del(struct mosquitto_message_index *index, struct mosquitto_message_all *message)
+{
+	struct mosquitto_message_all **bucket;
+
+	if (!index->hash) {
+		return;
+	}
+	bucket = &index->hash[message->msg.mid & (index->hash_size - 1)];
+	while (*bucket) {
+		if (*bucket == message) {
+			*bucket = message->hnext;
+			break;
+		}
+		bucket = &(*bucket)->hnext;
+	}
+	message->hnext = NULL;
+}
+
+static void _mosquitto_message_hash_free(struct mosquitto_message_index *index)
+{
+	if (index->hash) {
+		_mosquitto_free(index->hash);
+	}
+	index->hash = NULL;
+	index->hash_size = 0;
+}
+
+/* Oldest message with this mid, without a hash table the list is searched */
+static struct mosquitto_message_all *_mosquitto_message_find(struct mosquitto_message_index *index, struct mosquitto_message_all *messages, uint16_t mid)
+{
+	if (index->hash) {
+		messages = index->hash[mid & (index->hash_size - 1)];
+		while (messages && messages->msg.mid != mid) {
+			messages = messages->hnext;
+		}
+		return messages;
+	}
+
+	while (messages && messages->msg.mid != mid) {
+		messages = messages->next;
+	}
+	return messages;
+}
+
+/* Take a message out of the list, the hash and its queue */
+static void _mosquitto_message_unlink(struct mosquitto *mosq, struct mosquitto_message_all *message, enum mosquitto_msg_direction dir)
+{
+	struct mosquitto_message_index *index = _mosquitto_message_index(mosq, dir);
+	struct mosquitto_message_all **first;
+	struct mosquitto_message_all **last;
+
+	if (dir == mosq_md_out) {
+		first = &mosq->out_messages;
+		last = &mosq->out_messages_last;
+	} else {
+		first = &mosq->in_messages;
+		last = &mosq->in_messages_last;
+	}
+
+	if (message->prev) {
+		message->prev->next = message->next;
+	} else {
+		*first = message->next;
+	}
+	if (message->next) {
+		message->next->prev = message->prev;
+	} else {
+		*last = message->prev;
+	}
+	message->next = NULL;
+	message->prev = NULL;
+
+	_mosquitto_message_hash_del(index, message);
+	_mosquitto_message_rqueue_remove(index, message, dir);
+
+	/* Do not keep a large table around after a backlog has drained */
+	if (!*first) {
+		_mosquitto_message_hash_free(index);
+	}
+}
+
 void _mosquitto_message_cleanup_all(struct mosquitto *mosq)
 {
 	struct mosquitto_message_all *tmp;
@@ -79,6 +269,10 @@ void _mosquitto_message_cleanup_all(struct mosquitto *mosq)
 		_mosquitto_message_cleanup(&mosq->out_messages);
 		mosq->out_messages = tmp;
 	}
+	_mosquitto_message_hash_free(&mosq->in_index);
+	_mosquitto_message_hash_free(&mosq->out_index);
+	memset(&mosq->in_index, 0, sizeof(mosq->in_index));
+	memset(&mosq->out_index, 0, sizeof(mosq->out_index));
 }
 
 int mosquitto_message_copy(struct mosquitto_message *dst, const struct mosquitto_message *src)
@@ -150,21 +344,27 @@ void mosquitto_message_free(struct mosquitto_message **message)
  */
 int _mosquitto_message_queue(struct mosquitto *mosq, struct mosquitto_message_all *message, enum mosquitto_msg_direction dir)
 {
+	struct mosquitto_message_index *index = _mosquitto_message_index(mosq, dir);
 	int rc = 0;
 
 	/* mosq->*_message_mutex should be locked before entering this function */
 	assert(mosq);
 	assert(message);
 
+	message->next = NULL;
 	if (dir == mosq_md_out) {
 		mosq->out_queue_len++;
-		message->next = NULL;
+		message->prev = mosq->out_messages_last;
 		if (mosq->out_messages_last) {
 			mosq->out_messages_last->next = message;
 		} else {
 			mosq->out_messages = message;
 		}
 		mosq->out_messages_last = message;
+		if (!index->hash || (unsigned int)mosq->out_queue_len > index->hash_size) {
+			_mosquitto_message_hash_grow(index, mosq->out_messages_last->prev, mosq->out_queue_len);
+		}
+		_mosquitto_message_hash_add(index, message);
 		if (message->msg.qos > 0) {
 			if (mosq->max_inflight_messages == 0 || mosq->inflight_messages < mosq->max_inflight_messages) {
 				mosq->inflight_messages++;
@@ -174,54 +374,68 @@ int _mosquitto_message_queue(struct mosquitto *mosq, struct mosquitto_message_al
 		}
 	} else {
 		mosq->in_queue_len++;
-		message->next = NULL;
+		message->prev = mosq->in_messages_last;
 		if (mosq->in_messages_last) {
 			mosq->in_messages_last->next = message;
 		} else {
 			mosq->in_messages = message;
 		}
 		mosq->in_messages_last = message;
+		if (!index->hash || (unsigned int)mosq->in_queue_len > index->hash_size) {
+			_mosquitto_message_hash_grow(index, mosq->in_messages_last->prev, mosq->in_queue_len);
+		}
+		_mosquitto_message_hash_add(index, message);
+	}
+
+	/* The caller marks a message that has to wait as mosq_ms_invalid */
+	if (rc) {
+		_mosquitto_message_rqueue_append(&index->waiting, &index->waiting_last, message);
+	} else {
+		_mosquitto_message_retry_append(index, message);
 	}
 	return rc;
 }
 
+/* Reset the message state for a new connection.  The retry and waiting queues
+ * are rebuilt in list order with timestamp 0, so that the retry check on
+ * CONNACK replays all inflight messages in one batch. */
 void _mosquitto_messages_reconnect_reset(struct mosquitto *mosq)
 {
+	struct mosquitto_message_index *index;
 	struct mosquitto_message_all *message;
-	struct mosquitto_message_all *prev = NULL;
+	struct mosquitto_message_all *next;
 	assert(mosq);
 
 	pthread_mutex_lock(&mosq->in_message_mutex);
-	message = mosq->in_messages;
+	for (message = mosq->in_messages; message; message = next) {
+		next = message->next;
+		if (message->msg.qos != 2) {
+			_mosquitto_message_unlink(mosq, message, mosq_md_in);
+			_mosquitto_message_cleanup(&message);
+		}
+	}
+	index = &mosq->in_index;
+	index->retry = NULL;
+	index->retry_last = NULL;
 	mosq->in_queue_len = 0;
-	while (message) {
+	for (message = mosq->in_messages; message; message = message->next) {
+		/* Message state can be preserved here because it should match
+		 * whatever the client has got. */
 		mosq->in_queue_len++;
 		message->timestamp = 0;
-		if (message->msg.qos != 2) {
-			if (prev) {
-				prev->next = message->next;
-				_mosquitto_message_cleanup(&message);
-				message = prev;
-			} else {
-				mosq->in_messages = message->next;
-				_mosquitto_message_cleanup(&message);
-				message = mosq->in_messages;
-			}
-		} else {
-			/* Message state can be preserved here because it should match
-			 * whatever the client has got. */
-		}
-		prev = message;
-		message = message->next;
+		_mosquitto_message_rqueue_append(&index->retry, &index->retry_last, message);
 	}
-	mosq->in_messages_last = prev;
 	pthread_mutex_unlock(&mosq->in_message_mutex);
 
 	pthread_mutex_lock(&mosq->out_message_mutex);
+	index = &mosq->out_index;
+	index->retry = NULL;
+	index->retry_last = NULL;
+	index->waiting = NULL;
+	index->waiting_last = NULL;
 	mosq->inflight_messages = 0;
-	message = mosq->out_messages;
 	mosq->out_queue_len = 0;
-	while (message) {
+	for (message = mosq->out_messages; message; message = message->next) {
 		mosq->out_queue_len++;
 		message->timestamp = 0;
 
@@ -231,109 +445,72 @@ void _mosquitto_messages_reconnect_reset(struct mosquitto *mosq)
 			}
 			if (message->msg.qos == 1) {
 				message->state = mosq_ms_wait_for_puback;
+			} else if (message->msg.qos == 2 && message->state == mosq_ms_invalid) {
+				/* Never sent before */
+				message->state = mosq_ms_wait_for_pubrec;
 			} else if (message->msg.qos == 2) {
 				/* Should be able to preserve state. */
 			}
+			_mosquitto_message_rqueue_append(&index->retry, &index->retry_last, message);
 		} else {
 			message->state = mosq_ms_invalid;
+			_mosquitto_message_rqueue_append(&index->waiting, &index->waiting_last, message);
 		}
-		prev = message;
-		message = message->next;
 	}
-	mosq->out_messages_last = prev;
 	pthread_mutex_unlock(&mosq->out_message_mutex);
 }
 
 int _mosquitto_message_remove(struct mosquitto *mosq, uint16_t mid, enum mosquitto_msg_direction dir, struct mosquitto_message_all **message)
 {
-	struct mosquitto_message_all *cur, *prev = NULL;
-	bool found = false;
-	int rc;
+	struct mosquitto_message_index *index = _mosquitto_message_index(mosq, dir);
+	struct mosquitto_message_all *cur;
 	assert(mosq);
 	assert(message);
 
 	if (dir == mosq_md_out) {
 		pthread_mutex_lock(&mosq->out_message_mutex);
-		cur = mosq->out_messages;
-		while (cur) {
-			if (cur->msg.mid == mid) {
-				if (prev) {
-					prev->next = cur->next;
-				} else {
-					mosq->out_messages = cur->next;
-				}
-				*message = cur;
-				mosq->out_queue_len--;
-				if (cur->next == NULL) {
-					mosq->out_messages_last = prev;
-				} else if (!mosq->out_messages) {
-					mosq->out_messages_last = NULL;
-				}
-				if (cur->msg.qos > 0) {
-					mosq->inflight_messages--;
-				}
-				found = true;
-				break;
-			}
-			prev = cur;
-			cur = cur->next;
+		cur = _mosquitto_message_find(index, mosq->out_messages, mid);
+		if (!cur) {
+			pthread_mutex_unlock(&mosq->out_message_mutex);
+			return MOSQ_ERR_NOT_FOUND;
 		}
 
-		if (found) {
-			cur = mosq->out_messages;
-			while (cur) {
-				if (mosq->max_inflight_messages == 0 || mosq->inflight_messages < mosq->max_inflight_messages) {
-					if (cur->msg.qos > 0 && cur->state == mosq_ms_invalid) {
-						mosq->inflight_messages++;
-						if (cur->msg.qos == 1) {
-							cur->state = mosq_ms_wait_for_puback;
-						} else if (cur->msg.qos == 2) {
-							cur->state = mosq_ms_wait_for_pubrec;
-						}
-						rc = _mosquitto_send_publish(mosq, cur->msg.mid, cur->msg.topic, cur->msg.payloadlen, cur->msg.payload, cur->msg.qos, cur->msg.retain, cur->dup);
-						if (rc) {
-							pthread_mutex_unlock(&mosq->out_message_mutex);
-							return rc;
-						}
-					}
-				} else {
-					pthread_mutex_unlock(&mosq->out_message_mutex);
-					return MOSQ_ERR_SUCCESS;
-				}
-				cur = cur->next;
+		/* A waiting message does not hold an inflight slot */
+		if (cur->msg.qos > 0 && cur->state != mosq_ms_invalid) {
+			mosq->inflight_messages--;
+		}
+		_mosquitto_message_unlink(mosq, cur, mosq_md_out);
+		mosq->out_queue_len--;
+		*message = cur;
+
+		/* Start the waiting messages that fit in the free inflight slots.  A
+		 * failed send is repeated by the retry check. */
+		while (index->waiting && (mosq->max_inflight_messages == 0 || mosq->inflight_messages < mosq->max_inflight_messages)) {
+			cur = index->waiting;
+			_mosquitto_message_rqueue_unlink(&index->waiting, &index->waiting_last, cur);
+			mosq->inflight_messages++;
+			if (cur->msg.qos == 1) {
+				cur->state = mosq_ms_wait_for_puback;
+			} else if (cur->msg.qos == 2) {
+				cur->state = mosq_ms_wait_for_pubrec;
 			}
-			pthread_mutex_unlock(&mosq->out_message_mutex);
-			return MOSQ_ERR_SUCCESS;
-		} else {
-			pthread_mutex_unlock(&mosq->out_message_mutex);
-			return MOSQ_ERR_NOT_FOUND;
+			cur->timestamp = mosquitto_time();
+			_mosquitto_message_retry_append(index, cur);
+			_mosquitto_send_publish(mosq, cur->msg.mid, cur->msg.topic, cur->msg.payloadlen, cur->msg.payload, cur->msg.qos, cur->msg.retain, cur->dup);
 		}
+		pthread_mutex_unlock(&mosq->out_message_mutex);
+		return MOSQ_ERR_SUCCESS;
 	} else {
 		pthread_mutex_lock(&mosq->in_message_mutex);
-		cur = mosq->in_messages;
-		while (cur) {
-			if (cur->msg.mid == mid) {
-				if (prev) {
-					prev->next = cur->next;
-				} else {
-					mosq->in_messages = cur->next;
-				}
-				*message = cur;
-				mosq->in_queue_len--;
-				if (cur->next == NULL) {
-					mosq->in_messages_last = prev;
-				} else if (!mosq->in_messages) {
-					mosq->in_messages_last = NULL;
-				}
-				found = true;
-				break;
-			}
-			prev = cur;
-			cur = cur->next;
+		cur = _mosquitto_message_find(index, mosq->in_messages, mid);
+		if (cur) {
+			_mosquitto_message_unlink(mosq, cur, mosq_md_in);
+			mosq->in_queue_len--;
+			*message = cur;
 		}
-
 		pthread_mutex_unlock(&mosq->in_message_mutex);
-		if (found) {
+
+		if (cur) {
 			return MOSQ_ERR_SUCCESS;
 		} else {
 			return MOSQ_ERR_NOT_FOUND;
@@ -341,12 +518,15 @@ int _mosquitto_message_remove(struct mosquitto *mosq, uint16_t mid, enum mosquit
 	}
 }
 
+/* Only the head of the retry queue can be due: every message that is sent
+ * again gets the current time and moves to the tail. */
 #ifdef WITH_THREADING
-void _mosquitto_message_retry_check_actual(struct mosquitto *mosq, struct mosquitto_message_all *messages, pthread_mutex_t *mutex)
+void _mosquitto_message_retry_check_actual(struct mosquitto *mosq, struct mosquitto_message_index *index, pthread_mutex_t *mutex)
 #else
-void _mosquitto_message_retry_check_actual(struct mosquitto *mosq, struct mosquitto_message_all *messages)
+void _mosquitto_message_retry_check_actual(struct mosquitto *mosq, struct mosquitto_message_index *index)
 #endif
 {
+	struct mosquitto_message_all *message;
 	time_t now = mosquitto_time();
 	assert(mosq);
 
@@ -354,30 +534,27 @@ void _mosquitto_message_retry_check_actual(struct mosquitto *mosq, struct mosqui
 	pthread_mutex_lock(mutex);
 #endif
 
-	while (messages) {
-		if (messages->timestamp + mosq->message_retry < now) {
-			switch (messages->state) {
-			case mosq_ms_wait_for_puback:
-			case mosq_ms_wait_for_pubrec:
-				messages->timestamp = now;
-				messages->dup = true;
-				_mosquitto_send_publish(mosq, messages->msg.mid, messages->msg.topic, messages->msg.payloadlen, messages->msg.payload, messages->msg.qos, messages->msg.retain, messages->dup);
-				break;
-			case mosq_ms_wait_for_pubrel:
-				messages->timestamp = now;
-				messages->dup = true;
-				_mosquitto_send_pubrec(mosq, messages->msg.mid);
-				break;
-			case mosq_ms_wait_for_pubcomp:
-				messages->timestamp = now;
-				messages->dup = true;
-				_mosquitto_send_pubrel(mosq, messages->msg.mid);
-				break;
-			default:
-				break;
-			}
+	while ((message = index->retry) != NULL && message->timestamp + mosq->message_retry < now) {
+		switch (message->state) {
+		case mosq_ms_wait_for_puback:
+		case mosq_ms_wait_for_pubrec:
+			message->dup = true;
+			_mosquitto_send_publish(mosq, message->msg.mid, message->msg.topic, message->msg.payloadlen, message->msg.payload, message->msg.qos, message->msg.retain, message->dup);
+			break;
+		case mosq_ms_wait_for_pubrel:
+			message->dup = true;
+			_mosquitto_send_pubrec(mosq, message->msg.mid);
+			break;
+		case mosq_ms_wait_for_pubcomp:
+			message->dup = true;
+			_mosquitto_send_pubrel(mosq, message->msg.mid);
+			break;
+		default:
+			break;
 		}
-		messages = messages->next;
+		message->timestamp = now;
+		_mosquitto_message_rqueue_unlink(&index->retry, &index->retry_last, message);
+		_mosquitto_message_rqueue_append(&index->retry, &index->retry_last, message);
 	}
 #ifdef WITH_THREADING
 	pthread_mutex_unlock(mutex);
@@ -386,13 +563,17 @@ void _mosquitto_message_retry_check_actual(struct mosquitto *mosq, struct mosqui
 
 void _mosquitto_message_retry_check(struct mosquitto *mosq)
 {
+	/* After a reconnect this replays every inflight message, write them
+	 * together rather than one by one. */
+	_mosquitto_packet_batch_begin(mosq);
 #ifdef WITH_THREADING
-	_mosquitto_message_retry_check_actual(mosq, mosq->out_messages, &mosq->out_message_mutex);
-	_mosquitto_message_retry_check_actual(mosq, mosq->in_messages, &mosq->in_message_mutex);
+	_mosquitto_message_retry_check_actual(mosq, &mosq->out_index, &mosq->out_message_mutex);
+	_mosquitto_message_retry_check_actual(mosq, &mosq->in_index, &mosq->in_message_mutex);
 #else
-	_mosquitto_message_retry_check_actual(mosq, mosq->out_messages);
-	_mosquitto_message_retry_check_actual(mosq, mosq->in_messages);
+	_mosquitto_message_retry_check_actual(mosq, &mosq->out_index);
+	_mosquitto_message_retry_check_actual(mosq, &mosq->in_index);
 #endif
+	_mosquitto_packet_batch_end(mosq);
 }
 
 void mosquitto_message_retry_set(struct mosquitto *mosq, unsigned int message_retry)
@@ -405,22 +586,27 @@ void mosquitto_message_retry_set(struct mosquitto *mosq, unsigned int message_re
 
 int _mosquitto_message_out_update(struct mosquitto *mosq, uint16_t mid, enum mosquitto_msg_state state)
 {
+	struct mosquitto_message_index *index = &mosq->out_index;
 	struct mosquitto_message_all *message;
 	assert(mosq);
 
 	pthread_mutex_lock(&mosq->out_message_mutex);
-	message = mosq->out_messages;
-	while (message) {
-		if (message->msg.mid == mid) {
-			message->state = state;
-			message->timestamp = mosquitto_time();
-			pthread_mutex_unlock(&mosq->out_message_mutex);
-			return MOSQ_ERR_SUCCESS;
-		}
-		message = message->next;
+	message = _mosquitto_message_find(index, mosq->out_messages, mid);
+	if (!message) {
+		pthread_mutex_unlock(&mosq->out_message_mutex);
+		return MOSQ_ERR_NOT_FOUND;
 	}
+
+	_mosquitto_message_rqueue_remove(index, message, mosq_md_out);
+	if (message->state == mosq_ms_invalid) {
+		/* The peer has got it, so it is inflight now */
+		mosq->inflight_messages++;
+	}
+	message->state = state;
+	message->timestamp = mosquitto_time();
+	_mosquitto_message_retry_append(index, message);
 	pthread_mutex_unlock(&mosq->out_message_mutex);
-	return MOSQ_ERR_NOT_FOUND;
+	return MOSQ_ERR_SUCCESS;
 }
 
 int mosquitto_max_inflight_messages_set(struct mosquitto *mosq, unsigned int max_inflight_messages)
@@ -172,6 +172,10 @@ struct _mosquitto_packet {
 
 struct mosquitto_message_all {
 	struct mosquitto_message_all *next;
+	struct mosquitto_message_all *prev;
+	struct mosquitto_message_all *hnext;	/* next message in the same message id bucket */
+	struct mosquitto_message_all *rnext;	/* next message in the retry or the waiting queue */
+	struct mosquitto_message_all *rprev;
 	time_t timestamp;
 	//enum mosquitto_msg_direction direction;
 	enum mosquitto_msg_state state;
@@ -179,6 +183,20 @@ struct mosquitto_message_all {
 	struct mosquitto_message msg;
 };
 
+/* Lookup structures for the messages of one direction.  Every message is in
+ * the message id hash.  A message waiting for a free inflight slot is in the
+ * waiting queue, in publish order.  Any other message is in the retry queue,
+ * which is kept in timestamp order so that the retry check only has to look
+ * at its head. */
+struct mosquitto_message_index {
+	struct mosquitto_message_all **hash;
+	unsigned int hash_size;
+	struct mosquitto_message_all *retry;
+	struct mosquitto_message_all *retry_last;
+	struct mosquitto_message_all *waiting;
+	struct mosquitto_message_all *waiting_last;
+};
+
 struct mosquitto {
 	mosq_sock_t sock;
 #ifndef WITH_BROKER
@@ -289,6 +307,8 @@ struct mosquitto {
 	struct mosquitto_message_all *in_messages_last;
 	struct mosquitto_message_all *out_messages;
 	struct mosquitto_message_all *out_messages_last;
+	struct mosquitto_message_index in_index;
+	struct mosquitto_message_index out_index;
 	void (*on_connect)(struct mosquitto *, void *userdata, int rc);
 	void (*on_disconnect)(struct mosquitto *, void *userdata, int rc);
 	void (*on_publish)(struct mosquitto *, void *userdata, int mid);
@@ -307,6 +327,7 @@ struct mosquitto {
 	bool reconnect_exponential_backoff;
 	char threaded;
 	struct _mosquitto_packet *out_packet_last;
+	bool out_packet_batch;
 	int inflight_messages;
 	int max_inflight_messages;
 #	ifdef WITH_SRV
@@ -164,10 +164,41 @@ void _mosquitto_packet_cleanup(struct _mosquitto_packet *packet)
 	packet->pos = 0;
 }
 
+#ifndef WITH_BROKER
+/* Write the queued packets, or let the network thread do it */
+static int _mosquitto_packet_flush(struct mosquitto *mosq)
+{
+	char sockpair_data = 0;
+
+	/* Write a single byte to sockpairW (connected to sockpairR) to break out
+	 * of select() if in threaded mode. */
+	if (mosq->sockpairW != INVALID_SOCKET) {
+#ifndef WIN32
+		if (write(mosq->sockpairW, &sockpair_data, 1)) {
+		}
+#else
+#if defined(__TINYARA__)
+		if (send(mosq->sockpairW, &sockpair_data, 1, 0) == -1) {
+			_mosquitto_log_printf(mosq, MOSQ_LOG_ERR, "Error: send() fail in %s in _mosquitto_packet_queue");
+		}
+#else
+		send(mosq->sockpairW, &sockpair_data, 1, 0);
+#endif
+#endif
+	}
+
+	if (mosq->in_callback == false && mosq->threaded == mosq_ts_none) {
+		return _mosquitto_packet_write(mosq);
+	} else {
+		return MOSQ_ERR_SUCCESS;
+	}
+}
+#endif
+
 int _mosquitto_packet_queue(struct mosquitto *mosq, struct _mosquitto_packet *packet)
 {
 #ifndef WITH_BROKER
-	char sockpair_data = 0;
+	bool batch;
 #endif
 	assert(mosq);
 	assert(packet);
@@ -183,6 +214,9 @@ int _mosquitto_packet_queue(struct mosquitto *mosq, struct _mosquitto_packet *pa
 		mosq->out_packet = packet;
 	}
 	mosq->out_packet_last = packet;
+#ifndef WITH_BROKER
+	batch = mosq->out_packet_batch;
+#endif
 	pthread_mutex_unlock(&mosq->out_packet_mutex);
 #ifdef WITH_BROKER
 #ifdef WITH_WEBSOCKETS
@@ -196,31 +230,44 @@ int _mosquitto_packet_queue(struct mosquitto *mosq, struct _mosquitto_packet *pa
 	return _mosquitto_packet_write(mosq);
 #endif
 #else
-
-	/* Write a single byte to sockpairW (connected to sockpairR) to break out
-	 * of select() if in threaded mode. */
-	if (mosq->sockpairW != INVALID_SOCKET) {
-#ifndef WIN32
-		if (write(mosq->sockpairW, &sockpair_data, 1)) {
-		}
-#else
-#if defined(__TINYARA__)
-		if (send(mosq->sockpairW, &sockpair_data, 1, 0) == -1) {
-			_mosquitto_log_printf(mosq, MOSQ_LOG_ERR, "Error: send() fail in %s in _mosquitto_packet_queue");
-		}
-#else
-		send(mosq->sockpairW, &sockpair_data, 1, 0);
-#endif
-#endif
+	if (batch) {
+		/* Written by _mosquitto_packet_batch_end() */
+		return MOSQ_ERR_SUCCESS;
 	}
+	return _mosquitto_packet_flush(mosq);
+#endif
+}
 
-	if (mosq->in_callback == false && mosq->threaded == mosq_ts_none) {
-		return _mosquitto_packet_write(mosq);
-	} else {
+#ifndef WITH_BROKER
+/* Packets queued between _mosquitto_packet_batch_begin() and
+ * _mosquitto_packet_batch_end() are written together at the end, instead of
+ * one write and one wakeup of the network thread per packet. */
+void _mosquitto_packet_batch_begin(struct mosquitto *mosq)
+{
+	assert(mosq);
+
+	pthread_mutex_lock(&mosq->out_packet_mutex);
+	mosq->out_packet_batch = true;
+	pthread_mutex_unlock(&mosq->out_packet_mutex);
+}
+
+int _mosquitto_packet_batch_end(struct mosquitto *mosq)
+{
+	bool queued;
+
+	assert(mosq);
+
+	pthread_mutex_lock(&mosq->out_packet_mutex);
+	mosq->out_packet_batch = false;
+	queued = (mosq->out_packet != NULL);
+	pthread_mutex_unlock(&mosq->out_packet_mutex);
+
+	if (!queued) {
 		return MOSQ_ERR_SUCCESS;
 	}
-#endif
+	return _mosquitto_packet_flush(mosq);
 }
+#endif
 
 /* Close a socket associated with a context and set it to -1.
  * Returns 1 on failure (context is NULL)
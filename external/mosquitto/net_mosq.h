@@ -71,6 +71,10 @@ void _mosquitto_net_cleanup(void);
 
 void _mosquitto_packet_cleanup(struct _mosquitto_packet *packet);
 int _mosquitto_packet_queue(struct mosquitto *mosq, struct _mosquitto_packet *packet);
+#ifndef WITH_BROKER
+void _mosquitto_packet_batch_begin(struct mosquitto *mosq);
+int _mosquitto_packet_batch_end(struct mosquitto *mosq);
+#endif
 int _mosquitto_socket_connect(struct mosquitto *mosq, const char *host, uint16_t port, const char *bind_address, bool blocking);
 #ifdef WITH_BROKER
 int _mosquitto_socket_close(struct mosquitto_db *db, struct mosquitto *mosq);
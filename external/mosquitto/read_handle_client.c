@@ -36,6 +36,7 @@ Contributors:
 #include <mosquitto.h>
 #include <logging_mosq.h>
 #include <memory_mosq.h>
+#include <messages_mosq.h>
 #include <net_mosq.h>
 #include <read_handle.h>
 
@@ -67,6 +68,8 @@ int _mosquitto_handle_connack(struct mosquitto *mosq)
 		if (mosq->state != mosq_cs_disconnecting) {
 			mosq->state = mosq_cs_connected;
 		}
+		/* Replay the messages that were inflight before the reconnect */
+		_mosquitto_message_retry_check(mosq);
 		return MOSQ_ERR_SUCCESS;
 	case 1:
 	case 2:
@@ -19,8 +19,6 @@
 #ifndef __http_h__
 #define __http_h__
 
-#include <mqueue.h>
-
 #ifdef CONFIG_ENDIAN_BIG
 #define HTTP_HTONS(ns) (ns)
 #define HTTP_HTONL(nl) (nl)
@@ -33,18 +31,4 @@
 					((((unsigned long)(nl)) & 0xff000000UL) >> 24))
 #endif
 
-typedef enum {
-	HTTP_ERROR_EVENT,
-	HTTP_CONNECT_EVENT,
-	HTTP_STOP_EVENT,
-} http_server_event_t;
-
-struct http_msg_t {
-	http_server_event_t event;
-	int data;
-};
-
-int http_server_mq_flush(mqd_t msg_q);
-mqd_t http_server_mq_open(int port);
-int http_server_mq_close(int port);
 #endif
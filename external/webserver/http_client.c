@@ -17,6 +17,11 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <errno.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include <tinyara/clock.h>
 #include <protocols/webserver/http_err.h>
 #include <protocols/webserver/http_keyvalue_list.h>
 #include <protocols/webclient.h>
@@ -31,85 +36,185 @@
 #include "http_arch.h"
 #include "http_log.h"
 
-#define MIN_WS_HEADER_FIELD 2
+/* Period to check the server state while the connections are idle */
+#define HTTP_HANDLER_POLL_MSEC  100
 
-pthread_addr_t http_handle_client(pthread_addr_t arg)
+/* Room for the size line of a chunk: up to 8 hex digits and CRLF */
+#define HTTP_CHUNK_HEADER_LEN   10
+
+static struct http_client_t *http_accept_connection(struct http_server_t *server)
 {
-	struct http_server_t *server = (struct http_server_t *)arg;
-	struct http_msg_t msg;
-	int result;
-	struct http_keyvalue_list_t request_params;
-	int sock_fd;
-	struct mallinfo data;
 	struct http_client_t *p;
-	mqd_t msg_q;
-	struct mq_attr mqattr;
+	struct sockaddr_in client_addr;
+	socklen_t addrlen = sizeof(struct sockaddr_in);
+	struct timeval tv;
+	struct mallinfo data;
+	int sock_fd;
 
-	if ((msg_q = http_server_mq_open(server->port)) == NULL) {
-		HTTP_LOGE("msg queue open fail in http_handle_client\n");
+	sock_fd = accept(server->listen_fd, (struct sockaddr *)&client_addr, &addrlen);
+	if (sock_fd < 0) {
+		/* Another client handler took the connection */
+		if (errno != EWOULDBLOCK && errno != EAGAIN) {
+			HTTP_LOGE("Error: Accept client error!!\n");
+		}
 		return NULL;
 	}
 
-	mq_getattr(msg_q, &mqattr);
+	tv.tv_sec = HTTP_CONF_SOCKET_TIMEOUT_MSEC / 1000;
+	tv.tv_usec = (HTTP_CONF_SOCKET_TIMEOUT_MSEC % 1000) * 1000;
+	HTTP_LOGD("Set timeout to socket (%d.%d)sec\n", tv.tv_sec, tv.tv_usec);
+	if (setsockopt(sock_fd, SOL_SOCKET, SO_RCVTIMEO,
+				   (struct timeval *)&tv, sizeof(struct timeval)) < 0) {
+		HTTP_LOGE("Error: Fail to setsockopt\n");
+	}
 
-	while (1) {
-		if (mq_receive(msg_q, (char *)&msg, mqattr.mq_msgsize, NULL) < 0) {
-			return NULL;
-		}
+	HTTP_LOGD("Client %d is accepted ipaddr: %d.%d.%d.%d\n", sock_fd,
+			  (int)((client_addr.sin_addr.s_addr & 0xFF)),
+			  (int)((client_addr.sin_addr.s_addr & 0xFF00) >> 8),
+			  (int)((client_addr.sin_addr.s_addr & 0xFF0000) >> 16),
+			  (int)((client_addr.sin_addr.s_addr & 0xFF000000) >> 24));
 
-		sock_fd = msg.data;
+	data = mallinfo();
 
-		if (msg.event == HTTP_STOP_EVENT) {
-			close(sock_fd);
-			break;
-		}
+	if (data.fordblks < HTTP_CONF_MIN_TLS_MEMORY * HTTP_CONF_MAX_CLIENT_HANDLE) {
+		HTTP_LOGE("Error: Not enough memory :: %d\n", data.fordblks);
+		close(sock_fd);
+		return NULL;
+	}
 
-		data = mallinfo();
+	HTTP_LOGD("Free Mem %d\n", data.fordblks);
 
-		if (data.fordblks < HTTP_CONF_MIN_TLS_MEMORY * HTTP_CONF_MAX_CLIENT_HANDLE) {
-			HTTP_LOGE("Error: Not enough memory :: %d\n", data.fordblks);
-			close(sock_fd);
-			continue;
+	p = http_client_init(server, sock_fd);
+	if (p == NULL) {
+		HTTP_LOGE("Error: Cannot init client!!\n");
+		close(sock_fd);
+		return NULL;
+	}
+	p->client_ip = client_addr.sin_addr.s_addr;
 
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (server->tls_init) {
+		if (http_client_tls_init(p) != HTTP_OK) {
+			HTTP_LOGE("Error: Cannot initialize TLS!! Close client.. %d\n", sock_fd);
+			http_close_client(p);
+			return NULL;
 		}
+	}
+#endif
 
-		HTTP_LOGD("Free Mem %d\n", data.fordblks);
+	return p;
+}
 
-		p = http_client_init(server, sock_fd);
+pthread_addr_t http_handle_client(pthread_addr_t arg)
+{
+	struct http_server_t *server = (struct http_server_t *)arg;
+	struct http_client_t *conn[HTTP_CONF_MAX_HANDLER_CONNECTIONS] = { NULL, };
+	struct http_client_t *p;
+	struct timeval tv;
+	fd_set readfds;
+	clock_t now;
+	clock_t idle_limit;
+	int nconn = 0;
+	int maxfd;
+	int ready;
+	int result;
+	int i;
+
+	/*
+	 * Each client handler waits for new connections and for requests on
+	 * its own connections in one select(), so a connection stays with the
+	 * handler which accepted it until it is closed.
+	 */
+	while (server->state == HTTP_SERVER_RUN) {
+		FD_ZERO(&readfds);
+		maxfd = -1;
+		tv.tv_sec = HTTP_HANDLER_POLL_MSEC / 1000;
+		tv.tv_usec = (HTTP_HANDLER_POLL_MSEC % 1000) * 1000;
+
+		/* Take new connections only while there is room for them */
+		if (nconn < HTTP_CONF_MAX_HANDLER_CONNECTIONS) {
+			FD_SET(server->listen_fd, &readfds);
+			maxfd = server->listen_fd;
+		}
 
-		if (p == NULL) {
-			HTTP_LOGE("Error: Cannot init client!!\n");
-			close(sock_fd);
+		for (i = 0; i < HTTP_CONF_MAX_HANDLER_CONNECTIONS; i++) {
+			if (conn[i] == NULL) {
+				continue;
+			}
+			/* Buffered requests do not make the socket readable */
+			if (http_client_pending(conn[i])) {
+				tv.tv_sec = 0;
+				tv.tv_usec = 0;
+			}
+			FD_SET(conn[i]->client_fd, &readfds);
+			if (conn[i]->client_fd > maxfd) {
+				maxfd = conn[i]->client_fd;
+			}
+		}
+
+		ready = select(maxfd + 1, &readfds, NULL, NULL, &tv);
+		if (ready < 0) {
+			if (errno != EINTR) {
+				HTTP_LOGE("Error: select fail %d\n", errno);
+				usleep(HTTP_HANDLER_POLL_MSEC * 1000);
+			}
 			continue;
 		}
 
-		HTTP_LOGD("Client %d.\n", p->client_fd);
+		now = clock_systimer();
 
-#ifdef CONFIG_NET_SECURITY_TLS
-		if (server->tls_init) {
-			if (http_client_tls_init(p) != HTTP_OK) {
-				HTTP_LOGE("Error: Cannot initialize TLS!! Close client.. %d\n", sock_fd);
-				http_client_release(p);
-				continue;
+		if (ready > 0 && FD_ISSET(server->listen_fd, &readfds)) {
+			p = http_accept_connection(server);
+			if (p != NULL) {
+				for (i = 0; conn[i] != NULL; i++) {
+					/* Find an empty slot, there is one */
+				}
+				p->idle_since = now;
+				conn[i] = p;
+				nconn++;
 			}
 		}
-#endif
-		http_keyvalue_list_init(&request_params);
-		result = http_recv_and_handle_request(p, &request_params);
-		http_keyvalue_list_release(&request_params);
 
-		if (result != HTTP_OK) {
-			HTTP_LOGD("Client %d  in error case.\n", sock_fd);
-		} else {
-			HTTP_LOGD("Client %d  in normal case.\n", sock_fd);
+		for (i = 0; i < HTTP_CONF_MAX_HANDLER_CONNECTIONS; i++) {
+			p = conn[i];
+			if (p == NULL) {
+				continue;
+			}
+
+			if ((ready > 0 && FD_ISSET(p->client_fd, &readfds)) || http_client_pending(p)) {
+				result = http_recv_and_handle_request(p);
+				p->idle_since = now;
+				if (result == HTTP_OK && p->ws_state < MIN_WS_HEADER_FIELD) {
+					continue;
+				}
+				if (result == HTTP_OK) {
+					/* The connection belongs to the websocket now */
+					http_client_release(p);
+				} else {
+					http_close_client(p);
+				}
+			} else {
+				/* The first request may take as long as a receive */
+				idle_limit = MSEC2TICK(p->nrequests > 0 ? HTTP_CONF_KEEPALIVE_TIMEOUT_MSEC : HTTP_CONF_SOCKET_TIMEOUT_MSEC);
+				if (now - p->idle_since < idle_limit) {
+					continue;
+				}
+				HTTP_LOGD("Client %d is idle, close\n", p->client_fd);
+				http_close_client(p);
+			}
+			conn[i] = NULL;
+			nconn--;
 		}
-		http_client_release(p);
-		HTTP_LOGD("Release client....\n");
 	}
 
-	mq_close(msg_q);
+	for (i = 0; i < HTTP_CONF_MAX_HANDLER_CONNECTIONS; i++) {
+		if (conn[i] != NULL) {
+			http_close_client(conn[i]);
+		}
+	}
 
 	HTTP_LOGD("Closed client handle %d\n", getpid());
+	sem_post(&server->sem_thread_sync);
 	return NULL;
 }
 
@@ -123,6 +228,13 @@ struct http_client_t *http_client_init(struct http_server_t *server, int sock_fd
 
 	memset(p, 0, sizeof(struct http_client_t));
 
+	/* One more byte to terminate the entity of a request */
+	p->buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH + 1);
+	if (p->buf == NULL) {
+		HTTP_FREE(p);
+		return NULL;
+	}
+
 	p->client_fd = sock_fd;
 	p->server = server;
 
@@ -136,6 +248,7 @@ int http_client_release(struct http_client_t *client)
 		http_client_tls_release(client);
 	}
 #endif
+	HTTP_FREE(client->buf);
 	HTTP_FREE(client);
 	HTTP_LOGD("Free Client\n");
 	return HTTP_OK;
@@ -186,6 +299,8 @@ int http_parse_message(char *buf, int buf_len, int *method, char *url,
 						(*method == HTTP_METHOD_DELETE) ?
 						"DELETE" : "UNKNOWN");
 					req->method = *method;
+					/* HTTP/1.1 connections are persistent unless told otherwise */
+					client->keep_alive = (protocol == HTTP_HTTP_VERSION_11);
 					HTTP_LOGD("Request URI : %s\n", url);
 					HTTP_LOGD("Request Protocol : ");
 					if (protocol == HTTP_HTTP_VERSION_09) {
@@ -234,14 +349,21 @@ int http_parse_message(char *buf, int buf_len, int *method, char *url,
 						if (strcmp(key, "Sec-WebSocket-Key") == 0) {
 							strncpy((char *)client->ws_key, value, WEBSOCKET_CLIENT_KEY_LEN);
 						}
+						if (strcasecmp(key, "Connection") == 0) {
+							if (strcasecmp(value, "close") == 0) {
+								client->keep_alive = false;
+							} else if (strcasecmp(value, "keep-alive") == 0) {
+								client->keep_alive = true;
+							}
+						}
 					}
-					if (strcmp(key, "Content-Length") == 0) {
+					if (strcasecmp(key, "Content-Length") == 0) {
 						len->content_len = HTTP_ATOI(value);
 						response->total_len = len->content_len;
 
 						HTTP_LOGD("This request contains contents, length : %d\n", len->content_len);
 					}
-					if (strcmp(key, "Transfer-Encoding") == 0 && strcmp(value, "chunked") == 0) {
+					if (strcasecmp(key, "Transfer-Encoding") == 0 && strcmp(value, "chunked") == 0) {
 						if (client) {
 							len->chunked_remain = 0;
 							len->entity_len = 0;
@@ -436,132 +558,272 @@ int http_parse_message(char *buf, int buf_len, int *method, char *url,
 	return read_finish;
 }
 
-int http_recv_and_handle_request(struct http_client_t *client, struct http_keyvalue_list_t *request_params)
+/*
+ * Returns the length of the first request in buf once it is complete, 0 if
+ * more data is needed or HTTP_ERROR if the request can not be framed.
+ */
+static int http_request_length(const char *buf, int len)
 {
-	char *buf;
-	int len = 0;
+	const char *value;
+	int content_len = 0;
+	int chunked = false;
+	int start = 0;
+	int end;
+	long chunk;
+
+	/* Request line and header fields up to the empty line */
+	while ((end = http_find_first_crlf(buf, len, start)) != start) {
+		if (end < 0) {
+			return 0;
+		}
+		if (strncasecmp(buf + start, "Content-Length:", 15) == 0) {
+			content_len = HTTP_ATOI(buf + start + 15);
+		} else if (strncasecmp(buf + start, "Transfer-Encoding:", 18) == 0) {
+			for (value = buf + start + 18; *value == ' '; value++) {
+			}
+			chunked = (strncasecmp(value, "chunked", 7) == 0);
+		}
+		start = end + 2;
+	}
+	start += 2;
+
+	if (!chunked) {
+		if (content_len < 0 || start + content_len > HTTP_CONF_MAX_REQUEST_LENGTH) {
+			return HTTP_ERROR;
+		}
+		return (start + content_len <= len) ? start + content_len : 0;
+	}
+
+	/* Chunks up to the last one of size zero */
+	do {
+		end = http_find_first_crlf(buf, len, start);
+		if (end < 0) {
+			return 0;
+		}
+		chunk = strtol(buf + start, NULL, 16);
+		if (chunk < 0 || chunk > HTTP_CONF_MAX_REQUEST_LENGTH) {
+			return HTTP_ERROR;
+		}
+		start = end + 2;
+		if (chunk > 0) {
+			start += chunk + 2;
+		}
+	} while (chunk > 0);
+
+	/* Trailer fields up to the empty line */
+	while ((end = http_find_first_crlf(buf, len, start)) != start) {
+		if (end < 0) {
+			return 0;
+		}
+		start = end + 2;
+	}
+
+	return end + 2;
+}
+
+/* Whether the connection stays open after the current response */
+static int http_client_keep_alive(struct http_client_t *client)
+{
+	if (client->nrequests >= HTTP_CONF_KEEPALIVE_MAX_REQUESTS || client->server->state != HTTP_SERVER_RUN) {
+		client->keep_alive = false;
+	}
+	return client->keep_alive;
+}
+
+int http_client_pending(struct http_client_t *client)
+{
+#ifdef CONFIG_NET_SECURITY_TLS
+	/* Decrypted data waiting in the TLS context */
+	if (client->server->tls_init && mbedtls_ssl_get_bytes_avail(&(client->tls_ssl)) > 0) {
+		return true;
+	}
+#endif
+	return client->buf_len > 0 && http_request_length(client->buf, client->buf_len) != 0;
+}
+
+#ifdef CONFIG_NETUTILS_WEBSOCKET
+static int http_start_websocket(struct http_client_t *client)
+{
+	websocket_t *ws = NULL;
+
+	ws = websocket_find_table();
+	if (ws == NULL) {
+		return HTTP_ERROR;
+	}
+	ws->fd = client->client_fd;
+	ws->cb = &client->server->ws_cb;
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (client->server->tls_init) {
+		ws->tls_enabled = 1;
+		ws->tls_net.fd = client->tls_client_fd.fd;
+		ws->tls_ssl = (mbedtls_ssl_context *)malloc(sizeof(mbedtls_ssl_context));
+		memcpy(ws->tls_ssl, &client->tls_ssl, sizeof(mbedtls_ssl_context));
+		ws->tls_conf = &client->server->tls_conf;
+		mbedtls_ssl_set_bio(ws->tls_ssl, &ws->tls_net, mbedtls_net_send, mbedtls_net_recv, NULL);
+	}
+#endif
+	if (pthread_attr_init(&ws->thread_attr) != 0) {
+		HTTP_LOGE("Error: Cannot initialize thread attribute\n");
+		return HTTP_ERROR;
+	}
+	pthread_attr_setstacksize(&ws->thread_attr, WEBSOCKET_STACKSIZE);
+	pthread_attr_setschedpolicy(&ws->thread_attr, SCHED_RR);
+	if (pthread_create(&ws->thread_id, &ws->thread_attr,
+					   (pthread_startroutine_t)websocket_server_init,
+					   (pthread_addr_t)ws) != 0) {
+		HTTP_LOGE("Error: Cannot create websocket thread!!\n");
+		return HTTP_ERROR;
+	}
+	pthread_setname_np(ws->thread_id, "websocket handle server");
+	pthread_detach(ws->thread_id);
+
+	return HTTP_OK;
+}
+#endif
+
+/* Parse and dispatch the complete request of req_len bytes at the start of the buffer */
+static int http_handle_request(struct http_client_t *client, int req_len)
+{
+	char *buf = client->buf;
 	char *body = NULL;
-	int read_finish = false;
+	char saved;
+	int read_finish;
+	int result = HTTP_ERROR;
 
 	int method = HTTP_METHOD_UNKNOWN;
 	char url[HTTP_CONF_MAX_REQUEST_HEADER_URL_LENGTH] = { 0, };
-	int buf_len = 0;
-	int remain = HTTP_CONF_MAX_REQUEST_LENGTH;
 	int enc = HTTP_CONTENT_LENGTH;
 	struct http_req_message req = {0, };
 	int state = HTTP_REQUEST_HEADER;
 	struct http_message_len_t mlen = {0,};
-	struct sockaddr_in addr;
-	socklen_t addr_len;
+	struct http_keyvalue_list_t request_params;
+	/* Only filled for the webclient, the parser needs it anyway */
+	struct http_client_response_t response = {0, };
 
 	client->ws_state = 0;
+	client->keep_alive = false;
+	client->nrequests++;
 
-	buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH);
-	if (buf == NULL) {
-		HTTP_LOGE("Error: Fail to malloc buf\n");
-		close(client->client_fd);
+	if (http_keyvalue_list_init(&request_params) != HTTP_OK) {
+		HTTP_LOGE("Error: Fail to init request params\n");
+		http_keyvalue_list_release(&request_params);
 		return HTTP_ERROR;
 	}
 
-	if (getpeername(client->client_fd, (struct sockaddr *)&addr, &addr_len) < 0) {
-		HTTP_LOGE("Error: Fail to getpeername\n");
-		goto errout;
-	}
 	req.req_msg = buf;
 	req.url = url;
-	req.headers = request_params;
-	req.client_ip = addr.sin_addr.s_addr;
+	req.headers = &request_params;
+	req.client_ip = client->client_ip;
 	req.encoding = HTTP_CONTENT_LENGTH;
 
-	while (!read_finish) {
-		if (remain <= 0) {
-			HTTP_LOGE("Error: Request size is too large!!\n");
-			goto errout;
+	/* The entity is terminated in place, on the first byte of the next request */
+	saved = buf[req_len];
+
+	read_finish = http_parse_message(buf, req_len, &method, url, &body, &enc, &state, &mlen, &request_params, client, &response, &req);
+	if (read_finish != true || method == HTTP_METHOD_UNKNOWN) {
+		HTTP_LOGE("Error: Fail to parse request\n");
+		goto errout;
+	}
+
+	if (enc == HTTP_CONTENT_LENGTH) {
+		req.entity = body;
+		http_dispatch_url(client, &req);
+	}
+
+	result = HTTP_OK;
+
+#ifdef CONFIG_NETUTILS_WEBSOCKET
+	/* open websocket */
+	if (client->ws_state >= MIN_WS_HEADER_FIELD) {
+		if (http_start_websocket(client) != HTTP_OK) {
+			/* The connection stays with the client handler and is closed there */
+			client->ws_state = 0;
+			result = HTTP_ERROR;
 		}
+	}
+#endif
+
+errout:
+	buf[req_len] = saved;
+	if (enc == HTTP_CHUNKED_ENCODING) {
+		HTTP_FREE(body);
+	}
+	http_keyvalue_list_release(&request_params);
+	return result;
+}
+
+/*
+ * Receive from the client and handle the complete requests in its buffer.
+ * Returns HTTP_OK while the connection stays open or when it was handed over
+ * to a websocket, HTTP_ERROR when the connection has to be closed.
+ */
+int http_recv_and_handle_request(struct http_client_t *client)
+{
+	int len;
+	int req_len;
+	int skip;
+
+	if (http_request_length(client->buf, client->buf_len) == 0) {
 #ifdef CONFIG_NET_SECURITY_TLS
 		if (client->server->tls_init) {
-			len = mbedtls_ssl_read(&(client->tls_ssl), (unsigned char *)buf + buf_len, HTTP_CONF_MAX_REQUEST_LENGTH - buf_len);
+			len = mbedtls_ssl_read(&(client->tls_ssl), (unsigned char *)client->buf + client->buf_len, HTTP_CONF_MAX_REQUEST_LENGTH - client->buf_len);
 		} else
 #endif
 		{
-			len = recv(client->client_fd, buf + buf_len, HTTP_CONF_MAX_REQUEST_LENGTH - buf_len, 0);
+			len = recv(client->client_fd, client->buf + client->buf_len, HTTP_CONF_MAX_REQUEST_LENGTH - client->buf_len, 0);
 		}
 		if (len < 0) {
 			HTTP_LOGE("Error: Receive Fail %d\n", len);
-			goto errout;
+			return HTTP_ERROR;
 		} else if (len == 0) {
 			HTTP_LOGD("Finish read\n");
-			goto errout;
+			return HTTP_ERROR;
 		}
-		buf_len += len;
-		remain -= len;
+		client->buf_len += len;
+	}
 
-		read_finish = http_parse_message(buf, len, &method, url, &body, &enc, &state, &mlen, request_params, client, NULL, &req);
-		if (read_finish == HTTP_ERROR) {
-			goto errout;
+	/* Pipelined requests are handled in order of arrival */
+	while (client->buf_len > 0) {
+		/* Empty lines in front of a request are ignored */
+		for (skip = 0; skip + 1 < client->buf_len && client->buf[skip] == '\r' && client->buf[skip + 1] == '\n'; skip += 2) {
 		}
-	}
-	if (method == HTTP_METHOD_UNKNOWN) {
-		goto errout;
-	}
 
-	if (enc == HTTP_CONTENT_LENGTH) {
-		req.entity = body;
-		http_dispatch_url(client, &req);
-	}
+		req_len = http_request_length(client->buf + skip, client->buf_len - skip);
+		if (req_len < 0) {
+			HTTP_LOGE("Error: Cannot frame request\n");
+			return HTTP_ERROR;
+		}
 
-#ifdef CONFIG_NETUTILS_WEBSOCKET
-	/* open websocket */
-	if (client->ws_state >= MIN_WS_HEADER_FIELD) {
-		websocket_t *ws = NULL;
-		ws = websocket_find_table();
-		if (ws == NULL) {
-			goto errout;
+		client->buf_len -= skip;
+		memmove(client->buf, client->buf + skip, client->buf_len);
+
+		if (req_len == 0) {
+			break;
 		}
-		ws->fd = client->client_fd;
-		ws->cb = &client->server->ws_cb;
-#ifdef CONFIG_NET_SECURITY_TLS
-		if (client->server->tls_init) {
-			ws->tls_enabled = 1;
-			ws->tls_net.fd = client->tls_client_fd.fd;
-			ws->tls_ssl = (mbedtls_ssl_context *)malloc(sizeof(mbedtls_ssl_context));
-			memcpy(ws->tls_ssl, &client->tls_ssl, sizeof(mbedtls_ssl_context));
-			ws->tls_conf = &client->server->tls_conf;
-			mbedtls_ssl_set_bio(ws->tls_ssl, &ws->tls_net, mbedtls_net_send, mbedtls_net_recv, NULL);
+
+		if (http_handle_request(client, req_len) != HTTP_OK) {
+			return HTTP_ERROR;
 		}
-#endif
-		if (pthread_attr_init(&ws->thread_attr) != 0) {
-			HTTP_LOGE("Error: Cannot initialize thread attribute\n");
-			goto errout;
+
+		client->buf_len -= req_len;
+		memmove(client->buf, client->buf + req_len, client->buf_len);
+
+		if (client->ws_state >= MIN_WS_HEADER_FIELD) {
+			return HTTP_OK;
 		}
-		pthread_attr_setstacksize(&ws->thread_attr, WEBSOCKET_STACKSIZE);
-		pthread_attr_setschedpolicy(&ws->thread_attr, SCHED_RR);
-		if (pthread_create(&ws->thread_id, &ws->thread_attr,
-						   (pthread_startroutine_t)websocket_server_init,
-						   (pthread_addr_t)ws) != 0) {
-			HTTP_LOGE("Error: Cannot create websocket thread!!\n");
-			goto errout;
+
+		if (!http_client_keep_alive(client)) {
+			HTTP_LOGD("Client %d is not kept alive\n", client->client_fd);
+			return HTTP_ERROR;
 		}
-		pthread_setname_np(ws->thread_id, "websocket handle server");
-		pthread_detach(ws->thread_id);
-	} else
-#endif
-	{
-		close(client->client_fd);
 	}
 
-	HTTP_FREE(buf);
-	if (enc == HTTP_CHUNKED_ENCODING) {
-		HTTP_FREE(body);
+	if (client->buf_len >= HTTP_CONF_MAX_REQUEST_LENGTH) {
+		HTTP_LOGE("Error: Request size is too large!!\n");
+		return HTTP_ERROR;
 	}
+
 	return HTTP_OK;
-errout:
-	close(client->client_fd);
-	HTTP_FREE(buf);
-	if (enc == HTTP_CHUNKED_ENCODING) {
-		HTTP_FREE(body);
-	}
-	return HTTP_ERROR;
 }
 
 void http_handle_file(struct http_client_t *client, int method, const char *url, char *entity)
@@ -573,16 +835,8 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 
 	switch (method) {
 	case HTTP_METHOD_GET:
-		if ((f = fopen(url, "r")) != NULL) {
-			fgets(entity, HTTP_CONF_MAX_ENTITY_LENGTH, f);
-			if (http_send_response(client, 200, entity, NULL) == HTTP_ERROR) {
-				HTTP_LOGE("Error: Fail to send response\n");
-			}
-			fclose(f);
-		} else {
-			if (http_send_response(client, 404, HTTP_ERROR_404, NULL) == HTTP_ERROR) {
-				HTTP_LOGE("Error: Fail to send response\n");
-			}
+		if (http_send_file(client, url) == HTTP_ERROR) {
+			HTTP_LOGE("Error: Fail to send file\n");
 		}
 		break;
 	case HTTP_METHOD_POST:
@@ -658,10 +912,39 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 	}
 }
 
+static int http_client_send(struct http_client_t *client, const char *data, int len)
+{
+	int ret;
+
+	while (len > 0) {
+#ifdef CONFIG_NET_SECURITY_TLS
+		if (client->server->tls_init) {
+			ret = mbedtls_ssl_write(&(client->tls_ssl), (const unsigned char *)data, len);
+		} else
+#endif
+		{
+			ret = send(client->client_fd, data, len, 0);
+		}
+
+		if (ret < 1) {
+			/* A part of the response is lost, the connection can not be reused */
+			client->keep_alive = false;
+			return HTTP_ERROR;
+		}
+		data += ret;
+		len -= ret;
+	}
+
+	return HTTP_OK;
+}
+
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers)
 {
 	char *buf;
-	int buflen = 0, ret, sndlen;
+	int buflen = 0, ret;
+	int bodylen = 0;
+	int framed = false;
+	int connection = false;
 	struct http_keyvalue_t *cur = NULL;
 
 	buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH);
@@ -686,57 +969,170 @@ int http_send_response(struct http_client_t *client, int status, const char *bod
 						  status, (status == 200) ? "OK" : body);
 		if (headers) {
 			cur = headers->head->next;
-			while (cur != headers->tail) {
+			while (cur != headers->tail && buflen < HTTP_CONF_MAX_REQUEST_LENGTH) {
+				if (strcasecmp(cur->key, "Content-Length") == 0 || strcasecmp(cur->key, "Transfer-Encoding") == 0) {
+					framed = true;
+				} else if (strcasecmp(cur->key, "Connection") == 0) {
+					connection = true;
+					if (strcasecmp(cur->value, "close") == 0) {
+						client->keep_alive = false;
+					}
+				}
 				buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
 								   "%s: %s\r\n", cur->key, cur->value);
 				cur = cur->next;
 			}
 		}
 
-		if (status == 200) {
-			if (headers == NULL) {
-				buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
-								   "Content-type: text/html\r\n"
-								   "Connection: close\r\n");
-				if (body) {
-					buflen += snprintf(buf + buflen,
-									   HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
-									   "Content-Length: %d\r\n"
-									   "\r\n"
-									   "%s",
-									   strlen(body), body);
-				} else {
-					buflen += snprintf(buf + buflen,
-									   HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
-									   "\r\n");
-				}
-			} else {
-				snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
-						 "\r\n%s", body);
-			}
+		/* Leave room for the header fields below */
+		if (buflen > HTTP_CONF_MAX_REQUEST_LENGTH - HTTP_CONF_MAX_KEY_LENGTH * 4) {
+			HTTP_LOGE("Error: Response header is too large\n");
+			HTTP_FREE(buf);
+			return HTTP_ERROR;
+		}
+
+		if (status == 200 && body) {
+			bodylen = strlen(body);
 		}
+
+		if (status == 200 && headers == NULL) {
+			buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
+							   "Content-type: text/html\r\n");
+		}
+
+		/* The length delimits the response on a persistent connection */
+		if (!framed) {
+			buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
+							   "Content-Length: %d\r\n", bodylen);
+		}
+		if (!connection) {
+			buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen,
+							   "Connection: %s\r\n", http_client_keep_alive(client) ? "keep-alive" : "close");
+		}
+		buflen += snprintf(buf + buflen, HTTP_CONF_MAX_REQUEST_LENGTH - buflen, "\r\n");
+
+		/* Small bodies go out with the header, large ones straight from the caller */
+		if (bodylen > 0 && buflen + bodylen <= HTTP_CONF_MAX_REQUEST_LENGTH) {
+			memcpy(buf + buflen, body, bodylen);
+			buflen += bodylen;
+			bodylen = 0;
+		}
+	}
+
+	ret = http_client_send(client, buf, buflen);
+	if (ret == HTTP_OK && bodylen > 0) {
+		ret = http_client_send(client, body, bodylen);
 	}
 
-	sndlen = strlen(buf);
-	buflen = 0;
-	while (sndlen > 0) {
+	HTTP_FREE(buf);
+	return ret;
+}
+
+int http_send_file(struct http_client_t *client, const char *path)
+{
+	char header[HTTP_CONF_MAX_REQUEST_LINE_LENGTH];
+	char size_line[HTTP_CHUNK_HEADER_LEN + 1];
+	struct stat st;
+	char *chunk = NULL;
+	char *data;
+	off_t offset = 0;
+	ssize_t nbytes;
+	int use_sendfile;
+	int chunked;
+	int len;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		HTTP_LOGD("Cannot open %s\n", path);
+		return http_send_response(client, 404, HTTP_ERROR_404, NULL);
+	}
+
+	/* Files of unknown size, e.g. in procfs, are sent with chunked encoding */
+	chunked = (fstat(fd, &st) < 0 || st.st_size <= 0);
+	use_sendfile = !chunked;
 #ifdef CONFIG_NET_SECURITY_TLS
-		if (client->server->tls_init) {
-			ret = mbedtls_ssl_write(&(client->tls_ssl), (unsigned char *)buf + buflen, sndlen);
-		} else
+	if (client->server->tls_init) {
+		use_sendfile = false;
+	}
 #endif
-		{
-			ret = send(client->client_fd, buf + buflen, sndlen, 0);
+
+	len = snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-type: text/html\r\n");
+	if (chunked) {
+		len += snprintf(header + len, sizeof(header) - len, "Transfer-Encoding: chunked\r\n");
+	} else {
+		len += snprintf(header + len, sizeof(header) - len, "Content-Length: %ld\r\n", (long)st.st_size);
+	}
+	len += snprintf(header + len, sizeof(header) - len, "Connection: %s\r\n\r\n",
+					http_client_keep_alive(client) ? "keep-alive" : "close");
+
+	if (http_client_send(client, header, len) != HTTP_OK) {
+		goto errout;
+	}
+
+	if (use_sendfile) {
+		/* The file goes from the file system to the socket without a user buffer */
+		while (offset < st.st_size) {
+			nbytes = sendfile(client->client_fd, fd, &offset, st.st_size - offset);
+			if (nbytes <= 0) {
+				HTTP_LOGE("Error: sendfile fail %d\n", errno);
+				goto errout;
+			}
 		}
+		close(fd);
+		return HTTP_OK;
+	}
 
-		if (ret < 1) {
-			HTTP_FREE(buf);
-			return HTTP_ERROR;
+	/* One buffer for the file, reused for every piece */
+	chunk = HTTP_MALLOC(HTTP_CHUNK_HEADER_LEN + HTTP_CONF_FILE_CHUNK_SIZE + 2);
+	if (chunk == NULL) {
+		HTTP_LOGE("Error: Fail to malloc buffer\n");
+		goto errout;
+	}
+	data = chunk + HTTP_CHUNK_HEADER_LEN;
+
+	while ((nbytes = read(fd, data, HTTP_CONF_FILE_CHUNK_SIZE)) > 0) {
+		if (chunked) {
+			/* The size line goes right in front of the data, CRLF behind it */
+			len = snprintf(size_line, sizeof(size_line), "%x\r\n", (unsigned int)nbytes);
+			memcpy(data - len, size_line, len);
+			data[nbytes] = '\r';
+			data[nbytes + 1] = '\n';
+			if (http_client_send(client, data - len, len + nbytes + 2) != HTTP_OK) {
+				goto errout;
+			}
 		} else {
-			sndlen -= ret;
-			buflen += ret;
+			if (http_client_send(client, data, nbytes) != HTTP_OK) {
+				goto errout;
+			}
+			offset += nbytes;
 		}
 	}
-	HTTP_FREE(buf);
+
+	if (nbytes < 0) {
+		HTTP_LOGE("Error: Fail to read %s\n", path);
+		goto errout;
+	}
+
+	if (chunked) {
+		if (http_client_send(client, "0\r\n\r\n", 5) != HTTP_OK) {
+			goto errout;
+		}
+	} else if (offset != st.st_size) {
+		HTTP_LOGE("Error: %s changed while sending\n", path);
+		goto errout;
+	}
+
+	HTTP_FREE(chunk);
+	close(fd);
 	return HTTP_OK;
+
+errout:
+	/* The response is incomplete, the client finds out when the connection closes */
+	client->keep_alive = false;
+	if (chunk) {
+		HTTP_FREE(chunk);
+	}
+	close(fd);
+	return HTTP_ERROR;
 }
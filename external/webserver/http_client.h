@@ -19,6 +19,7 @@
 #ifndef __http_client_h__
 #define __http_client_h__
 
+#include <time.h>
 #include <protocols/webserver/http_server.h>
 #include <protocols/webclient.h>
 #include <protocols/websocket.h>
@@ -36,6 +37,9 @@
 #include "mbedtls/ssl_cache.h"
 #endif
 
+/* Number of header fields which request a websocket upgrade */
+#define MIN_WS_HEADER_FIELD 2
+
 enum {
 	HTTP_REQUEST_HEADER, HTTP_REQUEST_PARAMETERS, HTTP_REQUEST_BODY
 };
@@ -45,6 +49,15 @@ struct http_client_t {
 	struct http_server_t *server;
 	int ws_state;
 	unsigned char ws_key[WEBSOCKET_CLIENT_KEY_LEN];
+	uint32_t client_ip;
+
+	/* Persistent connection state. buf holds the received bytes which are
+	 * not handled yet, which may be several pipelined requests. */
+	char *buf;
+	int buf_len;
+	int keep_alive;
+	int nrequests;
+	clock_t idle_since;
 
 #ifdef CONFIG_NET_SECURITY_TLS
 	mbedtls_ssl_context       tls_ssl;
@@ -60,7 +73,6 @@ struct http_message_len_t {
 	int content_len;
 };
 
-int   http_accept_client(struct http_server_t *server);
 void  http_close_client(struct http_client_t *client);
 void *http_handle_client(void *arg /* struct http_client_t *client */);
 
@@ -74,7 +86,8 @@ int http_parse_message(char *buf, int buf_len, int *method, char *url,
 					   struct http_client_t *client,
 					   struct http_client_response_t *response,
 					   struct http_req_message *req);
-int   http_recv_and_handle_request(struct http_client_t *client, struct http_keyvalue_list_t *request_params);
+int   http_recv_and_handle_request(struct http_client_t *client);
+int   http_client_pending(struct http_client_t *client);
 
 #ifdef CONFIG_NET_SECURITY_TLS
 int   http_client_tls_init(struct http_client_t *client);
@@ -73,24 +73,37 @@ void http_server_release(struct http_server_t **server)
 
 void http_close_client(struct http_client_t *client)
 {
-	close(client->client_fd);
+#ifdef CONFIG_NET_SECURITY_TLS
+	/* The socket is closed by mbedtls_net_free() when TLS is released */
+	if (!client->server->tls_init || client->ws_state >= MIN_WS_HEADER_FIELD)
+#endif
+	{
+		close(client->client_fd);
+	}
 	http_client_release(client);
 }
 
 int http_server_stop(struct http_server_t *server)
 {
-	if (server == NULL) {
+	int i;
+
+	if (server == NULL || server->state != HTTP_SERVER_RUN) {
 		HTTP_LOGE("Error: Server must be started before stop\n");
 		return HTTP_ERROR;
 	}
 
 	server->state = HTTP_SERVER_STOP_REQ;
 
-	while (server->state != HTTP_SERVER_STOP) {
-		usleep(100000);
+	/* Each client handler closes its connections and posts once it exits */
+	for (i = 0; i < HTTP_CONF_MAX_CLIENT_HANDLE; i++) {
+		while (sem_wait(&server->sem_thread_sync) != 0) {
+			/* Interrupted by a signal, wait again */
+		}
 	}
+	sem_destroy(&server->sem_thread_sync);
 
 	close(server->listen_fd);
+	server->state = HTTP_SERVER_STOP;
 
 	return HTTP_OK;
 }
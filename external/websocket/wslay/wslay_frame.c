@@ -42,6 +42,7 @@
 #include "wslay_frame.h"
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 
@@ -49,6 +50,59 @@
 
 #define wslay_min(A, B) (((A) < (B)) ? (A) : (B))
 
+/* Payload bytes masked and sent per send_callback call */
+#define WSLAY_OBUF_SIZE 4096
+
+/* Machine word for masking, it may alias the byte buffers */
+typedef uintptr_t __attribute__((__may_alias__)) wslay_word_t;
+
+#define WSLAY_WORD_MASK (sizeof(wslay_word_t) - 1)
+
+/* First position in buf which is aligned like ptr */
+static inline uint8_t *wslay_align_like(uint8_t *buf, const uint8_t *ptr)
+{
+	return buf + (((uintptr_t)ptr - (uintptr_t)buf) & WSLAY_WORD_MASK);
+}
+
+/*
+ * XOR len bytes of src with the mask key into dst, off is the payload
+ * offset of src[0].  When src and dst are aligned alike, the body is done a
+ * word at a time with the key repeated over the word.  dst may be src.
+ */
+static void wslay_mask(uint8_t *dst, const uint8_t *src, size_t len, const uint8_t *maskkey, uint64_t off)
+{
+	wslay_word_t mask;
+	uint8_t *maskbytes = (uint8_t *)&mask;
+	size_t i;
+
+	if ((((uintptr_t)dst ^ (uintptr_t)src) & WSLAY_WORD_MASK) == 0) {
+		for (; len > 0 && ((uintptr_t)dst & WSLAY_WORD_MASK) != 0; --len, ++off) {
+			*dst++ = *src++ ^ maskkey[off % 4];
+		}
+		/* Built in memory order, so it does not depend on the endianness */
+		for (i = 0; i < sizeof(wslay_word_t); ++i) {
+			maskbytes[i] = maskkey[(off + i) % 4];
+		}
+		/* A word is a multiple of 4 bytes, the key phase stays the same */
+		for (; len >= 4 * sizeof(wslay_word_t); len -= 4 * sizeof(wslay_word_t)) {
+			((wslay_word_t *)dst)[0] = ((const wslay_word_t *)src)[0] ^ mask;
+			((wslay_word_t *)dst)[1] = ((const wslay_word_t *)src)[1] ^ mask;
+			((wslay_word_t *)dst)[2] = ((const wslay_word_t *)src)[2] ^ mask;
+			((wslay_word_t *)dst)[3] = ((const wslay_word_t *)src)[3] ^ mask;
+			dst += 4 * sizeof(wslay_word_t);
+			src += 4 * sizeof(wslay_word_t);
+		}
+		for (; len >= sizeof(wslay_word_t); len -= sizeof(wslay_word_t)) {
+			*(wslay_word_t *)dst = *(const wslay_word_t *)src ^ mask;
+			dst += sizeof(wslay_word_t);
+			src += sizeof(wslay_word_t);
+		}
+	}
+	for (; len > 0; --len, ++off) {
+		*dst++ = *src++ ^ maskkey[off % 4];
+	}
+}
+
 int wslay_frame_context_init(wslay_frame_context_ptr *ctx, const struct wslay_frame_callbacks *callbacks, void *user_data)
 {
 	*ctx = (wslay_frame_context_ptr)malloc(sizeof(struct wslay_frame_context));
@@ -72,12 +126,17 @@ void wslay_frame_context_free(wslay_frame_context_ptr ctx)
 
 ssize_t wslay_frame_send(wslay_frame_context_ptr ctx, struct wslay_frame_iocb *iocb)
 {
+	/* Room for the header in front of the payload and for aligning the payload like the user data */
+	uint8_t obuf[sizeof(ctx->oheader) + WSLAY_OBUF_SIZE + sizeof(wslay_word_t)];
+	size_t totallen = 0;
+
 	if (iocb->data_length > iocb->payload_length) {
 		return WSLAY_ERR_INVALID_ARGUMENT;
 	}
 	if (ctx->ostate == PREP_HEADER) {
 		uint8_t *hdptr = ctx->oheader;
 		memset(ctx->oheader, 0, sizeof(ctx->oheader));
+		ctx->omask = 0;
 		*hdptr |= (iocb->fin << 7) & 0x80u;
 		*hdptr |= (iocb->rsv << 4) & 0x70u;
 		*hdptr |= iocb->opcode & 0xfu;
@@ -121,44 +180,50 @@ ssize_t wslay_frame_send(wslay_frame_context_ptr ctx, struct wslay_frame_iocb *i
 		ctx->opayloadoff = 0;
 	}
 	if (ctx->ostate == SEND_HEADER) {
-		ptrdiff_t len = ctx->oheaderlimit - ctx->oheadermark;
+		/* Send the header together with the first part of the payload, like writev() */
+		size_t hdrlen = ctx->oheaderlimit - ctx->oheadermark;
+		size_t writelen = wslay_min(WSLAY_OBUF_SIZE, iocb->data_length);
+		uint8_t *payload = wslay_align_like(obuf + sizeof(ctx->oheader), iocb->data);
 		ssize_t r;
 		int flags = 0;
-		if (iocb->data_length > 0) {
+		if (writelen > 0) {
+			if (ctx->omask) {
+				wslay_mask(payload, iocb->data, writelen, ctx->omaskkey, ctx->opayloadoff);
+			} else {
+				memcpy(payload, iocb->data, writelen);
+			}
+		}
+		if (writelen < iocb->data_length) {
 			flags |= WSLAY_MSG_MORE;
-		};
-		r = ctx->callbacks.send_callback(ctx->oheadermark, len, flags, ctx->user_data);
+		}
+		memcpy(payload - hdrlen, ctx->oheadermark, hdrlen);
+		r = ctx->callbacks.send_callback(payload - hdrlen, hdrlen + writelen, flags, ctx->user_data);
 		if (r > 0) {
-			if (r > len) {
+			if ((size_t)r > hdrlen + writelen) {
 				return WSLAY_ERR_INVALID_CALLBACK;
-			} else {
+			} else if ((size_t)r < hdrlen) {
 				ctx->oheadermark += r;
-				if (ctx->oheadermark == ctx->oheaderlimit) {
-					ctx->ostate = SEND_PAYLOAD;
-				} else {
-					return WSLAY_ERR_WANT_WRITE;
-				}
+				return WSLAY_ERR_WANT_WRITE;
+			} else {
+				ctx->oheadermark = ctx->oheaderlimit;
+				ctx->ostate = SEND_PAYLOAD;
+				totallen = r - hdrlen;
+				ctx->opayloadoff += totallen;
 			}
 		} else {
 			return WSLAY_ERR_WANT_WRITE;
 		}
 	}
 	if (ctx->ostate == SEND_PAYLOAD) {
-		size_t totallen = 0;
-		if (iocb->data_length > 0) {
+		if (totallen < iocb->data_length) {
 			if (ctx->omask) {
-				uint8_t temp[4096];
-				const uint8_t *datamark = iocb->data, *datalimit = iocb->data + iocb->data_length;
+				const uint8_t *datamark = iocb->data + totallen, *datalimit = iocb->data + iocb->data_length;
 				while (datamark < datalimit) {
-					size_t datalen = datalimit - datamark;
-					const uint8_t *writelimit = datamark + wslay_min(sizeof(temp), datalen);
-					size_t writelen = writelimit - datamark;
+					size_t writelen = wslay_min(WSLAY_OBUF_SIZE, (size_t)(datalimit - datamark));
+					uint8_t *payload = wslay_align_like(obuf, datamark);
 					ssize_t r;
-					size_t i;
-					for (i = 0; i < writelen; ++i) {
-						temp[i] = datamark[i] ^ ctx->omaskkey[(ctx->opayloadoff + i) % 4];
-					}
-					r = ctx->callbacks.send_callback(temp, writelen, 0, ctx->user_data);
+					wslay_mask(payload, datamark, writelen, ctx->omaskkey, ctx->opayloadoff);
+					r = ctx->callbacks.send_callback(payload, writelen, 0, ctx->user_data);
 					if (r > 0) {
 						if ((size_t)r > writelen) {
 							return WSLAY_ERR_INVALID_CALLBACK;
@@ -176,16 +241,17 @@ ssize_t wslay_frame_send(wslay_frame_context_ptr ctx, struct wslay_frame_iocb *i
 					}
 				}
 			} else {
+				size_t writelen = iocb->data_length - totallen;
 				ssize_t r;
-				r = ctx->callbacks.send_callback(iocb->data, iocb->data_length, 0, ctx->user_data);
+				r = ctx->callbacks.send_callback(iocb->data + totallen, writelen, 0, ctx->user_data);
 				if (r > 0) {
-					if ((size_t)r > iocb->data_length) {
+					if ((size_t)r > writelen) {
 						return WSLAY_ERR_INVALID_CALLBACK;
 					} else {
 						ctx->opayloadoff += r;
-						totallen = r;
+						totallen += r;
 					}
-				} else {
+				} else if (totallen == 0) {
 					return WSLAY_ERR_WANT_WRITE;
 				}
 			}
@@ -318,13 +384,10 @@ ssize_t wslay_frame_recv(wslay_frame_context_ptr ctx, struct wslay_frame_iocb *i
 		readmark = ctx->ibufmark;
 		readlimit = WSLAY_AVAIL_IBUF(ctx) < rempayloadlen ? ctx->ibuflimit : ctx->ibufmark + rempayloadlen;
 		if (ctx->imask) {
-			for (; ctx->ibufmark != readlimit; ++ctx->ibufmark, ++ctx->ipayloadoff) {
-				ctx->ibufmark[0] ^= ctx->imaskkey[ctx->ipayloadoff % 4];
-			}
-		} else {
-			ctx->ibufmark = readlimit;
-			ctx->ipayloadoff += readlimit - readmark;
+			wslay_mask(readmark, readmark, readlimit - readmark, ctx->imaskkey, ctx->ipayloadoff);
 		}
+		ctx->ibufmark = readlimit;
+		ctx->ipayloadoff += readlimit - readmark;
 		iocb->fin = ctx->iom.fin;
 		iocb->rsv = ctx->iom.rsv;
 		iocb->opcode = ctx->iom.opcode;
@@ -37,6 +37,7 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
 #include <string>
 
 namespace media {
@@ -132,6 +133,11 @@ private:
 	static size_t HeaderCallback(char *data, size_t size, size_t nmemb, void *userp);
 	static size_t WriteCallback(char *data, size_t size, size_t nmemb, void *userp);
 	static void *workerMain(void *arg);
+	void onResponseStatus(const std::string &status);
+	void prefetch();
+	void updateChunkSize(size_t bytes, std::chrono::steady_clock::duration elapsed);
+	bool waitForRetry(int retries);
+	void abortDownload();
 
 private:
 	std::string mContentType;
@@ -141,6 +147,22 @@ private:
 	std::condition_variable mCondv;
 	bool mIsHeaderReceived;
 	bool mIsDataReceived;
+	bool mIsClosing;
+	// Range requests are used until a response proves the server ignores them
+	bool mRangeSupported;
+	bool mIsRebuffering;
+	// Status of the response being received
+	long mResponseCode;
+	// Length of the whole resource, 0 while it is unknown (e.g. live streams)
+	size_t mContentLength;
+	// Bytes of the resource written into the stream buffer so far
+	size_t mOffset;
+	// Bytes to drop from a response that restarted from the beginning
+	size_t mSkip;
+	// Length of the next range request
+	size_t mChunkSize;
+	// Buffer level last reported to the source buffer listener
+	size_t mReportedLevel;
 	std::shared_ptr<HttpStream> mHttpStream;
 	std::shared_ptr<StreamBuffer> mStreamBuffer;
 	std::shared_ptr<StreamBufferReader> mBufferReader;
@@ -30,6 +30,7 @@
 #define __MEDIA_INPUTDATASOURCE_H
 
 #include <memory>
+#include <functional>
 #include <media/DataSource.h>
 
 namespace media {
@@ -76,6 +77,47 @@ public:
 	 * @since TizenRT v2.0
 	 */
 	virtual ssize_t read(unsigned char *buf, size_t size) = 0;
+
+	/**
+	 * @brief Events of a buffer that the source fills by itself, e.g. the
+	 * download buffer of a network source.
+	 * @details @b #include <media/InputDataSource.h>
+	 * @since TizenRT v3.1 PRE
+	 */
+	enum class SourceBufferEvent {
+		/** The fill level changed */
+		LEVEL,
+		/** The buffer ran dry while the stream goes on */
+		REBUFFERING,
+		/** Enough data was buffered again after REBUFFERING */
+		REBUFFERED,
+	};
+
+	/**
+	 * @brief Listener of SourceBufferEvent, with the buffer level and size in bytes
+	 * @details @b #include <media/InputDataSource.h>
+	 * @since TizenRT v3.1 PRE
+	 */
+	using SourceBufferListener = std::function<void(SourceBufferEvent event, size_t level, size_t size)>;
+
+	/**
+	 * @brief Sets the listener of the source buffer events, nullptr removes it.
+	 * Sources without a buffer of their own never call it.
+	 * @details @b #include <media/InputDataSource.h>
+	 * @since TizenRT v3.1 PRE
+	 */
+	void setSourceBufferListener(SourceBufferListener listener);
+
+protected:
+	/**
+	 * @brief Calls the source buffer listener, if there is one
+	 * @details @b #include <media/InputDataSource.h>
+	 * @since TizenRT v3.1 PRE
+	 */
+	void notifySourceBuffer(SourceBufferEvent event, size_t level, size_t size);
+
+private:
+	SourceBufferListener mSourceBufferListener;
 };
 
 } // namespace stream
@@ -128,6 +128,22 @@ public:
 	 * @since TizenRT v2.0
 	 */
 	virtual void onPlaybackBufferStateChanged(MediaPlayer &mediaPlayer, buffer_state_t state) {}
+	/**
+	 * @brief informs the user of the fill level of the buffer in which the
+	 * data source prefetches the stream, e.g. HttpInputDataSource.
+	 * @details @b #include <media/MediaPlayerObserverInterface.h>
+	 * param[in] level bytes in the buffer
+	 * param[in] size size of the buffer
+	 * @since TizenRT v3.1 PRE
+	 */
+	virtual void onPlaybackSourceBufferLevel(MediaPlayer &mediaPlayer, size_t level, size_t size) {}
+	/**
+	 * @brief informs the user that playback waits for the data source to
+	 * buffer the stream again (true), and that it goes on (false).
+	 * @details @b #include <media/MediaPlayerObserverInterface.h>
+	 * @since TizenRT v3.1 PRE
+	 */
+	virtual void onPlaybackRebuffering(MediaPlayer &mediaPlayer, bool rebuffering) {}
 	/**
 	 * @brief informs the user of the player has been prepared
 	 * @details @b #include <media/MediaPlayerObserverInterface.h>
@@ -439,6 +439,7 @@ int pcm_mmap_begin(struct pcm *pcm, void **areas, unsigned int *offset, unsigned
 * @brief Application has completed the access to area requested with pcm_mmap_begin
 *
 * @details @b #include <tinyalsa/tinyalsa.h>
+* For playback, the area is queued to the device, which is started on the first commit.
 * @param[in] pcm A PCM handle
 * @param[in] offset Area offset in frames. This must be same as the offset returned by pcm_mmap_begin
 * @param[in] frames Mmap area portion size in frames that application wishes to commit
@@ -19,12 +19,14 @@
 #include <tinyara/config.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <stdlib.h>
 #include <debug.h>
 #include <unistd.h>
 #include <assert.h>
 #include <media/HttpInputDataSource.h>
 #include <chrono>
+#include <algorithm>
 
 #include <media/MediaUtils.h>
 #include "HttpStream.h"
@@ -45,23 +47,76 @@
 #define CONFIG_HTTPSOURCE_DOWNLOAD_STACKSIZE 8192
 #endif
 
+#ifndef CONFIG_HTTPSOURCE_PREFETCH_DEPTH
+#define CONFIG_HTTPSOURCE_PREFETCH_DEPTH 2048
+#endif
+
+#ifndef CONFIG_HTTPSOURCE_PREFETCH_MIN_CHUNK
+#define CONFIG_HTTPSOURCE_PREFETCH_MIN_CHUNK 512
+#endif
+
+#ifndef CONFIG_HTTPSOURCE_PREFETCH_REQUEST_MSEC
+#define CONFIG_HTTPSOURCE_PREFETCH_REQUEST_MSEC 500
+#endif
+
+#ifndef CONFIG_HTTPSOURCE_STALL_TIMEOUT
+#define CONFIG_HTTPSOURCE_STALL_TIMEOUT 5
+#endif
+
+#ifndef CONFIG_HTTPSOURCE_RETRY_COUNT
+#define CONFIG_HTTPSOURCE_RETRY_COUNT 5
+#endif
+
+// Range requests stop at the depth, unless that leaves less than the minimum
+#if CONFIG_HTTPSOURCE_DOWNLOAD_BUFFER_SIZE > CONFIG_HTTPSOURCE_PREFETCH_DEPTH + CONFIG_HTTPSOURCE_PREFETCH_MIN_CHUNK
+#define PREFETCH_MAX_CHUNK (CONFIG_HTTPSOURCE_DOWNLOAD_BUFFER_SIZE - CONFIG_HTTPSOURCE_PREFETCH_DEPTH)
+#define PREFETCH_MIN_CHUNK CONFIG_HTTPSOURCE_PREFETCH_MIN_CHUNK
+#else
+#define PREFETCH_MAX_CHUNK (CONFIG_HTTPSOURCE_DOWNLOAD_BUFFER_SIZE / 2)
+#define PREFETCH_MIN_CHUNK PREFETCH_MAX_CHUNK
+#endif
+
+// Number of steps in which the buffer level is reported
+#define LEVEL_REPORT_STEPS 8
+
 namespace media {
 namespace stream {
 
 // Content-Type tag
 static const std::string TAG_CONTENT_TYPE = "Content-Type:";
+static const std::string TAG_CONTENT_LENGTH = "Content-Length:";
+static const std::string TAG_CONTENT_RANGE = "Content-Range:";
 
 static const std::chrono::seconds WAIT_HEADER_TIMEOUT = std::chrono::seconds(3);
 static const std::chrono::seconds WAIT_DATA_TIMEOUT = std::chrono::seconds(3);
+// Delay before the first retry, doubled for each following one up to 16 times
+static const std::chrono::milliseconds RETRY_DELAY = std::chrono::milliseconds(250);
+
+/* Gets the value of 'header' if its name is 'tag', which is case-insensitive */
+static bool getHeaderValue(const std::string &header, const std::string &tag, std::string &value)
+{
+	if (strncasecmp(header.c_str(), tag.c_str(), tag.length()) != 0) {
+		return false;
+	}
+
+	auto pos = header.find_first_not_of(' ', tag.length());
+	if (pos == std::string::npos) {
+		return false;
+	}
+
+	auto end = header.find((char)0x0d, pos); // CR: 0x0d
+	value = header.substr(pos, end - pos);
+	return true;
+}
 
 HttpInputDataSource::HttpInputDataSource(const std::string &url)
-	: InputDataSource(), mUrl(url), mThread((pthread_t)0), mIsHeaderReceived(false), mIsDataReceived(false)
+	: InputDataSource(), mUrl(url), mThread((pthread_t)0), mIsHeaderReceived(false), mIsDataReceived(false), mIsClosing(false), mRangeSupported(true), mIsRebuffering(false), mResponseCode(0), mContentLength(0), mOffset(0), mSkip(0), mChunkSize(PREFETCH_MAX_CHUNK), mReportedLevel(0)
 {
 	medvdbg("url: %s\n", mUrl.c_str());
 }
 
 HttpInputDataSource::HttpInputDataSource(const HttpInputDataSource &source)
-	: InputDataSource(source), mUrl(source.mUrl), mThread((pthread_t)0), mIsHeaderReceived(source.mIsHeaderReceived), mIsDataReceived(source.mIsDataReceived)
+	: InputDataSource(source), mUrl(source.mUrl), mThread((pthread_t)0), mIsHeaderReceived(source.mIsHeaderReceived), mIsDataReceived(source.mIsDataReceived), mIsClosing(false), mRangeSupported(true), mIsRebuffering(false), mResponseCode(0), mContentLength(0), mOffset(0), mSkip(0), mChunkSize(PREFETCH_MAX_CHUNK), mReportedLevel(0)
 {
 }
 
@@ -107,6 +162,13 @@ bool HttpInputDataSource::open()
 	std::unique_lock<std::mutex> lock(mMutex);
 	mIsHeaderReceived = false;
 	mIsDataReceived = false;
+	mIsClosing = false;
+	mRangeSupported = true;
+	mIsRebuffering = false;
+	mContentLength = 0;
+	mOffset = 0;
+	mChunkSize = PREFETCH_MAX_CHUNK;
+	mReportedLevel = 0;
 
 	pthread_attr_t attr;
 	pthread_attr_init(&attr);
@@ -125,7 +187,8 @@ bool HttpInputDataSource::open()
 	// wait for Content-Type header
 	if (!mCondv.wait_for(lock, WAIT_HEADER_TIMEOUT, [=]{ return mIsHeaderReceived; })) {
 		meddbg("download:: wait header timeout!\n");
-		mBufferWriter->setEndOfStream();
+		lock.unlock();
+		abortDownload();
 		return false;
 	}
 
@@ -137,15 +200,19 @@ bool HttpInputDataSource::open()
 		// wait for audio stream data
 		if (!mCondv.wait_for(lock, WAIT_DATA_TIMEOUT, [=]{ return mIsDataReceived; })) {
 			meddbg("download:: wait audio data timeout!\n");
-			mBufferWriter->setEndOfStream();
+			lock.unlock();
+			abortDownload();
 			return false;
 		}
 
+		// Download thread takes the lock from inside the buffer, don't hold it while using the buffer
+		lock.unlock();
+
 		size_t templen = mBufferReader->sizeOfData();
 		unsigned char *tempbuf = new unsigned char[templen];
 		if (tempbuf == nullptr) {
 			meddbg("memory allocation failed! size 0x%x\n", templen);
-			mBufferWriter->setEndOfStream();
+			abortDownload();
 			return false;
 		}
 
@@ -157,7 +224,7 @@ bool HttpInputDataSource::open()
 
 		if (!ret) {
 			meddbg("header parsing failed\n");
-			mBufferWriter->setEndOfStream();
+			abortDownload();
 			return false;
 		}
 
@@ -171,7 +238,8 @@ bool HttpInputDataSource::open()
 	default:
 		/* unsupported audio type */
 		meddbg("HttpInputDataSource::open, unsupported audio type %d\n", (int)audioType);
-		mBufferWriter->setEndOfStream();
+		lock.unlock();
+		abortDownload();
 		return false;
 	}
 
@@ -183,7 +251,7 @@ bool HttpInputDataSource::close()
 {
 	medvdbg("HttpInputDataSource::close enter\n");
 	if (mBufferWriter) {
-		mBufferWriter->setEndOfStream();
+		abortDownload();
 	}
 
 	if (mThread != (pthread_t)0) {
@@ -232,6 +300,12 @@ void HttpInputDataSource::onBufferOverrun()
 
 void HttpInputDataSource::onBufferUnderrun()
 {
+	// The player waits for data: unless the stream is just starting, the download fell behind
+	if (mIsDataReceived && !mIsRebuffering) {
+		medwdbg("rebuffering\n");
+		mIsRebuffering = true;
+		notifySourceBuffer(SourceBufferEvent::REBUFFERING, mStreamBuffer->sizeOfData(), mStreamBuffer->getBufferSize());
+	}
 }
 
 void HttpInputDataSource::onBufferUpdated(ssize_t change, size_t current)
@@ -244,6 +318,20 @@ void HttpInputDataSource::onBufferUpdated(ssize_t change, size_t current)
 			mCondv.notify_one();
 		}
 	}
+
+	size_t size = mStreamBuffer->getBufferSize();
+	if (mIsRebuffering && current >= mStreamBuffer->getThreshold()) {
+		medwdbg("rebuffered\n");
+		mIsRebuffering = false;
+		notifySourceBuffer(SourceBufferEvent::REBUFFERED, current, size);
+	}
+
+	// Report the level in steps rather than for every read and write, and whenever it gets empty or full
+	size_t diff = (current > mReportedLevel) ? (current - mReportedLevel) : (mReportedLevel - current);
+	if (diff >= size / LEVEL_REPORT_STEPS || (diff > 0 && (current == 0 || current == size))) {
+		mReportedLevel = current;
+		notifySourceBuffer(SourceBufferEvent::LEVEL, current, size);
+	}
 }
 
 size_t HttpInputDataSource::HeaderCallback(char *data, size_t size, size_t nmemb, void *userp)
@@ -257,16 +345,32 @@ size_t HttpInputDataSource::HeaderCallback(char *data, size_t size, size_t nmemb
 	size_t totalsize = size * nmemb;
 	std::string header(data, totalsize);
 	medvdbg("%s\n", header.c_str());
-	auto pos = header.find(TAG_CONTENT_TYPE);
-	if (pos != std::string::npos) {
-		pos = header.find_first_not_of(' ', pos + TAG_CONTENT_TYPE.length());
-		auto end = header.find((char)0x0d, pos); // CR: 0x0d
-		source->mContentType = header.substr(pos, end - pos);
+
+	if (header.compare(0, 5, "HTTP/") == 0) {
+		// Status line, the headers of a new response follow
+		source->onResponseStatus(header);
+		return totalsize;
+	}
+
+	std::string value;
+	if (getHeaderValue(header, TAG_CONTENT_TYPE, value)) {
 		if (!source->mIsHeaderReceived) {
+			source->mContentType = value;
 			std::lock_guard<std::mutex> lock(source->mMutex);
 			source->mIsHeaderReceived = true;
 			source->mCondv.notify_one();
 		}
+	} else if (getHeaderValue(header, TAG_CONTENT_LENGTH, value)) {
+		// Length of the whole resource, unless only a range of it is sent
+		if (source->mResponseCode == 200) {
+			source->mContentLength = strtoul(value.c_str(), NULL, 10);
+		}
+	} else if (getHeaderValue(header, TAG_CONTENT_RANGE, value)) {
+		// bytes <first>-<last>/<complete length or *>
+		auto pos = value.find('/');
+		if (source->mResponseCode == 206 && pos != std::string::npos && value.compare(pos + 1, 1, "*") != 0) {
+			source->mContentLength = strtoul(value.c_str() + pos + 1, NULL, 10);
+		}
 	}
 
 	return totalsize;
@@ -276,7 +380,148 @@ size_t HttpInputDataSource::WriteCallback(char *data, size_t size, size_t nmemb,
 {
 	auto source = static_cast<HttpInputDataSource *>(userp);
 	size_t totalsize = size * nmemb;
-	return source->mBufferWriter->write((unsigned char *)data, totalsize);
+
+	if (source->mResponseCode >= 300) {
+		// Not the stream, but an error page or the like
+		return totalsize;
+	}
+
+	size_t skip = std::min(source->mSkip, totalsize);
+	source->mSkip -= skip;
+	if (skip == totalsize) {
+		return totalsize;
+	}
+
+	size_t wlen = source->mBufferWriter->write((unsigned char *)data + skip, totalsize - skip);
+	source->mOffset += wlen;
+	return skip + wlen;
+}
+
+void HttpInputDataSource::onResponseStatus(const std::string &status)
+{
+	// HTTP/<version> <code> <reason>
+	auto pos = status.find(' ');
+	mResponseCode = (pos != std::string::npos) ? strtol(status.c_str() + pos, NULL, 10) : 0;
+	mSkip = 0;
+
+	if (mResponseCode == 200) {
+		// The whole resource is sent, either the Range request was ignored or there was none.
+		// A live stream goes on from where it is now, others start over from the beginning.
+		medvdbg("range not supported\n");
+		mRangeSupported = false;
+		if (mContentLength > 0) {
+			mSkip = mOffset;
+		}
+	}
+}
+
+void HttpInputDataSource::updateChunkSize(size_t bytes, std::chrono::steady_clock::duration elapsed)
+{
+	auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+	if (msec <= 0) {
+		msec = 1;
+	}
+
+	// Size requests to take about the same time at the measured throughput: a fast link spreads
+	// the round trip of a request over more data, a slow one is asked for what it delivers in time
+	size_t target = (size_t)((unsigned long long)bytes * CONFIG_HTTPSOURCE_PREFETCH_REQUEST_MSEC / msec);
+	target = std::max<size_t>(PREFETCH_MIN_CHUNK, std::min<size_t>(PREFETCH_MAX_CHUNK, target));
+	mChunkSize = (mChunkSize + target) / 2;
+	medvdbg("%u bytes in %d ms, next chunk %u\n", (unsigned int)bytes, (int)msec, (unsigned int)mChunkSize);
+}
+
+bool HttpInputDataSource::waitForRetry(int retries)
+{
+	auto delay = RETRY_DELAY * (1 << std::min(retries - 1, 4));
+	std::unique_lock<std::mutex> lock(mMutex);
+	return !mCondv.wait_for(lock, delay, [this] { return mIsClosing; });
+}
+
+void HttpInputDataSource::abortDownload()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mIsClosing = true;
+		mCondv.notify_all();
+	}
+
+	mBufferWriter->setEndOfStream();
+}
+
+void HttpInputDataSource::prefetch()
+{
+	int retries = 0;
+
+	while (!mBufferReader->isEndOfStream()) {
+		size_t length = 0;
+		if (mRangeSupported) {
+			if (mContentLength > 0 && mOffset >= mContentLength) {
+				medvdbg("download completed, %u bytes\n", (unsigned int)mOffset);
+				break;
+			}
+
+			// Ask for no more than fits, so the connection never waits for the player
+			if (!mBufferWriter->waitForSpace(mChunkSize)) {
+				break;
+			}
+
+			length = mChunkSize;
+			if (mContentLength > 0 && length > mContentLength - mOffset) {
+				length = mContentLength - mOffset;
+			}
+		}
+
+		// A transfer blocked by a full buffer doesn't stall, so only ranges are watched. The
+		// first one is not either: the server may send the whole resource in answer to it.
+		mHttpStream->setStallTimeout((mRangeSupported && mOffset > 0) ? CONFIG_HTTPSOURCE_STALL_TIMEOUT : 0);
+
+		size_t offset = mOffset;
+		auto start = std::chrono::steady_clock::now();
+		bool ok = mHttpStream->download(mUrl, mRangeSupported ? offset : 0, length);
+		size_t received = mOffset - offset;
+
+		if (mBufferReader->isEndOfStream()) {
+			// Closed
+			break;
+		}
+
+		long code = mHttpStream->getResponseCode();
+		if (ok && code == 206) {
+			retries = 0;
+			if (received < length) {
+				// The resource ended before the range
+				break;
+			}
+
+			updateChunkSize(received, std::chrono::steady_clock::now() - start);
+			continue;
+		}
+
+		if ((ok && code == 200) || code == 416) {
+			// The whole resource was sent, or the range starts at its end
+			break;
+		}
+
+		if (code >= 300 && code < 500 && code != 408 && code != 429) {
+			meddbg("download failed, response %ld\n", code);
+			break;
+		}
+
+		// Disconnected, stalled or the server is busy: go on from the last byte received
+		if (received > 0) {
+			retries = 0;
+		}
+
+		if (++retries > CONFIG_HTTPSOURCE_RETRY_COUNT) {
+			meddbg("download failed at %u bytes!\n", (unsigned int)mOffset);
+			break;
+		}
+
+		medwdbg("download interrupted at %u bytes, retry %d\n", (unsigned int)mOffset, retries);
+		if (!waitForRetry(retries)) {
+			break;
+		}
+	}
 }
 
 void *HttpInputDataSource::workerMain(void *arg)
@@ -287,10 +532,8 @@ void *HttpInputDataSource::workerMain(void *arg)
 	//mHttpStream->addHeader("Icy-MetaData:1"); // not support now
 	source->mHttpStream->setHeaderCallback(HeaderCallback, arg);
 	source->mHttpStream->setWriteCallback(WriteCallback, arg);
-	if (!source->mHttpStream->download(source->mUrl)) {
-		medwdbg("download failed or terminated!\n");
-		// TODO: send network error code to upper layer later
-	}
+	source->prefetch();
+	// TODO: send network error code to upper layer later
 
 	source->mBufferWriter->setEndOfStream();
 	medvdbg("download thread exit!\n");
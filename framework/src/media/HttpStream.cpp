@@ -19,6 +19,7 @@
 #include <curl/curl.h>
 #include <curl/easy.h>
 #include <debug.h>
+#include <stdio.h>
 
 #include "HttpStream.h"
 
@@ -48,7 +49,7 @@ std::shared_ptr<HttpStream> HttpStream::create()
 }
 
 HttpStream::HttpStream() :
-	mCurl(nullptr), mHttpHeaders(nullptr), mInitializeFlag(false)
+	mCurl(nullptr), mHttpHeaders(nullptr), mResponseCode(0), mInitializeFlag(false)
 {
 }
 
@@ -105,6 +106,16 @@ bool HttpStream::init()
 		return false;
 	}
 
+	// Probe idle connections, so that they stay usable between requests
+	SET_OPTION(mCurl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+	return true;
+}
+
+bool HttpStream::setStallTimeout(long seconds)
+{
+	SET_OPTION(mCurl, CURLOPT_LOW_SPEED_LIMIT, seconds > 0 ? 1L : 0L);
+	SET_OPTION(mCurl, CURLOPT_LOW_SPEED_TIME, seconds);
 	return true;
 }
 
@@ -136,25 +147,38 @@ bool HttpStream::perform()
 	}
 
 	CURLcode result = curl_easy_perform(mCurl);
-	if (result != CURLE_OK) {
-		meddbg("curl_easy_perform failed, result %d - %s\n", result, curl_easy_strerror(result));
+
+	// A transfer that was cut off still has the code of its response
+	mResponseCode = 0;
+	if (curl_easy_getinfo(mCurl, CURLINFO_RESPONSE_CODE, &mResponseCode) != CURLE_OK) {
+		meddbg("Get response failed! response[%ld]\n", mResponseCode);
 		return false;
 	}
 
-	long response_code = 0;
-	result = curl_easy_getinfo(mCurl, CURLINFO_RESPONSE_CODE, &response_code);
 	if (result != CURLE_OK) {
-		meddbg("Get response failed! result[%d] response[%ld]\n", result, response_code);
+		meddbg("curl_easy_perform failed, result %d - %s\n", result, curl_easy_strerror(result));
 		return false;
 	}
 
 	return true;
 }
 
-bool HttpStream::download(const std::string &url)
+bool HttpStream::download(const std::string &url, size_t offset, size_t length)
 {
 	SET_OPTION(mCurl, CURLOPT_HTTPGET, 1L);
 
+	if (offset > 0 || length > 0) {
+		char range[24];
+		if (length > 0) {
+			snprintf(range, sizeof(range), "%u-%u", (unsigned int)offset, (unsigned int)(offset + length - 1));
+		} else {
+			snprintf(range, sizeof(range), "%u-", (unsigned int)offset);
+		}
+		SET_OPTION(mCurl, CURLOPT_RANGE, range);
+	} else {
+		SET_OPTION(mCurl, CURLOPT_RANGE, (char *)NULL);
+	}
+
 	SET_OPTION(mCurl, CURLOPT_URL, url.c_str());
 
 	SET_OPTION(mCurl, CURLOPT_SSL_VERIFYPEER, 0L);
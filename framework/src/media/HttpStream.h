@@ -66,9 +66,21 @@ public:
 	bool setReadCallback(CallbackFunc callback, void *userdata);
 
 	/*
-	 * Sets the callback for uploading local data
+	 * Downloads the resource, or only 'length' bytes of it from 'offset' with
+	 * a Range request when they are not zero. length 0 reads up to the end.
+	 * Successive downloads reuse the connection if the server keeps it alive.
+	 */
+	bool download(const std::string &url, size_t offset = 0, size_t length = 0);
+
+	/*
+	 * Aborts transfers that deliver no data for 'seconds'. 0 waits forever.
+	 */
+	bool setStallTimeout(long seconds);
+
+	/*
+	 * HTTP response code of the last transfer, 0 if there was no response
 	 */
-	bool download(const std::string &url);
+	long getResponseCode() { return mResponseCode; }
 
 	/*
 	 * Sets the callback for uploading local data
@@ -85,6 +97,8 @@ private:
 	CURL *mCurl;
 	// http level headers
 	curl_slist *mHttpHeaders;
+	// response code of the last transfer
+	long mResponseCode;
 
 	bool mInitializeFlag;
 	static int mInitializeCount;
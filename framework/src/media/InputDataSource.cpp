@@ -54,6 +54,18 @@ InputDataSource &InputDataSource::operator=(const InputDataSource &source)
 InputDataSource::~InputDataSource()
 {
 }
+
+void InputDataSource::setSourceBufferListener(SourceBufferListener listener)
+{
+	mSourceBufferListener = listener;
+}
+
+void InputDataSource::notifySourceBuffer(SourceBufferEvent event, size_t level, size_t size)
+{
+	if (mSourceBufferListener) {
+		mSourceBufferListener(event, level, size);
+	}
+}
 } // namespace stream
 } // namespace media
 
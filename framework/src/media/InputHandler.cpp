@@ -45,7 +45,30 @@ void InputHandler::setInputDataSource(std::shared_ptr<InputDataSource> source)
 		return;
 	}
 	StreamHandler::setDataSource(source);
+	if (mInputDataSource) {
+		mInputDataSource->setSourceBufferListener(nullptr);
+	}
 	mInputDataSource = source;
+
+	// Forward the events of sources that buffer data by themselves, such as downloads
+	mInputDataSource->setSourceBufferListener([this](InputDataSource::SourceBufferEvent event, size_t level, size_t size) {
+		auto mp = getPlayer();
+		if (!mp) {
+			return;
+		}
+
+		switch (event) {
+		case InputDataSource::SourceBufferEvent::LEVEL:
+			mp->notifyObserver(PLAYER_OBSERVER_COMMAND_SOURCE_BUFFER_LEVEL, level, size);
+			break;
+		case InputDataSource::SourceBufferEvent::REBUFFERING:
+			mp->notifyObserver(PLAYER_OBSERVER_COMMAND_REBUFFERING, (int)true);
+			break;
+		case InputDataSource::SourceBufferEvent::REBUFFERED:
+			mp->notifyObserver(PLAYER_OBSERVER_COMMAND_REBUFFERING, (int)false);
+			break;
+		}
+	});
 }
 
 bool InputHandler::doStandBy()
@@ -111,6 +134,24 @@ ssize_t InputHandler::read(unsigned char *buf, size_t size)
 	return (ssize_t)rlen;
 }
 
+ssize_t InputHandler::getRegion(unsigned char **region, size_t size)
+{
+	size_t rlen = 0;
+
+	if (mBufferReader) {
+		rlen = mBufferReader->getRegion(region, size);
+	}
+
+	return (ssize_t)rlen;
+}
+
+void InputHandler::consume(size_t size)
+{
+	if (mBufferReader) {
+		mBufferReader->consume(size);
+	}
+}
+
 void InputHandler::resetWorker()
 {
 	mState = BUFFER_STATE_EMPTY;
@@ -253,8 +294,14 @@ ssize_t InputHandler::writeToStreamBuffer(unsigned char *buf, size_t size)
 
 		size_t usedES = 0;
 		while (1) {
-			unsigned char *buffPCM = buf;
-			size_t sizePCM = used;
+			// Decode PCM data straight into the stream buffer
+			unsigned char *buffPCM = nullptr;
+			size_t sizePCM = mBufferWriter->getRegion(&buffPCM);
+			if (sizePCM == 0) {
+				meddbg("End of writting!\n");
+				return EOF;
+			}
+
 			ret = getPCM(buffES, sizeES, &usedES, &buffPCM, &sizePCM);
 			if (ret < 0) {
 				meddbg("getPCM failed! error: %d\n", ret);
@@ -265,12 +312,7 @@ ssize_t InputHandler::writeToStreamBuffer(unsigned char *buf, size_t size)
 				break;
 			}
 
-			// write PCM data to stream buffer
-			size_t written = mBufferWriter->write(buffPCM, sizePCM);
-			if (written != sizePCM) {
-				meddbg("End of writting!\n");
-				return EOF;
-			}
+			mBufferWriter->commit(sizePCM);
 		}
 	}
 	return size;
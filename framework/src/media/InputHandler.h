@@ -49,6 +49,8 @@ public:
 	bool open() override;
 	bool close() override;
 	ssize_t read(unsigned char *buf, size_t size);
+	ssize_t getRegion(unsigned char **region, size_t size);
+	void consume(size_t size);
 
 	void setBufferState(buffer_state_t state);
 
@@ -35,6 +35,14 @@ MediaPlayerImpl::MediaPlayerImpl(MediaPlayer &player) : mPlayer(player)
 	mCurState = PLAYER_STATE_NONE;
 	mBuffer = nullptr;
 	mBufSize = 0;
+#ifdef CONFIG_AUDIO_MIXER
+	mMixerStream = nullptr;
+	mVolume = 0;
+	get_max_audio_volume(&mVolume);
+#endif
+#ifdef CONFIG_MEDIA_PLAYER_DIRECT_OUTPUT
+	mDirectOutput = false;
+#endif
 }
 
 player_result_t MediaPlayerImpl::create()
@@ -152,15 +160,13 @@ void MediaPlayerImpl::preparePlayer(player_result_t &ret)
 		return notifySync();
 	}
 
-	auto source = mInputHandler.getDataSource();
-	if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
-							 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
-		meddbg("MediaPlayer prepare fail : set_audio_stream_out fail\n");
+	if (openAudioStream() != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer prepare fail : openAudioStream fail\n");
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
 		return notifySync();
 	}
 
-	mBufSize = get_user_output_frames_to_byte(get_output_frame_count());
+	mBufSize = getAudioBufferSize();
 	if (mBufSize < 0) {
 		meddbg("MediaPlayer prepare fail : get_output_frames_byte_size fail\n");
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
@@ -256,8 +262,8 @@ void MediaPlayerImpl::unpreparePlayer(player_result_t &ret)
 	}
 	mBufSize = 0;
 
-	if (reset_audio_stream_out() != AUDIO_MANAGER_SUCCESS) {
-		meddbg("MediaPlayer unprepare fail : reset_audio_stream_out fail\n");
+	if (closeAudioStream() != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer unprepare fail : closeAudioStream fail\n");
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
 		return notifySync();
 	}
@@ -297,15 +303,17 @@ void MediaPlayerImpl::startPlayer()
 	}
 
 	if (mCurState == PLAYER_STATE_PAUSED) {
-		auto source = mInputHandler.getDataSource();
-		if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
-								 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
-			meddbg("MediaPlayer startPlayer fail : set_audio_stream_out fail\n");
+		if (openAudioStream() != AUDIO_MANAGER_SUCCESS) {
+			meddbg("MediaPlayer startPlayer fail : openAudioStream fail\n");
 			notifyObserver(PLAYER_OBSERVER_COMMAND_START_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 			return;
 		}
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	/* Every player has a stream of its own, so they all play at once */
+	mpw.addPlayer(shared_from_this());
+#else
 	auto prevPlayer = mpw.getPlayer();
 	auto curPlayer = shared_from_this();
 	if (prevPlayer != curPlayer) {
@@ -315,6 +323,7 @@ void MediaPlayerImpl::startPlayer()
 		}
 		mpw.setPlayer(curPlayer);
 	}
+#endif
 
 	mCurState = PLAYER_STATE_PLAYING;
 	notifyObserver(PLAYER_OBSERVER_COMMAND_STARTED);
@@ -357,12 +366,17 @@ player_result_t MediaPlayerImpl::stopPlayback()
 		return PLAYER_ERROR_INVALID_STATE;
 	}
 
+	audio_manager_result_t result = stopAudioStream();
+
 	mCurState = PLAYER_STATE_READY;
+#ifdef CONFIG_AUDIO_MIXER
+	mpw.removePlayer(shared_from_this());
+#else
 	mpw.setPlayer(nullptr);
+#endif
 
-	audio_manager_result_t result = stop_audio_stream_out();
 	if (result != AUDIO_MANAGER_SUCCESS) {
-		meddbg("stop_audio_stream_out failed ret : %d\n", result);
+		meddbg("stopAudioStream failed ret : %d\n", result);
 		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
 	}
 
@@ -397,18 +411,22 @@ void MediaPlayerImpl::pausePlayer()
 		return;
 	}
 
-	audio_manager_result_t result = pause_audio_stream_out();
+	audio_manager_result_t result = pauseAudioStream();
 	if (result != AUDIO_MANAGER_SUCCESS) {
-		meddbg("pause_audio_stream_in failed ret : %d\n", result);
+		meddbg("pauseAudioStream failed ret : %d\n", result);
 		notifyObserver(PLAYER_OBSERVER_COMMAND_PAUSE_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 		return;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	mpw.removePlayer(shared_from_this());
+#else
 	auto prevPlayer = mpw.getPlayer();
 	auto curPlayer = shared_from_this();
 	if (prevPlayer == curPlayer) {
 		mpw.setPlayer(nullptr);
 	}
+#endif
 	mCurState = PLAYER_STATE_PAUSED;
 	notifyObserver(PLAYER_OBSERVER_COMMAND_PAUSED);
 }
@@ -441,10 +459,15 @@ player_result_t MediaPlayerImpl::getVolume(uint8_t *vol)
 void MediaPlayerImpl::getPlayerVolume(uint8_t *vol, player_result_t &ret)
 {
 	medvdbg("MediaPlayer Worker : getVolume\n");
+#ifdef CONFIG_AUDIO_MIXER
+	/* The volume of this player in the mix, kept across streams */
+	*vol = mVolume;
+#else
 	if (get_output_audio_volume(vol) != AUDIO_MANAGER_SUCCESS) {
 		meddbg("get_output_audio_volume() is failed, ret = %d\n", ret);
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
 	}
+#endif
 
 	notifySync();
 }
@@ -508,7 +531,18 @@ void MediaPlayerImpl::setPlayerVolume(uint8_t vol, player_result_t &ret)
 {
 	medvdbg("MediaPlayer Worker : setVolume %d\n", vol);
 
+#ifdef CONFIG_AUDIO_MIXER
+	uint8_t max_vol;
+	audio_manager_result_t result = get_max_audio_volume(&max_vol);
+	if (result == AUDIO_MANAGER_SUCCESS) {
+		mVolume = vol > max_vol ? max_vol : vol;
+		if (mMixerStream) {
+			result = set_audio_mixer_stream_volume(mMixerStream, mVolume);
+		}
+	}
+#else
 	audio_manager_result_t result = set_output_audio_volume(vol);
+#endif
 	if (result != AUDIO_MANAGER_SUCCESS) {
 		meddbg("set_input_audio_volume failed vol : %d ret : %d\n", vol, result);
 		if (result == AUDIO_MANAGER_DEVICE_NOT_SUPPORT) {
@@ -676,6 +710,14 @@ void MediaPlayerImpl::notifyObserver(player_observer_command_t cmd, ...)
 		case PLAYER_OBSERVER_COMMAND_BUFFER_STATECHANGED:
 			pow.enQueue(&MediaPlayerObserverInterface::onPlaybackBufferStateChanged, mPlayerObserver, mPlayer, (buffer_state_t)va_arg(ap, int));
 			break;
+		case PLAYER_OBSERVER_COMMAND_SOURCE_BUFFER_LEVEL: {
+			size_t level = va_arg(ap, size_t);
+			size_t size = va_arg(ap, size_t);
+			pow.enQueue(&MediaPlayerObserverInterface::onPlaybackSourceBufferLevel, mPlayerObserver, mPlayer, level, size);
+		} break;
+		case PLAYER_OBSERVER_COMMAND_REBUFFERING:
+			pow.enQueue(&MediaPlayerObserverInterface::onPlaybackRebuffering, mPlayerObserver, mPlayer, (bool)va_arg(ap, int));
+			break;
 		case PLAYER_OBSERVER_COMMAND_BUFFER_DATAREACHED: {
 			medvdbg("OBSERVER_COMMAND_BUFFER_DATAREACHED\n");
 			unsigned char *data = va_arg(ap, unsigned char *);
@@ -711,16 +753,14 @@ void MediaPlayerImpl::notifyAsync(player_event_t event)
 	case PLAYER_EVENT_SOURCE_PREPARED: {
 		// Input handler has been opened successfully by InputHandler::doStandBy().
 		// Now setup audio manager and notify player observer the result.
-		auto source = mInputHandler.getDataSource();
-		if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
-								 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
-			meddbg("MediaPlayer prepare fail : set_audio_stream_out fail\n");
+		if (openAudioStream() != AUDIO_MANAGER_SUCCESS) {
+			meddbg("MediaPlayer prepare fail : openAudioStream fail\n");
 			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 		}
 
-		mBufSize = get_user_output_frames_to_byte(get_output_frame_count());
+		mBufSize = getAudioBufferSize();
 		if (mBufSize < 0) {
-			meddbg("MediaPlayer prepare fail : get_user_output_frames_to_byte fail\n");
+			meddbg("MediaPlayer prepare fail : getAudioBufferSize fail\n");
 			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 		}
 
@@ -746,23 +786,21 @@ void MediaPlayerImpl::notifyAsync(player_event_t event)
 
 void MediaPlayerImpl::playback()
 {
-	ssize_t num_read = mInputHandler.read(mBuffer, (int)mBufSize);
+	int ret = AUDIO_MANAGER_SUCCESS;
+	ssize_t num_read = feedAudioStream(&ret);
 	medvdbg("num_read : %d\n", num_read);
-	if (num_read > 0) {
-		int ret = start_audio_stream_out(mBuffer, get_user_output_bytes_to_frame((unsigned int)num_read));
-		if (ret < 0) {
-			notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-			PlayerWorker &mpw = PlayerWorker::getWorker();
-			switch (ret) {
-			case AUDIO_MANAGER_XRUN_STATE:
-				meddbg("AUDIO_MANAGER_XRUN_STATE\n");
-				mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-				break;
-			default:
-				meddbg("audio manager error : %d\n", ret);
-				mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-				break;
-			}
+	if (ret < 0) {
+		notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+		PlayerWorker &mpw = PlayerWorker::getWorker();
+		switch (ret) {
+		case AUDIO_MANAGER_XRUN_STATE:
+			meddbg("AUDIO_MANAGER_XRUN_STATE\n");
+			mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+			break;
+		default:
+			meddbg("audio manager error : %d\n", ret);
+			mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+			break;
 		}
 	} else if (num_read == 0) {
 		player_result_t errcode = stopPlayback();
@@ -771,7 +809,7 @@ void MediaPlayerImpl::playback()
 		} else {
 			notifyObserver(PLAYER_OBSERVER_COMMAND_FINISHIED);
 		}
-	} else {
+	} else if (num_read < 0) {
 		meddbg("InputDatasource read error\n");
 		notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 		PlayerWorker &mpw = PlayerWorker::getWorker();
@@ -779,6 +817,147 @@ void MediaPlayerImpl::playback()
 	}
 }
 
+bool MediaPlayerImpl::canPlayback()
+{
+#ifdef CONFIG_AUDIO_MIXER
+	/* Only feed the mixer when a whole buffer fits, so that no player blocks the others */
+	return get_audio_mixer_stream_space(mMixerStream) >= get_audio_mixer_period_frames(mMixerStream);
+#else
+	return true;
+#endif
+}
+
+audio_manager_result_t MediaPlayerImpl::openAudioStream()
+{
+	auto source = mInputHandler.getDataSource();
+#ifdef CONFIG_AUDIO_MIXER
+	if (mMixerStream) {
+		return AUDIO_MANAGER_SUCCESS;
+	}
+
+	audio_manager_result_t result = open_audio_mixer_stream(source->getChannels(), source->getSampleRate(),
+															 source->getPcmFormat(), &mMixerStream);
+	if (result != AUDIO_MANAGER_SUCCESS) {
+		return result;
+	}
+
+	return set_audio_mixer_stream_volume(mMixerStream, mVolume);
+#else
+#ifdef CONFIG_MEDIA_PLAYER_DIRECT_OUTPUT
+	/* Until get_audio_stream_out_buffer() tells that the stream is resampled */
+	mDirectOutput = true;
+#endif
+	return set_audio_stream_out(source->getChannels(), source->getSampleRate(), source->getPcmFormat());
+#endif
+}
+
+audio_manager_result_t MediaPlayerImpl::closeAudioStream()
+{
+#ifdef CONFIG_AUDIO_MIXER
+	if (!mMixerStream) {
+		return AUDIO_MANAGER_SUCCESS;
+	}
+
+	audio_mixer_stream_stats_t stats;
+	if (get_audio_mixer_stream_stats(mMixerStream, &stats) == AUDIO_MANAGER_SUCCESS) {
+		medvdbg("MediaPlayer mixed %u frames, %u underruns\n", stats.frames, stats.underruns);
+	}
+
+	audio_manager_result_t result = close_audio_mixer_stream(mMixerStream);
+	mMixerStream = nullptr;
+	return result;
+#else
+	return reset_audio_stream_out();
+#endif
+}
+
+int MediaPlayerImpl::getAudioBufferSize()
+{
+#ifdef CONFIG_AUDIO_MIXER
+	/* One mixer period: small enough to keep the latency of every player low */
+	return get_audio_mixer_period_frames(mMixerStream) * get_audio_mixer_stream_frame_size(mMixerStream);
+#else
+	return get_user_output_frames_to_byte(get_output_frame_count());
+#endif
+}
+
+ssize_t MediaPlayerImpl::feedAudioStream(int *result)
+{
+	unsigned char *data;
+	ssize_t size;
+
+#ifdef CONFIG_MEDIA_PLAYER_DIRECT_OUTPUT
+	if (mDirectOutput) {
+		void *buffer;
+		unsigned int frames = get_user_output_bytes_to_frame(mBufSize);
+
+		*result = get_audio_stream_out_buffer(&buffer, &frames);
+		if (*result == AUDIO_MANAGER_SUCCESS) {
+			/* The data is copied once, from the stream buffer into the device buffer */
+			size = mInputHandler.read((unsigned char *)buffer, get_user_output_frames_to_byte(frames));
+			if (size > 0) {
+				*result = commit_audio_stream_out(get_user_output_bytes_to_frame(size));
+			}
+			return size;
+		}
+
+		if (*result != AUDIO_MANAGER_DEVICE_NOT_SUPPORT) {
+			return 0;
+		}
+
+		medvdbg("Stream is resampled, write it through the audio manager\n");
+		mDirectOutput = false;
+		*result = AUDIO_MANAGER_SUCCESS;
+	}
+#endif
+
+	/* Write from the stream buffer in place, unless the data wraps around its end */
+	size = mInputHandler.getRegion(&data, (size_t)mBufSize);
+	if (size == mBufSize) {
+		*result = writeAudioStream(data, (unsigned int)size);
+		mInputHandler.consume((size_t)size);
+		return size;
+	}
+
+	size = mInputHandler.read(mBuffer, (size_t)mBufSize);
+	if (size > 0) {
+		*result = writeAudioStream(mBuffer, (unsigned int)size);
+	}
+
+	return size;
+}
+
+int MediaPlayerImpl::writeAudioStream(unsigned char *data, unsigned int size)
+{
+#ifdef CONFIG_AUDIO_MIXER
+	return write_audio_mixer_stream(mMixerStream, data, size / get_audio_mixer_stream_frame_size(mMixerStream));
+#else
+	return start_audio_stream_out(data, get_user_output_bytes_to_frame(size));
+#endif
+}
+
+audio_manager_result_t MediaPlayerImpl::pauseAudioStream()
+{
+#ifdef CONFIG_AUDIO_MIXER
+	return pause_audio_mixer_stream(mMixerStream);
+#else
+	return pause_audio_stream_out();
+#endif
+}
+
+audio_manager_result_t MediaPlayerImpl::stopAudioStream()
+{
+#ifdef CONFIG_AUDIO_MIXER
+	/* Like stop_audio_stream_out(): play out what is queued, unless paused */
+	if (mCurState == PLAYER_STATE_PAUSED) {
+		return drop_audio_mixer_stream(mMixerStream);
+	}
+	return drain_audio_mixer_stream(mMixerStream);
+#else
+	return stop_audio_stream_out();
+#endif
+}
+
 MediaPlayerImpl::~MediaPlayerImpl()
 {
 	player_result_t ret;
@@ -19,6 +19,8 @@
 #ifndef __MEDIA_MEDIAPLAYERIMPL_H
 #define __MEDIA_MEDIAPLAYERIMPL_H
 
+#include <tinyara/config.h>
+
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -29,6 +31,7 @@
 
 #include "PlayerObserverWorker.h"
 #include "InputHandler.h"
+#include "audio/audio_manager.h"
 
 namespace media {
 /**
@@ -78,6 +81,8 @@ typedef enum player_observer_command_e {
 	PLAYER_OBSERVER_COMMAND_BUFFER_UPDATED,
 	PLAYER_OBSERVER_COMMAND_BUFFER_STATECHANGED,
 	PLAYER_OBSERVER_COMMAND_BUFFER_DATAREACHED,
+	PLAYER_OBSERVER_COMMAND_SOURCE_BUFFER_LEVEL,
+	PLAYER_OBSERVER_COMMAND_REBUFFERING,
 } player_observer_command_t;
 
 typedef enum player_event_e {
@@ -114,6 +119,7 @@ public:
 	void notifyObserver(player_observer_command_t cmd, ...);
 	void notifyAsync(player_event_t event);
 	void playback();
+	bool canPlayback();
 
 private:
 	void createPlayer(player_result_t &ret);
@@ -130,6 +136,13 @@ private:
 	void setPlayerVolume(uint8_t vol, player_result_t &ret);
 	void setPlayerObserver(std::shared_ptr<MediaPlayerObserverInterface> observer);
 	void setPlayerDataSource(std::shared_ptr<stream::InputDataSource> dataSource, player_result_t &ret);
+	audio_manager_result_t openAudioStream();
+	audio_manager_result_t closeAudioStream();
+	int getAudioBufferSize();
+	ssize_t feedAudioStream(int *result);
+	int writeAudioStream(unsigned char *data, unsigned int size);
+	audio_manager_result_t pauseAudioStream();
+	audio_manager_result_t stopAudioStream();
 
 private:
 	MediaPlayer &mPlayer;
@@ -141,6 +154,13 @@ private:
 	std::shared_ptr<stream_info_t> mStreamInfo;
 	std::shared_ptr<MediaPlayerObserverInterface> mPlayerObserver;
 	stream::InputHandler mInputHandler;
+#ifdef CONFIG_AUDIO_MIXER
+	audio_mixer_stream_t mMixerStream;
+	uint8_t mVolume;
+#endif
+#ifdef CONFIG_MEDIA_PLAYER_DIRECT_OUTPUT
+	bool mDirectOutput;
+#endif
 };
 } // namespace media
 #endif
@@ -18,6 +18,7 @@
 
 #include <tinyara/config.h>
 #include <debug.h>
+#include <algorithm>
 
 #include "PlayerWorker.h"
 #include "MediaPlayerImpl.h"
@@ -47,12 +48,39 @@ PlayerWorker& PlayerWorker::getWorker()
 
 bool PlayerWorker::processLoop()
 {
+#ifdef CONFIG_AUDIO_MIXER
+	bool playing = false;
+	bool progressed = false;
+
+	/* playback() may stop its player and remove it from the list */
+	for (size_t i = 0; i < mPlayers.size();) {
+		auto player = mPlayers[i];
+		if (player->getState() == PLAYER_STATE_PLAYING) {
+			playing = true;
+			if (player->canPlayback()) {
+				player->playback();
+				progressed = true;
+			}
+		}
+		if (i < mPlayers.size() && mPlayers[i] == player) {
+			i++;
+		}
+	}
+
+	if (playing && !progressed) {
+		/* Every stream is full: sleep until the mixer takes a period */
+		wait_audio_mixer_period();
+	}
+
+	return playing;
+#else
 	if (mCurPlayer && (mCurPlayer->getState() == PLAYER_STATE_PLAYING)) {
 		mCurPlayer->playback();
 		return true;
 	}
 
 	return false;
+#endif
 }
 
 void PlayerWorker::setPlayer(std::shared_ptr<MediaPlayerImpl> player)
@@ -65,4 +93,18 @@ std::shared_ptr<MediaPlayerImpl> PlayerWorker::getPlayer()
 	return mCurPlayer;
 }
 
+#ifdef CONFIG_AUDIO_MIXER
+void PlayerWorker::addPlayer(std::shared_ptr<MediaPlayerImpl> player)
+{
+	if (std::find(mPlayers.begin(), mPlayers.end(), player) == mPlayers.end()) {
+		mPlayers.push_back(player);
+	}
+}
+
+void PlayerWorker::removePlayer(std::shared_ptr<MediaPlayerImpl> player)
+{
+	mPlayers.erase(std::remove(mPlayers.begin(), mPlayers.end(), player), mPlayers.end());
+}
+#endif
+
 } // namespace media
@@ -19,7 +19,10 @@
 #ifndef __MEDIA_PLAYERWORKER_HPP
 #define __MEDIA_PLAYERWORKER_HPP
 
+#include <tinyara/config.h>
+
 #include <memory>
+#include <vector>
 #include <media/MediaPlayer.h>
 #include "MediaWorker.h"
 
@@ -31,6 +34,10 @@ public:
 
 	void setPlayer(std::shared_ptr<MediaPlayerImpl>);
 	std::shared_ptr<MediaPlayerImpl> getPlayer();
+#ifdef CONFIG_AUDIO_MIXER
+	void addPlayer(std::shared_ptr<MediaPlayerImpl>);
+	void removePlayer(std::shared_ptr<MediaPlayerImpl>);
+#endif
 
 private:
 	PlayerWorker();
@@ -39,6 +46,10 @@ private:
 
 private:
 	std::shared_ptr<MediaPlayerImpl> mCurPlayer;
+#ifdef CONFIG_AUDIO_MIXER
+	/* Players fed to the mixer, in turn */
+	std::vector<std::shared_ptr<MediaPlayerImpl>> mPlayers;
+#endif
 };
 } // namespace media
 #endif
@@ -92,6 +92,21 @@ size_t StreamBuffer::write(unsigned char *buf, size_t size)
 	return rb_write(&mRingBuf, buf, size);
 }
 
+size_t StreamBuffer::readRegion(unsigned char **region)
+{
+	return rb_read_region(&mRingBuf, (void **)region);
+}
+
+size_t StreamBuffer::writeRegion(unsigned char **region)
+{
+	return rb_write_region(&mRingBuf, (void **)region);
+}
+
+size_t StreamBuffer::commit(size_t size)
+{
+	return rb_write_commit(&mRingBuf, size);
+}
+
 size_t StreamBuffer::sizeOfSpace()
 {
 	return rb_avail(&mRingBuf);
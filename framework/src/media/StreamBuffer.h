@@ -87,6 +87,22 @@ public:
 	 * Write(push) data into stream buffer.
 	 */
 	size_t write(unsigned char *buf, size_t size);
+	/**
+	 * Get a view of the data at the read position without copying it.
+	 * Returns the size of the view, which ends early where the data wraps
+	 * around the end of the ring buffer. Release it with read(nullptr, size).
+	 */
+	size_t readRegion(unsigned char **region);
+	/**
+	 * Get a view of the free space at the write position, for data to be
+	 * produced in place. Returns the size of the view, which ends early
+	 * where the space wraps around. Publish the data with commit().
+	 */
+	size_t writeRegion(unsigned char **region);
+	/**
+	 * Push data written through writeRegion() into stream buffer.
+	 */
+	size_t commit(size_t size);
 	/**
 	 * Get bytes of data available in stream buffer.
 	 */
@@ -17,6 +17,7 @@
  ******************************************************************/
 
 #include <iostream>
+#include <algorithm>
 #include <stdio.h>
 #include <assert.h>
 #include <debug.h>
@@ -86,6 +87,38 @@ size_t StreamBufferReader::read(unsigned char *buf, size_t size, bool sync)
 	return rlen;
 }
 
+size_t StreamBufferReader::getRegion(unsigned char **region, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	std::unique_lock<std::mutex> lock(mStream->getMutex());
+
+	if (sync) {
+		// The whole buffer is the most that can ever be waited for
+		size_t wanted = std::min(size, mStream->getBufferSize());
+		while (mStream->sizeOfData() < wanted && !mStream->isEndOfStream()) {
+			medvdbg("buffered %lu/%lu\n", mStream->sizeOfData(), wanted);
+			mStream->notifyObserver(StreamBuffer::State::UNDERRUN);
+			mStream->getCondv().notify_one();
+			mStream->getCondv().wait(lock);
+		}
+	}
+
+	size_t rlen = std::min(mStream->readRegion(region), size);
+	medvdbg("region %lu\n", rlen);
+	return rlen;
+}
+
+size_t StreamBufferReader::consume(size_t size)
+{
+	std::lock_guard<std::mutex> lock(mStream->getMutex());
+	size_t rlen = mStream->read(nullptr, size);
+	mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) rlen));
+
+	// Writer may be waiting for more spaces, so it's necessary to notify after reading.
+	mStream->getCondv().notify_one();
+	return rlen;
+}
+
 size_t StreamBufferReader::sizeOfData()
 {
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
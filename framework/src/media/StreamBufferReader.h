@@ -34,6 +34,14 @@ public:
 	virtual size_t copy(unsigned char *buf, size_t size, size_t offset = 0);
 	virtual size_t read(unsigned char *buf, size_t size, bool sync = true);
 	virtual size_t sizeOfData();
+	/**
+	 * Get a view of up to 'size' bytes at the read position, instead of
+	 * copying them. With 'sync', waits until 'size' bytes are buffered or
+	 * the end of stream. The view can be shorter than the data where it
+	 * wraps around the end of the buffer. Data stays buffered until consume().
+	 */
+	virtual size_t getRegion(unsigned char **region, size_t size, bool sync = true);
+	virtual size_t consume(size_t size);
 
 public:
 	bool isEndOfStream();
@@ -76,6 +76,57 @@ size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
 	return wlen;
 }
 
+size_t StreamBufferWriter::getRegion(unsigned char **region, bool sync)
+{
+	std::unique_lock<std::mutex> lock(mStream->getMutex());
+
+	while (!mStream->isEndOfStream()) {
+		size_t wlen = mStream->writeRegion(region);
+		if (wlen > 0 || !sync) {
+			medvdbg("region %lu\n", wlen);
+			return wlen;
+		}
+
+		// There's no space, wait notification from reader.
+		mStream->notifyObserver(StreamBuffer::State::OVERRUN);
+		mStream->getCondv().notify_one();
+		mStream->getCondv().wait(lock);
+	}
+
+	// Streaming may be stopped (EOS was set)
+	medvdbg("EOS break\n");
+	return 0;
+}
+
+size_t StreamBufferWriter::commit(size_t size)
+{
+	std::lock_guard<std::mutex> lock(mStream->getMutex());
+	size_t wlen = mStream->commit(size);
+	mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) wlen);
+
+	// Reader may be waiting for more data, so it's necessary to notify after writing.
+	mStream->getCondv().notify_one();
+	return wlen;
+}
+
+bool StreamBufferWriter::waitForSpace(size_t size)
+{
+	std::unique_lock<std::mutex> lock(mStream->getMutex());
+
+	while (!mStream->isEndOfStream()) {
+		if (mStream->sizeOfSpace() >= size) {
+			return true;
+		}
+
+		// Reader may be waiting for more data, then wait notification from reader.
+		mStream->getCondv().notify_one();
+		mStream->getCondv().wait(lock);
+	}
+
+	medvdbg("EOS break\n");
+	return false;
+}
+
 size_t StreamBufferWriter::sizeOfSpace()
 {
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
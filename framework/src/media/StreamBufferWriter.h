@@ -33,6 +33,22 @@ public:
 public:
 	virtual size_t write(unsigned char *buf, size_t size, bool sync = true);
 	virtual size_t sizeOfSpace();
+	/**
+	 * Get a view of the free space at the write position, for data to be
+	 * produced in place. With 'sync', waits for space unless the end of
+	 * stream was set, in which case nothing is returned. The view can be
+	 * shorter than the space where it wraps around the end of the buffer.
+	 */
+	virtual size_t getRegion(unsigned char **region, bool sync = true);
+	/**
+	 * Push 'size' bytes written through getRegion() into the stream.
+	 */
+	virtual size_t commit(size_t size);
+	/**
+	 * Wait until 'size' bytes can be written without blocking. Returns false
+	 * if the end of stream was set.
+	 */
+	virtual bool waitForSpace(size_t size);
 
 public:
 	void setEndOfStream();
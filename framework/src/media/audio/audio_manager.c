@@ -24,6 +24,8 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <time.h>
+#include <unistd.h>
 #include <sys/ioctl.h>
 #include <sys/time.h>
 #include <sys/stat.h>
@@ -98,6 +100,36 @@
 
 #define INVALID_ID -1
 
+#ifdef CONFIG_AUDIO_MIXER
+#ifndef CONFIG_AUDIO_MIXER_SAMPLE_RATE
+#define CONFIG_AUDIO_MIXER_SAMPLE_RATE AUDIO_SAMP_RATE_48K
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_PERIOD_FRAMES
+#define CONFIG_AUDIO_MIXER_PERIOD_FRAMES 256
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_PERIOD_COUNT
+#define CONFIG_AUDIO_MIXER_PERIOD_COUNT 3
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_STREAM_PERIODS
+#define CONFIG_AUDIO_MIXER_STREAM_PERIODS 4
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_STACKSIZE
+#define CONFIG_AUDIO_MIXER_STACKSIZE 2048
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_PRIORITY
+#define CONFIG_AUDIO_MIXER_PRIORITY 150
+#endif
+
+#define AUDIO_MIXER_GAIN_SHIFT 15
+#define AUDIO_MIXER_UNITY_GAIN (1 << AUDIO_MIXER_GAIN_SHIFT)
+#define AUDIO_MIXER_MAX_CHANNELS 8
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -176,6 +208,56 @@ static const struct audio_samprate_map_entry_s g_audio_samprate_entry[] = {
 	{AUDIO_SAMP_RATE_TYPE_96K, AUDIO_SAMP_RATE_96K}
 };
 
+#ifdef CONFIG_AUDIO_MIXER
+struct audio_mixer_stream_s {
+	struct audio_mixer_stream_s *next;
+	/* user provided */
+	unsigned int channels;
+	unsigned int sample_rate;
+	enum pcm_format format;
+	unsigned int sample_bytes;  // bytes per sample of user format
+	/* conversion to the mixer format */
+	int16_t *conv;              // user frames converted to 16 bits and mixer channels
+	unsigned int conv_frames;
+	src_handle_t src;           // resampler, NULL if the rate matches the mixer
+	int16_t *resampled;
+	unsigned int resampled_frames;
+	/* frames waiting to be mixed, in the mixer format */
+	int16_t *ring;
+	unsigned int ring_frames;
+	unsigned int head;
+	unsigned int count;
+	uint32_t gain;              // Q15, AUDIO_MIXER_UNITY_GAIN leaves samples as they are
+	uint8_t volume;
+	bool started;               // written to since opened or drained
+	bool paused;
+	bool draining;
+	audio_mixer_stream_stats_t stats;
+};
+
+struct audio_mixer_s {
+	pthread_mutex_t ctrl_lock;  // serializes opening and closing of streams
+	pthread_mutex_t lock;       // protects the stream list and rings
+	pthread_cond_t cond;        // signaled whenever data is queued or mixed
+	pthread_t thread;
+	bool running;
+	struct audio_mixer_stream_s *streams;
+	unsigned int nstreams;
+	unsigned int rate;
+	unsigned int channels;
+	int32_t *acc;               // one period summed over all streams
+	int16_t *period;            // the same period clipped for the card
+	uint32_t periods;           // periods handed to the card so far
+	uint32_t xruns;             // underruns of the card itself
+};
+
+static struct audio_mixer_s g_audio_mixer = {
+	.ctrl_lock = PTHREAD_MUTEX_INITIALIZER,
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -789,7 +871,12 @@ audio_manager_result_t set_audio_stream_out(unsigned int channels, unsigned int
 	config.channels = channel_num;
 	medvdbg("[OUT] Device samplerate: %u, User requested: %u\n", config.rate, sample_rate);
 	medvdbg("[OUT] Device channel: %u, User requested: %u\n", config.channels, channels);
+#ifdef CONFIG_MEDIA_PLAYER_DIRECT_OUTPUT
+	/* mmap access also keeps pcm_writei() working, for resampled streams */
+	card->pcm = pcm_open(g_actual_audio_out_card_id, card->device_id, PCM_OUT | PCM_MMAP, &config);
+#else
 	card->pcm = pcm_open(g_actual_audio_out_card_id, card->device_id, PCM_OUT, &config);
+#endif
 
 	if (!pcm_is_ready(card->pcm)) {
 		meddbg("fail to pcm_is_ready() error : %s", pcm_get_error(card->pcm));
@@ -1013,6 +1100,115 @@ error_with_lock:
 	return ret;
 }
 
+#ifdef CONFIG_MEDIA_PLAYER_DIRECT_OUTPUT
+audio_manager_result_t get_audio_stream_out_buffer(void **data, unsigned int *frames)
+{
+	audio_manager_result_t ret = AUDIO_MANAGER_SUCCESS;
+	int prepare_retry = AUDIO_STREAM_RETRY_COUNT;
+	audio_card_info_t *card;
+	unsigned int offset;
+	unsigned int nframes;
+	void *area;
+	int result;
+
+	if ((data == NULL) || (frames == NULL) || (*frames == 0)) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	if (g_actual_audio_out_card_id < 0) {
+		meddbg("Found no active output audio card\n");
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	card = &g_audio_out_cards[g_actual_audio_out_card_id];
+
+	if ((card->config[card->device_id].status == AUDIO_CARD_IDLE) || (card->config[card->device_id].status == AUDIO_CARD_NONE)) {
+		meddbg("Card status is wrong status : %d\n", card->config[card->device_id].status);
+		return AUDIO_MANAGER_INVALID_DEVICE;
+	}
+
+	/* Resampled data can not be produced in place */
+	if (card->resample.necessary) {
+		return AUDIO_MANAGER_DEVICE_NOT_SUPPORT;
+	}
+
+	pthread_mutex_lock(&(card->card_mutex));
+
+	if (card->config[card->device_id].status == AUDIO_CARD_PAUSE) {
+		if (ioctl(pcm_get_file_descriptor(card->pcm), AUDIOIOC_RESUME, 0UL) < 0) {
+			meddbg("Fail to ioctl AUDIOIOC_RESUME\n");
+			ret = AUDIO_MANAGER_DEVICE_FAIL;
+			goto error_with_lock;
+		}
+	}
+
+	card->config[card->device_id].status = AUDIO_CARD_RUNNING;
+
+	while (1) {
+		nframes = *frames;
+		result = pcm_mmap_begin(card->pcm, &area, &offset, &nframes);
+		if (result < 0) {
+			meddbg("pcm_mmap_begin failed, ret = %d\n", result);
+			ret = AUDIO_MANAGER_OPERATION_FAIL;
+			break;
+		}
+
+		if (nframes > 0) {
+			*data = (uint8_t *)area + pcm_frames_to_bytes(card->pcm, offset);
+			*frames = nframes;
+			break;
+		}
+
+		/* Every buffer is queued, wait until the device gives one back */
+		result = pcm_wait(card->pcm, -1);
+		if (result == -EPIPE) {
+			if (prepare_retry-- == 0 || pcm_prepare(card->pcm) != OK) {
+				meddbg("Fail to pcm_prepare()\n");
+				ret = AUDIO_MANAGER_XRUN_STATE;
+				break;
+			}
+		} else if (result < 0) {
+			meddbg("pcm_wait failed, ret = %d\n", result);
+			ret = AUDIO_MANAGER_OPERATION_FAIL;
+			break;
+		}
+	}
+
+error_with_lock:
+	pthread_mutex_unlock(&(card->card_mutex));
+	return ret;
+}
+
+int commit_audio_stream_out(unsigned int frames)
+{
+	audio_card_info_t *card;
+	int ret;
+
+	if (g_actual_audio_out_card_id < 0) {
+		meddbg("Found no active output audio card\n");
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	if (frames == 0) {
+		/* The buffer is handed out again by the next get_audio_stream_out_buffer() */
+		return 0;
+	}
+
+	card = &g_audio_out_cards[g_actual_audio_out_card_id];
+
+	pthread_mutex_lock(&(card->card_mutex));
+	ret = pcm_mmap_commit(card->pcm, 0, frames);
+	pthread_mutex_unlock(&(card->card_mutex));
+
+	if (ret < 0) {
+		meddbg("pcm_mmap_commit failed, ret = %d\n", ret);
+		return ret == -EPIPE ? AUDIO_MANAGER_XRUN_STATE : AUDIO_MANAGER_OPERATION_FAIL;
+	}
+
+	return frames;
+}
+#endif
+
 static audio_manager_result_t pause_audio_stream(audio_io_direction_t direct)
 {
 	audio_manager_result_t ret;
@@ -1899,6 +2095,737 @@ audio_manager_result_t get_stream_out_policy(stream_policy_t *policy)
 	return get_stream_policy(policy, OUTPUT);
 }
 
+#ifdef CONFIG_AUDIO_MIXER
+/****************************************************************************
+ * Audio Mixer
+ *
+ * Streams opened with open_audio_mixer_stream() are converted to the mixer
+ * format (16 bits, card channels, mixer rate) when they are written and
+ * queued in a ring per stream. A mixer thread takes one fixed period from
+ * every ring, sums them with the gain of each stream and writes the result
+ * to the output card, which it keeps open for as long as any stream is.
+ ****************************************************************************/
+
+/* Private Functions */
+
+static inline int16_t audio_mixer_get_sample(const uint8_t *src, enum pcm_format format)
+{
+	switch (format) {
+	case PCM_FORMAT_S8:
+		return (int16_t)((int8_t)src[0] << 8);
+	case PCM_FORMAT_S16_BE:
+		return (int16_t)((src[0] << 8) | src[1]);
+	case PCM_FORMAT_S24_LE:
+	case PCM_FORMAT_S24_3LE:
+		return (int16_t)((src[2] << 8) | src[1]);
+	case PCM_FORMAT_S24_BE:
+		return (int16_t)((src[1] << 8) | src[2]);
+	case PCM_FORMAT_S24_3BE:
+		return (int16_t)((src[0] << 8) | src[1]);
+	case PCM_FORMAT_S32_LE:
+		return (int16_t)((src[3] << 8) | src[2]);
+	case PCM_FORMAT_S32_BE:
+		return (int16_t)((src[0] << 8) | src[1]);
+	case PCM_FORMAT_S16_LE:
+	default:
+		return (int16_t)((src[1] << 8) | src[0]);
+	}
+}
+
+/*
+ * Convert frames of the stream format into 16 bit frames with the channel
+ * count of the mixer. Missing channels repeat the existing ones, and a mono
+ * mixer gets the average of all stream channels.
+ */
+static void audio_mixer_convert(audio_mixer_stream_t stream, const uint8_t *src, unsigned int frames, int16_t *dst)
+{
+	unsigned int in_channels = stream->channels;
+	unsigned int out_channels = g_audio_mixer.channels;
+	unsigned int in_sample = stream->sample_bytes;
+	unsigned int i;
+	unsigned int c;
+
+	if (stream->format == PCM_FORMAT_S16_LE && in_channels == out_channels) {
+		memcpy(dst, src, frames * out_channels * sizeof(int16_t));
+		return;
+	}
+
+	for (i = 0; i < frames; i++) {
+		if (out_channels == 1 && in_channels > 1) {
+			int32_t sum = 0;
+			for (c = 0; c < in_channels; c++) {
+				sum += audio_mixer_get_sample(src + c * in_sample, stream->format);
+			}
+			*dst++ = (int16_t)(sum / (int32_t)in_channels);
+		} else {
+			for (c = 0; c < out_channels; c++) {
+				*dst++ = audio_mixer_get_sample(src + (c % in_channels) * in_sample, stream->format);
+			}
+		}
+		src += in_channels * in_sample;
+	}
+}
+
+/* Copy frames into the ring of the stream, waiting for room. Called with the mixer locked. */
+static audio_manager_result_t audio_mixer_queue(audio_mixer_stream_t stream, const int16_t *src, unsigned int frames)
+{
+	unsigned int channels = g_audio_mixer.channels;
+	unsigned int tail;
+	unsigned int n;
+
+	while (frames > 0) {
+		while (stream->count == stream->ring_frames) {
+			if (!g_audio_mixer.running) {
+				return AUDIO_MANAGER_DEVICE_FAIL;
+			}
+			pthread_cond_wait(&g_audio_mixer.cond, &g_audio_mixer.lock);
+		}
+
+		tail = (stream->head + stream->count) % stream->ring_frames;
+		n = stream->ring_frames - stream->count;
+		if (n > stream->ring_frames - tail) {
+			n = stream->ring_frames - tail;
+		}
+		if (n > frames) {
+			n = frames;
+		}
+
+		memcpy(stream->ring + tail * channels, src, n * channels * sizeof(int16_t));
+		stream->count += n;
+		src += n * channels;
+		frames -= n;
+
+		pthread_cond_broadcast(&g_audio_mixer.cond);
+	}
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+static void audio_mixer_accumulate(int32_t *acc, const int16_t *src, unsigned int samples, uint32_t gain)
+{
+	unsigned int i;
+
+	if (gain == AUDIO_MIXER_UNITY_GAIN) {
+		for (i = 0; i < samples; i++) {
+			acc[i] += src[i];
+		}
+	} else {
+		for (i = 0; i < samples; i++) {
+			acc[i] += (src[i] * (int32_t)gain) >> AUDIO_MIXER_GAIN_SHIFT;
+		}
+	}
+}
+
+/* Whether the mixer has anything to play. Called with the mixer locked. */
+static bool audio_mixer_has_data(void)
+{
+	audio_mixer_stream_t stream;
+
+	for (stream = g_audio_mixer.streams; stream != NULL; stream = stream->next) {
+		if (!stream->paused && stream->count > 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Count an underrun for every stream that is being played but has nothing queued. Called with the mixer locked. */
+static void audio_mixer_count_starved(void)
+{
+	audio_mixer_stream_t stream;
+
+	for (stream = g_audio_mixer.streams; stream != NULL; stream = stream->next) {
+		if (stream->started && !stream->paused && !stream->draining && stream->count == 0) {
+			stream->stats.underruns++;
+		}
+	}
+}
+
+/*
+ * Take one period from every stream, sum it and clip it into the output
+ * period. A stream that is played but delivers less than a period is
+ * padded with silence and charged an underrun, except while it is drained.
+ * Called with the mixer locked.
+ */
+static void audio_mixer_mix_period(void)
+{
+	unsigned int channels = g_audio_mixer.channels;
+	unsigned int samples = CONFIG_AUDIO_MIXER_PERIOD_FRAMES * channels;
+	audio_mixer_stream_t stream;
+	unsigned int frames;
+	unsigned int n;
+	unsigned int i;
+	int32_t value;
+
+	memset(g_audio_mixer.acc, 0, samples * sizeof(int32_t));
+
+	for (stream = g_audio_mixer.streams; stream != NULL; stream = stream->next) {
+		if (stream->paused || (!stream->started && stream->count == 0)) {
+			continue;
+		}
+
+		frames = stream->count < CONFIG_AUDIO_MIXER_PERIOD_FRAMES ? stream->count : CONFIG_AUDIO_MIXER_PERIOD_FRAMES;
+		if (frames < CONFIG_AUDIO_MIXER_PERIOD_FRAMES && !stream->draining) {
+			stream->stats.underruns++;
+			stream->stats.silent_frames += CONFIG_AUDIO_MIXER_PERIOD_FRAMES - frames;
+		}
+
+		/* At most two spans: up to the end of the ring, then from its start */
+
+		for (i = 0; i < frames; i += n) {
+			n = frames - i;
+			if (n > stream->ring_frames - stream->head) {
+				n = stream->ring_frames - stream->head;
+			}
+			audio_mixer_accumulate(g_audio_mixer.acc + i * channels, stream->ring + stream->head * channels, n * channels, stream->gain);
+			stream->head = (stream->head + n) % stream->ring_frames;
+		}
+
+		stream->count -= frames;
+		stream->stats.frames += frames;
+	}
+
+	for (i = 0; i < samples; i++) {
+		value = g_audio_mixer.acc[i];
+		if (value > INT16_MAX) {
+			value = INT16_MAX;
+		} else if (value < INT16_MIN) {
+			value = INT16_MIN;
+		}
+		g_audio_mixer.period[i] = (int16_t)value;
+	}
+
+	g_audio_mixer.periods++;
+	pthread_cond_broadcast(&g_audio_mixer.cond);
+}
+
+static int audio_mixer_write_period(struct pcm *pcm)
+{
+	int prepare_retry = AUDIO_STREAM_RETRY_COUNT;
+	int ret;
+
+	do {
+		ret = pcm_writei(pcm, g_audio_mixer.period, CONFIG_AUDIO_MIXER_PERIOD_FRAMES);
+		if (ret == -EPIPE) {
+			/* The card ran dry while no stream had data: start it again */
+
+			g_audio_mixer.xruns++;
+			if (prepare_retry-- == 0 || pcm_prepare(pcm) != OK) {
+				meddbg("Fail to pcm_prepare()\n");
+				return AUDIO_MANAGER_XRUN_STATE;
+			}
+			ret = 0;
+		} else if (ret < 0) {
+			meddbg("pcm_writei failed, ret = %d\n", ret);
+			return AUDIO_MANAGER_OPERATION_FAIL;
+		}
+	} while (ret == 0);
+
+	return ret;
+}
+
+static void *audio_mixer_thread(void *arg)
+{
+	audio_card_info_t *card = (audio_card_info_t *)arg;
+	bool idle = false;
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	while (g_audio_mixer.running) {
+		if (!audio_mixer_has_data()) {
+			if (!idle) {
+				audio_mixer_count_starved();
+				idle = true;
+			}
+			pthread_cond_wait(&g_audio_mixer.cond, &g_audio_mixer.lock);
+			continue;
+		}
+		idle = false;
+
+		audio_mixer_mix_period();
+
+		/* The card blocks until a period is free: let writers fill their rings meanwhile */
+
+		pthread_mutex_unlock(&g_audio_mixer.lock);
+		if (audio_mixer_write_period(card->pcm) < 0) {
+			usleep(CONFIG_AUDIO_MIXER_PERIOD_FRAMES * 1000000ULL / g_audio_mixer.rate);
+		}
+		pthread_mutex_lock(&g_audio_mixer.lock);
+	}
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	return NULL;
+}
+
+/* Open the output card with the fixed mixer period and start the mixer thread. Called with the control lock held. */
+static audio_manager_result_t audio_mixer_start(void)
+{
+	audio_card_info_t *card;
+	struct pcm_config config;
+	struct sched_param sparam;
+	pthread_attr_t attr;
+	audio_manager_result_t ret;
+	unsigned int channel_num;
+	unsigned int samples;
+
+	if (g_actual_audio_out_card_id < 0) {
+		meddbg("Found no active output audio card\n");
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	card = &g_audio_out_cards[g_actual_audio_out_card_id];
+	if (card->config[card->device_id].status != AUDIO_CARD_IDLE) {
+		meddbg("Output card is in use, status : %d\n", card->config[card->device_id].status);
+		return AUDIO_MANAGER_DEVICE_ALREADY_IN_USE;
+	}
+
+	ret = get_supported_capability(OUTPUT, &channel_num);
+	if (ret != AUDIO_MANAGER_SUCCESS) {
+		return ret;
+	}
+
+	pthread_mutex_lock(&(card->card_mutex));
+
+	memset(&config, 0, sizeof(struct pcm_config));
+	config.rate = get_closest_samprate(CONFIG_AUDIO_MIXER_SAMPLE_RATE, OUTPUT);
+	config.format = PCM_FORMAT_S16_LE;
+	config.period_size = CONFIG_AUDIO_MIXER_PERIOD_FRAMES;
+	config.period_count = CONFIG_AUDIO_MIXER_PERIOD_COUNT;
+	config.channels = channel_num;
+	card->pcm = pcm_open(g_actual_audio_out_card_id, card->device_id, PCM_OUT, &config);
+	if (!pcm_is_ready(card->pcm)) {
+		meddbg("fail to pcm_is_ready() error : %s", pcm_get_error(card->pcm));
+		ret = AUDIO_MANAGER_CARD_NOT_READY;
+		goto errout_with_pcm;
+	}
+
+	/* Streams are converted by the mixer, the card itself is used as is */
+
+	card->resample.necessary = false;
+	card->resample.user_channel = config.channels;
+	card->resample.user_sample_rate = config.rate;
+	card->resample.user_format = sizeof(int16_t);
+
+	g_audio_mixer.rate = config.rate;
+	g_audio_mixer.channels = config.channels;
+	samples = CONFIG_AUDIO_MIXER_PERIOD_FRAMES * config.channels;
+	g_audio_mixer.acc = (int32_t *)malloc(samples * sizeof(int32_t));
+	g_audio_mixer.period = (int16_t *)malloc(samples * sizeof(int16_t));
+	if (!g_audio_mixer.acc || !g_audio_mixer.period) {
+		meddbg("malloc for the mixer period failed\n");
+		ret = AUDIO_MANAGER_OPERATION_FAIL;
+		goto errout_with_buffers;
+	}
+
+	g_audio_mixer.running = true;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, CONFIG_AUDIO_MIXER_STACKSIZE);
+	sparam.sched_priority = CONFIG_AUDIO_MIXER_PRIORITY;
+	pthread_attr_setschedparam(&attr, &sparam);
+	if (pthread_create(&g_audio_mixer.thread, &attr, audio_mixer_thread, card) != OK) {
+		meddbg("Fail to create the mixer thread\n");
+		g_audio_mixer.running = false;
+		ret = AUDIO_MANAGER_OPERATION_FAIL;
+		goto errout_with_buffers;
+	}
+	pthread_setname_np(g_audio_mixer.thread, "AudioMixer");
+
+	card->config[card->device_id].status = AUDIO_CARD_RUNNING;
+	pthread_mutex_unlock(&(card->card_mutex));
+	medvdbg("Mixer started: rate %u channels %u period %u x %u\n", config.rate, config.channels, config.period_size, config.period_count);
+	return AUDIO_MANAGER_SUCCESS;
+
+errout_with_buffers:
+	free(g_audio_mixer.acc);
+	free(g_audio_mixer.period);
+	g_audio_mixer.acc = NULL;
+	g_audio_mixer.period = NULL;
+errout_with_pcm:
+	pcm_close(card->pcm);
+	card->pcm = NULL;
+	pthread_mutex_unlock(&(card->card_mutex));
+	return ret;
+}
+
+/* Stop the mixer thread, play out what the card holds and release it. Called with the control lock held. */
+static void audio_mixer_stop(void)
+{
+	audio_card_info_t *card = &g_audio_out_cards[g_actual_audio_out_card_id];
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	g_audio_mixer.running = false;
+	pthread_cond_broadcast(&g_audio_mixer.cond);
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+	pthread_join(g_audio_mixer.thread, NULL);
+
+	pthread_mutex_lock(&(card->card_mutex));
+	if (pcm_drain(card->pcm) < 0) {
+		medvdbg("pcm_drain failed\n");
+	}
+	pcm_close(card->pcm);
+	card->pcm = NULL;
+	card->config[card->device_id].status = AUDIO_CARD_IDLE;
+	pthread_mutex_unlock(&(card->card_mutex));
+
+	free(g_audio_mixer.acc);
+	free(g_audio_mixer.period);
+	g_audio_mixer.acc = NULL;
+	g_audio_mixer.period = NULL;
+	medvdbg("Mixer stopped, %u periods, %u card underruns\n", g_audio_mixer.periods, g_audio_mixer.xruns);
+}
+
+static void audio_mixer_free_stream(audio_mixer_stream_t stream)
+{
+	if (stream->src) {
+		src_destroy(stream->src);
+	}
+	free(stream->resampled);
+	free(stream->conv);
+	free(stream->ring);
+	free(stream);
+}
+
+/* Public Functions */
+
+audio_manager_result_t open_audio_mixer_stream(unsigned int channels, unsigned int sample_rate, int format, audio_mixer_stream_t *stream)
+{
+	audio_mixer_stream_t new_stream;
+	audio_manager_result_t ret = AUDIO_MANAGER_SUCCESS;
+	unsigned int bits;
+
+	if (!stream || channels == 0 || channels > AUDIO_MIXER_MAX_CHANNELS || sample_rate == 0) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	bits = pcm_format_to_bits((enum pcm_format)format);
+	if (bits == 0 || format == PCM_FORMAT_NONE) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	new_stream = (audio_mixer_stream_t)zalloc(sizeof(struct audio_mixer_stream_s));
+	if (!new_stream) {
+		return AUDIO_MANAGER_OPERATION_FAIL;
+	}
+
+	new_stream->channels = channels;
+	new_stream->sample_rate = sample_rate;
+	new_stream->format = (enum pcm_format)format;
+	new_stream->sample_bytes = (format == PCM_FORMAT_S24_3LE || format == PCM_FORMAT_S24_3BE) ? 3 : bits >> 3;
+	new_stream->volume = AUDIO_DEVICE_MAX_VOLUME;
+	new_stream->gain = AUDIO_MIXER_UNITY_GAIN;
+
+	pthread_mutex_lock(&g_audio_mixer.ctrl_lock);
+
+	if (g_audio_mixer.nstreams == 0) {
+		ret = audio_mixer_start();
+		if (ret != AUDIO_MANAGER_SUCCESS) {
+			goto errout_with_lock;
+		}
+	}
+
+	/* The ring and the conversion buffers depend on the card format the mixer settled on */
+
+	new_stream->ring_frames = CONFIG_AUDIO_MIXER_PERIOD_FRAMES * CONFIG_AUDIO_MIXER_STREAM_PERIODS;
+	new_stream->ring = (int16_t *)malloc(new_stream->ring_frames * g_audio_mixer.channels * sizeof(int16_t));
+	new_stream->conv_frames = CONFIG_AUDIO_MIXER_PERIOD_FRAMES;
+	new_stream->conv = (int16_t *)malloc(new_stream->conv_frames * g_audio_mixer.channels * sizeof(int16_t));
+	if (!new_stream->ring || !new_stream->conv) {
+		ret = AUDIO_MANAGER_OPERATION_FAIL;
+		goto errout_with_mixer;
+	}
+
+	if (sample_rate != g_audio_mixer.rate) {
+		new_stream->src = src_init(CONFIG_AUDIO_RESAMPLER_BUFSIZE);
+		new_stream->resampled_frames = CONFIG_AUDIO_MIXER_PERIOD_FRAMES;
+		new_stream->resampled = (int16_t *)malloc(new_stream->resampled_frames * g_audio_mixer.channels * sizeof(int16_t));
+		if (!new_stream->src || !new_stream->resampled) {
+			meddbg("Fail to set up resampling %u -> %u\n", sample_rate, g_audio_mixer.rate);
+			ret = AUDIO_MANAGER_RESAMPLE_FAIL;
+			goto errout_with_mixer;
+		}
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	new_stream->next = g_audio_mixer.streams;
+	g_audio_mixer.streams = new_stream;
+	g_audio_mixer.nstreams++;
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	pthread_mutex_unlock(&g_audio_mixer.ctrl_lock);
+
+	medvdbg("Mixer stream %p: %u ch, %u Hz, format %d\n", new_stream, channels, sample_rate, format);
+	*stream = new_stream;
+	return AUDIO_MANAGER_SUCCESS;
+
+errout_with_mixer:
+	if (g_audio_mixer.nstreams == 0) {
+		audio_mixer_stop();
+	}
+errout_with_lock:
+	pthread_mutex_unlock(&g_audio_mixer.ctrl_lock);
+	audio_mixer_free_stream(new_stream);
+	return ret;
+}
+
+int write_audio_mixer_stream(audio_mixer_stream_t stream, const void *data, unsigned int frames)
+{
+	const uint8_t *src = (const uint8_t *)data;
+	unsigned int frame_bytes;
+	unsigned int done = 0;
+	unsigned int chunk;
+	unsigned int used;
+	audio_manager_result_t ret = AUDIO_MANAGER_SUCCESS;
+	src_data_t srcData = { 0, };
+
+	if (!stream || !data) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	frame_bytes = stream->channels * stream->sample_bytes;
+
+	while (done < frames && ret == AUDIO_MANAGER_SUCCESS) {
+		chunk = frames - done;
+		if (chunk > stream->conv_frames) {
+			chunk = stream->conv_frames;
+		}
+
+		/* Conversion works on private buffers and needs no lock */
+
+		audio_mixer_convert(stream, src + done * frame_bytes, chunk, stream->conv);
+
+		if (!stream->src) {
+			pthread_mutex_lock(&g_audio_mixer.lock);
+			stream->paused = false;
+			stream->started = true;
+			ret = audio_mixer_queue(stream, stream->conv, chunk);
+			pthread_mutex_unlock(&g_audio_mixer.lock);
+		} else {
+			srcData.origin_channel_num = g_audio_mixer.channels;
+			srcData.origin_sample_rate = stream->sample_rate;
+			srcData.origin_sample_width = SAMPLE_WIDTH_16BITS;
+			srcData.desired_channel_num = g_audio_mixer.channels;
+			srcData.desired_sample_rate = g_audio_mixer.rate;
+			srcData.desired_sample_width = SAMPLE_WIDTH_16BITS;
+
+			for (used = 0; used < chunk && ret == AUDIO_MANAGER_SUCCESS;) {
+				srcData.data_in = stream->conv + used * g_audio_mixer.channels;
+				srcData.input_frames = chunk - used;
+				srcData.data_out = stream->resampled;
+				srcData.out_buf_length = stream->resampled_frames * g_audio_mixer.channels * sizeof(int16_t);
+				if (src_simple(stream->src, &srcData) < 0 || (srcData.input_frames_used == 0 && srcData.output_frames_gen == 0)) {
+					meddbg("Fail to resample in:%u/%u\n", used, chunk);
+					ret = AUDIO_MANAGER_RESAMPLE_FAIL;
+					break;
+				}
+				used += srcData.input_frames_used;
+
+				pthread_mutex_lock(&g_audio_mixer.lock);
+				stream->paused = false;
+				stream->started = true;
+				ret = audio_mixer_queue(stream, stream->resampled, srcData.output_frames_gen);
+				pthread_mutex_unlock(&g_audio_mixer.lock);
+			}
+		}
+
+		if (ret == AUDIO_MANAGER_SUCCESS) {
+			done += chunk;
+		}
+	}
+
+	return done > 0 ? (int)done : (int)ret;
+}
+
+unsigned int get_audio_mixer_stream_space(audio_mixer_stream_t stream)
+{
+	unsigned int space;
+
+	if (!stream) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	space = stream->ring_frames - stream->count;
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	/* In frames of the stream; keep a frame for rounding in the resampler */
+
+	if (stream->src) {
+		space = (unsigned int)((uint64_t)space * stream->sample_rate / g_audio_mixer.rate);
+		space = space > 0 ? space - 1 : 0;
+	}
+
+	return space;
+}
+
+unsigned int get_audio_mixer_period_frames(audio_mixer_stream_t stream)
+{
+	unsigned int frames;
+
+	if (!stream) {
+		return 0;
+	}
+
+	frames = (unsigned int)((uint64_t)CONFIG_AUDIO_MIXER_PERIOD_FRAMES * stream->sample_rate / g_audio_mixer.rate);
+	return frames > 0 ? frames : 1;
+}
+
+unsigned int get_audio_mixer_stream_frame_size(audio_mixer_stream_t stream)
+{
+	if (!stream) {
+		return 0;
+	}
+
+	return stream->channels * stream->sample_bytes;
+}
+
+void wait_audio_mixer_period(void)
+{
+	struct timespec abstime;
+	uint32_t periods;
+	uint64_t nsec;
+
+	/* Give up after two periods, so that a caller never hangs on a stopped mixer */
+
+	nsec = 2ULL * CONFIG_AUDIO_MIXER_PERIOD_FRAMES * 1000000000ULL / (g_audio_mixer.rate ? g_audio_mixer.rate : CONFIG_AUDIO_MIXER_SAMPLE_RATE);
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_sec += (abstime.tv_nsec + nsec) / 1000000000ULL;
+	abstime.tv_nsec = (abstime.tv_nsec + nsec) % 1000000000ULL;
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	periods = g_audio_mixer.periods;
+	while (g_audio_mixer.running && periods == g_audio_mixer.periods) {
+		if (pthread_cond_timedwait(&g_audio_mixer.cond, &g_audio_mixer.lock, &abstime) == ETIMEDOUT) {
+			break;
+		}
+	}
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+}
+
+audio_manager_result_t pause_audio_mixer_stream(audio_mixer_stream_t stream)
+{
+	if (!stream) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	stream->paused = true;
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t drain_audio_mixer_stream(audio_mixer_stream_t stream)
+{
+	if (!stream) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	stream->paused = false;
+	stream->draining = true;
+	pthread_cond_broadcast(&g_audio_mixer.cond);
+	while (stream->count > 0 && g_audio_mixer.running) {
+		pthread_cond_wait(&g_audio_mixer.cond, &g_audio_mixer.lock);
+	}
+	stream->draining = false;
+	stream->started = false;
+	stream->count = 0;
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t drop_audio_mixer_stream(audio_mixer_stream_t stream)
+{
+	if (!stream) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	stream->paused = false;
+	stream->started = false;
+	stream->count = 0;
+	pthread_cond_broadcast(&g_audio_mixer.cond);
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t set_audio_mixer_stream_volume(audio_mixer_stream_t stream, uint8_t volume)
+{
+	if (!stream) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	if (volume > AUDIO_DEVICE_MAX_VOLUME) {
+		volume = AUDIO_DEVICE_MAX_VOLUME;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	stream->volume = volume;
+	stream->gain = (uint32_t)volume * AUDIO_MIXER_UNITY_GAIN / AUDIO_DEVICE_MAX_VOLUME;
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t get_audio_mixer_stream_volume(audio_mixer_stream_t stream, uint8_t *volume)
+{
+	if (!stream || !volume) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	*volume = stream->volume;
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t get_audio_mixer_stream_stats(audio_mixer_stream_t stream, audio_mixer_stream_stats_t *stats)
+{
+	if (!stream || !stats) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	*stats = stream->stats;
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t close_audio_mixer_stream(audio_mixer_stream_t stream)
+{
+	audio_mixer_stream_t *prev;
+
+	if (!stream) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_audio_mixer.ctrl_lock);
+
+	pthread_mutex_lock(&g_audio_mixer.lock);
+	for (prev = &g_audio_mixer.streams; *prev != NULL && *prev != stream; prev = &(*prev)->next);
+	if (*prev == NULL) {
+		pthread_mutex_unlock(&g_audio_mixer.lock);
+		pthread_mutex_unlock(&g_audio_mixer.ctrl_lock);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+	*prev = stream->next;
+	g_audio_mixer.nstreams--;
+	pthread_mutex_unlock(&g_audio_mixer.lock);
+
+	medvdbg("Mixer stream %p closed: %u frames, %u underruns, %u silent frames\n", stream, stream->stats.frames, stream->stats.underruns, stream->stats.silent_frames);
+
+	if (g_audio_mixer.nstreams == 0) {
+		audio_mixer_stop();
+	}
+
+	pthread_mutex_unlock(&g_audio_mixer.ctrl_lock);
+
+	audio_mixer_free_stream(stream);
+	return AUDIO_MANAGER_SUCCESS;
+}
+#endif /* CONFIG_AUDIO_MIXER */
+
 #ifdef CONFIG_DEBUG_MEDIA_INFO
 void print_audio_card_info(audio_io_direction_t direct)
 {
@@ -91,6 +91,24 @@ enum audio_device_process_unit_subtype_e {
 
 typedef enum audio_device_process_unit_subtype_e device_process_subtype_t;
 
+#ifdef CONFIG_AUDIO_MIXER
+/**
+ * @brief Handle of a stream played through the software mixer
+ */
+typedef struct audio_mixer_stream_s *audio_mixer_stream_t;
+
+/**
+ * @brief Playback statistics of a mixer stream
+ */
+struct audio_mixer_stream_stats_s {
+	uint32_t frames;			// frames mixed into the output, at the mixer rate
+	uint32_t underruns;			// periods the stream was played but could not fill
+	uint32_t silent_frames;		// frames of silence mixed in for the stream because of underruns
+};
+
+typedef struct audio_mixer_stream_stats_s audio_mixer_stream_stats_t;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -176,6 +194,44 @@ int start_audio_stream_in(void *data, unsigned int frames);
  ****************************************************************************/
 int start_audio_stream_out(void *data, unsigned int frames);
 
+#ifdef CONFIG_MEDIA_PLAYER_DIRECT_OUTPUT
+/****************************************************************************
+ * Name: get_audio_stream_out_buffer
+ *
+ * Description:
+ *   Get the next free buffer of the output device, to be filled in place
+ *   instead of passing the data to start_audio_stream_out(). Waits for the
+ *   device to give a buffer back if all of them are queued, and resumes a
+ *   paused device. The buffer is queued by commit_audio_stream_out().
+ *
+ * Input parameters:
+ *   data: returns the start of the buffer
+ *   frames: number of frames wanted, returns the number of frames that fit
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. AUDIO_MANAGER_DEVICE_NOT_SUPPORT if
+ *   the stream is resampled, so must be written with start_audio_stream_out().
+ *   Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t get_audio_stream_out_buffer(void **data, unsigned int *frames);
+
+/****************************************************************************
+ * Name: commit_audio_stream_out
+ *
+ * Description:
+ *   Queue the buffer of get_audio_stream_out_buffer() to the output device,
+ *   with the first 'frames' frames of it filled. Playback starts with the
+ *   first buffer.
+ *
+ * Input parameters:
+ *   frames: number of frames written into the buffer
+ *
+ * Return Value:
+ *   On success, the number of frames queued. Otherwise, a negative value.
+ ****************************************************************************/
+int commit_audio_stream_out(unsigned int frames);
+#endif
+
 /****************************************************************************
  * Name: pause_audio_stream_in
  *
@@ -653,6 +709,197 @@ audio_manager_result_t get_stream_in_id(int *card_id, int *device_id);
  ****************************************************************************/
 audio_manager_result_t get_stream_out_id(int *card_id, int *device_id);
 
+#ifdef CONFIG_AUDIO_MIXER
+/****************************************************************************
+ * Name: open_audio_mixer_stream
+ *
+ * Description:
+ *   Open a stream played through the software mixer. Any number of streams
+ *   can be open at once; the first one opens the output card with a fixed
+ *   period and the last one to be closed releases it. The card can not be
+ *   used with set_audio_stream_out() in the meantime.
+ *
+ * Input parameter:
+ *   channels : channels of the stream, sample_rate : sample rate of the stream,
+ *   format : a pcm_format of tinyalsa, stream : the opened stream to be returned
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t open_audio_mixer_stream(unsigned int channels, unsigned int sample_rate, int format, audio_mixer_stream_t *stream);
+
+/****************************************************************************
+ * Name: write_audio_mixer_stream
+ *
+ * Description:
+ *   Queue frames of the stream for mixing. The frames are converted to the
+ *   mixer format right away. Blocks while the stream has no room, and
+ *   resumes a paused stream.
+ *
+ * Input parameter:
+ *   stream : the stream, data : frames in the format of the stream, frames : number of frames
+ *
+ * Return Value:
+ *   On success, the number of frames queued. Otherwise, a negative value.
+ ****************************************************************************/
+int write_audio_mixer_stream(audio_mixer_stream_t stream, const void *data, unsigned int frames);
+
+/****************************************************************************
+ * Name: get_audio_mixer_stream_space
+ *
+ * Description:
+ *   Get the number of frames that can be written without blocking
+ *
+ * Input parameter:
+ *   stream : the stream
+ *
+ * Return Value:
+ *   The number of frames, in the format of the stream.
+ ****************************************************************************/
+unsigned int get_audio_mixer_stream_space(audio_mixer_stream_t stream);
+
+/****************************************************************************
+ * Name: get_audio_mixer_period_frames
+ *
+ * Description:
+ *   Get the number of frames of the stream that make up one mixer period
+ *
+ * Input parameter:
+ *   stream : the stream
+ *
+ * Return Value:
+ *   The number of frames, in the format of the stream.
+ ****************************************************************************/
+unsigned int get_audio_mixer_period_frames(audio_mixer_stream_t stream);
+
+/****************************************************************************
+ * Name: get_audio_mixer_stream_frame_size
+ *
+ * Description:
+ *   Get the size of one frame of the stream
+ *
+ * Input parameter:
+ *   stream : the stream
+ *
+ * Return Value:
+ *   The number of bytes per frame.
+ ****************************************************************************/
+unsigned int get_audio_mixer_stream_frame_size(audio_mixer_stream_t stream);
+
+/****************************************************************************
+ * Name: wait_audio_mixer_period
+ *
+ * Description:
+ *   Wait until the mixer has taken the next period, or at most two periods
+ *
+ * Input parameter:
+ *   None
+ *
+ * Return Value:
+ *   None
+ ****************************************************************************/
+void wait_audio_mixer_period(void);
+
+/****************************************************************************
+ * Name: pause_audio_mixer_stream
+ *
+ * Description:
+ *   Stop mixing the stream while keeping what it has queued. The next
+ *   write resumes it.
+ *
+ * Input parameter:
+ *   stream : the stream
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t pause_audio_mixer_stream(audio_mixer_stream_t stream);
+
+/****************************************************************************
+ * Name: drain_audio_mixer_stream
+ *
+ * Description:
+ *   Wait until everything queued on the stream has been mixed
+ *
+ * Input parameter:
+ *   stream : the stream
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t drain_audio_mixer_stream(audio_mixer_stream_t stream);
+
+/****************************************************************************
+ * Name: drop_audio_mixer_stream
+ *
+ * Description:
+ *   Discard everything queued on the stream
+ *
+ * Input parameter:
+ *   stream : the stream
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t drop_audio_mixer_stream(audio_mixer_stream_t stream);
+
+/****************************************************************************
+ * Name: set_audio_mixer_stream_volume
+ *
+ * Description:
+ *   Set the gain of the stream in the mix, without touching the card volume
+ *
+ * Input parameter:
+ *   stream : the stream, volume : 0 (mute) to the value of get_max_audio_volume()
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t set_audio_mixer_stream_volume(audio_mixer_stream_t stream, uint8_t volume);
+
+/****************************************************************************
+ * Name: get_audio_mixer_stream_volume
+ *
+ * Description:
+ *   Get the gain of the stream in the mix
+ *
+ * Input parameter:
+ *   stream : the stream, volume : the volume to be returned
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t get_audio_mixer_stream_volume(audio_mixer_stream_t stream, uint8_t *volume);
+
+/****************************************************************************
+ * Name: get_audio_mixer_stream_stats
+ *
+ * Description:
+ *   Get the playback statistics of the stream
+ *
+ * Input parameter:
+ *   stream : the stream, stats : the statistics to be returned
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t get_audio_mixer_stream_stats(audio_mixer_stream_t stream, audio_mixer_stream_stats_t *stats);
+
+/****************************************************************************
+ * Name: close_audio_mixer_stream
+ *
+ * Description:
+ *   Remove the stream from the mixer, dropping what it has queued
+ *
+ * Input parameter:
+ *   stream : the stream
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t close_audio_mixer_stream(audio_mixer_stream_t stream);
+#endif
+
 #ifdef CONFIG_DEBUG_MEDIA_INFO
 /****************************************************************************
  * Name: dump_audio_card_info
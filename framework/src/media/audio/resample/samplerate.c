@@ -24,6 +24,10 @@
 ** file at : https://github.com/erikd/libsamplerate/blob/master/COPYING
 */
 
+#ifdef __TINYARA__
+#include <tinyara/config.h>
+#endif
+
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -32,10 +36,24 @@
 #include "samplerate.h"
 #include "../../utils/remix.h"
 
+#if defined(CONFIG_AUDIO_RESAMPLER_ARM_DSP) && defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#define SRC_USE_SIMD32
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
+// Taps of each filter phase when the rate goes up, downsampling scales them by the ratio
+#ifndef CONFIG_AUDIO_RESAMPLER_TAPS
+#define CONFIG_AUDIO_RESAMPLER_TAPS 32
+#endif
+
+// Most filter phases kept, ratios needing more interpolate between two phases
+#ifndef CONFIG_AUDIO_RESAMPLER_MAX_PHASES
+#define CONFIG_AUDIO_RESAMPLER_MAX_PHASES 64
+#endif
+
 // Range of ratio supported for sample rate conversion
 #define SRC_MAX_RATIO   ((float)3)
 #define SRC_MIN_RATIO   ((float)1 / SRC_MAX_RATIO)
@@ -43,41 +61,23 @@
 #define MAXIMUM(a, b)   (((a) > (b)) ? (a) : (b))
 #define MINIMUM(a, b)   (((a) < (b)) ? (a) : (b))
 
-// Fraction part bits
-#define FRACBITS            (16)
-
-// Convert to 16.16 fixed point value
-#define TO_16_16_FIXED(x)   ((uint32_t)((float)(x) * (float)(1 << FRACBITS) + 0.5f))
-
-// Int part value: 16.0 fixed point
-#define INTPART_VALUE(x)    ((x) >> FRACBITS)
-
-// Fraction part value: 0.16 fixed point
-#define FRACPART_VALUE(x)   ((x) & 0xffff)
-
-// Calculate new sample data
-#define CALC_NEW_SAMPLE(s1, s2, part) ((s1) + INTPART_VALUE(((s2) - (s1)) * (int32_t)(part)))
-
 // Convert sample width in bytes
 #define BYTES_PER_SAMPLE(bits_per_sample)   ((bits_per_sample) >> 3)
 
-// Round the given positive float number to the nearest integer
-#define LRINTPF(pf) ((long)((float)(pf) + 0.5f))
-
 // Max channel num supported for SRC
 #define SRC_MAX_CH  (2)
 
-// Down resample ratio for 44.1k->32k, 22.05k->16k and 11.025k->8k
-#define DOWN_RESAMPLE_441_320_RATIO ((float)441 / (float)320)
+// Filter coefficients are Q15, every phase sums to 1.0
+#define SRC_COEFF_BITS      (15)
+#define SRC_COEFF_ONE       (1 << SRC_COEFF_BITS)
 
-#define FLOAT_ACCURACY      (0.000001f)
-#define FLOAT_EQUAL(a, b)   (fabsf((a)-(b)) < FLOAT_ACCURACY)
+// -6dB point of the anti-aliasing filter, relative to the lower Nyquist frequency
+#define SRC_CUTOFF          (0.91f)
 
-#define NUM_COEFF_22KHZ (sizeof(filter_22khz_coeff) / sizeof(filter_22khz_coeff[0]))
-#define OVERLAP_22KHZ   (NUM_COEFF_22KHZ - 2)
+// Kaiser window shape, about 65dB of stopband attenuation
+#define SRC_KAISER_BETA     (6.5f)
 
-// At least remain one frame (one sample for each channel)
-#define OVERLAP_DEFAULT (1)
+#define SRC_PI              (3.14159265358979f)
 
 #define RETURN_VAL_IF_FAIL(condition, val) \
 	do { \
@@ -100,80 +100,51 @@
  * @structure src_context_s: main structure used for SRC, it contains context
  *            variables used between src_simple() calls.
  * @brief It's internal structure, user can only get the handler via src_init().
+ *
+ * The conversion is a polyphase FIR filter: the rate ratio is reduced to
+ * up/down, and output frame n lies at input position n * down / up. Its
+ * fractional part selects one of num_phases precomputed filters, which is
+ * applied to the num_taps input frames around the position. When up is
+ * larger than CONFIG_AUDIO_RESAMPLER_MAX_PHASES, the filter for the
+ * position is interpolated from the two nearest phases.
  */
 struct src_context_s {
-	int16_t *in_buffer;     // pointer to the internal input buffer allocated
-	int16_t *out_buffer;    // pointer to the external output buffer assigned
+	int16_t *in_buffer;     // pointer to the internal input buffer allocated, holds rechanneled frames
 	int in_buffer_bytes;    // internal input buffer capability in bytes
 	int in_buffer_frames;   // internal input buffer capability in frames
-	int left_frames;        // number of frames remained in internal input buffer
-	int used_frames;        // number of frames used in internal input buffer
+	int left_frames;        // number of frames in internal input buffer
 	int old_channel_num;    // memorize old channel number
 	int new_channel_num;    // memorize new channel number
 	int old_sample_rate;    // memorize old sample rate
 	int new_sample_rate;    // memorize new sample rate
 	int old_sample_width;   // memorize old sample width(format)
 	int new_sample_width;   // memorize new sample width(format)
-	const int *filter_coeff;// pointer to filter coefficient array
-	int overlap_frames;     // number of overlap frames reserved in internal buffer
-	float ratio;            // (float)new_sample_rate / (float)old_sample_rate
-	float inverse_ratio;    // (float)old_sample_rate / (float)new_sample_rate
-	uint32_t fp_frac;       // fraction part value of last fixed point index
-	/**
-	 * @brief   Function pointer to resampling process function
-	 * @param   src_context_t *: pointer to resampler object.
-	 * @param   int32_t *: give number of frames available for converting
-	 *                     and retrieve number of frames used actually.
-	 * @return  number of frames generated
-	 */
-	int32_t (*src_func)(struct src_context_s *, int32_t *);
+	int16_t *filter_bank;   // num_phases + 1 filters of num_taps Q15 coefficients each
+	int16_t *filter;        // num_taps coefficients interpolated for one output frame
+	int num_taps;           // taps per filter phase, even
+	int num_phases;         // filter phases, up or CONFIG_AUDIO_RESAMPLER_MAX_PHASES if less
+	uint32_t up;            // new_sample_rate / gcd
+	uint32_t down;          // old_sample_rate / gcd
+	uint32_t step_int;      // input frames advanced per output frame: step_int + step_frac / up
+	uint32_t step_frac;
+	uint32_t inverse_up;    // 2^32 / up, turns a remainder of up into a Q15 weight
+	uint32_t phase;         // fractional input position of the next output frame, in 1/up units
+	int32_t position;       // first input frame used for the next output frame
 };
 
 typedef struct src_context_s src_context_t;
 
-/**
- * 16.16 fixed point FIR filter coefficients for conversion 44100 -> 22050.
- * (Works equivalently for 22010 -> 11025 or any other halving, of course.)
- */
-static const int32_t filter_22khz_coeff[] = {
-	2089257, 2898328, -5820678, -10484531,
-	19038724, 30542725, -50469415, -81505260,
-	152544464, 478517512, 478517512, 152544464,
-	-81505260, -50469415, 30542725, 19038724,
-	-10484531, -5820678, 2898328, 2089257,
-};
-
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
-/**
- * @brief   Do convolution calculation for sample data
- * @remarks FIR: Finite Impulse Response
- * @param   input: pointer to input samples buffer.
- * @param   coeff: pointer to coefficient array for convolution.
- * @param   num_samples: num of coefficients in array.
- * @param   channels_num: num of channels of input samples.
- * @return  value of convolution result.
- * @see
- */
-static int32_t fir_convolve(const int16_t *input, const int32_t *coeff, int32_t num_samples, int32_t channels_num)
-{
-	int32_t sum = 1 << 13;
-	int32_t i;
-	for (i = 0; i < num_samples; ++i) {
-		sum += input[i * channels_num] * (coeff[i] >> 16);
-	}
-	return sum >> 14;
-}
-
 /**
  * @brief   Clip an integer value (32 bits) to a signed short type value(16 bits)
  * @remarks int16_t value in range [INT16_MIN, INT16_MAX], which is defined in <stdint.h>
  * @param   x: input 32 bits integer value.
  * @return  output 16 bits signed short value.
  */
-static int16_t clip(int32_t x)
+static inline int16_t clip(int32_t x)
 {
 	if (x < INT16_MIN) {
 		return INT16_MIN;
@@ -184,89 +155,249 @@ static int16_t clip(int32_t x)
 	return x;
 }
 
+#ifdef SRC_USE_SIMD32
 /**
- * It handles sample rate up scaling in all ratio cases (i.e. inverse ratio 0.*)
- * and sample rate down scaling cases in inverse ratio 1.* and 2.* with fraction.
+ * @brief   Load two adjacent Q15 values as one word for the dual MAC instructions
+ * @remarks Only frames of stereo data are word aligned, memcpy lets the compiler
+ *          use an unaligned load for the others.
  */
-static int32_t resample_frac(src_context_t *src, int32_t *num_frames_in)
+static inline int32_t load_q15x2(const int16_t *p)
 {
-	int32_t num_frames_out = (int32_t)((float)*num_frames_in * src->ratio);
-	const int16_t *input = src->in_buffer;
-	int16_t *output = src->out_buffer;
-	int32_t channels_num = src->new_channel_num;
-	uint32_t step = TO_16_16_FIXED(src->inverse_ratio);
-	uint32_t fp_index = src->fp_frac;
-	uint32_t whole, frac;
-	int32_t i, j, s1, s2;
-
-	for (i = 0; i < num_frames_out; ++i, fp_index += step) {
-		whole = INTPART_VALUE(fp_index);
-		frac = FRACPART_VALUE(fp_index);
-		for (j = 0; j < channels_num; j++) {
-			s1 = input[whole * channels_num + j];
-			s2 = input[(whole + 1) * channels_num + j];
-			*output++ = clip(CALC_NEW_SAMPLE(s1, s2, frac));
-		}
+	int32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+#endif
+
+/**
+ * @brief   Apply one filter phase to mono frames
+ * @param   input: first of num_taps input samples
+ * @param   coeff: num_taps Q15 coefficients, num_taps is even
+ * @return  output sample
+ */
+static inline int16_t fir_mono(const int16_t *input, const int16_t *coeff, int32_t num_taps)
+{
+	int32_t sum = 1 << (SRC_COEFF_BITS - 1);
+	int32_t i;
+
+#ifdef SRC_USE_SIMD32
+	// SMLAD: two samples times two coefficients per instruction
+	for (i = 0; i < num_taps; i += 2) {
+		sum = __smlad(load_q15x2(input + i), load_q15x2(coeff + i), sum);
+	}
+#else
+	for (i = 0; i < num_taps; i += 2) {
+		sum += input[i] * coeff[i];
+		sum += input[i + 1] * coeff[i + 1];
+	}
+#endif
+
+	return clip(sum >> SRC_COEFF_BITS);
+}
+
+/**
+ * @brief   Apply one filter phase to interleaved stereo frames, both channels in one pass
+ * @param   input: first of num_taps input frames
+ * @param   coeff: num_taps Q15 coefficients, num_taps is even
+ * @param   output: receives the left and the right output sample
+ */
+static inline void fir_stereo(const int16_t *input, const int16_t *coeff, int32_t num_taps, int16_t *output)
+{
+	int32_t left = 1 << (SRC_COEFF_BITS - 1);
+	int32_t right = 1 << (SRC_COEFF_BITS - 1);
+	int32_t i;
+
+#ifdef SRC_USE_SIMD32
+	// Two frames L0 R0 L1 R1 are regrouped into L0 L1 and R0 R1 (PKHBT/PKHTB)
+	for (i = 0; i < num_taps; i += 2) {
+		uint32_t frame0 = (uint32_t)load_q15x2(input + 2 * i);
+		uint32_t frame1 = (uint32_t)load_q15x2(input + 2 * i + 2);
+		int32_t c = load_q15x2(coeff + i);
+		left = __smlad((frame0 & 0xffff) | (frame1 << 16), c, left);
+		right = __smlad((frame0 >> 16) | (frame1 & 0xffff0000), c, right);
+	}
+#else
+	for (i = 0; i < num_taps; i++) {
+		left += input[2 * i] * coeff[i];
+		right += input[2 * i + 1] * coeff[i];
 	}
+#endif
 
-	*num_frames_in = INTPART_VALUE(fp_index);
-	src->fp_frac = FRACPART_VALUE(fp_index);;
-	return num_frames_out;
+	output[0] = clip(left >> SRC_COEFF_BITS);
+	output[1] = clip(right >> SRC_COEFF_BITS);
 }
 
 /**
- * It handles sample rate down scaling cases in inverse ratio 2.0 and 3.0 without fraction.
- * This function has same logic as resample_frac(), that means resample_frac() also works,
- * but downresample_int() is more efficient in special inverse ratio 2.0 and 3.0 cases.
- * Optimization: The fraction value of fp_index is always 0, so remove unnecessary calculation.
+ * @brief   Zeroth order modified Bessel function of the first kind, for the Kaiser window
  */
-static int32_t downresample_int(src_context_t *src, int32_t *num_frames_in)
+static float bessel_i0(float x)
+{
+	float sum = 1.0f;
+	float term = 1.0f;
+	float half = x / 2.0f;
+	int k;
+
+	for (k = 1; k < 32 && term > sum * 1e-7f; k++) {
+		term *= (half / k) * (half / k);
+		sum += term;
+	}
+
+	return sum;
+}
+
+static uint32_t gcd(uint32_t a, uint32_t b)
 {
-	int32_t quotient = (int32_t)src->inverse_ratio;
-	*num_frames_in = *num_frames_in / quotient * quotient;
-	int32_t num_frames_out = *num_frames_in / quotient;
-
-	const int16_t *input = src->in_buffer;
-	int16_t *output = src->out_buffer;
-	int32_t channels_num = src->new_channel_num;
-	uint32_t step = TO_16_16_FIXED(quotient);
-	uint32_t fp_index = 0;
-	uint32_t whole;
-	int32_t i, j;
-
-	for (i = 0; i < num_frames_out; ++i, fp_index += step) {
-		whole = INTPART_VALUE(fp_index);
-		for (j = 0; j < channels_num; j++) {
-			*output++ = input[whole * channels_num + j];
+	while (b != 0) {
+		uint32_t t = a % b;
+		a = b;
+		b = t;
+	}
+
+	return a;
+}
+
+/**
+ * @brief   Design the filter bank: a Kaiser windowed sinc low-pass, sampled at
+ *          num_phases fractional delays and quantized to Q15.
+ * @remarks Float is used here only, once per converter. Each phase is normalized
+ *          to a DC gain of exactly 1.0 after rounding. An extra phase for a delay
+ *          of one whole frame ends the bank, for interpolation past the last phase.
+ * @param   src: pointer to resampler object, with up, down, num_taps and num_phases set.
+ * @return  0 on success, negative value means failure.
+ */
+static int design_filter_bank(src_context_t *src)
+{
+	int32_t half = src->num_taps / 2;
+	float cutoff = 0.5f * SRC_CUTOFF;   // cycles per input frame
+	float i0_beta = bessel_i0(SRC_KAISER_BETA);
+	float *taps;
+	int32_t k, j;
+
+	if (src->down > src->up) {
+		// Down resampling: below the output Nyquist frequency instead
+		cutoff = cutoff * (float)src->up / (float)src->down;
+	}
+
+	src->filter_bank = (int16_t *)malloc((src->num_phases + 1) * src->num_taps * sizeof(int16_t));
+	src->filter = (int16_t *)malloc(src->num_taps * sizeof(int16_t));
+	taps = (float *)malloc(src->num_taps * sizeof(float));
+	if (src->filter_bank == NULL || src->filter == NULL || taps == NULL) {
+		free(taps);
+		return SRC_ERR_MALLOC_FAILED;
+	}
+
+	for (k = 0; k <= src->num_phases; k++) {
+		int16_t *coeff = src->filter_bank + k * src->num_taps;
+		float frac = (float)k / (float)src->num_phases;
+		float sum = 0.0f;
+		int32_t total = 0;
+		int32_t center = half - 1;
+
+		// Tap j weights input frame position + j, the output lies at position + half - 1 + frac
+		for (j = 0; j < src->num_taps; j++) {
+			float t = (float)(j - (half - 1)) - frac;
+			float x = t / (float)half;
+			float h = 2.0f * cutoff;
+			if (fabsf(t) > 1e-6f) {
+				h = sinf(2.0f * SRC_PI * cutoff * t) / (SRC_PI * t);
+			}
+			if (x * x < 1.0f) {
+				h *= bessel_i0(SRC_KAISER_BETA * sqrtf(1.0f - x * x)) / i0_beta;
+			} else {
+				h = 0.0f;
+			}
+			taps[j] = h;
+			sum += h;
+		}
+
+		for (j = 0; j < src->num_taps; j++) {
+			coeff[j] = clip(lrintf(taps[j] * SRC_COEFF_ONE / sum));
+			total += coeff[j];
+		}
+
+		// Put the rounding error on the largest tap
+		if (frac > 0.5f) {
+			center++;
+		}
+		if (center >= src->num_taps) {
+			center = src->num_taps - 1;
 		}
+		coeff[center] = clip(coeff[center] + SRC_COEFF_ONE - total);
+	}
+
+	free(taps);
+	return SRC_ERR_NO_ERROR;
+}
+
+/**
+ * @brief   Interpolate the filter of a position between two phases of the bank.
+ * @param   src: pointer to resampler object.
+ * @param   phase: fractional input position, in 1/up units.
+ * @return  the filter, num_taps Q15 coefficients.
+ */
+static const int16_t *interpolate_filter(src_context_t *src, uint32_t phase)
+{
+	// Position in 1/num_phases units: phase index and Q15 weight of the next phase
+	uint32_t scaled = phase * src->num_phases;
+	uint32_t k = scaled / src->up;
+	int32_t weight = (int32_t)(((uint64_t)(scaled - k * src->up) * src->inverse_up) >> (32 - SRC_COEFF_BITS));
+	const int16_t *c0 = src->filter_bank + k * src->num_taps;
+	const int16_t *c1 = c0 + src->num_taps;
+	int16_t *filter = src->filter;
+	int32_t j;
+
+	for (j = 0; j < src->num_taps; j++) {
+		filter[j] = c0[j] + (((c1[j] - c0[j]) * weight + (1 << (SRC_COEFF_BITS - 1))) >> SRC_COEFF_BITS);
 	}
 
-	return num_frames_out;
+	return filter;
 }
 
 /**
- * @brief   Do filtering once new frames added to internal buffer.
+ * @brief   Generate output frames from the input frames in the internal buffer.
  * @param   src: pointer to resampler object.
- * @param   num_frames_add: number of frames added
+ * @param   output: output buffer.
+ * @param   max_frames: number of frames the output buffer holds.
+ * @return  number of frames generated.
  */
-static void convolution_filtering(src_context_t *src, int32_t num_frames_add)
+static int32_t resample_polyphase(src_context_t *src, int16_t *output, int32_t max_frames)
 {
-	if ((src->filter_coeff != NULL) && (src->left_frames > src->overlap_frames)) {
-		int16_t *input;
-		int32_t samples;
-		if (src->left_frames == num_frames_add) {
-			input = src->in_buffer;
-			samples = (num_frames_add - src->overlap_frames) * src->new_channel_num;
+	const int32_t channels_num = src->new_channel_num;
+	const int32_t num_taps = src->num_taps;
+	const int32_t num_phases = src->num_phases;
+	const uint32_t up = src->up;
+	uint32_t phase = src->phase;
+	int32_t position = src->position;
+	int32_t frames = 0;
+
+	while (frames < max_frames && position + num_taps <= src->left_frames) {
+		const int16_t *coeff;
+
+		if (num_phases == (int32_t)up) {
+			coeff = src->filter_bank + phase * num_taps;
 		} else {
-			input = src->in_buffer + src->left_frames - num_frames_add - src->overlap_frames;
-			samples = num_frames_add * src->new_channel_num;
+			coeff = interpolate_filter(src, phase);
 		}
 
-		int32_t i;
-		for (i = 0; i < samples; ++i) {
-			input[i] = fir_convolve(input + i, src->filter_coeff, src->overlap_frames, src->new_channel_num);
+		if (channels_num == 1) {
+			*output++ = fir_mono(src->in_buffer + position, coeff, num_taps);
+		} else {
+			fir_stereo(src->in_buffer + 2 * position, coeff, num_taps, output);
+			output += 2;
+		}
+		frames++;
+
+		position += src->step_int;
+		phase += src->step_frac;
+		if (phase >= up) {
+			phase -= up;
+			position++;
 		}
 	}
+
+	src->phase = phase;
+	src->position = position;
+	return frames;
 }
 
 /**
@@ -281,10 +412,10 @@ static int check_src_data(src_context_t *src, src_data_t *src_data)
 	RETURN_VAL_IF_FAIL(((src_data->data_in != NULL) && (src_data->data_out != NULL)), SRC_ERR_BAD_PARAMS);
 
 	if (!CHECK_SRC_CONTEXT_INIT(src)) {
-		// Check supported converting ratio
-		if (!src_is_valid_ratio((float)src_data->desired_sample_rate / (float)src_data->origin_sample_rate)) {
-			return SRC_ERR_BAD_SRC_RATIO;
-		}
+		// Check supported converting ratio, in integers: 1/3 <= desired/origin <= 3
+		RETURN_VAL_IF_FAIL(((src_data->origin_sample_rate > 0) && (src_data->desired_sample_rate > 0)), SRC_ERR_BAD_SRC_RATIO);
+		RETURN_VAL_IF_FAIL((src_data->desired_sample_rate <= 3 * src_data->origin_sample_rate), SRC_ERR_BAD_SRC_RATIO);
+		RETURN_VAL_IF_FAIL((src_data->origin_sample_rate <= 3 * src_data->desired_sample_rate), SRC_ERR_BAD_SRC_RATIO);
 		// Check supported input multichannels number: 1-Mono/.../6-5.1 Stereo
 		RETURN_VAL_IF_FAIL(((src_data->origin_channel_num >= 1) && (src_data->origin_channel_num <= 6)), SRC_ERR_BAD_CHANNEL_COUNT);
 		// Check supported output channel: 1-Mono/2-Stereo
@@ -314,9 +445,8 @@ static int check_src_data(src_context_t *src, src_data_t *src_data)
  */
 static int init_src_context(src_context_t *src, src_data_t *src_data)
 {
-	// Allocate internal buffer
-	src->in_buffer = (int16_t *)malloc(src->in_buffer_bytes);
-	RETURN_VAL_IF_FAIL((src->in_buffer != NULL), SRC_ERR_MALLOC_FAILED);
+	uint32_t divisor;
+	int ret;
 
 	// Initialize other members
 	src->old_channel_num = src_data->origin_channel_num;
@@ -325,42 +455,49 @@ static int init_src_context(src_context_t *src, src_data_t *src_data)
 	src->new_sample_width = src_data->desired_sample_width;
 	src->old_sample_rate = src_data->origin_sample_rate;
 	src->new_sample_rate = src_data->desired_sample_rate;
-	src->in_buffer_frames = src->in_buffer_bytes / OLD_FRAMES_TO_BYTES(src, 1);
-	src->left_frames = 0;
-	src->used_frames = 0;
-	src->fp_frac = 0;
-
-	// Calculate converting ratio for later use
-	src->ratio = (float)src->new_sample_rate / (float)src->old_sample_rate;
-	src->inverse_ratio = (float)src->old_sample_rate / (float)src->new_sample_rate;
-
-	// Set overlap frame number and converting function as per converting ratio
-	if (src->old_sample_rate > src->new_sample_rate) {
-		// down resampling
-		if (src->old_sample_rate % src->new_sample_rate == 0) {
-			// inverse ratio 2.0/3.0 cases. e.g. 48K->16K, 48K->24K, 44.1K->22.05K, ...
-			src->filter_coeff = filter_22khz_coeff;
-			src->overlap_frames = OVERLAP_22KHZ;
-			src->src_func = downresample_int;
-		} else if ((int)src->inverse_ratio >= 2) {
-			// inverse ratio 2.* cases. e.g. 48K->22.05K, 44.1K->16K, 24K->11.025K, ...
-			src->filter_coeff = filter_22khz_coeff;
-			src->overlap_frames = OVERLAP_22KHZ;
-			src->src_func = resample_frac;
-		} else {
-			// inverse ratio 1.* cases. e.g. 48K->44.1K, 44.1K->32K, 44.1K->24K, ...
-			src->filter_coeff = NULL;
-			src->overlap_frames = OVERLAP_DEFAULT;
-			src->src_func = resample_frac;
-		}
-	} else {
-		// up resampling
-		src->filter_coeff = NULL;
-		src->overlap_frames = OVERLAP_DEFAULT;
-		src->src_func = resample_frac;
-		// TODO: Noises appeared in ratio 2.* cases, consider fir-filtering after converting process
+
+	// Reduce the ratio, e.g. 44.1K->16K is 160/441 and 22.05K->48K is 320/147
+	divisor = gcd(src->new_sample_rate, src->old_sample_rate);
+	src->up = src->new_sample_rate / divisor;
+	src->down = src->old_sample_rate / divisor;
+	src->step_int = src->down / src->up;
+	src->step_frac = src->down % src->up;
+	src->inverse_up = UINT32_MAX / src->up;
+	src->num_phases = MINIMUM(src->up, CONFIG_AUDIO_RESAMPLER_MAX_PHASES);
+
+	// Down resampling narrows the filter, so it needs taps in proportion
+	src->num_taps = CONFIG_AUDIO_RESAMPLER_TAPS;
+	if (src->down > src->up) {
+		src->num_taps = (CONFIG_AUDIO_RESAMPLER_TAPS * src->down + src->up - 1) / src->up;
+	}
+	src->num_taps = (src->num_taps + 1) & ~1;
+
+	ret = design_filter_bank(src);
+	if (ret != SRC_ERR_NO_ERROR) {
+		free(src->filter_bank);
+		free(src->filter);
+		src->filter_bank = NULL;
+		src->filter = NULL;
+		return ret;
 	}
 
+	// Allocate internal buffer, with room for a few filter spans at least
+	src->in_buffer_frames = MAXIMUM(src->in_buffer_bytes / NEW_FRAMES_TO_BYTES(src, 1), 4 * src->num_taps);
+	src->in_buffer = (int16_t *)malloc(NEW_FRAMES_TO_BYTES(src, src->in_buffer_frames));
+	if (src->in_buffer == NULL) {
+		free(src->filter_bank);
+		free(src->filter);
+		src->filter_bank = NULL;
+		src->filter = NULL;
+		return SRC_ERR_MALLOC_FAILED;
+	}
+
+	// Silence before the first frame centers the filter on it: no delay is added
+	src->left_frames = src->num_taps / 2 - 1;
+	memset(src->in_buffer, 0, NEW_FRAMES_TO_BYTES(src, src->left_frames));
+	src->position = 0;
+	src->phase = 0;
+
 	return SRC_ERR_NO_ERROR;
 }
 
@@ -378,6 +515,8 @@ src_handle_t src_init(int size)
 	src->in_buffer_bytes = (((size + max_frame_size - 1) / max_frame_size) * max_frame_size);
 	src->in_buffer_frames = 0;
 	src->in_buffer = NULL;
+	src->filter_bank = NULL;
+	src->filter = NULL;
 	// Other members will be initilized before first use,
 	// as soon as in_buffer allocated in init_src_context().
 
@@ -391,6 +530,10 @@ int src_destroy(src_handle_t handle)
 
 	free(src->in_buffer);
 	src->in_buffer = NULL;
+	free(src->filter_bank);
+	src->filter_bank = NULL;
+	free(src->filter);
+	src->filter = NULL;
 
 	free(src);
 	return SRC_ERR_NO_ERROR;
@@ -437,46 +580,27 @@ int src_simple(src_handle_t handle, src_data_t *src_data)
 	if (!CHECK_SRC_CONTEXT_INIT(src)) {
 		ret = init_src_context(src, src_data);
 		RETURN_VAL_IF_FAIL((ret == SRC_ERR_NO_ERROR), ret);
-		RETURN_VAL_IF_FAIL((src->src_func != NULL), SRC_ERR_UNKNOWN);
-	}
-
-	// Update output buffer to src context (used in converting proccess functions)
-	src->out_buffer = (int16_t *)src_data->data_out;
-
-	// Move remaining frames in internal buffer
-	if ((src->used_frames > 0) && (src->left_frames > 0)) {
-		memcpy((void *)src->in_buffer, \
-			(const void *)((int8_t *)src->in_buffer + NEW_FRAMES_TO_BYTES(src, src->used_frames)), \
-			NEW_FRAMES_TO_BYTES(src, src->left_frames));
-		src->used_frames = 0;
 	}
 
 	// Accept input frames as much as possible, append (rechannel/copy) input frames to internal buffer
 	int input_frames_used = MINIMUM(src_data->input_frames, (src->in_buffer_frames - src->left_frames));
-	frames = rechannel(ch2layout(src->old_channel_num), ch2layout(src->new_channel_num), \
-					(const int16_t *)src_data->data_in, input_frames_used, \
-					(int16_t *)((int8_t *)src->in_buffer + NEW_FRAMES_TO_BYTES(src, src->left_frames)), input_frames_used);
-	RETURN_VAL_IF_FAIL((frames == input_frames_used), SRC_ERR_UNKNOWN);
-	src->left_frames += input_frames_used;
-
-	// Filtering on new appended frames
-	convolution_filtering(src, input_frames_used);
-
-	// Calculate how many input frames needed if fill up out buffer
-	float input_frames_need = (float)out_buffer_frames / src->ratio;
-	if (input_frames_need - (int)input_frames_need > 0) {
-		input_frames_need = (int)input_frames_need + 1;
+	if (input_frames_used > 0) {
+		frames = rechannel(ch2layout(src->old_channel_num), ch2layout(src->new_channel_num), \
+						(const int16_t *)src_data->data_in, input_frames_used, \
+						src->in_buffer + src->left_frames * src->new_channel_num, input_frames_used);
+		RETURN_VAL_IF_FAIL((frames == input_frames_used), SRC_ERR_UNKNOWN);
+		src->left_frames += input_frames_used;
 	}
 
-	int output_frames_gen = 0;
-	// Reserve overlap frames, then do converting process with available frames
-	frames = MINIMUM(src->left_frames - src->overlap_frames, (int)input_frames_need);
-	if (frames > 0) {
-		output_frames_gen = src->src_func(src, &frames);
-		if (output_frames_gen != 0) {
-			src->used_frames = frames;
-			src->left_frames -= frames;
-		}
+	int output_frames_gen = resample_polyphase(src, (int16_t *)src_data->data_out, out_buffer_frames);
+
+	// Drop the frames no later output needs, the filter span stays in the buffer
+	if (src->position > 0) {
+		int used_frames = MINIMUM(src->position, src->left_frames);
+		memmove(src->in_buffer, src->in_buffer + used_frames * src->new_channel_num, \
+				NEW_FRAMES_TO_BYTES(src, src->left_frames - used_frames));
+		src->left_frames -= used_frames;
+		src->position -= used_frames;
 	}
 
 	src_data->input_frames_used = input_frames_used;
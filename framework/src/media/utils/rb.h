@@ -102,6 +102,36 @@ size_t rb_read(rb_p rbp, void *ptr, size_t len);
  */
 size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset);
 
+/**
+ * @brief  Get the data at the read index that is contiguous in memory,
+ *         so that it can be used in place instead of being copied.
+ *         Release it with rb_read(rbp, NULL, len) once it is used.
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  ptr: Returns the start of the data
+ * @return size of the contiguous data, less than rb_used() when the
+ *         data wraps around the end of the buffer.
+ */
+size_t rb_read_region(rb_p rbp, void **ptr);
+
+/**
+ * @brief  Get the free space at the write index that is contiguous in
+ *         memory, so that new data can be produced in place.
+ *         Publish it with rb_write_commit() once it is filled.
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  ptr: Returns the start of the free space
+ * @return size of the contiguous free space, less than rb_avail() when
+ *         the free space wraps around the end of the buffer.
+ */
+size_t rb_write_region(rb_p rbp, void **ptr);
+
+/**
+ * @brief  Increase wr_idx over data written in place by the caller.
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  len: length of the data written
+ * @return size wr_idx increased, range[0, len]
+ */
+size_t rb_write_commit(rb_p rbp, size_t len);
+
 /**
  * @brief  Reset ring-buffer, data in ring-buffer will be dropped.
  * @param  rbp: Pointer to the ring-buffer object
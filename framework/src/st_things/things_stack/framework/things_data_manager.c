@@ -20,7 +20,11 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <json/cJSON.h>
+#include <json/cJSON_Stream.h>
 #include <tinyara/hashmap.h>
 
 #include "octypes.h"
@@ -46,6 +50,9 @@
 #include <security/security_api.h>
 #define TAG "[things_datamgr]"
 
+/* Read and write chunk of the streamed JSON files */
+#define JSON_STREAM_BUFFER_SIZE                                 (256)
+
 /* device define JSON */
 #define KEY_DEVICE                                              "device"
 #define KEY_DEVICE_SPECIFICATION                                "specification"
@@ -778,6 +785,113 @@ int set_json_string_into_file(const char *filename, const char *json_str)
 	return 1;
 }
 
+// Replaces filename with the complete file tmp_path. rename() does not replace an existing file on every
+// file system (smartfs fails with EEXIST), so the old file is removed first. If the power is lost in between,
+// recover_json_file() completes the update.
+int replace_json_file(const char *tmp_path, const char *filename)
+{
+	if (unlink(filename) != 0 && errno != ENOENT) {
+		THINGS_LOG_V(TAG, "Failed to remove \"%s\" (%d).", filename, errno);
+		return 0;
+	}
+	if (rename(tmp_path, filename) != 0) {
+		THINGS_LOG_V(TAG, "Failed to rename \"%s\" (%d).", tmp_path, errno);
+		return 0;
+	}
+	return 1;
+}
+
+// Finishes or discards an update that replace_json_file() did not complete. Without filename, tmp_path is
+// complete, because the old file is only removed after it was closed. Next to filename, it is left over from
+// an interrupted write.
+void recover_json_file(const char *tmp_path, const char *filename)
+{
+	struct stat st;
+
+	if (stat(tmp_path, &st) != 0) {
+		return;
+	}
+	if (stat(filename, &st) == 0) {
+		unlink(tmp_path);
+	} else if (rename(tmp_path, filename) != 0) {
+		THINGS_LOG_V(TAG, "Failed to restore \"%s\" (%d).", filename, errno);
+	}
+}
+
+static int json_file_read(void *context, char *buffer, size_t size)
+{
+	FILE *fp = (FILE *)context;
+	size_t read = fread(buffer, 1, size, fp);
+
+	if (read == 0 && ferror(fp)) {
+		return -1;
+	}
+	return (int)read;
+}
+
+static int json_file_write(void *context, const char *buffer, size_t size)
+{
+	return (int)fwrite(buffer, 1, size, (FILE *)context);
+}
+
+// Builds a cJSON tree out of the value of one top-level member, the rest of the document is only streamed through.
+static cJSON *get_json_section(cJSON_Reader *reader, const char *key)
+{
+	if (cJSON_ReaderNext(reader) != cJSON_TokenObjectStart) {
+		return NULL;
+	}
+
+	while (cJSON_ReaderNext(reader) == cJSON_TokenKey) {
+		if (strcmp(reader->value, key) == 0) {
+			return cJSON_ReaderGetValue(reader);
+		}
+		if (!cJSON_ReaderSkipValue(reader)) {
+			break;
+		}
+	}
+	return NULL;
+}
+
+// Loads the "cloud" member of the cloud file. found tells whether there was a cloud file at all.
+static cJSON *load_cloud_json(const char *filename, bool *found)
+{
+	cJSON_Reader reader;
+	cJSON *cloud = NULL;
+#ifdef CONFIG_ST_THINGS_SECURESTORAGE
+	char *json_str = get_json_string_from_securestorage();
+
+	*found = (json_str != NULL && strlen(json_str) > 0);
+	if (*found) {
+		cJSON_InitStringReader(&reader, json_str, strlen(json_str), NULL, 0);
+		cloud = get_json_section(&reader, KEY_CLOUD);
+		cJSON_ReleaseReader(&reader);
+	}
+	if (json_str != NULL) {
+		things_free(json_str);
+	}
+#else
+	char window[JSON_STREAM_BUFFER_SIZE];
+	char tmp_path[MAX_FILE_PATH_LENGTH + 5];
+	FILE *fp = NULL;
+
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", filename);
+	recover_json_file(tmp_path, filename);
+	*found = (get_json_file_size(filename) > 0);
+	if (*found) {
+		fp = fopen(filename, "r");
+	}
+	if (fp != NULL) {
+		cJSON_InitReader(&reader, json_file_read, fp, window, sizeof(window), NULL, 0);
+		cloud = get_json_section(&reader, KEY_CLOUD);
+		cJSON_ReleaseReader(&reader);
+		fclose(fp);
+	} else {
+		*found = false;
+	}
+#endif
+	return cloud;
+}
+
 static int get_json_int(cJSON *json, int64_t *variable)
 {
 	THINGS_LOG_D(TAG, THINGS_FUNC_ENTRY);
@@ -948,14 +1062,10 @@ int parse_things_cloud_json(const char *filename)
 	THINGS_LOG_D(TAG, THINGS_FUNC_ENTRY);
 
 	int ret = 0;
-	char *json_str = NULL;
-#ifdef CONFIG_ST_THINGS_SECURESTORAGE
-	json_str = get_json_string_from_securestorage();
-#else
-	json_str = get_json_string_from_file(filename);
-#endif
+	bool found = false;
+	cJSON *cloud = load_cloud_json(filename, &found);
 
-	if (json_str == NULL) {
+	if (!found) {
 		THINGS_LOG_V(TAG, "cloud file initialization.");
 #ifdef CONFIG_ST_THINGS_SECURESTORAGE
 		if (set_json_string_into_securestorage(origin_cloud_json_str) == 0) {
@@ -968,24 +1078,18 @@ int parse_things_cloud_json(const char *filename)
 			return 0;
 		}
 #endif
-	} else {
-		if (strlen(json_str) > 0) {
-			cJSON *root = cJSON_Parse((const char *)json_str);
-			if (root != NULL) {
-				cJSON *cloud = cJSON_GetObjectItem(root, KEY_CLOUD);
-				if (cloud != NULL) {
-					cJSON *address = cJSON_GetObjectItem(cloud, KEY_CLOUD_ADDRESS);
-					if (address != NULL) {
-						memset(g_cloud_address, 0, (size_t) MAX_CLOUD_ADDRESS);
-						memcpy(g_cloud_address, address->valuestring, strlen(address->valuestring) + 1);
-						THINGS_LOG_D(TAG, "[CLOUD] CI Address : %s", g_cloud_address);
-						ret = 1;
-					}
-				}
-				cJSON_Delete(root);
-			}
+	} else if (cloud != NULL) {
+		cJSON *address = cJSON_GetObjectItem(cloud, KEY_CLOUD_ADDRESS);
+		if (address != NULL) {
+			memset(g_cloud_address, 0, (size_t) MAX_CLOUD_ADDRESS);
+			memcpy(g_cloud_address, address->valuestring, strlen(address->valuestring) + 1);
+			THINGS_LOG_D(TAG, "[CLOUD] CI Address : %s", g_cloud_address);
+			ret = 1;
 		}
-		things_free(json_str);
+	}
+
+	if (cloud != NULL) {
+		cJSON_Delete(cloud);
 	}
 
 	THINGS_LOG_D(TAG, THINGS_FUNC_EXIT);
@@ -1757,43 +1861,88 @@ static int parse_things_info_json(const char *filename)
 	THINGS_LOG_D(TAG, THINGS_FUNC_ENTRY);
 
 	int ret = 0;
-	char *json_str = get_json_string_from_file(filename);
-	cJSON *json_user_root = NULL;
-
-	if (json_str != NULL && strlen(json_str) > 0) {
-		// 3. Parse the Json string
-		json_user_root = cJSON_Parse((const char *)json_str);
-		assert(json_user_root != NULL);
+	int token;
+	bool has_device = false;
+	bool has_resource_types = false;
+	bool has_configuration = false;
+	char window[JSON_STREAM_BUFFER_SIZE];
+	cJSON_Reader reader;
+	cJSON *section = NULL;
+	FILE *fp = fopen(filename, "r");
 
-		// Device Items
-		cJSON *devices = cJSON_GetObjectItem(json_user_root, KEY_DEVICE);
-		if (devices == NULL) {
-			THINGS_LOG_E(TAG, "device is NULL");
+	// The info file is streamed and only one top-level member is held as a cJSON tree at a time.
+	cJSON_InitReader(&reader, json_file_read, fp, window, sizeof(window), NULL, 0);
+	if (fp != NULL) {
+		if (cJSON_ReaderNext(&reader) != cJSON_TokenObjectStart) {
+			THINGS_LOG_E(TAG, "info file is not a JSON object");
 			goto JSON_ERROR;
 		}
 
-		int device_cnt = cJSON_GetArraySize(devices);
-		THINGS_LOG_D(TAG, "device_cnt = %d", device_cnt);
+		while ((token = cJSON_ReaderNext(&reader)) == cJSON_TokenKey) {
+			if (strcmp(reader.value, KEY_DEVICE) == 0 && !has_device) {
+				// Device Items
+				has_device = true;
+				section = cJSON_ReaderGetValue(&reader);
+				if (section == NULL) {
+					break;
+				}
+				int device_cnt = cJSON_GetArraySize(section);
+				THINGS_LOG_D(TAG, "device_cnt = %d", device_cnt);
 
-		if (device_cnt > 1) {
-			THINGS_LOG_E(TAG, "not supported one more deice");
-			goto JSON_ERROR;
+				if (device_cnt > 1) {
+					THINGS_LOG_E(TAG, "not supported one more deice");
+					goto JSON_ERROR;
+				}
+
+				cJSON *device = cJSON_GetArrayItem(section, 0);
+				if (parse_device_json(device) == 0) {
+					THINGS_LOG_E(TAG, "parse_device_json fail");
+					goto JSON_ERROR;
+				}
+			} else if (strcmp(reader.value, KEY_RESOURCES_TYPE) == 0 && !has_resource_types) {
+				has_resource_types = true;
+				section = cJSON_ReaderGetValue(&reader);
+				if (section == NULL) {
+					break;
+				}
+				if (parse_resource_type_json_with_internal(section) == 0) {
+					THINGS_LOG_E(TAG, "parse_resource_type_json fail");
+					goto JSON_ERROR;
+				}
+			} else if (strcmp(reader.value, KEY_CONFIGURATION) == 0 && !has_configuration) {
+				has_configuration = true;
+				section = cJSON_ReaderGetValue(&reader);
+				if (section == NULL) {
+					break;
+				}
+				if (parse_configuration_json(section) == 0) {
+					THINGS_LOG_E(TAG, "parse_configuration_json fail");
+					goto JSON_ERROR;
+				}
+			} else if (!cJSON_ReaderSkipValue(&reader)) {
+				break;
+			}
+
+			if (section != NULL) {
+				cJSON_Delete(section);
+				section = NULL;
+			}
 		}
 
-		cJSON *device = cJSON_GetArrayItem(devices, 0);
-		if (parse_device_json(device) == 0) {
-			THINGS_LOG_E(TAG, "parse_device_json fail");
+		if (token != cJSON_TokenObjectEnd) {
+			THINGS_LOG_E(TAG, "info file is malformed");
 			goto JSON_ERROR;
 		}
 
-		cJSON *resource_types = cJSON_GetObjectItem(json_user_root, KEY_RESOURCES_TYPE);
-		if (parse_resource_type_json_with_internal(resource_types) == 0) {
+		if (!has_device) {
+			THINGS_LOG_E(TAG, "device is NULL");
+			goto JSON_ERROR;
+		}
+		if (!has_resource_types && parse_resource_type_json_with_internal(NULL) == 0) {
 			THINGS_LOG_E(TAG, "parse_resource_type_json fail");
 			goto JSON_ERROR;
 		}
-
-		cJSON *configuration = cJSON_GetObjectItem(json_user_root, KEY_CONFIGURATION);
-		if (parse_configuration_json(configuration) == 0) {
+		if (!has_configuration && parse_configuration_json(NULL) == 0) {
 			THINGS_LOG_E(TAG, "parse_configuration_json fail");
 			goto JSON_ERROR;
 		}
@@ -1805,12 +1954,13 @@ static int parse_things_info_json(const char *filename)
 
 	ret = 1;
 JSON_ERROR:
-	if (json_user_root != NULL) {
-		cJSON_Delete(json_user_root);
+	if (section != NULL) {
+		cJSON_Delete(section);
 	}
 
-	if (json_str != NULL) {
-		things_free(json_str);
+	cJSON_ReleaseReader(&reader);
+	if (fp != NULL) {
+		fclose(fp);
 	}
 
 	THINGS_LOG_D(TAG, THINGS_FUNC_EXIT);
@@ -1822,145 +1972,230 @@ static int get_signup_data_from_json(const char *filename, es_cloud_signup_s **c
 	THINGS_LOG_D(TAG, THINGS_FUNC_ENTRY);
 
 	int ret = 1;
-#ifdef CONFIG_ST_THINGS_SECURESTORAGE
-	char *json_str = get_json_string_from_securestorage();
-#else
-	char *json_str = get_json_string_from_file(filename);
-#endif
-	cJSON *root = NULL;
-	cJSON *cloud = NULL;
+	bool found = false;
+	cJSON *cloud = load_cloud_json(filename, &found);
 
-	if (json_str != NULL && strlen(json_str) > 0) {
-		root = cJSON_Parse((const char *)json_str);
-		cloud = cJSON_GetObjectItem(root, KEY_CLOUD);
-		if (cloud == NULL) {
-			THINGS_LOG_V(TAG, "cloud cJSON is NULL.");
-			ret = 0;
-			goto JSON_ERROR;
-		} else if ((ret = load_cloud_signup_data(cloud, cl_data)) != 1) {
-			THINGS_LOG_V(TAG, "Load Cloud SignUp Data Failed.");
-		}
-	} else {
+	if (!found) {
 		THINGS_LOG_V(TAG, "cloud file Reading is failed.");
 		ret = 0;
-		goto JSON_ERROR;
-	}
-JSON_ERROR:
-	if (root != NULL) {
-		cJSON_Delete(root);
+	} else if (cloud == NULL) {
+		THINGS_LOG_V(TAG, "cloud cJSON is NULL.");
+		ret = 0;
+	} else if ((ret = load_cloud_signup_data(cloud, cl_data)) != 1) {
+		THINGS_LOG_V(TAG, "Load Cloud SignUp Data Failed.");
 	}
-	if (json_str != NULL) {
-		things_free(json_str);
+
+	if (cloud != NULL) {
+		cJSON_Delete(cloud);
 	}
 
 	THINGS_LOG_D(TAG, THINGS_FUNC_EXIT);
 	return ret;
 }
 
-static int update_things_cloud_json_by_cloud_signup(const char *filename, es_cloud_signup_s *cl_data)
+static int update_cloud_json(cJSON *cloud, es_cloud_signup_s *cl_data)
 {
-	THINGS_LOG_D(TAG, THINGS_FUNC_ENTRY);
+	cJSON_DeleteItemFromObject(cloud, KEY_CLOUD_ADDRESS);
+	cJSON_DeleteItemFromObject(cloud, KEY_CLOUD_DOMAIN);
+	cJSON_DeleteItemFromObject(cloud, KEY_CLOUD_PORT);
+	cJSON_DeleteItemFromObject(cloud, KEY_TOKEN_ACCESS);
+	cJSON_DeleteItemFromObject(cloud, KEY_TOKEN_ACCESS_REFRESH);
+	cJSON_DeleteItemFromObject(cloud, KEY_TOKEN_TYPE);
+	cJSON_DeleteItemFromObject(cloud, KEY_EXPIRE_TIME);
+	cJSON_DeleteItemFromObject(cloud, KEY_ID_USER);
+	cJSON_DeleteItemFromObject(cloud, KEY_SERVER_REDIRECT_URI);
+	cJSON_DeleteItemFromObject(cloud, KEY_CERTIFICATE_FILE);
+	cJSON_DeleteItemFromObject(cloud, KEY_SERVER_ID);
+	memset(g_cloud_address, 0, MAX_CLOUD_ADDRESS);
+	if (things_strcat(g_cloud_address, MAX_CLOUD_ADDRESS, cl_data->address) == NULL) {
+		THINGS_LOG_V(TAG, "Fail : Copy to g_cloud_address.");
+		return 0;
+	}
+	if (cl_data->domain != NULL && strlen(cl_data->domain) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_CLOUD_DOMAIN, cl_data->domain);
+	}
+	if (cl_data->address != NULL && strlen(cl_data->address) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_CLOUD_ADDRESS, cl_data->address);
+	}
+	if (cl_data->port != NULL && strlen(cl_data->port) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_CLOUD_PORT, cl_data->port);
+	}
+	if (cl_data->access_token != NULL && strlen(cl_data->access_token) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_TOKEN_ACCESS, cl_data->access_token);
+	}
+	if (cl_data->refresh_token != NULL && strlen(cl_data->refresh_token) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_TOKEN_ACCESS_REFRESH, cl_data->refresh_token);
+	}
+	if (cl_data->token_type != NULL && strlen(cl_data->token_type) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_TOKEN_TYPE, cl_data->token_type);
+	}
+	if (cl_data->expire_time != CLOUD_EXPIRESIN_INVALID) {
+		cJSON_AddNumberToObject(cloud, KEY_EXPIRE_TIME, cl_data->expire_time);
+	}
+	if (cl_data->uid != NULL && strlen(cl_data->uid) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_ID_USER, cl_data->uid);
+	}
+	if (cl_data->redirect_uri != NULL && strlen(cl_data->redirect_uri) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_SERVER_REDIRECT_URI, cl_data->redirect_uri);
+	}
+	if (cl_data->certificate != NULL && strlen(cl_data->certificate) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_CERTIFICATE_FILE, cl_data->certificate);
+	}
+	if (cl_data->sid != NULL && strlen(cl_data->sid) > 0) {
+		cJSON_AddStringToObject(cloud, KEY_SERVER_ID, cl_data->sid);
+	}
+	return 1;
+}
 
+// Copies the cloud document from reader to writer one top-level member at a time, with the cloud member updated on the way.
+static int write_cloud_json(cJSON_Reader *reader, cJSON_Writer *writer, es_cloud_signup_s *cl_data)
+{
 	int ret = 0;
-	cJSON *root = NULL;
-	char *json_update = NULL;
-#ifdef CONFIG_ST_THINGS_SECURESTORAGE
-	char *json_str = get_json_string_from_securestorage();
-#else
-	char *json_str = get_json_string_from_file(filename);
-#endif
+	int token;
+	bool has_cloud = false;
+	char *name = NULL;
+	cJSON *value = NULL;
 
-	if (json_str != NULL && strlen(json_str) > 0) {
-		root = cJSON_Parse((const char *)json_str);
-		cJSON *cloud = cJSON_GetObjectItem(root, KEY_CLOUD);
-		if (cloud == NULL) {
-			THINGS_LOG_V(TAG, "cloud cJSON is NULL.");
+	if (cJSON_ReaderNext(reader) != cJSON_TokenObjectStart) {
+		return 0;
+	}
+	cJSON_WriteObjectStart(writer, NULL);
+
+	while ((token = cJSON_ReaderNext(reader)) == cJSON_TokenKey) {
+		name = things_strdup(reader->value);
+		value = cJSON_ReaderGetValue(reader);
+		if (name == NULL || value == NULL) {
 			goto GOTO_OUT;
 		}
 
-		cJSON_DeleteItemFromObject(cloud, KEY_CLOUD_ADDRESS);
-		cJSON_DeleteItemFromObject(cloud, KEY_CLOUD_DOMAIN);
-		cJSON_DeleteItemFromObject(cloud, KEY_CLOUD_PORT);
-		cJSON_DeleteItemFromObject(cloud, KEY_TOKEN_ACCESS);
-		cJSON_DeleteItemFromObject(cloud, KEY_TOKEN_ACCESS_REFRESH);
-		cJSON_DeleteItemFromObject(cloud, KEY_TOKEN_TYPE);
-		cJSON_DeleteItemFromObject(cloud, KEY_EXPIRE_TIME);
-		cJSON_DeleteItemFromObject(cloud, KEY_ID_USER);
-		cJSON_DeleteItemFromObject(cloud, KEY_SERVER_REDIRECT_URI);
-		cJSON_DeleteItemFromObject(cloud, KEY_CERTIFICATE_FILE);
-		cJSON_DeleteItemFromObject(cloud, KEY_SERVER_ID);
-		memset(g_cloud_address, 0, MAX_CLOUD_ADDRESS);
-		if (cl_data != NULL) {
-			if (things_strcat(g_cloud_address, MAX_CLOUD_ADDRESS, cl_data->address) == NULL) {
-				THINGS_LOG_V(TAG, "Fail : Copy to g_cloud_address.");
+		if (strcmp(name, KEY_CLOUD) == 0 && !has_cloud) {
+			has_cloud = true;
+			if (update_cloud_json(value, cl_data) == 0) {
 				goto GOTO_OUT;
 			}
-			if (cl_data->domain != NULL && strlen(cl_data->domain) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_CLOUD_DOMAIN, cl_data->domain);
-			}
-			if (cl_data->address != NULL && strlen(cl_data->address) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_CLOUD_ADDRESS, cl_data->address);
-			}
-			if (cl_data->port != NULL && strlen(cl_data->port) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_CLOUD_PORT, cl_data->port);
-			}
-			if (cl_data->access_token != NULL && strlen(cl_data->access_token) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_TOKEN_ACCESS, cl_data->access_token);
-			}
-			if (cl_data->refresh_token != NULL && strlen(cl_data->refresh_token) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_TOKEN_ACCESS_REFRESH, cl_data->refresh_token);
-			}
-			if (cl_data->token_type != NULL && strlen(cl_data->token_type) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_TOKEN_TYPE, cl_data->token_type);
-			}
-			if (cl_data->expire_time != CLOUD_EXPIRESIN_INVALID) {
-				cJSON_AddNumberToObject(cloud, KEY_EXPIRE_TIME, cl_data->expire_time);
-			}
-			if (cl_data->uid != NULL && strlen(cl_data->uid) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_ID_USER, cl_data->uid);
-			}
-			if (cl_data->redirect_uri != NULL && strlen(cl_data->redirect_uri) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_SERVER_REDIRECT_URI, cl_data->redirect_uri);
-			}
-			if (cl_data->certificate != NULL && strlen(cl_data->certificate) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_CERTIFICATE_FILE, cl_data->certificate);
-			}
-			if (cl_data->sid != NULL && strlen(cl_data->sid) > 0) {
-				cJSON_AddStringToObject(cloud, KEY_SERVER_ID, cl_data->sid);
-			}
-			json_update = cJSON_Print(root);
-		} else {
-			json_update = things_malloc(sizeof(char) * (strlen(origin_cloud_json_str) + 1));
-			strncpy(json_update, origin_cloud_json_str, strlen(origin_cloud_json_str) + 1);
 		}
+		if (!cJSON_WriteItem(writer, name, value)) {
+			goto GOTO_OUT;
+		}
+
+		things_free(name);
+		name = NULL;
+		cJSON_Delete(value);
+		value = NULL;
+	}
+
+	if (token != cJSON_TokenObjectEnd) {
+		goto GOTO_OUT;
+	}
+	if (!has_cloud) {
+		THINGS_LOG_V(TAG, "cloud cJSON is NULL.");
+		goto GOTO_OUT;
+	}
+	cJSON_WriteObjectEnd(writer);
+	ret = (cJSON_WriterFinish(writer) >= 0);
+
+GOTO_OUT:
+	if (name != NULL) {
+		things_free(name);
+	}
+	if (value != NULL) {
+		cJSON_Delete(value);
+	}
+	return ret;
+}
+
+static int update_things_cloud_json_by_cloud_signup(const char *filename, es_cloud_signup_s *cl_data)
+{
+	THINGS_LOG_D(TAG, THINGS_FUNC_ENTRY);
+
+	int ret = 0;
+	cJSON_Reader reader;
+	cJSON_Writer writer;
+
+	if (cl_data == NULL) {
+		bool found = false;
+		cJSON *cloud = load_cloud_json(filename, &found);
+
+		if (cloud == NULL) {
+			THINGS_LOG_V(TAG, "cloud cJSON is NULL.");
+			goto GOTO_OUT;
+		}
+		cJSON_Delete(cloud);
 #ifdef CONFIG_ST_THINGS_SECURESTORAGE
-		if (set_json_string_into_securestorage(json_update) == 0) {
+		if (set_json_string_into_securestorage(origin_cloud_json_str) == 0) {
 			THINGS_LOG_V(TAG, "Fail : Store data to info securestorage.");
 			goto GOTO_OUT;
 		}
 #else
-		if (set_json_string_into_file(filename, json_update) == 0) {
+		if (set_json_string_into_file(filename, origin_cloud_json_str) == 0) {
 			THINGS_LOG_V(TAG, "Fail : Store data to info file.");
 			goto GOTO_OUT;
 		}
 #endif
 		ret = 1;
+	} else {
+#ifdef CONFIG_ST_THINGS_SECURESTORAGE
+		// The secure storage holds at most two blocks, so that bounds the output as well.
+		size_t json_size = SECURESTOARGE_MAX_DATA_SIZE * 2 + 1;
+		char *json_str = get_json_string_from_securestorage();
+		char *json_update = (char *)things_malloc(json_size);
+
+		if (json_str != NULL && json_update != NULL) {
+			cJSON_InitStringReader(&reader, json_str, strlen(json_str), NULL, 0);
+			cJSON_InitWriter(&writer, NULL, NULL, json_update, json_size, true);
+			ret = write_cloud_json(&reader, &writer, cl_data);
+			cJSON_ReleaseReader(&reader);
+			if (ret == 1 && set_json_string_into_securestorage(json_update) == 0) {
+				THINGS_LOG_V(TAG, "Fail : Store data to info securestorage.");
+				ret = 0;
+			}
+		}
+		if (json_str != NULL) {
+			things_free(json_str);
+		}
+		if (json_update != NULL) {
+			things_free(json_update);
+		}
+#else
+		// Stream into a temporary file next to the original and replace it once complete.
+		char window[JSON_STREAM_BUFFER_SIZE];
+		char buffer[JSON_STREAM_BUFFER_SIZE];
+		char tmp_path[MAX_FILE_PATH_LENGTH + 5];
+		FILE *in = NULL;
+		FILE *out = NULL;
+
+		snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", filename);
+		recover_json_file(tmp_path, filename);
+		in = fopen(filename, "r");
+		if (in != NULL) {
+			out = fopen(tmp_path, "w");
+		}
+		if (out != NULL) {
+			cJSON_InitReader(&reader, json_file_read, in, window, sizeof(window), NULL, 0);
+			cJSON_InitWriter(&writer, json_file_write, out, buffer, sizeof(buffer), true);
+			ret = write_cloud_json(&reader, &writer, cl_data);
+			cJSON_ReleaseReader(&reader);
+			if (fclose(out) != 0) {
+				ret = 0;
+			}
+		}
+		if (in != NULL) {
+			fclose(in);
+		}
+		if (ret == 1 && replace_json_file(tmp_path, filename) == 0) {
+			THINGS_LOG_V(TAG, "Fail : Store data to info file.");
+			ret = 0;
+		}
+		if (out != NULL && ret == 0 && access(filename, F_OK) == 0) {
+			remove(tmp_path);
+		}
+#endif
+		if (ret == 0) {
+			goto GOTO_OUT;
+		}
 	}
 	THINGS_LOG_D(TAG, "Update Success in \"%s\" file.", filename);
 GOTO_OUT:
-	if (root != NULL) {
-		cJSON_Delete(root);
-		root = NULL;
-	}
-
-	if (json_str != NULL) {
-		things_free(json_str);
-	}
-
-	if (json_update != NULL) {
-		things_free(json_update);
-	}
-
 	THINGS_LOG_D(TAG, THINGS_FUNC_EXIT);
 	return ret;
 }
@@ -153,6 +153,8 @@ char *dm_get_firmware_version(void);
 char *dm_get_vendor_id(void);
 char *dm_get_model_number(void);
 char *get_json_string_from_file(const char *filename);
+int replace_json_file(const char *tmp_path, const char *filename);
+void recover_json_file(const char *tmp_path, const char *filename);
 int set_json_string_into_file(const char *filename, const char *json_str);
 typedef enum {
 	es_conn_type_none = 0,
@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <string.h>
+#include <sched.h>
+#include <debug.h>
+#include <sys/types.h>
+#include <task_manager/task_manager.h>
+#include "task_manager_internal.h"
+
+/****************************************************************************
+ * Private Definitions
+ ****************************************************************************/
+/* Entries start out with status 0, which the task manager never publishes,
+ * so readers see every handle as unregistered until the first publication.
+ */
+static tm_app_entry_t tm_app_table[CONFIG_TASK_MANAGER_MAX_TASKS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static bool taskmgr_app_table_is_same(volatile tm_app_entry_t *entry, const tm_app_entry_t *app)
+{
+	return entry->pid == app->pid && entry->tm_gid == app->tm_gid && entry->status == app->status && entry->permission == app->permission && entry->name_truncated == app->name_truncated && strncmp((const char *)entry->name, app->name, CONFIG_TASK_NAME_SIZE + 1) == 0;
+}
+
+static int taskmgr_app_table_add_info(tm_appinfo_list_t **list, int handle, tm_app_entry_t *app)
+{
+	tm_appinfo_list_t *item;
+	int name_len;
+
+	item = (tm_appinfo_list_t *)TM_ALLOC(sizeof(tm_appinfo_list_t));
+	if (item == NULL) {
+		tmdbg("Memory allocation Failed\n");
+		return TM_OUT_OF_MEMORY;
+	}
+
+	name_len = strlen(app->name);
+	item->task.name = (char *)TM_ALLOC(name_len + 1);
+	if (item->task.name == NULL) {
+		tmdbg("Memory allocation for name Failed\n");
+		TM_FREE(item);
+		return TM_OUT_OF_MEMORY;
+	}
+
+	strncpy(item->task.name, app->name, name_len + 1);
+
+	item->task.tm_gid = app->tm_gid;
+	item->task.handle = handle;
+	item->task.status = app->status;
+	item->task.permission = app->permission;
+	item->next = *list;
+
+	*list = item;
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+/****************************************************************************
+ * taskmgr_app_table_publish
+ ****************************************************************************/
+void taskmgr_app_table_publish(int handle, const tm_app_entry_t *app)
+{
+	volatile tm_app_entry_t *entry = &tm_app_table[handle];
+
+	(void)sched_lock();
+
+	if (!taskmgr_app_table_is_same(entry, app)) {
+		entry->seq++;
+		TM_APP_TABLE_BARRIER();
+
+		entry->pid = app->pid;
+		entry->tm_gid = app->tm_gid;
+		entry->status = app->status;
+		entry->permission = app->permission;
+		entry->name_truncated = app->name_truncated;
+		strncpy((char *)entry->name, app->name, CONFIG_TASK_NAME_SIZE + 1);
+
+		TM_APP_TABLE_BARRIER();
+		entry->seq++;
+	}
+
+	(void)sched_unlock();
+}
+
+/****************************************************************************
+ * taskmgr_app_table_read
+ ****************************************************************************/
+bool taskmgr_app_table_read(int handle, tm_app_entry_t *app)
+{
+	volatile tm_app_entry_t *entry = &tm_app_table[handle];
+	uint32_t seq;
+
+	do {
+		/* An odd count means that the entry is being updated */
+
+		while ((seq = entry->seq) & 1) {
+			(void)sched_yield();
+		}
+
+		TM_APP_TABLE_BARRIER();
+		memcpy(app, (const void *)entry, sizeof(tm_app_entry_t));
+		TM_APP_TABLE_BARRIER();
+	} while (entry->seq != seq);
+
+	app->name[CONFIG_TASK_NAME_SIZE] = '\0';
+
+	if (app->status == 0 || app->status == TM_APP_STATE_UNREGISTERED) {
+		return false;
+	}
+
+	/* The task manager only notices that a task exited when it is asked about
+	 * it. Do the same check, without changing the table.
+	 */
+
+	if (app->status == TM_APP_STATE_RUNNING || app->status == TM_APP_STATE_PAUSE) {
+		struct sched_param param;
+
+		if (sched_getparam(app->pid, &param) != OK) {
+			app->status = TM_APP_STATE_STOP;
+		}
+	}
+
+	return true;
+}
+
+/****************************************************************************
+ * taskmgr_app_table_getinfo
+ *
+ * Builds the info list of the apps that a TASKMGRCMD_SCAN_* request would
+ * find, with 'key' being the handle, group or pid. Returns OK, a negative
+ * value as the task manager would, or TM_NOT_SUPPORTED if only the task
+ * manager can answer because a name is longer than the table keeps.
+ ****************************************************************************/
+int taskmgr_app_table_getinfo(int cmd, int key, const char *name, tm_appinfo_list_t **list)
+{
+	tm_app_entry_t app;
+	int handle;
+	int first;
+	int last;
+	int ret;
+
+	*list = NULL;
+
+	if (cmd == TASKMGRCMD_SCAN_HANDLE) {
+		if (IS_INVALID_HANDLE(key)) {
+			return TM_INVALID_PARAM;
+		}
+		first = last = key;
+	} else {
+		if (cmd == TASKMGRCMD_SCAN_NAME && strlen(name) > CONFIG_TASK_NAME_SIZE) {
+			return TM_NOT_SUPPORTED;
+		}
+		first = 0;
+		last = CONFIG_TASK_MANAGER_MAX_TASKS - 1;
+	}
+
+	ret = TM_UNREGISTERED_APP;
+
+	for (handle = first; handle <= last; handle++) {
+		if (!taskmgr_app_table_read(handle, &app)) {
+			continue;
+		}
+
+		if (cmd == TASKMGRCMD_SCAN_NAME) {
+			/* A truncated name is longer than the one looked for */
+			if (app.name_truncated || strncmp(app.name, name, CONFIG_TASK_NAME_SIZE + 1) != 0) {
+				continue;
+			}
+		} else if (cmd == TASKMGRCMD_SCAN_GROUP) {
+			if (app.tm_gid != key) {
+				continue;
+			}
+		} else if (cmd == TASKMGRCMD_SCAN_PID) {
+			if (app.pid != key) {
+				continue;
+			}
+		}
+
+		if (app.name_truncated) {
+			task_manager_clean_infolist(list);
+			return TM_NOT_SUPPORTED;
+		}
+
+		ret = taskmgr_app_table_add_info(list, handle, &app);
+		if (ret != OK) {
+			task_manager_clean_infolist(list);
+			return ret;
+		}
+
+		if (cmd == TASKMGRCMD_SCAN_PID) {
+			break;
+		}
+	}
+
+	return ret;
+}
@@ -60,6 +60,8 @@ static app_list_t tm_app_list[CONFIG_TASK_MANAGER_MAX_TASKS];
 static tm_task_info_t tm_task_list[CONFIG_TASK_MANAGER_MAX_TASKS];
 static bool g_handle_hash[CONFIG_TASK_MANAGER_MAX_TASKS];
 static int tm_broadcast_msg[TM_BROADCAST_MSG_MAX + CONFIG_TASK_MANAGER_MAX_TASKS];
+/* Broadcast callbacks of all apps, listed per msg through msg_flink */
+static tm_broadcast_info_t *tm_broadcast_subscribers[TM_BROADCAST_MSG_MAX + CONFIG_TASK_MANAGER_MAX_TASKS];
 static int task_manager_pid;
 
 #define MAX_HANDLE_MASK      (CONFIG_TASK_MANAGER_MAX_TASKS - 1)
@@ -100,6 +102,82 @@ app_list_t *taskmger_get_applist(int handle)
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
+static const char *taskmgr_get_app_name(int handle)
+{
+	if (TM_TYPE(handle) == TM_BUILTIN_TASK) {
+		return builtin_list[TM_IDX(handle)].name;
+	} else if (TM_TYPE(handle) == TM_TASK) {
+		return tm_task_list[TM_IDX(handle)].name;
+	}
+#ifndef CONFIG_DISABLE_PTHREAD
+	else if (TM_TYPE(handle) == TM_PTHREAD) {
+		return tm_pthread_list[TM_IDX(handle)].name;
+	}
+#endif
+	return NULL;
+}
+
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+/* Publish the current state of 'handle' to the shared app table */
+void taskmgr_update_app_table(int handle)
+{
+	tm_app_entry_t app;
+	const char *name;
+
+	memset(&app, 0, sizeof(tm_app_entry_t));
+
+	if (TM_LIST_ADDR(handle) == NULL) {
+		app.status = TM_APP_STATE_UNREGISTERED;
+	} else {
+		app.pid = TM_PID(handle);
+		app.tm_gid = TM_GID(handle);
+		app.status = TM_STATUS(handle);
+		app.permission = TM_PERMISSION(handle);
+
+		name = taskmgr_get_app_name(handle);
+		if (name != NULL) {
+			strncpy(app.name, name, CONFIG_TASK_NAME_SIZE);
+			app.name_truncated = (strlen(name) > CONFIG_TASK_NAME_SIZE);
+		}
+	}
+
+	taskmgr_app_table_publish(handle, &app);
+}
+
+/* Publish the app that 'request' changed. Lazy state updates, late
+ * unregistration and stop callbacks publish their own changes.
+ */
+static void taskmgr_publish_request(tm_request_t *request, int ret)
+{
+	switch (request->cmd) {
+	case TASKMGRCMD_REGISTER_BUILTIN:
+	case TASKMGRCMD_REGISTER_TASK:
+#ifndef CONFIG_DISABLE_PTHREAD
+	case TASKMGRCMD_REGISTER_PTHREAD:
+#endif
+		/* The new handle */
+		if (ret >= 0) {
+			taskmgr_update_app_table(ret);
+		}
+		break;
+
+	case TASKMGRCMD_UNREGISTER:
+	case TASKMGRCMD_START:
+	case TASKMGRCMD_STOP:
+	case TASKMGRCMD_RESTART:
+	case TASKMGRCMD_PAUSE:
+	case TASKMGRCMD_RESUME:
+		if (!IS_INVALID_HANDLE(request->handle)) {
+			taskmgr_update_app_table(request->handle);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+#endif
+
 static int taskmgr_open_driver(void)
 {
 	g_taskmgr_fd = open(TASK_MANAGER_DRVPATH, O_RDWR);
@@ -216,11 +294,42 @@ static int taskmgr_register_builtin(char *name, int permission, int caller_pid)
 	return handle;
 }
 
+/* Keep the subscribers in handle order, the order in which broadcasts were
+ * always delivered
+ */
+static void taskmgr_subscribe_broadcast(tm_broadcast_info_t *info)
+{
+	tm_broadcast_info_t **link;
+
+	for (link = &tm_broadcast_subscribers[info->msg - 1]; *link != NULL; link = &(*link)->msg_flink) {
+		if ((*link)->handle > info->handle) {
+			break;
+		}
+	}
+
+	info->msg_flink = *link;
+	*link = info;
+}
+
+static void taskmgr_unsubscribe_broadcast(tm_broadcast_info_t *info)
+{
+	tm_broadcast_info_t **link;
+
+	for (link = &tm_broadcast_subscribers[info->msg - 1]; *link != NULL; link = &(*link)->msg_flink) {
+		if (*link == info) {
+			*link = info->msg_flink;
+			info->msg_flink = NULL;
+			return;
+		}
+	}
+}
+
 static void taskmgr_clear_broadcast_info_list(int handle)
 {
 	tm_broadcast_info_t *curr;
 
 	while ((curr = (tm_broadcast_info_t *)sq_remfirst(&TM_BROADCAST_INFO_LIST(handle))) != NULL) {
+		taskmgr_unsubscribe_broadcast(curr);
 		TM_FREE(curr);
 	}
 }
@@ -274,6 +383,9 @@ static void *taskmgr_late_unregister(void *arg)
 		sleep(TM_INTERVAL_TRY_UNREGISTER);
 	}
 	taskmgr_execute_unregister((int)arg);
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	taskmgr_update_app_table((int)arg);
+#endif
 	return NULL;
 }
 
@@ -454,6 +566,9 @@ void taskmgr_update_stop_status(int signo, siginfo_t *data)
 
 	TM_FREE(TM_STOP_CB_INFO(handle));
 	TM_STOP_CB_INFO(handle) = NULL;
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	taskmgr_update_app_table(handle);
+#endif
 }
 
 static int taskmgr_stop(int handle, int caller_pid)
@@ -776,17 +891,7 @@ static int taskmgr_get_task_info(tm_appinfo_list_t **data, int handle)
 		return TM_OUT_OF_MEMORY;
 	}
 
-	if (TM_TYPE(handle) == TM_BUILTIN_TASK) {
-		name = builtin_list[TM_IDX(handle)].name;
-	} else if (TM_TYPE(handle) == TM_TASK) {
-		name = tm_task_list[TM_IDX(handle)].name;
-	}
-#ifndef CONFIG_DISABLE_PTHREAD
-	else {
-		name = tm_pthread_list[TM_IDX(handle)].name;
-	}
-#endif
-
+	name = taskmgr_get_app_name(handle);
 	name_len = strlen(name);
 
 	item->task.name = (char *)TM_ALLOC(name_len + 1);
@@ -956,41 +1061,37 @@ static int taskmgr_broadcast(tm_internal_msg_t *arg)
 		return ret;
 	}
 
-	for (handle = 0; handle < CONFIG_TASK_MANAGER_MAX_TASKS; handle++) {
-		if (TM_LIST_ADDR(handle) != NULL) {
-			ret = taskmgr_get_task_state(handle);
-			if (ret == TM_APP_STATE_STOP || ret == TM_APP_STATE_UNREGISTERED) {
-				continue;
-			}
-			ret = taskmgr_handle_tcb(TMIOC_BROADCAST, TM_PID(handle), NULL);
-			if (ret != OK) {
-				continue;
-			}
-			broadcast_info = taskmgr_search_broadcast_info(arg->type, handle);
-			if (broadcast_info == NULL) {
-				continue;
-			}
-			bm = (tm_broadcast_internal_msg_t *)TM_ALLOC(sizeof(tm_broadcast_internal_msg_t));
-			if (bm == NULL) {
+	/* Only the apps that set a callback for this msg */
+	for (broadcast_info = tm_broadcast_subscribers[arg->type - 1]; broadcast_info != NULL; broadcast_info = broadcast_info->msg_flink) {
+		handle = broadcast_info->handle;
+		ret = taskmgr_get_task_state(handle);
+		if (ret == TM_APP_STATE_STOP || ret == TM_APP_STATE_UNREGISTERED) {
+			continue;
+		}
+		ret = taskmgr_handle_tcb(TMIOC_BROADCAST, TM_PID(handle), NULL);
+		if (ret != OK) {
+			continue;
+		}
+		bm = (tm_broadcast_internal_msg_t *)TM_ALLOC(sizeof(tm_broadcast_internal_msg_t));
+		if (bm == NULL) {
+			return TM_OUT_OF_MEMORY;
+		}
+		if (arg->msg_size > 0) {
+			bm->user_data = TM_ALLOC(arg->msg_size);
+			if (bm->user_data == NULL) {
+				TM_FREE(bm);
 				return TM_OUT_OF_MEMORY;
 			}
-			if (arg->msg_size > 0) {
-				bm->user_data = TM_ALLOC(arg->msg_size);
-				if (bm->user_data == NULL) {
-					TM_FREE(bm);
-					return TM_OUT_OF_MEMORY;
-				}
-				bm->size = arg->msg_size;
-				memcpy(bm->user_data, arg->msg, arg->msg_size);
-			} else {
-				bm->user_data = NULL;
-				bm->size = arg->msg_size;
-			}
-
-			bm->cb_info = broadcast_info;
-			msg_broad.sival_ptr = (void *)bm;
-			(void)sigqueue(TM_PID(handle), SIGTM_BROADCAST, msg_broad);
+			bm->size = arg->msg_size;
+			memcpy(bm->user_data, arg->msg, arg->msg_size);
+		} else {
+			bm->user_data = NULL;
+			bm->size = arg->msg_size;
 		}
+
+		bm->cb_info = broadcast_info;
+		msg_broad.sival_ptr = (void *)bm;
+		(void)sigqueue(TM_PID(handle), SIGTM_BROADCAST, msg_broad);
 	}
 	return OK;
 }
@@ -1067,6 +1168,8 @@ static int taskmgr_set_broadcast_cb(tm_broadcast_info_t *data, int pid)
 			return TM_OUT_OF_MEMORY;
 		}
 		broadcast_info->flink = NULL;
+		broadcast_info->msg_flink = NULL;
+		broadcast_info->handle = handle;
 		broadcast_info->msg = data->msg;
 		broadcast_info->cb = data->cb;
 		if (data->cb_data != NULL) {
@@ -1092,6 +1195,7 @@ static int taskmgr_set_broadcast_cb(tm_broadcast_info_t *data, int pid)
 			broadcast_info->cb_data = NULL;
 		}
 		sq_addlast((FAR sq_entry_t *)broadcast_info, &TM_BROADCAST_INFO_LIST(handle));
+		taskmgr_subscribe_broadcast(broadcast_info);
 	} else {
 		if ((broadcast_info->cb == data->cb) && (CB_MSGSIZE_OF(broadcast_info) == CB_MSGSIZE_OF(data)) && (memcmp(CB_MSG_OF(broadcast_info), CB_MSG_OF(data), CB_MSGSIZE_OF(data)) == 0)) {
 			return TM_ALREADY_REGISTERED_CB;
@@ -1160,6 +1264,7 @@ static int taskmgr_unset_broadcast_cb(int msg, int pid)
 		return TM_UNREGISTERED_MSG;
 	}
 	sq_rem((FAR sq_entry_t *)broadcast_info, &TM_BROADCAST_INFO_LIST(handle));
+	taskmgr_unsubscribe_broadcast(broadcast_info);
 	if (broadcast_info->cb_data != NULL) {
 		if (CB_MSG_OF(broadcast_info) != NULL) {
 			TM_FREE(CB_MSG_OF(broadcast_info));
@@ -1617,6 +1722,10 @@ int task_manager(int argc, char *argv[])
 			break;
 		}
 
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+		/* Publish the changes before the caller can see the response */
+		taskmgr_publish_request(&request_msg, ret);
+#endif
 		taskmgr_send_response((char *)request_msg.q_name, request_msg.timeout, &response_msg, ret);
 		taskmgr_dealloc_reqmsg_data(&request_msg);
 
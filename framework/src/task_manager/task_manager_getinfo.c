@@ -50,11 +50,22 @@ tm_appinfo_list_t *task_manager_getinfo_with_name(char *name, int timeout)
 	int status;
 	tm_request_t request_msg;
 	tm_response_t response_msg;
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	tm_appinfo_list_t *list;
+#endif
 
 	if (name == NULL || timeout < TM_RESPONSE_WAIT_INF || timeout == TM_NO_RESPONSE) {
 		return NULL;
 	}
 
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	/* Answer from the app table, the task manager is only asked if it can't */
+	status = taskmgr_app_table_getinfo(TASKMGRCMD_SCAN_NAME, 0, name, &list);
+	if (status != TM_NOT_SUPPORTED) {
+		return status == OK ? list : NULL;
+	}
+#endif
+
 	memset(&request_msg, 0, sizeof(tm_request_t));
 
 	/* Set the request msg */
@@ -96,11 +107,22 @@ tm_appinfo_t *task_manager_getinfo_with_handle(int handle, int timeout)
 	int status;
 	tm_request_t request_msg;
 	tm_response_t response_msg;
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	tm_appinfo_list_t *list;
+#endif
 
 	if (IS_INVALID_HANDLE(handle) || timeout < TM_RESPONSE_WAIT_INF || timeout == TM_NO_RESPONSE) {
 		return NULL;
 	}
 
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	/* Answer from the app table, the task manager is only asked if it can't */
+	status = taskmgr_app_table_getinfo(TASKMGRCMD_SCAN_HANDLE, handle, NULL, &list);
+	if (status != TM_NOT_SUPPORTED) {
+		return status == OK ? &list->task : NULL;
+	}
+#endif
+
 	memset(&request_msg, 0, sizeof(tm_request_t));
 
 	/* Set the request msg */
@@ -127,11 +149,22 @@ tm_appinfo_list_t *task_manager_getinfo_with_group(int group, int timeout)
 	int status;
 	tm_request_t request_msg;
 	tm_response_t response_msg;
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	tm_appinfo_list_t *list;
+#endif
 
 	if (group < 0 || timeout < TM_RESPONSE_WAIT_INF || timeout == TM_NO_RESPONSE) {
 		return NULL;
 	}
 
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	/* Answer from the app table, the task manager is only asked if it can't */
+	status = taskmgr_app_table_getinfo(TASKMGRCMD_SCAN_GROUP, group, NULL, &list);
+	if (status != TM_NOT_SUPPORTED) {
+		return status == OK ? list : NULL;
+	}
+#endif
+
 	memset(&request_msg, 0, sizeof(tm_request_t));
 
 	/* Set the request msg */
@@ -158,11 +191,22 @@ tm_appinfo_t *task_manager_getinfo_with_pid(int pid, int timeout)
 	int status;
 	tm_request_t request_msg;
 	tm_response_t response_msg;
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	tm_appinfo_list_t *list;
+#endif
 
 	if (pid < 0 || timeout < TM_RESPONSE_WAIT_INF || timeout == TM_NO_RESPONSE) {
 		return NULL;
 	}
 
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+	/* Answer from the app table, the task manager is only asked if it can't */
+	status = taskmgr_app_table_getinfo(TASKMGRCMD_SCAN_PID, pid, NULL, &list);
+	if (status != TM_NOT_SUPPORTED) {
+		return status == OK ? &list->task : NULL;
+	}
+#endif
+
 	memset(&request_msg, 0, sizeof(tm_request_t));
 	/* Set the request msg */
 	request_msg.cmd = TASKMGRCMD_SCAN_PID;
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <unistd.h>
 #ifndef CONFIG_DISABLE_PTHREAD
 #include <pthread.h>
@@ -146,7 +147,9 @@ struct tm_response_s {
 typedef struct tm_response_s tm_response_t;
 
 struct tm_broadcast_info_s {
-	struct tm_broadcast_info_s *flink;
+	struct tm_broadcast_info_s *flink;	/* Next callback of the same app */
+	struct tm_broadcast_info_s *msg_flink;	/* Next subscriber of the same msg */
+	int handle;
 	int msg;
 	tm_broadcast_callback_t cb;
 	tm_msg_t *cb_data;
@@ -188,6 +191,34 @@ typedef struct tm_broadcast_internal_msg_s tm_broadcast_internal_msg_t;
 
 #define IS_INVALID_HANDLE(i) (i < 0 || i >= CONFIG_TASK_MANAGER_MAX_TASKS)
 
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+/**
+ * @brief Copy of an app entry that the task manager publishes for lock-free queries
+ *
+ * Only the task manager writes the table, with preemption disabled. It makes 'seq'
+ * odd while it updates an entry, and readers retry until they copied the entry
+ * with the same even 'seq' before and after.
+ */
+struct tm_app_entry_s {
+	volatile uint32_t seq;
+	int pid;
+	int tm_gid;
+	int status;			/* TM_APP_STATE_UNREGISTERED for a free handle */
+	int permission;
+	bool name_truncated;		/* The full name is only known to the task manager */
+	char name[CONFIG_TASK_NAME_SIZE + 1];
+};
+typedef struct tm_app_entry_s tm_app_entry_t;
+
+/* Orders the accesses to an entry against its sequence count */
+#define TM_APP_TABLE_BARRIER() __sync_synchronize()
+
+void taskmgr_app_table_publish(int handle, const tm_app_entry_t *app);
+bool taskmgr_app_table_read(int handle, tm_app_entry_t *app);
+int taskmgr_app_table_getinfo(int cmd, int key, const char *name, tm_appinfo_list_t **list);
+void taskmgr_update_app_table(int handle);
+#endif
+
 app_list_t *taskmger_get_applist(int handle);
 #define TM_LIST_ADDR(handle)            ((app_list_data_t *)taskmger_get_applist(handle)->addr)
 #define TM_PID(handle)                  taskmger_get_applist(handle)->pid
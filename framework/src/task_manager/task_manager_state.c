@@ -48,6 +48,9 @@ static void taskmgr_update_task_state(int handle)
 	if (ret != OK && TM_LIST_ADDR(handle) != NULL) {
 		if (TM_STATUS(handle) == TM_APP_STATE_RUNNING || TM_STATUS(handle) == TM_APP_STATE_PAUSE) {
 			TM_STATUS(handle) = TM_APP_STATE_STOP;
+#ifdef CONFIG_TASK_MANAGER_SHARED_APP_TABLE
+			taskmgr_update_app_table(handle);
+#endif
 		}
 	}
 }
@@ -1124,11 +1124,19 @@ int pcm_stop(struct pcm *pcm)
 	int size;
 	int prio;
 	struct timespec st_time;
+	int x;
 	do {
 		clock_gettime(CLOCK_REALTIME, &st_time);
 		size = mq_timedreceive(pcm->mq, (FAR char *)&msg, sizeof(msg), &prio, &st_time);
 	} while (size > 0);
 
+	/* The driver gave all buffers up, none of them is queued anymore */
+	for (x = 0; x < pcm->buffer_cnt; x++) {
+		pcm->pBuffers[x]->flags &= ~AUDIO_APB_MMAP_ENQUEUED;
+		pcm->pBuffers[x]->nbytes = 0;
+		pcm->pBuffers[x]->curbyte = 0;
+	}
+
 	pcm->prepared = 0;
 	pcm->running = 0;
 	pcm->draining = 0;
@@ -1225,6 +1233,16 @@ int pcm_drain(struct pcm *pcm)
 	}
 }
 
+/* A played mmap buffer came back from the driver. For playback, buf_idx
+ * counts the buffers still queued, which is what pcm_drain waits for.
+ */
+static void pcm_mmap_dequeued(struct pcm *pcm)
+{
+	if ((pcm->flags & PCM_OUT) && pcm->buf_idx > 0) {
+		pcm->buf_idx--;
+	}
+}
+
 /** Application request to access a portion of direct (mmap) area
  * @param[in] pcm A PCM handle
  * @param[out] areas Returned mmap channel areas
@@ -1343,6 +1361,11 @@ int pcm_mmap_commit(struct pcm *pcm, unsigned int offset, unsigned int frames)
 		pcm->buf_idx++;
 	}
 
+	/* If playback is not already started, start now, as pcm_writei does */
+	if ((pcm->flags & PCM_OUT) && !pcm->running && pcm_start(pcm) < 0) {
+		return -errno;
+	}
+
 	return 0;
 }
 
@@ -1420,6 +1443,7 @@ int pcm_wait(struct pcm *pcm, int timeout)
 			apb = (struct ap_buffer_s *)msg.u.pPtr;
 			apb->flags &= ~AUDIO_APB_MMAP_ENQUEUED;
 			apb->curbyte = 0;
+			pcm_mmap_dequeued(pcm);
 			count++;
 		} else if (msg.msgId == AUDIO_MSG_XRUN) {
 			/* Underrun to be handled by client */
@@ -1452,8 +1476,11 @@ int pcm_wait(struct pcm *pcm, int timeout)
 		audvdbg("avail update %d buffer_size %d\n", pcm_avail_update(pcm), pcm->buffer_size);
 		return 1;
 	}
+	/* Playback goes on as soon as one buffer can be refilled, so that the
+		device queue never runs low. Recording waits for most buffers. */
+	int wanted = (pcm->flags & PCM_OUT) ? 1 : pcm->buffer_cnt - 1;
 	int cnt = 0;
-	while (cnt < pcm->buffer_cnt - 1) {
+	while (cnt < wanted) {
 		/* If there were no buffers in the queue, wait for codec to put a buffer on the queue */
 		if (timeout > 0) {
 			/* Use the timeout given by application */
@@ -1480,6 +1507,7 @@ int pcm_wait(struct pcm *pcm, int timeout)
 			apb = (struct ap_buffer_s *)msg.u.pPtr;
 			apb->flags &= ~AUDIO_APB_MMAP_ENQUEUED;
 			apb->curbyte = 0;
+			pcm_mmap_dequeued(pcm);
 			cnt++;
 		} else if (msg.msgId == AUDIO_MSG_XRUN) {
 			/* Underrun to be handled by client */
@@ -1488,7 +1516,7 @@ int pcm_wait(struct pcm *pcm, int timeout)
 			break;
 		}
 	}
-	if (cnt == pcm->buffer_cnt - 1) {
+	if (cnt == wanted) {
 		return 1;
 	}
 
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * libc/aio/aio_ring.c
+ *
+ * Reader side of the non-standard AIO completion ring.  The AIO workers
+ * add the control blocks of requests notified with SIGEV_AIO_RING; the
+ * reader polls them here without a system call.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+
+#ifdef CONFIG_FS_AIO
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_init
+ *
+ * Description:
+ *   Initialize a completion ring over the caller's array of 'nentries'
+ *   slots.  The ring must be able to hold all requests that may complete
+ *   before it is read; completions that do not fit are counted in
+ *   ar_overflow and are only visible through aio_error().
+ *
+ * Input Parameters:
+ *   ring     - The ring to initialize
+ *   entries  - Storage for the slots, valid as long as the ring is used
+ *   nentries - The number of slots, a power of two up to 32768
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and errno is set to
+ *   EINVAL.
+ *
+ ****************************************************************************/
+
+int aio_ring_init(FAR struct aio_ring_s *ring, FAR struct aiocb **entries, int nentries)
+{
+	if (ring == NULL || entries == NULL || nentries <= 0 || nentries > 32768 || (nentries & (nentries - 1)) != 0) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	ring->ar_entries = entries;
+	ring->ar_size = (uint16_t)nentries;
+	ring->ar_head = 0;
+	ring->ar_tail = 0;
+	ring->ar_overflow = 0;
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_get
+ *
+ * Description:
+ *   Take the oldest completed control block from the ring.  Its result is
+ *   final and can be read with aio_return().  Only one thread may read a
+ *   ring.  To wait for a completion, use aio_suspend().
+ *
+ * Input Parameters:
+ *   ring - The ring given in sigev_value.sival_ptr of the requests
+ *
+ * Returned Value:
+ *   The control block, or NULL if no request completed since the last call.
+ *
+ ****************************************************************************/
+
+FAR struct aiocb *aio_ring_get(FAR struct aio_ring_s *ring)
+{
+	FAR struct aiocb *aiocbp;
+	uint16_t tail;
+
+	DEBUGASSERT(ring);
+
+	tail = ring->ar_tail;
+	if (tail == ring->ar_head) {
+		return NULL;
+	}
+
+	/* Read the entry only after the head that published it */
+
+	__sync_synchronize();
+	aiocbp = ring->ar_entries[tail & (ring->ar_size - 1)];
+	ring->ar_tail = tail + 1;
+
+	return aiocbp;
+}
+
+#endif							/* CONFIG_FS_AIO */
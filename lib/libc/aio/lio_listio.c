@@ -307,7 +307,6 @@ static int lio_sigsetup(FAR struct aiocb *const *list, int nent, FAR struct sige
 
 	/* Attach our signal handler */
 
-	printf("waiter_main: Registering signal handler\n");
 	act.sa_sigaction = lio_sighandler;
 	act.sa_flags = SA_SIGINFO;
 
@@ -550,6 +549,9 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent, FAR struct si
 	/* Lock the scheduler so that no I/O events can complete on the worker
 	 * thread until we set our wait set up.  Pre-emption will, of course, be
 	 * re-enabled while we are waiting for the signal.
+	 *
+	 * This also queues the whole list before any worker runs, so that the
+	 * AIO worker pool can merge the adjacent requests in it.
 	 */
 
 	sched_lock();
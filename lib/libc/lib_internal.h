@@ -60,6 +60,7 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <limits.h>
@@ -139,10 +140,36 @@
 
 #define LIB_BUFLEN_UNKNOWN INT_MAX
 
+/* Helpers for the word-at-a-time string functions.  LIB_HASZERO(w) is
+ * non-zero if and only if one of the bytes of word 'w' is zero, so a word
+ * can be searched for a byte value 'c' with LIB_HASZERO(w ^ LIB_REPEAT(c)).
+ */
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#define LIB_WORDSIZE       sizeof(lib_word_t)
+#define LIB_WORDMASK       (LIB_WORDSIZE - 1)
+#define LIB_WORDBITS       (8 * LIB_WORDSIZE)
+#define LIB_ALIGNED(p)     (((uintptr_t)(p) & LIB_WORDMASK) == 0)
+#define LIB_ONES           ((lib_word_t)-1 / 0xff)
+#define LIB_HIGHS          (LIB_ONES * 0x80)
+#define LIB_REPEAT(c)      (LIB_ONES * (unsigned char)(c))
+#define LIB_HASZERO(w)     (((w) - LIB_ONES) & ~(w) & LIB_HIGHS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+/* Machine word used to access byte arrays a word at a time */
+
+#ifdef __GNUC__
+typedef uintptr_t __attribute__((__may_alias__)) lib_word_t;
+#else
+typedef uintptr_t lib_word_t;
+#endif
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
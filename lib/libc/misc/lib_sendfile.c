@@ -63,6 +63,8 @@
 #include <errno.h>
 #include <limits.h>
 
+#include <tinyara/fs/fs.h>
+
 #include "lib_internal.h"
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0 || CONFIG_NFILE_DESCRIPTORS > 0
@@ -92,11 +94,11 @@
  *
  * Description:
  *   sendfile() copies data between one file descriptor and another.
- *   sendfile() basically just wraps a sequence of reads() and writes()
- *   to perform a copy.  It serves a purpose in systems where there is
- *   a penalty for copies to between user and kernal space, but really
- *   nothing in TinyAra but provide some Linux compatible (and adding
- *   another 'almost standard' interface).
+ *   When 'infd' is a file the copy is done by the kernel (fs_sendfile()),
+ *   which sends memory mapped file data without copying it and otherwise
+ *   saves a read() and a write() per chunk.  Only when there is no such
+ *   path, for example when 'infd' is a socket, does sendfile() wrap a
+ *   sequence of reads() and writes() through a local buffer.
  *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
@@ -142,6 +144,15 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 	ssize_t ntransferred;
 	bool endxfr;
 
+#if CONFIG_NFILE_DESCRIPTORS > 0
+	/* Let the kernel do the copy if it can */
+
+	nbyteswritten = fs_sendfile(outfd, infd, offset, count);
+	if (nbyteswritten >= 0 || get_errno() != ENOSYS) {
+		return nbyteswritten;
+	}
+#endif
+
 	/* Get the current file position. */
 
 	if (offset) {
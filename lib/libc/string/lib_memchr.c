@@ -56,8 +56,11 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -79,8 +82,29 @@
 FAR void *memchr(FAR const void *s, int c, size_t n)
 {
 	FAR const unsigned char *p = (FAR const unsigned char *)s;
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	lib_word_t mask;
+#endif
 
 	if (s) {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+		/* Check bytes up to a word boundary, then skip whole words that do
+		 * not hold 'c'.
+		 */
+
+		for (; n > 0 && !LIB_ALIGNED(p); n--, p++) {
+			if (*p == (unsigned char)c) {
+				return (FAR void *)p;
+			}
+		}
+
+		mask = LIB_REPEAT(c);
+		while (n >= LIB_WORDSIZE && !LIB_HASZERO(*(FAR const lib_word_t *)p ^ mask)) {
+			p += LIB_WORDSIZE;
+			n -= LIB_WORDSIZE;
+		}
+#endif
+
 		while (n--) {
 			if (*p == (unsigned char)c) {
 				return (FAR void *)p;
@@ -60,8 +60,11 @@
 
 #include <tinyara/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /************************************************************
  * Global Functions
  ************************************************************/
@@ -72,6 +75,30 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
 	unsigned char *p1 = (unsigned char *)s1;
 	unsigned char *p2 = (unsigned char *)s2;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	/* If both buffers can be aligned together, skip over equal words.  The
+	 * first differing word is resolved byte by byte below.
+	 */
+
+	if (n >= 2 * LIB_WORDSIZE && (((uintptr_t)p1 ^ (uintptr_t)p2) & LIB_WORDMASK) == 0) {
+		while (!LIB_ALIGNED(p1)) {
+			if (*p1 != *p2) {
+				return *p1 < *p2 ? -1 : 1;
+			}
+
+			p1++;
+			p2++;
+			n--;
+		}
+
+		while (n >= LIB_WORDSIZE && *(FAR const lib_word_t *)p1 == *(FAR const lib_word_t *)p2) {
+			p1 += LIB_WORDSIZE;
+			p2 += LIB_WORDSIZE;
+			n -= LIB_WORDSIZE;
+		}
+	}
+#endif
+
 	while (n-- > 0) {
 		if (*p1 < *p2) {
 			return -1;
@@ -60,8 +60,11 @@
 
 #include <tinyara/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -75,6 +78,74 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
 	FAR unsigned char *pout = (FAR unsigned char *)dest;
 	FAR unsigned char *pin = (FAR unsigned char *)src;
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	FAR lib_word_t *wout;
+	FAR const lib_word_t *win;
+
+	if (n >= 2 * LIB_WORDSIZE) {
+		/* Align the destination */
+
+		while (!LIB_ALIGNED(pout)) {
+			*pout++ = *pin++;
+			n--;
+		}
+
+		wout = (FAR lib_word_t *)pout;
+
+		if (LIB_ALIGNED(pin)) {
+			/* Source and destination are both aligned: copy four words per
+			 * iteration, then single words.
+			 */
+
+			win = (FAR const lib_word_t *)pin;
+			while (n >= 4 * LIB_WORDSIZE) {
+				wout[0] = win[0];
+				wout[1] = win[1];
+				wout[2] = win[2];
+				wout[3] = win[3];
+				wout += 4;
+				win += 4;
+				n -= 4 * LIB_WORDSIZE;
+			}
+
+			while (n >= LIB_WORDSIZE) {
+				*wout++ = *win++;
+				n -= LIB_WORDSIZE;
+			}
+
+			pin = (FAR unsigned char *)win;
+		} else {
+			/* The source is misaligned relative to the destination: read
+			 * aligned source words and merge each adjacent pair with shifts.
+			 * The last aligned word read may extend past the end of the
+			 * source, but never past the aligned word that holds its last
+			 * byte.
+			 */
+
+			unsigned int shift = ((uintptr_t)pin & LIB_WORDMASK) * 8;
+			lib_word_t cur;
+			lib_word_t next;
+
+			win = (FAR const lib_word_t *)((uintptr_t)pin & ~(uintptr_t)LIB_WORDMASK);
+			cur = *win++;
+
+			while (n >= LIB_WORDSIZE) {
+				next = *win++;
+#ifdef CONFIG_ENDIAN_BIG
+				*wout++ = (cur << shift) | (next >> (LIB_WORDBITS - shift));
+#else
+				*wout++ = (cur >> shift) | (next << (LIB_WORDBITS - shift));
+#endif
+				cur = next;
+				pin += LIB_WORDSIZE;
+				n -= LIB_WORDSIZE;
+			}
+		}
+
+		pout = (FAR unsigned char *)wout;
+	}
+#endif
+
 	while (n-- > 0) {
 		*pout++ = *pin++;
 	}
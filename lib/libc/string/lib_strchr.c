@@ -56,8 +56,11 @@
 
 #include <tinyara/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -79,9 +82,34 @@
 #ifndef CONFIG_ARCH_STRCHR
 FAR char *strchr(FAR const char *s, int c)
 {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	FAR const lib_word_t *w;
+	lib_word_t mask;
+#endif
+
 	if (s) {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+		/* Check bytes up to a word boundary, then skip whole words that
+		 * hold neither the terminator nor 'c'.
+		 */
+
+		for (; !LIB_ALIGNED(s); s++) {
+			if (*s == (char)c) {
+				return (FAR char *)s;
+			}
+
+			if (!*s) {
+				return NULL;
+			}
+		}
+
+		mask = LIB_REPEAT(c);
+		for (w = (FAR const lib_word_t *)s; !LIB_HASZERO(*w) && !LIB_HASZERO(*w ^ mask); w++);
+		s = (FAR const char *)w;
+#endif
+
 		for (;; s++) {
-			if (*s == c) {
+			if (*s == (char)c) {
 				return (FAR char *)s;
 			}
 
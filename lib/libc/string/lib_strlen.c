@@ -56,8 +56,11 @@
 
 #include <tinyara/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "lib_internal.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -66,10 +69,32 @@
 size_t strlen(const char *s)
 {
 	const char *sc;
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	FAR const lib_word_t *w;
+#endif
+
 	if (s == NULL) {
 		return 0;
 	}
-	for (sc = s; *sc != '\0'; ++sc);
+
+	sc = s;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+	/* Check bytes up to a word boundary, then whole words.  Reading the
+	 * whole aligned word holding the terminator is always safe.
+	 */
+
+	for (; !LIB_ALIGNED(sc); ++sc) {
+		if (*sc == '\0') {
+			return sc - s;
+		}
+	}
+
+	for (w = (FAR const lib_word_t *)sc; !LIB_HASZERO(*w); w++);
+	sc = (const char *)w;
+#endif
+
+	for (; *sc != '\0'; ++sc);
 	return sc - s;
 }
 #endif
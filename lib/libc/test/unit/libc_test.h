@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/test/unit/libc_test.h
+ *
+ * Minimal checking for the host unit tests of the C library.  Each test
+ * program is a single file that counts its failures and returns non-zero
+ * from main() if there were any.
+ *
+ ****************************************************************************/
+
+#ifndef __LIB_LIBC_TEST_UNIT_LIBC_TEST_H
+#define __LIB_LIBC_TEST_UNIT_LIBC_TEST_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Failures reported in detail; later ones are only counted */
+
+#define TEST_MAXREPORT 20
+
+/* Record a failure if 'cond' is false */
+
+#define TEST_CHECK(cond, ...) \
+	do { \
+		if (!(cond)) { \
+			if (g_test_errors++ < TEST_MAXREPORT) { \
+				printf("%s:%d: ", __FILE__, __LINE__); \
+				printf(__VA_ARGS__); \
+				printf("\n"); \
+			} \
+		} \
+	} while (0)
+
+/* Print the result of a test program and give its exit status */
+
+#define TEST_RESULT(name) \
+	(printf("%s: %s, %d failures\n", (name), \
+			g_test_errors == 0 ? "PASS" : "FAIL", g_test_errors), \
+	 g_test_errors == 0 ? 0 : 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_test_errors;
+
+#endif							/* __LIB_LIBC_TEST_UNIT_LIBC_TEST_H */
@@ -0,0 +1,234 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/test/unit/misc/test_crc.c
+ *
+ * Checks crc8, crc16 and crc32 of lib/libc/misc bit for bit against
+ * bit-wise implementations of the same polynomials: whole buffers, two
+ * crcNpart() parts, the stream API and crc32combine(), for every length up
+ * to TEST_MAXLEN at every alignment within 8 bytes.  The Makefile builds
+ * this once for each LIBC_CRC_* choice.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <crc8.h>
+#include <crc16.h>
+#include <crc32.h>
+
+#include "libc_test.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Lengths up to this cover the byte-wise tails and many slicing steps */
+
+#define TEST_MAXLEN  300
+
+/* Alignments tried, enough for the 8 byte steps of slice-by-8 */
+
+#define TEST_NALIGN  8
+
+/* A long buffer, checked once, in case an error only shows after many
+ * steps.
+ */
+
+#define TEST_LONGLEN 65536
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_buf[TEST_LONGLEN + TEST_NALIGN];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void test_fill(uint8_t *buf, size_t len)
+{
+	uint32_t x = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		x = x * 1103515245 + 12345;
+		buf[i] = (uint8_t)(x >> 16);
+	}
+}
+
+/* Bit-wise crc8, polynomial 0xB2 reflected, inverted */
+
+static uint8_t test_ref8(const uint8_t *src, size_t len)
+{
+	uint8_t reg = 0xff;
+	int bit;
+
+	while (len-- > 0) {
+		reg ^= *src++;
+		for (bit = 0; bit < 8; bit++) {
+			reg = (reg & 1) ? (reg >> 1) ^ 0xb2 : reg >> 1;
+		}
+	}
+
+	return reg ^ 0xff;
+}
+
+/* Bit-wise crc16, polynomial 0x1021 with each byte added after the
+ * register is shifted
+ */
+
+static uint16_t test_ref16(const uint8_t *src, size_t len)
+{
+	uint16_t reg = 0;
+	uint16_t fb;
+	int bit;
+
+	while (len-- > 0) {
+		fb = reg & 0xff00;
+		for (bit = 0; bit < 8; bit++) {
+			fb = (fb & 0x8000) ? (fb << 1) ^ 0x1021 : fb << 1;
+		}
+
+		reg = fb ^ (uint16_t)(reg << 8) ^ *src++;
+	}
+
+	return reg;
+}
+
+/* Bit-wise crc32, polynomial 0xedb88320 reflected, inverted */
+
+static uint32_t test_ref32(const uint8_t *src, size_t len)
+{
+	uint32_t reg = 0xffffffff;
+	int bit;
+
+	while (len-- > 0) {
+		reg ^= *src++;
+		for (bit = 0; bit < 8; bit++) {
+			reg = (reg & 1) ? (reg >> 1) ^ 0xedb88320 : reg >> 1;
+		}
+	}
+
+	return ~reg;
+}
+
+static void test_checkvalues(void)
+{
+	const uint8_t *check = (const uint8_t *)"123456789";
+
+	/* The standard check value of CRC-32, and the references agreeing with
+	 * the library on it
+	 */
+
+	TEST_CHECK(crc32(check, 9) == 0xcbf43926, "crc32 check value 0x%08x", (unsigned)crc32(check, 9));
+	TEST_CHECK(test_ref32(check, 9) == 0xcbf43926, "reference crc32 check value");
+	TEST_CHECK(crc16(check, 9) == test_ref16(check, 9), "crc16 check value 0x%04x", (unsigned)crc16(check, 9));
+	TEST_CHECK(crc8(check, 9) == test_ref8(check, 9), "crc8 check value 0x%02x", (unsigned)crc8(check, 9));
+}
+
+static void test_lengths(void)
+{
+	struct crc8_ctx_s ctx8;
+	struct crc16_ctx_s ctx16;
+	struct crc32_ctx_s ctx32;
+	const uint8_t *src;
+	uint8_t ref8;
+	uint16_t ref16;
+	uint32_t ref32;
+	size_t align;
+	size_t len;
+	size_t half;
+	size_t pos;
+	size_t step;
+
+	for (align = 0; align < TEST_NALIGN; align++) {
+		for (len = 0; len <= TEST_MAXLEN; len++) {
+			src = g_buf + align;
+			half = (len * 3) / 7;
+
+			ref8 = test_ref8(src, len);
+			ref16 = test_ref16(src, len);
+			ref32 = test_ref32(src, len);
+
+			TEST_CHECK(crc8(src, len) == ref8, "crc8: len %zu src+%zu", len, align);
+			TEST_CHECK(crc16(src, len) == ref16, "crc16: len %zu src+%zu", len, align);
+			TEST_CHECK(crc32(src, len) == ref32, "crc32: len %zu src+%zu", len, align);
+
+			/* In two parts, the second one misaligned for most lengths */
+
+			TEST_CHECK(crc8part(src + half, len - half, crc8part(src, half, 0)) == ref8, "crc8part: len %zu at %zu src+%zu", len, half, align);
+			TEST_CHECK(crc16part(src + half, len - half, crc16part(src, half, 0)) == ref16, "crc16part: len %zu at %zu src+%zu", len, half, align);
+			TEST_CHECK(crc32part(src + half, len - half, crc32part(src, half, 0)) == ref32, "crc32part: len %zu at %zu src+%zu", len, half, align);
+
+			TEST_CHECK(crc32combine(crc32(src, half), crc32(src + half, len - half), len - half) == ref32, "crc32combine: len %zu at %zu", len, half);
+
+			/* As a stream, in parts of growing size */
+
+			crc8_init(&ctx8);
+			crc16_init(&ctx16);
+			crc32_init(&ctx32);
+			for (pos = 0, step = 1; pos < len; pos += step, step += 3) {
+				if (step > len - pos) {
+					step = len - pos;
+				}
+
+				crc8_update(&ctx8, src + pos, step);
+				crc16_update(&ctx16, src + pos, step);
+				crc32_update(&ctx32, src + pos, step);
+			}
+
+			TEST_CHECK(crc8_final(&ctx8) == ref8, "crc8 stream: len %zu src+%zu", len, align);
+			TEST_CHECK(crc16_final(&ctx16) == ref16, "crc16 stream: len %zu src+%zu", len, align);
+			TEST_CHECK(crc32_final(&ctx32) == ref32, "crc32 stream: len %zu src+%zu", len, align);
+			TEST_CHECK(ctx32.len == len, "crc32 stream: counted %zu of %zu bytes", ctx32.len, len);
+		}
+	}
+}
+
+static void test_long(void)
+{
+	size_t align;
+
+	for (align = 0; align < TEST_NALIGN; align += 3) {
+		TEST_CHECK(crc8(g_buf + align, TEST_LONGLEN) == test_ref8(g_buf + align, TEST_LONGLEN), "crc8: long buffer src+%zu", align);
+		TEST_CHECK(crc16(g_buf + align, TEST_LONGLEN) == test_ref16(g_buf + align, TEST_LONGLEN), "crc16: long buffer src+%zu", align);
+		TEST_CHECK(crc32(g_buf + align, TEST_LONGLEN) == test_ref32(g_buf + align, TEST_LONGLEN), "crc32: long buffer src+%zu", align);
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+	test_fill(g_buf, sizeof(g_buf));
+
+	test_checkvalues();
+	test_lengths();
+	test_long();
+
+	return TEST_RESULT(argc > 0 ? argv[0] : "test_crc");
+}
@@ -0,0 +1,344 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * lib/libc/test/unit/string/test_string.c
+ *
+ * Checks memcpy, memset, memcmp, memchr, strlen and strchr of lib/libc/string
+ * against the C library of the host, for every length up to TEST_MAXLEN at
+ * every source and destination alignment within a machine word.  The
+ * Makefile builds the routines under libc_ names, once with and once
+ * without CONFIG_LIBC_STRING_OPTSPEED.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "libc_test.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Lengths up to this cover the byte-wise heads and tails and several
+ * iterations of the unrolled word loops.
+ */
+
+#define TEST_MAXLEN   300
+
+/* Alignments tried for each pointer */
+
+#define TEST_NALIGN   sizeof(uintptr_t)
+
+/* Room before and after the data, where nothing may be written */
+
+#define TEST_GUARD    32
+
+#define TEST_BUFSIZE  (TEST_GUARD + TEST_NALIGN + TEST_MAXLEN + TEST_GUARD)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* The routines under test, renamed by the Makefile */
+
+void *libc_memcpy(void *dest, const void *src, size_t n);
+void *libc_memset(void *s, int c, size_t n);
+int libc_memcmp(const void *s1, const void *s2, size_t n);
+void *libc_memchr(const void *s, int c, size_t n);
+size_t libc_strlen(const char *s);
+char *libc_strchr(const char *s, int c);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned char g_src[TEST_BUFSIZE];
+static unsigned char g_dst[TEST_BUFSIZE];
+static unsigned char g_ref[TEST_BUFSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Fill a buffer with a pattern rich in the byte values that defeat a
+ * careless zero-byte test: 0x80, 0x01, 0xff and 0x7f next to each other.
+ */
+
+static void test_fill(unsigned char *buf, size_t len, uint32_t seed)
+{
+	static const unsigned char tricky[] = { 0x80, 0x01, 0xff, 0x7f, 0x81, 0xfe };
+	uint32_t x = seed;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		x = x * 1103515245 + 12345;
+		buf[i] = (x & 0x100) ? tricky[(x >> 16) % sizeof(tricky)] : (unsigned char)(x >> 16);
+	}
+}
+
+/* Replace the zero bytes of a buffer, so that it holds no terminator */
+
+static void test_nozero(unsigned char *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (buf[i] == 0) {
+			buf[i] = 0x80;
+		}
+	}
+}
+
+static int test_sign(int value)
+{
+	return value < 0 ? -1 : value > 0;
+}
+
+static void test_memcpy(void)
+{
+	size_t salign;
+	size_t dalign;
+	size_t len;
+	void *ret;
+
+	test_fill(g_src, TEST_BUFSIZE, 1);
+
+	for (salign = 0; salign < TEST_NALIGN; salign++) {
+		for (dalign = 0; dalign < TEST_NALIGN; dalign++) {
+			for (len = 0; len <= TEST_MAXLEN; len++) {
+				memset(g_dst, 0xaa, TEST_BUFSIZE);
+				memset(g_ref, 0xaa, TEST_BUFSIZE);
+				memcpy(g_ref + TEST_GUARD + dalign, g_src + TEST_GUARD + salign, len);
+
+				ret = libc_memcpy(g_dst + TEST_GUARD + dalign, g_src + TEST_GUARD + salign, len);
+
+				TEST_CHECK(ret == g_dst + TEST_GUARD + dalign, "memcpy: wrong return value, len %zu", len);
+				TEST_CHECK(memcmp(g_dst, g_ref, TEST_BUFSIZE) == 0, "memcpy: len %zu src+%zu dst+%zu", len, salign, dalign);
+			}
+		}
+	}
+}
+
+static void test_memset(void)
+{
+	static const int values[] = { 0, 0x5a, 0x80, 0xff, 0x1a5, -1 };
+	size_t align;
+	size_t len;
+	size_t v;
+	void *ret;
+
+	for (v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+		for (align = 0; align < TEST_NALIGN; align++) {
+			for (len = 0; len <= TEST_MAXLEN; len++) {
+				memset(g_dst, 0xaa, TEST_BUFSIZE);
+				memset(g_ref, 0xaa, TEST_BUFSIZE);
+				memset(g_ref + TEST_GUARD + align, values[v], len);
+
+				ret = libc_memset(g_dst + TEST_GUARD + align, values[v], len);
+
+				TEST_CHECK(ret == g_dst + TEST_GUARD + align, "memset: wrong return value, len %zu", len);
+				TEST_CHECK(memcmp(g_dst, g_ref, TEST_BUFSIZE) == 0, "memset: value 0x%x len %zu dst+%zu", values[v], len, align);
+			}
+		}
+	}
+}
+
+static void test_memcmp(void)
+{
+	unsigned char *s1;
+	unsigned char *s2;
+	size_t a1;
+	size_t a2;
+	size_t len;
+	size_t pos;
+	unsigned char save;
+
+	test_fill(g_src, TEST_BUFSIZE, 2);
+
+	for (a1 = 0; a1 < TEST_NALIGN; a1++) {
+		for (a2 = 0; a2 < TEST_NALIGN; a2++) {
+			s1 = g_src + TEST_GUARD + a1;
+			s2 = g_dst + TEST_GUARD + a2;
+
+			for (len = 0; len <= TEST_MAXLEN; len++) {
+				memcpy(s2, s1, len);
+				TEST_CHECK(libc_memcmp(s1, s2, len) == 0, "memcmp: equal, len %zu s1+%zu s2+%zu", len, a1, a2);
+
+				/* A difference at each position, in both directions.
+				 * Positions near both ends are tried for every length; the
+				 * others only for some, to keep the run short.
+				 */
+
+				for (pos = 0; pos < len; pos++) {
+					if (pos > TEST_NALIGN && pos + TEST_NALIGN < len && len % 17 != 0) {
+						continue;
+					}
+
+					save = s2[pos];
+					s2[pos] = save ^ 0x80;
+					TEST_CHECK(test_sign(libc_memcmp(s1, s2, len)) == test_sign(memcmp(s1, s2, len)), "memcmp: len %zu diff at %zu s1+%zu s2+%zu", len, pos, a1, a2);
+					TEST_CHECK(test_sign(libc_memcmp(s2, s1, len)) == test_sign(memcmp(s2, s1, len)), "memcmp: len %zu diff at %zu s1+%zu s2+%zu, swapped", len, pos, a1, a2);
+
+					/* Later bytes must not matter once one differs */
+
+					if (pos + 1 < len) {
+						s2[len - 1] ^= 0x01;
+						TEST_CHECK(test_sign(libc_memcmp(s1, s2, len)) == test_sign(memcmp(s1, s2, len)), "memcmp: len %zu diff at %zu and at the end", len, pos);
+						s2[len - 1] ^= 0x01;
+					}
+
+					s2[pos] = save;
+				}
+			}
+		}
+	}
+}
+
+static void test_memchr(void)
+{
+	unsigned char *s;
+	size_t align;
+	size_t len;
+	size_t pos;
+	int c;
+
+	for (align = 0; align < TEST_NALIGN; align++) {
+		s = g_src + TEST_GUARD + align;
+
+		for (len = 0; len <= TEST_MAXLEN; len++) {
+			/* Searched bytes absent: the bytes after 'len' hold it */
+
+			test_fill(g_src, TEST_BUFSIZE, 3);
+			for (pos = 0; pos < len; pos++) {
+				if (s[pos] == 0x42) {
+					s[pos] = 0x43;
+				}
+			}
+
+			s[len] = 0x42;
+			TEST_CHECK(libc_memchr(s, 0x42, len) == NULL, "memchr: absent, len %zu s+%zu", len, align);
+
+			/* Present at each position; the int argument is converted to
+			 * unsigned char, so 0x142 finds 0x42 as well.
+			 */
+
+			for (pos = 0; pos < len; pos++) {
+				c = (pos & 1) ? 0x142 : 0x42;
+				s[pos] = 0x42;
+				TEST_CHECK(libc_memchr(s, c, len) == memchr(s, c, len), "memchr: at %zu, len %zu s+%zu", pos, len, align);
+				s[pos] = 0x43;
+			}
+
+			/* Byte values with the top bit set and zero */
+
+			TEST_CHECK(libc_memchr(s, 0x80, len) == memchr(s, 0x80, len), "memchr: 0x80, len %zu s+%zu", len, align);
+			TEST_CHECK(libc_memchr(s, 0xff, len) == memchr(s, 0xff, len), "memchr: 0xff, len %zu s+%zu", len, align);
+			TEST_CHECK(libc_memchr(s, 0, len) == memchr(s, 0, len), "memchr: 0, len %zu s+%zu", len, align);
+		}
+	}
+}
+
+static void test_strlen(void)
+{
+	char *s;
+	size_t align;
+	size_t len;
+
+	test_fill(g_src, TEST_BUFSIZE, 4);
+	test_nozero(g_src, TEST_BUFSIZE);
+
+	for (align = 0; align < TEST_NALIGN; align++) {
+		s = (char *)g_src + TEST_GUARD + align;
+
+		for (len = 0; len <= TEST_MAXLEN; len++) {
+			s[len] = '\0';
+			TEST_CHECK(libc_strlen(s) == len, "strlen: len %zu s+%zu returned %zu", len, align, libc_strlen(s));
+			s[len] = (char)0x80;
+		}
+	}
+}
+
+static void test_strchr(void)
+{
+	static const int values[] = { 'a', 0x80, 0xff, -1, 0x161 };
+	char *s;
+	size_t align;
+	size_t len;
+	size_t pos;
+	size_t v;
+
+	test_fill(g_src, TEST_BUFSIZE, 5);
+	test_nozero(g_src, TEST_BUFSIZE);
+
+	for (align = 0; align < TEST_NALIGN; align++) {
+		s = (char *)g_src + TEST_GUARD + align;
+
+		for (len = 0; len <= TEST_MAXLEN; len++) {
+			s[len] = '\0';
+
+			/* The terminator is found by searching for zero */
+
+			TEST_CHECK(libc_strchr(s, 0) == s + len, "strchr: terminator, len %zu s+%zu", len, align);
+
+			/* Values present somewhere, absent, or only past the end */
+
+			for (v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+				TEST_CHECK(libc_strchr(s, values[v]) == strchr(s, values[v]), "strchr: value 0x%x len %zu s+%zu", values[v], len, align);
+			}
+
+			/* A unique character at each position */
+
+			for (pos = 0; pos < len; pos++) {
+				if (pos > TEST_NALIGN && pos + TEST_NALIGN < len && len % 13 != 0) {
+					continue;
+				}
+
+				memset(s, 'b', len);
+				s[pos] = 'a';
+				s[len + 1] = 'a';
+				TEST_CHECK(libc_strchr(s, 'a') == s + pos, "strchr: at %zu, len %zu s+%zu", pos, len, align);
+				s[pos] = 'b';
+				TEST_CHECK(libc_strchr(s, 'a') == NULL, "strchr: 'a' only after the end, len %zu s+%zu", len, align);
+			}
+
+			test_fill(g_src, TEST_BUFSIZE, 5);
+			test_nozero(g_src, TEST_BUFSIZE);
+		}
+	}
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+	test_memcpy();
+	test_memset();
+	test_memcmp();
+	test_memchr();
+	test_strlen();
+	test_strchr();
+
+	return TEST_RESULT(argc > 0 ? argv[0] : "test_string");
+}
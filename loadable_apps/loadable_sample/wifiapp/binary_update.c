@@ -320,6 +320,10 @@ static void print_binary_info(binary_update_info_t *binary_info)
 	printf(" %10s | %8s\n", "Version", "Available size");
 	printf(" -------------------------------------------- \n");
 	printf(" %8.1u | %8d\n", binary_info->version, binary_info->available_size);
+	printf(" -------------------------------------------- \n");
+	printf(" Load time (us) : header %u, load %u, bind %u, verify %u, total %u\n", \
+	binary_info->load_time.header, binary_info->load_time.load, binary_info->load_time.bind, \
+	binary_info->load_time.verify, binary_info->load_time.total);
 	printf(" ============================================ \n");
 }
 
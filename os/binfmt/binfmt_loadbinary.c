@@ -152,6 +152,11 @@ int load_binary(int binary_idx, FAR const char *filename, load_attr_t *load_attr
 			bin->bin_name = load_attr->bin_name;
 #endif
 			bin->ramsize = load_attr->ram_size;
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+			bin->crc_check = load_attr->crc_check;
+			bin->crc_seed = load_attr->crc_seed;
+			bin->crc_hash = load_attr->crc_hash;
+#endif
 		} else {
 #ifdef CONFIG_SUPPORT_COMMON_BINARY
 			bin->islibrary = true;
@@ -167,6 +172,10 @@ int load_binary(int binary_idx, FAR const char *filename, load_attr_t *load_attr
 			goto errout_with_bin;
 		}
 
+		if (load_attr) {
+			load_attr->load_time = bin->load_time;
+		}
+
 #ifdef CONFIG_OPTIMIZE_APP_RELOAD_TIME
 		if (!bin->data_backup) {
 			errcode = -EINVAL;
@@ -240,7 +249,7 @@ errout_with_bin:
 	g_lib_binp = NULL;
 #endif
 errout:
-	set_errno(errcode);
+	set_errno(-errcode);
 	return ERROR;
 
 }
@@ -63,6 +63,7 @@
 #include <errno.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/clock.h>
 #include <tinyara/binfmt/binfmt.h>
 #include <tinyara/binfmt/elf.h>
 
@@ -88,6 +89,14 @@
 #define MIN(a, b) (a < b ? a : b)
 #endif
 
+/* Record the time since 'start' as one phase of the load for binary manager */
+
+#ifdef CONFIG_BINARY_MANAGER
+#define elf_settime(b, phase, start) ((b)->load_time.phase = (uint32_t)TICK2USEC(clock_systimer() - (start)))
+#else
+#define elf_settime(b, phase, start) ((void)(start))
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -224,6 +233,7 @@ static void elf_dumpentrypt(FAR struct binary_s *binp, FAR struct elf_loadinfo_s
 static int elf_loadbinary(FAR struct binary_s *binp)
 {
 	struct elf_loadinfo_s loadinfo;	/* Contains globals for libelf */
+	clock_t start;
 	int ret;
 
 	binfo("Loading file: %s\n", binp->filename);
@@ -239,7 +249,15 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 #ifdef CONFIG_APP_BINARY_SEPARATION
 	loadinfo.binp = binp;
 #endif
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+	/* Compressed binaries are checked by binary manager before loading */
 
+	loadinfo.crc_check = binp->crc_check && binp->compression_type == COMPRESS_TYPE_NONE;
+	loadinfo.crc_seed = binp->crc_seed;
+	loadinfo.crc_hash = binp->crc_hash;
+#endif
+
+	start = clock_systimer();
 	ret = elf_init(binp->filename, &loadinfo);
 	elf_dumploadinfo(&loadinfo);
 	if (ret != 0) {
@@ -256,14 +274,34 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 		goto errout_with_init;
 	}
 
+	elf_settime(binp, load, start);
+
 	/* Bind the program to the exported symbol table */
 
+	start = clock_systimer();
 	ret = elf_bind(&loadinfo, binp->exports, binp->nexports);
 	if (ret != 0) {
 		berr("Failed to bind symbols program binary: %d\n", ret);
 		goto errout_with_load;
 	}
 
+	elf_settime(binp, bind, start);
+
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+	/* All sections are read now.  Complete the CRC with what was not read
+	 * and drop the loaded program if it does not match.
+	 */
+
+	start = clock_systimer();
+	ret = elf_verifycrc(&loadinfo);
+	if (ret != 0) {
+		berr("Failed to verify CRC of program binary: %d\n", ret);
+		goto errout_with_load;
+	}
+
+	elf_settime(binp, verify, start);
+#endif
+
 	/* Return the load information */
 
 	binp->entrypt = (main_t)(loadinfo.textalloc + loadinfo.ehdr.e_entry);
@@ -482,4 +482,29 @@ void *elf_find_start_section_addr(struct binary_s *binp);
 #endif
 #endif
 
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+/****************************************************************************
+ * Name: elf_crc_update
+ *
+ * Description:
+ *   Account for 'size' bytes just read from 'offset' in the ELF file into
+ *   'buffer' in the running CRC of the file.  Called by elf_read().
+ *
+ ****************************************************************************/
+void elf_crc_update(FAR struct elf_loadinfo_s *loadinfo, FAR const uint8_t *buffer, size_t size, off_t offset);
+
+/****************************************************************************
+ * Name: elf_verifycrc
+ *
+ * Description:
+ *   Complete the CRC of the file by reading the parts that were not loaded
+ *   and compare it with loadinfo->crc_hash.
+ *
+ * Returned Value:
+ *   0 (OK) if the CRC matches, -EBADMSG if it does not and another negated
+ *   errno value if the file could not be read.
+ ****************************************************************************/
+int elf_verifycrc(FAR struct elf_loadinfo_s *loadinfo);
+#endif
+
 #endif							/* __BINFMT_LIBELF_LIBELF_H */
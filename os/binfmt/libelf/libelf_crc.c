@@ -0,0 +1,254 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * os/binfmt/libelf/libelf_crc.c
+ *
+ * The CRC of a binary is accumulated from the data that elf_read() returns
+ * while the sections are loaded, so the file does not have to be read twice.
+ * Reads do not come in file order, so the CRC is kept per range of the file
+ * and the ranges are joined with crc32combine().
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+#include <errno.h>
+#include <crc32.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/binfmt/elf.h>
+
+#include "libelf.h"
+
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Reads shorter than this only extend an existing range.  They are single
+ * symbols or relocations, which would use up the ranges for little gain.
+ */
+
+#define ELF_CRC_MINRANGE 64
+
+/* Buffer used to read the parts of the file that were not loaded */
+
+#define ELF_CRC_BUFSIZE  512
+
+#ifndef MIN
+#define MIN(x, y) ((x) < (y) ? (x) : (y))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_crc_merge
+ *
+ * Description:
+ *   Join crcranges[index] with the next range if they became adjacent.
+ *
+ ****************************************************************************/
+
+static void elf_crc_merge(FAR struct elf_loadinfo_s *loadinfo, int index)
+{
+	FAR struct elf_crcrange_s *range = &loadinfo->crcranges[index];
+	FAR struct elf_crcrange_s *next = range + 1;
+
+	if (index + 1 >= loadinfo->ncrcranges || range->start + range->size != next->start) {
+		return;
+	}
+
+	range->crc = crc32combine(range->crc, next->crc, next->size);
+	range->size += next->size;
+
+	loadinfo->ncrcranges--;
+	memmove(next, next + 1, (loadinfo->ncrcranges - index - 1) * sizeof(struct elf_crcrange_s));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_crc_update
+ *
+ * Description:
+ *   Account for 'size' bytes just read from 'offset' in the ELF file into
+ *   'buffer' in the running CRC of the file.  Parts already covered by a
+ *   range are skipped, the rest extends a range or starts a new one.
+ *
+ ****************************************************************************/
+
+void elf_crc_update(FAR struct elf_loadinfo_s *loadinfo, FAR const uint8_t *buffer, size_t size, off_t offset)
+{
+	FAR struct elf_crcrange_s *range;
+	off_t pos = offset;
+	off_t end = offset + size;
+	off_t limit;
+	int index = 0;
+
+	if (!loadinfo->crc_check) {
+		return;
+	}
+
+	while (pos < end) {
+		/* Skip the ranges which end before pos */
+
+		while (index < loadinfo->ncrcranges && loadinfo->crcranges[index].start + loadinfo->crcranges[index].size < pos) {
+			index++;
+		}
+
+		range = &loadinfo->crcranges[index];
+		if (index < loadinfo->ncrcranges && range->start <= pos) {
+			if (pos < range->start + range->size) {
+				/* Read again, already accounted for */
+
+				pos = MIN(end, range->start + range->size);
+				continue;
+			}
+
+			/* Continues the range, up to the start of the next one */
+
+			limit = end;
+			if (index + 1 < loadinfo->ncrcranges) {
+				limit = MIN(limit, range[1].start);
+			}
+
+			range->crc = crc32part(buffer + (pos - offset), limit - pos, range->crc);
+			range->size += limit - pos;
+			pos = limit;
+			elf_crc_merge(loadinfo, index);
+			continue;
+		}
+
+		/* pos lies before crcranges[index], in a part not read yet */
+
+		limit = end;
+		if (index < loadinfo->ncrcranges) {
+			limit = MIN(limit, range->start);
+		}
+
+		if (limit - pos >= ELF_CRC_MINRANGE && loadinfo->ncrcranges < CONFIG_ELF_CRC_RANGES) {
+			memmove(range + 1, range, (loadinfo->ncrcranges - index) * sizeof(struct elf_crcrange_s));
+			loadinfo->ncrcranges++;
+
+			range->start = pos;
+			range->size = limit - pos;
+			range->crc = crc32part(buffer + (pos - offset), limit - pos, 0);
+			elf_crc_merge(loadinfo, index);
+		}
+
+		/* Otherwise elf_verifycrc() reads this part again */
+
+		pos = limit;
+	}
+}
+
+/****************************************************************************
+ * Name: elf_verifycrc
+ *
+ * Description:
+ *   Complete the CRC of the file by reading the parts that were not loaded
+ *   and compare it with loadinfo->crc_hash.
+ *
+ * Returned Value:
+ *   0 (OK) if the CRC matches, -EBADMSG if it does not and another negated
+ *   errno value if the file could not be read.
+ *
+ ****************************************************************************/
+
+int elf_verifycrc(FAR struct elf_loadinfo_s *loadinfo)
+{
+	FAR struct elf_crcrange_s *range;
+	FAR uint8_t *buffer;
+	uint32_t crc;
+	off_t pos;
+	off_t limit;
+	size_t readsize;
+	size_t reread;
+	int index;
+	int ret;
+
+	if (!loadinfo->crc_check) {
+		return OK;
+	}
+
+	/* Nothing read from here on is tracked */
+
+	loadinfo->crc_check = false;
+
+	buffer = (FAR uint8_t *)kmm_malloc(ELF_CRC_BUFSIZE);
+	if (!buffer) {
+		berr("Failed to allocate a buffer for the CRC\n");
+		return -ENOMEM;
+	}
+
+	/* Walk the file in order, reading the gaps and joining the ranges */
+
+	crc = loadinfo->crc_seed;
+	pos = 0;
+	index = 0;
+	reread = 0;
+	ret = OK;
+
+	while (pos < loadinfo->filelen) {
+		range = &loadinfo->crcranges[index];
+		if (index < loadinfo->ncrcranges && range->start == pos) {
+			crc = crc32combine(crc, range->crc, range->size);
+			pos += range->size;
+			index++;
+			continue;
+		}
+
+		limit = index < loadinfo->ncrcranges ? range->start : loadinfo->filelen;
+		readsize = MIN(limit - pos, ELF_CRC_BUFSIZE);
+		ret = elf_read(loadinfo, buffer, readsize, pos);
+		if (ret < 0) {
+			berr("Failed to read %u bytes at %lu: %d\n", readsize, (unsigned long)pos, ret);
+			goto errout_with_buffer;
+		}
+
+		crc = crc32part(buffer, readsize, crc);
+		pos += readsize;
+		reread += readsize;
+	}
+
+	binfo("CRC joined from %u ranges, %u bytes read again\n", loadinfo->ncrcranges, reread);
+
+	if (crc != loadinfo->crc_hash) {
+		berr("CRC mismatch: %08x != %08x\n", crc, loadinfo->crc_hash);
+		ret = -EBADMSG;
+	}
+
+errout_with_buffer:
+	kmm_free(buffer);
+	return ret;
+}
+
+#endif /* CONFIG_ELF_CRC_ON_LOAD */
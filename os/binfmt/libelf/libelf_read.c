@@ -65,6 +65,7 @@
 
 #include <tinyara/fs/fs.h>
 #include <tinyara/binfmt/elf.h>
+#include "libelf.h"
 
 #ifdef CONFIG_COMPRESSED_BINARY
 #include <tinyara/binfmt/compression/compress_read.h>
@@ -132,6 +133,11 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer, size_t re
 {
 	ssize_t nbytes;				/* Number of bytes read */
 	off_t rpos;					/* Position returned by lseek */
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+	FAR uint8_t *start = buffer;
+	size_t size = readsize;
+	off_t elfoffset = offset;
+#endif
 
 	/* Advance offset by binary header size, loadinfo->offset will be 0 in normal exec call */
 	offset += loadinfo->offset;
@@ -209,5 +215,9 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer, size_t re
 	}
 
 	elf_dumpreaddata(buffer, readsize);
+
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+	elf_crc_update(loadinfo, start, size, elfoffset);
+#endif
 	return OK;
 }
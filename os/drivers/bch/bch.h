@@ -69,20 +69,56 @@
 #define bchlib_semgive(d)	sem_post(&(d)->sem)	/* To match bchlib_semtake */
 #define MAX_OPENCNT			(255)				/* Limit of uint8_t */
 
+/* Number of sectors held in the BCH sector cache */
+
+#if !defined(CONFIG_BCH_CACHE_NSECTORS) || CONFIG_BCH_CACHE_NSECTORS < 1
+#undef  CONFIG_BCH_CACHE_NSECTORS
+#define CONFIG_BCH_CACHE_NSECTORS	1
+#endif
+
+#define BCH_NOSECTOR		((size_t)-1)		/* Cache entry holds no sector */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+/* One entry of the sector cache */
+
+struct bch_sector_s {
+	size_t sector;				/* The sector held in this entry (or BCH_NOSECTOR) */
+	uint32_t lru;				/* Access stamp used to select the LRU victim */
+	bool dirty;					/* true: Data has been written to the buffer */
+	FAR uint8_t *buffer;		/* One sector buffer */
+};
+
+/* Sector cache statistics, reported through procfs */
+
+struct bch_stats_s {
+	uint32_t hits;				/* Sector lookups satisfied from the cache */
+	uint32_t misses;			/* Sector lookups that required a media read */
+	uint32_t evictions;			/* Dirty entries written back to make room */
+	uint32_t writebacks;		/* Dirty sectors written back to the media */
+	uint32_t writeops;			/* Block driver write calls used for write-back */
+};
+
 struct bchlib_s {
 	FAR struct inode *inode;	/* I-node of the block driver */
 	uint32_t sectsize;			/* The size of one sector on the device */
 	size_t nsectors;			/* Number of sectors supported by the device */
-	size_t sector;				/* The current sector in the buffer */
 	sem_t sem;					/* For atomic accesses to this structure */
 	uint8_t refs;				/* Number of references */
-	bool dirty;					/* true: Data has been written to the buffer */
+	uint8_t ndirty;				/* Number of dirty entries in the cache */
 	bool readonly;				/* true: Only read operations are supported */
 	bool unlinked;				/* true: The driver has been unlinked */
-	FAR uint8_t *buffer;		/* One sector buffer */
+	uint32_t lrustamp;			/* Next LRU access stamp */
+	FAR uint8_t *buffer;		/* Backing memory of all sector buffers */
+	FAR struct bch_sector_s *current;	/* Entry returned by bchlib_readsector() */
+	struct bch_sector_s cache[CONFIG_BCH_CACHE_NSECTORS];	/* Sector cache */
+	struct bch_stats_s stats;	/* Sector cache statistics */
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BCH)
+	FAR struct bchlib_s *flink;	/* Next BCH device registered with procfs */
+	int devno;					/* Device number shown in procfs */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 	uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];	/* Encryption key */
@@ -108,6 +144,20 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_initcache(FAR struct bchlib_s *bch);
+EXTERN void bchlib_markdirty(FAR struct bchlib_s *bch);
+EXTERN void bchlib_cacheoverlay(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+								size_t sector, size_t nsectors);
+EXTERN void bchlib_cacheinvalidate(FAR struct bchlib_s *bch, size_t sector,
+								   size_t nsectors);
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BCH)
+EXTERN void bchlib_procfs_register(FAR struct bchlib_s *bch);
+EXTERN void bchlib_procfs_unregister(FAR struct bchlib_s *bch);
+#else
+#define bchlib_procfs_register(b)
+#define bchlib_procfs_unregister(b)
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -0,0 +1,337 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/bch/bch_procfs.c
+ *
+ * Exposes the sector cache statistics of every BCH device as /proc/bch.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#include "bch.h"
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_BCH) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* This structure describes one open "file" */
+
+struct bch_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	bool header;				/* true: The header line has been output */
+	int nextdevno;				/* Device number of the next line to output */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int bch_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int bch_procfs_close(FAR struct file *filep);
+static ssize_t bch_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int bch_procfs_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int bch_procfs_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+const struct procfs_operations bch_procfsoperations = {
+	bch_procfs_open,			/* open */
+	bch_procfs_close,			/* close */
+	bch_procfs_read,			/* read */
+	NULL,						/* write */
+
+	bch_procfs_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	bch_procfs_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+/* BCH registration variables */
+
+static FAR struct bchlib_s *g_pfirstbch = NULL;
+static int g_nextbchno = 0;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bch_procfs_open
+ ****************************************************************************/
+
+static int bch_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct bch_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* Allocate a context structure */
+
+	attr = (FAR struct bch_file_s *)kmm_zalloc(sizeof(struct bch_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the context as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bch_procfs_close
+ ****************************************************************************/
+
+static int bch_procfs_close(FAR struct file *filep)
+{
+	FAR struct bch_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct bch_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bch_procfs_read
+ ****************************************************************************/
+
+static ssize_t bch_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct bch_file_s *priv;
+	FAR struct bchlib_s *bch;
+	ssize_t total = 0;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	priv = (FAR struct bch_file_s *)filep->f_priv;
+	DEBUGASSERT(priv);
+
+	/* Output a header before the first entry */
+
+	if (!priv->header) {
+		ret = snprintf(buffer, buflen, "Num  Cache Dirty Hits       Misses     Evicts     WrBack     WrOps      Device\n");
+		if ((size_t)ret >= buflen) {
+			return 0;
+		}
+
+		total = ret;
+		priv->header = true;
+	}
+
+	/* Devices are looked up by number on each read so that a device torn
+	 * down between two reads is simply skipped.
+	 */
+
+	sched_lock();
+	for (bch = g_pfirstbch; bch; bch = bch->flink) {
+		if (bch->devno < priv->nextdevno) {
+			continue;
+		}
+
+		ret = snprintf(&buffer[total], buflen - total, "%-5d%-6d%-6d%-11u%-11u%-11u%-11u%-11u%s\n",
+					   bch->devno, CONFIG_BCH_CACHE_NSECTORS, bch->ndirty,
+					   bch->stats.hits, bch->stats.misses, bch->stats.evictions,
+					   bch->stats.writebacks, bch->stats.writeops, bch->inode->i_name);
+
+		if ((size_t)(ret + total) < buflen) {
+			total += ret;
+			priv->nextdevno = bch->devno + 1;
+		} else {
+			buffer[total] = '\0';
+			break;
+		}
+	}
+	sched_unlock();
+
+	/* Update the file offset */
+
+	if (total > 0) {
+		filep->f_pos += total;
+	}
+
+	return total;
+}
+
+/****************************************************************************
+ * Name: bch_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int bch_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct bch_file_s *oldattr;
+	FAR struct bch_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct bch_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct bch_file_s *)kmm_zalloc(sizeof(struct bch_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct bch_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bch_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int bch_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+	/* File/directory size, access block size */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_procfs_register
+ *
+ * Description:
+ *   Add a BCH device to the list reported by /proc/bch.
+ *
+ ****************************************************************************/
+
+void bchlib_procfs_register(FAR struct bchlib_s *bch)
+{
+	FAR struct bchlib_s *plast;
+
+	sched_lock();
+	bch->devno = g_nextbchno++;
+	bch->flink = NULL;
+
+	/* Insert at end of list so that devices are listed in order */
+
+	if (g_pfirstbch == NULL) {
+		g_pfirstbch = bch;
+	} else {
+		plast = g_pfirstbch;
+		while (plast->flink) {
+			plast = plast->flink;
+		}
+
+		plast->flink = bch;
+	}
+	sched_unlock();
+}
+
+/****************************************************************************
+ * Name: bchlib_procfs_unregister
+ *
+ * Description:
+ *   Remove a BCH device from the list reported by /proc/bch.
+ *
+ ****************************************************************************/
+
+void bchlib_procfs_unregister(FAR struct bchlib_s *bch)
+{
+	FAR struct bchlib_s **pprev;
+
+	sched_lock();
+	for (pprev = &g_pfirstbch; *pprev; pprev = &(*pprev)->flink) {
+		if (*pprev == bch) {
+			*pprev = bch->flink;
+			break;
+		}
+	}
+	sched_unlock();
+}
+
+#endif							/* !CONFIG_FS_PROCFS_EXCLUDE_BCH && CONFIG_FS_PROCFS */
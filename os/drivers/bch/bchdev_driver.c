@@ -338,6 +338,12 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 			ret = OK;
 	}
 #endif
+	/* Is this a request to write back the sector cache? */
+	else if (cmd == BIOC_FLUSH) {
+		bchlib_semtake(bch);
+		ret = bchlib_flushsector(bch);
+		bchlib_semgive(bch);
+	}
 	/* Otherwise, pass the IOCTL command on to the contained block driver */
 	else {
 		FAR struct inode *bchinode = bch->inode;
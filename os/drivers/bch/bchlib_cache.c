@@ -57,6 +57,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -88,16 +89,16 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  * Name: bch_cypher
  ****************************************************************************/
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR struct bch_sector_s *entry, int encrypt)
 {
 	int blocks = bch->sectsize / 16;
-	FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+	FAR uint32_t *buffer = (FAR uint32_t *)entry->buffer;
 	int i;
 
 	for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t)) {
 		uint32_t T[4];
 		uint32_t X[4] = {
-			bch->sector, 0, 0, i
+			entry->sector, 0, 0, i
 		};
 
 		aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -114,14 +115,251 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 }
 #endif
 
+/****************************************************************************
+ * Name: bch_lookup
+ *
+ * Description:
+ *   Return the cache entry holding 'sector' or NULL if it is not cached.
+ *
+ ****************************************************************************/
+static FAR struct bch_sector_s *bch_lookup(FAR struct bchlib_s *bch, size_t sector)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++) {
+		if (bch->cache[i].sector == sector) {
+			return &bch->cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: bch_swapbuffers
+ *
+ * Description:
+ *   Exchange the sector buffers of two cache entries, data included.
+ *
+ ****************************************************************************/
+static void bch_swapbuffers(FAR struct bchlib_s *bch, FAR struct bch_sector_s *a, FAR struct bch_sector_s *b)
+{
+	FAR uint8_t *tmp;
+	uint32_t i;
+
+	if ((bch->sectsize & 3) == 0) {
+		FAR uint32_t *pa = (FAR uint32_t *)a->buffer;
+		FAR uint32_t *pb = (FAR uint32_t *)b->buffer;
+		uint32_t word;
+
+		for (i = 0; i < bch->sectsize / 4; i++) {
+			word  = pa[i];
+			pa[i] = pb[i];
+			pb[i] = word;
+		}
+	} else {
+		uint8_t byte;
+
+		for (i = 0; i < bch->sectsize; i++) {
+			byte         = a->buffer[i];
+			a->buffer[i] = b->buffer[i];
+			b->buffer[i] = byte;
+		}
+	}
+
+	tmp       = a->buffer;
+	a->buffer = b->buffer;
+	b->buffer = tmp;
+}
+
+/****************************************************************************
+ * Name: bch_gatherrun
+ *
+ * Description:
+ *   Move the sector buffers of a run of consecutive sectors next to each
+ *   other, in sector order, so that the run can be written with a single
+ *   block driver call.  Entries are handed out in LRU order, so their
+ *   buffers are rarely adjacent already.  The entries that get displaced
+ *   keep their data; only the buffer slots are exchanged.
+ *
+ ****************************************************************************/
+static void bch_gatherrun(FAR struct bchlib_s *bch, FAR struct bch_sector_s **run, int nentries)
+{
+	FAR uint8_t *slot;
+	size_t first;
+	int i;
+	int j;
+
+	/* Keep the run where its first sector is, if there is room after it */
+	first = (run[0]->buffer - bch->buffer) / bch->sectsize;
+	if (first + nentries > CONFIG_BCH_CACHE_NSECTORS) {
+		first = CONFIG_BCH_CACHE_NSECTORS - nentries;
+	}
+
+	for (i = 0; i < nentries; i++) {
+		slot = &bch->buffer[(first + i) * bch->sectsize];
+		if (run[i]->buffer == slot) {
+			continue;
+		}
+
+		/*
+		 * The slots before this one already hold run[0..i-1], so the entry
+		 * owning the slot is either a later part of the run or not in it.
+		 */
+		for (j = 0; j < CONFIG_BCH_CACHE_NSECTORS; j++) {
+			if (bch->cache[j].buffer == slot) {
+				bch_swapbuffers(bch, run[i], &bch->cache[j]);
+				break;
+			}
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: bch_writeentries
+ *
+ * Description:
+ *   Write back 'nentries' dirty cache entries that hold consecutive sectors.
+ *   Their buffers are gathered first, so the run is written with a single
+ *   block driver call.  On failure, the entries stay dirty so that the data
+ *   is not lost and the write is retried by the next flush.
+ *
+ ****************************************************************************/
+static int bch_writeentries(FAR struct bchlib_s *bch, FAR struct bch_sector_s **run, int nentries)
+{
+	FAR struct inode *inode = bch->inode;
+	ssize_t ret;
+	int i;
+
+	if (nentries > 1) {
+		bch_gatherrun(bch, run, nentries);
+	}
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+	/* Encrypt data as necessary */
+	for (i = 0; i < nentries; i++) {
+		bch_cypher(bch, run[i], CYPHER_ENCRYPT);
+	}
+#endif
+
+	ret = inode->u.i_bops->write(inode, run[0]->buffer, run[0]->sector, nentries);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+	/*
+	 * Computation overhead to save memory for extra sector buffer
+	 * TODO: Add configuration switch for extra sector buffer
+	 */
+	for (i = 0; i < nentries; i++) {
+		bch_cypher(bch, run[i], CYPHER_DECRYPT);
+	}
+#endif
+
+	if (ret < 0) {
+		fdbg("Write failed: %d\n", (int)ret);
+		return (int)ret;
+	}
+
+	bch->stats.writeops++;
+	bch->stats.writebacks += nentries;
+
+	/* The sectors are now in sync with the media */
+	for (i = 0; i < nentries; i++) {
+		run[i]->dirty = false;
+		bch->ndirty--;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bch_allocentry
+ *
+ * Description:
+ *   Select the cache entry that will receive a new sector: an unused entry
+ *   if there is one, otherwise the least recently used entry.  A dirty
+ *   victim is written back before it is reused.  If that write fails, the
+ *   least recently used clean entry is taken instead, and if every entry is
+ *   dirty the error is returned and the cache is left as it is.
+ *
+ ****************************************************************************/
+static int bch_allocentry(FAR struct bchlib_s *bch, FAR struct bch_sector_s **pentry)
+{
+	FAR struct bch_sector_s *victim = &bch->cache[0];
+	FAR struct bch_sector_s *clean = NULL;
+	int ret;
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++) {
+		FAR struct bch_sector_s *entry = &bch->cache[i];
+
+		if (entry->sector == BCH_NOSECTOR) {
+			*pentry = entry;
+			return OK;
+		}
+
+		/* Compare relative ages so that stamp wrap-around is harmless */
+		if ((int32_t)(entry->lru - victim->lru) < 0) {
+			victim = entry;
+		}
+
+		if (!entry->dirty && (clean == NULL || (int32_t)(entry->lru - clean->lru) < 0)) {
+			clean = entry;
+		}
+	}
+
+	if (victim->dirty) {
+		ret = bch_writeentries(bch, &victim, 1);
+		if (ret < 0) {
+			if (clean == NULL) {
+				return ret;
+			}
+
+			victim = clean;
+		} else {
+			bch->stats.evictions++;
+		}
+	}
+
+	victim->sector = BCH_NOSECTOR;
+	*pentry = victim;
+	return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_initcache
+ *
+ * Description:
+ *   Carve the sector buffers out of bch->buffer and mark every entry unused.
+ *   bch->buffer must hold CONFIG_BCH_CACHE_NSECTORS sectors.
+ *
+ ****************************************************************************/
+void bchlib_initcache(FAR struct bchlib_s *bch)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++) {
+		bch->cache[i].sector = BCH_NOSECTOR;
+		bch->cache[i].lru    = 0;
+		bch->cache[i].dirty  = false;
+		bch->cache[i].buffer = &bch->buffer[i * bch->sectsize];
+	}
+
+	bch->current  = &bch->cache[0];
+	bch->ndirty   = 0;
+	bch->lrustamp = 0;
+}
+
 /****************************************************************************
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush every dirty sector in the cache to the media.  Dirty sectors are
+ *   written in ascending sector order and runs of consecutive sectors are
+ *   coalesced into a single block driver write where possible.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -129,47 +367,61 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  ****************************************************************************/
 int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
-	FAR struct inode *inode;
-	ssize_t ret = OK;
+	FAR struct bch_sector_s *run[CONFIG_BCH_CACHE_NSECTORS];
+	FAR struct bch_sector_s *next;
+	size_t start = 0;
+	int nentries;
+	int ret = OK;
+	int err;
+	int i;
 
 	/*
-	 * Check if the sector has been modified and is out of sync with the
-	 * media.
+	 * Check if any sector has been modified and is out of sync with the
+	 * media.  Sectors that fail to write stay dirty, so the scan moves on
+	 * from the end of each run rather than until nothing is dirty.
 	 */
-	if (bch->dirty) {
-		inode = bch->inode;
+	while (bch->ndirty > 0) {
+		/* Find the lowest dirty sector not handled yet */
+		run[0] = NULL;
+		for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++) {
+			if (bch->cache[i].dirty && bch->cache[i].sector >= start &&
+				(!run[0] || bch->cache[i].sector < run[0]->sector)) {
+				run[0] = &bch->cache[i];
+			}
+		}
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-		/* Encrypt data as necessary */
-		bch_cypher(bch, CYPHER_ENCRYPT);
-#endif
+		if (run[0] == NULL) {
+			break;
+		}
 
-		/* Write the sector to the media */
-		ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-		if (ret < 0) {
-			fdbg("Write failed: %d\n");
+		/* Extend the run while the next sector is cached and dirty too */
+		nentries = 1;
+		while ((next = bch_lookup(bch, run[nentries - 1]->sector + 1)) != NULL && next->dirty) {
+			run[nentries++] = next;
 		}
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-		/*
-		 * Computation overhead to save memory for extra sector buffer
-		 * TODO: Add configuration switch for extra sector buffer
-		 */
-		bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+		start = run[nentries - 1]->sector + 1;
 
-		/* The sector is now in sync with the media */
-		bch->dirty = false;
+		err = bch_writeentries(bch, run, nentries);
+		if (err < 0 && ret == OK) {
+			ret = err;
+		}
 	}
 
-	return (int)ret;
+	return ret;
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make 'sector' available in the cache and select it as bch->current.
+ *   The least recently used sector is replaced (and written back if it is
+ *   dirty) when the sector is not already cached.
+ *
+ * Returned Value:
+ *   OK, or a negated errno value if the sector could not be read or no
+ *   entry could be freed for it.  bch->current is then left unchanged.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -178,23 +430,113 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
 	FAR struct inode *inode;
-	ssize_t ret = OK;
+	FAR struct bch_sector_s *entry;
+	ssize_t ret;
 
-	if (bch->sector != sector) {
+	entry = bch_lookup(bch, sector);
+	if (entry != NULL) {
+		bch->stats.hits++;
+	} else {
 		inode = bch->inode;
+		bch->stats.misses++;
 
-		(void)bchlib_flushsector(bch);
-		bch->sector = (size_t)-1;
+		ret = bch_allocentry(bch, &entry);
+		if (ret < 0) {
+			return (int)ret;
+		}
 
-		ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+		/* On failure the entry stays unused, nothing is cached */
+		ret = inode->u.i_bops->read(inode, entry->buffer, sector, 1);
 		if (ret < 0) {
-			fdbg("Read failed: %d\n");
+			fdbg("Read failed: %d\n", (int)ret);
+			return (int)ret;
 		}
-		bch->sector = sector;
+
+		entry->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-		bch_cypher(bch, CYPHER_DECRYPT);
+		bch_cypher(bch, entry, CYPHER_DECRYPT);
 #endif
 	}
-	return (int)ret;
+
+	entry->lru   = bch->lrustamp++;
+	bch->current = entry;
+	return OK;
 }
 
+/****************************************************************************
+ * Name: bchlib_markdirty
+ *
+ * Description:
+ *   Mark the sector selected by the last bchlib_readsector() as modified.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_markdirty(FAR struct bchlib_s *bch)
+{
+	if (!bch->current->dirty) {
+		bch->current->dirty = true;
+		bch->ndirty++;
+	}
+}
+
+/****************************************************************************
+ * Name: bchlib_cacheoverlay
+ *
+ * Description:
+ *   Sectors read directly from the media into 'buffer' may be stale if the
+ *   cache holds newer, dirty copies.  Copy those dirty sectors over the
+ *   corresponding parts of 'buffer'.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_cacheoverlay(FAR struct bchlib_s *bch, FAR uint8_t *buffer,
+						 size_t sector, size_t nsectors)
+{
+	FAR struct bch_sector_s *entry;
+	int i;
+
+	if (bch->ndirty == 0) {
+		return;
+	}
+
+	for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++) {
+		entry = &bch->cache[i];
+		if (entry->dirty && entry->sector >= sector && entry->sector < sector + nsectors) {
+			memcpy(&buffer[(entry->sector - sector) * bch->sectsize], entry->buffer, bch->sectsize);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: bchlib_cacheinvalidate
+ *
+ * Description:
+ *   Discard cached copies of sectors that are about to be overwritten
+ *   directly on the media.  Pending dirty data for those sectors is dropped
+ *   because it is superseded by the new write.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_cacheinvalidate(FAR struct bchlib_s *bch, size_t sector, size_t nsectors)
+{
+	FAR struct bch_sector_s *entry;
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++) {
+		entry = &bch->cache[i];
+		if (entry->sector != BCH_NOSECTOR && entry->sector >= sector && entry->sector < sector + nsectors) {
+			if (entry->dirty) {
+				entry->dirty = false;
+				bch->ndirty--;
+			}
+
+			entry->sector = BCH_NOSECTOR;
+		}
+	}
+}
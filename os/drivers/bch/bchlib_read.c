@@ -121,7 +121,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 	bytesread = 0;
 	if (sectoffset > 0) {
 		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		ret = bchlib_readsector(bch, sector);
+		if (ret < 0) {
+			fdbg("ERROR: Read failed: %d\n", ret);
+			return ret;
+		}
 
 		/* Copy the tail end of the sector to the user buffer */
 		if (sectoffset + len > bch->sectsize) {
@@ -130,7 +134,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 			nbytes = len;
 		}
 
-		memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+		memcpy(buffer, &bch->current->buffer[sectoffset], nbytes);
 
 		/* Adjust pointers and counts */
 		sector++;
@@ -161,6 +165,9 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 			return ret;
 		}
 
+		/* Pick up any newer data still pending in the sector cache */
+		bchlib_cacheoverlay(bch, (FAR uint8_t *)buffer, sector, nsectors);
+
 		/* Adjust pointers and counts */
 		sector    += nsectors;
 		nbytes     = nsectors * bch->sectsize;
@@ -177,10 +184,14 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 	/* Then read any partial final sector */
 	if (len > 0) {
 		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		ret = bchlib_readsector(bch, sector);
+		if (ret < 0) {
+			fdbg("ERROR: Read failed: %d\n", ret);
+			return bytesread > 0 ? bytesread : ret;
+		}
 
 		/* Copy the head end of the sector to the user buffer */
-		memcpy(buffer, bch->buffer, len);
+		memcpy(buffer, bch->current->buffer, len);
 
 		/* Adjust counts */
 		bytesread += len;
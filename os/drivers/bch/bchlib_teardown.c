@@ -90,6 +90,8 @@ int bchlib_teardown(FAR void *handle)
 	/* Flush any pending data to the block driver */
 	bchlib_flushsector(bch);
 
+	bchlib_procfs_unregister(bch);
+
 	/* Close the block driver */
 	(void)close_blockdriver(bch->inode);
 
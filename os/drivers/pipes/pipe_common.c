@@ -129,6 +129,26 @@ static void pipecommon_semtake(sem_t *sem)
 	}
 }
 
+/****************************************************************************
+ * Name: pipecommon_xsemtake
+ *
+ * Description:
+ *   Take d_rdxsem or d_wrxsem.  If 'nonblock' is set, fail with -EAGAIN
+ *   instead of waiting for another reader or writer (or a splice) to
+ *   release it.
+ *
+ ****************************************************************************/
+
+static int pipecommon_xsemtake(FAR sem_t *sem, bool nonblock)
+{
+	if (nonblock) {
+		return sem_trywait(sem) == OK ? OK : -EAGAIN;
+	}
+
+	pipecommon_semtake(sem);
+	return OK;
+}
+
 /****************************************************************************
  * Name: pipecommon_pollnotify
  ****************************************************************************/
@@ -153,6 +173,237 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev, pollevent_t events
 #define pipecommon_pollnotify(dev, event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up every thread waiting on one of the reader/writer semaphores.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+	int sval;
+
+	while (sem_getvalue(sem, &sval) == 0 && sval < 0) {
+		sem_post(sem);
+	}
+}
+
+/****************************************************************************
+ * Name: pipecommon_nbytes
+ *
+ * Description:
+ *   Return the number of bytes held in the circular buffer.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+	if (dev->d_wrndx >= dev->d_rdndx) {
+		return dev->d_wrndx - dev->d_rdndx;
+	}
+
+	return dev->d_bufsize - dev->d_rdndx + dev->d_wrndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdspan
+ *
+ * Description:
+ *   Return the number of buffered bytes that can be read contiguously from
+ *   index 'rdndx' (i.e. without wrapping around the end of the buffer).
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_rdspan(FAR struct pipe_dev_s *dev, size_t rdndx)
+{
+	if (dev->d_wrndx >= rdndx) {
+		return dev->d_wrndx - rdndx;
+	}
+
+	return dev->d_bufsize - rdndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_wrspan
+ *
+ * Description:
+ *   Return the number of bytes that can be written contiguously at d_wrndx.
+ *   One slot is always left unused so that a full buffer can be told apart
+ *   from an empty one.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_wrspan(FAR struct pipe_dev_s *dev)
+{
+	if (dev->d_wrndx >= dev->d_rdndx) {
+		return dev->d_bufsize - dev->d_wrndx - (dev->d_rdndx == 0 ? 1 : 0);
+	}
+
+	return dev->d_rdndx - dev->d_wrndx - 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_advance
+ *
+ * Description:
+ *   Advance a read or write index by 'nbytes', wrapping at the buffer end.
+ *
+ ****************************************************************************/
+
+static inline pipe_ndx_t pipecommon_advance(FAR struct pipe_dev_s *dev, size_t ndx, size_t nbytes)
+{
+	ndx += nbytes;
+	if (ndx >= dev->d_bufsize) {
+		ndx -= dev->d_bufsize;
+	}
+
+	return (pipe_ndx_t)ndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until there is data in the pipe.  Must be called with d_bfsem held.
+ *   Returns 1 with d_bfsem still held if data is available.  Otherwise
+ *   d_bfsem is released and 0 (end-of-file: no writers), -EAGAIN or ERROR
+ *   is returned.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitdata(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+	int ret;
+
+	while (dev->d_wrndx == dev->d_rdndx) {
+		/* If O_NONBLOCK was set, then return EGAIN */
+
+		if (nonblock) {
+			sem_post(&dev->d_bfsem);
+			return -EAGAIN;
+		}
+
+		/* If there are no writers on the pipe, then return end of file */
+
+		if (dev->d_nwriters <= 0) {
+			sem_post(&dev->d_bfsem);
+			return 0;
+		}
+
+		/* Otherwise, wait for something to be written to the pipe */
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		ret = sem_wait(&dev->d_rdsem);
+		sched_unlock();
+
+		if (ret < 0 || sem_wait(&dev->d_bfsem) < 0) {
+			return ERROR;
+		}
+	}
+
+	return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitspace
+ *
+ * Description:
+ *   Wait until there is free space in the pipe.  Must be called with d_bfsem
+ *   held.  Returns OK with d_bfsem still held, or -EAGAIN with d_bfsem
+ *   released if 'nonblock' is set and the pipe is full.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitspace(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+	while (pipecommon_wrspan(dev) == 0) {
+		if (nonblock) {
+			sem_post(&dev->d_bfsem);
+			return -EAGAIN;
+		}
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		pipecommon_semtake(&dev->d_wrsem);
+		sched_unlock();
+		pipecommon_semtake(&dev->d_bfsem);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pipecommon_setsize
+ *
+ * Description:
+ *   Resize the circular buffer of the pipe so that it holds 'size' bytes.
+ *   One more byte is allocated, because a full circular buffer always
+ *   keeps one slot free.  Buffered data is preserved.  Must be called with
+ *   d_bfsem held.
+ *
+ ****************************************************************************/
+
+static int pipecommon_setsize(FAR struct pipe_dev_s *dev, unsigned long size)
+{
+	FAR uint8_t *newbuf;
+	size_t nbytes;
+	size_t span;
+
+	if (size < 1 || size > CONFIG_DEV_PIPE_MAXSIZE) {
+		return -EINVAL;
+	}
+
+	/* If the buffer has not been allocated yet, it will be allocated with the
+	 * new size when the pipe is opened.
+	 */
+
+	if (dev->d_buffer == NULL) {
+		dev->d_bufsize = size + 1;
+		return size;
+	}
+
+	/* A splice in progress uses the buffer without holding d_bfsem */
+
+	if (dev->d_rdbusy || dev->d_wrbusy) {
+		return -EBUSY;
+	}
+
+	/* The data already in the pipe must fit in the new buffer */
+
+	nbytes = pipecommon_nbytes(dev);
+	if (nbytes > size) {
+		return -EBUSY;
+	}
+
+	newbuf = (FAR uint8_t *)kmm_malloc(size + 1);
+	if (newbuf == NULL) {
+		return -ENOMEM;
+	}
+
+	/* Copy the buffered data to the beginning of the new buffer */
+
+	span = pipecommon_rdspan(dev, dev->d_rdndx);
+	memcpy(newbuf, &dev->d_buffer[dev->d_rdndx], span);
+	if (span < nbytes) {
+		memcpy(&newbuf[span], dev->d_buffer, nbytes - span);
+	}
+
+	kmm_free(dev->d_buffer);
+	dev->d_buffer = newbuf;
+	dev->d_bufsize = size + 1;
+	dev->d_rdndx = 0;
+	dev->d_wrndx = nbytes;
+
+	/* The pipe may have grown; let blocked writers retry */
+
+	pipecommon_wakeup(&dev->d_wrsem);
+	pipecommon_pollnotify(dev, POLLOUT);
+	return size;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -172,7 +423,10 @@ FAR struct pipe_dev_s *pipecommon_allocdev(void)
 		/* Initialize the private structure */
 
 		memset(dev, 0, sizeof(struct pipe_dev_s));
+		dev->d_bufsize = CONFIG_DEV_PIPE_SIZE;
 		sem_init(&dev->d_bfsem, 0, 1);
+		sem_init(&dev->d_rdxsem, 0, 1);
+		sem_init(&dev->d_wrxsem, 0, 1);
 		sem_init(&dev->d_rdsem, 0, 0);
 		sem_init(&dev->d_wrsem, 0, 0);
 
@@ -194,6 +448,8 @@ FAR struct pipe_dev_s *pipecommon_allocdev(void)
 void pipecommon_freedev(FAR struct pipe_dev_s *dev)
 {
 	sem_destroy(&dev->d_bfsem);
+	sem_destroy(&dev->d_rdxsem);
+	sem_destroy(&dev->d_wrxsem);
 	sem_destroy(&dev->d_rdsem);
 	sem_destroy(&dev->d_wrsem);
 	kmm_free(dev);
@@ -207,7 +463,6 @@ int pipecommon_open(FAR struct file *filep)
 {
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
-	int sval;
 	int ret;
 
 	DEBUGASSERT(dev);
@@ -229,7 +484,7 @@ int pipecommon_open(FAR struct file *filep)
 	 */
 
 	if (dev->d_refs == 0 && dev->d_buffer == NULL) {
-		dev->d_buffer = (uint8_t *)kmm_malloc(CONFIG_DEV_PIPE_SIZE);
+		dev->d_buffer = (uint8_t *)kmm_malloc(dev->d_bufsize);
 		if (!dev->d_buffer) {
 			(void)sem_post(&dev->d_bfsem);
 			return -ENOMEM;
@@ -250,9 +505,7 @@ int pipecommon_open(FAR struct file *filep)
 		 */
 
 		if (dev->d_nwriters == 1) {
-			while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-				sem_post(&dev->d_rdsem);
-			}
+			pipecommon_wakeup(&dev->d_rdsem);
 		}
 	}
 
@@ -304,7 +557,6 @@ int pipecommon_close(FAR struct file *filep)
 {
 	struct inode *inode = filep->f_inode;
 	struct pipe_dev_s *dev = inode->i_private;
-	int sval;
 #ifndef CONFIG_DISABLE_POLL
 	int i;
 #endif
@@ -348,9 +600,7 @@ int pipecommon_close(FAR struct file *filep)
 			 */
 
 			if (--dev->d_nwriters <= 0) {
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
+				pipecommon_wakeup(&dev->d_rdsem);
 			}
 		}
 	}
@@ -401,7 +651,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 	FAR uint8_t *start = (uint8_t *)buffer;
 #endif
 	ssize_t nread = 0;
-	int sval;
+	size_t nbytes;
 	int ret;
 
 	DEBUGASSERT(dev);
@@ -410,63 +660,57 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 		return 0;
 	}
 
-	/* Make sure that we have exclusive access to the device structure */
+	/* Make sure that we have exclusive access to the device structure and
+	 * that no splice is reading the buffer without holding it.
+	 */
+
+	if ((filep->f_oflags & O_NONBLOCK) != 0) {
+		if (sem_trywait(&dev->d_rdxsem) < 0) {
+			return -EAGAIN;
+		}
+	} else if (sem_wait(&dev->d_rdxsem) < 0) {
+		return ERROR;
+	}
 
 	if (sem_wait(&dev->d_bfsem) < 0) {
+		sem_post(&dev->d_rdxsem);
 		return ERROR;
 	}
 
 	/* If the pipe is empty, then wait for something to be written to it */
 
-	while (dev->d_wrndx == dev->d_rdndx) {
-		/* If O_NONBLOCK was set, then return EGAIN */
-
-		if (filep->f_oflags & O_NONBLOCK) {
-			sem_post(&dev->d_bfsem);
-			return -EAGAIN;
-		}
-
-		/* If there are no writers on the pipe, then return end of file */
-
-		if (dev->d_nwriters <= 0) {
-			sem_post(&dev->d_bfsem);
-			return 0;
-		}
-
-		/* Otherwise, wait for something to be written to the pipe */
-
-		sched_lock();
-		sem_post(&dev->d_bfsem);
-		ret = sem_wait(&dev->d_rdsem);
-		sched_unlock();
-
-		if (ret < 0 || sem_wait(&dev->d_bfsem) < 0) {
-			return ERROR;
-		}
+	ret = pipecommon_waitdata(dev, (filep->f_oflags & O_NONBLOCK) != 0);
+	if (ret <= 0) {
+		sem_post(&dev->d_rdxsem);
+		return ret;
 	}
 
-	/* Then return whatever is available in the pipe (which is at least one byte) */
+	/* Then return whatever is available in the pipe (which is at least one
+	 * byte).  The data is copied in at most two chunks: up to the end of the
+	 * circular buffer and then from its beginning.
+	 */
 
-	nread = 0;
-	while (nread < len && dev->d_wrndx != dev->d_rdndx) {
-		*buffer++ = dev->d_buffer[dev->d_rdndx];
-		if (++dev->d_rdndx >= CONFIG_DEV_PIPE_SIZE) {
-			dev->d_rdndx = 0;
+	while (nread < len && (nbytes = pipecommon_rdspan(dev, dev->d_rdndx)) > 0) {
+		if (nbytes > len - nread) {
+			nbytes = len - nread;
 		}
-		nread++;
+
+		memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nbytes);
+		dev->d_rdndx = pipecommon_advance(dev, dev->d_rdndx, nbytes);
+		buffer += nbytes;
+		nread += nbytes;
 	}
 
 	/* Notify all waiting writers that bytes have been removed from the buffer */
 
-	while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0) {
-		sem_post(&dev->d_wrsem);
-	}
+	pipecommon_wakeup(&dev->d_wrsem);
 
 	/* Notify all poll/select waiters that they can write to the FIFO */
 
 	pipecommon_pollnotify(dev, POLLOUT);
 
 	sem_post(&dev->d_bfsem);
+	sem_post(&dev->d_rdxsem);
 	pipe_dumpbuffer("From PIPE:", start, nread);
 	return nread;
 }
@@ -481,8 +725,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 	struct pipe_dev_s *dev = inode->i_private;
 	ssize_t nwritten = 0;
 	ssize_t last;
-	int nxtwrndx;
-	int sval;
+	size_t nbytes;
 
 	DEBUGASSERT(dev);
 	pipe_dumpbuffer("To PIPE:", (uint8_t *)buffer, len);
@@ -505,8 +748,20 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 
 	DEBUGASSERT(up_interrupt_context() == false)
 
-	/* Make sure that we have exclusive access to the device structure */
+	/* Make sure that we have exclusive access to the device structure and
+	 * that no splice is filling the buffer without holding it.
+	 */
+
+	if ((filep->f_oflags & O_NONBLOCK) != 0) {
+		if (sem_trywait(&dev->d_wrxsem) < 0) {
+			return -EAGAIN;
+		}
+	} else if (sem_wait(&dev->d_wrxsem) < 0) {
+		return ERROR;
+	}
+
 	if (sem_wait(&dev->d_bfsem) < 0) {
+		sem_post(&dev->d_wrxsem);
 		return ERROR;
 	}
 
@@ -514,69 +769,67 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer, size_t
 
 	last = 0;
 	for (;;) {
-		/* Calculate the write index AFTER the next byte is written */
-
-		nxtwrndx = dev->d_wrndx + 1;
-		if (nxtwrndx >= CONFIG_DEV_PIPE_SIZE) {
-			nxtwrndx = 0;
-		}
+		/* Copy as much as fits into the free space of the circular buffer,
+		 * in at most two chunks (up to the end and then from the beginning).
+		 */
 
-		/* Would the next write overflow the circular buffer? */
+		while (nwritten < len && (nbytes = pipecommon_wrspan(dev)) > 0) {
+			if (nbytes > len - nwritten) {
+				nbytes = len - nwritten;
+			}
 
-		if (nxtwrndx != dev->d_rdndx) {
-			/* No... copy the byte */
+			memcpy(&dev->d_buffer[dev->d_wrndx], buffer, nbytes);
+			dev->d_wrndx = pipecommon_advance(dev, dev->d_wrndx, nbytes);
+			buffer += nbytes;
+			nwritten += nbytes;
+		}
 
-			dev->d_buffer[dev->d_wrndx] = *buffer++;
-			dev->d_wrndx = nxtwrndx;
+		/* Is the write complete? */
 
-			/* Is the write complete? */
+		if (nwritten >= len) {
+			/* Yes.. Notify all of the waiting readers that more data is available */
 
-			if (++nwritten >= len) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
+			pipecommon_wakeup(&dev->d_rdsem);
 
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
+			/* Notify all poll/select waiters that they can read from the FIFO */
 
-				/* Notify all poll/select waiters that they can write to the FIFO */
+			pipecommon_pollnotify(dev, POLLIN);
 
-				pipecommon_pollnotify(dev, POLLIN);
+			/* Return the number of bytes written */
 
-				/* Return the number of bytes written */
+			sem_post(&dev->d_bfsem);
+			sem_post(&dev->d_wrxsem);
+			return len;
+		}
 
-				sem_post(&dev->d_bfsem);
-				return len;
-			}
-		} else {
-			/* There is not enough room for the next byte. Was anything written in this pass? */
+		/* There is not enough room for the next byte. Was anything written in this pass? */
 
-			if (last < nwritten) {
-				/* Yes.. Notify all of the waiting readers that more data is available */
+		if (last < nwritten) {
+			/* Yes.. Notify all of the waiting readers that more data is available */
 
-				while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0) {
-					sem_post(&dev->d_rdsem);
-				}
-			}
-			last = nwritten;
+			pipecommon_wakeup(&dev->d_rdsem);
+			pipecommon_pollnotify(dev, POLLIN);
+		}
+		last = nwritten;
 
-			/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+		/* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
 
-			if (filep->f_oflags & O_NONBLOCK) {
-				if (nwritten == 0) {
-					nwritten = -EAGAIN;
-				}
-				sem_post(&dev->d_bfsem);
-				return nwritten;
+		if (filep->f_oflags & O_NONBLOCK) {
+			if (nwritten == 0) {
+				nwritten = -EAGAIN;
 			}
-
-			/* There is more to be written.. wait for data to be removed from the pipe */
-
-			sched_lock();
 			sem_post(&dev->d_bfsem);
-			pipecommon_semtake(&dev->d_wrsem);
-			sched_unlock();
-			pipecommon_semtake(&dev->d_bfsem);
+			sem_post(&dev->d_wrxsem);
+			return nwritten;
 		}
+
+		/* There is more to be written.. wait for data to be removed from the pipe */
+
+		sched_lock();
+		sem_post(&dev->d_bfsem);
+		pipecommon_semtake(&dev->d_wrsem);
+		sched_unlock();
+		pipecommon_semtake(&dev->d_bfsem);
 	}
 }
 
@@ -628,16 +881,12 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 		 * First, determine how many bytes are in the buffer
 		 */
 
-		if (dev->d_wrndx >= dev->d_rdndx) {
-			nbytes = dev->d_wrndx - dev->d_rdndx;
-		} else {
-			nbytes = (CONFIG_DEV_PIPE_SIZE - 1) + dev->d_wrndx - dev->d_rdndx;
-		}
+		nbytes = pipecommon_nbytes(dev);
 
 		/* Notify the POLLOUT event if the pipe is not full */
 
 		eventset = 0;
-		if (nbytes < (CONFIG_DEV_PIPE_SIZE - 1)) {
+		if (nbytes < (dev->d_bufsize - 1)) {
 			eventset |= POLLOUT;
 		}
 
@@ -683,10 +932,10 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
 	FAR struct inode *inode = filep->f_inode;
 	FAR struct pipe_dev_s *dev = inode->i_private;
+	int ret;
 
-	/* Only one command supported */
-
-	if (cmd == PIPEIOC_POLICY) {
+	switch (cmd) {
+	case PIPEIOC_POLICY:
 		if (arg != 0) {
 			PIPE_POLICY_1(dev->d_flags);
 		} else {
@@ -694,6 +943,18 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		}
 
 		return OK;
+
+	case PIPEIOC_SETSIZE:
+		pipecommon_semtake(&dev->d_bfsem);
+		ret = pipecommon_setsize(dev, arg);
+		sem_post(&dev->d_bfsem);
+		return ret;
+
+	case PIPEIOC_GETSIZE:
+		return dev->d_bufsize - 1;
+
+	default:
+		break;
 	}
 
 	return -ENOTTY;
@@ -731,4 +992,331 @@ int pipecommon_unlink(FAR struct inode *inode)
 	return OK;
 }
 
+/****************************************************************************
+ * Name: pipecommon_ispipe
+ *
+ * Description:
+ *   Return true if the open file refers to a pipe or FIFO.
+ *
+ ****************************************************************************/
+
+bool pipecommon_ispipe(FAR struct file *filep)
+{
+	FAR struct inode *inode = filep->f_inode;
+
+	/* Pipes and FIFOs are the only drivers that use pipecommon_read() */
+
+	return inode != NULL && inode->u.i_ops != NULL && inode->u.i_ops->read == pipecommon_read;
+}
+
+/****************************************************************************
+ * Name: pipecommon_drain
+ *
+ * Description:
+ *   Remove up to 'len' bytes from the pipe, passing them to 'sink' directly
+ *   from the circular buffer (at most two calls per wrap-around) instead of
+ *   copying them through an intermediate user buffer.  Blocks like read()
+ *   until at least one byte is available unless 'nonblock' is set.
+ *
+ *   d_bfsem is released while the sink runs, so that a slow sink does not
+ *   hold up the writers and pollers of the pipe.  The span stays valid:
+ *   writers only use free space, other readers wait for d_rdxsem, and
+ *   d_rdbusy keeps the buffer from being resized.
+ *
+ * Returned Value:
+ *   The number of bytes consumed, 0 on end-of-file, or a negated errno.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_drain(FAR struct file *filep, pipe_sink_t sink, FAR void *arg, size_t len, bool nonblock)
+{
+	FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+	FAR const uint8_t *span;
+	ssize_t total = 0;
+	ssize_t ret;
+	size_t nbytes;
+
+	DEBUGASSERT(dev && sink);
+
+	if (len == 0) {
+		return 0;
+	}
+
+	nonblock = nonblock || (filep->f_oflags & O_NONBLOCK) != 0;
+	ret = pipecommon_xsemtake(&dev->d_rdxsem, nonblock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	pipecommon_semtake(&dev->d_bfsem);
+	ret = pipecommon_waitdata(dev, nonblock);
+	if (ret <= 0) {
+		sem_post(&dev->d_rdxsem);
+		return ret < 0 && ret != -EAGAIN ? -EINTR : ret;
+	}
+
+	while (total < len && (nbytes = pipecommon_rdspan(dev, dev->d_rdndx)) > 0) {
+		if (nbytes > len - total) {
+			nbytes = len - total;
+		}
+
+		span = &dev->d_buffer[dev->d_rdndx];
+		dev->d_rdbusy = true;
+		sem_post(&dev->d_bfsem);
+
+		ret = sink(arg, span, nbytes);
+
+		pipecommon_semtake(&dev->d_bfsem);
+		dev->d_rdbusy = false;
+		if (ret <= 0) {
+			break;
+		}
+
+		dev->d_rdndx = pipecommon_advance(dev, dev->d_rdndx, ret);
+		total += ret;
+
+		/* Let blocked writers use the space at once */
+
+		pipecommon_wakeup(&dev->d_wrsem);
+		pipecommon_pollnotify(dev, POLLOUT);
+
+		if (ret < nbytes) {
+			/* Short write, the sink cannot take more now */
+
+			break;
+		}
+	}
+
+	sem_post(&dev->d_bfsem);
+	sem_post(&dev->d_rdxsem);
+	return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_fill
+ *
+ * Description:
+ *   Add up to 'len' bytes to the pipe, letting 'source' produce them
+ *   directly into the free space of the circular buffer.  Blocks until the
+ *   pipe has some free space unless 'nonblock' is set.  'source' is told
+ *   whether data has already been transferred so that it can avoid blocking
+ *   for the remainder.
+ *
+ *   As in pipecommon_drain(), d_bfsem is released while the source runs.
+ *   Readers never look beyond d_wrndx, other writers wait for d_wrxsem,
+ *   and d_wrbusy keeps the buffer from being resized.
+ *
+ * Returned Value:
+ *   The number of bytes added, 0 if the source is at end-of-file, or a
+ *   negated errno.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_fill(FAR struct file *filep, pipe_source_t source, FAR void *arg, size_t len, bool nonblock)
+{
+	FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+	FAR uint8_t *span;
+	ssize_t total = 0;
+	ssize_t ret = 0;
+	size_t nbytes;
+
+	DEBUGASSERT(dev && source);
+
+	if (len == 0) {
+		return 0;
+	}
+
+	nonblock = nonblock || (filep->f_oflags & O_NONBLOCK) != 0;
+	ret = pipecommon_xsemtake(&dev->d_wrxsem, nonblock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	pipecommon_semtake(&dev->d_bfsem);
+	ret = pipecommon_waitspace(dev, nonblock);
+	if (ret < 0) {
+		sem_post(&dev->d_wrxsem);
+		return ret;
+	}
+
+	while (total < len && (nbytes = pipecommon_wrspan(dev)) > 0) {
+		if (nbytes > len - total) {
+			nbytes = len - total;
+		}
+
+		span = &dev->d_buffer[dev->d_wrndx];
+		dev->d_wrbusy = true;
+		sem_post(&dev->d_bfsem);
+
+		ret = source(arg, span, nbytes, total > 0);
+
+		pipecommon_semtake(&dev->d_bfsem);
+		dev->d_wrbusy = false;
+		if (ret <= 0) {
+			break;
+		}
+
+		dev->d_wrndx = pipecommon_advance(dev, dev->d_wrndx, ret);
+		total += ret;
+
+		/* Let blocked readers have the data at once */
+
+		pipecommon_wakeup(&dev->d_rdsem);
+		pipecommon_pollnotify(dev, POLLIN);
+
+		if (ret < nbytes) {
+			break;
+		}
+	}
+
+	sem_post(&dev->d_bfsem);
+	sem_post(&dev->d_wrxsem);
+
+	/* A would-block after some data was added is not an error */
+
+	return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copy
+ *
+ * Description:
+ *   Move ('consume' true, splice) or duplicate ('consume' false, tee) up to
+ *   'len' bytes from one pipe to another.  The data is copied once, from
+ *   one circular buffer to the other.  Waits until the input pipe has data
+ *   and the output pipe has space unless 'nonblock' is set.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, 0 on end-of-file of the input pipe, or
+ *   a negated errno.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_copy(FAR struct file *infile, FAR struct file *outfile, size_t len, bool nonblock, bool consume)
+{
+	FAR struct pipe_dev_s *in = infile->f_inode->i_private;
+	FAR struct pipe_dev_s *out = outfile->f_inode->i_private;
+	FAR struct pipe_dev_s *first;
+	FAR struct pipe_dev_s *second;
+	ssize_t total = 0;
+	size_t rdndx;
+	size_t avail;
+	size_t nbytes;
+	size_t span;
+	ssize_t ret;
+
+	DEBUGASSERT(in && out);
+
+	if (in == out) {
+		return -EINVAL;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+
+	/* The two device semaphores are always taken in address order so that
+	 * two concurrent transfers in opposite directions cannot deadlock.
+	 */
+
+	first = in < out ? in : out;
+	second = in < out ? out : in;
+
+	/* Keep splices of either pipe from using the buffers unlocked.  tee()
+	 * does not consume, so it can read alongside another reader.
+	 */
+
+	if (consume) {
+		ret = pipecommon_xsemtake(&in->d_rdxsem, nonblock || (infile->f_oflags & O_NONBLOCK) != 0);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	ret = pipecommon_xsemtake(&out->d_wrxsem, nonblock || (outfile->f_oflags & O_NONBLOCK) != 0);
+	if (ret < 0) {
+		if (consume) {
+			sem_post(&in->d_rdxsem);
+		}
+
+		return ret;
+	}
+
+	for (;;) {
+		/* Wait for data in the input and space in the output, one pipe at
+		 * a time, then take both and recheck.
+		 */
+
+		pipecommon_semtake(&in->d_bfsem);
+		ret = pipecommon_waitdata(in, nonblock || (infile->f_oflags & O_NONBLOCK) != 0);
+		if (ret <= 0) {
+			ret = ret < 0 && ret != -EAGAIN ? -EINTR : ret;
+			goto errout;
+		}
+		sem_post(&in->d_bfsem);
+
+		pipecommon_semtake(&out->d_bfsem);
+		ret = pipecommon_waitspace(out, nonblock || (outfile->f_oflags & O_NONBLOCK) != 0);
+		if (ret < 0) {
+			goto errout;
+		}
+		sem_post(&out->d_bfsem);
+
+		pipecommon_semtake(&first->d_bfsem);
+		pipecommon_semtake(&second->d_bfsem);
+
+		if (in->d_wrndx != in->d_rdndx && pipecommon_wrspan(out) > 0) {
+			break;
+		}
+
+		/* Lost a race with another reader or writer, try again */
+
+		sem_post(&second->d_bfsem);
+		sem_post(&first->d_bfsem);
+	}
+
+	avail = pipecommon_nbytes(in);
+	if (avail > len) {
+		avail = len;
+	}
+
+	rdndx = in->d_rdndx;
+	while (total < avail && (span = pipecommon_wrspan(out)) > 0) {
+		nbytes = pipecommon_rdspan(in, rdndx);
+		if (nbytes > span) {
+			nbytes = span;
+		}
+
+		if (nbytes > avail - total) {
+			nbytes = avail - total;
+		}
+
+		memcpy(&out->d_buffer[out->d_wrndx], &in->d_buffer[rdndx], nbytes);
+		out->d_wrndx = pipecommon_advance(out, out->d_wrndx, nbytes);
+		rdndx = pipecommon_advance(in, rdndx, nbytes);
+		total += nbytes;
+	}
+
+	if (consume) {
+		in->d_rdndx = rdndx;
+		pipecommon_wakeup(&in->d_wrsem);
+		pipecommon_pollnotify(in, POLLOUT);
+	}
+
+	pipecommon_wakeup(&out->d_rdsem);
+	pipecommon_pollnotify(out, POLLIN);
+
+	sem_post(&second->d_bfsem);
+	sem_post(&first->d_bfsem);
+	ret = total;
+
+errout:
+	sem_post(&out->d_wrxsem);
+	if (consume) {
+		sem_post(&in->d_rdxsem);
+	}
+
+	return ret;
+}
+
 #endif							/* CONFIG_DEV_PIPE_SIZE > 0 */
@@ -68,6 +68,13 @@
 #define CONFIG_DEV_PIPE_SIZE 1024
 #endif
 
+/* Upper limit for the size set with PIPEIOC_SETSIZE / F_SETPIPE_SZ */
+
+#if !defined(CONFIG_DEV_PIPE_MAXSIZE) || CONFIG_DEV_PIPE_MAXSIZE < CONFIG_DEV_PIPE_SIZE
+#undef  CONFIG_DEV_PIPE_MAXSIZE
+#define CONFIG_DEV_PIPE_MAXSIZE CONFIG_DEV_PIPE_SIZE
+#endif
+
 #if CONFIG_DEV_PIPE_SIZE > 0
 
 /****************************************************************************
@@ -101,11 +108,22 @@
  * Public Types
  ****************************************************************************/
 
-/* Make the buffer index as small as possible for the configured pipe size */
+/* Callbacks used by pipecommon_drain() and pipecommon_fill() to move data
+ * directly between the circular buffer and another file.  They return the
+ * number of bytes transferred or a negated errno.  'more' tells the source
+ * that data has already been transferred, so it should not block.
+ */
+
+typedef CODE ssize_t (*pipe_sink_t)(FAR void *arg, FAR const uint8_t *buffer, size_t len);
+typedef CODE ssize_t (*pipe_source_t)(FAR void *arg, FAR uint8_t *buffer, size_t len, bool more);
+
+/* Make the buffer index as small as possible for the configured pipe size.
+ * A buffer resized to CONFIG_DEV_PIPE_MAXSIZE has one more byte.
+ */
 
-#if CONFIG_DEV_PIPE_SIZE > 65535
+#if CONFIG_DEV_PIPE_MAXSIZE >= 65535
 typedef uint32_t pipe_ndx_t;	/* 32-bit index */
-#elif CONFIG_DEV_PIPE_SIZE > 255
+#elif CONFIG_DEV_PIPE_MAXSIZE >= 255
 typedef uint16_t pipe_ndx_t;	/* 16-bit index */
 #else
 typedef uint8_t pipe_ndx_t;		/*  8-bit index */
@@ -120,12 +138,17 @@ struct pipe_dev_s {
 	sem_t d_bfsem;				/* Used to serialize access to d_buffer and indices */
 	sem_t d_rdsem;				/* Empty buffer - Reader waits for data write */
 	sem_t d_wrsem;				/* Full buffer - Writer waits for data read */
+	sem_t d_rdxsem;				/* Serializes the readers of the buffered data */
+	sem_t d_wrxsem;				/* Serializes the writers of the free space */
 	pipe_ndx_t d_wrndx;			/* Index in d_buffer to save next byte written */
 	pipe_ndx_t d_rdndx;			/* Index in d_buffer to return the next byte read */
+	pipe_ndx_t d_bufsize;		/* Size of d_buffer (holds d_bufsize - 1 bytes) */
 	uint8_t d_refs;				/* References counts on pipe (limited to 255) */
 	uint8_t d_nwriters;			/* Number of reference counts for write access */
 	uint8_t d_pipeno;			/* Pipe minor number */
 	uint8_t d_flags;			/* See PIPE_FLAG_* definitions */
+	bool d_rdbusy;				/* true: A splice sink uses buffered data */
+	bool d_wrbusy;				/* true: A splice source fills free space */
 	uint8_t *d_buffer;			/* Buffer allocated when device opened */
 
 	/* The following is a list if poll structures of threads waiting for
@@ -163,6 +186,10 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 #endif
 int pipecommon_unlink(FAR struct inode *priv);
+bool pipecommon_ispipe(FAR struct file *filep);
+ssize_t pipecommon_drain(FAR struct file *filep, pipe_sink_t sink, FAR void *arg, size_t len, bool nonblock);
+ssize_t pipecommon_fill(FAR struct file *filep, pipe_source_t source, FAR void *arg, size_t len, bool nonblock);
+ssize_t pipecommon_copy(FAR struct file *infile, FAR struct file *outfile, size_t len, bool nonblock, bool consume);
 
 #undef EXTERN
 #ifdef __cplusplus
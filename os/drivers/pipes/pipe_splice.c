@@ -0,0 +1,301 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ * splice() and tee(): move data between a pipe and a file, a socket or
+ * another pipe without copying it through a user buffer.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/cancelpt.h>
+
+#include "pipe_common.h"
+
+#if CONFIG_DEV_PIPE_SIZE > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The file or socket on the other side of the pipe */
+
+struct splice_peer_s {
+	int fd;						/* Descriptor (used for sockets) */
+	FAR struct file *filep;		/* Open file, NULL for sockets */
+	FAR off_t *offset;			/* Explicit file offset or NULL */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_sink
+ *
+ * Description:
+ *   Write data taken directly from the pipe buffer to the peer.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_sink(FAR void *arg, FAR const uint8_t *buffer, size_t len)
+{
+	FAR struct splice_peer_s *peer = (FAR struct splice_peer_s *)arg;
+	ssize_t ret;
+
+	if (peer->filep == NULL) {
+#if defined(CONFIG_NET_LWIP) && CONFIG_NSOCKET_DESCRIPTORS > 0
+		ret = send(peer->fd, buffer, len, 0);
+		return ret < 0 ? -get_errno() : ret;
+#else
+		return -EBADF;
+#endif
+	}
+
+	if (peer->offset != NULL) {
+		ret = file_pwrite(peer->filep, buffer, len, *peer->offset);
+		if (ret < 0) {
+			return ret;
+		}
+
+		*peer->offset += ret;
+		return ret;
+	}
+
+	return file_write(peer->filep, buffer, len);
+}
+
+/****************************************************************************
+ * Name: splice_source
+ *
+ * Description:
+ *   Read data from the peer directly into the pipe buffer.  Once some data
+ *   has been transferred, a socket is only polled so that the call returns
+ *   what is already available instead of waiting for more.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_source(FAR void *arg, FAR uint8_t *buffer, size_t len, bool more)
+{
+	FAR struct splice_peer_s *peer = (FAR struct splice_peer_s *)arg;
+	ssize_t ret;
+
+	if (peer->filep == NULL) {
+#if defined(CONFIG_NET_LWIP) && CONFIG_NSOCKET_DESCRIPTORS > 0
+		ret = recv(peer->fd, buffer, len, more ? MSG_DONTWAIT : 0);
+		return ret < 0 ? -get_errno() : ret;
+#else
+		return -EBADF;
+#endif
+	}
+
+	if (peer->offset != NULL) {
+		ret = file_pread(peer->filep, buffer, len, *peer->offset);
+		if (ret < 0) {
+			return ret;
+		}
+
+		*peer->offset += ret;
+		return ret;
+	}
+
+	return file_read(peer->filep, buffer, len);
+}
+
+/****************************************************************************
+ * Name: splice_getpeer
+ *
+ * Description:
+ *   Resolve a descriptor into either an open file or a socket.
+ *
+ ****************************************************************************/
+
+static int splice_getpeer(int fd, FAR off_t *offset, FAR struct splice_peer_s *peer)
+{
+	int ret;
+
+	peer->fd = fd;
+	peer->filep = NULL;
+	peer->offset = offset;
+
+	if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS) {
+#if defined(CONFIG_NET_LWIP) && CONFIG_NSOCKET_DESCRIPTORS > 0
+		/* Sockets have no file position */
+
+		return offset != NULL ? -ESPIPE : OK;
+#else
+		return -EBADF;
+#endif
+	}
+
+	ret = fs_getfilep(fd, &peer->filep);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   Move up to 'len' bytes between fd_in and fd_out, at least one of which
+ *   must be a pipe.  Data is read directly into, or written directly from,
+ *   the pipe buffer so that it is copied only once.  If both are pipes the
+ *   data is copied from one pipe buffer to the other.
+ *
+ * Input Parameters:
+ *   fd_in, fd_out - Source and destination descriptors
+ *   off_in, off_out - Explicit offset for a non-pipe regular file, updated
+ *     on return.  Must be NULL for pipes and sockets.
+ *   len - Maximum number of bytes to move
+ *   flags - SPLICE_F_NONBLOCK makes the pipe side non-blocking.  Other flags
+ *     are accepted and ignored.
+ *
+ * Returned Value:
+ *   The number of bytes moved, 0 on end of input, or -1 with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out, size_t len, unsigned int flags)
+{
+	struct splice_peer_s in;
+	struct splice_peer_s out;
+	bool nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+	bool inpipe;
+	bool outpipe;
+	ssize_t ret;
+
+	/* splice() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	ret = splice_getpeer(fd_in, off_in, &in);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	ret = splice_getpeer(fd_out, off_out, &out);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	inpipe = in.filep != NULL && pipecommon_ispipe(in.filep);
+	outpipe = out.filep != NULL && pipecommon_ispipe(out.filep);
+
+	if ((inpipe && off_in != NULL) || (outpipe && off_out != NULL)) {
+		ret = -ESPIPE;
+	} else if (inpipe && outpipe) {
+		ret = pipecommon_copy(in.filep, out.filep, len, nonblock, true);
+	} else if (inpipe) {
+		ret = pipecommon_drain(in.filep, splice_sink, &out, len, nonblock);
+	} else if (outpipe) {
+		ret = pipecommon_fill(out.filep, splice_source, &in, len, nonblock);
+	} else {
+		ret = -EINVAL;
+	}
+
+	if (ret < 0) {
+		goto errout;
+	}
+
+	leave_cancellation_point();
+	return ret;
+
+errout:
+	set_errno(-ret);
+	leave_cancellation_point();
+	return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   Copy up to 'len' bytes from pipe fd_in to pipe fd_out without consuming
+ *   them, so that the same data can still be read or spliced from fd_in.
+ *
+ * Returned Value:
+ *   The number of bytes copied, 0 if fd_in is empty and has no writers, or
+ *   -1 with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+	FAR struct file *infile;
+	FAR struct file *outfile;
+	ssize_t ret;
+
+	(void)enter_cancellation_point();
+
+	if ((unsigned int)fd_in >= CONFIG_NFILE_DESCRIPTORS || (unsigned int)fd_out >= CONFIG_NFILE_DESCRIPTORS) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	ret = fs_getfilep(fd_in, &infile);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	ret = fs_getfilep(fd_out, &outfile);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	if (!pipecommon_ispipe(infile) || !pipecommon_ispipe(outfile)) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	ret = pipecommon_copy(infile, outfile, len, (flags & SPLICE_F_NONBLOCK) != 0, false);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	leave_cancellation_point();
+	return ret;
+
+errout:
+	set_errno(-ret);
+	leave_cancellation_point();
+	return ERROR;
+}
+
+#endif							/* CONFIG_DEV_PIPE_SIZE > 0 */
@@ -68,6 +68,7 @@
 #include <debug.h>
 
 #include <tinyara/kmalloc.h>
+#include <tinyara/clock.h>
 #include <tinyara/wqueue.h>
 #include <tinyara/rwbuffer.h>
 
@@ -91,6 +92,14 @@
  * Private Types
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb);
+#endif
+
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
@@ -145,6 +154,19 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1, off_t blockst
 	}
 }
 
+/****************************************************************************
+ * Name: rwb_resetextent
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static inline void rwb_resetextent(FAR struct rwb_extent_s *ext)
+{
+	ext->blockstart = (off_t)-1;
+	ext->nblocks = 0;
+	ext->flushing = false;
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_resetwrbuffer
  ****************************************************************************/
@@ -152,45 +174,127 @@ static inline bool rwb_overlap(off_t blockstart1, size_t nblocks1, off_t blockst
 #ifdef CONFIG_DRVR_WRITEBUFFER
 static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
 {
+	int i;
+
 	/* We assume that the caller holds the wrsem */
 
-	rwb->wrnblocks = 0;
-	rwb->wrblockstart = (off_t)-1;
-	rwb->wrexpectedblock = (off_t)-1;
+	for (i = 0; i < rwb->wrnextents; i++) {
+		rwb_resetextent(&rwb->wrextent[i]);
+	}
 }
 #endif
 
 /****************************************************************************
  * Name: rwb_wrflush
  *
+ * Description:
+ *   Write back every dirty extent of the write buffer.  The extents are
+ *   claimed under wrsem and then written in ascending block order without
+ *   holding wrsem, so writers may keep filling the other extents while the
+ *   media is busy.  flsem serializes write-back passes so that data is
+ *   written to the media in the order in which it was buffered.
+ *
  * Assumptions:
- *   The caller holds the wrsem semaphore.
+ *   The caller holds the flsem semaphore but not the wrsem semaphore.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrflush(struct rwbuffer_s *rwb)
+static int rwb_wrflushlocked(struct rwbuffer_s *rwb, bool sync)
 {
-	int ret;
+	FAR struct rwb_extent_s *batch[CONFIG_DRVR_WREXTENTS];
+	FAR struct rwb_extent_s *ext;
+	clock_t start;
+	clock_t elapsed;
+	int nbatch = 0;
+	int ret = OK;
+	int err;
+	int i;
+	int j;
 
-	fvdbg("Timeout!\n");
+	rwb_semtake(&rwb->wrsem);
 
-	if (rwb->wrnblocks > 0) {
-		fvdbg("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n", (long)rwb->wrblockstart, rwb->wrnblocks, rwb->wrbuffer);
+	/* Claim all dirty extents, sorted by their first block */
 
-		/* Flush cache.  On success, the flush method will return the number
-		 * of blocks written.  Anything other than the number requested is
-		 * an error.
-		 */
+	for (i = 0; i < rwb->wrnextents; i++) {
+		ext = &rwb->wrextent[i];
+		if (ext->nblocks == 0) {
+			continue;
+		}
 
-		ret = rwb->wrflush(rwb->dev, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
-		if (ret != rwb->wrnblocks) {
-			fdbg("ERROR: Error flushing write buffer: %d\n", ret);
+		for (j = nbatch; j > 0 && batch[j - 1]->blockstart > ext->blockstart; j--) {
+			batch[j] = batch[j - 1];
 		}
 
-		rwb_resetwrbuffer(rwb);
+		batch[j] = ext;
+		ext->flushing = true;
+		nbatch++;
+	}
+
+	rwb_semgive(&rwb->wrsem);
+
+	if (nbatch > 0) {
+		start = clock_systimer();
+
+		for (i = 0; i < nbatch; i++) {
+			ext = batch[i];
+			fvdbg("Flushing: blockstart=0x%08lx nblocks=%d from buffer=%p\n", (long)ext->blockstart, ext->nblocks, ext->buffer);
+
+			/* Flush the extent.  On success, the flush method will return
+			 * the number of blocks written.  Anything other than the number
+			 * requested is an error.
+			 */
+
+			err = rwb->wrflush(rwb->dev, ext->buffer, ext->blockstart, ext->nblocks);
+			if (err != ext->nblocks) {
+				fdbg("ERROR: Error flushing write buffer: %d\n", err);
+				ret = err < 0 ? err : -EIO;
+			}
+		}
+
+		elapsed = clock_systimer() - start;
+
+		/* Release the extents and account for the write-back pass */
+
+		rwb_semtake(&rwb->wrsem);
+		for (i = 0; i < nbatch; i++) {
+			rwb->stats.flushblocks += batch[i]->nblocks;
+			rwb_resetextent(batch[i]);
+		}
+
+		rwb->stats.flushes++;
+		if (sync) {
+			rwb->stats.syncflushes++;
+		}
+
+		rwb->stats.flushticks += elapsed;
+		if (elapsed > rwb->stats.maxflushticks) {
+			rwb->stats.maxflushticks = elapsed;
+		}
+
+		rwb_semgive(&rwb->wrsem);
 	}
 
+	return ret;
+}
+
+/****************************************************************************
+ * Name: rwb_wrflush
+ *
+ * Description:
+ *   Write back every dirty extent, waiting for a write-back pass that is
+ *   already running to complete first.
+ *
+ ****************************************************************************/
+
+static int rwb_wrflush(struct rwbuffer_s *rwb, bool sync)
+{
+	int ret;
+
+	rwb_semtake(&rwb->flsem);
+	ret = rwb_wrflushlocked(rwb, sync);
+	rwb_semgive(&rwb->flsem);
+	return ret;
 }
 #endif
 
@@ -198,6 +302,7 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
  * Name: rwb_wrtimeout
  ****************************************************************************/
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
 static void rwb_wrtimeout(FAR void *arg)
 {
 	/* The following assumes that the size of a pointer is 4-bytes or less */
@@ -205,14 +310,22 @@ static void rwb_wrtimeout(FAR void *arg)
 	FAR struct rwbuffer_s *rwb = (struct rwbuffer_s *)arg;
 	DEBUGASSERT(rwb != NULL);
 
-	/* If a timeout elapses with with write buffer activity, this watchdog
-	 * handler function will be evoked on the thread of execution of the
-	 * worker thread.
+	/* If a timeout elapses with with write buffer activity, or if the write
+	 * buffer is filling up, this handler function will be evoked on the
+	 * thread of execution of the worker thread.
+	 *
+	 * The LP work queue is shared, so do not wait here while a writer is
+	 * flushing synchronously.  That pass writes back what is buffered now;
+	 * check again for data buffered meanwhile after the usual delay.
 	 */
 
-	rwb_semtake(&rwb->wrsem);
-	rwb_wrflush(rwb);
-	rwb_semgive(&rwb->wrsem);
+	if (sem_trywait(&rwb->flsem) < 0) {
+		rwb_wrstarttimeout(rwb);
+		return;
+	}
+
+	(void)rwb_wrflushlocked(rwb, false);
+	rwb_semgive(&rwb->flsem);
 }
 
 /****************************************************************************
@@ -229,6 +342,19 @@ static void rwb_wrstarttimeout(FAR struct rwbuffer_s *rwb)
 	(void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb, ticks);
 }
 
+/****************************************************************************
+ * Name: rwb_wrstartflush
+ *
+ * Description:
+ *   Hand the write-back of all dirty extents to the worker thread now.
+ *
+ ****************************************************************************/
+
+static void rwb_wrstartflush(FAR struct rwbuffer_s *rwb)
+{
+	(void)work_queue(LPWORK, &rwb->work, rwb_wrtimeout, (FAR void *)rwb, 0);
+}
+
 /****************************************************************************
  * Name: rwb_wrcanceltimeout
  ****************************************************************************/
@@ -237,6 +363,75 @@ static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 {
 	(void)work_cancel(LPWORK, &rwb->work);
 }
+#endif
+
+/****************************************************************************
+ * Name: rwb_wrfindextent
+ *
+ * Description:
+ *   Select the extent that will buffer the blocks startblock through
+ *   startblock + nblocks - 1: an extent that already holds or directly
+ *   precedes them and has room, otherwise a free extent.  NULL is returned
+ *   if the dirty extents must be written back first, either because none
+ *   is free or because the blocks partially overlap buffered data.
+ *
+ * Assumptions:
+ *   The caller holds the wrsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static FAR struct rwb_extent_s *rwb_wrfindextent(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks)
+{
+	FAR struct rwb_extent_s *freeext = NULL;
+	FAR struct rwb_extent_s *target = NULL;
+	FAR struct rwb_extent_s *ext;
+	off_t endblock = startblock + nblocks;
+	off_t extend;
+	int i;
+
+	/* Extents being written back are never modified */
+
+	for (i = 0; i < rwb->wrnextents; i++) {
+		ext = &rwb->wrextent[i];
+		if (ext->flushing) {
+			continue;
+		}
+
+		if (ext->nblocks == 0) {
+			if (freeext == NULL) {
+				freeext = ext;
+			}
+
+			continue;
+		}
+
+		/* Rewrite blocks held in the extent and/or append to it */
+
+		extend = ext->blockstart + ext->nblocks;
+		if (target == NULL && startblock >= ext->blockstart && startblock <= extend &&
+			endblock - ext->blockstart <= rwb->extmaxblocks) {
+			target = ext;
+		}
+	}
+
+	/* The dirty extents must never overlap each other */
+
+	for (i = 0; i < rwb->wrnextents; i++) {
+		ext = &rwb->wrextent[i];
+		if (ext == target || ext->flushing || ext->nblocks == 0) {
+			continue;
+		}
+
+		extend = ext->blockstart + ext->nblocks;
+		if (ext->blockstart < endblock && startblock < extend) {
+			return NULL;
+		}
+	}
+
+	return target != NULL ? target : freeext;
+}
+#endif
 
 /****************************************************************************
  * Name: rwb_writebuffer
@@ -245,61 +440,184 @@ static inline void rwb_wrcanceltimeout(struct rwbuffer_s *rwb)
 #ifdef CONFIG_DRVR_WRITEBUFFER
 static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR const uint8_t *wrbuffer)
 {
+	FAR struct rwb_extent_s *ext;
+	off_t endblock = startblock + nblocks;
+	int ndirty;
 	int ret;
+	int i;
 
 	/* Write writebuffer Logic */
 
 	rwb_wrcanceltimeout(rwb);
 
-	/* First: Should we flush out our cache? We would do that if (1) we already
-	 * buffering blocks and the next block writing is not in the same sequence,
-	 * or (2) the number of blocks would exceed our allocated buffer capacity
+	/* First: Find an extent for the data.  If there is none, we have to
+	 * write back the buffered data ourselves before we can continue.
 	 */
 
-	if (((startblock != rwb->wrexpectedblock) && (rwb->wrnblocks)) || ((rwb->wrnblocks + nblocks) > rwb->wrmaxblocks)) {
-		fvdbg("writebuffer miss, expected: %08x, given: %08x\n", rwb->wrexpectedblock, startblock);
+	for (;;) {
+		rwb_semtake(&rwb->wrsem);
+		ext = rwb_wrfindextent(rwb, startblock, nblocks);
+		if (ext != NULL) {
+			break;
+		}
+
+		rwb_semgive(&rwb->wrsem);
 
-		/* Flush the write buffer */
+		fvdbg("writebuffer miss, given: %08x\n", startblock);
 
-		ret = rwb->wrflush(rwb, rwb->wrbuffer, rwb->wrblockstart, rwb->wrnblocks);
+		ret = rwb_wrflush(rwb, true);
 		if (ret < 0) {
 			fdbg("ERROR: Error writing multiple from cache: %d\n", -ret);
 			return ret;
 		}
+	}
 
-		rwb_resetwrbuffer(rwb);
+	/* Extent is empty? Then initialize it */
+
+	if (ext->nblocks == 0) {
+		fvdbg("Fresh extent starting at block: 0x%08x\n", startblock);
+		ext->blockstart = startblock;
 	}
 
-	/* writebuffer is empty? Then initialize it */
+	/* Add data to the extent */
+
+	fvdbg("writebuffer: copying %d bytes from %p to %p\n", nblocks * rwb->blocksize, wrbuffer, &ext->buffer[(startblock - ext->blockstart) * rwb->blocksize]);
+	memcpy(&ext->buffer[(startblock - ext->blockstart) * rwb->blocksize], wrbuffer, nblocks * rwb->blocksize);
 
-	if (rwb->wrnblocks == 0) {
-		fvdbg("Fresh cache starting at block: 0x%08x\n", startblock);
-		rwb->wrblockstart = startblock;
+	if (endblock > ext->blockstart + ext->nblocks) {
+		ext->nblocks = endblock - ext->blockstart;
 	}
 
-	/* Add data to cache */
+	rwb->stats.wrblocks += nblocks;
 
-	fvdbg("writebuffer: copying %d bytes from %p to %p\n", nblocks * rwb->blocksize, wrbuffer, &rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize]);
-	memcpy(&rwb->wrbuffer[rwb->wrnblocks * rwb->blocksize], wrbuffer, nblocks * rwb->blocksize);
+	ndirty = 0;
+	for (i = 0; i < rwb->wrnextents; i++) {
+		if (rwb->wrextent[i].nblocks > 0 && !rwb->wrextent[i].flushing) {
+			ndirty++;
+		}
+	}
+
+	rwb_semgive(&rwb->wrsem);
+
+	/* Once half of the extents are dirty, start writing them back on the
+	 * worker thread so that later writers are unlikely to find the buffer
+	 * full.  The single buffer is only flushed on a miss or after a delay.
+	 */
+
+	if (rwb->wrnextents > 1 && ndirty >= (rwb->wrnextents + 1) / 2) {
+		rwb_wrstartflush(rwb);
+	} else {
+		rwb_wrstarttimeout(rwb);
+	}
 
-	rwb->wrnblocks += nblocks;
-	rwb->wrexpectedblock = rwb->wrblockstart + rwb->wrnblocks;
-	rwb_wrstarttimeout(rwb);
 	return nblocks;
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_wroverlap
+ *
+ * Description:
+ *   Return true if any extent of the write buffer (including extents being
+ *   written back) overlaps the given blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static bool rwb_wroverlap(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks)
+{
+	FAR struct rwb_extent_s *ext;
+	bool overlap = false;
+	int i;
+
+	rwb_semtake(&rwb->wrsem);
+	for (i = 0; i < rwb->wrnextents && !overlap; i++) {
+		ext = &rwb->wrextent[i];
+		overlap = ext->nblocks > 0 && rwb_overlap(ext->blockstart, ext->nblocks, startblock, nblocks);
+	}
+
+	rwb_semgive(&rwb->wrsem);
+	return overlap;
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_resetrhbuffer
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
+static inline void rwb_resetrhstream(FAR struct rwb_rhstream_s *stream)
+{
+	stream->nblocks = 0;
+	stream->blockstart = (off_t)-1;
+}
+
 static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
 {
+	int i;
+
 	/* We assume that the caller holds the readAheadBufferSemphore */
 
-	rwb->rhnblocks = 0;
-	rwb->rhblockstart = (off_t)-1;
+	for (i = 0; i < rwb->rhnstreams; i++) {
+		rwb_resetrhstream(&rwb->rhstream[i]);
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: rwb_rhfind
+ *
+ * Description:
+ *   Return the read-ahead stream that holds startblock, or NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READAHEAD
+static FAR struct rwb_rhstream_s *rwb_rhfind(FAR struct rwbuffer_s *rwb, off_t startblock)
+{
+	FAR struct rwb_rhstream_s *stream;
+	int i;
+
+	for (i = 0; i < rwb->rhnstreams; i++) {
+		stream = &rwb->rhstream[i];
+		if (stream->nblocks > 0 && startblock >= stream->blockstart && startblock < stream->blockstart + stream->nblocks) {
+			return stream;
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: rwb_rhvictim
+ *
+ * Description:
+ *   Select the read-ahead stream to reload at startblock: the stream that
+ *   ends right before startblock (the reader is continuing it), otherwise
+ *   the least recently used stream.
+ *
+ ****************************************************************************/
+
+static FAR struct rwb_rhstream_s *rwb_rhvictim(FAR struct rwbuffer_s *rwb, off_t startblock)
+{
+	FAR struct rwb_rhstream_s *victim = &rwb->rhstream[0];
+	FAR struct rwb_rhstream_s *stream;
+	int i;
+
+	for (i = 0; i < rwb->rhnstreams; i++) {
+		stream = &rwb->rhstream[i];
+		if (stream->nblocks > 0 && stream->blockstart + stream->nblocks == startblock) {
+			return stream;
+		}
+
+		if (stream->nblocks == 0) {
+			victim = stream;
+		} else if (victim->nblocks > 0 && (int32_t)(stream->lru - victim->lru) < 0) {
+			victim = stream;
+		}
+	}
+
+	return victim;
 }
 #endif
 
@@ -308,22 +626,22 @@ static inline void rwb_resetrhbuffer(struct rwbuffer_s *rwb)
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static inline void rwb_bufferread(struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, uint8_t **rdbuffer)
+static inline void rwb_bufferread(struct rwbuffer_s *rwb, FAR struct rwb_rhstream_s *stream, off_t startblock, size_t nblocks, uint8_t **rdbuffer)
 {
 	/* We assume that (1) the caller holds the readAheadBufferSemphore, and (2)
 	 * that the caller already knows that all of the blocks are in the
-	 * read-ahead buffer.
+	 * read-ahead stream.
 	 */
 
 	/* Convert the units from blocks to bytes */
 
-	off_t blockoffset = startblock - rwb->rhblockstart;
+	off_t blockoffset = startblock - stream->blockstart;
 	off_t byteoffset = rwb->blocksize * blockoffset;
 	size_t nbytes = rwb->blocksize * nblocks;
 
 	/* Get the byte address in the read-ahead buffer */
 
-	uint8_t *rhbuffer = rwb->rhbuffer + byteoffset;
+	uint8_t *rhbuffer = stream->buffer + byteoffset;
 
 	/* Copy the data from the read-ahead buffer into the IO buffer */
 
@@ -340,7 +658,7 @@ static inline void rwb_bufferread(struct rwbuffer_s *rwb, off_t startblock, size
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READAHEAD
-static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
+static int rwb_rhreload(struct rwbuffer_s *rwb, FAR struct rwb_rhstream_s *stream, off_t startblock)
 {
 	off_t endblock;
 	size_t nblocks;
@@ -353,10 +671,10 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 	}
 
 	/* Get the block number +1 of the last block that will fit in the
-	 * read-ahead buffer
+	 * read-ahead stream
 	 */
 
-	endblock = startblock + rwb->rhmaxblocks;
+	endblock = startblock + rwb->rhstreamblocks;
 
 	/* Make sure that we don't read past the end of the device */
 
@@ -366,18 +684,19 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 
 	nblocks = endblock - startblock;
 
-	/* Reset the read buffer */
+	/* Reset the read stream */
 
-	rwb_resetrhbuffer(rwb);
+	rwb_resetrhstream(stream);
 
 	/* Now perform the read */
 
-	ret = rwb->rhreload(rwb->dev, rwb->rhbuffer, startblock, nblocks);
+	ret = rwb->rhreload(rwb->dev, stream->buffer, startblock, nblocks);
 	if (ret == nblocks) {
-		/* Update information about what is in the read-ahead buffer */
+		/* Update information about what is in the read-ahead stream */
 
-		rwb->rhnblocks = nblocks;
-		rwb->rhblockstart = startblock;
+		stream->nblocks = nblocks;
+		stream->blockstart = startblock;
+		rwb->stats.rhreloads++;
 
 		/* The return value is not the number of blocks we asked to be loaded. */
 
@@ -389,127 +708,159 @@ static int rwb_rhreload(struct rwbuffer_s *rwb, off_t startblock)
 #endif
 
 /****************************************************************************
- * Name: rwb_invalidate_writebuffer
+ * Name: rwb_invalidate_extent
  *
  * Description:
- *   Invalidate a region of the write buffer
+ *   Invalidate a region of one write buffer extent
+ *
+ * Assumptions:
+ *   The caller holds the flsem and wrsem semaphores.
  *
  ****************************************************************************/
 
 #if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
-int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount)
+static int rwb_invalidate_extent(FAR struct rwbuffer_s *rwb, FAR struct rwb_extent_s *ext, off_t startblock, size_t blockcount)
 {
+	off_t wrbend;
+	off_t invend;
 	int ret;
 
-	if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0) {
-		off_t wrbend;
-		off_t invend;
+	/* Now there are five cases:
+	 *
+	 * 1. We invalidate nothing
+	 */
 
-		fvdbg("startblock=%d blockcount=%p\n", startblock, blockcount);
+	wrbend = ext->blockstart + ext->nblocks;
+	invend = startblock + blockcount;
 
-		rwb_semtake(&rwb->wrsem);
+	if (ext->nblocks == 0 || ext->blockstart >= invend || wrbend <= startblock) {
+		ret = OK;
+	}
 
-		/* Now there are five cases:
-		 *
-		 * 1. We invalidate nothing
-		 */
+	/* 2. We invalidate the entire extent. */
+
+	else if (ext->blockstart >= startblock && wrbend <= invend) {
+		rwb_resetextent(ext);
+		ret = OK;
+	}
 
-		wrbend = rwb->wrblockstart + rwb->wrnblocks;
-		invend = startblock + blockcount;
+	/* We are going to invalidate a subset of the extent.  Three more cases
+	 * to consider:
+	 *
+	 * 3. We invalidate a portion in the middle of the extent
+	 */
 
-		if (rwb->wrblockstart > invend || wrbend < startblock) {
-			ret = OK;
-		}
+	else if (ext->blockstart < startblock && wrbend > invend) {
+		uint8_t *src;
+		off_t block;
+		off_t offset;
+		size_t nblocks;
 
-		/* 2. We invalidate the entire write buffer. */
+		/* Write the blocks at the end of the media to hardware */
 
-		else if (rwb->wrblockstart >= startblock && wrbend <= invend) {
-			rwb->wrnblocks = 0;
-			ret = OK;
+		nblocks = wrbend - invend;
+		block = invend;
+		offset = block - ext->blockstart;
+		src = ext->buffer + offset * rwb->blocksize;
+
+		ret = rwb->wrflush(rwb->dev, src, block, nblocks);
+		if (ret < 0) {
+			fdbg("ERROR: wrflush failed: %d\n", ret);
 		}
 
-		/* We are going to invalidate a subset of the write buffer.  Three
-		 * more cases to consider:
-		 *
-		 * 2. We invalidate a portion in the middle of the write buffer
+		/* Keep the blocks at the beginning of the extent up the
+		 * start of the invalidated region.
 		 */
+		else {
+			ext->nblocks = startblock - ext->blockstart;
+			ret = OK;
+		}
+	}
 
-		else if (rwb->wrblockstart < startblock && wrbend > invend) {
-			uint8_t *src;
-			off_t block;
-			off_t offset;
-			size_t nblocks;
+	/* 4. We invalidate a portion at the end of the extent */
 
-			/* Write the blocks at the end of the media to hardware */
+	else if (ext->blockstart < startblock) {
+		ext->nblocks = startblock - ext->blockstart;
+		ret = OK;
+	}
 
-			nblocks = wrbend - invend;
-			block = invend;
-			offset = block - rwb->wrblockstart;
-			src = rwb->wrbuffer + offset * rwb->blocksize;
+	/* 5. We invalidate a portion at the beginning of the extent */
 
-			ret = rwb->wrflush(rwb->dev, src, block, nblocks);
-			if (ret < 0) {
-				fdbg("ERROR: wrflush failed: %d\n", ret);
-			}
+	else {						/* if (ext->blockstart >= startblock && wrbend > invend) */
 
-			/* Keep the blocks at the beginning of the buffer up the
-			 * start of the invalidated region.
-			 */
-			else {
-				rwb->wrnblocks = startblock - rwb->wrblockstart;
-				ret = OK;
-			}
-		}
+		uint8_t *src;
+		size_t ninval;
+		size_t nkeep;
 
-		/* 3. We invalidate a portion at the end of the write buffer */
+		DEBUGASSERT(ext->blockstart >= startblock && wrbend > invend);
 
-		else if (wrbend > startblock && wrbend <= invend) {
-			rwb->wrnblocks = wrbend - startblock;
-			ret = OK;
-		}
+		/* Copy the data from the uninvalidated region to the beginning
+		 * of the extent.
+		 *
+		 * First calculate the source and destination of the transfer.
+		 */
 
-		/* 4. We invalidate a portion at the beginning of the write buffer */
+		ninval = invend - ext->blockstart;
+		src = ext->buffer + ninval * rwb->blocksize;
 
-		else {					/* if (rwb->wrblockstart >= startblock && wrbend > invend) */
+		/* Calculate the number of blocks we are keeping.  We keep
+		 * the ones that we don't invalidate.
+		 */
 
-			uint8_t *src;
-			size_t ninval;
-			size_t nkeep;
+		nkeep = ext->nblocks - ninval;
 
-			DEBUGASSERT(rwb->wrblockstart >= startblock && wrbend > invend);
+		/* Then move the data that we are keeping to the beginning
+		 * the extent.
+		 */
 
-			/* Copy the data from the uninvalidated region to the beginning
-			 * of the write buffer.
-			 *
-			 * First calculate the source and destination of the transfer.
-			 */
+		memmove(ext->buffer, src, nkeep * rwb->blocksize);
+
+		/* Update the block info.  The first block is now the one just
+		 * after the invalidation region and the number buffered blocks
+		 * is the number that we kept.
+		 */
 
-			ninval = invend - rwb->wrblockstart;
-			src = rwb->wrbuffer + ninval * rwb->blocksize;
+		ext->blockstart = invend;
+		ext->nblocks = nkeep;
+		ret = OK;
+	}
 
-			/* Calculate the number of blocks we are keeping.  We keep
-			 * the ones that we don't invalidate.
-			 */
+	return ret;
+}
+#endif
 
-			nkeep = rwb->wrnblocks - ninval;
+/****************************************************************************
+ * Name: rwb_invalidate_writebuffer
+ *
+ * Description:
+ *   Invalidate a region of the write buffer
+ *
+ ****************************************************************************/
 
-			/* Then move the data that we are keeping to the beginning
-			 * the write buffer.
-			 */
+#if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
+int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount)
+{
+	int ret = OK;
+	int err;
+	int i;
 
-			memcpy(rwb->wrbuffer, src, nkeep * rwb->blocksize);
+	if (rwb->wrmaxblocks > 0) {
+		fvdbg("startblock=%d blockcount=%p\n", startblock, blockcount);
 
-			/* Update the block info.  The first block is now the one just
-			 * after the invalidation region and the number buffered blocks
-			 * is the number that we kept.
-			 */
+		/* Wait for any write-back in progress so that no extent is busy */
 
-			rwb->wrblockstart = invend;
-			rwb->wrnblocks = nkeep;
-			ret = OK;
+		rwb_semtake(&rwb->flsem);
+		rwb_semtake(&rwb->wrsem);
+
+		for (i = 0; i < rwb->wrnextents; i++) {
+			err = rwb_invalidate_extent(rwb, &rwb->wrextent[i], startblock, blockcount);
+			if (err < 0) {
+				ret = err;
+			}
 		}
 
 		rwb_semgive(&rwb->wrsem);
+		rwb_semgive(&rwb->flsem);
 	}
 
 	return ret;
@@ -527,75 +878,55 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb, off_t startblock, siz
 #if defined(CONFIG_DRVR_READAHEAD)  && defined(CONFIG_DRVR_INVALIDATE)
 int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount)
 {
-	int ret;
-
-	if (rwb->rhmaxblocks > 0 && rwb->rhnblocks > 0) {
-		off_t rhbend;
-		off_t invend;
+	FAR struct rwb_rhstream_s *stream;
+	off_t rhbend;
+	off_t invend;
+	int i;
 
+	if (rwb->rhmaxblocks > 0) {
 		fvdbg("startblock=%d blockcount=%p\n", startblock, blockcount);
 
 		rwb_semtake(&rwb->rhsem);
 
-		/* Now there are five cases:
-		 *
-		 * 1. We invalidate nothing
-		 */
+		for (i = 0; i < rwb->rhnstreams; i++) {
+			stream = &rwb->rhstream[i];
 
-		rhbend = rwb->rhblockstart + rwb->rhnblocks;
-		invend = startblock + blockcount;
-
-		if (rhbend <= startblock || rwb->rhblockstart >= invend) {
-			ret = OK;
-		}
-
-		/* 2. We invalidate the entire read-ahead buffer. */
-
-		else if (rwb->rhblockstart >= startblock && rhbend <= invend) {
-			rwb->rhnblocks = 0;
-			ret = OK;
-		}
-
-		/* We are going to invalidate a subset of the read-ahead buffer.
-		 * Three more cases to consider:
-		 *
-		 * 2. We invalidate a portion in the middle of the read-ahead buffer
-		 */
-
-		else if (rwb->rhblockstart < startblock && rhbend > invend) {
-			/* Keep the blocks at the beginning of the buffer up the
-			 * start of the invalidated region.
+			/* Now there are five cases:
+			 *
+			 * 1. We invalidate nothing
 			 */
 
-			rwb->rhnblocks = startblock - rwb->rhblockstart;
-			ret = OK;
-		}
-
-		/* 3. We invalidate a portion at the end of the read-ahead buffer */
+			rhbend = stream->blockstart + stream->nblocks;
+			invend = startblock + blockcount;
 
-		else if (rhbend > startblock && rhbend <= invend) {
-			rwb->rhnblocks = rhbend - startblock;
-			ret = OK;
-		}
+			if (stream->nblocks == 0 || rhbend <= startblock || stream->blockstart >= invend) {
+				continue;
+			}
 
-		/* 4. We invalidate a portion at the beginning of the write buffer */
+			/* 2. We invalidate a portion at the end or in the middle of the
+			 * stream.  Keep the blocks at the beginning of the stream up to
+			 * the start of the invalidated region.
+			 */
 
-		else {					/* if (rwb->rhblockstart >= startblock && rhbend > invend) */
+			if (stream->blockstart < startblock) {
+				stream->nblocks = startblock - stream->blockstart;
+			}
 
-			/* Let's just force the whole read-ahead buffer to be reloaded.
+			/* 3. We invalidate the entire stream or a portion at its
+			 * beginning.  Let's just force the whole stream to be reloaded.
 			 * That might cost s small amount of performance, but well worth
 			 * the lower complexity.
 			 */
 
-			DEBUGASSERT(rwb->rhblockstart >= startblock && rhbend > invend);
-			rwb->rhnblocks = 0;
-			ret = OK;
+			else {
+				rwb_resetrhstream(stream);
+			}
 		}
 
 		rwb_semgive(&rwb->rhsem);
 	}
 
-	return ret;
+	return OK;
 }
 #endif
 
@@ -609,6 +940,7 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb, off_t startblock, size_
 int rwb_initialize(FAR struct rwbuffer_s *rwb)
 {
 	uint32_t allocsize;
+	int i;
 
 	/* Sanity checking */
 
@@ -617,6 +949,8 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 	DEBUGASSERT(rwb->nblocks > 0);
 	DEBUGASSERT(rwb->dev != NULL);
 
+	memset(&rwb->stats, 0, sizeof(struct rwb_stats_s));
+
 	/* Setup so that rwb_uninitialize can handle a failure */
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
@@ -632,27 +966,38 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 	if (rwb->wrmaxblocks > 0) {
 		fvdbg("Initialize the write buffer\n");
 
-		/* Initialize the write buffer access semaphore */
+		/* Initialize the write buffer access semaphores */
 
 		sem_init(&rwb->wrsem, 0, 1);
+		sem_init(&rwb->flsem, 0, 1);
 
-		/* Initialize write buffer parameters */
+		/* Split the write buffer into extents of equal size */
 
-		rwb_resetwrbuffer(rwb);
+		rwb->wrnextents = CONFIG_DRVR_WREXTENTS;
+		if (rwb->wrnextents > rwb->wrmaxblocks) {
+			rwb->wrnextents = rwb->wrmaxblocks;
+		}
+
+		rwb->extmaxblocks = rwb->wrmaxblocks / rwb->wrnextents;
 
 		/* Allocate the write buffer */
 
-		rwb->wrbuffer = NULL;
-		if (rwb->wrmaxblocks > 0) {
-			allocsize = rwb->wrmaxblocks * rwb->blocksize;
-			rwb->wrbuffer = kmm_malloc(allocsize);
-			if (!rwb->wrbuffer) {
-				fdbg("Write buffer kmm_malloc(%d) failed\n", allocsize);
-				return -ENOMEM;
-			}
+		allocsize = rwb->wrmaxblocks * rwb->blocksize;
+		rwb->wrbuffer = kmm_malloc(allocsize);
+		if (!rwb->wrbuffer) {
+			fdbg("Write buffer kmm_malloc(%d) failed\n", allocsize);
+			return -ENOMEM;
+		}
+
+		for (i = 0; i < rwb->wrnextents; i++) {
+			rwb->wrextent[i].buffer = rwb->wrbuffer + i * rwb->extmaxblocks * rwb->blocksize;
 		}
 
-		fvdbg("Write buffer size: %d bytes\n", allocsize);
+		/* Initialize write buffer parameters */
+
+		rwb_resetwrbuffer(rwb);
+
+		fvdbg("Write buffer size: %d bytes, %d extents\n", allocsize, rwb->wrnextents);
 	}
 #endif							/* CONFIG_DRVR_WRITEBUFFER */
 
@@ -664,26 +1009,42 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
 		sem_init(&rwb->rhsem, 0, 1);
 
-		/* Initialize read-ahead buffer parameters */
+		/* Split the read-ahead buffer into streams of equal size */
 
-		rwb_resetrhbuffer(rwb);
+		rwb->rhnstreams = CONFIG_DRVR_READAHEAD_STREAMS;
+		if (rwb->rhnstreams > rwb->rhmaxblocks) {
+			rwb->rhnstreams = rwb->rhmaxblocks;
+		}
+
+		rwb->rhstreamblocks = rwb->rhmaxblocks / rwb->rhnstreams;
+		rwb->rhstamp = 0;
 
 		/* Allocate the read-ahead buffer */
 
-		rwb->rhbuffer = NULL;
-		if (rwb->rhmaxblocks > 0) {
-			allocsize = rwb->rhmaxblocks * rwb->blocksize;
-			rwb->rhbuffer = kmm_malloc(allocsize);
-			if (!rwb->rhbuffer) {
-				fdbg("Read-ahead buffer kmm_malloc(%d) failed\n", allocsize);
-				return -ENOMEM;
-			}
+		allocsize = rwb->rhmaxblocks * rwb->blocksize;
+		rwb->rhbuffer = kmm_malloc(allocsize);
+		if (!rwb->rhbuffer) {
+			fdbg("Read-ahead buffer kmm_malloc(%d) failed\n", allocsize);
+			return -ENOMEM;
+		}
+
+		for (i = 0; i < rwb->rhnstreams; i++) {
+			rwb->rhstream[i].buffer = rwb->rhbuffer + i * rwb->rhstreamblocks * rwb->blocksize;
+			rwb->rhstream[i].lru = 0;
 		}
 
-		fvdbg("Read-ahead buffer size: %d bytes\n", allocsize);
+		/* Initialize read-ahead buffer parameters */
+
+		rwb_resetrhbuffer(rwb);
+
+		fvdbg("Read-ahead buffer size: %d bytes, %d streams\n", allocsize, rwb->rhnstreams);
 	}
 #endif							/* CONFIG_DRVR_READAHEAD */
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_RWBUFFER)
+	rwb_procfs_register(rwb);
+#endif
+
 	return OK;
 }
 
@@ -693,10 +1054,15 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
 void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
 {
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_RWBUFFER)
+	rwb_procfs_unregister(rwb);
+#endif
+
 #ifdef CONFIG_DRVR_WRITEBUFFER
 	if (rwb->wrmaxblocks > 0) {
 		rwb_wrcanceltimeout(rwb);
 		sem_destroy(&rwb->wrsem);
+		sem_destroy(&rwb->flsem);
 		if (rwb->wrbuffer) {
 			kmm_free(rwb->wrbuffer);
 		}
@@ -720,7 +1086,9 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
 int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR uint8_t *rdbuffer)
 {
 #ifdef CONFIG_DRVR_READAHEAD
+	FAR struct rwb_rhstream_s *stream;
 	uint32_t remaining;
+	size_t rdblocks;
 #endif
 	int ret = OK;
 
@@ -738,12 +1106,9 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 		 * write buffer.
 		 */
 
-		rwb_semtake(&rwb->wrsem);
-		if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock, nblocks)) {
-			rwb_wrflush(rwb);
+		if (rwb_wroverlap(rwb, startblock, nblocks)) {
+			(void)rwb_wrflush(rwb, true);
 		}
-
-		rwb_semgive(&rwb->wrsem);
 	}
 #endif
 
@@ -753,39 +1118,36 @@ int rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, uint32_t nblocks, FAR
 
 		rwb_semtake(&rwb->rhsem);
 		for (remaining = nblocks; remaining > 0;) {
-			/* Is there anything in the read-ahead buffer? */
-
-			if (rwb->rhnblocks > 0) {
-				off_t bufferend;
-
-				/* How many blocks are available in this buffer? */
-
-				bufferend = rwb->rhblockstart + rwb->rhnblocks;
-				if (startblock >= rwb->rhblockstart && startblock < bufferend) {
-					size_t rdblocks = bufferend - startblock;
-					if (rdblocks > remaining) {
-						rdblocks = remaining;
-					}
-
-					/* Then read the data from the read-ahead buffer */
-
-					rwb_bufferread(rwb, startblock, rdblocks, &rdbuffer);
-					startblock += rdblocks;
-					remaining -= rdblocks;
-				}
-			}
-
-			/* If we did not get all of the data from the buffer, then we have
-			 * to refill the buffer and try again.
+			/* Is the next block in one of the read-ahead streams?  If not,
+			 * we have to refill a stream and try again.
 			 */
 
-			if (remaining > 0) {
-				ret = rwb_rhreload(rwb, startblock);
+			stream = rwb_rhfind(rwb, startblock);
+			if (stream == NULL) {
+				stream = rwb_rhvictim(rwb, startblock);
+				ret = rwb_rhreload(rwb, stream, startblock);
 				if (ret < 0) {
 					fdbg("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
+					rwb_semgive(&rwb->rhsem);
 					return ret;
 				}
+			} else {
+				rwb->stats.rhhits++;
 			}
+
+			/* How many blocks are available in this stream? */
+
+			rdblocks = stream->blockstart + stream->nblocks - startblock;
+			if (rdblocks > remaining) {
+				rdblocks = remaining;
+			}
+
+			/* Then read the data from the read-ahead stream */
+
+			rwb_bufferread(rwb, stream, startblock, rdblocks, &rdbuffer);
+			stream->lru = rwb->rhstamp++;
+			startblock += rdblocks;
+			remaining -= rdblocks;
 		}
 
 		/* On success, return the number of blocks that we were requested to
@@ -818,6 +1180,9 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 
 #ifdef CONFIG_DRVR_READAHEAD
 	if (rwb->rhmaxblocks > 0) {
+		FAR struct rwb_rhstream_s *stream;
+		int i;
+
 		/* If the new write data overlaps any part of the read buffer, then
 		 * flush the data from the read buffer.  We could attempt some more
 		 * exotic handling -- but this simple logic is well-suited for simple
@@ -825,8 +1190,11 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 		 */
 
 		rwb_semtake(&rwb->rhsem);
-		if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, startblock, nblocks)) {
-			rwb_resetrhbuffer(rwb);
+		for (i = 0; i < rwb->rhnstreams; i++) {
+			stream = &rwb->rhstream[i];
+			if (stream->nblocks > 0 && rwb_overlap(stream->blockstart, stream->nblocks, startblock, nblocks)) {
+				rwb_resetrhstream(stream);
+			}
 		}
 
 		rwb_semgive(&rwb->rhsem);
@@ -837,14 +1205,13 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 	if (rwb->wrmaxblocks > 0) {
 		fvdbg("startblock=%d wrbuffer=%p\n", startblock, wrbuffer);
 
-		/* Use the block cache unless the buffer size is bigger than block cache */
+		/* Use the block cache unless the buffer size is bigger than an extent */
 
-		if (nblocks > rwb->wrmaxblocks) {
+		if (nblocks > rwb->extmaxblocks) {
 			/* First flush the cache */
 
-			rwb_semtake(&rwb->wrsem);
-			rwb_wrflush(rwb);
-			rwb_semgive(&rwb->wrsem);
+			rwb_wrcanceltimeout(rwb);
+			(void)rwb_wrflush(rwb, true);
 
 			/* Then transfer the data directly to the media */
 
@@ -872,6 +1239,45 @@ int rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t nblocks, FAR
 	return ret;
 }
 
+/****************************************************************************
+ * Name: rwb_flush
+ *
+ * Description:
+ *   Write barrier: write all buffered data to the media and return only
+ *   after every write-back, including one already running on the worker
+ *   thread, has completed.
+ *
+ ****************************************************************************/
+
+int rwb_flush(FAR struct rwbuffer_s *rwb)
+{
+#ifdef CONFIG_DRVR_WRITEBUFFER
+	if (rwb->wrmaxblocks > 0) {
+		rwb_wrcanceltimeout(rwb);
+		return rwb_wrflush(rwb, true);
+	}
+#endif
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: rwb_getstats
+ *
+ * Description:
+ *   Return the buffering statistics, as listed in /proc/rwbuffer.
+ *   Comparing flushticks/flushblocks and syncflushes for different
+ *   CONFIG_DRVR_WREXTENTS settings shows the write-back throughput and how
+ *   often writers had to wait for the media.
+ *
+ ****************************************************************************/
+
+void rwb_getstats(FAR struct rwbuffer_s *rwb, FAR struct rwb_stats_s *stats)
+{
+	DEBUGASSERT(rwb != NULL && stats != NULL);
+	memcpy(stats, &rwb->stats, sizeof(struct rwb_stats_s));
+}
+
 /****************************************************************************
  * Name: rwb_readbytes
  *
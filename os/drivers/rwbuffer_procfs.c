@@ -0,0 +1,355 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/rwbuffer_procfs.c
+ *
+ * Exposes the buffering statistics of every read-ahead/write buffer as
+ * /proc/rwbuffer, so that CONFIG_DRVR_WREXTENTS and
+ * CONFIG_DRVR_READAHEAD_STREAMS settings can be compared on the target.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/clock.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+#include <tinyara/rwbuffer.h>
+
+#if (defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)) && \
+	defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_RWBUFFER)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* This structure describes one open "file" */
+
+struct rwb_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	bool header;				/* true: The header line has been output */
+	int nextdevno;				/* Device number of the next line to output */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int rwb_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int rwb_procfs_close(FAR struct file *filep);
+static ssize_t rwb_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int rwb_procfs_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int rwb_procfs_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+const struct procfs_operations rwbuffer_procfsoperations = {
+	rwb_procfs_open,			/* open */
+	rwb_procfs_close,			/* close */
+	rwb_procfs_read,			/* read */
+	NULL,						/* write */
+
+	rwb_procfs_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	rwb_procfs_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+/* Buffer registration variables */
+
+static FAR struct rwbuffer_s *g_pfirstrwb = NULL;
+static int g_nextrwbno = 0;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rwb_procfs_open
+ ****************************************************************************/
+
+static int rwb_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct rwb_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* Allocate a context structure */
+
+	attr = (FAR struct rwb_file_s *)kmm_zalloc(sizeof(struct rwb_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the context as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: rwb_procfs_close
+ ****************************************************************************/
+
+static int rwb_procfs_close(FAR struct file *filep)
+{
+	FAR struct rwb_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct rwb_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: rwb_procfs_read
+ ****************************************************************************/
+
+static ssize_t rwb_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct rwb_file_s *priv;
+	FAR struct rwbuffer_s *rwb;
+	struct rwb_stats_s stats;
+	uint32_t avgms;
+	int nextents = 0;
+	int nstreams = 0;
+	ssize_t total = 0;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	priv = (FAR struct rwb_file_s *)filep->f_priv;
+	DEBUGASSERT(priv);
+
+	/* Output a header before the first entry */
+
+	if (!priv->header) {
+		ret = snprintf(buffer, buflen, "Num  BlkSz Ext Str WrBlocks   Flushes    Sync       FlBlocks   AvgMs  MaxMs  RhHits     RhLoads\n");
+		if ((size_t)ret >= buflen) {
+			return 0;
+		}
+
+		total = ret;
+		priv->header = true;
+	}
+
+	/* Buffers are looked up by number on each read so that a buffer
+	 * released between two reads is simply skipped.
+	 */
+
+	sched_lock();
+	for (rwb = g_pfirstrwb; rwb; rwb = rwb->flink) {
+		if (rwb->devno < priv->nextdevno) {
+			continue;
+		}
+
+		rwb_getstats(rwb, &stats);
+		avgms = stats.flushes > 0 ? TICK2MSEC(stats.flushticks) / stats.flushes : 0;
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+		nextents = rwb->wrmaxblocks > 0 ? rwb->wrnextents : 0;
+#endif
+#ifdef CONFIG_DRVR_READAHEAD
+		nstreams = rwb->rhmaxblocks > 0 ? rwb->rhnstreams : 0;
+#endif
+
+		ret = snprintf(&buffer[total], buflen - total, "%-5d%-6u%-4d%-4d%-11u%-11u%-11u%-11u%-7u%-7u%-11u%u\n",
+					   rwb->devno, rwb->blocksize, nextents, nstreams,
+					   stats.wrblocks, stats.flushes, stats.syncflushes, stats.flushblocks,
+					   avgms, (uint32_t)TICK2MSEC(stats.maxflushticks),
+					   stats.rhhits, stats.rhreloads);
+
+		if ((size_t)(ret + total) < buflen) {
+			total += ret;
+			priv->nextdevno = rwb->devno + 1;
+		} else {
+			buffer[total] = '\0';
+			break;
+		}
+	}
+	sched_unlock();
+
+	/* Update the file offset */
+
+	if (total > 0) {
+		filep->f_pos += total;
+	}
+
+	return total;
+}
+
+/****************************************************************************
+ * Name: rwb_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int rwb_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct rwb_file_s *oldattr;
+	FAR struct rwb_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct rwb_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct rwb_file_s *)kmm_zalloc(sizeof(struct rwb_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct rwb_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: rwb_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int rwb_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+	/* File/directory size, access block size */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rwb_procfs_register
+ *
+ * Description:
+ *   Add a buffer to the list reported by /proc/rwbuffer.
+ *
+ ****************************************************************************/
+
+void rwb_procfs_register(FAR struct rwbuffer_s *rwb)
+{
+	FAR struct rwbuffer_s *plast;
+
+	sched_lock();
+	rwb->devno = g_nextrwbno++;
+	rwb->flink = NULL;
+
+	/* Insert at end of list so that buffers are listed in order */
+
+	if (g_pfirstrwb == NULL) {
+		g_pfirstrwb = rwb;
+	} else {
+		plast = g_pfirstrwb;
+		while (plast->flink) {
+			plast = plast->flink;
+		}
+
+		plast->flink = rwb;
+	}
+	sched_unlock();
+}
+
+/****************************************************************************
+ * Name: rwb_procfs_unregister
+ *
+ * Description:
+ *   Remove a buffer from the list reported by /proc/rwbuffer.
+ *
+ ****************************************************************************/
+
+void rwb_procfs_unregister(FAR struct rwbuffer_s *rwb)
+{
+	FAR struct rwbuffer_s **pprev;
+
+	sched_lock();
+	for (pprev = &g_pfirstrwb; *pprev; pprev = &(*pprev)->flink) {
+		if (*pprev == rwb) {
+			*pprev = rwb->flink;
+			break;
+		}
+	}
+	sched_unlock();
+}
+
+#endif							/* CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_RWBUFFER */
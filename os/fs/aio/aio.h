@@ -90,6 +90,40 @@
 #error AIO needs file and/or socket descriptors
 #endif
 
+#ifdef CONFIG_FS_AIO_POOL
+#ifndef CONFIG_FS_AIO_NWORKERS
+#define CONFIG_FS_AIO_NWORKERS 2
+#endif
+
+#ifndef CONFIG_FS_AIO_PRIORITY
+#define CONFIG_FS_AIO_PRIORITY 100
+#endif
+
+#ifndef CONFIG_FS_AIO_STACKSIZE
+#define CONFIG_FS_AIO_STACKSIZE 2048
+#endif
+
+#ifndef CONFIG_FS_AIO_MERGE_BUFSIZE
+#define CONFIG_FS_AIO_MERGE_BUFSIZE 1024
+#endif
+#endif
+
+/* The workers restore the priority of the low priority work queue after
+ * each transfer.  The AIO worker pool manages its own priorities.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_FS_AIO_POOL)
+#define aio_restorepriority(prio) lpwork_restorepriority(prio)
+#else
+#define aio_restorepriority(prio) ((void)(prio))
+#endif
+
+/* States of a container on the pending list */
+
+#define AIOC_STATE_NEW     0	/* Contained, not yet queued */
+#define AIOC_STATE_QUEUED  1	/* Waiting for a worker */
+#define AIOC_STATE_ACTIVE  2	/* Taken by a worker */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -109,6 +143,11 @@ struct aio_container_s {
 		FAR void *ptr;			/* Generic pointer to FAR data */
 	} u;
 	struct work_s aioc_work;	/* Used to defer I/O to the work thread */
+#ifdef CONFIG_FS_AIO_POOL
+	worker_t aioc_worker;		/* Performs the I/O of this container alone */
+	uint8_t aioc_state;			/* See AIOC_STATE_* */
+#endif
+	uint8_t aioc_op;			/* LIO_READ or LIO_WRITE if it can be merged */
 	pid_t aioc_pid;				/* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t aioc_prio;			/* Priority of the waiting task */
@@ -283,5 +322,47 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
 int aio_signal(pid_t pid, FAR struct aiocb *aiocbp);
 
+#ifdef CONFIG_FS_AIO_POOL
+/****************************************************************************
+ * Name: aio_pool_queue
+ *
+ * Description:
+ *   Queue the asynchronous I/O for the AIO worker pool, starting the
+ *   workers on first use.  Containers of one file are started in the order
+ *   that they were queued, one at a time; adjacent reads or writes of the
+ *   same file may be performed with a single transfer.
+ *
+ * Input Parameters:
+ *   aioc   - The AIO container, on the pending list
+ *   worker - Performs the I/O if the container is not merged
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int aio_pool_queue(FAR struct aio_container_s *aioc, worker_t worker);
+
+/****************************************************************************
+ * Name: aio_pool_cancel
+ *
+ * Description:
+ *   Remove a container from the AIO worker pool if no worker has taken it.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was cancelled; the caller must decant the
+ *   container.  -EBUSY if the I/O has been started.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+int aio_pool_cancel(FAR struct aio_container_s *aioc);
+#endif
+
 #endif							/* CONFIG_FS_AIO */
 #endif							/* __FS_AIO_AIO_H */
@@ -170,7 +170,11 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 				 * first case.
 				 */
 
+#ifdef CONFIG_FS_AIO_POOL
+				status = aio_pool_cancel(aioc);
+#else
 				status = work_cancel(LPWORK, &aioc->aioc_work);
+#endif
 				if (status >= 0) {
 					aiocbp->aio_result = -ECANCELED;
 					ret = AIO_CANCELED;
@@ -178,9 +182,16 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 					ret = AIO_NOTCANCELED;
 				}
 
-				/* Remove the container from the list of pending transfers */
+				/* Remove the container from the list of pending transfers.
+				 * A worker of the pool owns the containers that it took.
+				 */
 
-				(void)aioc_decant(aioc);
+#ifdef CONFIG_FS_AIO_POOL
+				if (status >= 0)
+#endif
+				{
+					(void)aioc_decant(aioc);
+				}
 			}
 		}
 	} else {
@@ -205,12 +216,23 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 				 * first case.
 				 */
 
+#ifdef CONFIG_FS_AIO_POOL
+				status = aio_pool_cancel(aioc);
+#else
 				status = work_cancel(LPWORK, &aioc->aioc_work);
+#endif
 
 				/* Remove the container from the list of pending transfers */
 
 				next = (FAR struct aio_container_s *)aioc->aioc_link.flink;
-				aiocbp = aioc_decant(aioc);
+#ifdef CONFIG_FS_AIO_POOL
+				if (status < 0) {
+					aiocbp = aioc->aioc_aiocbp;
+				} else
+#endif
+				{
+					aiocbp = aioc_decant(aioc);
+				}
 				DEBUGASSERT(aiocbp);
 
 				if (status >= 0) {
@@ -109,6 +109,7 @@ static void aio_fsync_worker(FAR void *arg)
 {
 	FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
 	FAR struct aiocb *aiocbp;
+	FAR struct file *filep;
 	pid_t pid;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t prio;
@@ -125,11 +126,12 @@ static void aio_fsync_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	prio = aioc->aioc_prio;
 #endif
+	filep = aioc->u.aioc_filep;
 	aiocbp = aioc_decant(aioc);
 
 	/* Perform the fsync using u.aioc_filep */
 
-	ret = file_fsync(aioc->u.aioc_filep);
+	ret = file_fsync(filep);
 	if (ret < 0) {
 		int errcode = get_errno();
 		fdbg("ERROR: fsync failed: %d\n", errcode);
@@ -146,7 +148,7 @@ static void aio_fsync_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	/* Restore the low priority worker thread default priority */
 
-	lpwork_restorepriority(prio);
+	aio_restorepriority(prio);
 #endif
 }
 
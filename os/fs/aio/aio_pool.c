@@ -0,0 +1,504 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/aio/aio_pool.c
+ *
+ * A pool of kernel threads that performs asynchronous I/O instead of the
+ * low priority work queue.  Each worker serves one file at a time, so the
+ * requests of a file are performed in the order that they were queued
+ * while other files proceed in parallel.  A worker that takes a read or a
+ * write also takes the following requests of the same file that continue
+ * it, and performs all of them with one transfer.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/kthread.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_AIO_POOL)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A transfer never merges more containers than there are */
+
+#define AIO_MERGE_MAX CONFIG_FS_NAIOC
+
+#ifndef MIN
+#define MIN(a, b) ((a < b) ? a : b)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The containers taken by a worker for one transfer */
+
+struct aio_batch_s {
+	FAR struct file *filep;		/* The file of all containers */
+	off_t offset;				/* File offset of the transfer */
+	size_t nbytes;				/* Length of the transfer */
+	bool contiguous;			/* The buffers follow each other in memory */
+	int ncontainers;
+	FAR struct aio_container_s *aioc[AIO_MERGE_MAX];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Counts the containers queued since a worker last looked */
+
+static sem_t g_aio_pool_sem;
+
+/* The file that each worker is serving, NULL if it is idle */
+
+static FAR struct file *g_aio_busy[CONFIG_FS_AIO_NWORKERS];
+
+static bool g_aio_pool_started;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_pool_isbusy
+ *
+ * Description:
+ *   Check if a worker is serving the file.
+ *
+ ****************************************************************************/
+
+static bool aio_pool_isbusy(FAR struct file *filep)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++) {
+		if (g_aio_busy[i] == filep) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/****************************************************************************
+ * Name: aio_pool_canmerge
+ *
+ * Description:
+ *   Check if 'aioc' continues the transfer of 'batch'.  Reads and writes
+ *   are merged if their buffers are contiguous, or if all of them fit in
+ *   the merge buffer of the worker.  Appending writes never are, as they
+ *   ignore the offset.
+ *
+ ****************************************************************************/
+
+static bool aio_pool_canmerge(FAR struct aio_batch_s *batch, FAR struct aio_container_s *aioc, size_t bufsize)
+{
+	FAR struct aio_container_s *first = batch->aioc[0];
+	FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+	FAR struct aiocb *prev = batch->aioc[batch->ncontainers - 1]->aioc_aiocbp;
+
+	if (batch->ncontainers >= AIO_MERGE_MAX || aioc->aioc_op != first->aioc_op) {
+		return false;
+	}
+
+	if (aiocbp->aio_offset != batch->offset + (off_t)batch->nbytes) {
+		return false;
+	}
+
+	if (batch->contiguous && (FAR uint8_t *)aiocbp->aio_buf == (FAR uint8_t *)prev->aio_buf + prev->aio_nbytes) {
+		return true;
+	}
+
+	return batch->nbytes + aiocbp->aio_nbytes <= bufsize;
+}
+
+/****************************************************************************
+ * Name: aio_pool_take
+ *
+ * Description:
+ *   Take the oldest queued container whose file no other worker is
+ *   serving, and the queued containers of the same file that continue its
+ *   transfer.  The first container of the file that does not continue it
+ *   ends the batch, so that the order of the requests is kept.
+ *
+ * Returned Value:
+ *   The number of containers taken, zero if there is nothing to do.
+ *
+ ****************************************************************************/
+
+static int aio_pool_take(int id, FAR struct aio_batch_s *batch, size_t bufsize)
+{
+	FAR struct aio_container_s *aioc;
+	FAR struct aiocb *aiocbp;
+
+	batch->ncontainers = 0;
+
+	aio_lock();
+
+	for (aioc = (FAR struct aio_container_s *)g_aio_pending.head; aioc; aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink) {
+		if (batch->ncontainers == 0) {
+			if (aioc->aioc_state != AIOC_STATE_QUEUED || aio_pool_isbusy(aioc->u.aioc_filep)) {
+				continue;
+			}
+
+			aiocbp = aioc->aioc_aiocbp;
+			batch->filep = aioc->u.aioc_filep;
+			batch->offset = aiocbp->aio_offset;
+			batch->nbytes = aiocbp->aio_nbytes;
+			batch->contiguous = true;
+			batch->aioc[batch->ncontainers++] = aioc;
+			aioc->aioc_state = AIOC_STATE_ACTIVE;
+			g_aio_busy[id] = batch->filep;
+
+			if (aioc->aioc_op != LIO_READ && aioc->aioc_op != LIO_WRITE) {
+				break;
+			}
+
+			if (aioc->aioc_op == LIO_WRITE && (batch->filep->f_oflags & O_APPEND) != 0) {
+				break;
+			}
+		} else if (aioc->u.aioc_filep == batch->filep && aioc->aioc_state == AIOC_STATE_QUEUED) {
+			if (!aio_pool_canmerge(batch, aioc, bufsize)) {
+				break;
+			}
+
+			aiocbp = aioc->aioc_aiocbp;
+			if (batch->contiguous) {
+				FAR struct aiocb *prev = batch->aioc[batch->ncontainers - 1]->aioc_aiocbp;
+				batch->contiguous = ((FAR uint8_t *)aiocbp->aio_buf == (FAR uint8_t *)prev->aio_buf + prev->aio_nbytes);
+			}
+
+			batch->nbytes += aiocbp->aio_nbytes;
+			batch->aioc[batch->ncontainers++] = aioc;
+			aioc->aioc_state = AIOC_STATE_ACTIVE;
+		}
+	}
+
+	aio_unlock();
+	return batch->ncontainers;
+}
+
+/****************************************************************************
+ * Name: aio_pool_release
+ *
+ * Description:
+ *   Mark the file of the worker as no longer served.  The worker itself
+ *   looks for the requests of the file that it could not take.
+ *
+ ****************************************************************************/
+
+static void aio_pool_release(int id)
+{
+	aio_lock();
+	g_aio_busy[id] = NULL;
+	aio_unlock();
+}
+
+/****************************************************************************
+ * Name: aio_pool_transfer
+ *
+ * Description:
+ *   Perform the merged transfer of a batch and complete each container
+ *   with its share of the result.
+ *
+ ****************************************************************************/
+
+static void aio_pool_transfer(FAR struct aio_batch_s *batch, FAR uint8_t *buffer)
+{
+	FAR struct aio_container_s *aioc;
+	FAR struct aiocb *aiocbp;
+	FAR uint8_t *data;
+	ssize_t nxfrd;
+	ssize_t result;
+	size_t pos;
+	pid_t pid;
+	int i;
+
+	if (batch->contiguous) {
+		data = (FAR uint8_t *)batch->aioc[0]->aioc_aiocbp->aio_buf;
+	} else {
+		data = buffer;
+	}
+
+	if (batch->aioc[0]->aioc_op == LIO_READ) {
+		nxfrd = file_pread(batch->filep, data, batch->nbytes, batch->offset);
+	} else {
+		if (!batch->contiguous) {
+			for (i = 0, pos = 0; i < batch->ncontainers; i++) {
+				aiocbp = batch->aioc[i]->aioc_aiocbp;
+				memcpy(data + pos, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes);
+				pos += aiocbp->aio_nbytes;
+			}
+		}
+
+		nxfrd = file_pwrite(batch->filep, data, batch->nbytes, batch->offset);
+	}
+
+	if (nxfrd < 0) {
+		fdbg("ERROR: merged transfer failed: %d\n", (int)nxfrd);
+	}
+
+	/* Each request gets the part of the transfer that covers it, as if it
+	 * had been performed alone right after the preceding ones.
+	 */
+
+	for (i = 0, pos = 0; i < batch->ncontainers; i++) {
+		aioc = batch->aioc[i];
+		pid = aioc->aioc_pid;
+		aiocbp = aioc_decant(aioc);
+
+		if (nxfrd < 0) {
+			result = nxfrd;
+		} else if ((size_t)nxfrd <= pos) {
+			result = 0;
+		} else {
+			result = (ssize_t)MIN((size_t)nxfrd - pos, aiocbp->aio_nbytes);
+			if (!batch->contiguous && batch->aioc[0]->aioc_op == LIO_READ) {
+				memcpy((FAR void *)aiocbp->aio_buf, data + pos, result);
+			}
+		}
+
+		pos += aiocbp->aio_nbytes;
+		aiocbp->aio_result = result;
+		(void)aio_signal(pid, aiocbp);
+	}
+}
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+/****************************************************************************
+ * Name: aio_pool_setprio
+ *
+ * Description:
+ *   Change the priority of the worker if it differs.
+ *
+ ****************************************************************************/
+
+static void aio_pool_setprio(int prio)
+{
+	struct sched_param param;
+
+	if (sched_getparam(0, &param) == OK && param.sched_priority != prio) {
+		param.sched_priority = prio;
+		(void)sched_setparam(0, &param);
+	}
+}
+
+/****************************************************************************
+ * Name: aio_pool_boost
+ *
+ * Description:
+ *   Run the worker at least at the priority of the tasks that wait for
+ *   the batch.
+ *
+ ****************************************************************************/
+
+static void aio_pool_boost(FAR struct aio_batch_s *batch)
+{
+	int prio = CONFIG_FS_AIO_PRIORITY;
+	int i;
+
+	for (i = 0; i < batch->ncontainers; i++) {
+		if (batch->aioc[i]->aioc_prio > prio) {
+			prio = batch->aioc[i]->aioc_prio;
+		}
+	}
+
+	aio_pool_setprio(prio);
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_pool_worker
+ *
+ * Description:
+ *   The AIO worker thread.  argv[1] is the index of the worker.
+ *
+ ****************************************************************************/
+
+static int aio_pool_worker(int argc, FAR char *argv[])
+{
+	struct aio_batch_s batch;
+	FAR uint8_t *buffer;
+	size_t bufsize;
+	int id;
+
+	DEBUGASSERT(argc > 1);
+	id = atoi(argv[1]);
+
+	/* Without a merge buffer only requests with contiguous buffers merge */
+
+	buffer = (FAR uint8_t *)kmm_malloc(CONFIG_FS_AIO_MERGE_BUFSIZE);
+	bufsize = buffer != NULL ? CONFIG_FS_AIO_MERGE_BUFSIZE : 0;
+
+	for (;;) {
+		while (sem_wait(&g_aio_pool_sem) < 0) {
+			DEBUGASSERT(get_errno() == EINTR);
+		}
+
+		/* Keep going while there is work, other workers may have been
+		 * woken for containers of the file that this worker served.
+		 */
+
+		while (aio_pool_take(id, &batch, bufsize) > 0) {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+			aio_pool_boost(&batch);
+#endif
+			if (batch.ncontainers == 1) {
+				/* The worker decants the container before the I/O */
+
+				batch.aioc[0]->aioc_worker(batch.aioc[0]);
+			} else {
+				aio_pool_transfer(&batch, buffer);
+			}
+
+			aio_pool_release(id);
+		}
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+		aio_pool_setprio(CONFIG_FS_AIO_PRIORITY);
+#endif
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_pool_start
+ *
+ * Description:
+ *   Start the AIO workers.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static int aio_pool_start(void)
+{
+	FAR char *argv[2];
+	char arg[8];
+	int nstarted = 0;
+	int ret = OK;
+	int i;
+
+	(void)sem_init(&g_aio_pool_sem, 0, 0);
+	sem_setprotocol(&g_aio_pool_sem, SEM_PRIO_NONE);
+
+	for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++) {
+		snprintf(arg, sizeof(arg), "%d", i);
+		argv[0] = arg;
+		argv[1] = NULL;
+
+		ret = kernel_thread("aio", CONFIG_FS_AIO_PRIORITY, CONFIG_FS_AIO_STACKSIZE, aio_pool_worker, argv);
+		if (ret < 0) {
+			ret = -get_errno();
+			fdbg("ERROR: Failed to start AIO worker %d: %d\n", i, ret);
+			break;
+		}
+
+		nstarted++;
+	}
+
+	/* Fewer workers only mean less parallelism */
+
+	if (nstarted == 0) {
+		sem_destroy(&g_aio_pool_sem);
+		return ret;
+	}
+
+	g_aio_pool_started = true;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_pool_queue
+ *
+ * Description:
+ *   Queue the asynchronous I/O for the AIO worker pool, starting the
+ *   workers on first use.
+ *
+ ****************************************************************************/
+
+int aio_pool_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+	int ret = OK;
+
+	aio_lock();
+
+	if (!g_aio_pool_started) {
+		ret = aio_pool_start();
+	}
+
+	if (ret == OK) {
+		aioc->aioc_worker = worker;
+		aioc->aioc_state = AIOC_STATE_QUEUED;
+		sem_post(&g_aio_pool_sem);
+	}
+
+	aio_unlock();
+	return ret;
+}
+
+/****************************************************************************
+ * Name: aio_pool_cancel
+ *
+ * Description:
+ *   Remove a container from the AIO worker pool if no worker has taken it.
+ *
+ ****************************************************************************/
+
+int aio_pool_cancel(FAR struct aio_container_s *aioc)
+{
+	if (aioc->aioc_state == AIOC_STATE_ACTIVE) {
+		return -EBUSY;
+	}
+
+	aioc->aioc_state = AIOC_STATE_NEW;
+	return OK;
+}
+
+#endif							/* CONFIG_FS_AIO && CONFIG_FS_AIO_POOL */
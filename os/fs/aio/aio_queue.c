@@ -91,7 +91,8 @@
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue, or on the
+ *   AIO worker pool if CONFIG_FS_AIO_POOL is selected
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -107,6 +108,11 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
 	int ret;
 
+#ifdef CONFIG_FS_AIO_POOL
+	/* The workers of the pool manage their priority themselves */
+
+	ret = aio_pool_queue(aioc, worker);
+#else
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	/* Prohibit context switches until we complete the queuing */
 
@@ -122,6 +128,7 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 	/* Schedule the work on the low priority worker thread */
 
 	ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
+#endif
 	if (ret < 0) {
 		FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
 		DEBUGASSERT(aiocbp);
@@ -129,8 +136,12 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 		aiocbp->aio_result = ret;
 		set_errno(-ret);
 		ret = ERROR;
+
+		/* The container will never be run, return it to the free list */
+
+		(void)aioc_decant(aioc);
 	}
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#if defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_FS_AIO_POOL)
 	/* Now the low-priority work queue might run at its new priority */
 
 	sched_unlock();
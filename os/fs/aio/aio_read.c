@@ -109,6 +109,9 @@ static void aio_read_worker(FAR void *arg)
 {
 	FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
 	FAR struct aiocb *aiocbp;
+#ifdef AIO_HAVE_FILEP
+	FAR struct file *filep;
+#endif
 	pid_t pid;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t prio;
@@ -124,6 +127,9 @@ static void aio_read_worker(FAR void *arg)
 	pid = aioc->aioc_pid;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	prio = aioc->aioc_prio;
+#endif
+#ifdef AIO_HAVE_FILEP
+	filep = aioc->u.aioc_filep;
 #endif
 	aiocbp = aioc_decant(aioc);
 
@@ -131,27 +137,24 @@ static void aio_read_worker(FAR void *arg)
 	{
 		/* Perform the file read using:
 		 *
-		 *   u.aioc_filep - File structure pointer
+		 *   filep        - File structure pointer
 		 *   aio_buf      - Location of buffer
 		 *   aio_nbytes   - Length of transfer
 		 *   aio_offset   - File offset
 		 */
 
-		nread = file_pread(aioc->u.aioc_filep, (FAR void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
+		nread = file_pread(filep, (FAR void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
 	}
 #endif
 
 	/* Set the result of the read */
 
 	if (nread < 0) {
-		int errcode = get_errno();
-		fdbg("ERROR: pread failed: %d\n", errcode);
-		DEBUGASSERT(errcode > 0);
-		aiocbp->aio_result = -errcode;
-	} else {
-		aiocbp->aio_result = nread;
+		fdbg("ERROR: pread failed: %d\n", (int)nread);
 	}
 
+	aiocbp->aio_result = nread;
+
 	/* Signal the client */
 
 	(void)aio_signal(pid, aiocbp);
@@ -159,7 +162,7 @@ static void aio_read_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	/* Restore the low priority worker thread default priority */
 
-	lpwork_restorepriority(prio);
+	aio_restorepriority(prio);
 #endif
 }
 
@@ -289,6 +292,7 @@ int aio_read(FAR struct aiocb *aiocbp)
 
 	/* Defer the work to the worker thread */
 
+	aioc->aioc_op = LIO_READ;
 	ret = aio_queue(aioc, aio_read_worker);
 	if (ret < 0) {
 		/* The result and the errno have already been set */
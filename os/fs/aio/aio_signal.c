@@ -88,6 +88,38 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_ring_post
+ *
+ * Description:
+ *   Add a completed control block to the completion ring of the client.
+ *   The workers post with pre-emption disabled, so that the ring has one
+ *   writer at a time.
+ *
+ ****************************************************************************/
+
+static void aio_ring_post(FAR struct aio_ring_s *ring, FAR struct aiocb *aiocbp)
+{
+	uint16_t head;
+
+	sched_lock();
+
+	head = ring->ar_head;
+	if ((uint16_t)(head - ring->ar_tail) >= ring->ar_size) {
+		fdbg("ERROR: AIO completion ring is full\n");
+		ring->ar_overflow++;
+	} else {
+		ring->ar_entries[head & (ring->ar_size - 1)] = aiocbp;
+
+		/* The entry and the result must be seen before the new head */
+
+		__sync_synchronize();
+		ring->ar_head = head + 1;
+	}
+
+	sched_unlock();
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -126,7 +158,9 @@ int aio_signal(pid_t pid, FAR struct aiocb *aiocbp)
 
 	/* Signal the client */
 
-	if (aiocbp->aio_sigevent.sigev_notify == SIGEV_SIGNAL) {
+	if (aiocbp->aio_sigevent.sigev_notify == SIGEV_AIO_RING) {
+		aio_ring_post((FAR struct aio_ring_s *)aiocbp->aio_sigevent.sigev_value.sival_ptr, aiocbp);
+	} else if (aiocbp->aio_sigevent.sigev_notify == SIGEV_SIGNAL) {
 #ifdef CONFIG_CAN_PASS_STRUCTS
 		status = sigqueue(pid, aiocbp->aio_sigevent.sigev_signo, aiocbp->aio_sigevent.sigev_value);
 #else
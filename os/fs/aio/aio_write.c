@@ -132,6 +132,7 @@ static void aio_write_worker(FAR void *arg)
 #endif
 	ssize_t nwritten = 0;
 #ifdef AIO_HAVE_FILEP
+	FAR struct file *filep;
 	int oflags;
 #endif
 
@@ -144,6 +145,9 @@ static void aio_write_worker(FAR void *arg)
 	pid = aioc->aioc_pid;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	prio = aioc->aioc_prio;
+#endif
+#ifdef AIO_HAVE_FILEP
+	filep = aioc->u.aioc_filep;
 #endif
 	aiocbp = aioc_decant(aioc);
 
@@ -151,7 +155,7 @@ static void aio_write_worker(FAR void *arg)
 	{
 		/* Call fcntl(F_GETFL) to get the file open mode. */
 
-		oflags = file_fcntl(aioc->u.aioc_filep, F_GETFL);
+		oflags = file_fcntl(filep, F_GETFL);
 		if (oflags < 0) {
 			int errcode = get_errno();
 			fdbg("ERROR: fcntl failed: %d\n", errcode);
@@ -161,7 +165,7 @@ static void aio_write_worker(FAR void *arg)
 
 		/* Perform the write using:
 		 *
-		 *   u.aioc_filep - File structure pointer
+		 *   filep        - File structure pointer
 		 *   aio_buf      - Location of buffer
 		 *   aio_nbytes   - Length of transfer
 		 *   aio_offset   - File offset
@@ -172,9 +176,9 @@ static void aio_write_worker(FAR void *arg)
 		if ((oflags & O_APPEND) != 0) {
 			/* Append to the current file position */
 
-			nwritten = file_write(aioc->u.aioc_filep, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes);
+			nwritten = file_write(filep, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes);
 		} else {
-			nwritten = file_pwrite(aioc->u.aioc_filep, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
+			nwritten = file_pwrite(filep, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
 		}
 	}
 #endif
@@ -182,14 +186,11 @@ static void aio_write_worker(FAR void *arg)
 	/* Check the result of the write */
 
 	if (nwritten < 0) {
-		int errcode = get_errno();
-		fdbg("ERROR: write/pwrite failed: %d\n", errcode);
-		DEBUGASSERT(errcode > 0);
-		aiocbp->aio_result = -errcode;
-	} else {
-		aiocbp->aio_result = nwritten;
+		fdbg("ERROR: write/pwrite failed: %d\n", (int)nwritten);
 	}
 
+	aiocbp->aio_result = nwritten;
+
 #ifdef AIO_HAVE_FILEP
 errout:
 #endif
@@ -201,7 +202,7 @@ errout:
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	/* Restore the low priority worker thread default priority */
 
-	lpwork_restorepriority(prio);
+	aio_restorepriority(prio);
 #endif
 }
 
@@ -333,6 +334,7 @@ int aio_write(FAR struct aiocb *aiocbp)
 
 	/* Defer the work to the worker thread */
 
+	aioc->aioc_op = LIO_WRITE;
 	ret = aio_queue(aioc, aio_write_worker);
 	if (ret < 0) {
 		/* The result and the errno have already been set */
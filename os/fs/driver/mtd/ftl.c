@@ -447,6 +447,15 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	 * different form).
 	 */
 
+#ifdef FTL_HAVE_RWBUFFER
+	/* Write back anything held in the write buffer (write barrier) */
+
+	if (cmd == BIOC_FLUSH) {
+		dev = (struct ftl_struct_s *)inode->i_private;
+		return rwb_flush(&dev->rwb);
+	}
+#endif
+
 	if (cmd == BIOC_XIPBASE) {
 		/* The argument accompanying the BIOC_XIPBASE should be non-NULL.  If
 		 * DEBUG is enabled, we will catch it here instead of in the MTD
@@ -576,6 +585,9 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 		ret = register_blockdriver(devname, &g_bops, 0, dev);
 		if (ret < 0) {
 			dbg("ERROR: register_blockdriver failed: %d\n", -ret);
+#ifdef FTL_HAVE_RWBUFFER
+			rwb_uninitialize(&dev->rwb);
+#endif
 			kmm_free(dev);
 		}
 	}
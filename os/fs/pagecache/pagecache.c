@@ -0,0 +1,670 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/pagecache/pagecache.c
+ *
+ * The pages of all volumes are kept in one hash table, keyed by volume and
+ * page number, and in one LRU list.  Device reads are done without the
+ * cache semaphore held; the file system that asked for them serializes the
+ * accesses to its device.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/mm/mm.h>
+#include <tinyara/fs/fs.h>
+
+#include "pagecache.h"
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PAGECACHE_NBUCKETS	32		/* Must be a power of two */
+
+/* The page data follows the page header */
+
+#define PAGE_DATA(p)		((FAR uint8_t *)((p) + 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pagecache_page_s {
+	dq_entry_t lru;				/* LRU list link, must be first */
+	FAR struct pagecache_page_s *hnext;	/* Next page in the hash bucket */
+	FAR struct pagecache_s *pc;	/* The volume of the page */
+	size_t page;				/* The page number on the volume */
+	bool readahead;				/* true: Read ahead and not used yet */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void pagecache_release(FAR struct pagecache_page_s *p);
+static size_t pagecache_reclaim(size_t size);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+sem_t g_pagecache_sem = SEM_INITIALIZER(1);
+FAR struct pagecache_s *g_pagecache_volumes;
+size_t g_pagecache_used;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *g_pagecache_hash[PAGECACHE_NBUCKETS];
+
+/* Most recently used page first */
+
+static dq_queue_t g_pagecache_lru;
+
+static int g_pagecache_nextdevno;
+
+static struct mm_reclaim_s g_pagecache_mmreclaim = {
+	NULL, pagecache_reclaim
+};
+
+static bool g_pagecache_registered;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_bucket
+ ****************************************************************************/
+
+static inline FAR struct pagecache_page_s **pagecache_bucket(FAR struct pagecache_s *pc, size_t page)
+{
+	return &g_pagecache_hash[(((uintptr_t)pc >> 2) ^ page) & (PAGECACHE_NBUCKETS - 1)];
+}
+
+/****************************************************************************
+ * Name: pagecache_lookup
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *pagecache_lookup(FAR struct pagecache_s *pc, size_t page)
+{
+	FAR struct pagecache_page_s *p;
+
+	for (p = *pagecache_bucket(pc, page); p != NULL; p = p->hnext) {
+		if (p->pc == pc && p->page == page) {
+			return p;
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: pagecache_alloc
+ *
+ * Description:
+ *   Allocate a page for 'pc', dropping the least recently used pages first
+ *   as long as the cache would grow beyond its size.
+ *
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *pagecache_alloc(FAR struct pagecache_s *pc)
+{
+	FAR struct pagecache_page_s *p;
+
+	if (pc->pagesize > CONFIG_FS_PAGECACHE_SIZE) {
+		return NULL;
+	}
+
+	while (g_pagecache_used + pc->pagesize > CONFIG_FS_PAGECACHE_SIZE) {
+		p = (FAR struct pagecache_page_s *)dq_tail(&g_pagecache_lru);
+		DEBUGASSERT(p != NULL);
+		p->pc->stats.evictions++;
+		pagecache_release(p);
+	}
+
+	/* The heap cannot shrink the cache from here, the semaphore is held */
+
+	p = (FAR struct pagecache_page_s *)kmm_malloc(sizeof(struct pagecache_page_s) + pc->pagesize);
+	if (p != NULL) {
+		p->pc = pc;
+		g_pagecache_used += pc->pagesize;
+	}
+
+	return p;
+}
+
+/****************************************************************************
+ * Name: pagecache_insert
+ ****************************************************************************/
+
+static void pagecache_insert(FAR struct pagecache_page_s *p, size_t page, bool readahead)
+{
+	FAR struct pagecache_page_s **bucket = pagecache_bucket(p->pc, page);
+
+	p->page = page;
+	p->readahead = readahead;
+	p->hnext = *bucket;
+	*bucket = p;
+
+	dq_addfirst(&p->lru, &g_pagecache_lru);
+	p->pc->ncached++;
+}
+
+/****************************************************************************
+ * Name: pagecache_release
+ *
+ * Description:
+ *   Remove a cached page and free it.
+ *
+ ****************************************************************************/
+
+static void pagecache_release(FAR struct pagecache_page_s *p)
+{
+	FAR struct pagecache_page_s **pprev;
+
+	for (pprev = pagecache_bucket(p->pc, p->page); *pprev != p; pprev = &(*pprev)->hnext) {
+		DEBUGASSERT(*pprev != NULL);
+	}
+
+	*pprev = p->hnext;
+	dq_rem(&p->lru, &g_pagecache_lru);
+
+	p->pc->ncached--;
+	g_pagecache_used -= p->pc->pagesize;
+	kmm_free(p);
+}
+
+/****************************************************************************
+ * Name: pagecache_hit
+ ****************************************************************************/
+
+static void pagecache_hit(FAR struct pagecache_page_s *p)
+{
+	p->pc->stats.hits++;
+	if (p->readahead) {
+		p->pc->stats.rahits++;
+		p->readahead = false;
+	}
+
+	dq_rem(&p->lru, &g_pagecache_lru);
+	dq_addfirst(&p->lru, &g_pagecache_lru);
+}
+
+/****************************************************************************
+ * Name: pagecache_add
+ *
+ * Description:
+ *   Cache copies of 'npages' pages just read from the device.  The device
+ *   was read without the semaphore, so another thread may have cached some
+ *   of the pages meanwhile.  Their cached copies also hold any
+ *   pagecache_update() made since, so they are kept and copied to 'buffer'
+ *   instead.
+ *
+ ****************************************************************************/
+
+static void pagecache_add(FAR struct pagecache_s *pc, FAR uint8_t *buffer, size_t page, unsigned int npages, bool readahead)
+{
+	FAR struct pagecache_page_s *p;
+
+	for (; npages > 0; npages--, page++, buffer += pc->pagesize) {
+		p = pagecache_lookup(pc, page);
+		if (p != NULL) {
+			memcpy(buffer, PAGE_DATA(p), pc->pagesize);
+			continue;
+		}
+
+		p = pagecache_alloc(pc);
+		if (p == NULL) {
+			break;
+		}
+
+		pagecache_insert(p, page, readahead);
+		memcpy(PAGE_DATA(p), buffer, pc->pagesize);
+	}
+}
+
+/****************************************************************************
+ * Name: pagecache_devread
+ *
+ * Description:
+ *   Read 'npages' pages from the device.  Called without the semaphore.
+ *
+ ****************************************************************************/
+
+static int pagecache_devread(FAR struct pagecache_s *pc, FAR uint8_t *buffer, size_t page, unsigned int npages)
+{
+	FAR struct inode *inode = pc->blkdriver;
+	ssize_t ret;
+
+	if (pc->ops != NULL) {
+		ret = pc->ops->read(inode, buffer, page, npages, pc->pagesize);
+	} else if (inode->u.i_bops && inode->u.i_bops->read) {
+		ret = inode->u.i_bops->read(inode, buffer, page, npages);
+	} else {
+		ret = -ENODEV;
+	}
+
+	if (ret == (ssize_t)npages) {
+		return OK;
+	}
+
+	return ret < 0 ? (int)ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: pagecache_window
+ *
+ * Description:
+ *   Return how many pages to read ahead of a read of pages 'page' to
+ *   'page' + 'npages' - 1.  The window doubles while each read continues
+ *   the previous one and closes on any other read.
+ *
+ ****************************************************************************/
+
+static unsigned int pagecache_window(FAR struct pagecache_s *pc, size_t page, unsigned int npages)
+{
+	if (!pc->readahead) {
+		return 0;
+	}
+
+	if (page == pc->nextpage) {
+		if (pc->window == 0) {
+			pc->window = 1;
+		} else if (pc->window < CONFIG_FS_PAGECACHE_READAHEAD) {
+			pc->window <<= 1;
+			if (pc->window > CONFIG_FS_PAGECACHE_READAHEAD) {
+				pc->window = CONFIG_FS_PAGECACHE_READAHEAD;
+			}
+		}
+	} else {
+		pc->window = 0;
+	}
+
+	pc->nextpage = page + npages;
+	return pc->window;
+}
+
+/****************************************************************************
+ * Name: pagecache_reclaim
+ *
+ * Description:
+ *   Called by the heap when an allocation fails.
+ *
+ ****************************************************************************/
+
+static size_t pagecache_reclaim(size_t size)
+{
+	return pagecache_shrink(size);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_semtake
+ ****************************************************************************/
+
+void pagecache_semtake(void)
+{
+	/* Take the semaphore (perhaps waiting) */
+
+	while (sem_wait(&g_pagecache_sem) != 0) {
+		/* The only case that an error should occur here is if
+		 * the wait was awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+/****************************************************************************
+ * Name: pagecache_attach
+ ****************************************************************************/
+
+FAR struct pagecache_s *pagecache_attach(FAR struct inode *blkdriver, FAR const char *fstype, uint16_t pagesize, size_t npages, bool readahead, FAR const struct pagecache_ops_s *ops)
+{
+	FAR struct pagecache_s *pc;
+	FAR struct pagecache_s **pprev;
+
+	DEBUGASSERT(blkdriver != NULL && pagesize > 0);
+
+	pagecache_semtake();
+
+	for (pprev = &g_pagecache_volumes; *pprev != NULL; pprev = &(*pprev)->flink) {
+		pc = *pprev;
+		if (pc->blkdriver == blkdriver) {
+			if (pc->pagesize != pagesize || pc->refs == UINT8_MAX) {
+				fdbg("Cannot share the cache of %s\n", blkdriver->i_name);
+				pc = NULL;
+			} else {
+				pc->refs++;
+			}
+
+			pagecache_semgive();
+			return pc;
+		}
+	}
+
+	pc = (FAR struct pagecache_s *)kmm_zalloc(sizeof(struct pagecache_s));
+	if (pc == NULL) {
+		pagecache_semgive();
+		return NULL;
+	}
+
+	pc->blkdriver = blkdriver;
+	pc->fstype = fstype;
+	pc->ops = ops;
+	pc->npages = npages;
+	pc->nextpage = (size_t)-1;
+	pc->pagesize = pagesize;
+	pc->refs = 1;
+	pc->devno = g_pagecache_nextdevno++;
+	pc->readahead = readahead && CONFIG_FS_PAGECACHE_READAHEAD > 0;
+
+	/* Add at the end so that procfs lists the volumes in order */
+
+	*pprev = pc;
+
+	if (!g_pagecache_registered) {
+		mm_register_reclaim(&g_pagecache_mmreclaim);
+		g_pagecache_registered = true;
+	}
+
+	pagecache_semgive();
+
+	fvdbg("%s on %s: %u pages of %u bytes\n", fstype, blkdriver->i_name, npages, pagesize);
+	return pc;
+}
+
+/****************************************************************************
+ * Name: pagecache_detach
+ ****************************************************************************/
+
+void pagecache_detach(FAR struct pagecache_s *pc)
+{
+	FAR struct pagecache_page_s *p;
+	FAR struct pagecache_page_s *next;
+	FAR struct pagecache_s **pprev;
+
+	pagecache_semtake();
+
+	if (--pc->refs > 0) {
+		pagecache_semgive();
+		return;
+	}
+
+	for (p = (FAR struct pagecache_page_s *)dq_peek(&g_pagecache_lru); p != NULL && pc->ncached > 0; p = next) {
+		next = (FAR struct pagecache_page_s *)dq_next(&p->lru);
+		if (p->pc == pc) {
+			pagecache_release(p);
+		}
+	}
+
+	for (pprev = &g_pagecache_volumes; *pprev != NULL; pprev = &(*pprev)->flink) {
+		if (*pprev == pc) {
+			*pprev = pc->flink;
+			break;
+		}
+	}
+
+	pagecache_semgive();
+	kmm_free(pc);
+}
+
+/****************************************************************************
+ * Name: pagecache_read
+ ****************************************************************************/
+
+int pagecache_read(FAR struct pagecache_s *pc, FAR uint8_t *buffer, size_t page, unsigned int npages)
+{
+	FAR struct pagecache_page_s *p;
+	FAR uint8_t *rabuf;
+	unsigned int window;
+	unsigned int nra;
+	unsigned int n;
+	int ret = OK;
+
+	pagecache_semtake();
+
+	window = pagecache_window(pc, page, npages);
+
+	while (npages > 0) {
+		p = pagecache_lookup(pc, page);
+		if (p != NULL) {
+			pagecache_hit(p);
+			memcpy(buffer, PAGE_DATA(p), pc->pagesize);
+
+			buffer += pc->pagesize;
+			page++;
+			npages--;
+			continue;
+		}
+
+		/* Read all the missing pages from here on with one request */
+
+		for (n = 1; n < npages && pagecache_lookup(pc, page + n) == NULL; n++) ;
+		pc->stats.misses += n;
+
+		/* If they are the last ones asked for, read ahead of them as well */
+
+		nra = 0;
+		if (n == npages) {
+			while (nra < window && page + n + nra < pc->npages && pagecache_lookup(pc, page + n + nra) == NULL) {
+				nra++;
+			}
+		}
+
+		pagecache_semgive();
+
+		ret = pagecache_devread(pc, buffer, page, n);
+
+		/* Read-ahead is best effort, it is skipped if memory is short */
+
+		rabuf = NULL;
+		if (ret == OK && nra > 0) {
+			rabuf = (FAR uint8_t *)kmm_malloc(nra * pc->pagesize);
+			if (rabuf != NULL && pagecache_devread(pc, rabuf, page + n, nra) != OK) {
+				kmm_free(rabuf);
+				rabuf = NULL;
+			}
+		}
+
+		pagecache_semtake();
+
+		if (ret != OK) {
+			fdbg("Read of %u pages at %u failed: %d\n", n, page, ret);
+			break;
+		}
+
+		pagecache_add(pc, buffer, page, n, false);
+
+		if (rabuf != NULL) {
+			pagecache_add(pc, rabuf, page + n, nra, true);
+			pc->stats.rapages += nra;
+			kmm_free(rabuf);
+		}
+
+		buffer += n * pc->pagesize;
+		page += n;
+		npages -= n;
+	}
+
+	pagecache_semgive();
+	return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_readpart
+ ****************************************************************************/
+
+ssize_t pagecache_readpart(FAR struct pagecache_s *pc, FAR uint8_t *buffer, size_t page, size_t offset, size_t count)
+{
+	FAR struct pagecache_page_s *p;
+	FAR struct pagecache_page_s *q;
+	int ret;
+
+	DEBUGASSERT(offset + count <= pc->pagesize);
+
+	pagecache_semtake();
+
+	p = pagecache_lookup(pc, page);
+	if (p != NULL) {
+		pagecache_hit(p);
+		memcpy(buffer, PAGE_DATA(p) + offset, count);
+		pagecache_semgive();
+		return count;
+	}
+
+	pc->stats.misses++;
+
+	p = pagecache_alloc(pc);
+	pagecache_semgive();
+
+	if (p == NULL) {
+		return -ENOMEM;
+	}
+
+	ret = pagecache_devread(pc, PAGE_DATA(p), page, 1);
+
+	pagecache_semtake();
+
+	if (ret != OK) {
+		g_pagecache_used -= pc->pagesize;
+		pagecache_semgive();
+		kmm_free(p);
+		return ret;
+	}
+
+	/* Another thread may have cached the page while the semaphore was free.
+	 * Keep its copy, which also holds any pagecache_update() made since.
+	 */
+
+	q = pagecache_lookup(pc, page);
+	if (q != NULL) {
+		g_pagecache_used -= pc->pagesize;
+		kmm_free(p);
+
+		dq_rem(&q->lru, &g_pagecache_lru);
+		dq_addfirst(&q->lru, &g_pagecache_lru);
+		p = q;
+	} else {
+		pagecache_insert(p, page, false);
+	}
+
+	memcpy(buffer, PAGE_DATA(p) + offset, count);
+
+	pagecache_semgive();
+	return count;
+}
+
+/****************************************************************************
+ * Name: pagecache_update
+ ****************************************************************************/
+
+void pagecache_update(FAR struct pagecache_s *pc, FAR const uint8_t *buffer, size_t page, size_t offset, size_t count)
+{
+	FAR struct pagecache_page_s *p;
+
+	DEBUGASSERT(offset + count <= pc->pagesize);
+
+	pagecache_semtake();
+
+	p = pagecache_lookup(pc, page);
+	if (p != NULL) {
+		dq_rem(&p->lru, &g_pagecache_lru);
+		dq_addfirst(&p->lru, &g_pagecache_lru);
+		memcpy(PAGE_DATA(p) + offset, buffer, count);
+	} else if (offset == 0 && count == pc->pagesize) {
+		p = pagecache_alloc(pc);
+		if (p != NULL) {
+			pagecache_insert(p, page, false);
+			memcpy(PAGE_DATA(p), buffer, count);
+		}
+	}
+
+	pagecache_semgive();
+}
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR struct pagecache_s *pc, size_t page, size_t npages)
+{
+	FAR struct pagecache_page_s *p;
+
+	pagecache_semtake();
+
+	for (; npages > 0 && pc->ncached > 0; npages--, page++) {
+		p = pagecache_lookup(pc, page);
+		if (p != NULL) {
+			pagecache_release(p);
+		}
+	}
+
+	pagecache_semgive();
+}
+
+/****************************************************************************
+ * Name: pagecache_shrink
+ ****************************************************************************/
+
+size_t pagecache_shrink(size_t nbytes)
+{
+	FAR struct pagecache_page_s *p;
+	size_t freed = 0;
+
+	/* The caller may be allocating with the semaphore held */
+
+	if (sem_trywait(&g_pagecache_sem) != OK) {
+		return 0;
+	}
+
+	while (freed < nbytes && (p = (FAR struct pagecache_page_s *)dq_tail(&g_pagecache_lru)) != NULL) {
+		p->pc->stats.evictions++;
+		freed += p->pc->pagesize;
+		pagecache_release(p);
+	}
+
+	pagecache_semgive();
+	return freed;
+}
+
+#endif							/* CONFIG_FS_PAGECACHE */
@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/pagecache/pagecache.h
+ ****************************************************************************/
+
+#ifndef __FS_PAGECACHE_PAGECACHE_H
+#define __FS_PAGECACHE_PAGECACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <tinyara/fs/pagecache.h>
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_PAGECACHE_SIZE
+#define CONFIG_FS_PAGECACHE_SIZE		16384
+#endif
+
+#ifndef CONFIG_FS_PAGECACHE_READAHEAD
+#define CONFIG_FS_PAGECACHE_READAHEAD	8
+#endif
+
+#define pagecache_semgive()				sem_post(&g_pagecache_sem)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Counters of one volume, reported through procfs */
+
+struct pagecache_stats_s {
+	uint32_t hits;				/* Pages found in the cache */
+	uint32_t misses;			/* Pages read from the device on demand */
+	uint32_t rapages;			/* Pages read ahead */
+	uint32_t rahits;			/* Pages read ahead that were then used */
+	uint32_t evictions;			/* Pages dropped for room or on memory pressure */
+};
+
+/* One attached device */
+
+struct pagecache_s {
+	FAR struct pagecache_s *flink;	/* Next attached device */
+	FAR struct inode *blkdriver;	/* The block driver, key of the volume */
+	FAR const char *fstype;		/* File system, for procfs */
+	FAR const struct pagecache_ops_s *ops;	/* Page read method or NULL */
+	size_t npages;				/* Pages on the device */
+	size_t nextpage;			/* First page after the last read */
+	size_t ncached;				/* Pages of this volume in the cache */
+	uint16_t pagesize;			/* Bytes per page */
+	uint16_t window;			/* Pages to read ahead of a sequential read */
+	uint8_t refs;				/* Number of pagecache_attach() calls */
+	int devno;					/* Volume number shown in procfs */
+	bool readahead;				/* true: Read-ahead is useful on this device */
+	struct pagecache_stats_s stats;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/* Protects the volumes, the pages and all counters */
+
+EXTERN sem_t g_pagecache_sem;
+
+/* The attached devices, in the order of attachment */
+
+EXTERN FAR struct pagecache_s *g_pagecache_volumes;
+
+/* Bytes of page data currently cached */
+
+EXTERN size_t g_pagecache_used;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+EXTERN void pagecache_semtake(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_FS_PAGECACHE */
+#endif							/* __FS_PAGECACHE_PAGECACHE_H */
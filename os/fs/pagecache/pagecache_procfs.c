@@ -0,0 +1,277 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/pagecache/pagecache_procfs.c
+ *
+ * Exposes the page cache statistics of every attached volume as
+ * /proc/fs/pagecache.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#include "pagecache.h"
+
+#if defined(CONFIG_FS_PAGECACHE) && defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PAGECACHE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* This structure describes one open "file" */
+
+struct pagecache_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	bool header;				/* true: The header line has been output */
+	int nextdevno;				/* Volume number of the next line to output */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int pagecache_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int pagecache_procfs_close(FAR struct file *filep);
+static ssize_t pagecache_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int pagecache_procfs_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int pagecache_procfs_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+const struct procfs_operations pagecache_procfsoperations = {
+	pagecache_procfs_open,		/* open */
+	pagecache_procfs_close,		/* close */
+	pagecache_procfs_read,		/* read */
+	NULL,						/* write */
+
+	pagecache_procfs_dup,		/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	pagecache_procfs_stat		/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_procfs_open
+ ****************************************************************************/
+
+static int pagecache_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct pagecache_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* Allocate a context structure */
+
+	attr = (FAR struct pagecache_file_s *)kmm_zalloc(sizeof(struct pagecache_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the context as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_procfs_close
+ ****************************************************************************/
+
+static int pagecache_procfs_close(FAR struct file *filep)
+{
+	FAR struct pagecache_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct pagecache_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_procfs_read
+ ****************************************************************************/
+
+static ssize_t pagecache_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct pagecache_file_s *priv;
+	FAR struct pagecache_s *pc;
+	ssize_t total = 0;
+	ssize_t ret;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	priv = (FAR struct pagecache_file_s *)filep->f_priv;
+	DEBUGASSERT(priv);
+
+	pagecache_semtake();
+
+	/* Output the cache size and a header before the first entry */
+
+	if (!priv->header) {
+		ret = snprintf(buffer, buflen, "Cache: %u of %u bytes\n"
+					   "Num  FS       Pages  Hits       Misses     RaPages    RaHits     Evicts     Device\n",
+					   g_pagecache_used, CONFIG_FS_PAGECACHE_SIZE);
+		if ((size_t)ret >= buflen) {
+			pagecache_semgive();
+			return 0;
+		}
+
+		total = ret;
+		priv->header = true;
+	}
+
+	/* Volumes are looked up by number on each read so that a volume
+	 * detached between two reads is simply skipped.
+	 */
+
+	for (pc = g_pagecache_volumes; pc; pc = pc->flink) {
+		if (pc->devno < priv->nextdevno) {
+			continue;
+		}
+
+		ret = snprintf(&buffer[total], buflen - total, "%-5d%-9s%-7u%-11u%-11u%-11u%-11u%-11u%s\n",
+					   pc->devno, pc->fstype, pc->ncached,
+					   pc->stats.hits, pc->stats.misses, pc->stats.rapages,
+					   pc->stats.rahits, pc->stats.evictions, pc->blkdriver->i_name);
+
+		if ((size_t)(ret + total) < buflen) {
+			total += ret;
+			priv->nextdevno = pc->devno + 1;
+		} else {
+			buffer[total] = '\0';
+			break;
+		}
+	}
+
+	pagecache_semgive();
+
+	/* Update the file offset */
+
+	if (total > 0) {
+		filep->f_pos += total;
+	}
+
+	return total;
+}
+
+/****************************************************************************
+ * Name: pagecache_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int pagecache_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct pagecache_file_s *oldattr;
+	FAR struct pagecache_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct pagecache_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct pagecache_file_s *)kmm_zalloc(sizeof(struct pagecache_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct pagecache_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int pagecache_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+	/* File/directory size, access block size */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_FS_PAGECACHE && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_PAGECACHE */
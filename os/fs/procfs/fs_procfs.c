@@ -101,9 +101,12 @@ extern const struct procfs_operations version_operations;
  * deal with them here is not a good coupling.
  */
 
+extern const struct procfs_operations bch_procfsoperations;
 extern const struct procfs_operations mtd_procfsoperations;
 extern const struct procfs_operations part_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
+extern const struct procfs_operations pagecache_procfsoperations;
+extern const struct procfs_operations rwbuffer_procfsoperations;
 extern const struct procfs_operations power_procfsoperations;
 extern const struct procfs_operations cm_operations;
 extern const struct procfs_operations irqs_operations;
@@ -125,10 +128,18 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"[0-9]*", &proc_operations},
 #endif
 
+#if defined(CONFIG_BCH) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BCH)
+	{"bch", &bch_procfsoperations},
+#endif
+
 #if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
 	{"cpuload", &cpuload_operations},
 #endif
 
+#if defined(CONFIG_FS_PAGECACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PAGECACHE)
+	{"fs/pagecache", &pagecache_procfsoperations},
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 	{"fs/smartfs**", &smartfs_procfsoperations},
 #endif
@@ -149,6 +160,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"power/domains**", &power_procfsoperations},
 #endif
 
+#if (defined(CONFIG_DRVR_WRITEBUFFER) || defined(CONFIG_DRVR_READAHEAD)) && !defined(CONFIG_FS_PROCFS_EXCLUDE_RWBUFFER)
+	{"rwbuffer", &rwbuffer_procfsoperations},
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
 	{"uptime", &uptime_operations},
 #endif
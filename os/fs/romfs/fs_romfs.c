@@ -972,6 +972,11 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data, FAR voi
 
 errout_with_buffer:
 	if (!rm->rm_xipbase) {
+#ifdef CONFIG_FS_PAGECACHE
+		if (rm->rm_pagecache) {
+			pagecache_detach(rm->rm_pagecache);
+		}
+#endif
 		kmm_free(rm->rm_buffer);
 	}
 
@@ -1034,6 +1039,12 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver)
 
 		/* Release the mountpoint private data */
 
+#ifdef CONFIG_FS_PAGECACHE
+		if (rm->rm_pagecache) {
+			pagecache_detach(rm->rm_pagecache);
+		}
+#endif
+
 		if (!rm->rm_xipbase && rm->rm_buffer) {
 			kmm_free(rm->rm_buffer);
 		}
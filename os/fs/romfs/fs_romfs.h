@@ -65,6 +65,7 @@
 #include <stdbool.h>
 
 #include <tinyara/fs/dirent.h>
+#include <tinyara/fs/pagecache.h>
 
 #include "inode/inode.h"
 
@@ -167,6 +168,9 @@ struct romfs_mountpt_s {
 	uint32_t rm_cachesector;	/* Current sector in the rm_buffer */
 	uint8_t *rm_xipbase;		/* Base address of directly accessible media */
 	uint8_t *rm_buffer;			/* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_PAGECACHE
+	struct pagecache_s *rm_pagecache;	/* Shared sector cache, NULL in XIP mode */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -404,6 +404,11 @@ int romfs_hwread(struct romfs_mountpt_s *rm, uint8_t *buffer, uint32_t sector, u
 		ssize_t nsectorsread;
 
 		DEBUGASSERT(inode);
+#ifdef CONFIG_FS_PAGECACHE
+		if (rm->rm_pagecache) {
+			return pagecache_read(rm->rm_pagecache, buffer, sector, nsectors);
+		}
+#endif
 		if (inode->u.i_bops && inode->u.i_bops->read) {
 			nsectorsread = inode->u.i_bops->read(inode, buffer, sector, nsectors);
 
@@ -529,6 +534,14 @@ int romfs_hwconfigure(struct romfs_mountpt_s *rm)
 		return -ENOMEM;
 	}
 
+#ifdef CONFIG_FS_PAGECACHE
+	/* Files are stored in consecutive sectors, so read-ahead pays off.
+	 * Without the cache, sectors are read directly.
+	 */
+
+	rm->rm_pagecache = pagecache_attach(inode, "romfs", rm->rm_hwsectorsize, rm->rm_hwnsectors, true, NULL);
+#endif
+
 	return OK;
 }
 
@@ -66,6 +66,7 @@
 
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/smart.h>
+#include <tinyara/fs/pagecache.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -208,7 +209,11 @@
 /* Underlying MTD Block driver access functions */
 
 #define FS_BOPS(f)        (f)->fs_blkdriver->u.i_bops
+#ifdef CONFIG_FS_PAGECACHE
+#define FS_IOCTL(f, c, a) smartfs_blkioctl(f, c, a)
+#else
 #define FS_IOCTL(f, c, a) (FS_BOPS(f)->ioctl ? FS_BOPS(f)->ioctl((f)->fs_blkdriver, c, a) : (-ENOSYS))
+#endif
 
 /* The logical sector number of the root directory. */
 
@@ -349,6 +354,9 @@ struct smartfs_mountpt_s {
 	uint8_t *fs_chunk_buffer;
 #endif
 	uint8_t fs_rootsector;		/* Root directory sector num */
+#ifdef CONFIG_FS_PAGECACHE
+	FAR struct pagecache_s *fs_pagecache;	/* Shared cache of logical sectors */
+#endif
 #ifdef CONFIG_SMARTFS_ENTRY_TIMESTAMP
 	uint32_t entry_seq;
 #endif
@@ -400,6 +408,10 @@ int smartfs_extendfile(FAR struct smartfs_mountpt_s *fs, FAR struct smartfs_ofil
 
 void smartfs_setbuffer(struct smart_read_write_s *rw, uint16_t logsector, uint16_t offset, uint16_t count, uint8_t *buffer);
 
+#ifdef CONFIG_FS_PAGECACHE
+int smartfs_blkioctl(FAR struct smartfs_mountpt_s *fs, int cmd, unsigned long arg);
+#endif
+
 void smartfs_set_entry_flags(struct smartfs_entry_s *new_entry, mode_t mode, uint16_t type);
 
 int smartfs_sync_internal(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf);
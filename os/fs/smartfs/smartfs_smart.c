@@ -1257,6 +1257,11 @@ static int smartfs_bind(FAR struct inode *blkdriver, const void *data, void **ha
 	return ret;
 
 error_with_semaphore:
+#ifdef CONFIG_FS_PAGECACHE
+	if (fs->fs_pagecache) {
+		pagecache_detach(fs->fs_pagecache);
+	}
+#endif
 	smartfs_semgive(fs);
 	kmm_free(fs);
 	return ret;
@@ -174,10 +174,20 @@ struct sector_recover_info_s {
  * Private Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_FS_PAGECACHE
+static ssize_t smartfs_readpages(FAR struct inode *blkdriver, FAR uint8_t *buffer, size_t page, unsigned int npages, uint16_t pagesize);
+#endif
+
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
 
+#ifdef CONFIG_FS_PAGECACHE
+static const struct pagecache_ops_s g_smartfs_pagecache_ops = {
+	smartfs_readpages			/* read */
+};
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -186,6 +196,37 @@ struct sector_recover_info_s {
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_FS_PAGECACHE
+/****************************************************************************
+ * Name: smartfs_readpages
+ *
+ * Description: Page read method of the page cache.  A page is the data
+ *   area of one logical sector.
+ *
+ ****************************************************************************/
+
+static ssize_t smartfs_readpages(FAR struct inode *blkdriver, FAR uint8_t *buffer, size_t page, unsigned int npages, uint16_t pagesize)
+{
+	struct smart_read_write_s readwrite;
+	unsigned int i;
+	int ret;
+
+	if (!blkdriver->u.i_bops->ioctl) {
+		return -ENOSYS;
+	}
+
+	for (i = 0; i < npages; i++, buffer += pagesize) {
+		smartfs_setbuffer(&readwrite, page + i, 0, pagesize, buffer);
+		ret = blkdriver->u.i_bops->ioctl(blkdriver, BIOC_READSECT, (unsigned long)&readwrite);
+		if (ret < 0) {
+			return i > 0 ? i : ret;
+		}
+	}
+
+	return npages;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -328,6 +369,78 @@ void smartfs_setbuffer(struct smart_read_write_s *rw, uint16_t logsector, uint16
 	return;
 }
 
+#ifdef CONFIG_FS_PAGECACHE
+/****************************************************************************
+ * Name: smartfs_blkioctl
+ *
+ * Description:
+ *   Issue an ioctl to the SMART block driver, keeping the page cache in
+ *   step.  Sector reads are served from the cache, sector writes update it,
+ *   and sectors that are allocated or freed are dropped from it.
+ *
+ ***************************************************************************/
+
+int smartfs_blkioctl(FAR struct smartfs_mountpt_s *fs, int cmd, unsigned long arg)
+{
+	FAR struct smart_read_write_s *rw = (FAR struct smart_read_write_s *)arg;
+	FAR struct pagecache_s *pc = fs->fs_pagecache;
+	int ret;
+
+	if (!FS_BOPS(fs)->ioctl) {
+		return -ENOSYS;
+	}
+
+	if (pc == NULL) {
+		return FS_BOPS(fs)->ioctl(fs->fs_blkdriver, cmd, arg);
+	}
+
+	switch (cmd) {
+	case BIOC_READSECT:
+		if (rw->offset + rw->count <= fs->fs_llformat.availbytes) {
+			ret = pagecache_readpart(pc, (FAR uint8_t *)rw->buffer, rw->logsector, rw->offset, rw->count);
+			if (ret != -ENOMEM) {
+				return ret;
+			}
+		}
+
+		/* The page could not be cached, read the device */
+
+		break;
+
+	case BIOC_WRITESECT:
+		ret = FS_BOPS(fs)->ioctl(fs->fs_blkdriver, cmd, arg);
+		if (ret < 0 || rw->offset + rw->count > fs->fs_llformat.availbytes) {
+			pagecache_invalidate(pc, rw->logsector, 1);
+		} else {
+			pagecache_update(pc, rw->buffer, rw->logsector, rw->offset, rw->count);
+		}
+
+		return ret;
+
+	case BIOC_ALLOCSECT:
+		ret = FS_BOPS(fs)->ioctl(fs->fs_blkdriver, cmd, arg);
+		if (ret >= 0) {
+			pagecache_invalidate(pc, ret, 1);
+		}
+
+		return ret;
+
+	case BIOC_FREESECT:
+		pagecache_invalidate(pc, arg, 1);
+		break;
+
+	case BIOC_LLFORMAT:
+		pagecache_invalidate(pc, 0, fs->fs_llformat.nsectors);
+		break;
+
+	default:
+		break;
+	}
+
+	return FS_BOPS(fs)->ioctl(fs->fs_blkdriver, cmd, arg);
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_set_entry_flags
  *
@@ -882,6 +995,15 @@ int smartfs_mount(struct smartfs_mountpt_s *fs, bool writeable)
 	fs->fs_workbuffer = (char *)kmm_malloc(256);
 	fs->fs_rootsector = SMARTFS_ROOT_DIR_SECTOR;
 
+#ifdef CONFIG_FS_PAGECACHE
+	/* The sectors of a file are chained, not consecutive on the device,
+	 * so sequential reads cannot be read ahead.  Without the cache, the
+	 * device is read directly.
+	 */
+
+	fs->fs_pagecache = pagecache_attach(fs->fs_blkdriver, "smartfs", fs->fs_llformat.availbytes, fs->fs_llformat.nsectors, false, &g_smartfs_pagecache_ops);
+#endif
+
 	/* We did it! */
 
 	fs->fs_mounted = TRUE;
@@ -928,6 +1050,13 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
 	int found = FALSE;
 #endif
 
+#ifdef CONFIG_FS_PAGECACHE
+	if (fs->fs_pagecache) {
+		pagecache_detach(fs->fs_pagecache);
+		fs->fs_pagecache = NULL;
+	}
+#endif
+
 #if defined(CONFIG_SMARTFS_MULTI_ROOT_DIRS) || \
 	(defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS))
 	/* Start at the head of the mounts and search for our entry.  Also
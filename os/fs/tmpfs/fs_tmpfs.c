@@ -83,10 +83,14 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
+#if CONFIG_FS_TMPFS_CHUNKSIZE < 64
+#  error CONFIG_FS_TMPFS_CHUNKSIZE is too small
 #endif
 
+/* Initial number of entries in a file chunk table */
+
+#define TMPFS_CHUNKTABLE_MIN 4
+
 #define tmpfs_lock_file(tfo) \
 	(tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
 #define tmpfs_lock_directory(tdo) \
@@ -108,7 +112,10 @@ static void tmpfs_unlock(FAR struct tmpfs_s *fs);
 static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo, unsigned int nentries);
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo, size_t newsize);
+static FAR uint8_t *tmpfs_alloc_chunk(void);
+static void tmpfs_free_chunk(FAR uint8_t *chunk);
+static int tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo, FAR const char *name);
@@ -150,6 +157,22 @@ static int tmpfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath, F
 static void tmpfs_stat_common(FAR struct tmpfs_object_s *to, FAR struct stat *buf);
 static int tmpfs_stat(FAR struct inode *mountpt, FAR const char *relpath, FAR struct stat *buf);
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Free chunks kept for reuse, shared by all TMPFS instances.  Free chunks
+ * are linked through their first word.
+ */
+
+static struct {
+	sem_t tcp_sem;             /* Protects the pool */
+	FAR void *tcp_head;        /* First free chunk */
+	uint16_t tcp_nfree;        /* Number of chunks in the pool */
+} g_tmpfs_chunkpool = {
+	SEM_INITIALIZER(1), NULL, 0
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -341,65 +364,163 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_alloc_chunk
+ *
+ * Description:
+ *   Get a data chunk, from the pool of free chunks if possible.  The
+ *   content of the chunk is undefined.
+ *
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-		size_t newsize)
+static FAR uint8_t *tmpfs_alloc_chunk(void)
 {
-	FAR struct tmpfs_file_s *oldtfo = *tfo;
-	FAR struct tmpfs_file_s *newtfo;
-	size_t objsize;
-	size_t allocsize;
+	FAR uint8_t *chunk;
+
+	while (sem_wait(&g_tmpfs_chunkpool.tcp_sem) != 0) {
+		ASSERT(get_errno() == EINTR);
+	}
+
+	chunk = (FAR uint8_t *)g_tmpfs_chunkpool.tcp_head;
+	if (chunk != NULL) {
+		g_tmpfs_chunkpool.tcp_head = *(FAR void **)chunk;
+		g_tmpfs_chunkpool.tcp_nfree--;
+	}
+
+	sem_post(&g_tmpfs_chunkpool.tcp_sem);
+
+	if (chunk == NULL) {
+		chunk = (FAR uint8_t *)kmm_malloc(CONFIG_FS_TMPFS_CHUNKSIZE);
+	}
+
+	return chunk;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_chunk
+ *
+ * Description:
+ *   Return a data chunk to the pool, or to the heap if the pool is full.
+ *
+ ****************************************************************************/
 
-	/* Check if the current allocation is sufficent */
+static void tmpfs_free_chunk(FAR uint8_t *chunk)
+{
+	while (sem_wait(&g_tmpfs_chunkpool.tcp_sem) != 0) {
+		ASSERT(get_errno() == EINTR);
+	}
+
+	if (g_tmpfs_chunkpool.tcp_nfree < CONFIG_FS_TMPFS_CHUNK_POOLSIZE) {
+		*(FAR void **)chunk = g_tmpfs_chunkpool.tcp_head;
+		g_tmpfs_chunkpool.tcp_head = chunk;
+		g_tmpfs_chunkpool.tcp_nfree++;
+		chunk = NULL;
+	}
 
-	objsize = SIZEOF_TMPFS_FILE(newsize);
+	sem_post(&g_tmpfs_chunkpool.tcp_sem);
 
-	/* Are we growing or shrinking the object? */
+	if (chunk != NULL) {
+		kmm_free(chunk);
+	}
+}
 
-	if (objsize <= oldtfo->tfo_alloc) {
-		/* Shrinking ... Shrink unconditionally if the size is shrinking to
-		 * zero.
+/****************************************************************************
+ * Name: tmpfs_resize_file
+ *
+ * Description:
+ *   Change the size of a file.  Growing only enlarges the chunk table; the
+ *   chunks themselves are allocated when data is written, so the new space
+ *   reads back as zeros.  Shrinking releases the chunks past the new end.
+ *
+ ****************************************************************************/
+
+static int tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize)
+{
+	FAR uint8_t **newtable;
+	unsigned int nneeded;
+	unsigned int ntable;
+	unsigned int i;
+	size_t offset;
+
+	nneeded = TMPFS_NCHUNKS(newsize);
+
+	if (nneeded > tfo->tfo_nchunks) {
+		/* Grow the chunk table geometrically so that appending to a file
+		 * costs amortized constant time.  Only the table of pointers is
+		 * reallocated, the file data never moves.
 		 */
 
-		if (newsize > 0) {
-			/* Otherwise, don't realloc unless the object has shrunk by a
-			 * lot.
-			 */
+		ntable = tfo->tfo_nchunks > 0 ? tfo->tfo_nchunks : TMPFS_CHUNKTABLE_MIN;
+		while (ntable < nneeded) {
+			ntable <<= 1;
+		}
 
-			if (oldtfo->tfo_alloc - objsize <= CONFIG_FS_TMPFS_FILE_FREEGUARD) {
-				/* Hasn't shrunk enough.. Return doing nothing for now */
+		newtable = (FAR uint8_t **)kmm_realloc(tfo->tfo_chunks, ntable * sizeof(FAR uint8_t *));
+		if (newtable == NULL) {
+			return -ENOMEM;
+		}
 
-				oldtfo->tfo_size = newsize;
-				return OK;
+		memset(&newtable[tfo->tfo_nchunks], 0, (ntable - tfo->tfo_nchunks) * sizeof(FAR uint8_t *));
+		tfo->tfo_alloc  += (ntable - tfo->tfo_nchunks) * sizeof(FAR uint8_t *);
+		tfo->tfo_chunks  = newtable;
+		tfo->tfo_nchunks = ntable;
+	} else if (newsize < tfo->tfo_size) {
+		/* Release the chunks that are now past the end of the file */
+
+		for (i = nneeded; i < tfo->tfo_nchunks; i++) {
+			if (tfo->tfo_chunks[i] != NULL) {
+				tmpfs_free_chunk(tfo->tfo_chunks[i]);
+				tfo->tfo_chunks[i] = NULL;
+				tfo->tfo_alloc -= CONFIG_FS_TMPFS_CHUNKSIZE;
 			}
 		}
-	}
 
-	/* Added some additional amount to the new size to account frequent
-	 * reallocations.
-	 */
+		/* Zero the cut-off part of the last chunk so that it reads back as
+		 * zeros if the file grows again.
+		 */
 
-	allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+		offset = newsize % CONFIG_FS_TMPFS_CHUNKSIZE;
+		if (offset > 0 && tfo->tfo_chunks[nneeded - 1] != NULL) {
+			memset(&tfo->tfo_chunks[nneeded - 1][offset], 0, CONFIG_FS_TMPFS_CHUNKSIZE - offset);
+		}
 
-	/* Realloc the file object */
+		/* An empty file needs no chunk table at all */
 
-	newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-	if (newtfo == NULL) {
-		return -ENOMEM;
+		if (newsize == 0) {
+			kmm_free(tfo->tfo_chunks);
+			tfo->tfo_alloc  -= tfo->tfo_nchunks * sizeof(FAR uint8_t *);
+			tfo->tfo_chunks  = NULL;
+			tfo->tfo_nchunks = 0;
+		}
 	}
-	/* Adjust the reference in the parent directory entry */
 
-	DEBUGASSERT(newtfo->tfo_dirent);
-	newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+	tfo->tfo_size = newsize;
+	return OK;
+}
 
-	/* Return the new address of the reallocated file object */
+/****************************************************************************
+ * Name: tmpfs_free_file
+ *
+ * Description:
+ *   Free a file object together with all of its data.
+ *
+ ****************************************************************************/
 
-	newtfo->tfo_alloc = allocsize;
-	newtfo->tfo_size  = newsize;
-	*tfo              = newtfo;
-	return OK;
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+	unsigned int i;
+
+	for (i = 0; i < tfo->tfo_nchunks; i++) {
+		if (tfo->tfo_chunks[i] != NULL) {
+			tmpfs_free_chunk(tfo->tfo_chunks[i]);
+		}
+	}
+
+	if (tfo->tfo_chunks != NULL) {
+		kmm_free(tfo->tfo_chunks);
+	}
+
+	sem_destroy(&tfo->tfo_exclsem.ts_sem);
+	kmm_free(tfo);
 }
 
 /****************************************************************************
@@ -433,8 +554,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 	 */
 
 	if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0) {
-		sem_destroy(&tfo->tfo_exclsem.ts_sem);
-		kmm_free(tfo);
+		tmpfs_free_file(tfo);
 	}
 
 	/* Otherwise, just decrement the reference count on the file object */
@@ -571,12 +691,12 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 {
 	FAR struct tmpfs_file_s *tfo;
-	size_t allocsize;
 
-	/* Create a new zero length file object */
+	/* Create a new zero length file object.  No data chunks are allocated
+	 * until something is written.
+	 */
 
-	allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-	tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+	tfo = (FAR struct tmpfs_file_s *)kmm_malloc(sizeof(struct tmpfs_file_s));
 	if (tfo == NULL) {
 		return NULL;
 	}
@@ -584,11 +704,13 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 	 * locked with one reference count.
 	 */
 
-	tfo->tfo_alloc = allocsize;
-	tfo->tfo_type  = TMPFS_REGULAR;
-	tfo->tfo_refs  = 1;
-	tfo->tfo_flags = 0;
-	tfo->tfo_size  = 0;
+	tfo->tfo_alloc   = sizeof(struct tmpfs_file_s);
+	tfo->tfo_type    = TMPFS_REGULAR;
+	tfo->tfo_refs    = 1;
+	tfo->tfo_flags   = 0;
+	tfo->tfo_size    = 0;
+	tfo->tfo_nchunks = 0;
+	tfo->tfo_chunks  = NULL;
 
 	tfo->tfo_exclsem.ts_holder = getpid();
 	tfo->tfo_exclsem.ts_count  = 1;
@@ -1171,6 +1293,11 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 			tfo->tfo_flags |= TFO_FLAG_UNLINKED;
 			return TMPFS_UNLINKED;
 		}
+
+		/* Free the file and its data now */
+
+		tmpfs_free_file(tfo);
+		return TMPFS_DELETED;
 	}
 
 	/* Free the object now */
@@ -1316,7 +1443,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 			 */
 
 			if (tfo->tfo_size > 0) {
-				ret = tmpfs_realloc_file(&tfo, 0);
+				ret = tmpfs_resize_file(tfo, 0);
 				if (ret < 0)
 					goto errout_with_filelock;
 			}
@@ -1420,7 +1547,7 @@ static int tmpfs_close(FAR struct file *filep)
 		 * have any other references.
 		 */
 
-		kmm_free(tfo);
+		tmpfs_free_file(tfo);
 		return OK;
 	}
 
@@ -1438,9 +1565,13 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 		size_t buflen)
 {
 	FAR struct tmpfs_file_s *tfo;
+	FAR uint8_t *chunk;
 	ssize_t nread;
 	off_t startpos;
 	off_t endpos;
+	off_t pos;
+	size_t offset;
+	size_t nbytes;
 
 	fvdbg("filep: %p buffer: %p buflen: %lu\n",
 			filep, buffer, (unsigned long)buflen);
@@ -1462,12 +1593,30 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
 	if (endpos > tfo->tfo_size) {
 		endpos = tfo->tfo_size;
-		nread  = endpos - startpos;
+		nread  = endpos > startpos ? endpos - startpos : 0;
 	}
 
-	/* Copy data from the memory object to the user buffer */
+	/* Copy data from the memory object to the user buffer, one chunk at a
+	 * time.  Holes read back as zeros.
+	 */
+
+	for (pos = startpos; pos < startpos + nread; pos += nbytes) {
+		offset = pos % CONFIG_FS_TMPFS_CHUNKSIZE;
+		nbytes = CONFIG_FS_TMPFS_CHUNKSIZE - offset;
+		if (nbytes > startpos + nread - pos) {
+			nbytes = startpos + nread - pos;
+		}
+
+		chunk = tfo->tfo_chunks[pos / CONFIG_FS_TMPFS_CHUNKSIZE];
+		if (chunk != NULL) {
+			memcpy(buffer, &chunk[offset], nbytes);
+		} else {
+			memset(buffer, 0, nbytes);
+		}
+
+		buffer += nbytes;
+	}
 
-	memcpy(buffer, &tfo->tfo_data[startpos], nread);
 	filep->f_pos += nread;
 
 	/* Release the lock on the file */
@@ -1484,9 +1633,13 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 		size_t buflen)
 {
 	FAR struct tmpfs_file_s *tfo;
+	FAR uint8_t *chunk;
 	ssize_t nwritten;
 	off_t startpos;
 	off_t endpos;
+	size_t oldsize;
+	size_t offset;
+	size_t nbytes;
 	int ret;
 
 	fvdbg("filep: %p buffer: %p buflen: %lu\n",
@@ -1504,22 +1657,63 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 	/* Handle attempts to read beyond the end of the file */
 
 	startpos = filep->f_pos;
-	nwritten = buflen;
 	endpos   = startpos + buflen;
+	oldsize  = tfo->tfo_size;
 
 	if (endpos > tfo->tfo_size) {
-		/* Reallocate the file to handle the write past the end of the file. */
+		/* Extend the file to handle the write past the end of the file. */
 
-		ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
+		ret = tmpfs_resize_file(tfo, (size_t)endpos);
 		if (ret < 0) {
 			goto errout_with_lock;
 		}
-		filep->f_priv = tfo;
 	}
 
-	/* Copy data from the memory object to the user buffer */
+	/* Copy data from the user buffer to the memory object, one chunk at a
+	 * time, allocating chunks as they are first written.
+	 */
+
+	for (nwritten = 0; nwritten < buflen; nwritten += nbytes) {
+		offset = (startpos + nwritten) % CONFIG_FS_TMPFS_CHUNKSIZE;
+		nbytes = CONFIG_FS_TMPFS_CHUNKSIZE - offset;
+		if (nbytes > buflen - nwritten) {
+			nbytes = buflen - nwritten;
+		}
+
+		chunk = tfo->tfo_chunks[(startpos + nwritten) / CONFIG_FS_TMPFS_CHUNKSIZE];
+		if (chunk == NULL) {
+			chunk = tmpfs_alloc_chunk();
+			if (chunk == NULL) {
+				/* Out of memory.  Keep what has been written so far */
+
+				if (oldsize < startpos + nwritten) {
+					oldsize = startpos + nwritten;
+				}
+
+				(void)tmpfs_resize_file(tfo, oldsize);
+				if (nwritten == 0) {
+					ret = -ENOMEM;
+					goto errout_with_lock;
+				}
+
+				break;
+			}
+
+			/* The parts of a new chunk that are not written must read as
+			 * zeros.
+			 */
+
+			memset(chunk, 0, offset);
+			memset(&chunk[offset + nbytes], 0, CONFIG_FS_TMPFS_CHUNKSIZE - offset - nbytes);
+
+			tfo->tfo_chunks[(startpos + nwritten) / CONFIG_FS_TMPFS_CHUNKSIZE] = chunk;
+			tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+		}
+
+		memcpy(&chunk[offset], buffer, nbytes);
+		buffer += nbytes;
+	}
 
-	memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
 	filep->f_pos += nwritten;
 
 	/* Release the lock on the file */
@@ -1611,12 +1805,36 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 	/* Only one ioctl command is supported */
 
 	if (cmd == FIOC_MMAP && ppv != NULL) {
+		FAR uint8_t *chunk;
+		int ret = -ENOSYS;
+
 		/* Return the address on the media corresponding to the start of
-		 * the file.
+		 * the file.  The data is only contiguous in memory if the whole
+		 * file fits in one chunk.
 		 */
 
-		*ppv = (FAR void *)tfo->tfo_data;
-		return OK;
+		tmpfs_lock_file(tfo);
+		if (tfo->tfo_size > 0 && tfo->tfo_size <= CONFIG_FS_TMPFS_CHUNKSIZE) {
+			chunk = tfo->tfo_chunks[0];
+			if (chunk == NULL) {
+				chunk = tmpfs_alloc_chunk();
+				if (chunk != NULL) {
+					memset(chunk, 0, CONFIG_FS_TMPFS_CHUNKSIZE);
+					tfo->tfo_chunks[0] = chunk;
+					tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+				}
+			}
+
+			if (chunk != NULL) {
+				*ppv = (FAR void *)chunk;
+				ret = OK;
+			} else {
+				ret = -ENOMEM;
+			}
+		}
+
+		tmpfs_unlock_file(tfo);
+		return ret;
 	}
 
 	fdbg("ERROR: Invalid cmd: %d\n", cmd);
@@ -1717,22 +1935,14 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 
 	oldsize = tfo->tfo_size;
 	if (oldsize != length) {
-		/* The size is changing.. up or down.  Reallocate the file memory. */
-		ret = tmpfs_realloc_file(&tfo, (size_t)length);
-		if (ret < 0) {
-			goto errout_with_lock;
-		}
-
-		filep->f_priv = tfo;
-
-		/* If the size has increased, then we need to zero the newly added
-		 * memory.
+		/* The size is changing.. up or down.  Any newly added space is a
+		 * hole that reads back as zeros.
 		 */
 
-		if (length > oldsize) {
-		  memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
+		ret = tmpfs_resize_file(tfo, (size_t)length);
+		if (ret < 0) {
+			goto errout_with_lock;
 		}
-		ret = OK;
 	}
 
 	/* Release the lock on the file */
@@ -2116,8 +2326,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 	/* Otherwise we can free the object now */
 
 	else {
-		sem_destroy(&tfo->tfo_exclsem.ts_sem);
-		kmm_free(tfo);
+		tmpfs_free_file(tfo);
 	}
 
 	/* Release the reference and lock on the parent directory */
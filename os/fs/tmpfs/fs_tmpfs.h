@@ -75,6 +75,18 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data is kept in fixed-size chunks */
+
+#ifndef CONFIG_FS_TMPFS_CHUNKSIZE
+#define CONFIG_FS_TMPFS_CHUNKSIZE 512
+#endif
+
+#ifndef CONFIG_FS_TMPFS_CHUNK_POOLSIZE
+#define CONFIG_FS_TMPFS_CHUNK_POOLSIZE 8
+#endif
+
+#define TMPFS_NCHUNKS(n)  (((n) + CONFIG_FS_TMPFS_CHUNKSIZE - 1) / CONFIG_FS_TMPFS_CHUNKSIZE)
+
 /* Redefine memory alloc function when using multi heap */
 
 #if CONFIG_KMM_NHEAPS > 1 && CONFIG_KMM_REGIONS > 1
@@ -158,6 +170,12 @@ struct tmpfs_directory_s {
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * The file data is held in CONFIG_FS_TMPFS_CHUNKSIZE chunks referenced by
+ * the chunk table, so growing a file never moves the data already written
+ * and never needs a contiguous region of the full file size.  A NULL entry
+ * is a hole that reads back as zeros.  Bytes of an allocated chunk beyond
+ * tfo_size are always zero.
  */
 
 struct tmpfs_file_s {
@@ -174,11 +192,10 @@ struct tmpfs_file_s {
 
 	uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
 	size_t   tfo_size;     /* Valid file size */
-	uint8_t  tfo_data[1];  /* File data starts here */
+	unsigned int tfo_nchunks;  /* Number of entries in tfo_chunks */
+	FAR uint8_t **tfo_chunks;  /* Chunk table (NULL entries are holes) */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
-
 /* This structure represents one instance of a TMPFS file system */
 
 struct tmpfs_s {
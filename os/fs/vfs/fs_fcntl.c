@@ -62,6 +62,7 @@
 #include <assert.h>
 
 #include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
 #include <tinyara/net/net.h>
 #include <tinyara/sched.h>
 #include <tinyara/cancelpt.h>
@@ -218,6 +219,29 @@ int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
 		err = ENOSYS;			/* Not implemented */
 		break;
 
+	case F_SETPIPE_SZ:
+	/* Change the capacity of the pipe referred to by fd to be at least arg
+	 * bytes (linux).
+	 */
+
+	case F_GETPIPE_SZ:
+		/* Return the capacity of the pipe referred to by fd (linux) */
+
+	{
+		if (cmd == F_SETPIPE_SZ) {
+			ret = file_ioctl(filep, PIPEIOC_SETSIZE, (unsigned long)va_arg(ap, int));
+		} else {
+			ret = file_ioctl(filep, PIPEIOC_GETSIZE, 0);
+		}
+
+		/* Only pipes and FIFOs support these commands */
+
+		if (ret < 0) {
+			err = (ret == -ENOTTY) ? EBADF : -ret;
+		}
+	}
+	break;
+
 	default:
 		err = EINVAL;
 		break;
@@ -77,8 +77,11 @@
  *
  * Description:
  *   Equivalent to the standard pread function except that is accepts a
- *   struct file instance instead of a file descriptor.  Currently used
- *   only by aio_read();
+ *   struct file instance instead of a file descriptor.  Used by the aio
+ *   workers and by splice().
+ *
+ * Returned Value:
+ *   The number of bytes read, or a negated errno value on failure.
  *
  ****************************************************************************/
 
@@ -87,7 +90,6 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes, off_t o
 	off_t savepos;
 	off_t pos;
 	ssize_t ret;
-	int errcode;
 
 	/* Perform the seek to the current position.  This will not move the
 	 * file pointer, but will return its current setting
@@ -97,7 +99,7 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes, off_t o
 	if (savepos == (off_t)-1) {
 		/* file_seek might fail if this if the media is not seekable */
 
-		return ERROR;
+		return (ssize_t)-get_errno();
 	}
 
 	/* Then seek to the correct position in the file */
@@ -106,16 +108,12 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes, off_t o
 	if (pos == (off_t)-1) {
 		/* This might fail is the offset is beyond the end of file */
 
-		return ERROR;
+		return (ssize_t)-get_errno();
 	}
 
 	/* Then perform the read operation */
 
 	ret = file_read(filep, buf, nbytes);
-	if (ret < 0) {
-		errcode = -ret;
-		ret = ERROR;
-	}
 
 	/* Restore the file position */
 
@@ -123,11 +121,9 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes, off_t o
 	if (pos == (off_t)-1 && ret >= 0) {
 		/* This really should not fail */
 
-		return ERROR;
-	}
-	if (ret == ERROR) {
-		set_errno(errcode);
+		return (ssize_t)-get_errno();
 	}
+
 	return ret;
 }
 
@@ -72,8 +72,11 @@
  *
  * Description:
  *   Equivalent to the standard pwrite function except that is accepts a
- *   struct file instance instead of a file descriptor.  Currently used
- *   only by aio_write();
+ *   struct file instance instead of a file descriptor.  Used by the aio
+ *   workers and by splice().
+ *
+ * Returned Value:
+ *   The number of bytes written, or a negated errno value on failure.
  *
  ****************************************************************************/
 
@@ -91,7 +94,7 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf, size_t nbytes,
 	if (savepos < 0) {
 		/* file_seek might fail if this if the media is not seekable */
 
-		return (ssize_t)savepos;
+		return (ssize_t)-get_errno();
 	}
 
 	/* Then seek to the correct position in the file */
@@ -100,7 +103,7 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf, size_t nbytes,
 	if (pos < 0) {
 		/* This might fail is the offset is beyond the end of file */
 
-		return (ssize_t)pos;
+		return (ssize_t)-get_errno();
 	}
 
 	/* Then perform the write operation */
@@ -113,7 +116,7 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf, size_t nbytes,
 	if (pos < 0 && ret >= 0) {
 		/* This really should not fail */
 
-		ret = (ssize_t)pos;
+		ret = (ssize_t)-get_errno();
 	}
 
 	return ret;
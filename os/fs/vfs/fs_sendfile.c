@@ -0,0 +1,440 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/vfs/fs_sendfile.c
+ *
+ * Kernel side of sendfile(): copy file data to a socket or another file
+ * without passing it through a user buffer.  Data that is memory mapped by
+ * its file system (romfs in XIP flash, single-chunk tmpfs files) is sent
+ * from where it lies; other files are read into one kernel buffer.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/cancelpt.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LWIP) && CONFIG_NSOCKET_DESCRIPTORS > 0
+#define SENDFILE_HAVE_SOCKETS 1
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a < b) ? a : b)
+#endif
+
+#ifndef CONFIG_LIB_SENDFILE_BUFSIZE
+#define CONFIG_LIB_SENDFILE_BUFSIZE 512
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Destination of the transfer */
+
+struct sendfile_out_s {
+	int fd;						/* Descriptor (used for sockets) */
+	FAR struct file *filep;		/* Open file, NULL for sockets */
+};
+
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+/* Completions of the send_zc() calls made for one mapped transfer */
+
+struct sendfile_zc_s {
+	sem_t sem;
+	int result;
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_write
+ *
+ * Description:
+ *   Write all of 'buffer' to the destination.
+ *
+ * Returned Value:
+ *   The number of bytes written.  A negated errno value is returned only if
+ *   nothing could be written.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_write(FAR struct sendfile_out_s *out, FAR const uint8_t *buffer, size_t len)
+{
+	size_t nwritten = 0;
+	ssize_t ret;
+
+	while (nwritten < len) {
+		if (out->filep == NULL) {
+#ifdef SENDFILE_HAVE_SOCKETS
+			ret = send(out->fd, buffer + nwritten, len - nwritten, 0);
+			if (ret < 0) {
+				ret = -get_errno();
+			}
+#else
+			ret = -EBADF;
+#endif
+		} else {
+			ret = file_write(out->filep, buffer + nwritten, len - nwritten);
+		}
+
+		if (ret < 0) {
+			/* Interruption is only an error if nothing was written */
+
+			if (ret == -EINTR && nwritten > 0) {
+				break;
+			}
+
+			return nwritten > 0 ? (ssize_t)nwritten : ret;
+		} else if (ret == 0) {
+			break;
+		}
+
+		nwritten += ret;
+	}
+
+	return nwritten;
+}
+
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+/****************************************************************************
+ * Name: sendfile_zc_done
+ *
+ * Description:
+ *   send_zc() completion, called from the network thread once lwIP no
+ *   longer references the data.
+ *
+ ****************************************************************************/
+
+static void sendfile_zc_done(FAR void *arg, int result)
+{
+	FAR struct sendfile_zc_s *zc = (FAR struct sendfile_zc_s *)arg;
+
+	if (result < 0 && zc->result == OK) {
+		zc->result = result;
+	}
+
+	sem_post(&zc->sem);
+}
+
+/****************************************************************************
+ * Name: sendfile_zerocopy
+ *
+ * Description:
+ *   Queue mapped file data on a TCP socket by reference, so that lwIP
+ *   builds PBUF_REF segments pointing at the file data instead of copying
+ *   it.  The call returns once the peer has acknowledged all of it: a
+ *   mapping is only guaranteed for as long as the file is open, and tmpfs
+ *   data may be rewritten as soon as this call returns.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_zerocopy(int sockfd, FAR const uint8_t *data, size_t len)
+{
+	struct sendfile_zc_s zc;
+	size_t nqueued = 0;
+	int npending = 0;
+	ssize_t ret = OK;
+
+	sem_init(&zc.sem, 0, 0);
+	sem_setprotocol(&zc.sem, SEM_PRIO_NONE);
+	zc.result = OK;
+
+	while (nqueued < len) {
+		ret = send_zc(sockfd, data + nqueued, len - nqueued, 0, sendfile_zc_done, &zc);
+		if (ret <= 0) {
+			ret = ret < 0 ? -get_errno() : OK;
+			break;
+		}
+
+		npending++;
+		nqueued += ret;
+	}
+
+	/* zc lives on this stack: wait for every completion, even if signaled */
+
+	while (npending > 0) {
+		if (sem_wait(&zc.sem) == OK) {
+			npending--;
+		}
+	}
+
+	sem_destroy(&zc.sem);
+
+	if (zc.result < 0) {
+		/* The connection went away, it is unknown what the peer has */
+
+		return zc.result;
+	}
+
+	return nqueued > 0 ? (ssize_t)nqueued : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: sendfile_mapped
+ *
+ * Description:
+ *   Transfer file data that the file system has mapped into memory.  For a
+ *   blocking TCP socket with CONFIG_NET_SOCKET_ZEROCOPY the data is not
+ *   copied at all, otherwise it is written from the mapping in one call.
+ *   Zero-copy waits for the peer to acknowledge the data, so non-blocking
+ *   sockets take the copying path, which only waits for buffer space.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_mapped(FAR struct sendfile_out_s *out, FAR const uint8_t *data, size_t len)
+{
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+	if (out->filep == NULL) {
+		socklen_t optlen = sizeof(int);
+		int oflags;
+		int type;
+
+		oflags = fcntl(out->fd, F_GETFL);
+		if (oflags >= 0 && (oflags & O_NONBLOCK) == 0 && getsockopt(out->fd, SOL_SOCKET, SO_TYPE, &type, &optlen) == OK && type == SOCK_STREAM) {
+			return sendfile_zerocopy(out->fd, data, len);
+		}
+	}
+#endif
+
+	return sendfile_write(out, data, len);
+}
+
+/****************************************************************************
+ * Name: sendfile_copy
+ *
+ * Description:
+ *   Transfer file data through a kernel buffer.  The input file is
+ *   positioned at the start of the transfer; on return its position is
+ *   undefined.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_copy(FAR struct sendfile_out_s *out, FAR struct file *infile, size_t count)
+{
+	FAR uint8_t *buffer;
+	size_t ntransferred = 0;
+	ssize_t nread;
+	ssize_t nwritten;
+	ssize_t ret = OK;
+
+	buffer = (FAR uint8_t *)kmm_malloc(CONFIG_LIB_SENDFILE_BUFSIZE);
+	if (buffer == NULL) {
+		return -ENOMEM;
+	}
+
+	while (ntransferred < count) {
+		nread = file_read(infile, buffer, MIN(count - ntransferred, CONFIG_LIB_SENDFILE_BUFSIZE));
+		if (nread <= 0) {
+			/* End of file, or an error that only counts if nothing moved */
+
+			ret = nread;
+			break;
+		}
+
+		nwritten = sendfile_write(out, buffer, nread);
+		if (nwritten < 0) {
+			ret = nwritten;
+			break;
+		}
+
+		ntransferred += nwritten;
+		if (nwritten < nread) {
+			break;
+		}
+	}
+
+	kmm_free(buffer);
+	return ntransferred > 0 ? (ssize_t)ntransferred : ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fs_sendfile
+ *
+ * Description:
+ *   Copy up to 'count' bytes from the file 'infd' to the socket or file
+ *   'outfd' inside the kernel.  This is the fast path of sendfile(): data
+ *   mapped into memory by its file system is sent from the mapping, by
+ *   reference where the network stack supports it, and other files are
+ *   read into a kernel buffer, which saves a pair of system calls and a
+ *   user copy per chunk.
+ *
+ * Input Parameters:
+ *   outfd  - A socket or file descriptor opened for writing
+ *   infd   - A file descriptor opened for reading
+ *   offset - Start position in 'infd', updated on return, or NULL to use
+ *            and update the file position of 'infd'
+ *   count  - The number of bytes to copy
+ *
+ * Returned Value:
+ *   The number of bytes written to 'outfd', or -1 with errno set.  ENOSYS
+ *   means that there is no fast path for 'infd' (a socket, for example) and
+ *   that nothing was transferred, so that the caller can fall back to
+ *   read() and write().
+ *
+ ****************************************************************************/
+
+ssize_t fs_sendfile(int outfd, int infd, FAR off_t *offset, size_t count)
+{
+	struct sendfile_out_s out;
+	FAR struct file *infile;
+	FAR uint8_t *mapped = NULL;
+	struct stat st;
+	off_t savepos = 0;
+	off_t pos;
+	ssize_t ret;
+
+	if ((unsigned int)infd >= CONFIG_NFILE_DESCRIPTORS) {
+		set_errno(ENOSYS);
+		return ERROR;
+	}
+
+	/* sendfile() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	ret = (ssize_t)fs_getfilep(infd, &infile);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	if ((infile->f_oflags & O_RDOK) == 0) {
+		ret = -EBADF;
+		goto errout;
+	}
+
+	out.fd = outfd;
+	out.filep = NULL;
+	if ((unsigned int)outfd < CONFIG_NFILE_DESCRIPTORS) {
+		ret = (ssize_t)fs_getfilep(outfd, &out.filep);
+		if (ret < 0) {
+			goto errout;
+		}
+	}
+#ifndef SENDFILE_HAVE_SOCKETS
+	else {
+		ret = -EBADF;
+		goto errout;
+	}
+#endif
+
+	if (offset != NULL) {
+		if (*offset < 0) {
+			ret = -EINVAL;
+			goto errout;
+		}
+
+		savepos = infile->f_pos;
+		pos = *offset;
+	} else {
+		pos = infile->f_pos;
+	}
+
+	if (count > SSIZE_MAX) {
+		count = SSIZE_MAX;
+	}
+
+	/* Only regular files are asked for a mapping: device drivers use
+	 * FIOC_MMAP for their own purposes.
+	 */
+
+	if (INODE_IS_MOUNTPT(infile->f_inode) &&
+		file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&mapped)) >= 0 && mapped != NULL &&
+		fstat(infd, &st) == OK) {
+		if (pos >= st.st_size) {
+			count = 0;
+		} else if (count > st.st_size - pos) {
+			count = st.st_size - pos;
+		}
+
+		ret = count > 0 ? sendfile_mapped(&out, mapped + pos, count) : 0;
+	} else {
+		if (file_seek(infile, pos, SEEK_SET) == (off_t)-1) {
+			ret = -get_errno();
+			goto errout;
+		}
+
+		ret = sendfile_copy(&out, infile, count);
+	}
+
+	/* The input position ends after the last byte written, or stays where
+	 * it was if an explicit offset was given.
+	 */
+
+	if (ret > 0) {
+		pos += ret;
+	}
+
+	if (offset != NULL) {
+		*offset = pos;
+		pos = savepos;
+	}
+
+	if (infile->f_pos != pos) {
+		(void)file_seek(infile, pos, SEEK_SET);
+	}
+
+	if (ret < 0) {
+		goto errout;
+	}
+
+	leave_cancellation_point();
+	return ret;
+
+errout:
+	set_errno(-ret);
+	leave_cancellation_point();
+	return ERROR;
+}
+
+#endif							/* CONFIG_NFILE_DESCRIPTORS > 0 */
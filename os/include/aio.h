@@ -60,6 +60,7 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <signal.h>
 #include <time.h>
 
@@ -130,6 +131,15 @@
 #define LIO_NOWAIT      0
 #define LIO_WAIT        1
 
+/* Non-standard completion notification.  With aio_sigevent.sigev_notify set
+ * to SIGEV_AIO_RING, the control block is posted to the struct aio_ring_s
+ * in aio_sigevent.sigev_value.sival_ptr when the I/O completes.  The
+ * caller collects completions with aio_ring_get(), without a signal
+ * handler or a call into the kernel.
+ */
+
+#define SIGEV_AIO_RING  3
+
 /****************************************************************************
  * Type Definitions
  ****************************************************************************/
@@ -157,6 +167,19 @@ struct aiocb {
 	FAR void *aio_priv;			/* Used by signal handlers */
 };
 
+/* Ring of completed control blocks, filled by the AIO workers and emptied
+ * by a single reader.  The counters run freely; 'ar_head - ar_tail' is the
+ * number of completions that have not been read.
+ */
+
+struct aio_ring_s {
+	FAR struct aiocb **ar_entries;	/* ar_size slots */
+	uint16_t ar_size;			/* Number of slots, a power of two */
+	volatile uint16_t ar_head;	/* Next slot to fill, written by the workers */
+	volatile uint16_t ar_tail;	/* Next slot to read, written by the reader */
+	volatile uint16_t ar_overflow;	/* Completions lost because the ring was full */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -181,6 +204,11 @@ int aio_suspend(FAR const struct aiocb *const list[], int nent, FAR const struct
 int aio_write(FAR struct aiocb *aiocbp);
 int lio_listio(int mode, FAR struct aiocb *const list[], int nent, FAR struct sigevent *sig);
 
+/* Non-standard polled completion ring, see SIGEV_AIO_RING */
+
+int aio_ring_init(FAR struct aio_ring_s *ring, FAR struct aiocb **entries, int nentries);
+FAR struct aiocb *aio_ring_get(FAR struct aio_ring_s *ring);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -66,6 +66,18 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/**
+ * @brief Running 16-bit CRC of a stream of data, see crc16_init()
+ */
+struct crc16_ctx_s {
+	uint16_t reg;				/* CRC register, not the CRC itself */
+	size_t len;				/* Number of bytes added so far */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -102,6 +114,44 @@ uint16_t crc16part(FAR const uint8_t *src, size_t len, uint16_t crc16val);
 
 uint16_t crc16(FAR const uint8_t *src, size_t len);
 
+/**
+ * @brief  Start the 16-bit CRC of a stream of data
+ *
+ * @details @b #include <crc16.h>
+ *   The stream is added with crc16_update() in as many parts as needed. crc16_final()
+ *   then returns the same value crc16() would return for the whole data.
+ * @param[out] ctx context of the stream
+ * @return none
+ * @since TizenRT v3.1
+ */
+
+void crc16_init(FAR struct crc16_ctx_s *ctx);
+
+/**
+ * @brief  Add the next part of a stream to its 16-bit CRC
+ *
+ * @details @b #include <crc16.h>
+ * @param[in,out] ctx context set up by crc16_init()
+ * @param[in] src next part of the stream
+ * @param[in] len length of the part
+ * @return none
+ * @since TizenRT v3.1
+ */
+
+void crc16_update(FAR struct crc16_ctx_s *ctx, FAR const uint8_t *src, size_t len);
+
+/**
+ * @brief  Return the 16-bit CRC of the stream added so far
+ *
+ * @details @b #include <crc16.h>
+ *   The stream may be continued with crc16_update() afterwards.
+ * @param[in] ctx context set up by crc16_init()
+ * @return The 16-bit CRC of the stream.
+ * @since TizenRT v3.1
+ */
+
+uint16_t crc16_final(FAR const struct crc16_ctx_s *ctx);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
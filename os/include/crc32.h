@@ -66,6 +66,18 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/**
+ * @brief Running 32-bit CRC of a stream of data, see crc32_init()
+ */
+struct crc32_ctx_s {
+	uint32_t reg;				/* CRC register, not the CRC itself */
+	size_t len;				/* Number of bytes added so far */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -102,6 +114,59 @@ uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val);
 
 uint32_t crc32(FAR const uint8_t *src, size_t len);
 
+/**
+ * @brief  Return the 32-bit CRC of two buffers laid end to end, from the CRCs of each
+ *
+ * @details @b #include <crc32.h>
+ *   This lets parts of data which are not processed in order be checked as a whole:
+ *   crc32combine(crc32(a, len1), crc32(b, len2), len2) equals the crc32 of a followed by b.
+ * @param[in] crc1 crc32 of the first buffer
+ * @param[in] crc2 crc32 of the second buffer
+ * @param[in] len2 length of the second buffer
+ * @return The 32-bit CRC of both buffers.
+ * @since TizenRT v3.1
+ */
+
+uint32_t crc32combine(uint32_t crc1, uint32_t crc2, size_t len2);
+
+/**
+ * @brief  Start the 32-bit CRC of a stream of data
+ *
+ * @details @b #include <crc32.h>
+ *   The stream is added with crc32_update() in as many parts as needed. crc32_final()
+ *   then returns the same value crc32() would return for the whole data.
+ * @param[out] ctx context of the stream
+ * @return none
+ * @since TizenRT v3.1
+ */
+
+void crc32_init(FAR struct crc32_ctx_s *ctx);
+
+/**
+ * @brief  Add the next part of a stream to its 32-bit CRC
+ *
+ * @details @b #include <crc32.h>
+ * @param[in,out] ctx context set up by crc32_init()
+ * @param[in] src next part of the stream
+ * @param[in] len length of the part
+ * @return none
+ * @since TizenRT v3.1
+ */
+
+void crc32_update(FAR struct crc32_ctx_s *ctx, FAR const uint8_t *src, size_t len);
+
+/**
+ * @brief  Return the 32-bit CRC of the stream added so far
+ *
+ * @details @b #include <crc32.h>
+ *   The stream may be continued with crc32_update() afterwards.
+ * @param[in] ctx context set up by crc32_init()
+ * @return The 32-bit CRC of the stream.
+ * @since TizenRT v3.1
+ */
+
+uint32_t crc32_final(FAR const struct crc32_ctx_s *ctx);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -70,6 +70,18 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/**
+ * @brief Running 8-bit CRC of a stream of data, see crc8_init()
+ */
+struct crc8_ctx_s {
+	uint8_t reg;				/* CRC register, not the CRC itself */
+	size_t len;				/* Number of bytes added so far */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -106,6 +118,44 @@ uint8_t crc8part(FAR const uint8_t *src, size_t len, uint8_t crc8val);
 
 uint8_t crc8(FAR const uint8_t *src, size_t len);
 
+/**
+ * @brief  Start the 8-bit CRC of a stream of data
+ *
+ * @details @b #include <crc8.h>
+ *   The stream is added with crc8_update() in as many parts as needed. crc8_final()
+ *   then returns the same value crc8() would return for the whole data.
+ * @param[out] ctx context of the stream
+ * @return none
+ * @since TizenRT v3.1
+ */
+
+void crc8_init(FAR struct crc8_ctx_s *ctx);
+
+/**
+ * @brief  Add the next part of a stream to its 8-bit CRC
+ *
+ * @details @b #include <crc8.h>
+ * @param[in,out] ctx context set up by crc8_init()
+ * @param[in] src next part of the stream
+ * @param[in] len length of the part
+ * @return none
+ * @since TizenRT v3.1
+ */
+
+void crc8_update(FAR struct crc8_ctx_s *ctx, FAR const uint8_t *src, size_t len);
+
+/**
+ * @brief  Return the 8-bit CRC of the stream added so far
+ *
+ * @details @b #include <crc8.h>
+ *   The stream may be continued with crc8_update() afterwards.
+ * @param[in] ctx context set up by crc8_init()
+ * @return The 8-bit CRC of the stream.
+ * @since TizenRT v3.1
+ */
+
+uint8_t crc8_final(FAR const struct crc8_ctx_s *ctx);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
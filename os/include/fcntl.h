@@ -135,6 +135,8 @@
 #define F_SETLKW    12			/* Like F_SETLK, but wait for lock to become available */
 #define F_SETOWN    13			/* Set pid that will receive SIGIO and SIGURG signals for fd */
 #define F_SETSIG    14			/* Set the signal to be sent */
+#define F_SETPIPE_SZ 15			/* Set the buffer size of a pipe (linux) */
+#define F_GETPIPE_SZ 16			/* Get the buffer size of a pipe (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -142,6 +144,12 @@
 #define F_WRLCK     1			/* Take out a write lease */
 #define F_UNLCK     2			/* Remove a lease */
 
+/* Flags for splice() and tee() (linux) */
+
+#define SPLICE_F_MOVE     (1 << 0)	/* Hint only, pages are never moved */
+#define SPLICE_F_NONBLOCK (1 << 1)	/* Do not block on the pipe(s) */
+#define SPLICE_F_MORE     (1 << 2)	/* Hint only, more data will follow */
+
 /* close-on-exec flag for F_GETRL and F_SETFL */
 
 #define FD_CLOEXEC  1
@@ -211,6 +219,29 @@ int open(const char *path, int oflag, ...);
  * @since TizenRT v1.0
  */
 int fcntl(int fd, int cmd, ...);
+#if defined(CONFIG_PIPES)
+/**
+ * @ingroup FCNTL_KERNEL
+ * @brief move data between a pipe and another file descriptor
+ * @details @b #include <fcntl.h> \n
+ * SYSTEM CALL API \n
+ * Linux API. One of fd_in or fd_out must be a pipe. The data is moved
+ * directly between the pipe buffer and the other file or socket without an
+ * intermediate user buffer.
+ * @since TizenRT v3.1
+ */
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out, size_t len, unsigned int flags);
+/**
+ * @ingroup FCNTL_KERNEL
+ * @brief duplicate pipe content
+ * @details @b #include <fcntl.h> \n
+ * SYSTEM CALL API \n
+ * Linux API. Copies up to len bytes from pipe fd_in to pipe fd_out without
+ * consuming them from fd_in.
+ * @since TizenRT v3.1
+ */
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -91,11 +91,11 @@ extern "C" {
  *
  * Description:
  *   sendfile() copies data between one file descriptor and another.
- *   sendfile() basically just wraps a sequence of reads() and writes()
- *   to perform a copy.  It serves a purpose in systems where there is
- *   a penalty for copies to between user and kernal space, but really
- *   nothing in TinyAra but provide some Linux compatible (and adding
- *   another 'almost standard' interface).
+ *   If 'infd' is a file the copy is done inside the kernel: data that its
+ *   file system maps into memory (romfs in XIP flash) is sent from where it
+ *   lies, by reference on TCP sockets with CONFIG_NET_SOCKET_ZEROCOPY, and
+ *   other files go through one kernel buffer.  Otherwise sendfile() wraps
+ *   a sequence of reads() and writes().
  *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
@@ -70,6 +70,7 @@
 #include <tinyara/config.h>
 #include <sys/types.h>
 #include <sys/uio.h>
+#include <time.h>
 
 #ifdef CONFIG_NET_LWIP
 #include "lwip/sockets.h"
@@ -152,6 +153,13 @@ struct msghdr {
 	int msg_flags;                 /* flags on received message */
 };
 
+/* One message of recvmmsg() and sendmmsg() */
+
+struct mmsghdr {
+	struct msghdr msg_hdr;         /* message header */
+	unsigned int msg_len;          /* number of bytes transmitted */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -170,6 +178,23 @@ struct msghdr {
 */
 int socket(int domain, int type, int protocol);
 
+/**
+* @brief creates a pair of connected sockets
+*
+* @details @b #include <sys/socket.h>\n
+* SYSTEM CALL API\n
+* POSIX API (refer to : http://pubs.opengroup.org/onlinepubs/9699919799/)\n
+* Only AF_UNIX is supported, with SOCK_STREAM or SOCK_DGRAM. The two sockets
+* exchange data through in-memory buffers.
+* @param[in] domain the communications domain, AF_UNIX
+* @param[in] type  the type of the sockets to be created
+* @param[in] protocol the protocol to be used with the sockets
+* @param[out] sv the two socket descriptors
+* @return On success, 0 is returned. On failure, -1 is returned.
+* @since TizenRT v3.1
+*/
+int socketpair(int domain, int type, int protocol, int sv[2]);
+
 /**
 * @brief  assigns an address to an unnamed socket.
 *
@@ -373,6 +398,104 @@ int getpeername(int s, struct sockaddr *name, socklen_t *namelen);
 ssize_t recvmsg(int sockfd, struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, struct msghdr *msg, int flags);
 
+/**
+* @brief   receive multiple messages from a socket
+*
+* @details @b #include <sys/socket.h>\n
+* SYSTEM CALL API\n
+* Receives up to vlen datagrams with a single call, filling msg_hdr and
+* msg_len of each entry of msgvec. Only datagram sockets are supported.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[inout] msgvec array of messages to be filled
+* @param[in] vlen the number of entries in msgvec
+* @param[in] flags the flags of recvmsg(), plus MSG_WAITFORONE to only wait for the first message
+* @param[in] timeout NULL, or the time after which no more messages are received (checked after each message)
+* @return On success, returns the number of messages received, On failure, -1 is returned.
+* @since TizenRT v3.1
+*/
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen, int flags, FAR struct timespec *timeout);
+
+/**
+* @brief   send multiple messages on a socket
+*
+* @details @b #include <sys/socket.h>\n
+* SYSTEM CALL API\n
+* Sends up to vlen messages with a single call, storing the number of bytes
+* sent in msg_len of each entry of msgvec. Datagrams are handed to the
+* network stack in batches.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[inout] msgvec array of messages to send
+* @param[in] vlen the number of entries in msgvec
+* @param[in] flags the flags of sendmsg()
+* @return On success, returns the number of messages sent, On failure, -1 is returned.
+* @since TizenRT v3.1
+*/
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen, int flags);
+
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+/**
+* @brief  completion callback of send_zc()
+*
+* @details Called once the stack no longer references the buffer passed to
+* send_zc(). For TCP this happens when the peer has acknowledged all of the
+* data, from the network thread, so the callback must not block.
+* @param[in] arg the argument given to send_zc()
+* @param[in] result 0 on success or a negative errno value if the connection
+* was reset or closed before all of the data was acknowledged
+*/
+typedef void (*sock_zc_done_t)(FAR void *arg, int result);
+
+/**
+* @brief   receive data from a socket without copying it
+*
+* @details @b #include <sys/socket.h>\n
+* The network buffers holding the received data are lent to the caller: iov
+* is filled with pointers into them and *zcbuf with a handle which must be
+* given back with recv_zc_release(). Held buffers are taken from the network
+* packet pool, so they should be released as soon as possible. A datagram
+* which does not fit into *iovcnt entries is truncated.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[out] iov array to be filled with the location of the data
+* @param[inout] iovcnt on input the number of entries in iov, on output the number of entries used
+* @param[out] zcbuf handle of the lent buffers, NULL if none were lent
+* @param[in] flags MSG_DONTWAIT and MSG_PEEK are supported
+* @return On success, returns the number of bytes described by iov, 0 at end of stream, On failure, -1 is returned.
+* @since TizenRT v3.1
+*/
+ssize_t recv_zc(int sockfd, FAR struct iovec *iov, FAR int *iovcnt, FAR void **zcbuf, int flags);
+
+/**
+* @brief   give back the buffers lent by recv_zc()
+*
+* @details @b #include <sys/socket.h>\n
+* @param[in] zcbuf handle returned by recv_zc()
+* @since TizenRT v3.1
+*/
+void recv_zc_release(FAR void *zcbuf);
+
+/**
+* @brief   send data on a socket without copying it
+*
+* @details @b #include <sys/socket.h>\n
+* The stack references buf instead of copying it, so buf must stay valid and
+* unchanged until done is called. done is called exactly once if send_zc()
+* succeeds and never if it fails. Closing a TCP socket which still has
+* zero-copy data in flight resets the connection.\n
+* There is no destination argument, so only connected TCP and UDP sockets
+* are supported: a UDP socket without a peer set by connect() fails with
+* EDESTADDRREQ, a raw socket with EOPNOTSUPP.
+* @param[in] sockfd the file descriptor associated with the socket.
+* @param[in] buf  Pointer to the buffer containing the message to send.
+* @param[in] len the length of the message in bytes.
+* @param[in] flags MSG_DONTWAIT and MSG_MORE are supported
+* @param[in] done completion callback
+* @param[in] arg argument of the completion callback
+* @return On success, returns the number of bytes queued, On failure, -1 is returned.
+* @since TizenRT v3.1
+*/
+ssize_t send_zc(int sockfd, FAR const void *buf, size_t len, int flags, sock_zc_done_t done, FAR void *arg);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -326,7 +326,9 @@
 #define SYS_opendir                    (__SYS_mmap + 2)
 #if defined(CONFIG_PIPES)
 #define SYS_pipe                       (__SYS_mmap + 3)
-#define __SYS_readdir                  (__SYS_mmap + 4)
+#define SYS_splice                     (__SYS_mmap + 4)
+#define SYS_tee                        (__SYS_mmap + 5)
+#define __SYS_readdir                  (__SYS_mmap + 6)
 #else
 #define __SYS_readdir                  (__SYS_mmap + 3)
 #endif
@@ -465,12 +467,15 @@
 #define SYS_recv                       (__SYS_network + 7)
 #define SYS_recvfrom                   (__SYS_network + 8)
 #define SYS_recvmsg                    (__SYS_network + 9)
-#define SYS_send                       (__SYS_network + 10)
-#define SYS_sendto                     (__SYS_network + 11)
-#define SYS_setsockopt                 (__SYS_network + 12)
-#define SYS_shutdown                   (__SYS_network + 13)
-#define SYS_socket                     (__SYS_network + 14)
-#define __SYS_prctl                    (__SYS_network + 15)
+#define SYS_recvmmsg                   (__SYS_network + 10)
+#define SYS_send                       (__SYS_network + 11)
+#define SYS_sendmmsg                   (__SYS_network + 12)
+#define SYS_sendto                     (__SYS_network + 13)
+#define SYS_setsockopt                 (__SYS_network + 14)
+#define SYS_shutdown                   (__SYS_network + 15)
+#define SYS_socket                     (__SYS_network + 16)
+#define SYS_socketpair                 (__SYS_network + 17)
+#define __SYS_prctl                    (__SYS_network + 18)
 #else
 #define __SYS_prctl                    __SYS_network
 #endif
@@ -479,7 +484,16 @@
 
 #define SYS_fin_wait                   SYS_prctl + 1
 
+/* System calls added later are appended here, so that the numbers of the
+ * existing ones do not change.
+ */
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+#define SYS_fs_sendfile                (SYS_fin_wait + 1)
+#define SYS_maxsyscall                 (SYS_fin_wait + 2)
+#else
 #define SYS_maxsyscall                 (SYS_fin_wait + 1)
+#endif
 
 /* Note that the reported number of system calls does *NOT* include the
  * architecture-specific system calls.  If the "real" total is required,
@@ -1655,6 +1655,24 @@ int up_timer_cancel(FAR struct timespec *ts);
 int up_timer_start(FAR const struct timespec *ts);
 #endif
 
+/****************************************************************************
+ * Name: up_crc32part
+ *
+ * Description:
+ *   Continue a 32-bit CRC over 'len' bytes of 'src' with the CRC unit of the
+ *   chip.  The result must equal the one of crc32part(): reflected
+ *   polynomial 0xedb88320, with 'crc32val' and the result inverted.  The
+ *   buffer may have any alignment and length.
+ *
+ *   Provided by the architecture when CONFIG_ARCH_CRC32 is selected, and
+ *   called from crc32part() in libc.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_CRC32
+uint32_t up_crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val);
+#endif
+
 /****************************************************************************
  * Name: up_romgetc
  *
@@ -25,6 +25,7 @@
 
 #include <tinyara/config.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <limits.h>
 
 #include <tinyara/fs/fs.h>
@@ -159,11 +160,22 @@ struct kernel_binary_header_s {
 } __attribute__((__packed__));
 typedef struct kernel_binary_header_s kernel_binary_header_t;
 
+/* Time spent in each phase of the last load of a user binary, in microseconds */
+struct binary_load_time_s {
+	uint32_t header;			/* Reading and checking the binary header */
+	uint32_t load;				/* Reading the ELF and its sections into memory */
+	uint32_t bind;				/* Symbol binding and relocation */
+	uint32_t verify;			/* Completing and checking the CRC of the binary */
+	uint32_t total;				/* From reading the header until the binary runs */
+};
+typedef struct binary_load_time_s binary_load_time_t;
+
 /* The structure of binary update information for kernel or user binaries */
 struct binary_update_info_s {
 	int available_size;
 	char name[BIN_NAME_MAX];
 	uint32_t version;
+	binary_load_time_t load_time;	/* Zero for the kernel */
 };
 typedef struct binary_update_info_s binary_update_info_t;
 
@@ -180,6 +192,12 @@ struct load_attr_s {
 #ifdef CONFIG_OPTIMIZE_APP_RELOAD_TIME
 	void *binp;			/* Binary info pointer */
 #endif
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+	bool crc_check;				/* The loader verifies the CRC while it reads the binary */
+	uint32_t crc_seed;			/* crc32 of the header part covered by crc_hash */
+	uint32_t crc_hash;			/* Expected crc32 from the binary header */
+#endif
+	binary_load_time_t load_time;	/* Filled in by the loader */
 };
 typedef struct load_attr_s load_attr_t;
 
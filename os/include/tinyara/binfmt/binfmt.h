@@ -185,6 +185,12 @@ struct binary_s {
 #else
 	char *bin_name;                 /* Name of binary */
 #endif
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+	bool crc_check;                 /* Verify the CRC while loading, see load_attr_s */
+	uint32_t crc_seed;
+	uint32_t crc_hash;
+#endif
+	binary_load_time_t load_time;   /* Load, bind and verify time reported by the loader */
 #endif
 
 	/* Unload module callback */
@@ -107,6 +107,16 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+/* A part of the ELF file which has been read, with its CRC32 */
+
+struct elf_crcrange_s {
+	off_t start;				/* Offset of the range in the ELF file */
+	size_t size;				/* Number of bytes */
+	uint32_t crc;				/* crc32 of those bytes */
+};
+#endif
+
 /* This struct provides a description of the currently loaded instantiation
  * of an ELF binary.
  */
@@ -175,6 +185,18 @@ struct elf_loadinfo_s {
 	uintptr_t symtab;			/* Copy of symbol table */
 	uintptr_t reltab;			/* Copy of relocation table */
 	uintptr_t strtab;			/* Copy of string table */
+
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+	/* CRC computed on the fly.  crcranges[] are sorted, disjoint and never
+	 * adjacent; elf_verifycrc() reads what is missing between them.
+	 */
+
+	bool crc_check;				/* Track the CRC of data read from the file */
+	uint8_t ncrcranges;			/* Number of valid entries in crcranges[] */
+	uint32_t crc_seed;			/* crc32 of what precedes the ELF in the file */
+	uint32_t crc_hash;			/* Expected crc32 of the seed part and the ELF */
+	struct elf_crcrange_s crcranges[CONFIG_ELF_CRC_RANGES];
+#endif
 };
 
 /****************************************************************************
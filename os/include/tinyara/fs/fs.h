@@ -890,8 +890,11 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes);
  *
  * Description:
  *   Equivalent to the standard pread function except that is accepts a
- *   struct file instance instead of a file descriptor.  Currently used
- *   only by aio_read();
+ *   struct file instance instead of a file descriptor.  Used by the aio
+ *   workers and by splice().
+ *
+ * Returned Value:
+ *   The number of bytes read, or a negated errno value on failure.
  *
  ****************************************************************************/
 
@@ -905,8 +908,11 @@ ssize_t file_pread(FAR struct file *filep, FAR void *buf, size_t nbytes, off_t o
  *
  * Description:
  *   Equivalent to the standard pwrite function except that is accepts a
- *   struct file instance instead of a file descriptor.  Currently used
- *   only by aio_write();
+ *   struct file instance instead of a file descriptor.  Used by the aio
+ *   workers and by splice().
+ *
+ * Returned Value:
+ *   The number of bytes written, or a negated errno value on failure.
  *
  ****************************************************************************/
 
@@ -929,6 +935,22 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf, size_t nbytes,
 off_t file_seek(FAR struct file *filep, off_t offset, int whence);
 #endif
 
+/* fs/fs_sendfile.c *********************************************************/
+/****************************************************************************
+ * Name: fs_sendfile
+ *
+ * Description:
+ *   The in-kernel part of sendfile().  Copies file data to a socket or file
+ *   without a user buffer, sending memory mapped file data from where it
+ *   lies.  Fails with ENOSYS, having transferred nothing, if 'infd' is not
+ *   a file so that sendfile() can fall back to read() and write().
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t fs_sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
+#endif
+
 /* fs/fs_fsync.c ************************************************************/
 /****************************************************************************
  * Name: file_fsync
@@ -246,6 +246,11 @@
 										 *		to reveal physical sector.
 										 * OUT: Physical sector number align with
 										 *		logical sector number */
+#define BIOC_FLUSH      _BIOC(0x000C)	/* Write back any data cached above the
+										 * block device (e.g. in the BCH layer)
+										 * IN:  None
+										 * OUT: None (ioctl return value provides
+										 *      success/failure indication). */
 #define BIOC_DEBUGCMD   _BIOC(0x00FF)	/* Send driver specific debug command /
 										 * data to the block device.
 										 * IN:  Pointer to a struct defined for
@@ -354,6 +359,13 @@
 											 *       (default)
 											 *     1=fre when empty
 											 * OUT: None */
+#define PIPEIOC_SETSIZE    _PIPEIOC(0x0002)	/* Resize the pipe buffer
+											 * IN: unsigned long integer
+											 *     bytes the pipe can hold
+											 * OUT: New size or negated errno */
+#define PIPEIOC_GETSIZE    _PIPEIOC(0x0003)	/* Get the pipe buffer size
+											 * IN: None
+											 * OUT: Bytes the pipe can hold */
 /* RTC driver ioctl definitions *********************************************/
 /* (see include/tinyara/rtc.h */
 
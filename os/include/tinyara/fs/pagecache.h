@@ -0,0 +1,189 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/fs/pagecache.h
+ *
+ * Page cache shared by the file systems mounted on block devices.  A file
+ * system attaches its device once per mount and then reads the device
+ * through the cache.  Pages are the unit in which the file system addresses
+ * the device: hardware sectors for romfs, logical sectors for smartfs.
+ * All volumes share one LRU list bounded by CONFIG_FS_PAGECACHE_SIZE bytes,
+ * which the heap also shrinks when an allocation fails.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_FS_PAGECACHE_H
+#define __INCLUDE_FS_PAGECACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <tinyara/fs/fs.h>
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* How the cache reads pages that it does not hold.  Without these
+ * operations, pages are sectors read with the read method of the block
+ * driver.
+ */
+
+struct pagecache_ops_s {
+	/* Read 'npages' consecutive pages of 'pagesize' bytes into 'buffer'.
+	 * Returns the number of pages read or a negated errno value.
+	 */
+
+	CODE ssize_t (*read)(FAR struct inode *blkdriver, FAR uint8_t *buffer, size_t page, unsigned int npages, uint16_t pagesize);
+};
+
+/* One attached device, opaque to the file systems */
+
+struct pagecache_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: pagecache_attach
+ *
+ * Description:
+ *   Start caching the pages of a block device.  Attaching a device that is
+ *   already attached, e.g. by a second smartfs root, returns the same
+ *   volume with one more reference.
+ *
+ * Input Parameters:
+ *   blkdriver - The block driver inode, the key of the volume
+ *   fstype    - The file system, shown in /proc/fs/pagecache
+ *   pagesize  - Bytes per page
+ *   npages    - Pages on the device; read-ahead stops there
+ *   readahead - true if the pages of a file are consecutive on the device,
+ *               so that sequential reads may prefetch the next pages
+ *   ops       - How to read pages, or NULL to use the block driver
+ *
+ * Returned Value:
+ *   The volume, or NULL if it could not be allocated.  The file system
+ *   then reads the device directly.
+ *
+ ****************************************************************************/
+
+EXTERN FAR struct pagecache_s *pagecache_attach(FAR struct inode *blkdriver, FAR const char *fstype, uint16_t pagesize, size_t npages, bool readahead, FAR const struct pagecache_ops_s *ops);
+
+/****************************************************************************
+ * Name: pagecache_detach
+ *
+ * Description:
+ *   Drop a reference taken by pagecache_attach().  The last one releases
+ *   the cached pages of the volume.
+ *
+ ****************************************************************************/
+
+EXTERN void pagecache_detach(FAR struct pagecache_s *pc);
+
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read 'npages' whole pages, from the cache where possible.  Pages that
+ *   are missing are read from the device and added to the cache.
+ *
+ * Returned Value:
+ *   OK, or a negated errno value if the device could not be read.
+ *
+ ****************************************************************************/
+
+EXTERN int pagecache_read(FAR struct pagecache_s *pc, FAR uint8_t *buffer, size_t page, unsigned int npages);
+
+/****************************************************************************
+ * Name: pagecache_readpart
+ *
+ * Description:
+ *   Read 'count' bytes at 'offset' within one page.  A missing page is
+ *   read whole and added to the cache.
+ *
+ * Returned Value:
+ *   'count', or a negated errno value.  -ENOMEM means that the page could
+ *   not be cached; the caller should then read the device directly.
+ *
+ ****************************************************************************/
+
+EXTERN ssize_t pagecache_readpart(FAR struct pagecache_s *pc, FAR uint8_t *buffer, size_t page, size_t offset, size_t count);
+
+/****************************************************************************
+ * Name: pagecache_update
+ *
+ * Description:
+ *   Record that 'count' bytes at 'offset' within 'page' were written to the
+ *   device.  A cached copy of the page is updated; a page written whole is
+ *   added to the cache, so that data just written reads back from memory.
+ *
+ ****************************************************************************/
+
+EXTERN void pagecache_update(FAR struct pagecache_s *pc, FAR const uint8_t *buffer, size_t page, size_t offset, size_t count);
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Forget the cached copies of 'npages' pages starting with 'page', e.g.
+ *   when they are freed or when a write to them failed.
+ *
+ ****************************************************************************/
+
+EXTERN void pagecache_invalidate(FAR struct pagecache_s *pc, size_t page, size_t npages);
+
+/****************************************************************************
+ * Name: pagecache_shrink
+ *
+ * Description:
+ *   Release least recently used pages of all volumes until at least
+ *   'nbytes' bytes were freed or the cache is empty.  Does nothing if the
+ *   cache is in use by the caller or another thread.
+ *
+ * Returned Value:
+ *   The number of bytes freed.
+ *
+ ****************************************************************************/
+
+EXTERN size_t pagecache_shrink(size_t nbytes);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* CONFIG_FS_PAGECACHE */
+#endif							/* __INCLUDE_FS_PAGECACHE_H */
@@ -660,6 +660,25 @@ struct mm_heap_s *kmm_get_heap(void);
 
 void mm_shrinkchunk(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node, size_t size);
 
+/* Functions contained in mm_reclaim.c **************************************/
+
+#ifdef CONFIG_MM_RECLAIM
+/* A cache that can give memory back when an allocation fails registers one
+ * of these.  'reclaim' frees at least 'size' bytes if it can and returns the
+ * number of bytes it freed.  It runs inside malloc() of the failing caller,
+ * so it may free memory but must not wait for a lock that such a caller
+ * could hold.
+ */
+
+struct mm_reclaim_s {
+	FAR struct mm_reclaim_s *flink;
+	CODE size_t (*reclaim)(size_t size);
+};
+
+void mm_register_reclaim(FAR struct mm_reclaim_s *reclaim);
+size_t mm_reclaim(size_t size);
+#endif
+
 /* Functions contained in mm_addfreechunk.c *********************************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
@@ -60,6 +60,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 #include <tinyara/wqueue.h>
 
@@ -69,6 +70,14 @@
  * Pre-processor Definitions
  **********************************************************************/
 
+#ifndef CONFIG_DRVR_WREXTENTS
+#define CONFIG_DRVR_WREXTENTS 1
+#endif
+
+#ifndef CONFIG_DRVR_READAHEAD_STREAMS
+#define CONFIG_DRVR_READAHEAD_STREAMS 1
+#endif
+
 /**********************************************************************
  * Public Types
  **********************************************************************/
@@ -81,6 +90,46 @@
 typedef ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer, off_t startblock, size_t nblocks);
 typedef ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
 
+/* One extent of the write buffer.  An extent holds a run of consecutive
+ * dirty blocks.  Extents never overlap unless one of them is being
+ * written back.
+ */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+struct rwb_extent_s {
+	FAR uint8_t *buffer;		/* This extent's part of the write buffer */
+	off_t blockstart;			/* First block in the extent */
+	uint16_t nblocks;			/* Number of blocks in the extent */
+	bool flushing;				/* true: Being written back to the media */
+};
+#endif
+
+/* One read-ahead stream.  Each stream caches a window of the media so that
+ * several interleaved sequential readers do not evict each other.
+ */
+
+#ifdef CONFIG_DRVR_READAHEAD
+struct rwb_rhstream_s {
+	FAR uint8_t *buffer;		/* This stream's part of the read-ahead buffer */
+	off_t blockstart;			/* First block in the stream buffer */
+	uint16_t nblocks;			/* Number of blocks in the stream buffer */
+	uint32_t lru;				/* Access stamp used to select a stream to reload */
+};
+#endif
+
+/* Buffering statistics, see rwb_getstats() */
+
+struct rwb_stats_s {
+	uint32_t wrblocks;			/* Blocks passed to rwb_write() */
+	uint32_t flushes;			/* Write-back passes */
+	uint32_t syncflushes;		/* Write-back passes run in a writer's context */
+	uint32_t flushblocks;		/* Blocks written back to the media */
+	uint32_t flushticks;		/* Clock ticks spent in write-back passes */
+	uint32_t maxflushticks;		/* Longest single write-back pass in ticks */
+	uint32_t rhhits;			/* Read requests satisfied from read-ahead */
+	uint32_t rhreloads;			/* Read-ahead stream reloads */
+};
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -150,11 +199,12 @@ struct rwbuffer_s {
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
 	sem_t wrsem;				/* Enforces exclusive access to the write buffer */
+	sem_t flsem;				/* Serializes write-back to the media */
 	struct work_s work;			/* Delayed work to flush buffer after a delay with no activity */
 	uint8_t *wrbuffer;			/* Allocated write buffer */
-	uint16_t wrnblocks;			/* Number of blocks in write buffer */
-	off_t wrblockstart;			/* First block in write buffer */
-	off_t wrexpectedblock;		/* Next block expected */
+	uint8_t wrnextents;			/* Number of extents in use for this buffer */
+	uint16_t extmaxblocks;		/* Capacity of one extent in blocks */
+	struct rwb_extent_s wrextent[CONFIG_DRVR_WREXTENTS];
 #endif
 
 	/* This is the state of the read-ahead buffering */
@@ -162,8 +212,17 @@ struct rwbuffer_s {
 #ifdef CONFIG_DRVR_READAHEAD
 	sem_t rhsem;				/* Enforces exclusive access to the write buffer */
 	uint8_t *rhbuffer;			/* Allocated read-ahead buffer */
-	uint16_t rhnblocks;			/* Number of blocks in read-ahead buffer */
-	off_t rhblockstart;			/* First block in read-ahead buffer */
+	uint8_t rhnstreams;			/* Number of read-ahead streams in use */
+	uint16_t rhstreamblocks;	/* Capacity of one stream in blocks */
+	uint32_t rhstamp;			/* Next read-ahead access stamp */
+	struct rwb_rhstream_s rhstream[CONFIG_DRVR_READAHEAD_STREAMS];
+#endif
+
+	struct rwb_stats_s stats;	/* Buffering statistics */
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_RWBUFFER)
+	FAR struct rwbuffer_s *flink;	/* Next buffer registered with procfs */
+	int devno;					/* Buffer number shown in procfs */
 #endif
 };
 
@@ -193,6 +252,21 @@ EXTERN "C" {
 	ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount, FAR uint8_t *rdbuffer);
 	ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock, size_t blockcount, FAR const uint8_t *wrbuffer);
 
+	/* Write all buffered data to the media and wait for it to complete */
+
+	int rwb_flush(FAR struct rwbuffer_s *rwb);
+
+	/* Buffering statistics */
+
+	void rwb_getstats(FAR struct rwbuffer_s *rwb, FAR struct rwb_stats_s *stats);
+
+	/* Listing in /proc/rwbuffer, done by rwb_initialize()/rwb_uninitialize() */
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_RWBUFFER)
+	void rwb_procfs_register(FAR struct rwbuffer_s *rwb);
+	void rwb_procfs_unregister(FAR struct rwbuffer_s *rwb);
+#endif
+
 	/* Character oriented transfers */
 
 #ifdef CONFIG_DRVR_READBYTES
@@ -224,6 +224,7 @@ void binary_manager_get_info_with_name(int requester_pid, char *bin_name)
 					response_msg.data.available_size = size;
 					strncpy(response_msg.data.name, BIN_NAME(bin_idx) , BIN_NAME_MAX);
 					response_msg.data.version = (double)BIN_LOADVER(bin_idx);
+					response_msg.data.load_time = BIN_LOAD_ATTR(bin_idx).load_time;
 				}
 				break;
 			}
@@ -287,6 +288,7 @@ void binary_manager_get_info_all(int requester_pid)
 			response_msg.data.bin_info[result_idx].available_size = size;
 			strncpy(response_msg.data.bin_info[result_idx].name, BIN_NAME(bin_idx) , BIN_NAME_MAX);
 			response_msg.data.bin_info[result_idx].version = (double)BIN_LOADVER(bin_idx);
+			response_msg.data.bin_info[result_idx].load_time = BIN_LOAD_ATTR(bin_idx).load_time;
 			result_idx++;
 		}
 	}
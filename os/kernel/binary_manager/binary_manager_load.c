@@ -36,6 +36,7 @@
 #include <sys/types.h>
 
 #include <tinyara/irq.h>
+#include <tinyara/clock.h>
 #include <tinyara/mm/mm.h>
 #include <tinyara/sched.h>
 #include <tinyara/init.h>
@@ -44,6 +45,9 @@
 #ifdef CONFIG_OPTIMIZE_APP_RELOAD_TIME
 #include <tinyara/binfmt/binfmt.h>
 #endif
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+#include <tinyara/binfmt/elf.h>
+#endif
 
 #include "sched/sched.h"
 #include "task/task.h"
@@ -56,6 +60,9 @@ extern sq_queue_t g_sem_list;
 /****************************************************************************
  * Private Definitions
  ****************************************************************************/
+/* Microseconds elapsed since 'start', for the load time of binaries */
+#define BINMGR_ELAPSED_USEC(start) ((uint32_t)TICK2USEC(clock_systimer() - (start)))
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -113,6 +120,11 @@ static int binary_manager_load_binary(int bin_idx, char *path, load_attr_t *load
 			strncpy(BIN_NAME(bin_idx), load_attr->bin_name, BIN_NAME_MAX);
 			bmvdbg("BIN TABLE[%d] %d %d %d %.1f %s\n", bin_idx, BIN_SIZE(bin_idx), BIN_RAMSIZE(bin_idx), BIN_LOADVER(bin_idx), BIN_KERNEL_VER(bin_idx), BIN_NAME(bin_idx));
 			return OK;
+		} else if (errno == EBADMSG) {
+			/* CRC mismatch found while loading. Loading it again would not help. */
+			lldbg("Load '%s' fail, invalid crc. Remove it\n", BIN_NAME(bin_idx));
+			unlink(path);
+			break;
 		} else if (errno == ENOMEM) {
 			/* Sleep for a moment to get available memory */
 			usleep(1000);
@@ -144,6 +156,7 @@ static int binary_manager_load(int bin_idx)
 	int ret;
 	int bin_count;
 	load_attr_t load_attr;
+	clock_t start;
 	char filepath[CONFIG_PATH_MAX];
 	user_binary_header_t header_data;
 #ifdef CONFIG_OPTIMIZE_APP_RELOAD_TIME
@@ -178,8 +191,17 @@ static int binary_manager_load(int bin_idx)
 #endif
 		{
 			/* Read header data and Check crc */
+			start = clock_systimer();
 			snprintf(filepath, CONFIG_PATH_MAX, "%s/%s_%d", BINARY_DIR_PATH, BIN_NAME(bin_idx), BIN_VER(bin_idx, BIN_USEIDX(bin_idx)));
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+			/* Uncompressed binaries are checked by the loader while it reads them */
+			ret = binary_manager_read_header(filepath, &header_data, false);
+			if (ret == OK && header_data.compression_type != COMPRESS_TYPE_NONE) {
+				ret = binary_manager_read_header(filepath, &header_data, true);
+			}
+#else
 			ret = binary_manager_read_header(filepath, &header_data, true);
+#endif
 			if (ret != OK) {
 				if (--bin_count > 0) {
 					bmdbg("Failed to read header %s, try to read another file\n", filepath);
@@ -199,16 +221,27 @@ static int binary_manager_load(int bin_idx)
 			load_attr.priority = header_data.bin_priority;
 			load_attr.offset = CHECKSUM_SIZE + header_data.header_size;
 			load_attr.bin_ver = header_data.bin_ver;
+#ifdef CONFIG_ELF_CRC_ON_LOAD
+			load_attr.crc_check = (header_data.compression_type == COMPRESS_TYPE_NONE);
+			load_attr.crc_seed = crc32part((uint8_t *)&header_data + CHECKSUM_SIZE, header_data.header_size, 0);
+			load_attr.crc_hash = header_data.crc_hash;
+#endif
+			memset(&load_attr.load_time, 0, sizeof(binary_load_time_t));
+			load_attr.load_time.header = BINMGR_ELAPSED_USEC(start);
 		}
 #ifdef CONFIG_OPTIMIZE_APP_RELOAD_TIME
 		else {
+			start = clock_systimer();
 			load_attr = BIN_LOAD_ATTR(bin_idx);
+			memset(&load_attr.load_time, 0, sizeof(binary_load_time_t));
 		}
 		load_attr.binp = binp;
 #endif
 		ret = binary_manager_load_binary(bin_idx, filepath, &load_attr);
 		if (ret == OK) {
 			BIN_KERNEL_VER(bin_idx) = header_data.kernel_ver;
+			BIN_LOAD_ATTR(bin_idx).load_time.total = BINMGR_ELAPSED_USEC(start);
+			bmvdbg("Load time of %s : header %u load %u bind %u verify %u total %u us\n", BIN_NAME(bin_idx), BIN_LOAD_ATTR(bin_idx).load_time.header, BIN_LOAD_ATTR(bin_idx).load_time.load, BIN_LOAD_ATTR(bin_idx).load_time.bind, BIN_LOAD_ATTR(bin_idx).load_time.verify, BIN_LOAD_ATTR(bin_idx).load_time.total);
 			return BINMGR_OK;
 		}
 		if (--bin_count > 0) {
@@ -86,6 +86,9 @@ static void *kheap_malloc(size_t size, size_t retaddr)
 	void *ret;
 	struct mm_heap_s *kheap = kmm_get_heap();
 
+#ifdef CONFIG_MM_RECLAIM
+retry:
+#endif
 	for (heap_idx = 0; heap_idx < CONFIG_KMM_NHEAPS; heap_idx++) {
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 		ret = mm_malloc(&kheap[heap_idx], size, retaddr);
@@ -97,6 +100,14 @@ static void *kheap_malloc(size_t size, size_t retaddr)
 		}
 	}
 
+#ifdef CONFIG_MM_RECLAIM
+	/* No kernel heap has room: let the caches give memory back and try again */
+
+	if (mm_reclaim(size) > 0) {
+		goto retry;
+	}
+#endif
+
 	return NULL;
 }
 
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_reclaim.c
+ *
+ * Lets caches give memory back to the heap when an allocation fails.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sched.h>
+
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_RECLAIM
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct mm_reclaim_s *g_mm_reclaim;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_register_reclaim
+ *
+ * Description:
+ *   Register a cache to be shrunk when an allocation fails.  The structure
+ *   must stay valid as long as the system runs; there is no unregistration.
+ *
+ ****************************************************************************/
+
+void mm_register_reclaim(FAR struct mm_reclaim_s *reclaim)
+{
+	sched_lock();
+	reclaim->flink = g_mm_reclaim;
+	g_mm_reclaim = reclaim;
+	sched_unlock();
+}
+
+/****************************************************************************
+ * Name: mm_reclaim
+ *
+ * Description:
+ *   Ask the registered caches to free at least 'size' bytes.  Called by
+ *   kmm_malloc(), and by malloc() when there is no separate kernel heap,
+ *   after every heap failed.  No heap semaphore is held.
+ *
+ * Returned Value:
+ *   The number of bytes freed, zero if there was nothing to free.
+ *
+ ****************************************************************************/
+
+size_t mm_reclaim(size_t size)
+{
+	FAR struct mm_reclaim_s *reclaim;
+	size_t freed = 0;
+
+	for (reclaim = g_mm_reclaim; reclaim != NULL && freed < size; reclaim = reclaim->flink) {
+		freed += reclaim->reclaim(size - freed);
+	}
+
+	return freed;
+}
+
+#endif							/* CONFIG_MM_RECLAIM */
@@ -210,6 +210,9 @@ FAR void *malloc(size_t size)
 	heap_idx = CONFIG_RAM_MALLOC_PRIOR_INDEX;
 #endif
 
+#if defined(CONFIG_MM_RECLAIM) && !defined(CONFIG_MM_KERNEL_HEAP)
+retry:
+#endif
 	ret = heap_malloc(size, heap_idx, CONFIG_KMM_NHEAPS, retaddr);
 	if (ret != NULL) {
 		return ret;
@@ -220,6 +223,16 @@ FAR void *malloc(size_t size)
 	ret = heap_malloc(size, 0, CONFIG_RAM_MALLOC_PRIOR_INDEX, retaddr);
 #endif
 
+#if defined(CONFIG_MM_RECLAIM) && !defined(CONFIG_MM_KERNEL_HEAP)
+	/* Without a separate kernel heap, the kernel caches share the user heap.
+	 * Once every heap failed, let them give memory back and try again.
+	 */
+
+	if (ret == NULL && mm_reclaim(size) > 0) {
+		goto retry;
+	}
+#endif
+
 	return ret;
 #endif /* CONFIG_BUILD_KERNEL */
 }
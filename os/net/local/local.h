@@ -60,6 +60,7 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
 #include <sys/un.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -91,6 +92,22 @@
 #define LOCAL_SYNC_BYTE 0x42 /* Byte in sync sequence */
 #define LOCAL_END_BYTE 0xbd  /* End of sync seqence */
 
+/* Connected peers exchange data through a pair of in-memory rings, one per
+ * direction.  A datagram is stored in a ring as its 16-bit length (in host
+ * order) followed by its data, so that message boundaries are kept.
+ */
+
+#define LOCAL_RING_HDRSIZE sizeof(uint16_t)
+
+/* MSG_DONTWAIT is only defined by some network stacks */
+
+#ifdef MSG_DONTWAIT
+#define LOCAL_NONBLOCK(psock, flags) \
+	(_SS_ISNONBLOCK((psock)->s_flags) || ((flags) & MSG_DONTWAIT) != 0)
+#else
+#define LOCAL_NONBLOCK(psock, flags) _SS_ISNONBLOCK((psock)->s_flags)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -123,6 +140,10 @@ enum local_state_s {
 	LOCAL_STATE_DISCONNECTED /* Peer disconnected */
 };
 
+/* One direction of an in-memory connection, see local_ring.c */
+
+struct local_ring_s;
+
 /* Representation of a local connection.  There are four types of
  * connection structures:
  *
@@ -164,6 +185,8 @@ struct local_conn_s {
 	char lc_path[UNIX_PATH_MAX]; /* Path assigned by bind() */
 	int32_t lc_instance_id;		 /* Connection instance ID for stream
 								  * server<->client connection pair */
+	FAR struct local_ring_s *lc_rxring; /* In-memory incoming data (peers) */
+	FAR struct local_ring_s *lc_txring; /* In-memory outgoing data (peers) */
 
 #ifdef CONFIG_NET_LOCAL_STREAM
 	/* SOCK_STREAM fields common to both client and server */
@@ -303,6 +326,26 @@ int psock_local_bind(FAR struct socket *psock,
 int psock_local_connect(FAR struct socket *psock,
 						FAR const struct sockaddr *addr);
 
+/****************************************************************************
+ * Name: psock_local_socketpair
+ *
+ * Description:
+ *   Connect two new local sockets of the same type to each other through
+ *   in-memory rings.  This implements the local part of socketpair().
+ *
+ * Input Parameters:
+ *   psock1 - The first socket, as set up by psock_socket()
+ *   psock2 - The second socket, as set up by psock_socket()
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int psock_local_socketpair(FAR struct socket *psock1,
+						   FAR struct socket *psock2);
+
 /****************************************************************************
  * Name: local_release
  *
@@ -523,6 +566,84 @@ int local_fifo_read(FAR struct file *filep, FAR uint8_t *buf, size_t *len);
 int local_getaddr(FAR struct local_conn_s *conn, FAR struct sockaddr *addr,
 				  FAR socklen_t *addrlen);
 
+/****************************************************************************
+ * Name: local_ring_connect
+ *
+ * Description:
+ *   Allocate the two rings of an in-memory connection and give one end of
+ *   each to both connection structures.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOMEM if the rings cannot be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+int local_ring_connect(FAR struct local_conn_s *conn1,
+					   FAR struct local_conn_s *conn2);
+
+/****************************************************************************
+ * Name: local_ring_disconnect
+ *
+ * Description:
+ *   Close the ends of the rings held by a connection.  The peer reads the
+ *   data already sent and then end-of-file; its sends fail with EPIPE.  A
+ *   ring is freed when both of its ends are closed.
+ *
+ ****************************************************************************/
+
+void local_ring_disconnect(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Send data to the peer of an in-memory connection.  A stream send
+ *   blocks until all of the data has been copied, unless 'nonblock' is set;
+ *   a datagram is copied whole or not at all.
+ *
+ * Returned Value:
+ *   The number of bytes sent on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn, FAR const void *buf,
+						size_t len, bool nonblock);
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Receive data from the peer of an in-memory connection.  A stream
+ *   receive returns what is available, up to 'len' bytes; a datagram
+ *   receive returns one datagram, and discards what does not fit in 'buf'.
+ *   MSG_PEEK leaves the data in the ring.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero at end-of-file, or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+						size_t len, int flags, bool nonblock);
+
+/****************************************************************************
+ * Name: local_ring_pollsetup and local_ring_pollteardown
+ *
+ * Description:
+ *   Setup and teardown the monitoring of the rings of an in-memory
+ *   connection.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+						 FAR struct pollfd *fds);
+int local_ring_pollteardown(FAR struct local_conn_s *conn,
+							FAR struct pollfd *fds);
+#endif
+
 /****************************************************************************
  * Name: local_sync
  *
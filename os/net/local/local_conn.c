@@ -141,6 +141,10 @@ void local_free(FAR struct local_conn_s *conn)
 {
 	DEBUGASSERT(conn != NULL);
 
+	/* Close our ends of the in-memory rings */
+
+	local_ring_disconnect(conn);
+
 	/* Make sure that the read-only FIFO is closed */
 
 	if (conn->lc_infile.f_inode != NULL) {
@@ -157,6 +157,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 	server->u.server.lc_pending++;
 	DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifdef CONFIG_NET_LOCAL_STREAM_FIFO
 	/* Create the FIFOs needed for the connection */
 
 	ret = local_create_fifos(client);
@@ -182,6 +183,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 	}
 
 	DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
 	/* Set the busy "result" before giving the semaphore. */
 
@@ -210,9 +212,15 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 
 	if (ret < 0) {
 		ndbg("ERROR: Failed to connect: %d\n", ret);
+#ifdef CONFIG_NET_LOCAL_STREAM_FIFO
 		goto errout_with_outfd;
+#else
+		client->lc_state = LOCAL_STATE_BOUND;
+		return ret;
+#endif
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_FIFO
 	/* Yes.. open the read-only FIFO */
 
 	ret = local_open_client_rx(client, nonblock);
@@ -223,9 +231,16 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 	}
 
 	DEBUGASSERT(client->lc_infile.f_inode != NULL);
+#else
+	/* Yes.. the server has attached the in-memory rings */
+
+	DEBUGASSERT(client->lc_rxring != NULL && client->lc_txring != NULL);
+#endif
 	client->lc_state = LOCAL_STATE_CONNECTED;
 	return OK;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_FIFO
+
 errout_with_outfd:
 	file_close(&client->lc_outfile);
 	client->lc_outfile.f_inode = NULL;
@@ -234,6 +249,7 @@ errout_with_fifos:
 	local_release_fifos(client);
 	client->lc_state = LOCAL_STATE_BOUND;
 	return ret;
+#endif
 }
 
 /****************************************************************************
@@ -187,6 +187,12 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
 	conn = (FAR struct local_conn_s *)psock->s_conn;
 
+	/* In-memory connections, stream or datagram, watch their rings */
+
+	if (conn->lc_rxring != NULL) {
+		return local_ring_pollsetup(conn, fds);
+	}
+
 	if (conn->lc_proto == SOCK_DGRAM) {
 		return ret;
 	}
@@ -317,6 +323,10 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 
 	conn = (FAR struct local_conn_s *)psock->s_conn;
 
+	if (conn->lc_rxring != NULL) {
+		return local_ring_pollteardown(conn, fds);
+	}
+
 	if (conn->lc_proto == SOCK_DGRAM) {
 		return ret;
 	}
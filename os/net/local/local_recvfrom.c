@@ -170,6 +170,21 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 		return -ENOTCONN;
 	}
 
+	/* In-memory connections bypass the FIFOs */
+
+	if (conn->lc_rxring != NULL) {
+		ssize_t nrecvd = local_ring_recv(conn, buf, len, flags,
+										 LOCAL_NONBLOCK(psock, flags));
+		if (nrecvd >= 0 && from) {
+			ret = local_getaddr(conn, from, fromlen);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		return nrecvd;
+	}
+
 	/* The incoming FIFO should be open */
 
 	DEBUGASSERT(conn->lc_infile.f_inode != NULL);
@@ -257,6 +272,21 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
 	DEBUGASSERT(len <= UINT16_MAX);
 
+	/* Datagrams between the ends of a socketpair go through memory */
+
+	if (conn->lc_state == LOCAL_STATE_CONNECTED && conn->lc_rxring != NULL) {
+		ssize_t nrecvd = local_ring_recv(conn, buf, len, flags,
+										 LOCAL_NONBLOCK(psock, flags));
+		if (nrecvd >= 0 && from) {
+			ret = local_getaddr(conn, from, fromlen);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		return nrecvd;
+	}
+
 	/* Verify that this is a bound, un-connected peer socket */
 
 	if (conn->lc_state != LOCAL_STATE_BOUND) {
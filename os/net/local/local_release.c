@@ -99,13 +99,18 @@ int local_release(FAR struct local_conn_s *conn)
 
 	DEBUGASSERT(conn->lc_state != LOCAL_STATE_ACCEPT);
 
-	/* If the socket is connected (SOCK_STREAM client), then disconnect it */
+	/* If the socket is connected (SOCK_STREAM client or either end of a
+	 * socketpair), then disconnect it
+	 */
 
 	if (conn->lc_state == LOCAL_STATE_CONNECTED ||
 		conn->lc_state == LOCAL_STATE_DISCONNECTED) {
-		DEBUGASSERT(conn->lc_proto == SOCK_STREAM);
+		DEBUGASSERT(conn->lc_proto == SOCK_STREAM ||
+					conn->lc_rxring != NULL);
 
-		/* Just free the connection structure */
+		/* Just free the connection structure, local_free() closes the
+		 * in-memory rings.
+		 */
 	}
 
 	/* Is the socket is listening socket (SOCK_STREAM server) */
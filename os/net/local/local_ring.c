@@ -0,0 +1,689 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/net/net.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_LOCAL_RINGBUF_SIZE
+#define CONFIG_NET_LOCAL_RINGBUF_SIZE 2048
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One direction of an in-memory connection.  The sending peer holds the
+ * writing end in lc_txring, the receiving peer the reading end in
+ * lc_rxring.  All fields are protected by the network lock.
+ */
+
+struct local_ring_s {
+	uint8_t lr_crefs;	   /* Number of open ends, the ring is freed at 0 */
+	bool lr_rclosed;	   /* The reading end was closed */
+	bool lr_wclosed;	   /* The writing end was closed */
+	uint8_t lr_nreaders;   /* Number of threads waiting for data */
+	uint8_t lr_nwriters;   /* Number of threads waiting for space */
+	sem_t lr_readsem;	   /* Wakes up the threads waiting for data */
+	sem_t lr_writesem;	   /* Wakes up the threads waiting for space */
+	size_t lr_size;		   /* Size of lr_buffer */
+	size_t lr_used;		   /* Number of bytes in lr_buffer */
+	size_t lr_head;		   /* Offset of the next byte written */
+	size_t lr_tail;		   /* Offset of the next byte read */
+#ifdef HAVE_LOCAL_POLL
+	struct pollfd *lr_readfds[LOCAL_NPOLLWAITERS];	/* Polls of the reading end */
+	struct pollfd *lr_writefds[LOCAL_NPOLLWAITERS]; /* Polls of the writing end */
+#endif
+	uint8_t lr_buffer[1];  /* The data, lr_size bytes */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ ****************************************************************************/
+
+static FAR struct local_ring_s *local_ring_alloc(void)
+{
+	FAR struct local_ring_s *ring;
+
+	/* Only the header needs to be cleared */
+
+	ring = (FAR struct local_ring_s *)
+		kmm_malloc(offsetof(struct local_ring_s, lr_buffer) +
+				   CONFIG_NET_LOCAL_RINGBUF_SIZE);
+	if (ring == NULL) {
+		return NULL;
+	}
+
+	memset(ring, 0, offsetof(struct local_ring_s, lr_buffer));
+	ring->lr_crefs = 2;
+	ring->lr_size = CONFIG_NET_LOCAL_RINGBUF_SIZE;
+
+	/* These semaphores are used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+
+	sem_init(&ring->lr_readsem, 0, 0);
+	sem_setprotocol(&ring->lr_readsem, SEM_PRIO_NONE);
+	sem_init(&ring->lr_writesem, 0, 0);
+	sem_setprotocol(&ring->lr_writesem, SEM_PRIO_NONE);
+	return ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ ****************************************************************************/
+
+static void local_ring_release(FAR struct local_ring_s *ring)
+{
+	DEBUGASSERT(ring->lr_crefs > 0);
+
+	if (--ring->lr_crefs == 0) {
+		sem_destroy(&ring->lr_readsem);
+		sem_destroy(&ring->lr_writesem);
+		kmm_free(ring);
+	}
+}
+
+/****************************************************************************
+ * Name: local_ring_write
+ *
+ * Description:
+ *   Append 'len' bytes to the ring, which must have room for them.
+ *
+ ****************************************************************************/
+
+static void local_ring_write(FAR struct local_ring_s *ring,
+							 FAR const uint8_t *buf, size_t len)
+{
+	size_t n = MIN(len, ring->lr_size - ring->lr_head);
+
+	memcpy(&ring->lr_buffer[ring->lr_head], buf, n);
+	memcpy(ring->lr_buffer, buf + n, len - n);
+
+	ring->lr_head += len;
+	if (ring->lr_head >= ring->lr_size) {
+		ring->lr_head -= ring->lr_size;
+	}
+
+	ring->lr_used += len;
+}
+
+/****************************************************************************
+ * Name: local_ring_peek
+ *
+ * Description:
+ *   Copy 'len' bytes, starting 'offset' bytes after the oldest one, out of
+ *   the ring without removing them.
+ *
+ ****************************************************************************/
+
+static void local_ring_peek(FAR struct local_ring_s *ring, size_t offset,
+							FAR uint8_t *buf, size_t len)
+{
+	size_t start = ring->lr_tail + offset;
+	size_t n;
+
+	if (start >= ring->lr_size) {
+		start -= ring->lr_size;
+	}
+
+	n = MIN(len, ring->lr_size - start);
+	memcpy(buf, &ring->lr_buffer[start], n);
+	memcpy(buf + n, ring->lr_buffer, len - n);
+}
+
+/****************************************************************************
+ * Name: local_ring_consume
+ *
+ * Description:
+ *   Remove the 'len' oldest bytes from the ring.
+ *
+ ****************************************************************************/
+
+static void local_ring_consume(FAR struct local_ring_s *ring, size_t len)
+{
+	DEBUGASSERT(len <= ring->lr_used);
+
+	ring->lr_used -= len;
+	if (ring->lr_used == 0) {
+		/* Start over at the beginning so that copies are not split */
+
+		ring->lr_head = 0;
+		ring->lr_tail = 0;
+	} else {
+		ring->lr_tail += len;
+		if (ring->lr_tail >= ring->lr_size) {
+			ring->lr_tail -= ring->lr_size;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Wait, with the network lock released, until local_ring_wakeup() is
+ *   called for the same semaphore.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR sem_t *sem, FAR uint8_t *nwaiters)
+{
+	int ret;
+
+	(*nwaiters)++;
+	ret = net_lockedwait(sem);
+	if (ret < 0) {
+		/* Not woken up, do not count this thread any longer */
+
+		if (*nwaiters > 0) {
+			(*nwaiters)--;
+		}
+
+		return -get_errno();
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_wakeup
+ ****************************************************************************/
+
+static void local_ring_wakeup(FAR sem_t *sem, FAR uint8_t *nwaiters)
+{
+	while (*nwaiters > 0) {
+		(*nwaiters)--;
+		sem_post(sem);
+	}
+}
+
+#ifdef HAVE_LOCAL_POLL
+/****************************************************************************
+ * Name: local_ring_readevents and local_ring_writeevents
+ *
+ * Description:
+ *   Return the poll events of the reading and of the writing end.
+ *
+ ****************************************************************************/
+
+static pollevent_t local_ring_readevents(FAR struct local_ring_s *ring)
+{
+	pollevent_t eventset = 0;
+
+	if (ring->lr_used > 0) {
+		eventset |= POLLIN;
+	}
+
+	if (ring->lr_wclosed) {
+		eventset |= POLLIN | POLLHUP;
+	}
+
+	return eventset;
+}
+
+static pollevent_t local_ring_writeevents(FAR struct local_ring_s *ring)
+{
+	if (ring->lr_rclosed) {
+		return POLLOUT | POLLERR;
+	}
+
+	/* The smallest datagram takes LOCAL_RING_HDRSIZE bytes */
+
+	if (ring->lr_size - ring->lr_used > LOCAL_RING_HDRSIZE) {
+		return POLLOUT;
+	}
+
+	return 0;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollnotify
+ ****************************************************************************/
+
+static void local_ring_pollnotify(FAR struct pollfd **slots,
+								  pollevent_t eventset)
+{
+	FAR struct pollfd *fds;
+	int i;
+
+	if (eventset == 0) {
+		return;
+	}
+
+	for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+		fds = slots[i];
+		if (fds) {
+			/* POLLERR and POLLHUP are reported even if not requested */
+
+			fds->revents |= (fds->events | POLLERR | POLLHUP) & eventset;
+			if (fds->revents != 0) {
+				nvdbg("Report events: %02x\n", fds->revents);
+				sem_post(fds->sem);
+			}
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: local_ring_addfds and local_ring_remfds
+ ****************************************************************************/
+
+static int local_ring_addfds(FAR struct pollfd **slots,
+							 FAR struct pollfd *fds)
+{
+	int i;
+
+	for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+		if (slots[i] == NULL) {
+			slots[i] = fds;
+			return OK;
+		}
+	}
+
+	return -EBUSY;
+}
+
+static void local_ring_remfds(FAR struct pollfd **slots,
+							  FAR struct pollfd *fds)
+{
+	int i;
+
+	for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+		if (slots[i] == fds) {
+			slots[i] = NULL;
+		}
+	}
+}
+#else
+#define local_ring_pollnotify(slots, eventset)
+#endif /* HAVE_LOCAL_POLL */
+
+/****************************************************************************
+ * Name: local_ring_written and local_ring_read
+ *
+ * Description:
+ *   Wake up the threads and the polls waiting for the reading end after
+ *   data was added or the writing end was closed, and the other way round.
+ *
+ ****************************************************************************/
+
+static void local_ring_written(FAR struct local_ring_s *ring)
+{
+	local_ring_wakeup(&ring->lr_readsem, &ring->lr_nreaders);
+	local_ring_pollnotify(ring->lr_readfds, local_ring_readevents(ring));
+}
+
+static void local_ring_read(FAR struct local_ring_s *ring)
+{
+	local_ring_wakeup(&ring->lr_writesem, &ring->lr_nwriters);
+	local_ring_pollnotify(ring->lr_writefds, local_ring_writeevents(ring));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_connect
+ *
+ * Description:
+ *   Allocate the two rings of an in-memory connection and give one end of
+ *   each to both connection structures.
+ *
+ ****************************************************************************/
+
+int local_ring_connect(FAR struct local_conn_s *conn1,
+					   FAR struct local_conn_s *conn2)
+{
+	FAR struct local_ring_s *ring1;
+	FAR struct local_ring_s *ring2;
+
+	DEBUGASSERT(conn1->lc_rxring == NULL && conn1->lc_txring == NULL);
+	DEBUGASSERT(conn2->lc_rxring == NULL && conn2->lc_txring == NULL);
+
+	ring1 = local_ring_alloc();
+	if (ring1 == NULL) {
+		return -ENOMEM;
+	}
+
+	ring2 = local_ring_alloc();
+	if (ring2 == NULL) {
+		kmm_free(ring1);
+		return -ENOMEM;
+	}
+
+	conn1->lc_txring = ring1;
+	conn2->lc_rxring = ring1;
+	conn2->lc_txring = ring2;
+	conn1->lc_rxring = ring2;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_disconnect
+ *
+ * Description:
+ *   Close the ends of the rings held by a connection.
+ *
+ ****************************************************************************/
+
+void local_ring_disconnect(FAR struct local_conn_s *conn)
+{
+	FAR struct local_ring_s *ring;
+
+	net_lock();
+
+	ring = conn->lc_rxring;
+	if (ring != NULL) {
+		ring->lr_rclosed = true;
+		local_ring_read(ring);
+		local_ring_release(ring);
+		conn->lc_rxring = NULL;
+	}
+
+	ring = conn->lc_txring;
+	if (ring != NULL) {
+		ring->lr_wclosed = true;
+		local_ring_written(ring);
+		local_ring_release(ring);
+		conn->lc_txring = NULL;
+	}
+
+	net_unlock();
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Send data to the peer of an in-memory connection.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn, FAR const void *buf,
+						size_t len, bool nonblock)
+{
+	FAR struct local_ring_s *ring = conn->lc_txring;
+	FAR const uint8_t *data = (FAR const uint8_t *)buf;
+	uint16_t len16;
+	size_t nsent = 0;
+	size_t n;
+	int ret = OK;
+
+	DEBUGASSERT(ring != NULL);
+
+	if (conn->lc_proto == SOCK_DGRAM &&
+		(len > UINT16_MAX || len > ring->lr_size - LOCAL_RING_HDRSIZE)) {
+		return -EMSGSIZE;
+	}
+
+	net_lock();
+
+	if (conn->lc_proto == SOCK_DGRAM) {
+		/* A datagram goes into the ring whole, with its length */
+
+		while (ring->lr_size - ring->lr_used < LOCAL_RING_HDRSIZE + len) {
+			if (ring->lr_rclosed) {
+				break;
+			}
+
+			if (nonblock) {
+				ret = -EAGAIN;
+				break;
+			}
+
+			ret = local_ring_wait(&ring->lr_writesem, &ring->lr_nwriters);
+			if (ret < 0) {
+				break;
+			}
+		}
+
+		if (ring->lr_rclosed) {
+			ret = -EPIPE;
+		} else if (ret == OK) {
+			len16 = (uint16_t)len;
+			local_ring_write(ring, (FAR const uint8_t *)&len16,
+							 LOCAL_RING_HDRSIZE);
+			local_ring_write(ring, data, len);
+			local_ring_written(ring);
+			nsent = len;
+		}
+	} else {
+		/* A stream is copied as room becomes available */
+
+		while (nsent < len) {
+			if (ring->lr_rclosed) {
+				ret = -EPIPE;
+				break;
+			}
+
+			n = MIN(len - nsent, ring->lr_size - ring->lr_used);
+			if (n > 0) {
+				local_ring_write(ring, data + nsent, n);
+				local_ring_written(ring);
+				nsent += n;
+				continue;
+			}
+
+			if (nonblock) {
+				ret = -EAGAIN;
+				break;
+			}
+
+			ret = local_ring_wait(&ring->lr_writesem, &ring->lr_nwriters);
+			if (ret < 0) {
+				break;
+			}
+		}
+
+		/* Report the error only if nothing was sent */
+
+		if (nsent > 0) {
+			ret = OK;
+		}
+	}
+
+	net_unlock();
+	return ret < 0 ? ret : (ssize_t)nsent;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Receive data from the peer of an in-memory connection.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+						size_t len, int flags, bool nonblock)
+{
+	FAR struct local_ring_s *ring = conn->lc_rxring;
+	uint16_t len16;
+	size_t skip = 0;
+	size_t n;
+	ssize_t ret;
+
+	DEBUGASSERT(ring != NULL);
+
+	net_lock();
+
+	/* Wait for data, or for the end of the connection */
+
+	while (ring->lr_used == 0) {
+		if (ring->lr_wclosed) {
+			net_unlock();
+			return 0;
+		}
+
+		if (nonblock) {
+			net_unlock();
+			return -EAGAIN;
+		}
+
+		ret = local_ring_wait(&ring->lr_readsem, &ring->lr_nreaders);
+		if (ret < 0) {
+			net_unlock();
+			return ret;
+		}
+	}
+
+	if (conn->lc_proto == SOCK_DGRAM) {
+		/* One datagram, the part that does not fit in 'buf' is lost */
+
+		local_ring_peek(ring, 0, (FAR uint8_t *)&len16, LOCAL_RING_HDRSIZE);
+		DEBUGASSERT(LOCAL_RING_HDRSIZE + len16 <= ring->lr_used);
+
+		skip = LOCAL_RING_HDRSIZE;
+		n = MIN(len, len16);
+		local_ring_peek(ring, skip, (FAR uint8_t *)buf, n);
+		skip += len16;
+	} else {
+		n = MIN(len, ring->lr_used);
+		local_ring_peek(ring, 0, (FAR uint8_t *)buf, n);
+		skip = n;
+	}
+
+#ifdef MSG_PEEK
+	if ((flags & MSG_PEEK) == 0)
+#endif
+	{
+		local_ring_consume(ring, skip);
+		local_ring_read(ring);
+	}
+
+	net_unlock();
+	return (ssize_t)n;
+}
+
+#ifdef HAVE_LOCAL_POLL
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup to monitor the rings of an in-memory connection.  POLLIN is
+ *   watched on the reading end of lc_rxring, POLLOUT on the writing end of
+ *   lc_txring.
+ *
+ ****************************************************************************/
+
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+						 FAR struct pollfd *fds)
+{
+	FAR struct local_ring_s *rxring = conn->lc_rxring;
+	FAR struct local_ring_s *txring = conn->lc_txring;
+	pollevent_t eventset = 0;
+	int ret;
+
+	DEBUGASSERT(rxring != NULL && txring != NULL);
+
+	net_lock();
+
+	if ((fds->events & POLLIN) != 0) {
+		ret = local_ring_addfds(rxring->lr_readfds, fds);
+		if (ret < 0) {
+			goto errout;
+		}
+	}
+
+	if ((fds->events & POLLOUT) != 0) {
+		ret = local_ring_addfds(txring->lr_writefds, fds);
+		if (ret < 0) {
+			local_ring_remfds(rxring->lr_readfds, fds);
+			goto errout;
+		}
+	}
+
+	fds->priv = conn;
+
+	/* Report the events that are already pending */
+
+	eventset = local_ring_readevents(rxring) | local_ring_writeevents(txring);
+	fds->revents |= (fds->events | POLLERR | POLLHUP) & eventset;
+	if (fds->revents != 0) {
+		sem_post(fds->sem);
+	}
+
+	net_unlock();
+	return OK;
+
+errout:
+	fds->priv = NULL;
+	net_unlock();
+	return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollteardown
+ ****************************************************************************/
+
+int local_ring_pollteardown(FAR struct local_conn_s *conn,
+							FAR struct pollfd *fds)
+{
+	if (fds->priv == NULL) {
+		return OK;
+	}
+
+	net_lock();
+	if (conn->lc_rxring != NULL) {
+		local_ring_remfds(conn->lc_rxring->lr_readfds, fds);
+	}
+
+	if (conn->lc_txring != NULL) {
+		local_ring_remfds(conn->lc_txring->lr_writefds, fds);
+	}
+
+	fds->priv = NULL;
+	net_unlock();
+	return OK;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL */
@@ -63,6 +63,7 @@
 
 #include <tinyara/net/net.h>
 
+#include "socket/socket.h"
 #include "local/local.h"
 
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -81,7 +82,7 @@
  *   psock    An instance of the internal socket structure.
  *   buf      Data to send
  *   len      Length of data to send
- *   flags    Send flags (ignored for now)
+ *   flags    Send flags (only MSG_DONTWAIT is used)
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -99,6 +100,13 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
 	DEBUGASSERT(psock && psock->s_conn && buf);
 	peer = (FAR struct local_conn_s *)psock->s_conn;
 
+	/* In-memory connections bypass the FIFOs */
+
+	if (peer->lc_state == LOCAL_STATE_CONNECTED && peer->lc_txring != NULL) {
+		return local_ring_send(peer, buf, len,
+							   LOCAL_NONBLOCK(psock, flags));
+	}
+
 	/* Verify that this is a connected peer socket and that it has opened the
 	 * outgoing FIFO for write-only access.
 	 */
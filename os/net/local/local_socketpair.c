@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_local_socketpair
+ *
+ * Description:
+ *   Connect two new local sockets of the same type to each other through
+ *   in-memory rings.  This implements the local part of socketpair().
+ *
+ * Input Parameters:
+ *   psock1 - The first socket, as set up by psock_socket()
+ *   psock2 - The second socket, as set up by psock_socket()
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int psock_local_socketpair(FAR struct socket *psock1,
+						   FAR struct socket *psock2)
+{
+	FAR struct local_conn_s *conn1;
+	FAR struct local_conn_s *conn2;
+	int ret;
+
+	DEBUGASSERT(psock1 != NULL && psock1->s_conn != NULL);
+	DEBUGASSERT(psock2 != NULL && psock2->s_conn != NULL);
+
+	if (psock1->s_domain != PF_LOCAL || psock2->s_domain != PF_LOCAL ||
+		psock1->s_type != psock2->s_type) {
+		return -EOPNOTSUPP;
+	}
+
+	conn1 = (FAR struct local_conn_s *)psock1->s_conn;
+	conn2 = (FAR struct local_conn_s *)psock2->s_conn;
+
+	ret = local_ring_connect(conn1, conn2);
+	if (ret < 0) {
+		ndbg("ERROR: Failed to allocate the rings: %d\n", ret);
+		return ret;
+	}
+
+	/* Both ends are unnamed, connected peers */
+
+	conn1->lc_proto = psock1->s_type;
+	conn1->lc_type = LOCAL_TYPE_UNNAMED;
+	conn1->lc_state = LOCAL_STATE_CONNECTED;
+	psock1->s_flags |= _SF_CONNECTED;
+
+	conn2->lc_proto = psock2->s_type;
+	conn2->lc_type = LOCAL_TYPE_UNNAMED;
+	conn2->lc_state = LOCAL_STATE_CONNECTED;
+	psock2->s_flags |= _SF_CONNECTED;
+
+	return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL */
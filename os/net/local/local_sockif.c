@@ -547,6 +547,12 @@ static int local_connect(FAR struct socket *psock,
 
 #ifdef CONFIG_NET_LOCAL_DGRAM
 	case SOCK_DGRAM: {
+		/* The ends of a socketpair cannot be re-associated */
+
+		if (_SS_ISCONNECTED(psock->s_flags)) {
+			return -EISCONN;
+		}
+
 		/* Perform the datagram connection logic */
 
 		return -ENOSYS;
@@ -682,9 +688,19 @@ static ssize_t local_send(FAR struct socket *psock, FAR const void *buf,
 
 #ifdef CONFIG_NET_LOCAL_DGRAM
 	case SOCK_DGRAM: {
-		/* Local UDP packet send */
+		FAR struct local_conn_s *conn = psock->s_conn;
+
+		/* Local UDP packet send, only the ends of a socketpair have a
+		 * peer to send to.
+		 */
 
-		ret = -ENOSYS;
+		if (conn->lc_state == LOCAL_STATE_CONNECTED &&
+			conn->lc_txring != NULL) {
+			ret = local_ring_send(conn, buf, len,
+								  LOCAL_NONBLOCK(psock, flags));
+		} else {
+			ret = -ENOSYS;
+		}
 	} break;
 #endif /* CONFIG_NET_LOCAL_DGRAM */
 
@@ -738,7 +754,7 @@ ssize_t local_sendto(FAR struct socket *psock, FAR const void *buf,
 #ifdef CONFIG_NET_LOCAL_DGRAM
 	/* If this is a connected socket, then return EISCONN */
 
-	if (psock->s_type != SOCK_DGRAM) {
+	if (psock->s_type != SOCK_DGRAM || _SS_ISCONNECTED(psock->s_flags)) {
 		ndbg("ERROR: Connected socket\n");
 		return -EISCONN;
 	}
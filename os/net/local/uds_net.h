@@ -19,13 +19,18 @@
 #ifndef __NET_LOCAL_UDS_NET_H
 #define __NET_LOCAL_UDS_NET_H
 
+#include <stdbool.h>
+#include <poll.h>
 #include <tinyara/net/net.h>
 
 void uds_net_initlist(FAR struct socketlist *list);
 void uds_net_releaselist(FAR struct socketlist *list);
 int uds_checksd(int fd, int oflags);
+int uds_close(int sockfd);
+int uds_poll(int sockfd, FAR struct pollfd *fds, bool setup);
 
 int uds_socket(int domain, int type, int protocol);
+int uds_socketpair(int domain, int type, int protocol, int sv[2]);
 int uds_bind(int sockfd, const struct sockaddr *addr, socklen_t addrlen);
 int uds_connect(int sockfd, FAR const struct sockaddr *addr, socklen_t addrlen);
 int uds_listen(int sockfd, int backlog);
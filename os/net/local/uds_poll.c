@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <tinyara/net/net.h>
+
+#include "local/uds_socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uds_poll
+ *
+ * Description:
+ *   Setup or teardown the monitoring of events on a Unix domain socket
+ *   descriptor for poll() and select().
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of the socket
+ *   fds    - The structure describing the events to be monitored
+ *   setup  - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int uds_poll(int sockfd, FAR struct pollfd *fds, bool setup)
+{
+	FAR struct socket *psock = sockfd_socket(sockfd);
+
+	/* Verify that the sockfd corresponds to valid, allocated socket */
+
+	if (psock == NULL || psock->s_crefs <= 0) {
+		return -EBADF;
+	}
+
+	/* Let the address family's poll() method handle the operation */
+
+	DEBUGASSERT(psock->s_sockif != NULL && psock->s_sockif->si_poll != NULL);
+	return psock->s_sockif->si_poll(psock, fds, setup);
+}
+
+#endif /* CONFIG_NET */
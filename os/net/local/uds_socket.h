@@ -142,7 +142,12 @@
  * Public Function Prototypes
  ****************************************************************************/
 
+int sockfd_allocate(int minsd);
+void sockfd_release(int sockfd);
+void psock_release(FAR struct socket *psock);
 FAR struct socket *sockfd_socket(int sockfd);
+int psock_socket(int domain, int type, int protocol, FAR struct socket *psock);
+int psock_close(FAR struct socket *psock);
 FAR const struct sock_intf_s *
 net_sockif(sa_family_t family, int type, int protocol);
 
@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/socket.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include "local/local.h"
+#include "local/uds_socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uds_socketpair
+ *
+ * Description:
+ *   Create an unnamed pair of connected Unix domain sockets.  Data written
+ *   to one socket is read from the other, through in-memory buffers.
+ *
+ * Input Parameters:
+ *   domain   AF_UNIX (AF_LOCAL)
+ *   type     SOCK_STREAM or SOCK_DGRAM
+ *   protocol (see sys/socket.h)
+ *   sv       Receives the two socket descriptors
+ *
+ * Returned Value:
+ *   0 on success; -1 on error with errno set appropriately.
+ *
+ *   EAFNOSUPPORT
+ *     The specified address family is not supported.
+ *   EFAULT
+ *     'sv' is NULL.
+ *   ENFILE
+ *     No socket descriptor is available.
+ *   ENOMEM
+ *     The buffers of the connection could not be allocated.
+ *   EPROTONOSUPPORT
+ *     The specified protocol is not supported within this domain.
+ *
+ ****************************************************************************/
+
+int uds_socketpair(int domain, int type, int protocol, int sv[2])
+{
+	FAR struct socket *psock[2];
+	int sockfd[2] = { -1, -1 };
+	int errcode;
+	int ret;
+	int i;
+
+	if (sv == NULL) {
+		errcode = EFAULT;
+		goto errout;
+	}
+
+	if (domain != AF_LOCAL) {
+		errcode = EAFNOSUPPORT;
+		goto errout;
+	}
+
+	/* Allocate and initialize both sockets */
+
+	for (i = 0; i < 2; i++) {
+		sockfd[i] = sockfd_allocate(0);
+		if (sockfd[i] < 0) {
+			ndbg("ERROR: Failed to allocate a socket descriptor\n");
+			errcode = ENFILE;
+			goto errout_with_sockfd;
+		}
+
+		psock[i] = sockfd_socket(sockfd[i]);
+		if (!psock[i]) {
+			errcode = ENOSYS; /* should not happen */
+			goto errout_with_sockfd;
+		}
+
+		ret = psock_socket(domain, type, protocol, psock[i]);
+		if (ret < 0) {
+			ndbg("ERROR: psock_socket() failed: %d\n", ret);
+			errcode = -ret;
+			goto errout_with_sockfd;
+		}
+	}
+
+	/* Then join them together */
+
+	ret = psock_local_socketpair(psock[0], psock[1]);
+	if (ret < 0) {
+		ndbg("ERROR: psock_local_socketpair() failed: %d\n", ret);
+		errcode = -ret;
+		goto errout_with_sockfd;
+	}
+
+	sv[0] = sockfd[0];
+	sv[1] = sockfd[1];
+	return OK;
+
+errout_with_sockfd:
+	for (i = 0; i < 2; i++) {
+		if (sockfd[i] < 0) {
+			continue;
+		}
+
+		/* Release the connection as well if psock_socket() attached one */
+
+		psock[i] = sockfd_socket(sockfd[i]);
+		if (psock[i] != NULL && psock[i]->s_conn != NULL) {
+			psock_close(psock[i]);
+		} else {
+			sockfd_release(sockfd[i]);
+		}
+	}
+
+errout:
+	set_errno(errcode);
+	return ERROR;
+}
+
+#endif /* CONFIG_NET */
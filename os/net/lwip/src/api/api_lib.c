@@ -702,19 +702,44 @@ err_t netconn_send(struct netconn *conn, struct netbuf *buf)
 }
 
 /**
- * Send data over a TCP netconn.
+ * Send several netbufs over a UDP or RAW netconn with a single call to the
+ * tcpip thread. The netbufs are sent in order until one fails.
  *
- * @param conn the TCP netconn over which to send data
- * @param dataptr pointer to the application buffer that contains the data to send
- * @param size size of the application data to send
- * @param apiflags combination of following flags :
- * - NETCONN_COPY: data will be copied into memory belonging to the stack
- * - NETCONN_MORE: for TCP connection, PSH flag will be set on last segment sent
- * - NETCONN_DONTBLOCK: only write the data if all data can be written at once
- * @param bytes_written pointer to a location that receives the number of written bytes
- * @return ERR_OK if data was sent, any other err_t on error
+ * @param conn the UDP or RAW netconn over which to send data
+ * @param bufs array of netbufs containing the data to send
+ * @param count number of netbufs in bufs
+ * @param sent pointer to a location that receives the number of netbufs sent
+ * @return ERR_OK if all netbufs were sent, else the error of the first one
+ *         that was not sent
  */
-err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written)
+err_t netconn_sendv(struct netconn *conn, struct netbuf **bufs, u16_t count, u16_t *sent)
+{
+	API_MSG_VAR_DECLARE(msg);
+	err_t err;
+
+	LWIP_ERROR("netconn_sendv: invalid conn", (conn != NULL), return ERR_ARG;);
+	LWIP_ERROR("netconn_sendv: invalid bufs", (bufs != NULL) && (sent != NULL), return ERR_ARG;);
+
+	LWIP_DEBUGF(API_LIB_DEBUG, ("netconn_sendv: sending %" U16_F " netbufs\n", count));
+
+	API_MSG_VAR_ALLOC(msg);
+	API_MSG_VAR_REF(msg).conn = conn;
+	API_MSG_VAR_REF(msg).msg.bv.bufs = bufs;
+	API_MSG_VAR_REF(msg).msg.bv.count = count;
+	API_MSG_VAR_REF(msg).msg.bv.sent = 0;
+	err = netconn_apimsg(lwip_netconn_do_sendv, &API_MSG_VAR_REF(msg));
+	*sent = API_MSG_VAR_REF(msg).msg.bv.sent;
+	API_MSG_VAR_FREE(msg);
+
+	return err;
+}
+
+/**
+ * Common part of netconn_write_partly() and netconn_write_zc().
+ * If *zc is set to NULL on return, the zero-copy write has been registered
+ * with the netconn.
+ */
+static err_t netconn_write_internal(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written, struct netconn_zc **zc)
 {
 	API_MSG_VAR_DECLARE(msg);
 	err_t err;
@@ -752,6 +777,11 @@ err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t siz
 		API_MSG_VAR_REF(msg).msg.w.time_started = 0;
 	}
 #endif							/* LWIP_SO_SNDTIMEO */
+#if LWIP_NETCONN_ZEROCOPY
+	API_MSG_VAR_REF(msg).msg.w.zc = (zc != NULL) ? *zc : NULL;
+#else
+	LWIP_UNUSED_ARG(zc);
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 
 	/* For locking the core: this _can_ be delayed on low memory/low send buffer,
 	   but if it is, this is done inside api_msg.c:do_write(), so we can use the
@@ -766,11 +796,72 @@ err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t siz
 			*bytes_written = size;
 		}
 	}
+#if LWIP_NETCONN_ZEROCOPY
+	if (zc != NULL) {
+		*zc = API_MSG_VAR_REF(msg).msg.w.zc;
+	}
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 	API_MSG_VAR_FREE(msg);
 
 	return err;
 }
 
+/**
+ * Send data over a TCP netconn.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param dataptr pointer to the application buffer that contains the data to send
+ * @param size size of the application data to send
+ * @param apiflags combination of following flags :
+ * - NETCONN_COPY: data will be copied into memory belonging to the stack
+ * - NETCONN_MORE: for TCP connection, PSH flag will be set on last segment sent
+ * - NETCONN_DONTBLOCK: only write the data if all data can be written at once
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @return ERR_OK if data was sent, any other err_t on error
+ */
+err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written)
+{
+	return netconn_write_internal(conn, dataptr, size, apiflags, bytes_written, NULL);
+}
+
+#if LWIP_NETCONN_ZEROCOPY
+/**
+ * Send data over a TCP netconn without copying it: the data is queued by
+ * reference and must stay untouched until zc->done is called from the tcpip
+ * thread, after all segments holding it have been acknowledged or the
+ * connection has been torn down. Deleting the netconn while such data is
+ * still queued resets the connection.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param dataptr pointer to the application buffer that contains the data to send
+ * @param size size of the application data to send
+ * @param apiflags NETCONN_MORE and NETCONN_DONTBLOCK (NETCONN_COPY is ignored)
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @param zc completion record with zc->done set, owned by the stack until
+ *           zc->done is called
+ * @return ERR_OK if data was queued and zc->done will be called, any other
+ *         err_t if nothing was queued (zc is not used then)
+ */
+err_t netconn_write_zc(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written, struct netconn_zc *zc)
+{
+	struct netconn_zc *pending = zc;
+	err_t err;
+
+	LWIP_ERROR("netconn_write_zc: invalid zc", (zc != NULL) && (zc->done != NULL), return ERR_ARG;);
+	LWIP_ERROR("netconn_write_zc: invalid size", (size > 0), return ERR_ARG;);
+
+	err = netconn_write_internal(conn, dataptr, size, apiflags & ~NETCONN_COPY, bytes_written, &pending);
+	if (pending == NULL) {
+		/* registered: the data is referenced by the pcb */
+		if ((err != ERR_OK) && (bytes_written != NULL)) {
+			*bytes_written = 0;
+		}
+		return ERR_OK;
+	}
+	return (err == ERR_OK) ? ERR_BUF : err;
+}
+#endif							/* LWIP_NETCONN_ZEROCOPY */
+
 /**
  * Close ot shutdown a TCP netconn (doesn't delete it).
  *
@@ -70,6 +70,9 @@
 #include "lwip/dns.h"
 #include "lwip/mld6.h"
 #include "lwip/priv/tcpip_priv.h"
+#if LWIP_NETCONN_ZEROCOPY
+#include "lwip/priv/tcp_priv.h"
+#endif
 
 #include <string.h>
 
@@ -343,6 +346,49 @@ static err_t poll_tcp(void *arg, struct tcp_pcb *pcb)
 	return ERR_OK;
 }
 
+#if LWIP_NETCONN_ZEROCOPY
+/**
+ * Append a zero-copy write that has just been queued on the pcb: its data
+ * ends where the pcb's send buffer ends.
+ */
+static void netconn_zc_add(struct netconn *conn, struct netconn_zc *zc)
+{
+	struct netconn_zc **link;
+
+	zc->next = NULL;
+	zc->end = conn->pcb.tcp->snd_lbb;
+	for (link = &conn->zc_sends; *link != NULL; link = &(*link)->next) ;
+	*link = zc;
+}
+
+/**
+ * Complete the zero-copy writes whose data is no longer referenced by any
+ * queued segment. With err != ERR_OK or without a pcb, all writes are
+ * completed with that error.
+ */
+static void netconn_zc_complete(struct netconn *conn, err_t err)
+{
+	struct netconn_zc *zc;
+	struct tcp_seg *seg = NULL;
+
+	if ((err == ERR_OK) && (conn->pcb.tcp != NULL)) {
+		/* the oldest segment still queued: data ending at or before its
+		   start is referenced by no segment any more */
+		seg = (conn->pcb.tcp->unacked != NULL) ? conn->pcb.tcp->unacked : conn->pcb.tcp->unsent;
+	} else if (err == ERR_OK) {
+		err = ERR_CLSD;
+	}
+
+	while ((zc = conn->zc_sends) != NULL) {
+		if ((err == ERR_OK) && (seg != NULL) && TCP_SEQ_LT(lwip_ntohl(seg->tcphdr->seqno), zc->end)) {
+			break;
+		}
+		conn->zc_sends = zc->next;
+		zc->done(zc, err);
+	}
+}
+#endif							/* LWIP_NETCONN_ZEROCOPY */
+
 /**
  * Sent callback function for TCP netconns.
  * Signals the conn->sem and calls API_EVENT.
@@ -363,6 +409,11 @@ static err_t sent_tcp(void *arg, struct tcp_pcb *pcb, u16_t len)
 		} else if (conn->state == NETCONN_CLOSE) {
 			lwip_netconn_do_close_internal(conn WRITE_DELAYED);
 		}
+#if LWIP_NETCONN_ZEROCOPY
+		if (conn->zc_sends != NULL) {
+			netconn_zc_complete(conn, ERR_OK);
+		}
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 
 		/* If the queued byte- or pbuf-count drops below the configured low-water limit,
 		   let select mark this pcb as writable again. */
@@ -391,6 +442,10 @@ static void err_tcp(void *arg, err_t err)
 	LWIP_ASSERT("conn != NULL", (conn != NULL));
 
 	conn->pcb.tcp = NULL;
+#if LWIP_NETCONN_ZEROCOPY
+	/* the pcb and its segments are gone: nothing references the data any more */
+	netconn_zc_complete(conn, (err != ERR_OK) ? err : ERR_ABRT);
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 
 	/* reset conn->state now before waking up other threads */
 	old_state = conn->state;
@@ -710,6 +765,9 @@ struct netconn *netconn_alloc(enum netconn_type t, netconn_callback callback)
 #if LWIP_TCP
 	conn->current_msg = NULL;
 	conn->write_offset = 0;
+#if LWIP_NETCONN_ZEROCOPY
+	conn->zc_sends = NULL;
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 #endif							/* LWIP_TCP */
 #if LWIP_SO_SNDTIMEO
 	conn->send_timeout = 0;
@@ -743,6 +801,9 @@ void netconn_free(struct netconn *conn)
 	LWIP_ASSERT("recvmbox must be deallocated before calling this function", !sys_mbox_valid(&conn->recvmbox));
 #if LWIP_TCP
 	LWIP_ASSERT("acceptmbox must be deallocated before calling this function", !sys_mbox_valid(&conn->acceptmbox));
+#if LWIP_NETCONN_ZEROCOPY
+	LWIP_ASSERT("zero-copy writes must be completed before calling this function", conn->zc_sends == NULL);
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 #endif							/* LWIP_TCP */
 
 #if !LWIP_NETCONN_SEM_PER_THREAD
@@ -1052,6 +1113,15 @@ void lwip_netconn_do_delconn(void *m)
 		/* Drain and delete mboxes */
 		netconn_drain(msg->conn);
 
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+		if ((msg->conn->zc_sends != NULL) && (msg->conn->pcb.tcp != NULL)) {
+			/* A graceful close would leave the pcb sending the caller's
+			   buffers after the netconn is gone: reset the connection
+			   instead, err_tcp() completes the writes */
+			tcp_abort(msg->conn->pcb.tcp);
+		}
+#endif							/* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
+
 		if (msg->conn->pcb.tcp != NULL) {
 
 			switch (NETCONNTYPE_GROUP(msg->conn->type)) {
@@ -1369,50 +1439,86 @@ void lwip_netconn_do_listen(void *m)
 #endif							/* LWIP_TCP */
 
 /**
- * Send some data on a RAW or UDP pcb contained in a netconn
- * Called from netconn_send
+ * Send one netbuf on a UDP or RAW netconn.
+ * Called from lwip_netconn_do_send and lwip_netconn_do_sendv.
  *
- * @param m the api_msg_msg pointing to the connection
+ * @param conn the UDP or RAW netconn
+ * @param buf the netbuf to send
+ * @return the result of the raw or udp send function
  */
-void lwip_netconn_do_send(void *m)
+static err_t netconn_send_netbuf(struct netconn *conn, struct netbuf *buf)
 {
-	struct api_msg *msg = (struct api_msg *)m;
+	err_t err;
 
-	if (ERR_IS_FATAL(msg->conn->last_err)) {
-		msg->err = msg->conn->last_err;
-	} else {
-		msg->err = ERR_CONN;
-		if (msg->conn->pcb.tcp != NULL) {
-			switch (NETCONNTYPE_GROUP(msg->conn->type)) {
+	if (ERR_IS_FATAL(conn->last_err)) {
+		return conn->last_err;
+	}
+	err = ERR_CONN;
+	if (conn->pcb.tcp != NULL) {
+		switch (NETCONNTYPE_GROUP(conn->type)) {
 #if LWIP_RAW
-			case NETCONN_RAW:
-				if (ip_addr_isany(&msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = raw_send(msg->conn->pcb.raw, msg->msg.b->p);
-				} else {
-					msg->err = raw_sendto(msg->conn->pcb.raw, msg->msg.b->p, &msg->msg.b->addr);
-				}
-				break;
+		case NETCONN_RAW:
+			if (ip_addr_isany(&buf->addr) || IP_IS_ANY_TYPE_VAL(buf->addr)) {
+				err = raw_send(conn->pcb.raw, buf->p);
+			} else {
+				err = raw_sendto(conn->pcb.raw, buf->p, &buf->addr);
+			}
+			break;
 #endif
 #if LWIP_UDP
-			case NETCONN_UDP:
+		case NETCONN_UDP:
 #if LWIP_CHECKSUM_ON_COPY
-				if (ip_addr_isany(&msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = udp_send_chksum(msg->conn->pcb.udp, msg->msg.b->p, msg->msg.b->flags & NETBUF_FLAG_CHKSUM, msg->msg.b->toport_chksum);
-				} else {
-					msg->err = udp_sendto_chksum(msg->conn->pcb.udp, msg->msg.b->p, &msg->msg.b->addr, msg->msg.b->port, msg->msg.b->flags & NETBUF_FLAG_CHKSUM, msg->msg.b->toport_chksum);
-				}
+			if (ip_addr_isany(&buf->addr) || IP_IS_ANY_TYPE_VAL(buf->addr)) {
+				err = udp_send_chksum(conn->pcb.udp, buf->p, buf->flags & NETBUF_FLAG_CHKSUM, buf->toport_chksum);
+			} else {
+				err = udp_sendto_chksum(conn->pcb.udp, buf->p, &buf->addr, buf->port, buf->flags & NETBUF_FLAG_CHKSUM, buf->toport_chksum);
+			}
 #else							/* LWIP_CHECKSUM_ON_COPY */
-				if (ip_addr_isany_val(msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = udp_send(msg->conn->pcb.udp, msg->msg.b->p);
-				} else {
-					msg->err = udp_sendto(msg->conn->pcb.udp, msg->msg.b->p, &msg->msg.b->addr, msg->msg.b->port);
-				}
+			if (ip_addr_isany_val(buf->addr) || IP_IS_ANY_TYPE_VAL(buf->addr)) {
+				err = udp_send(conn->pcb.udp, buf->p);
+			} else {
+				err = udp_sendto(conn->pcb.udp, buf->p, &buf->addr, buf->port);
+			}
 #endif							/* LWIP_CHECKSUM_ON_COPY */
-				break;
+			break;
 #endif							/* LWIP_UDP */
-			default:
-				break;
-			}
+		default:
+			break;
+		}
+	}
+	return err;
+}
+
+/**
+ * Send some data on a RAW or UDP pcb contained in a netconn
+ * Called from netconn_send
+ *
+ * @param m the api_msg_msg pointing to the connection
+ */
+void lwip_netconn_do_send(void *m)
+{
+	struct api_msg *msg = (struct api_msg *)m;
+
+	msg->err = netconn_send_netbuf(msg->conn, msg->msg.b);
+	TCPIP_APIMSG_ACK(msg);
+}
+
+/**
+ * Send several netbufs on a UDP or RAW netconn in one call of the tcpip
+ * thread. Stops at the first netbuf that could not be sent.
+ * Called from netconn_sendv
+ *
+ * @param m the api_msg_msg pointing to the connection
+ */
+void lwip_netconn_do_sendv(void *m)
+{
+	struct api_msg *msg = (struct api_msg *)m;
+
+	msg->err = ERR_OK;
+	for (msg->msg.bv.sent = 0; msg->msg.bv.sent < msg->msg.bv.count; msg->msg.bv.sent++) {
+		msg->err = netconn_send_netbuf(msg->conn, msg->msg.bv.bufs[msg->msg.bv.sent]);
+		if (msg->err != ERR_OK) {
+			break;
 		}
 	}
 	TCPIP_APIMSG_ACK(msg);
@@ -1597,6 +1703,13 @@ err_mem:
 		/* everything was written: set back connection state
 		   and back to application task */
 		sys_sem_t *op_completed_sem = LWIP_API_MSG_SEM(conn->current_msg);
+#if LWIP_NETCONN_ZEROCOPY
+		if ((conn->current_msg->msg.w.zc != NULL) && ((conn->write_offset > 0) || (conn->current_msg->msg.w.len > 0))) {
+			/* some data was queued by reference */
+			netconn_zc_add(conn, conn->current_msg->msg.w.zc);
+			conn->current_msg->msg.w.zc = NULL;
+		}
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 		conn->current_msg->err = err;
 		conn->current_msg = NULL;
 		conn->write_offset = 0;
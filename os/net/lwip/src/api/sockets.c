@@ -990,6 +990,143 @@ int lwip_recv(int s, void *mem, size_t len, int flags)
 	return lwip_recvfrom(s, mem, len, flags, NULL, NULL);
 }
 
+#if LWIP_UDP || LWIP_RAW
+/**
+ * Receive one datagram into a msghdr: the data is scattered over the IO
+ * vectors and the source address is stored in msg_name.
+ *
+ * @return the number of bytes stored, or -1 with the socket errno set
+ */
+static int lwip_recv_datagram(struct lwip_sock *sock, struct msghdr *msg, int flags)
+{
+	struct netbuf *buf;
+	struct pbuf *p;
+	u16_t off = 0;
+	u16_t copylen;
+	int i;
+	err_t err;
+
+	if (sock->lastdata) {
+		buf = (struct netbuf *)sock->lastdata;
+	} else {
+		if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+			sock_set_errno(sock, EWOULDBLOCK);
+			return -1;
+		}
+		err = netconn_recv(sock->conn, &buf);
+		if (err != ERR_OK) {
+			sock_set_errno(sock, err_to_errno(err));
+			return -1;
+		}
+		sock->lastdata = buf;
+	}
+
+	p = buf->p;
+	msg->msg_flags = 0;
+	for (i = 0; (i < msg->msg_iovlen) && (off < p->tot_len); i++) {
+		copylen = (u16_t)LWIP_MIN((size_t)(p->tot_len - off), msg->msg_iov[i].iov_len);
+		pbuf_copy_partial(p, msg->msg_iov[i].iov_base, copylen, off);
+		off += copylen;
+	}
+	if (off < p->tot_len) {
+		msg->msg_flags |= MSG_TRUNC;
+	}
+
+	if ((msg->msg_name != NULL) && (msg->msg_namelen > 0)) {
+		ip_addr_t fromaddr;
+		union sockaddr_aligned saddr;
+
+		ip_addr_copy(fromaddr, *netbuf_fromaddr(buf));
+#if LWIP_IPV4 && LWIP_IPV6
+		/* Dual-stack: Map IPv4 addresses to IPv4 mapped IPv6 */
+		if (NETCONNTYPE_ISIPV6(netconn_type(sock->conn)) && IP_IS_V4(&fromaddr)) {
+			ip4_2_ipv4_mapped_ipv6(ip_2_ip6(&fromaddr), ip_2_ip4(&fromaddr));
+			IP_SET_TYPE(&fromaddr, IPADDR_TYPE_V6);
+		}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+		IPADDR_PORT_TO_SOCKADDR(&saddr, &fromaddr, netbuf_fromport(buf));
+		if (msg->msg_namelen > saddr.sa.sa_len) {
+			msg->msg_namelen = saddr.sa.sa_len;
+		}
+		MEMCPY(msg->msg_name, &saddr, msg->msg_namelen);
+	}
+	msg->msg_controllen = 0;
+
+	if ((flags & MSG_PEEK) == 0) {
+		sock->lastdata = NULL;
+		sock->lastoffset = 0;
+		netbuf_delete(buf);
+	}
+
+	return off;
+}
+#endif							/* LWIP_UDP || LWIP_RAW */
+
+/**
+ * Receive up to vlen datagrams. Without MSG_WAITFORONE, every datagram is
+ * waited for as in lwip_recvfrom(); with it, only the first one. If timeout
+ * is given, no more datagrams are received once it has expired (it is only
+ * checked after each datagram). Stream sockets are not supported.
+ *
+ * @return the number of messages received, or -1 if none could be received
+ */
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	struct lwip_sock *sock;
+#if LWIP_UDP || LWIP_RAW
+	u32_t start = sys_now();
+	u32_t limit = 0;
+	unsigned int n;
+	int ret;
+#endif
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmmsg(%d, %p, %u, 0x%x)\n", s, (void *)msgvec, vlen, flags));
+	sock = get_socket(s, getpid());
+	if (!sock) {
+		return -1;
+	}
+	LWIP_ERROR("lwip_recvmmsg: invalid msgvec", (msgvec != NULL) && (vlen > 0), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		sock_set_errno(sock, EOPNOTSUPP);
+		return -1;
+	}
+
+#if LWIP_UDP || LWIP_RAW
+	if (timeout != NULL) {
+		limit = (u32_t)timeout->tv_sec * 1000 + (u32_t)timeout->tv_nsec / 1000000;
+	}
+
+	for (n = 0; n < vlen; n++) {
+		ret = lwip_recv_datagram(sock, &msgvec[n].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+		msgvec[n].msg_len = (unsigned int)ret;
+		if (flags & MSG_WAITFORONE) {
+			flags |= MSG_DONTWAIT;
+		}
+		if ((timeout != NULL) && ((u32_t)(sys_now() - start) >= limit)) {
+			n++;
+			break;
+		}
+	}
+
+	if (n == 0) {
+		/* errno was set by lwip_recv_datagram() */
+		return -1;
+	}
+	/* an error after the first datagram is reported by the next call */
+	sock_set_errno(sock, 0);
+	return (int)n;
+#else							/* LWIP_UDP || LWIP_RAW */
+	LWIP_UNUSED_ARG(flags);
+	LWIP_UNUSED_ARG(timeout);
+	sock_set_errno(sock, err_to_errno(ERR_ARG));
+	return -1;
+#endif							/* LWIP_UDP || LWIP_RAW */
+}
+
 int lwip_send(int s, const void *data, size_t size, int flags)
 {
 	struct lwip_sock *sock;
@@ -1022,6 +1159,93 @@ int lwip_send(int s, const void *data, size_t size, int flags)
 	return (err == ERR_OK ? (int)written : -1);
 }
 
+#if LWIP_UDP || LWIP_RAW
+/**
+ * Set up a netbuf with the destination and the data of a msghdr for a UDP or
+ * RAW socket. The IO vectors are referenced by PBUF_REF pbufs, or flattened
+ * into one pbuf if the netif needs single-pbuf packets. The netbuf must be
+ * freed by the caller even if this fails.
+ *
+ * @param sock the socket the data will be sent on
+ * @param msg the message to send
+ * @param buf an empty netbuf
+ * @param size receives the number of bytes in the netbuf
+ * @return ERR_OK or an error if the msghdr is invalid or memory ran out
+ */
+static err_t lwip_msghdr_to_netbuf(struct lwip_sock *sock, const struct msghdr *msg, struct netbuf *buf, int *size)
+{
+	err_t err = ERR_OK;
+	int i;
+
+	LWIP_ERROR("lwip_sendmsg: invalid msghdr name", (((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || IS_SOCK_ADDR_LEN_VALID(msg->msg_namelen)), return ERR_ARG;);
+
+	*size = 0;
+	if (msg->msg_name) {
+		u16_t remote_port;
+		SOCKADDR_TO_IPADDR_PORT((const struct sockaddr *)msg->msg_name, &buf->addr, remote_port);
+		netbuf_fromport(buf) = remote_port;
+	}
+#if LWIP_NETIF_TX_SINGLE_PBUF
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		*size += msg->msg_iov[i].iov_len;
+	}
+	/* Allocate a new netbuf and copy the data into it. */
+	if (netbuf_alloc(buf, (u16_t)*size) == NULL) {
+		err = ERR_MEM;
+	} else {
+		/* flatten the IO vectors */
+		size_t offset = 0;
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			MEMCPY(&((u8_t *) buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+			offset += msg->msg_iov[i].iov_len;
+		}
+#if LWIP_CHECKSUM_ON_COPY
+		{
+			/* This can be improved by using LWIP_CHKSUM_COPY() and aggregating the checksum for each IO vector */
+			u16_t chksum = ~inet_chksum_pbuf(buf->p);
+			netbuf_set_chksum(buf, chksum);
+		}
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+	}
+#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
+	/* create a chained netbuf from the IO vectors. NOTE: we assemble a pbuf chain
+	   manually to avoid having to allocate, chain, and delete a netbuf for each iov */
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
+		if (p == NULL) {
+			err = ERR_MEM;	/* let netbuf_free() cleanup the chain */
+			break;
+		}
+		p->payload = msg->msg_iov[i].iov_base;
+		LWIP_ASSERT("iov_len < u16_t", msg->msg_iov[i].iov_len <= 0xFFFF);
+		p->len = p->tot_len = (u16_t) msg->msg_iov[i].iov_len;
+		/* netbuf empty, add new pbuf */
+		if (buf->p == NULL) {
+			buf->p = buf->ptr = p;
+			/* add pbuf to existing pbuf chain */
+		} else {
+			pbuf_cat(buf->p, p);
+		}
+	}
+	/* save size of total chain */
+	if ((err == ERR_OK) && (buf->p != NULL)) {
+		*size = netbuf_len(buf);
+	}
+#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
+
+#if LWIP_IPV4 && LWIP_IPV6
+	/* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
+	if (IP_IS_V6_VAL(buf->addr) && ip6_addr_isipv4mappedipv6(ip_2_ip6(&buf->addr))) {
+		unmap_ipv4_mapped_ipv6(ip_2_ip4(&buf->addr), ip_2_ip6(&buf->addr));
+		IP_SET_TYPE_VAL(buf->addr, IPADDR_TYPE_V4);
+	}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+	LWIP_UNUSED_ARG(sock);
+
+	return err;
+}
+#endif							/* LWIP_UDP || LWIP_RAW */
+
 int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 {
 	struct lwip_sock *sock;
@@ -1086,87 +1310,115 @@ int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 		struct netbuf *chain_buf;
 
 		LWIP_UNUSED_ARG(flags);
-		LWIP_ERROR("lwip_sendmsg: invalid msghdr name", (((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || IS_SOCK_ADDR_LEN_VALID(msg->msg_namelen)), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
 
-		/* initialize chain buffer with destination */
 		chain_buf = netbuf_new();
 		if (!chain_buf) {
 			sock_set_errno(sock, err_to_errno(ERR_MEM));
 			return -1;
 		}
-		if (msg->msg_name) {
-			u16_t remote_port;
-			SOCKADDR_TO_IPADDR_PORT((const struct sockaddr *)msg->msg_name, &chain_buf->addr, remote_port);
-			netbuf_fromport(chain_buf) = remote_port;
-		}
-#if LWIP_NETIF_TX_SINGLE_PBUF
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			size += msg->msg_iov[i].iov_len;
-		}
-		/* Allocate a new netbuf and copy the data into it. */
-		if (netbuf_alloc(chain_buf, (u16_t) size) == NULL) {
-			err = ERR_MEM;
-		} else {
-			/* flatten the IO vectors */
-			size_t offset = 0;
-			for (i = 0; i < msg->msg_iovlen; i++) {
-				MEMCPY(&((u8_t *) chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
-				offset += msg->msg_iov[i].iov_len;
-			}
-#if LWIP_CHECKSUM_ON_COPY
-			{
-				/* This can be improved by using LWIP_CHKSUM_COPY() and aggregating the checksum for each IO vector */
-				u16_t chksum = ~inet_chksum_pbuf(chain_buf->p);
-				netbuf_set_chksum(chain_buf, chksum);
-			}
-#endif							/* LWIP_CHECKSUM_ON_COPY */
-			err = ERR_OK;
+		err = lwip_msghdr_to_netbuf(sock, msg, chain_buf, &size);
+		if (err == ERR_OK) {
+			/* send the data */
+			err = netconn_send(sock->conn, chain_buf);
 		}
-#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
-		/* create a chained netbuf from the IO vectors. NOTE: we assemble a pbuf chain
-		   manually to avoid having to allocate, chain, and delete a netbuf for each iov */
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
-			if (p == NULL) {
-				err = ERR_MEM;	/* let netbuf_delete() cleanup chain_buf */
+
+		/* deallocated the buffer */
+		netbuf_delete(chain_buf);
+
+		sock_set_errno(sock, err_to_errno(err));
+		return (err == ERR_OK ? size : -1);
+	}
+#else							/* LWIP_UDP || LWIP_RAW */
+	sock_set_errno(sock, err_to_errno(ERR_ARG));
+	return -1;
+#endif							/* LWIP_UDP || LWIP_RAW */
+}
+
+/**
+ * Send up to vlen messages. For UDP and RAW sockets the datagrams are handed
+ * to the tcpip thread in batches of LWIP_SOCKET_MMSG_BATCH, each with one
+ * message. Stream sockets send the messages one by one with lwip_sendmsg().
+ *
+ * @return the number of messages sent, or -1 if none could be sent
+ */
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	struct lwip_sock *sock;
+	unsigned int done = 0;
+	err_t err = ERR_OK;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_sendmmsg(%d, %p, %u, 0x%x)\n", s, (void *)msgvec, vlen, flags));
+	sock = get_socket(s, getpid());
+	if (!sock) {
+		return -1;
+	}
+	LWIP_ERROR("lwip_sendmmsg: invalid msgvec", (msgvec != NULL) && (vlen > 0), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		int ret;
+
+		for (done = 0; done < vlen; done++) {
+			ret = lwip_sendmsg(s, &msgvec[done].msg_hdr, flags);
+			if (ret < 0) {
 				break;
 			}
-			p->payload = msg->msg_iov[i].iov_base;
-			LWIP_ASSERT("iov_len < u16_t", msg->msg_iov[i].iov_len <= 0xFFFF);
-			p->len = p->tot_len = (u16_t) msg->msg_iov[i].iov_len;
-			/* netbuf empty, add new pbuf */
-			if (chain_buf->p == NULL) {
-				chain_buf->p = chain_buf->ptr = p;
-				/* add pbuf to existing pbuf chain */
-			} else {
-				pbuf_cat(chain_buf->p, p);
-			}
+			msgvec[done].msg_len = (unsigned int)ret;
 		}
-		/* save size of total chain */
-		if (err == ERR_OK) {
-			size = netbuf_len(chain_buf);
+		if (done == 0) {
+			return -1;
 		}
-#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
+		sock_set_errno(sock, 0);
+		return (int)done;
+	}
 
-		if (err == ERR_OK) {
-#if LWIP_IPV4 && LWIP_IPV6
-			/* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
-			if (IP_IS_V6_VAL(chain_buf->addr) && ip6_addr_isipv4mappedipv6(ip_2_ip6(&chain_buf->addr))) {
-				unmap_ipv4_mapped_ipv6(ip_2_ip4(&chain_buf->addr), ip_2_ip6(&chain_buf->addr));
-				IP_SET_TYPE_VAL(chain_buf->addr, IPADDR_TYPE_V4);
+#if LWIP_UDP || LWIP_RAW
+	while ((done < vlen) && (err == ERR_OK)) {
+		struct netbuf bufs[LWIP_SOCKET_MMSG_BATCH];
+		struct netbuf *bufp[LWIP_SOCKET_MMSG_BATCH];
+		int sizes[LWIP_SOCKET_MMSG_BATCH];
+		struct msghdr *hdr;
+		u16_t n;
+		u16_t sent = 0;
+		u16_t i;
+
+		/* build the netbufs of one batch */
+		for (n = 0; (n < LWIP_SOCKET_MMSG_BATCH) && (done + n < vlen); n++) {
+			hdr = &msgvec[done + n].msg_hdr;
+			memset(&bufs[n], 0, sizeof(struct netbuf));
+			bufp[n] = &bufs[n];
+			if ((hdr->msg_iov == NULL) || (hdr->msg_iovlen == 0)) {
+				err = ERR_ARG;
+			} else {
+				err = lwip_msghdr_to_netbuf(sock, hdr, &bufs[n], &sizes[n]);
 			}
-#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+			if (err != ERR_OK) {
+				netbuf_free(&bufs[n]);
+				break;
+			}
+		}
 
-			/* send the data */
-			err = netconn_send(sock->conn, chain_buf);
+		if (n > 0) {
+			err_t send_err = netconn_sendv(sock->conn, bufp, n, &sent);
+			if (send_err != ERR_OK) {
+				err = send_err;
+			}
 		}
 
-		/* deallocated the buffer */
-		netbuf_delete(chain_buf);
+		for (i = 0; i < n; i++) {
+			if (i < sent) {
+				msgvec[done + i].msg_len = (unsigned int)sizes[i];
+			}
+			netbuf_free(&bufs[i]);
+		}
+		done += sent;
+	}
 
+	if (done == 0) {
 		sock_set_errno(sock, err_to_errno(err));
-		return (err == ERR_OK ? size : -1);
+		return -1;
 	}
+	sock_set_errno(sock, 0);
+	return (int)done;
 #else							/* LWIP_UDP || LWIP_RAW */
 	sock_set_errno(sock, err_to_errno(ERR_ARG));
 	return -1;
@@ -1327,6 +1579,262 @@ int lwip_writev(int s, const struct iovec *iov, int iovcnt)
 	return lwip_sendmsg(s, &msg, 0);
 }
 
+#if LWIP_SOCKET_ZEROCOPY
+#if !LWIP_NETCONN_ZEROCOPY || !LWIP_SUPPORT_CUSTOM_PBUF
+#error "LWIP_SOCKET_ZEROCOPY needs LWIP_NETCONN_ZEROCOPY and LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+/** Completion record of one lwip_send_zc() call */
+struct lwip_zc_send {
+	union {
+#if LWIP_TCP
+		struct netconn_zc tcp;
+#endif
+		struct pbuf_custom dgram;
+	} u;
+	void (*done)(void *arg, int result);
+	void *arg;
+};
+
+#if LWIP_TCP
+/** netconn_zc callback: all segments referencing the data are gone */
+static void lwip_send_zc_tcp_done(struct netconn_zc *zc, err_t err)
+{
+	struct lwip_zc_send *zs = (struct lwip_zc_send *)zc;
+
+	zs->done(zs->arg, err == ERR_OK ? 0 : -err_to_errno(err));
+	mem_free(zs);
+}
+#endif							/* LWIP_TCP */
+
+/** pbuf_custom free function: the last reference to the datagram is gone */
+static void lwip_send_zc_dgram_free(struct pbuf *p)
+{
+	struct lwip_zc_send *zs = (struct lwip_zc_send *)p;
+
+	if (zs->done != NULL) {
+		zs->done(zs->arg, 0);
+	}
+	mem_free(zs);
+}
+
+/**
+ * Receive data without copying it: the iovec array is filled with pointers
+ * into the received pbufs.  On return, *iovcnt holds the number of entries
+ * used and *zcbuf a handle that keeps the pbufs alive until it is passed to
+ * lwip_recv_zc_release().  For datagram sockets one call returns at most one
+ * datagram, which is truncated if it does not fit into *iovcnt entries.
+ *
+ * @return the number of bytes described by iov, 0 on end of stream, -1 on error
+ */
+int lwip_recv_zc(int s, struct iovec *iov, int *iovcnt, void **zcbuf, int flags)
+{
+	struct lwip_sock *sock;
+	void *buf = NULL;
+	struct pbuf *p;
+	struct pbuf *q;
+	u16_t offset;
+	int total = 0;
+	int n = 0;
+	err_t err;
+	u8_t is_tcp;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_zc(%d, 0x%x)\n", s, flags));
+	sock = get_socket(s, getpid());
+	if (!sock) {
+		return -1;
+	}
+	if ((iov == NULL) || (iovcnt == NULL) || (*iovcnt <= 0) || (zcbuf == NULL)) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+	*zcbuf = NULL;
+	is_tcp = (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP);
+
+	if (sock->lastdata) {
+		buf = sock->lastdata;
+	} else {
+		if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_zc(%d): returning EWOULDBLOCK\n", s));
+			set_errno(EWOULDBLOCK);
+			return -1;
+		}
+		if (is_tcp) {
+			err = netconn_recv_tcp_pbuf(sock->conn, (struct pbuf **)&buf);
+		} else {
+			err = netconn_recv(sock->conn, (struct netbuf **)&buf);
+		}
+		if (err != ERR_OK) {
+			sock_set_errno(sock, err_to_errno(err));
+			if (err == ERR_CLSD) {
+				sock->conn->last_err = ERR_OK;
+				*iovcnt = 0;
+				return 0;
+			}
+			return -1;
+		}
+		LWIP_ASSERT("buf != NULL", buf != NULL);
+		sock->lastdata = buf;
+		sock->lastoffset = 0;
+	}
+
+	p = is_tcp ? (struct pbuf *)buf : ((struct netbuf *)buf)->p;
+
+	/* skip what has already been consumed, then lend the rest */
+	offset = sock->lastoffset;
+	for (q = p; (q != NULL) && (offset >= q->len); q = q->next) {
+		offset -= q->len;
+	}
+	for (; (q != NULL) && (n < *iovcnt); q = q->next) {
+		if (q->len > offset) {
+			iov[n].iov_base = (u8_t *)q->payload + offset;
+			iov[n].iov_len = q->len - offset;
+			total += q->len - offset;
+			n++;
+		}
+		offset = 0;
+	}
+
+	/* the handle references the whole chain, independent of lastdata */
+	pbuf_ref(p);
+	*zcbuf = p;
+	*iovcnt = n;
+
+	if ((flags & MSG_PEEK) == 0) {
+		if (is_tcp && (p->tot_len - sock->lastoffset - total > 0)) {
+			sock->lastoffset += (u16_t)total;
+		} else {
+			sock->lastdata = NULL;
+			sock->lastoffset = 0;
+			if (is_tcp) {
+				pbuf_free((struct pbuf *)buf);
+			} else {
+				netbuf_delete((struct netbuf *)buf);
+			}
+		}
+	}
+
+	sock_set_errno(sock, 0);
+	return total;
+}
+
+/** Give back the buffers lent by lwip_recv_zc() */
+void lwip_recv_zc_release(void *zcbuf)
+{
+	if (zcbuf != NULL) {
+		pbuf_free((struct pbuf *)zcbuf);
+	}
+}
+
+/**
+ * Send data without copying it.  The data must stay untouched until done is
+ * called with 0 or a negative errno value: for TCP once all data has been
+ * acknowledged by the peer (from the tcpip thread), for datagrams once the
+ * last reference to the packet has been dropped.  done is not called if this
+ * function returns -1.  Only TCP and UDP sockets are supported, and a UDP
+ * socket needs a peer set by connect(), else EDESTADDRREQ is returned.
+ *
+ * @return the number of bytes queued or -1 on error
+ */
+int lwip_send_zc(int s, const void *data, size_t size, int flags, void (*done)(void *arg, int result), void *arg)
+{
+	struct lwip_sock *sock;
+	struct lwip_zc_send *zs;
+	err_t err;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_zc(%d, data=%p, size=%" SZT_F ", flags=0x%x)\n", s, data, size, flags));
+	sock = get_socket(s, getpid());
+	if (!sock) {
+		return -1;
+	}
+	if ((data == NULL) || (size == 0) || (done == NULL)) {
+		sock_set_errno(sock, EINVAL);
+		return -1;
+	}
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_RAW) {
+		/* raw netconns never report a peer, see lwip_netconn_do_getaddr() */
+		sock_set_errno(sock, EOPNOTSUPP);
+		return -1;
+	}
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_UDP) {
+		ip_addr_t remote;
+		u16_t port;
+
+		/* there is no address argument: datagrams go to the connected peer */
+		if (netconn_peer(sock->conn, &remote, &port) != ERR_OK) {
+			sock_set_errno(sock, EDESTADDRREQ);
+			return -1;
+		}
+	}
+
+	zs = (struct lwip_zc_send *)mem_malloc(sizeof(struct lwip_zc_send));
+	if (zs == NULL) {
+		sock_set_errno(sock, ENOMEM);
+		return -1;
+	}
+	zs->done = done;
+	zs->arg = arg;
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+#if LWIP_TCP
+		size_t written = 0;
+		u8_t write_flags = ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
+
+		zs->u.tcp.done = lwip_send_zc_tcp_done;
+		err = netconn_write_zc(sock->conn, data, size, write_flags, &written, &zs->u.tcp);
+		if (err != ERR_OK) {
+			mem_free(zs);
+			sock_set_errno(sock, err_to_errno(err));
+			return -1;
+		}
+		/* zs now belongs to the netconn */
+		sock_set_errno(sock, 0);
+		return (int)written;
+#else							/* LWIP_TCP */
+		err = ERR_ARG;
+#endif							/* LWIP_TCP */
+	} else {
+#if LWIP_NETIF_TX_SINGLE_PBUF
+		/* drivers want the packet in one buffer anyway: copy it */
+		int ret;
+
+		mem_free(zs);
+		ret = lwip_sendto(s, data, size, flags, NULL, 0);
+		if (ret >= 0) {
+			done(arg, 0);
+		}
+		return ret;
+#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
+		struct netbuf buf;
+
+		LWIP_ERROR("lwip_send_zc: size must fit in u16_t", size <= 0xffff, mem_free(zs); sock_set_errno(sock, EMSGSIZE); return -1;);
+		zs->u.dgram.custom_free_function = lwip_send_zc_dgram_free;
+		memset(&buf, 0, sizeof(buf));
+		buf.p = pbuf_alloced_custom(PBUF_RAW, (u16_t)size, PBUF_REF, &zs->u.dgram, LWIP_CONST_CAST(void *, data), (u16_t)size);
+		buf.ptr = buf.p;
+		/* an unset address sends to the connected peer, checked above */
+		ip_addr_set_any(NETCONNTYPE_ISIPV6(netconn_type(sock->conn)), &buf.addr);
+		netbuf_fromport(&buf) = 0;
+
+		err = netconn_send(sock->conn, &buf);
+		if (err != ERR_OK) {
+			/* not sent: no completion, the caller keeps its buffer */
+			zs->done = NULL;
+		}
+		/* drop our reference, done runs when the last one goes */
+		pbuf_free(buf.p);
+		if (err == ERR_OK) {
+			sock_set_errno(sock, 0);
+			return (int)size;
+		}
+#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
+	}
+
+	sock_set_errno(sock, err_to_errno(err));
+	return -1;
+}
+#endif							/* LWIP_SOCKET_ZEROCOPY */
+
 #if LWIP_SELECT
 
 /**
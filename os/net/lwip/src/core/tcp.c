@@ -142,6 +142,13 @@ struct tcp_pcb **const tcp_pcb_lists[] = { &tcp_listen_pcbs.pcbs, &tcp_bound_pcb
 		   &tcp_active_pcbs, &tcp_tw_pcbs
 };
 
+#if LWIP_TCP_PCB_HASH
+/** Active and TIME-WAIT PCBs hashed on the 4-tuple */
+struct tcp_pcb *tcp_conn_hash[TCP_PCB_HASH_SIZE];
+/** Listening PCBs indexed by local port */
+struct tcp_pcb_listen *tcp_listen_hash[TCP_LISTEN_HASH_SIZE];
+#endif							/* LWIP_TCP_PCB_HASH */
+
 u8_t tcp_active_pcbs_changed;
 
 /** Timer counter to handle calling slow-timer from tcp_tmr() */
@@ -1104,6 +1111,7 @@ tcp_slowtmr_start:
 			enum tcp_state last_state;
 			tcp_pcb_purge(pcb);
 			/* Remove PCB from tcp_active_pcbs list. */
+			TCP_HASH_RMV(&tcp_active_pcbs, pcb);
 			if (prev != NULL) {
 				LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_active_pcbs", pcb != tcp_active_pcbs);
 				prev->next = pcb->next;
@@ -1168,6 +1176,7 @@ tcp_slowtmr_start:
 			struct tcp_pcb *pcb2;
 			tcp_pcb_purge(pcb);
 			/* Remove PCB from tcp_tw_pcbs list. */
+			TCP_HASH_RMV(&tcp_tw_pcbs, pcb);
 			if (prev != NULL) {
 				LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_tw_pcbs", pcb != tcp_tw_pcbs);
 				prev->next = pcb->next;
@@ -1793,6 +1802,98 @@ void tcp_pcb_remove(struct tcp_pcb **pcblist, struct tcp_pcb *pcb)
 	LWIP_ASSERT("tcp_pcb_remove: tcp_pcbs_sane()", tcp_pcbs_sane());
 }
 
+#if LWIP_TCP_PCB_HASH
+/**
+ * Calculates the tcp_conn_hash bucket of a connection. The local address is
+ * left out so that the index can be computed from a PCB before and after it
+ * is bound to an interface address.
+ *
+ * @param local_port local port of the connection (host byte order)
+ * @param remote_port remote port of the connection (host byte order)
+ * @param remote_ip remote IP address of the connection
+ * @return index into tcp_conn_hash
+ */
+u16_t tcp_conn_hash_index(u16_t local_port, u16_t remote_port, const ip_addr_t *remote_ip)
+{
+	u32_t h;
+
+#if LWIP_IPV6
+	if (IP_IS_V6(remote_ip)) {
+		const u32_t *addr = ip_2_ip6(remote_ip)->addr;
+		h = addr[0] ^ addr[1] ^ addr[2] ^ addr[3];
+	} else
+#endif							/* LWIP_IPV6 */
+	{
+#if LWIP_IPV4
+		h = ip4_addr_get_u32(ip_2_ip4(remote_ip));
+#else
+		h = 0;
+#endif							/* LWIP_IPV4 */
+	}
+
+	h ^= ((u32_t)remote_port << 16) | local_port;
+	h ^= h >> 16;
+	h *= 0x45d9f3bU;
+	h ^= h >> 16;
+
+	return (u16_t)(h & (TCP_PCB_HASH_SIZE - 1));
+}
+
+/**
+ * Returns the lookup table bucket a PCB belongs to when it is on the given
+ * list, or NULL if PCBs on that list are not hashed (tcp_bound_pcbs).
+ */
+static struct tcp_pcb **tcp_pcb_hash_bucket(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+	if (pcbs == &tcp_active_pcbs || pcbs == &tcp_tw_pcbs) {
+		return &tcp_conn_hash[tcp_conn_hash_index(pcb->local_port, pcb->remote_port, &pcb->remote_ip)];
+	}
+	if (pcbs == &tcp_listen_pcbs.pcbs) {
+		return (struct tcp_pcb **)&tcp_listen_hash[TCP_LISTEN_HASH(pcb->local_port)];
+	}
+	return NULL;
+}
+
+/**
+ * Adds a PCB that has just been put on a PCB list to the matching lookup
+ * table. Called from TCP_REG.
+ *
+ * @param pcbs PCB list the pcb was added to
+ * @param pcb the tcp_pcb (or tcp_pcb_listen) to add
+ */
+void tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+	struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, pcb);
+
+	if (bucket != NULL) {
+		pcb->hash_next = *bucket;
+		*bucket = pcb;
+	}
+}
+
+/**
+ * Removes a PCB that is about to be taken off a PCB list from the matching
+ * lookup table. Called from TCP_RMV and wherever a list is unlinked by hand.
+ *
+ * @param pcbs PCB list the pcb is removed from
+ * @param pcb the tcp_pcb (or tcp_pcb_listen) to remove
+ */
+void tcp_pcb_hash_remove(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+	struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, pcb);
+
+	if (bucket != NULL) {
+		for (; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+			if (*bucket == pcb) {
+				*bucket = pcb->hash_next;
+				break;
+			}
+		}
+		pcb->hash_next = NULL;
+	}
+}
+#endif							/* LWIP_TCP_PCB_HASH */
+
 /**
  * Calculates a new initial sequence number for new connections.
  *
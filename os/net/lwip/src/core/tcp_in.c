@@ -101,10 +101,23 @@ static struct pbuf *recv_data;
 
 struct tcp_pcb *tcp_input_pcb;
 
+/* Listening PCBs that may match a destination port: the bucket of the
+   listen table when hashing, the whole listen list otherwise. */
+#if LWIP_TCP_PCB_HASH
+#define TCP_LISTEN_FIRST(port)  tcp_listen_hash[TCP_LISTEN_HASH(port)]
+#define TCP_LISTEN_NEXT(lpcb)   ((lpcb)->hash_next)
+#else
+#define TCP_LISTEN_FIRST(port)  tcp_listen_pcbs.listen_pcbs
+#define TCP_LISTEN_NEXT(lpcb)   ((lpcb)->next)
+#endif							/* LWIP_TCP_PCB_HASH */
+
 /* Forward declarations. */
 static err_t tcp_process(struct tcp_pcb *pcb);
 static void tcp_receive(struct tcp_pcb *pcb);
 static void tcp_parseopt(struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+static void tcp_sack_mark(struct tcp_pcb *pcb, u32_t left, u32_t right);
+#endif
 
 static void tcp_listen_input(struct tcp_pcb_listen *pcb);
 static void tcp_timewait_input(struct tcp_pcb *pcb);
@@ -122,6 +135,9 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 {
 	struct tcp_pcb *pcb, *prev;
 	struct tcp_pcb_listen *lpcb;
+#if LWIP_TCP_PCB_HASH
+	struct tcp_pcb **bucket;
+#endif							/* LWIP_TCP_PCB_HASH */
 #if SO_REUSE
 	struct tcp_pcb *lpcb_prev = NULL;
 	struct tcp_pcb_listen *lpcb_any = NULL;
@@ -236,6 +252,35 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 	   for an active connection. */
 	prev = NULL;
 
+#if LWIP_TCP_PCB_HASH
+	/* Active and TIME-WAIT connections share one table hashed on the
+	   4-tuple, so only the PCBs of one bucket have to be compared. */
+	bucket = &tcp_conn_hash[tcp_conn_hash_index(tcphdr->dest, tcphdr->src, ip_current_src_addr())];
+	for (pcb = *bucket; pcb != NULL; pcb = pcb->hash_next) {
+		LWIP_ASSERT("tcp_input: hashed pcb->state != CLOSED", pcb->state != CLOSED);
+		LWIP_ASSERT("tcp_input: hashed pcb->state != LISTEN", pcb->state != LISTEN);
+		if (pcb->remote_port == tcphdr->src && pcb->local_port == tcphdr->dest && ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()) && ip_addr_cmp(&pcb->local_ip, ip_current_dest_addr())) {
+			/* Move this PCB to the front of its bucket so that subsequent
+			   lookups will be faster when buckets are shared. */
+			if (prev != NULL) {
+				prev->hash_next = pcb->hash_next;
+				pcb->hash_next = *bucket;
+				*bucket = pcb;
+			} else {
+				TCP_STATS_INC(tcp.cachehit);
+			}
+			break;
+		}
+		prev = pcb;
+	}
+
+	if (pcb != NULL && pcb->state == TIME_WAIT) {
+		LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for TIME_WAITing connection.\n"));
+		tcp_timewait_input(pcb);
+		pbuf_free(p);
+		return;
+	}
+#else							/* LWIP_TCP_PCB_HASH */
 	for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
 		LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
 		LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
@@ -257,8 +302,10 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 		}
 		prev = pcb;
 	}
+#endif							/* LWIP_TCP_PCB_HASH */
 
 	if (pcb == NULL) {
+#if !LWIP_TCP_PCB_HASH
 		/* If it did not go to an active connection, we check the connections
 		   in the TIME-WAIT state. */
 		for (pcb = tcp_tw_pcbs; pcb != NULL; pcb = pcb->next) {
@@ -273,11 +320,12 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 				return;
 			}
 		}
+#endif							/* !LWIP_TCP_PCB_HASH */
 
 		/* Finally, if we still did not get a match, we check all PCBs that
 		   are LISTENing for incoming connections. */
 		prev = NULL;
-		for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+		for (lpcb = TCP_LISTEN_FIRST(tcphdr->dest); lpcb != NULL; lpcb = TCP_LISTEN_NEXT(lpcb)) {
 			if (lpcb->local_port == tcphdr->dest) {
 				if (IP_IS_ANY_TYPE_VAL(lpcb->local_ip)) {
 					/* found an ANY TYPE (IPv4/IPv6) match */
@@ -317,11 +365,11 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 			   lookups will be faster (we exploit locality in TCP segment
 			   arrivals). */
 			if (prev != NULL) {
-				((struct tcp_pcb_listen *)prev)->next = lpcb->next;
+				TCP_LISTEN_NEXT((struct tcp_pcb_listen *)prev) = TCP_LISTEN_NEXT(lpcb);
 				/* our successor is the remainder of the listening list */
-				lpcb->next = tcp_listen_pcbs.listen_pcbs;
+				TCP_LISTEN_NEXT(lpcb) = TCP_LISTEN_FIRST(tcphdr->dest);
 				/* put this listening pcb at the head of the listening list */
-				tcp_listen_pcbs.listen_pcbs = lpcb;
+				TCP_LISTEN_FIRST(tcphdr->dest) = lpcb;
 			} else {
 				TCP_STATS_INC(tcp.cachehit);
 			}
@@ -1071,6 +1119,12 @@ static void tcp_receive(struct tcp_pcb *pcb)
 								/* Do fast retransmit */
 								tcp_rexmit_fast(pcb);
 							}
+#if LWIP_TCP_SACK
+							if ((pcb->flags & TF_SACK) && (pcb->flags & TF_INFR)) {
+								/* The dupack may have reported more holes */
+								tcp_rexmit_sack(pcb);
+							}
+#endif							/* LWIP_TCP_SACK */
 						}
 					}
 				}
@@ -1087,8 +1141,15 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			   in fast retransmit. Also reset the congestion window to the
 			   slow start threshold. */
 			if (pcb->flags & TF_INFR) {
-				pcb->flags &= ~TF_INFR;
-				pcb->cwnd = pcb->ssthresh;
+#if LWIP_TCP_SACK
+				/* With SACK, a partial ACK (below the recovery point) keeps
+				   the connection in fast recovery (RFC 6675). */
+				if (!(pcb->flags & TF_SACK) || !TCP_SEQ_LT(ackno, pcb->recover))
+#endif							/* LWIP_TCP_SACK */
+				{
+					pcb->flags &= ~TF_INFR;
+					pcb->cwnd = pcb->ssthresh;
+				}
 			}
 
 			/* Reset the number of retransmissions. */
@@ -1148,6 +1209,13 @@ static void tcp_receive(struct tcp_pcb *pcb)
 				pcb->rtime = 0;
 			}
 
+#if LWIP_TCP_SACK
+			if ((pcb->flags & TF_SACK) && (pcb->flags & TF_INFR)) {
+				/* Partial ACK: the first unacked segment is missing as well */
+				tcp_rexmit_sack(pcb);
+			}
+#endif							/* LWIP_TCP_SACK */
+
 			pcb->polltmr = 0;
 
 #if LWIP_IPV6 && LWIP_ND6_TCP_REACHABILITY_HINTS
@@ -1463,8 +1531,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			} else {
 				/* We get here if the incoming segment is out-of-sequence. */
-				tcp_send_empty_ack(pcb);
 #if TCP_QUEUE_OOSEQ
+#if LWIP_TCP_SACK
+				/* reported in the first SACK block of the ACK sent below */
+				pcb->rcv_sack_recent = seqno;
+#endif							/* LWIP_TCP_SACK */
 				/* We queue the segment on the ->ooseq queue. */
 				if (pcb->ooseq == NULL) {
 					pcb->ooseq = tcp_seg_copy(&inseg);
@@ -1605,6 +1676,9 @@ static void tcp_receive(struct tcp_pcb *pcb)
 				}
 #endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
 #endif							/* TCP_QUEUE_OOSEQ */
+				/* Send a duplicate ACK. It is sent after queueing so that
+				   SACK blocks can describe the new ooseq state. */
+				tcp_send_empty_ack(pcb);
 			}
 		} else {
 			/* The incoming segment is not within the window. */
@@ -1645,6 +1719,9 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 #if LWIP_TCP_TIMESTAMPS
 	u32_t tsval;
 #endif
+#if LWIP_TCP_SACK
+	u32_t left, right;
+#endif
 
 	/* Parse the TCP MSS option, if present. */
 	if (tcphdr_optlen != 0) {
@@ -1723,6 +1800,42 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 				tcp_optidx += LWIP_TCP_OPT_LEN_TS - 6;
 				break;
 #endif
+#if LWIP_TCP_SACK
+			case LWIP_TCP_OPT_SACK_PERM:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK_PERM\n"));
+				if (tcp_getoptbyte() != LWIP_TCP_OPT_LEN_SACK_PERM || (tcp_optidx - 2 + LWIP_TCP_OPT_LEN_SACK_PERM) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				/* SACK may be used if both SYNs permitted it */
+				if (flags & TCP_SYN) {
+					pcb->flags |= TF_SACK;
+				}
+				break;
+			case LWIP_TCP_OPT_SACK:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+				data = tcp_getoptbyte();
+				if (data < 10 || ((data - 2) % 8) != 0 || (tcp_optidx - 2 + data) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				for (data = (data - 2) / 8; data > 0; data--) {
+					left = (u32_t)tcp_getoptbyte() << 24;
+					left |= (u32_t)tcp_getoptbyte() << 16;
+					left |= (u32_t)tcp_getoptbyte() << 8;
+					left |= tcp_getoptbyte();
+					right = (u32_t)tcp_getoptbyte() << 24;
+					right |= (u32_t)tcp_getoptbyte() << 16;
+					right |= (u32_t)tcp_getoptbyte() << 8;
+					right |= tcp_getoptbyte();
+					if ((pcb->flags & TF_SACK) && (flags & TCP_ACK) && !(flags & TCP_SYN)) {
+						tcp_sack_mark(pcb, left, right);
+					}
+				}
+				break;
+#endif							/* LWIP_TCP_SACK */
 			default:
 				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
 				data = tcp_getoptbyte();
@@ -1740,6 +1853,40 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 	}
 }
 
+#if LWIP_TCP_SACK
+/**
+ * Updates the SACK scoreboard: marks the unacked segments covered by a SACK
+ * block of an incoming ACK as received by the remote host.
+ *
+ * Called from tcp_parseopt(). Blocks outside the sequence space that is
+ * currently in flight are ignored.
+ *
+ * @param pcb the tcp_pcb for which a SACK block arrived
+ * @param left first sequence number of the block
+ * @param right sequence number following the block
+ */
+static void tcp_sack_mark(struct tcp_pcb *pcb, u32_t left, u32_t right)
+{
+	struct tcp_seg *seg;
+	u32_t seg_seqno;
+
+	if (!TCP_SEQ_LT(left, right) || TCP_SEQ_LT(left, pcb->lastack) || TCP_SEQ_GT(right, pcb->snd_nxt)) {
+		return;
+	}
+
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		seg_seqno = lwip_ntohl(seg->tcphdr->seqno);
+		if (TCP_SEQ_GEQ(seg_seqno, right)) {
+			/* unacked is sorted */
+			break;
+		}
+		if (TCP_SEQ_GEQ(seg_seqno, left) && TCP_SEQ_LEQ(seg_seqno + TCP_TCPLEN(seg), right)) {
+			seg->flags |= TF_SEG_SACKED;
+		}
+	}
+}
+#endif							/* LWIP_TCP_SACK */
+
 void tcp_trigger_input_pcb_close(void)
 {
 	recv_flags |= TF_CLOSED;
@@ -781,6 +781,13 @@ err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
 			optflags |= TF_SEG_OPTS_WND_SCALE;
 		}
 #endif							/* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+		if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_SACK)) {
+			/* Like window scaling, SACK may only be permitted in a <SYN,ACK>
+			   if the remote host permitted it in its SYN. */
+			optflags |= TF_SEG_OPTS_SACK_PERM;
+		}
+#endif							/* LWIP_TCP_SACK */
 	}
 #if LWIP_TCP_TIMESTAMPS
 	if ((pcb->flags & TF_TIMESTAMP)) {
@@ -869,6 +876,72 @@ static void tcp_build_wnd_scale_option(u32_t *opts)
 }
 #endif
 
+#if LWIP_TCP_SACK
+/** Collect SACK blocks describing the data queued on ooseq
+ *
+ * Contiguous ooseq segments are merged into one block. As required by
+ * RFC 2018, the block holding the most recently received segment is
+ * reported first; the others follow in sequence order.
+ *
+ * @param pcb tcp_pcb
+ * @param edges array of 2 * (max + 1) words receiving left and right edges
+ * @param max maximum number of blocks to report
+ * @return number of blocks stored at the start of edges
+ */
+static u8_t tcp_get_sack_blocks(struct tcp_pcb *pcb, u32_t *edges, u8_t max)
+{
+	struct tcp_seg *seg;
+	u32_t left, right;
+	u8_t recent = 0;
+	u8_t n = 0;
+	u8_t i;
+
+	/* edges[0..1] is kept free for the most recent block */
+	seg = pcb->ooseq;
+	while (seg != NULL) {
+		left = seg->tcphdr->seqno;
+		right = left + TCP_TCPLEN(seg);
+		for (seg = seg->next; seg != NULL && seg->tcphdr->seqno == right; seg = seg->next) {
+			right += TCP_TCPLEN(seg);
+		}
+		if (!recent && TCP_SEQ_BETWEEN(pcb->rcv_sack_recent, left, right - 1)) {
+			edges[0] = left;
+			edges[1] = right;
+			recent = 1;
+		} else if (n < max) {
+			n++;
+			edges[2 * n] = left;
+			edges[2 * n + 1] = right;
+		}
+	}
+
+	if (recent) {
+		return (u8_t)LWIP_MIN(n + 1, max);
+	}
+	for (i = 0; i < 2 * n; i++) {
+		edges[i] = edges[i + 2];
+	}
+	return n;
+}
+
+/** Build a SACK option at the specified options pointer
+ *
+ * @param opts option pointer where to store the SACK option
+ * @param edges left and right edges of the blocks in host byte order
+ * @param num number of blocks
+ */
+static void tcp_build_sack_option(u32_t *opts, const u32_t *edges, u8_t num)
+{
+	u8_t i;
+
+	/* Pad with two NOP options to make everything nicely aligned */
+	opts[0] = PP_HTONL(0x01010500) | lwip_htonl(LWIP_TCP_OPT_LEN_SACK_OUT(num) - 2);
+	for (i = 0; i < 2 * num; i++) {
+		opts[1 + i] = lwip_htonl(edges[i]);
+	}
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Send an ACK without data.
  *
@@ -880,15 +953,32 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 	struct pbuf *p;
 	u8_t optlen = 0;
 	struct netif *netif;
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK
 	struct tcp_hdr *tcphdr;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK */
+#if LWIP_TCP_SACK
+	u32_t sack_edges[2 * (LWIP_TCP_SACK_BLOCKS + 1)];
+	u8_t sack_num = 0;
+	u8_t sack_max = LWIP_TCP_SACK_BLOCKS;
+#endif							/* LWIP_TCP_SACK */
 
 #if LWIP_TCP_TIMESTAMPS
 	if (pcb->flags & TF_TIMESTAMP) {
 		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
+#if LWIP_TCP_SACK
+		/* only three blocks fit next to the timestamp option */
+		sack_max = LWIP_MIN(sack_max, 3);
+#endif							/* LWIP_TCP_SACK */
 	}
 #endif
+#if LWIP_TCP_SACK
+	if ((pcb->flags & TF_SACK) && (pcb->ooseq != NULL)) {
+		sack_num = tcp_get_sack_blocks(pcb, sack_edges, sack_max);
+		if (sack_num > 0) {
+			optlen += LWIP_TCP_OPT_LEN_SACK_OUT(sack_num);
+		}
+	}
+#endif							/* LWIP_TCP_SACK */
 
 	p = tcp_output_alloc_header(pcb, optlen, 0, lwip_htonl(pcb->snd_nxt));
 	if (p == NULL) {
@@ -897,9 +987,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: (ACK) could not allocate pbuf\n"));
 		return ERR_BUF;
 	}
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK
 	tcphdr = (struct tcp_hdr *)p->payload;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK */
 	LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: sending ACK for %" U32_F "\n", pcb->rcv_nxt));
 
 	/* NB. MSS option is only sent on SYNs, so ignore it here */
@@ -910,6 +1000,12 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		tcp_build_timestamp_option(pcb, (u32_t *)(tcphdr + 1));
 	}
 #endif
+#if LWIP_TCP_SACK
+	if (sack_num > 0) {
+		/* the SACK option goes last, after the timestamp option if present */
+		tcp_build_sack_option((u32_t *)((u8_t *)(tcphdr + 1) + optlen - LWIP_TCP_OPT_LEN_SACK_OUT(sack_num)), sack_edges, sack_num);
+	}
+#endif							/* LWIP_TCP_SACK */
 
 	netif = ip_route(&pcb->local_ip, &pcb->remote_ip);
 	if (netif == NULL) {
@@ -1173,6 +1269,13 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct
 		opts += 1;
 	}
 #endif
+#if LWIP_TCP_SACK
+	if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+		/* Pad with two NOP options to make everything nicely aligned */
+		*opts = PP_HTONL(0x01010402);
+		opts += 1;
+	}
+#endif
 
 	/* Set retransmission timer running if it is not currently enabled
 	   This must be set before checking the route. */
@@ -1318,6 +1421,17 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 		return;
 	}
 
+#if LWIP_TCP_SACK
+	if (pcb->flags & TF_SACK) {
+		/* The receiver may have discarded SACKed data (RFC 2018, section 8),
+		   so forget the scoreboard and leave fast recovery. */
+		for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+			seg->flags &= ~(TF_SEG_SACKED | TF_SEG_SACK_REXMIT);
+		}
+		pcb->flags &= ~TF_INFR;
+	}
+#endif							/* LWIP_TCP_SACK */
+
 	/* Move all unacked segments to the head of the unsent queue */
 	for (seg = pcb->unacked; seg->next != NULL; seg = seg->next) ;
 	/* concatenate unsent queue after unacked queue */
@@ -1346,26 +1460,16 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 }
 
 /**
- * Requeue the first unacked segment for retransmission
+ * Insert a segment taken from the unacked queue into the unsent queue,
+ * keeping the unsent queue sorted.
  *
- * Called by tcp_receive() for fast retramsmit.
- *
- * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ * @param pcb the tcp_pcb owning the segment
+ * @param seg the segment to retransmit
  */
-void tcp_rexmit(struct tcp_pcb *pcb)
+static void tcp_rexmit_enqueue(struct tcp_pcb *pcb, struct tcp_seg *seg)
 {
-	struct tcp_seg *seg;
 	struct tcp_seg **cur_seg;
 
-	if (pcb->unacked == NULL) {
-		return;
-	}
-
-	/* Move the first unacked segment to the unsent queue */
-	/* Keep the unsent queue sorted. */
-	seg = pcb->unacked;
-	pcb->unacked = seg->next;
-
 	cur_seg = &(pcb->unsent);
 	while (*cur_seg && TCP_SEQ_LT(lwip_ntohl((*cur_seg)->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno))) {
 		cur_seg = &((*cur_seg)->next);
@@ -1378,6 +1482,27 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 		pcb->unsent_oversize = 0;
 	}
 #endif							/* TCP_OVERSIZE */
+}
+
+/**
+ * Requeue the first unacked segment for retransmission
+ *
+ * Called by tcp_receive() for fast retramsmit.
+ *
+ * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ */
+void tcp_rexmit(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+
+	if (pcb->unacked == NULL) {
+		return;
+	}
+
+	/* Move the first unacked segment to the unsent queue */
+	seg = pcb->unacked;
+	pcb->unacked = seg->next;
+	tcp_rexmit_enqueue(pcb, seg);
 
 	if (pcb->nrtx < 0xFF) {
 		++pcb->nrtx;
@@ -1392,6 +1517,59 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 	   and thus tcp_output directly returns. */
 }
 
+#if LWIP_TCP_SACK
+/**
+ * Requeue the unacked segments the receiver is missing for retransmission
+ *
+ * Called during fast recovery on connections that negotiated SACK. A segment
+ * is missing if it is the first unacked segment or if a later segment has
+ * been SACKed. Segments that were SACKed or already retransmitted during
+ * this recovery are skipped, so every hole is retransmitted once.
+ *
+ * @param pcb the tcp_pcb for which to retransmit the missing segments
+ * @return number of segments requeued
+ */
+u16_t tcp_rexmit_sack(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+	struct tcp_seg *last_sacked = NULL;
+	struct tcp_seg **cur_seg;
+	u16_t num = 0;
+	u8_t first = 1;
+
+	/* Holes lie below the highest SACKed segment */
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		if (seg->flags & TF_SEG_SACKED) {
+			last_sacked = seg;
+		}
+	}
+
+	cur_seg = &(pcb->unacked);
+	while ((seg = *cur_seg) != NULL && (first || last_sacked != NULL) && seg != last_sacked) {
+		first = 0;
+		if (seg->flags & (TF_SEG_SACKED | TF_SEG_SACK_REXMIT)) {
+			cur_seg = &(seg->next);
+			continue;
+		}
+		LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_rexmit_sack: retransmit %" U32_F "\n", lwip_ntohl(seg->tcphdr->seqno)));
+		*cur_seg = seg->next;
+		seg->flags |= TF_SEG_SACK_REXMIT;
+		tcp_rexmit_enqueue(pcb, seg);
+		MIB2_STATS_INC(mib2.tcpretranssegs);
+		num++;
+	}
+
+	if (num > 0) {
+		if (pcb->nrtx < 0xFF) {
+			++pcb->nrtx;
+		}
+		/* Don't take any rtt measurements after retransmitting. */
+		pcb->rttest = 0;
+	}
+	return num;
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Handle retransmission after three dupacks received
  *
@@ -1402,7 +1580,17 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 	if (pcb->unacked != NULL && !(pcb->flags & TF_INFR)) {
 		/* This is fast retransmit. Retransmit the first unacked segment. */
 		LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_receive: dupacks %" U16_F " (%" U32_F "), fast retransmit %" U32_F "\n", (u16_t) pcb->dupacks, pcb->lastack, lwip_ntohl(pcb->unacked->tcphdr->seqno)));
-		tcp_rexmit(pcb);
+#if LWIP_TCP_SACK
+		if (pcb->flags & TF_SACK) {
+			/* With SACK, every hole the receiver reported is retransmitted,
+			   and recovery lasts until everything sent so far is acked. */
+			pcb->recover = pcb->snd_nxt;
+			tcp_rexmit_sack(pcb);
+		} else
+#endif							/* LWIP_TCP_SACK */
+		{
+			tcp_rexmit(pcb);
+		}
 
 		/* Set ssthresh to half of the minimum of the current
 		 * cwnd and the advertised window */
@@ -97,6 +97,54 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs = NULL;
 
+#if LWIP_UDP_PCB_HASH
+#if (UDP_PCB_HASH_SIZE & (UDP_PCB_HASH_SIZE - 1)) != 0
+#error "UDP_PCB_HASH_SIZE must be a power of two"
+#endif
+
+/* The PCBs of udp_pcbs indexed by local port */
+static struct udp_pcb *udp_pcb_hash[UDP_PCB_HASH_SIZE];
+
+/* PCBs that may be bound to a local port: the bucket of the port table when
+   hashing, the whole PCB list otherwise. */
+#define UDP_PCB_FIRST(port)     udp_pcb_hash[(port) & (UDP_PCB_HASH_SIZE - 1)]
+#define UDP_PCB_NEXT(pcb)       ((pcb)->hash_next)
+#else
+#define UDP_PCB_FIRST(port)     udp_pcbs
+#define UDP_PCB_NEXT(pcb)       ((pcb)->next)
+#endif							/* LWIP_UDP_PCB_HASH */
+
+#if LWIP_UDP_PCB_HASH
+/**
+ * Add a PCB that was put on udp_pcbs to the bucket of its local port.
+ */
+static void udp_pcb_hash_add(struct udp_pcb *pcb)
+{
+	pcb->hash_next = UDP_PCB_FIRST(pcb->local_port);
+	UDP_PCB_FIRST(pcb->local_port) = pcb;
+}
+
+/**
+ * Remove a PCB from the bucket of its local port before it is taken off
+ * udp_pcbs or its local port changes.
+ */
+static void udp_pcb_hash_remove(struct udp_pcb *pcb)
+{
+	struct udp_pcb **link;
+
+	for (link = &UDP_PCB_FIRST(pcb->local_port); *link != NULL; link = &(*link)->hash_next) {
+		if (*link == pcb) {
+			*link = pcb->hash_next;
+			break;
+		}
+	}
+	pcb->hash_next = NULL;
+}
+#else
+#define udp_pcb_hash_add(pcb)
+#define udp_pcb_hash_remove(pcb)
+#endif							/* LWIP_UDP_PCB_HASH */
+
 /**
  * Initialize this module.
  */
@@ -122,7 +170,7 @@ again:
 		udp_port = UDP_LOCAL_PORT_RANGE_START;
 	}
 	/* Check all PCBs. */
-	for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+	for (pcb = UDP_PCB_FIRST(udp_port); pcb != NULL; pcb = UDP_PCB_NEXT(pcb)) {
 		if (pcb->local_port == udp_port) {
 			if (++n > (UDP_LOCAL_PORT_RANGE_END - UDP_LOCAL_PORT_RANGE_START)) {
 				return 0;
@@ -246,7 +294,7 @@ void udp_input(struct pbuf *p, struct netif *inp)
 	 * 'Perfect match' pcbs (connected to the remote port & ip address) are
 	 * preferred. If no perfect match is found, the first unconnected pcb that
 	 * matches the local port and ip address gets the datagram. */
-	for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+	for (pcb = UDP_PCB_FIRST(dest); pcb != NULL; pcb = UDP_PCB_NEXT(pcb)) {
 		/* print the PCB local and remote address */
 		LWIP_DEBUGF(UDP_DEBUG, ("pcb ("));
 		ip_addr_debug_print(UDP_DEBUG, &pcb->local_ip);
@@ -270,11 +318,11 @@ void udp_input(struct pbuf *p, struct netif *inp)
 			if ((pcb->remote_port == src) && (ip_addr_isany_val(pcb->remote_ip) || ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()))) {
 				/* the first fully matching PCB */
 				if (prev != NULL) {
-					/* move the pcb to the front of udp_pcbs so that is
-					   found faster next time */
-					prev->next = pcb->next;
-					pcb->next = udp_pcbs;
-					udp_pcbs = pcb;
+					/* move the pcb to the front of udp_pcbs (or of its
+					   port bucket) so that is found faster next time */
+					UDP_PCB_NEXT(prev) = UDP_PCB_NEXT(pcb);
+					UDP_PCB_NEXT(pcb) = UDP_PCB_FIRST(dest);
+					UDP_PCB_FIRST(dest) = pcb;
 				} else {
 					UDP_STATS_INC(udp.cachehit);
 				}
@@ -356,7 +404,7 @@ void udp_input(struct pbuf *p, struct netif *inp)
 				struct udp_pcb *mpcb;
 				u8_t p_header_changed = 0;
 				s16_t hdrs_len = (s16_t)(ip_current_header_tot_len() + UDP_HLEN);
-				for (mpcb = udp_pcbs; mpcb != NULL; mpcb = mpcb->next) {
+				for (mpcb = UDP_PCB_FIRST(dest); mpcb != NULL; mpcb = UDP_PCB_NEXT(mpcb)) {
 					if (mpcb != pcb) {
 						/* compare PCB local addr+port to UDP destination addr+port */
 						if ((mpcb->local_port == dest) && (udp_input_local_match(mpcb, inp, broadcast) != 0)) {
@@ -884,7 +932,7 @@ err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 			return ERR_USE;
 		}
 	} else {
-		for (ipcb = udp_pcbs; ipcb != NULL; ipcb = ipcb->next) {
+		for (ipcb = UDP_PCB_FIRST(port); ipcb != NULL; ipcb = UDP_PCB_NEXT(ipcb)) {
 			if (pcb != ipcb) {
 				/* By default, we don't allow to bind to a port that any other udp
 				   PCB is already bound to, unless *all* PCBs with that port have tha
@@ -908,6 +956,12 @@ err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 
 	ip_addr_set_ipaddr(&pcb->local_ip, ipaddr);
 
+	if ((rebind != 0) && (pcb->local_port != port)) {
+		/* rebound to another port: move to the bucket of the new port */
+		udp_pcb_hash_remove(pcb);
+		pcb->local_port = port;
+		udp_pcb_hash_add(pcb);
+	}
 	pcb->local_port = port;
 	mib2_udp_bind(pcb);
 	/* pcb not active yet? */
@@ -915,6 +969,7 @@ err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 		/* place the PCB on the active list if not already there */
 		pcb->next = udp_pcbs;
 		udp_pcbs = pcb;
+		udp_pcb_hash_add(pcb);
 	}
 	LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("udp_bind: bound to "));
 	ip_addr_debug_print(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, &pcb->local_ip);
@@ -972,6 +1027,7 @@ err_t udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 	/* PCB not yet on the list, add PCB now */
 	pcb->next = udp_pcbs;
 	udp_pcbs = pcb;
+	udp_pcb_hash_add(pcb);
 	return ERR_OK;
 }
 
@@ -1026,6 +1082,7 @@ void udp_remove(struct udp_pcb *pcb)
 	struct udp_pcb *pcb2;
 
 	mib2_udp_unbind(pcb);
+	udp_pcb_hash_remove(pcb);
 	/* pcb to be removed is first in list? */
 	if (udp_pcbs == pcb) {
 		/* make list start at 2nd pcb */
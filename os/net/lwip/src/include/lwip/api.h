@@ -229,6 +229,23 @@ struct api_msg;
 /* A callback prototype to inform about events for a netconn */
 typedef void (*netconn_callback)(struct netconn *, enum netconn_evt, u16_t len);
 
+struct netconn_zc;
+
+#if LWIP_NETCONN_ZEROCOPY
+/** Called from the tcpip thread once the data of a netconn_write_zc() is no
+ * longer referenced by the stack: err is ERR_OK when it was acknowledged, or
+ * the error that tore the connection down. */
+typedef void (*netconn_zc_fn)(struct netconn_zc *zc, err_t err);
+
+/** A zero-copy write in flight, provided by the caller of netconn_write_zc() */
+struct netconn_zc {
+	struct netconn_zc *next;
+	/** sequence number following the last byte of the data */
+	u32_t end;
+	netconn_zc_fn done;
+};
+#endif							/* LWIP_NETCONN_ZEROCOPY */
+
 /* A netconn descriptor */
 struct netconn {
 	/* type of the netconn (TCP, UDP or RAW) */
@@ -303,6 +320,10 @@ struct netconn {
 	   this temporarily stores the message.
 	   Also used during connect and close. */
 	struct api_msg *current_msg;
+#if LWIP_NETCONN_ZEROCOPY
+	/* TCP: zero-copy writes whose data is still referenced, oldest first */
+	struct netconn_zc *zc_sends;
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 #endif							/* LWIP_TCP */
 	/* A callback function that is informed about events for this netconn */
 	netconn_callback callback;
@@ -348,9 +369,13 @@ err_t netconn_recv(struct netconn *conn, struct netbuf **new_buf);
 err_t netconn_recv_tcp_pbuf(struct netconn *conn, struct pbuf **new_buf);
 err_t netconn_sendto(struct netconn *conn, struct netbuf *buf, const ip_addr_t *addr, u16_t port);
 err_t netconn_send(struct netconn *conn, struct netbuf *buf);
+err_t netconn_sendv(struct netconn *conn, struct netbuf **bufs, u16_t count, u16_t *sent);
 err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written);
 #define netconn_write(conn, dataptr, size, apiflags) \
 		netconn_write_partly(conn, dataptr, size, apiflags, NULL)
+#if LWIP_NETCONN_ZEROCOPY
+err_t netconn_write_zc(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written, struct netconn_zc *zc);
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 err_t netconn_close(struct netconn *conn);
 err_t netconn_shutdown(struct netconn *conn, u8_t shut_rx, u8_t shut_tx);
 
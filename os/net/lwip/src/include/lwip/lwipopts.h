@@ -424,6 +424,14 @@
 #define TCP_DEFAULT_LISTEN_BACKLOG	CONFIG_NET_TCP_DEFAULT_LISTEN_BACKLOG
 #endif
 
+#ifdef CONFIG_NET_TCP_PCB_HASH
+#define LWIP_TCP_PCB_HASH	CONFIG_NET_TCP_PCB_HASH
+#endif
+
+#ifdef CONFIG_NET_TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_SIZE	CONFIG_NET_TCP_PCB_HASH_SIZE
+#endif
+
 #ifdef CONFIG_NET_TCP_OVERSIZE
 #define TCP_OVERSIZE	CONFIG_NET_TCP_OVERSIZE
 #endif
@@ -432,6 +440,14 @@
 #define TCP_TIMESTAMPS	CONFIG_NET_TCP_TIMESTAMPS
 #endif
 
+#ifdef CONFIG_NET_TCP_SACK
+#define LWIP_TCP_SACK	CONFIG_NET_TCP_SACK
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK_BLOCKS
+#define LWIP_TCP_SACK_BLOCKS	CONFIG_NET_TCP_SACK_BLOCKS
+#endif
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 #define LWIP_TCP_KEEPALIVE              CONFIG_NET_TCP_KEEPALIVE
 #endif
@@ -461,6 +477,14 @@
 #define LWIP_NETBUF_RECVINFO	CONFIG_NET_NETBUF_RECVINFO
 #endif
 
+#ifdef CONFIG_NET_UDP_PCB_HASH
+#define LWIP_UDP_PCB_HASH	CONFIG_NET_UDP_PCB_HASH
+#endif
+
+#ifdef CONFIG_NET_UDP_PCB_HASH_SIZE
+#define UDP_PCB_HASH_SIZE	CONFIG_NET_UDP_PCB_HASH_SIZE
+#endif
+
 /* ---------- UDP options ---------- */
 
 /* ---------- SNMP options ---------- */
@@ -677,6 +701,12 @@
 #define LWIP_SO_RCVBUF	CONFIG_NET_SO_RCVBUF
 #endif
 
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+#define LWIP_SOCKET_ZEROCOPY	1
+#define LWIP_NETCONN_ZEROCOPY	1
+#define LWIP_SUPPORT_CUSTOM_PBUF	1
+#endif
+
 #ifdef CONFIG_NET_SO_REUSE
 #define SO_REUSE	CONFIG_NET_SO_REUSE
 #endif
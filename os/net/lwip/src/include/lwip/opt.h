@@ -1099,6 +1099,23 @@
 #ifndef LWIP_NETBUF_RECVINFO
 #define LWIP_NETBUF_RECVINFO            0
 #endif
+
+/**
+ * LWIP_UDP_PCB_HASH==1: Index bound UDP PCBs by local port so that
+ * udp_input() only walks the PCBs sharing the destination port instead
+ * of every UDP PCB.
+ */
+#ifndef LWIP_UDP_PCB_HASH
+#define LWIP_UDP_PCB_HASH               0
+#endif
+
+/**
+ * UDP_PCB_HASH_SIZE: Number of buckets of the UDP port table.
+ * Must be a power of two.
+ */
+#ifndef UDP_PCB_HASH_SIZE
+#define UDP_PCB_HASH_SIZE               16
+#endif
 /**
  * @}
  */
@@ -1249,6 +1266,24 @@
 #define TCP_DEFAULT_LISTEN_BACKLOG      0xff
 #endif
 
+/**
+ * LWIP_TCP_PCB_HASH==1: Demultiplex incoming segments through a table of
+ * active and TIME-WAIT PCBs hashed on the 4-tuple and a table of listening
+ * PCBs indexed by local port, instead of walking the PCB lists.
+ */
+#ifndef LWIP_TCP_PCB_HASH
+#define LWIP_TCP_PCB_HASH               0
+#endif
+
+/**
+ * TCP_PCB_HASH_SIZE: Number of buckets of the connection table.  The
+ * listen table uses TCP_PCB_HASH_SIZE / 4 buckets (at least one).
+ * Must be a power of two.
+ */
+#ifndef TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_SIZE               32
+#endif
+
 /**
  * TCP_OVERSIZE: The maximum number of bytes that tcp_write may
  * allocate ahead of time in an attempt to create shorter pbuf chains
@@ -1277,6 +1312,25 @@
 #define LWIP_TCP_TIMESTAMPS             0
 #endif
 
+/**
+ * LWIP_TCP_SACK==1: support the TCP selective acknowledgement option
+ * (RFC 2018). SACK-permitted is sent in every SYN; once both sides agreed,
+ * segments queued on ooseq are reported in SACK blocks and fast recovery
+ * retransmits only the segments the remote host reported missing.
+ * Requires TCP_QUEUE_OOSEQ.
+ */
+#ifndef LWIP_TCP_SACK
+#define LWIP_TCP_SACK                   0
+#endif
+
+/**
+ * LWIP_TCP_SACK_BLOCKS: Maximum number of SACK blocks sent in one ACK (1..4).
+ * Only three blocks fit into the option space together with timestamps.
+ */
+#ifndef LWIP_TCP_SACK_BLOCKS
+#define LWIP_TCP_SACK_BLOCKS            4
+#endif
+
 /**
  * TCP_WND_UPDATE_THRESHOLD: difference in window to trigger an
  * explicit window update
@@ -1699,6 +1753,14 @@
 #ifndef LWIP_NETCONN_FULLDUPLEX
 #define LWIP_NETCONN_FULLDUPLEX         0
 #endif
+
+/** LWIP_NETCONN_ZEROCOPY==1: Enable netconn_write_zc(), which queues TCP data
+ * by reference and reports through a callback when the stack no longer
+ * references it (all segments holding the data have been acknowledged).
+ */
+#ifndef LWIP_NETCONN_ZEROCOPY
+#define LWIP_NETCONN_ZEROCOPY           0
+#endif
 /**
  * @}
  */
@@ -1757,6 +1819,26 @@
 #define LWIP_SOCKET_OFFSET              0
 #endif
 
+/**
+ * LWIP_SOCKET_ZEROCOPY==1: Enable lwip_recv_zc(), lwip_recv_zc_release() and
+ * lwip_send_zc(). Received pbufs are lent to the caller instead of being
+ * copied, and caller buffers are sent by reference (TCP: netconn_write_zc(),
+ * UDP/RAW: custom PBUF_REF pbufs). Requires LWIP_NETCONN_ZEROCOPY and
+ * LWIP_SUPPORT_CUSTOM_PBUF.
+ */
+#ifndef LWIP_SOCKET_ZEROCOPY
+#define LWIP_SOCKET_ZEROCOPY            0
+#endif
+
+/**
+ * LWIP_SOCKET_MMSG_BATCH: Maximum number of datagrams lwip_sendmmsg() passes
+ * to the tcpip thread in one message. The netbufs of a batch live on the
+ * stack of the calling thread.
+ */
+#ifndef LWIP_SOCKET_MMSG_BATCH
+#define LWIP_SOCKET_MMSG_BATCH          8
+#endif
+
 /**
  * LWIP_TCP_KEEPALIVE==1: Enable TCP_KEEPIDLE, TCP_KEEPINTVL and TCP_KEEPCNT
  * options processing. Note that TCP_KEEPIDLE and TCP_KEEPINTVL have to be set
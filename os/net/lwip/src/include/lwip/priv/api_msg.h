@@ -103,6 +103,12 @@ struct api_msg {
 	union {
 		/** used for lwip_netconn_do_send */
 		struct netbuf *b;
+		/** used for lwip_netconn_do_sendv */
+		struct {
+			struct netbuf **bufs;
+			u16_t count;
+			u16_t sent;
+		} bv;
 		/** used for lwip_netconn_do_newconn */
 		struct {
 			u8_t proto;
@@ -126,6 +132,10 @@ struct api_msg {
 #if LWIP_SO_SNDTIMEO
 			u32_t time_started;
 #endif							/* LWIP_SO_SNDTIMEO */
+#if LWIP_NETCONN_ZEROCOPY
+			/* zero-copy write: set to NULL once registered with the netconn */
+			struct netconn_zc *zc;
+#endif							/* LWIP_NETCONN_ZEROCOPY */
 		} w;
 		/** used for lwip_netconn_do_recv */
 		struct {
@@ -204,6 +214,7 @@ void lwip_netconn_do_connect(void *m);
 void lwip_netconn_do_disconnect(void *m);
 void lwip_netconn_do_listen(void *m);
 void lwip_netconn_do_send(void *m);
+void lwip_netconn_do_sendv(void *m);
 void lwip_netconn_do_recv(void *m);
 #if TCP_LISTEN_BACKLOG
 void lwip_netconn_do_accepted(void *m);
@@ -99,6 +99,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb);
 void tcp_rexmit(struct tcp_pcb *pcb);
 void tcp_rexmit_rto(struct tcp_pcb *pcb);
 void tcp_rexmit_fast(struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+u16_t tcp_rexmit_sack(struct tcp_pcb *pcb);
+#endif
 u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb);
 err_t tcp_process_refused_data(struct tcp_pcb *pcb);
 
@@ -279,6 +282,9 @@ struct tcp_seg {
 #define TF_SEG_DATA_CHECKSUMMED (u8_t)0x04U	/* ALL data (not the header) is
 											   checksummed into 'chksum' */
 #define TF_SEG_OPTS_WND_SCALE   (u8_t)0x08U	/* Include WND SCALE option */
+#define TF_SEG_OPTS_SACK_PERM   (u8_t)0x10U	/* Include SACK Permitted option */
+#define TF_SEG_SACKED           (u8_t)0x20U	/* Reported received by a SACK block */
+#define TF_SEG_SACK_REXMIT      (u8_t)0x40U	/* Retransmitted in the current recovery */
 	struct tcp_hdr *tcphdr;	/* the TCP header */
 };
 
@@ -286,6 +292,8 @@ struct tcp_seg {
 #define LWIP_TCP_OPT_NOP        1
 #define LWIP_TCP_OPT_MSS        2
 #define LWIP_TCP_OPT_WS         3
+#define LWIP_TCP_OPT_SACK_PERM  4
+#define LWIP_TCP_OPT_SACK       5
 #define LWIP_TCP_OPT_TS         8
 
 #define LWIP_TCP_OPT_LEN_MSS    4
@@ -301,11 +309,19 @@ struct tcp_seg {
 #else
 #define LWIP_TCP_OPT_LEN_WS_OUT 0
 #endif
+#if LWIP_TCP_SACK
+#define LWIP_TCP_OPT_LEN_SACK_PERM     2
+#define LWIP_TCP_OPT_LEN_SACK_PERM_OUT 4	/* aligned for output (includes NOP padding) */
+#define LWIP_TCP_OPT_LEN_SACK_OUT(n)   (4 + 8 * (n))	/* two NOPs, kind, length, n blocks */
+#else
+#define LWIP_TCP_OPT_LEN_SACK_PERM_OUT 0
+#endif
 
 #define LWIP_TCP_OPT_LENGTH(flags) \
 		(flags & TF_SEG_OPTS_MSS       ? LWIP_TCP_OPT_LEN_MSS    : 0) + \
 		(flags & TF_SEG_OPTS_TS        ? LWIP_TCP_OPT_LEN_TS_OUT : 0) + \
-		(flags & TF_SEG_OPTS_WND_SCALE ? LWIP_TCP_OPT_LEN_WS_OUT : 0)
+		(flags & TF_SEG_OPTS_WND_SCALE ? LWIP_TCP_OPT_LEN_WS_OUT : 0) + \
+		(flags & TF_SEG_OPTS_SACK_PERM ? LWIP_TCP_OPT_LEN_SACK_PERM_OUT : 0)
 
 /** This returns a TCP header option for MSS in an u32_t */
 #define TCP_BUILD_MSS_OPTION(mss) lwip_htonl(0x02040000 | ((mss) & 0xFFFF))
@@ -343,6 +359,39 @@ extern struct tcp_pcb *tcp_tw_pcbs;	/* List of all TCP PCBs in TIME-WAIT. */
 #define NUM_TCP_PCB_LISTS               4
 extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 
+#if LWIP_TCP_PCB_HASH
+#if (TCP_PCB_HASH_SIZE & (TCP_PCB_HASH_SIZE - 1)) != 0
+#error "TCP_PCB_HASH_SIZE must be a power of two"
+#endif
+
+#if TCP_PCB_HASH_SIZE >= 4
+#define TCP_LISTEN_HASH_SIZE            (TCP_PCB_HASH_SIZE / 4)
+#else
+#define TCP_LISTEN_HASH_SIZE            1
+#endif
+
+/* Lookup tables used by tcp_input(), kept in sync with the PCB lists by
+   TCP_REG and TCP_RMV:
+   - tcp_conn_hash holds the PCBs of tcp_active_pcbs and tcp_tw_pcbs,
+     hashed on local port, remote port and remote IP address.
+   - tcp_listen_hash holds the PCBs of tcp_listen_pcbs, indexed by local
+     port. */
+extern struct tcp_pcb *tcp_conn_hash[TCP_PCB_HASH_SIZE];
+extern struct tcp_pcb_listen *tcp_listen_hash[TCP_LISTEN_HASH_SIZE];
+
+#define TCP_LISTEN_HASH(port)           ((port) & (TCP_LISTEN_HASH_SIZE - 1))
+
+u16_t tcp_conn_hash_index(u16_t local_port, u16_t remote_port, const ip_addr_t *remote_ip);
+void tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+void tcp_pcb_hash_remove(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+
+#define TCP_HASH_REG(pcbs, npcb)        tcp_pcb_hash_add(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb)        tcp_pcb_hash_remove(pcbs, npcb)
+#else
+#define TCP_HASH_REG(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb)
+#endif							/* LWIP_TCP_PCB_HASH */
+
 /* Axioms about the above lists:
    1) Every TCP PCB that is not CLOSED is in one of the lists.
    2) A PCB is only in one of the lists.
@@ -367,6 +416,7 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 		(npcb)->next = *(pcbs); \
 		LWIP_ASSERT("TCP_REG: npcb->next != npcb", (npcb)->next != (npcb)); \
 		*(pcbs) = (npcb); \
+		TCP_HASH_REG(pcbs, npcb); \
 		LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
 		tcp_timer_needed(); \
 	} while (0)
@@ -374,6 +424,7 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 		struct tcp_pcb *tcp_tmp_pcb; \
 		LWIP_ASSERT("TCP_RMV: pcbs != NULL", *(pcbs) != NULL); \
 		LWIP_DEBUGF(TCP_DEBUG, ("TCP_RMV: removing %p from %p\n", (npcb), *(pcbs))); \
+		TCP_HASH_RMV(pcbs, npcb); \
 		if (*(pcbs) == (npcb)) { \
 			*(pcbs) = (*pcbs)->next; \
 		} else for (tcp_tmp_pcb = *(pcbs); tcp_tmp_pcb != NULL; tcp_tmp_pcb = tcp_tmp_pcb->next) { \
@@ -393,11 +444,13 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 	do {                                             \
 		(npcb)->next = *pcbs;                          \
 		*(pcbs) = (npcb);                              \
+		TCP_HASH_REG(pcbs, npcb);                      \
 		tcp_timer_needed();                            \
 	} while (0)
 
 #define TCP_RMV(pcbs, npcb)                        \
 	do {                                             \
+		TCP_HASH_RMV(pcbs, npcb);                      \
 		if (*(pcbs) == (npcb)) {                        \
 			(*(pcbs)) = (*pcbs)->next;                   \
 		}                                              \
@@ -169,6 +169,7 @@ struct lwip_setgetsockopt_data {
 #endif /* IOV_MAX */
 
 struct msghdr;
+struct mmsghdr;
 
 /* struct msghdr->msg_flags bit field values */
 #define MSG_TRUNC   0x04
@@ -289,6 +290,7 @@ struct linger {
 #define MSG_OOB        0x04		/* Unimplemented: Requests out-of-band data. The significance and semantics of out-of-band data are protocol-specific */
 #define MSG_DONTWAIT   0x08		/* Nonblocking i/o for this operation only */
 #define MSG_MORE       0x10		/* Sender will send more */
+#define MSG_WAITFORONE 0x20		/* recvmmsg(): only wait for the first message */
 
 /*
  * Options for level IPPROTO_IP
@@ -519,6 +521,8 @@ int lwip_read(int s, void *mem, size_t len);
 int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t * fromlen);
 int lwip_send(int s, const void *dataptr, size_t size, int flags);
 int lwip_sendmsg(int s, const struct msghdr *message, int flags);
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout);
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
 int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
 int lwip_socket(int domain, int type, int protocol);
 int lwip_write(int s, const void *dataptr, size_t size);
@@ -528,6 +532,11 @@ int lwip_ioctl(int s, long cmd, void *argp);
 int lwip_fcntl(int s, int cmd, int val);
 
 int lwip_poll(int fd, struct pollfd *fds, bool setup);
+#if LWIP_SOCKET_ZEROCOPY
+int lwip_recv_zc(int s, struct iovec *iov, int *iovcnt, void **zcbuf, int flags);
+void lwip_recv_zc_release(void *zcbuf);
+int lwip_send_zc(int s, const void *dataptr, size_t size, int flags, void (*done)(void *arg, int result), void *arg);
+#endif
 #ifdef __cplusplus
 }
 #endif
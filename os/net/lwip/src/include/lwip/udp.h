@@ -94,6 +94,10 @@ struct udp_pcb {
 
 	/* Protocol specific PCB members */
 	struct udp_pcb *next;
+#if LWIP_UDP_PCB_HASH
+	/* next PCB in the same port table bucket */
+	struct udp_pcb *hash_next;
+#endif
 
 	u8_t flags;
 	/** ports are in host byte order */
@@ -62,6 +62,15 @@
 #define TCP_SND_BUF                     (12 * TCP_MSS)
 #define TCP_WND                         (10 * TCP_MSS)
 
+/* Hashed PCB demultiplexing, small tables so that buckets are shared: */
+#define LWIP_TCP_PCB_HASH               1
+#define TCP_PCB_HASH_SIZE               8
+#define LWIP_UDP_PCB_HASH               1
+#define UDP_PCB_HASH_SIZE               4
+#define MEMP_NUM_TCP_PCB                80
+
+#define LWIP_TCP_SACK                   1
+
 /* Minimal changes to opt.h required for etharp unit tests: */
 #define ETHARP_SUPPORT_STATIC_ENTRIES   1
 
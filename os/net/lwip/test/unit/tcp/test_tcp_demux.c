@@ -0,0 +1,273 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_tcp_demux.h"
+
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/stats.h"
+#include "lwip/sys.h"
+#include "tcp_helper.h"
+
+#if !LWIP_STATS || !TCP_STATS || !MEMP_STATS
+#error "This tests needs TCP- and MEMP-statistics enabled"
+#endif
+
+/* Number of connections used by the tests, several per hash bucket */
+#define DEMUX_NUM_PCBS          48
+/* Number of segments passed to tcp_input by the benchmark */
+#define DEMUX_BENCH_SEGMENTS    20000
+
+static struct tcp_pcb *demux_pcbs[DEMUX_NUM_PCBS];
+static struct test_tcp_counters demux_counters[DEMUX_NUM_PCBS];
+
+/* Helper functions */
+
+/** Connection i comes from 192.168.1.<2 + i % 16>:<0x4000 + i> to one of
+ * three local ports, so that connections differ in every tuple member.  The
+ * peers are on the netif subnet so that RSTs can be routed. */
+static void demux_tuple(int i, ip_addr_t *remote_ip, u16_t *remote_port, u16_t *local_port)
+{
+	IP4_ADDR(remote_ip, 192, 168, 1, 2 + i % 16);
+	*remote_port = (u16_t)(0x4000 + i);
+	*local_port = (u16_t)(80 + i % 3);
+}
+
+/** Create DEMUX_NUM_PCBS ESTABLISHED connections */
+static void demux_create_pcbs(ip_addr_t *local_ip)
+{
+	ip_addr_t remote_ip;
+	u16_t remote_port, local_port;
+	int i;
+
+	memset(demux_counters, 0, sizeof(demux_counters));
+	for (i = 0; i < DEMUX_NUM_PCBS; i++) {
+		demux_pcbs[i] = test_tcp_new_counters_pcb(&demux_counters[i]);
+		EXPECT_RET(demux_pcbs[i] != NULL);
+		demux_tuple(i, &remote_ip, &remote_port, &local_port);
+		tcp_set_state(demux_pcbs[i], ESTABLISHED, local_ip, &remote_ip, local_port, remote_port);
+	}
+}
+
+/** Send 'len' bytes of data to connection i */
+static void demux_send(int i, struct netif *netif, char *data, size_t len)
+{
+	struct pbuf *p = tcp_create_rx_segment(demux_pcbs[i], data, len, 0, 0, TCP_PSH | TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, netif);
+}
+
+/* Setups/teardown functions */
+
+static void tcp_demux_setup(void)
+{
+	tcp_remove_all();
+}
+
+static void tcp_demux_teardown(void)
+{
+	netif_list = NULL;
+	tcp_remove_all();
+}
+
+/* Test functions */
+
+/** Each segment must reach exactly the connection of its 4-tuple, in any
+ * arrival order and with several connections per hash bucket */
+START_TEST(test_tcp_demux_active)
+{
+	struct test_tcp_txcounters txcounters;
+	struct netif netif;
+	ip_addr_t local_ip, netmask;
+	char data[] = { 1, 2, 3, 4 };
+	int i, j;
+	LWIP_UNUSED_ARG(_i);
+
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	demux_create_pcbs(&local_ip);
+
+	/* walk the connections backwards and then by a stride */
+	for (i = DEMUX_NUM_PCBS - 1; i >= 0; i--) {
+		demux_send(i, &netif, data, sizeof(data));
+	}
+	for (j = 0; j < DEMUX_NUM_PCBS; j++) {
+		i = (j * 7) % DEMUX_NUM_PCBS;
+		demux_send(i, &netif, data, sizeof(data));
+	}
+
+	for (i = 0; i < DEMUX_NUM_PCBS; i++) {
+		EXPECT(demux_counters[i].recv_calls == 2);
+		EXPECT(demux_counters[i].recved_bytes == 2 * sizeof(data));
+		EXPECT(demux_counters[i].err_calls == 0);
+	}
+	/* every second segment is acknowledged at once, none is answered with a RST */
+	EXPECT(txcounters.num_tx_calls == DEMUX_NUM_PCBS);
+}
+
+END_TEST
+/** Aborted connections must leave the lookup tables, the others must still
+ * be found */
+START_TEST(test_tcp_demux_abort)
+{
+	struct test_tcp_txcounters txcounters;
+	struct netif netif;
+	ip_addr_t local_ip, remote_ip, netmask;
+	u16_t remote_port, local_port;
+	char data[] = { 1, 2, 3, 4 };
+	struct pbuf *p;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	demux_create_pcbs(&local_ip);
+
+	for (i = 0; i < DEMUX_NUM_PCBS; i += 2) {
+		tcp_abort(demux_pcbs[i]);
+		demux_pcbs[i] = NULL;
+	}
+	/* one RST per abort */
+	EXPECT(txcounters.num_tx_calls == DEMUX_NUM_PCBS / 2);
+	txcounters.num_tx_calls = 0;
+
+	for (i = 1; i < DEMUX_NUM_PCBS; i += 2) {
+		demux_send(i, &netif, data, sizeof(data));
+		EXPECT(demux_counters[i].recv_calls == 1);
+	}
+	EXPECT(txcounters.num_tx_calls == 0);
+
+	/* a segment for an aborted connection is not delivered but reset */
+	demux_tuple(0, &remote_ip, &remote_port, &local_port);
+	p = tcp_create_segment(&remote_ip, &local_ip, remote_port, local_port, data, sizeof(data), 1000, 2000, TCP_PSH | TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(demux_counters[0].recv_calls == 0);
+	EXPECT(txcounters.num_tx_calls == 1);
+}
+
+END_TEST
+/** A segment that matches no connection goes to the listener of its port
+ * even when active and TIME-WAIT connections share that local port */
+START_TEST(test_tcp_demux_listen)
+{
+	struct test_tcp_txcounters txcounters;
+	struct test_tcp_counters counters;
+	struct netif netif;
+	struct tcp_pcb *lpcb, *twpcb;
+	ip_addr_t local_ip, remote_ip, netmask;
+	struct pbuf *p;
+	u16_t used;
+	err_t err;
+	LWIP_UNUSED_ARG(_i);
+
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 200);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+
+	/* listener on port 80, bound before the port is in use */
+	lpcb = tcp_new();
+	EXPECT_RET(lpcb != NULL);
+	err = tcp_bind(lpcb, IP_ADDR_ANY, 80);
+	EXPECT_RET(err == ERR_OK);
+	lpcb = tcp_listen(lpcb);
+	EXPECT_RET(lpcb != NULL);
+
+	demux_create_pcbs(&local_ip);
+
+	/* TIME-WAIT connection on port 80 */
+	memset(&counters, 0, sizeof(counters));
+	twpcb = test_tcp_new_counters_pcb(&counters);
+	EXPECT_RET(twpcb != NULL);
+	tcp_set_state(twpcb, TIME_WAIT, &local_ip, &remote_ip, 80, 0x5000);
+	used = lwip_stats.memp[MEMP_TCP_PCB]->used;
+
+	/* segment for the TIME-WAIT connection: answered with an ACK */
+	p = tcp_create_segment(&remote_ip, &local_ip, 0x5000, 80, NULL, 0, twpcb->rcv_nxt, twpcb->snd_nxt, TCP_ACK | TCP_FIN);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(txcounters.num_tx_calls == 1);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == used);
+
+	/* SYN from the same host on another port: new connection from the listener */
+	p = tcp_create_segment(&remote_ip, &local_ip, 0x5001, 80, NULL, 0, 12345, 0, TCP_SYN);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(txcounters.num_tx_calls == 2);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == used + 1);
+	EXPECT(tcp_active_pcbs != NULL && tcp_active_pcbs->state == SYN_RCVD);
+	EXPECT(tcp_active_pcbs->remote_port == 0x5001);
+
+	/* SYN to a port without listener: reset */
+	p = tcp_create_segment(&remote_ip, &local_ip, 0x5002, 81, NULL, 0, 12345, 0, TCP_SYN);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &netif);
+	EXPECT(txcounters.num_tx_calls == 3);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == used + 1);
+
+	/* listen pcbs must be closed, not aborted */
+	err = tcp_close(lpcb);
+	EXPECT(err == ERR_OK);
+}
+
+END_TEST
+/** Synthetic many-connection benchmark: time the demultiplexing of segments
+ * spread over all connections.  Compare the result with LWIP_TCP_PCB_HASH
+ * set to 0. */
+START_TEST(test_tcp_demux_bench)
+{
+	struct test_tcp_txcounters txcounters;
+	struct netif netif;
+	ip_addr_t local_ip, netmask;
+	u32_t start, elapsed;
+	u32_t n;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&netif, &txcounters, &local_ip, &netmask);
+	demux_create_pcbs(&local_ip);
+
+	start = sys_now();
+	for (n = 0; n < DEMUX_BENCH_SEGMENTS; n++) {
+		/* pure ACKs, the connection state does not change */
+		i = (int)((n * 17) % DEMUX_NUM_PCBS);
+		test_tcp_input(tcp_create_rx_segment(demux_pcbs[i], NULL, 0, 0, 0, TCP_ACK), &netif);
+	}
+	elapsed = sys_now() - start;
+
+	printf("tcp demux: %d segments over %d connections (hash %d) in %" U32_F " ms\n", DEMUX_BENCH_SEGMENTS, DEMUX_NUM_PCBS, LWIP_TCP_PCB_HASH, elapsed);
+	EXPECT(txcounters.num_tx_calls == 0);
+	EXPECT(lwip_stats.memp[MEMP_PBUF_POOL]->used == 0);
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *tcp_demux_suite(void)
+{
+	TFun tests[] = {
+		test_tcp_demux_active,
+		test_tcp_demux_abort,
+		test_tcp_demux_listen,
+		test_tcp_demux_bench
+	};
+	return create_suite("TCP_DEMUX", tests, sizeof(tests) / sizeof(TFun), tcp_demux_setup, tcp_demux_teardown);
+}
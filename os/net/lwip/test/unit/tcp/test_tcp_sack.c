@@ -0,0 +1,509 @@
+/****************************************************************************
+ *
+ * Copyright 2021 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_tcp_sack.h"
+
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/stats.h"
+#include "tcp_helper.h"
+
+#if !LWIP_STATS || !TCP_STATS || !MEMP_STATS
+#error "This tests needs TCP- and MEMP-statistics enabled"
+#endif
+#if !LWIP_TCP_SACK
+#error "This tests needs LWIP_TCP_SACK enabled"
+#endif
+
+/* Size of the segments used by the receiver tests */
+#define SACK_SEG_LEN     100
+/* Number of segments sent by the sender tests */
+#define SACK_NUM_SEGS    8
+
+static struct netif sack_netif;
+static struct test_tcp_txcounters sack_txcounters;
+static struct test_tcp_counters sack_counters;
+static u8_t sack_data[SACK_NUM_SEGS * TCP_MSS];
+
+/* Helper functions */
+
+/** Create an ESTABLISHED connection, with SACK negotiated if 'sack' is set */
+static struct tcp_pcb *sack_create_pcb(int sack)
+{
+	struct tcp_pcb *pcb;
+	ip_addr_t local_ip, remote_ip, netmask;
+
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&sack_netif, &sack_txcounters, &local_ip, &netmask);
+	memset(&sack_counters, 0, sizeof(sack_counters));
+
+	pcb = test_tcp_new_counters_pcb(&sack_counters);
+	EXPECT_RETNULL(pcb != NULL);
+	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, 0x101, 0x100);
+	pcb->mss = TCP_MSS;
+	/* disable initial congestion window (we don't send a SYN here...) */
+	pcb->cwnd = pcb->snd_wnd;
+	if (sack) {
+		pcb->flags |= TF_SACK;
+	}
+	return pcb;
+}
+
+/** Build a SACK option from 'num' pairs of left and right edges */
+static u8_t sack_build_option(u8_t *opts, const u32_t *edges, u8_t num)
+{
+	u8_t i;
+
+	opts[0] = LWIP_TCP_OPT_NOP;
+	opts[1] = LWIP_TCP_OPT_NOP;
+	opts[2] = LWIP_TCP_OPT_SACK;
+	opts[3] = (u8_t)(2 + 8 * num);
+	for (i = 0; i < 2 * num; i++) {
+		opts[4 + 4 * i] = (u8_t)(edges[i] >> 24);
+		opts[5 + 4 * i] = (u8_t)(edges[i] >> 16);
+		opts[6 + 4 * i] = (u8_t)(edges[i] >> 8);
+		opts[7 + 4 * i] = (u8_t)edges[i];
+	}
+	return (u8_t)(4 + 8 * num);
+}
+
+/** Pass a duplicate ACK carrying the given SACK blocks to the pcb */
+static void sack_input_dupack(struct tcp_pcb *pcb, const u32_t *edges, u8_t num)
+{
+	u8_t opts[4 + 8 * 4];
+	u8_t optlen = sack_build_option(opts, edges, num);
+	struct pbuf *p = tcp_create_rx_segment_opts(pcb, NULL, 0, 0, 0, TCP_ACK, opts, optlen);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+}
+
+/** Return the TCP header of a packet captured by the test netif */
+static struct tcp_hdr *sack_tx_tcphdr(struct pbuf *q)
+{
+	struct ip_hdr *iphdr = (struct ip_hdr *)q->payload;
+	return (struct tcp_hdr *)((u8_t *)q->payload + IPH_HL(iphdr) * 4);
+}
+
+/** Find option 'kind' in a captured packet, NULL if it is not present */
+static u8_t *sack_tx_find_option(struct pbuf *q, u8_t kind)
+{
+	struct tcp_hdr *tcphdr = sack_tx_tcphdr(q);
+	u8_t *opts = (u8_t *)(tcphdr + 1);
+	u16_t optlen = TCPH_HDRLEN(tcphdr) * 4 - TCP_HLEN;
+	u16_t i = 0;
+
+	while (i < optlen && opts[i] != LWIP_TCP_OPT_EOL) {
+		if (opts[i] == LWIP_TCP_OPT_NOP) {
+			i++;
+		} else if (opts[i] == kind) {
+			return &opts[i];
+		} else {
+			i += opts[i + 1];
+		}
+	}
+	return NULL;
+}
+
+/** Read the SACK blocks of the last captured packet into 'edges',
+ * return the number of blocks */
+static u8_t sack_tx_blocks(u32_t *edges)
+{
+	struct pbuf *q;
+	u8_t *opt;
+	u8_t i;
+
+	EXPECT_RETX(sack_txcounters.tx_packets != NULL, 0);
+	for (q = sack_txcounters.tx_packets; q->next != NULL; q = q->next) ;
+	opt = sack_tx_find_option(q, LWIP_TCP_OPT_SACK);
+	if (opt == NULL) {
+		return 0;
+	}
+	for (i = 0; i < (opt[1] - 2) / 4; i++) {
+		edges[i] = ((u32_t)opt[2 + 4 * i] << 24) | ((u32_t)opt[3 + 4 * i] << 16) | ((u32_t)opt[4 + 4 * i] << 8) | opt[5 + 4 * i];
+	}
+	return (u8_t)((opt[1] - 2) / 8);
+}
+
+/** Free the captured packets */
+static void sack_tx_reset(void)
+{
+	if (sack_txcounters.tx_packets != NULL) {
+		pbuf_free(sack_txcounters.tx_packets);
+	}
+	sack_txcounters.tx_packets = NULL;
+	sack_txcounters.num_tx_calls = 0;
+	sack_txcounters.num_tx_bytes = 0;
+}
+
+/** Check that the captured packets are exactly the segments starting at
+ * base + seg[i] * TCP_MSS */
+static void sack_tx_check_segs(u32_t base, const int *segs, int num)
+{
+	struct pbuf *q;
+	int i = 0;
+
+	EXPECT(sack_txcounters.num_tx_calls == (u32_t)num);
+	for (q = sack_txcounters.tx_packets; q != NULL && i < num; q = q->next, i++) {
+		EXPECT(lwip_ntohl(sack_tx_tcphdr(q)->seqno) == base + segs[i] * TCP_MSS);
+	}
+}
+
+/** Send SACK_NUM_SEGS full-sized segments */
+static void sack_send_segs(struct tcp_pcb *pcb)
+{
+	err_t err;
+	int i;
+
+	for (i = 0; i < SACK_NUM_SEGS; i++) {
+		err = tcp_write(pcb, &sack_data[i * TCP_MSS], TCP_MSS, TCP_WRITE_FLAG_COPY);
+		EXPECT_RET(err == ERR_OK);
+	}
+	err = tcp_output(pcb);
+	EXPECT_RET(err == ERR_OK);
+	EXPECT(sack_txcounters.num_tx_calls == SACK_NUM_SEGS);
+	sack_tx_reset();
+}
+
+/* Setups/teardown functions */
+
+static void tcp_sack_setup(void)
+{
+	tcp_remove_all();
+}
+
+static void tcp_sack_teardown(void)
+{
+	sack_tx_reset();
+	netif_list = NULL;
+	tcp_remove_all();
+}
+
+/* Test functions */
+
+/** SACK is used only if both SYNs permitted it */
+START_TEST(test_tcp_sack_negotiate)
+{
+	u8_t sack_perm[] = { LWIP_TCP_OPT_NOP, LWIP_TCP_OPT_NOP, LWIP_TCP_OPT_SACK_PERM, LWIP_TCP_OPT_LEN_SACK_PERM };
+	struct tcp_pcb *lpcb;
+	ip_addr_t local_ip, remote_ip, netmask;
+	struct pbuf *p;
+	err_t err;
+	LWIP_UNUSED_ARG(_i);
+
+	IP4_ADDR(&local_ip, 192, 168, 1, 1);
+	IP4_ADDR(&remote_ip, 192, 168, 1, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	test_tcp_init_netif(&sack_netif, &sack_txcounters, &local_ip, &netmask);
+	sack_txcounters.copy_tx_packets = 1;
+
+	lpcb = tcp_new();
+	EXPECT_RET(lpcb != NULL);
+	err = tcp_bind(lpcb, IP_ADDR_ANY, 80);
+	EXPECT_RET(err == ERR_OK);
+	lpcb = tcp_listen(lpcb);
+	EXPECT_RET(lpcb != NULL);
+
+	/* SYN permitting SACK: the <SYN,ACK> permits it as well */
+	p = tcp_create_segment_opts(&remote_ip, &local_ip, 0x5000, 80, NULL, 0, 1000, 0, TCP_SYN, sack_perm, sizeof(sack_perm));
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	EXPECT_RET(sack_txcounters.num_tx_calls == 1);
+	EXPECT_RET(tcp_active_pcbs != NULL && tcp_active_pcbs->remote_port == 0x5000);
+	EXPECT(tcp_active_pcbs->flags & TF_SACK);
+	EXPECT(sack_tx_find_option(sack_txcounters.tx_packets, LWIP_TCP_OPT_SACK_PERM) != NULL);
+	sack_tx_reset();
+
+	/* plain SYN: no SACK on this connection */
+	p = tcp_create_segment(&remote_ip, &local_ip, 0x5001, 80, NULL, 0, 2000, 0, TCP_SYN);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	EXPECT_RET(sack_txcounters.num_tx_calls == 1);
+	EXPECT_RET(tcp_active_pcbs != NULL && tcp_active_pcbs->remote_port == 0x5001);
+	EXPECT((tcp_active_pcbs->flags & TF_SACK) == 0);
+	EXPECT(sack_tx_find_option(sack_txcounters.tx_packets, LWIP_TCP_OPT_SACK_PERM) == NULL);
+
+	err = tcp_close(lpcb);
+	EXPECT(err == ERR_OK);
+}
+
+END_TEST
+/** Out of order data is reported in SACK blocks, most recent block first */
+START_TEST(test_tcp_sack_blocks)
+{
+	struct tcp_pcb *pcb;
+	struct pbuf *p;
+	u32_t edges[8];
+	u32_t base;
+	u8_t num;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	pcb = sack_create_pcb(1);
+	EXPECT_RET(pcb != NULL);
+	sack_txcounters.copy_tx_packets = 1;
+	base = pcb->rcv_nxt;
+
+	/* [100,200) arrives, [0,100) is missing */
+	p = tcp_create_rx_segment(pcb, sack_data, SACK_SEG_LEN, SACK_SEG_LEN, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	EXPECT_RET(sack_txcounters.num_tx_calls == 1);
+	num = sack_tx_blocks(edges);
+	EXPECT_RET(num == 1);
+	EXPECT(edges[0] == base + 100 && edges[1] == base + 200);
+	sack_tx_reset();
+
+	/* [300,400) arrives: reported first */
+	p = tcp_create_rx_segment(pcb, sack_data, SACK_SEG_LEN, 3 * SACK_SEG_LEN, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	num = sack_tx_blocks(edges);
+	EXPECT_RET(num == 2);
+	EXPECT(edges[0] == base + 300 && edges[1] == base + 400);
+	EXPECT(edges[2] == base + 100 && edges[3] == base + 200);
+	sack_tx_reset();
+
+	/* [200,300) fills the gap between both blocks */
+	p = tcp_create_rx_segment(pcb, sack_data, SACK_SEG_LEN, 2 * SACK_SEG_LEN, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	num = sack_tx_blocks(edges);
+	EXPECT_RET(num == 1);
+	EXPECT(edges[0] == base + 100 && edges[1] == base + 400);
+	sack_tx_reset();
+
+	/* [500,600), [700,800), ...: no more than LWIP_TCP_SACK_BLOCKS blocks */
+	for (i = 5; i < 12; i += 2) {
+		p = tcp_create_rx_segment(pcb, sack_data, SACK_SEG_LEN, i * SACK_SEG_LEN, 0, TCP_ACK);
+		EXPECT_RET(p != NULL);
+		test_tcp_input(p, &sack_netif);
+	}
+	num = sack_tx_blocks(edges);
+	EXPECT_RET(num == LWIP_MIN(5, LWIP_TCP_SACK_BLOCKS));
+	EXPECT(edges[0] == base + 1100 && edges[1] == base + 1200);
+	if (num > 1) {
+		EXPECT(edges[2] == base + 100 && edges[3] == base + 400);
+	}
+	sack_tx_reset();
+
+	/* the hole at the start is filled: [0,400) is delivered, no more SACK
+	   blocks for it */
+	p = tcp_create_rx_segment(pcb, sack_data, SACK_SEG_LEN, 0, 0, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	EXPECT(sack_counters.recved_bytes == 4 * SACK_SEG_LEN);
+	EXPECT(pcb->rcv_nxt == base + 4 * SACK_SEG_LEN);
+	tcp_ack_now(pcb);
+	tcp_output(pcb);
+	num = sack_tx_blocks(edges);
+	EXPECT_RET(num > 1);
+	EXPECT(edges[0] == base + 1100 && edges[1] == base + 1200);
+	EXPECT(edges[2] == base + 500 && edges[3] == base + 600);
+
+	tcp_abort(pcb);
+}
+
+END_TEST
+/** Fast recovery retransmits every hole reported by SACK once, and nothing
+ * the receiver already has */
+START_TEST(test_tcp_sack_rexmit_holes)
+{
+	struct tcp_pcb *pcb;
+	struct pbuf *p;
+	u32_t base;
+	u32_t edges[6];
+	int rexmit[] = { 1, 3, 5 };
+	LWIP_UNUSED_ARG(_i);
+
+	pcb = sack_create_pcb(1);
+	EXPECT_RET(pcb != NULL);
+	base = pcb->snd_nxt;
+	sack_send_segs(pcb);
+	sack_txcounters.copy_tx_packets = 1;
+
+	/* segment 0 arrives, segments 1, 3 and 5 are lost */
+	p = tcp_create_rx_segment(pcb, NULL, 0, 0, TCP_MSS, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+
+	edges[0] = base + 2 * TCP_MSS;
+	edges[1] = base + 3 * TCP_MSS;
+	sack_input_dupack(pcb, edges, 1);
+	edges[0] = base + 4 * TCP_MSS;
+	edges[1] = base + 5 * TCP_MSS;
+	edges[2] = base + 2 * TCP_MSS;
+	edges[3] = base + 3 * TCP_MSS;
+	sack_input_dupack(pcb, edges, 2);
+	EXPECT(sack_txcounters.num_tx_calls == 0);
+
+	/* third dupack: segments 1, 3 and 5 are retransmitted */
+	edges[0] = base + 6 * TCP_MSS;
+	edges[1] = base + 8 * TCP_MSS;
+	edges[2] = base + 4 * TCP_MSS;
+	edges[3] = base + 5 * TCP_MSS;
+	edges[4] = base + 2 * TCP_MSS;
+	edges[5] = base + 3 * TCP_MSS;
+	sack_input_dupack(pcb, edges, 3);
+	EXPECT(pcb->dupacks == 3);
+	EXPECT(pcb->flags & TF_INFR);
+	sack_tx_check_segs(base, rexmit, 3);
+	sack_tx_reset();
+
+	/* another dupack does not retransmit anything again */
+	sack_input_dupack(pcb, edges, 3);
+	EXPECT(sack_txcounters.num_tx_calls == 0);
+
+	/* partial ACK up to segment 3: still in recovery, nothing to send */
+	p = tcp_create_rx_segment(pcb, NULL, 0, 0, 2 * TCP_MSS, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	EXPECT(pcb->flags & TF_INFR);
+	EXPECT(sack_txcounters.num_tx_calls == 0);
+
+	/* everything acknowledged: recovery ends */
+	p = tcp_create_rx_segment(pcb, NULL, 0, 0, 5 * TCP_MSS, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	EXPECT((pcb->flags & TF_INFR) == 0);
+	EXPECT(pcb->unacked == NULL && pcb->unsent == NULL);
+
+	tcp_abort(pcb);
+}
+
+END_TEST
+/** A partial ACK during recovery reveals a hole that was not SACKed: its
+ * first segment is retransmitted at once */
+START_TEST(test_tcp_sack_partial_ack)
+{
+	struct tcp_pcb *pcb;
+	struct pbuf *p;
+	u32_t base;
+	u32_t edges[2];
+	int rexmit1[] = { 0 };
+	int rexmit2[] = { 4 };
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	pcb = sack_create_pcb(1);
+	EXPECT_RET(pcb != NULL);
+	base = pcb->snd_nxt;
+	sack_send_segs(pcb);
+	sack_txcounters.copy_tx_packets = 1;
+
+	/* segments 0, 4 and 5 are lost, only 1..3 are SACKed */
+	edges[0] = base + TCP_MSS;
+	for (i = 2; i <= 4; i++) {
+		edges[1] = base + i * TCP_MSS;
+		sack_input_dupack(pcb, edges, 1);
+	}
+	sack_tx_check_segs(base, rexmit1, 1);
+	sack_tx_reset();
+
+	/* the retransmission arrives: ACK up to segment 4 */
+	p = tcp_create_rx_segment(pcb, NULL, 0, 0, 4 * TCP_MSS, TCP_ACK);
+	EXPECT_RET(p != NULL);
+	test_tcp_input(p, &sack_netif);
+	EXPECT(pcb->flags & TF_INFR);
+	sack_tx_check_segs(base, rexmit2, 1);
+
+	tcp_abort(pcb);
+}
+
+END_TEST
+/** A retransmission timeout forgets the scoreboard and resends everything */
+START_TEST(test_tcp_sack_rto)
+{
+	struct tcp_pcb *pcb;
+	struct tcp_seg *seg;
+	u32_t base;
+	u32_t edges[2];
+	LWIP_UNUSED_ARG(_i);
+
+	pcb = sack_create_pcb(1);
+	EXPECT_RET(pcb != NULL);
+	base = pcb->snd_nxt;
+	sack_send_segs(pcb);
+
+	/* segment 0 is lost, 1..7 are SACKed */
+	edges[0] = base + TCP_MSS;
+	edges[1] = base + SACK_NUM_SEGS * TCP_MSS;
+	sack_input_dupack(pcb, edges, 1);
+	for (seg = pcb->unacked->next; seg != NULL; seg = seg->next) {
+		EXPECT(seg->flags & TF_SEG_SACKED);
+	}
+	EXPECT((pcb->unacked->flags & TF_SEG_SACKED) == 0);
+
+	tcp_rexmit_rto(pcb);
+	EXPECT(sack_txcounters.num_tx_calls == SACK_NUM_SEGS);
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		EXPECT((seg->flags & (TF_SEG_SACKED | TF_SEG_SACK_REXMIT)) == 0);
+	}
+
+	tcp_abort(pcb);
+}
+
+END_TEST
+/** SACK blocks are ignored if SACK was not negotiated: only the first
+ * unacked segment is retransmitted */
+START_TEST(test_tcp_sack_not_permitted)
+{
+	struct tcp_pcb *pcb;
+	struct tcp_seg *seg;
+	u32_t base;
+	u32_t edges[4];
+	int rexmit[] = { 0 };
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	pcb = sack_create_pcb(0);
+	EXPECT_RET(pcb != NULL);
+	base = pcb->snd_nxt;
+	sack_send_segs(pcb);
+	sack_txcounters.copy_tx_packets = 1;
+
+	/* segments 0 and 2 are lost */
+	edges[0] = base + 3 * TCP_MSS;
+	edges[1] = base + SACK_NUM_SEGS * TCP_MSS;
+	edges[2] = base + TCP_MSS;
+	edges[3] = base + 2 * TCP_MSS;
+	for (i = 0; i < 3; i++) {
+		sack_input_dupack(pcb, edges, 2);
+	}
+	sack_tx_check_segs(base, rexmit, 1);
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		EXPECT((seg->flags & TF_SEG_SACKED) == 0);
+	}
+
+	tcp_abort(pcb);
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *tcp_sack_suite(void)
+{
+	TFun tests[] = {
+		test_tcp_sack_negotiate,
+		test_tcp_sack_blocks,
+		test_tcp_sack_rexmit_holes,
+		test_tcp_sack_partial_ack,
+		test_tcp_sack_rto,
+		test_tcp_sack_not_permitted
+	};
+	return create_suite("TCP_SACK", tests, sizeof(tests) / sizeof(TFun), tcp_sack_setup, tcp_sack_teardown);
+}
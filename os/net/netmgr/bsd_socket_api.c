@@ -30,6 +30,7 @@
 #include <sys/types.h>
 #include <netinet/in.h>
 #include <net/if.h>
+#include <errno.h>
 #include <tinyara/lwnl/lwnl.h>
 #include "netstack.h"
 #include "netdev_stats.h"
@@ -188,6 +189,100 @@ ssize_t sendmsg(int sockfd, struct msghdr *msg, int flags)
 	NETSTACK_CALL_BYFD(sockfd, sendmsg, (sockfd, msg, flags));
 }
 
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *	 Receive up to vlen datagrams with one call to the network stack.
+ *
+ * Parameters:
+ *	 sockfd	  Socket descriptor of socket
+ *	 msgvec	  Array of messages to fill
+ *	 vlen	  Number of messages in msgvec
+ *	 flags	  Receive flags, MSG_WAITFORONE to wait for the first one only
+ *	 timeout  NULL or time after which no more messages are received
+ *
+ * Returned Value:
+ *	 The number of messages received, or -1 with errno set.
+ *
+ ****************************************************************************/
+int recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+	unsigned int i;
+	NETSTACK_CALL_BYFD_RET(sockfd, recvmmsg, (sockfd, msgvec, vlen, flags, timeout), res);
+	for (i = 0; res > 0 && i < (unsigned int)res; i++) {
+		NETMGR_STATS_ADD(g_app_recv_byte, msgvec[i].msg_len);
+		NETMGR_STATS_INC(g_app_recv_cnt);
+	}
+	leave_cancellation_point();
+	return res;
+}
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *	 Send up to vlen messages with as few calls to the network stack as
+ *	 possible.
+ *
+ * Parameters:
+ *	 sockfd	  Socket descriptor of socket
+ *	 msgvec	  Array of messages to send
+ *	 vlen	  Number of messages in msgvec
+ *	 flags	  Send flags
+ *
+ * Returned Value:
+ *	 The number of messages sent, or -1 with errno set.
+ *
+ ****************************************************************************/
+int sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+	NETSTACK_CALL_BYFD_RET(sockfd, sendmmsg, (sockfd, msgvec, vlen, flags), res);
+	leave_cancellation_point();
+	return res;
+}
+
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+ssize_t recv_zc(int sockfd, struct iovec *iov, int *iovcnt, void **zcbuf, int flags)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+	NETSTACK_CALL_BYFD_RET(sockfd, recv_zc, (sockfd, iov, iovcnt, zcbuf, flags), res);
+	if (res > 0) {
+		NETMGR_STATS_ADD(g_app_recv_byte, res);
+		NETMGR_STATS_INC(g_app_recv_cnt);
+	}
+	leave_cancellation_point();
+	return res;
+}
+
+void recv_zc_release(void *zcbuf)
+{
+	/* Lent buffers always come from the socket stack */
+	struct netstack *stk = get_netstack(TR_SOCKET);
+	if (stk && stk->ops->recv_zc_release) {
+		stk->ops->recv_zc_release(zcbuf);
+	}
+}
+
+ssize_t send_zc(int sockfd, const void *data, size_t size, int flags, sock_zc_done_t done, void *arg)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+	NETSTACK_CALL_BYFD_RET(sockfd, send_zc, (sockfd, data, size, flags, done, arg), res);
+	leave_cancellation_point();
+	return res;
+}
+#endif
+
 int socket(int domain, int type, int protocol)
 {
 	struct netstack *stk = NULL;
@@ -203,4 +298,17 @@ int socket(int domain, int type, int protocol)
 	NETSTACK_CALL(stk, socket, (domain, type, protocol));
 }
 
+int socketpair(int domain, int type, int protocol, int sv[2])
+{
+	struct netstack *stk = NULL;
+	if (domain != AF_UNIX) {
+		/* Only user domain sockets can be created in pairs */
+		set_errno(EAFNOSUPPORT);
+		return -1;
+	}
+	stk = get_netstack(TR_UDS);
+
+	NETSTACK_CALL(stk, socketpair, (domain, type, protocol, sv));
+}
+
 #endif // CONFIG_NET
@@ -94,6 +94,15 @@ struct netstack_ops {
 
 	void (*initlist)(struct socketlist *list);
 	void (*releaselist)(struct socketlist *list);
+
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+	ssize_t (*recv_zc)(int s, struct iovec *iov, int *iovcnt, void **zcbuf, int flags);
+	void (*recv_zc_release)(void *zcbuf);
+	ssize_t (*send_zc)(int s, const void *data, size_t size, int flags, sock_zc_done_t done, void *arg);
+#endif
+	int (*recvmmsg)(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout);
+	int (*sendmmsg)(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+	int (*socketpair)(int domain, int type, int protocol, int sv[2]);
 };
 
 struct netstack {
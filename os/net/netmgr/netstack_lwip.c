@@ -322,6 +322,37 @@ static ssize_t lwip_ns_sendmsg(int sockfd, struct msghdr *msg, int flags)
 	return sendto(sockfd, buf, len, flags, to, (socklen_t) *addrlen);
 }
 
+
+static int lwip_ns_recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	return lwip_recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+}
+
+
+static int lwip_ns_sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	return lwip_sendmmsg(sockfd, msgvec, vlen, flags);
+}
+
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+static ssize_t lwip_ns_recv_zc(int s, struct iovec *iov, int *iovcnt, void **zcbuf, int flags)
+{
+	return lwip_recv_zc(s, iov, iovcnt, zcbuf, flags);
+}
+
+
+static void lwip_ns_recv_zc_release(void *zcbuf)
+{
+	lwip_recv_zc_release(zcbuf);
+}
+
+
+static ssize_t lwip_ns_send_zc(int s, const void *data, size_t size, int flags, sock_zc_done_t done, void *arg)
+{
+	return lwip_send_zc(s, data, size, flags, done, arg);
+}
+#endif
+
 static int lwip_ns_init(void *data)
 {
 	lwip_init();
@@ -557,7 +588,14 @@ struct netstack_ops g_lwip_stack_ops = {
 	lwip_ns_getstats,
 #endif
 	lwip_ns_initlist,
-	lwip_ns_releaselist
+	lwip_ns_releaselist,
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+	lwip_ns_recv_zc,
+	lwip_ns_recv_zc_release,
+	lwip_ns_send_zc,
+#endif
+	lwip_ns_recvmmsg,
+	lwip_ns_sendmmsg,
 };
 
 
@@ -28,7 +28,7 @@ struct netstack_ops g_uds_stack_ops = {
 	NULL,
 	NULL,
 	NULL,
-	NULL,
+	uds_close,
 
 	NULL,
 	NULL,
@@ -36,7 +36,7 @@ struct netstack_ops g_uds_stack_ops = {
 	uds_checksd,
 	NULL,
 	NULL,
-	NULL,
+	uds_poll,
 
 	uds_socket,
 	uds_bind,
@@ -63,6 +63,16 @@ struct netstack_ops g_uds_stack_ops = {
 #ifdef CONFIG_NET_NETMON
 	NULL,
 #endif
+	NULL,
+	NULL,
+#ifdef CONFIG_NET_SOCKET_ZEROCOPY
+	NULL,
+	NULL,
+	NULL,
+#endif
+	NULL,
+	NULL,
+	uds_socketpair,
 };
 
 struct netstack g_uds_stack = {&g_uds_stack_ops, NULL};
@@ -230,6 +230,8 @@ SYSCALL_LOOKUP(open,                    6, STUB_open)
 SYSCALL_LOOKUP(opendir,                 1, STUB_opendir)
 #if defined(CONFIG_PIPES)
 SYSCALL_LOOKUP(pipe,                    1, STUB_pipe)
+SYSCALL_LOOKUP(splice,                  6, STUB_splice)
+SYSCALL_LOOKUP(tee,                     4, STUB_tee)
 #endif
 SYSCALL_LOOKUP(readdir,                 1, STUB_readdir)
 SYSCALL_LOOKUP(rewinddir,               1, STUB_rewinddir)
@@ -337,11 +339,14 @@ SYSCALL_LOOKUP(listen,                  2, STUB_listen)
 SYSCALL_LOOKUP(recv,                    4, STUB_recv)
 SYSCALL_LOOKUP(recvfrom,                6, STUB_recvfrom)
 SYSCALL_LOOKUP(recvmsg,                 3, STUB_recvmsg)
+SYSCALL_LOOKUP(recvmmsg,                5, STUB_recvmmsg)
 SYSCALL_LOOKUP(send,                    4, STUB_send)
+SYSCALL_LOOKUP(sendmmsg,                4, STUB_sendmmsg)
 SYSCALL_LOOKUP(sendto,                  6, STUB_sendto)
 SYSCALL_LOOKUP(setsockopt,              5, STUB_setsockopt)
 SYSCALL_LOOKUP(shutdown,                2, STUB_shutdown)
 SYSCALL_LOOKUP(socket,                  3, STUB_socket)
+SYSCALL_LOOKUP(socketpair,              4, STUB_socketpair)
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
@@ -352,6 +357,10 @@ SYSCALL_LOOKUP(prctl,                   5, STUB_prctl)
 
 SYSCALL_LOOKUP(fin_wait,		0, STUB_fin_wait)
 
+#if CONFIG_NFILE_DESCRIPTORS > 0
+SYSCALL_LOOKUP(fs_sendfile,             4, STUB_fs_sendfile)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
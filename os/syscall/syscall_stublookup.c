@@ -228,6 +228,11 @@ uintptr_t STUB_open(int nbr, uintptr_t parm1, uintptr_t parm2,
 					uintptr_t parm6);
 uintptr_t STUB_opendir(int nbr, uintptr_t parm1);
 uintptr_t STUB_pipe(int nbr, uintptr_t parm1);
+uintptr_t STUB_splice(int nbr, uintptr_t parm1, uintptr_t parm2,
+					  uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
+					  uintptr_t parm6);
+uintptr_t STUB_tee(int nbr, uintptr_t parm1, uintptr_t parm2,
+				   uintptr_t parm3, uintptr_t parm4);
 uintptr_t STUB_readdir(int nbr, uintptr_t parm1);
 uintptr_t STUB_rewinddir(int nbr, uintptr_t parm1);
 uintptr_t STUB_seekdir(int nbr, uintptr_t parm1, uintptr_t parm2);
@@ -349,8 +354,12 @@ uintptr_t STUB_recvfrom(int nbr, uintptr_t parm1, uintptr_t parm2,
 						uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
 						uintptr_t parm6);
 uintptr_t STUB_recvmsg(int nbr, uintptr_t parm1, uintptr_t parm2, uintptr_t parm3);
+uintptr_t STUB_recvmmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+						uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
 uintptr_t STUB_send(int nbr, uintptr_t parm1, uintptr_t parm2,
 					uintptr_t parm3, uintptr_t parm4);
+uintptr_t STUB_sendmmsg(int nbr, uintptr_t parm1, uintptr_t parm2,
+						uintptr_t parm3, uintptr_t parm4);
 uintptr_t STUB_sendto(int nbr, uintptr_t parm1, uintptr_t parm2,
 					  uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
 					  uintptr_t parm6);
@@ -359,6 +368,8 @@ uintptr_t STUB_setsockopt(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_shutdown(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_socket(int nbr, uintptr_t parm1, uintptr_t parm2,
 					  uintptr_t parm3);
+uintptr_t STUB_socketpair(int nbr, uintptr_t parm1, uintptr_t parm2,
+						  uintptr_t parm3, uintptr_t parm4);
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
 
@@ -367,6 +378,9 @@ uintptr_t STUB_prctl(int nbr, uintptr_t parm1, uintptr_t parm2,
 
 uintptr_t STUB_fin_wait(int nbr);
 
+uintptr_t STUB_fs_sendfile(int nbr, uintptr_t parm1, uintptr_t parm2,
+						   uintptr_t parm3, uintptr_t parm4);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/